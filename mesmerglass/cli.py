@@ -197,11 +197,8 @@ def _load_theme_bank_from_media_bank(
 ):
     """Build a ThemeBank instance directly from media_bank.json entries."""
 
-    from mesmerglass.content.theme import ThemeConfig
-    from mesmerglass.content.themebank import ThemeBank
-    from mesmerglass.content.media_scan import scan_media_directory, scan_font_directory
+    from mesmerglass.content.themebank import ThemeBank, themes_from_media_bank
 
-    log = logging.getLogger(__name__)
     path = media_bank_path.expanduser().resolve()
     if not path.exists():
         raise FileNotFoundError(f"media bank not found: {path}")
@@ -214,38 +211,7 @@ def _load_theme_bank_from_media_bank(
     if not isinstance(entries, list):
         raise ValueError(f"Media bank must be a list of entries (got {type(entries).__name__})")
 
-    themes: list[ThemeConfig] = []
-    font_paths: list[str] = []
-    for entry in entries:
-        if not isinstance(entry, dict):
-            continue
-        raw_path = entry.get("path")
-        if not raw_path:
-            continue
-        dir_path = Path(raw_path).expanduser()
-        if not dir_path.exists():
-            log.warning("[themebank.cli] Skipping missing directory: %s", dir_path)
-            continue
-        media_type = (entry.get("type") or "both").lower()
-        if media_type == "fonts":
-            font_paths.extend(scan_font_directory(dir_path))
-            continue
-
-        images, videos = scan_media_directory(dir_path)
-        if media_type == "images":
-            videos = []
-        elif media_type == "videos":
-            images = []
-        theme = ThemeConfig(
-            name=entry.get("name", dir_path.name),
-            enabled=True,
-            image_path=images,
-            animation_path=videos,
-            font_path=[],
-            text_line=[],
-        )
-        themes.append(theme)
-
+    themes, font_paths = themes_from_media_bank(entries)
     if not themes:
         raise RuntimeError("No usable media directories were found; run 'media bank' setup first")
 
@@ -332,6 +298,149 @@ def cmd_themebank(args) -> int:
         bank.shutdown()
 
 
+def cmd_bundle(args) -> int:
+    """Pack, inspect or verify single-file session bundles (.mgbundle)."""
+
+    from mesmerglass.content import bundle as session_bundle
+
+    cmd = getattr(args, "bundle_cmd", "info")
+    if cmd == "pack":
+        session_path = Path(args.session)
+        if not session_path.is_file():
+            print(f"bundle pack: session not found: {session_path}", file=sys.stderr)
+            return 2
+        progress = None
+        if not getattr(args, "json", False):
+            def progress(done: int, total: int, name: str) -> None:
+                if done == total or done % 100 == 0:
+                    print(f"  packed {done}/{total} {name}")
+        try:
+            summary = session_bundle.write_bundle(session_path, args.output, progress=progress)
+        except (OSError, ValueError) as exc:
+            print(f"bundle pack: {exc}", file=sys.stderr)
+            return 2
+        if getattr(args, "json", False):
+            print(json.dumps(summary, indent=2))
+        else:
+            kinds = ", ".join(f"{k}={v}" for k, v in sorted(summary["kinds"].items())) or "no media"
+            print(
+                f"Wrote {summary['path']}: {summary['entries']} entries ({kinds}), "
+                f"{summary['bytes'] / (1024 * 1024):.1f} MB in {summary['seconds']:.1f}s"
+            )
+        return 0
+
+    try:
+        with session_bundle.SessionBundle(args.bundle) as packed:
+            if cmd == "info":
+                stats = packed.stats()
+                if getattr(args, "json", False):
+                    stats["members"] = [
+                        {"name": e.name, "kind": e.kind, "offset": e.offset, "size": e.size} for e in packed.entries
+                    ]
+                    print(json.dumps(stats, indent=2))
+                else:
+                    print(f"{packed.path.name}: bundle v{stats['version']} from {stats['source']} ({stats['created']})")
+                    print(f"  Members: {stats['entries']} ({stats['data_bytes'] / (1024 * 1024):.1f} MB)")
+                    for kind, count in sorted(stats["kinds"].items()):
+                        print(f"    {kind}: {count}")
+                    if getattr(args, "list", False):
+                        for e in packed.entries:
+                            print(f"  {e.offset:>12} {e.size:>10} {e.kind:<7} {e.name}")
+                return 0
+            if cmd == "verify":
+                bad = packed.verify()
+                if bad:
+                    for name in bad:
+                        print(f"bundle verify: CRC mismatch in {name}", file=sys.stderr)
+                    return 3
+                print(f"{packed.path.name}: {len(packed.entries)} members OK")
+                return 0
+    except (OSError, ValueError) as exc:
+        print(f"bundle {cmd}: {exc}", file=sys.stderr)
+        return 2
+
+    print(f"bundle: unknown subcommand '{cmd}'", file=sys.stderr)
+    return 2
+
+
+def cmd_session_trace(args) -> int:
+    """Inspect or replay session traces recorded with MESMERGLASS_SESSION_TRACE."""
+
+    from mesmerglass.session import replay
+
+    cmd = getattr(args, "trace_cmd", "info")
+    try:
+        trace = replay.SessionTrace.load(args.trace)
+    except (OSError, ValueError) as exc:
+        print(f"session-trace {cmd}: {exc}", file=sys.stderr)
+        return 2
+
+    if cmd == "info":
+        stats = trace.stats()
+        if getattr(args, "json", False):
+            print(json.dumps(stats, indent=2))
+        else:
+            print(
+                f"{Path(args.trace).name}: '{stats['cuelist']}' recorded {stats['created']}, "
+                f"{stats['duration_s']:.1f}s, seed {stats['seed']}"
+            )
+            records = ", ".join(f"{k}={v}" for k, v in sorted(stats["records"].items()))
+            events = ", ".join(f"{k}={v}" for k, v in sorted(stats["events"].items())) or "none"
+            print(f"  Records: {records} ({stats['clock_reads']} clock reads)")
+            print(f"  Events: {events}")
+        return 0
+
+    if cmd == "replay":
+        profiler = None
+        if args.profile:
+            import cProfile
+
+            profiler = cProfile.Profile()
+            profiler.enable()
+        try:
+            report = replay.replay(
+                trace,
+                realtime=bool(args.realtime),
+                decode_media=bool(args.decode_media),
+                top=max(1, int(args.top)),
+            )
+        finally:
+            if profiler is not None:
+                profiler.disable()
+                profiler.dump_stats(args.profile)
+        summary = report.to_dict()
+        if getattr(args, "json", False):
+            print(json.dumps(summary, indent=2, default=str))
+        else:
+            upd = summary["update_ms"]
+            print(
+                f"Replayed {summary['frames']} frames ({summary['virtual_s']:.1f}s session) "
+                f"in {summary['wall_s']:.2f}s"
+            )
+            print(f"  update(): p50 {upd['p50']:.3f}ms  p95 {upd['p95']:.3f}ms  p99 {upd['p99']:.3f}ms  max {upd['max']:.3f}ms")
+            for frame in summary["slowest"]:
+                print(f"    {frame['ms']:8.3f}ms at {frame['t_s']:8.3f}s (cue {frame['cue']})")
+            media = summary["media"]
+            if media["decoded"]:
+                print(f"  Media: {media['decoded']} decoded, p95 {media['p95_ms']:.1f}ms, max {media['max_ms']:.1f}ms")
+                for item in media["slowest"]:
+                    print(f"    {item['ms']:8.1f}ms {item['path']}")
+            if profiler is not None:
+                print(f"  Profile written to {args.profile}")
+        if report.divergences or report.clock_misses:
+            first = summary["first_divergence"]
+            print(
+                f"session-trace replay: diverged from the recording "
+                f"({report.divergences} event mismatches, {report.clock_misses} missing clock reads; first: {first})",
+                file=sys.stderr,
+            )
+            return 3
+        return 0
+
+    print(f"session-trace: unknown subcommand '{cmd}'", file=sys.stderr)
+    return 2
+
+
 def build_parser() -> argparse.ArgumentParser:
     logging_parent = _build_logging_parent()
     parser = argparse.ArgumentParser(
@@ -466,6 +575,32 @@ def build_parser() -> argparse.ArgumentParser:
     tb_self.add_argument("--require-videos", action="store_true", help="Require at least one video")
     tb_pull_image = tb_sub.add_parser("pull-image", parents=[tb_parent], help="Load a single ThemeBank image and print metadata")
     tb_pull_video = tb_sub.add_parser("pull-video", parents=[tb_parent], help="Select a ThemeBank video and print its path")
+
+    p_bundle = add_subparser("bundle", help="Pack a session and its media into one .mgbundle file, or inspect one")
+    bundle_sub = p_bundle.add_subparsers(dest="bundle_cmd", required=True)
+    bundle_pack = bundle_sub.add_parser("pack", help="Pack a .session.json and every file it references")
+    bundle_pack.add_argument("session", help="Path to the .session.json file")
+    bundle_pack.add_argument("-o", "--output", default=None, help="Bundle path (default: next to the session, .mgbundle)")
+    bundle_pack.add_argument("--json", action="store_true", help="Emit JSON summary instead of text")
+    bundle_info = bundle_sub.add_parser("info", help="Summarise a bundle's members")
+    bundle_info.add_argument("bundle", help="Path to the .mgbundle file")
+    bundle_info.add_argument("--list", action="store_true", help="List every member with offset and size")
+    bundle_info.add_argument("--json", action="store_true", help="Emit JSON payload instead of text")
+    bundle_verify = bundle_sub.add_parser("verify", help="Check every member against its CRC-32 (exit 3 on mismatch)")
+    bundle_verify.add_argument("bundle", help="Path to the .mgbundle file")
+
+    p_trace = add_subparser("session-trace", help="Inspect or replay a recorded session trace (.mgtrace.gz)")
+    trace_sub = p_trace.add_subparsers(dest="trace_cmd", required=True)
+    trace_info = trace_sub.add_parser("info", help="Summarise a trace's records and events")
+    trace_info.add_argument("trace", help="Trace written with MESMERGLASS_SESSION_TRACE set")
+    trace_info.add_argument("--json", action="store_true", help="Emit JSON payload instead of text")
+    trace_replay = trace_sub.add_parser("replay", help="Drive a headless SessionRunner through the trace and time update()")
+    trace_replay.add_argument("trace", help="Trace written with MESMERGLASS_SESSION_TRACE set")
+    trace_replay.add_argument("--realtime", action="store_true", help="Keep the recorded pace instead of running as fast as possible")
+    trace_replay.add_argument("--decode-media", action="store_true", help="Decode recorded images when they were shown")
+    trace_replay.add_argument("--top", type=int, default=10, help="Slowest frames to list (default: 10)")
+    trace_replay.add_argument("--profile", default=None, help="Write cProfile stats for the replay to this file")
+    trace_replay.add_argument("--json", action="store_true", help="Emit JSON report instead of text")
     
     # MesmerLoom spiral visual test (Phase 2 real implementation)
     p_spiral = add_subparser("spiral-test", help="Run a bounded MesmerLoom spiral render test")
@@ -621,8 +756,9 @@ def build_parser() -> argparse.ArgumentParser:
     p_vr_stream.add_argument("--host", type=str, default="0.0.0.0", help="Server host address (default: 0.0.0.0)")
     p_vr_stream.add_argument("--port", type=int, default=5555, help="TCP streaming port (default: 5555)")
     p_vr_stream.add_argument("--discovery-port", type=int, default=5556, help="UDP discovery port (default: 5556)")
-    p_vr_stream.add_argument("--encoder", choices=["auto", "nvenc", "jpeg"], default="auto",
-                           help="Encoder: auto (detect), nvenc (H.264 GPU), jpeg (CPU fallback)")
+    p_vr_stream.add_argument("--encoder", choices=["auto", "nvenc", "jpeg", "etc2", "hevc"], default="auto",
+                           help="Encoder: auto (detect), nvenc (H.264 GPU), jpeg (CPU fallback), etc2 (compressed textures, no headset decode), "
+                                "hevc (H.265 for headsets that advertise it, H.264 for the rest)")
     p_vr_stream.add_argument("--fps", type=int, default=30, help="Target FPS (default: 30)")
     p_vr_stream.add_argument("--quality", type=int, default=85, help="JPEG quality 1-100 (default: 85, ignored for NVENC)")
     p_vr_stream.add_argument("--bitrate", type=int, default=2000000, help="H.264 bitrate in bps (default: 2Mbps, ignored for JPEG)")
@@ -631,6 +767,19 @@ def build_parser() -> argparse.ArgumentParser:
     p_vr_stream.add_argument("--enable-images", action="store_true", help="Include image overlays in stream")
     p_vr_stream.add_argument("--intensity", type=float, default=0.75, help="Initial spiral intensity 0-1 (default: 0.75)")
     p_vr_stream.add_argument("--duration", type=float, default=0, help="Stream duration in seconds (0=infinite)")
+    p_vr_stream.add_argument("--record", type=str, default=None, metavar="PATH",
+                           help="Record the encoded H.264 stream to fragmented MP4 without re-encoding (.mp4 file or directory)")
+    p_vr_stream.add_argument("--hud", action="store_true",
+                           help="Show the headset performance overlay (frame-time graphs, bitrate, drops)")
+    p_vr_stream.add_argument("--asset-cache", action="store_true",
+                           help="JPEG/ETC2 only: send recurring frames once and show them from the headset's asset cache")
+    p_vr_stream.add_argument("--multicast", nargs="?", const="1", default=None, metavar="GROUP[:PORT]",
+                           help="Send each frame once to a UDP multicast group with FEC (default group 239.255.77.1:5557); "
+                                "headset TCP connections carry control only")
+    p_vr_stream.add_argument("--adaptive-fps", action="store_true",
+                           help="Lower the frame rate while the spiral and media are calm (--fps stays the ceiling)")
+    p_vr_stream.add_argument("--headless", action="store_true",
+                           help="Render offscreen at the stream's fps and size only (no window; runs without a display)")
     
     p_vr_test = add_subparser("vr-test", help="Test VR streaming with generated pattern (no full app)")
     p_vr_test.add_argument("--pattern", choices=["checkerboard", "gradient", "noise", "spiral"], default="checkerboard",
@@ -638,12 +787,73 @@ def build_parser() -> argparse.ArgumentParser:
     p_vr_test.add_argument("--host", type=str, default="0.0.0.0", help="Server host address")
     p_vr_test.add_argument("--port", type=int, default=5555, help="TCP streaming port")
     p_vr_test.add_argument("--discovery-port", type=int, default=5556, help="UDP discovery port")
-    p_vr_test.add_argument("--encoder", choices=["auto", "nvenc", "jpeg"], default="auto", help="Encoder type")
+    p_vr_test.add_argument("--encoder", choices=["auto", "nvenc", "jpeg", "etc2", "hevc"], default="auto", help="Encoder type")
     p_vr_test.add_argument("--fps", type=int, default=30, help="Target FPS")
     p_vr_test.add_argument("--width", type=int, default=1920, help="Frame width (default: 1920)")
     p_vr_test.add_argument("--height", type=int, default=1080, help="Frame height (default: 1080)")
     p_vr_test.add_argument("--quality", type=int, default=85, help="JPEG quality (default: 85)")
     p_vr_test.add_argument("--duration", type=int, default=0, help="Duration in seconds (0=infinite)")
+    p_vr_test.add_argument("--hud", action="store_true", help="Show the headset performance overlay")
+    p_vr_test.add_argument("--asset-cache", action="store_true",
+                          help="JPEG/ETC2 only: send recurring frames once and show them from the headset's asset cache")
+    p_vr_test.add_argument("--multicast", nargs="?", const="1", default=None, metavar="GROUP[:PORT]",
+                          help="Send each frame once to a UDP multicast group with FEC (default group 239.255.77.1:5557)")
+    p_vr_test.add_argument("--adaptive-fps", action="store_true",
+                          help="Lower the frame rate while the pattern is calm (--fps stays the ceiling)")
+
+    p_vr_bench = add_subparser("vr-bench", help="Benchmark the streaming chain end to end over loopback TCP (no headset)")
+    p_vr_bench.add_argument("--encoders", type=str, default="jpeg,etc2,x264,nvenc,x265",
+                            help="Comma list of encoders: jpeg, etc2, x264, nvenc, x265 (default: all; unavailable ones are reported as skipped)")
+    p_vr_bench.add_argument("--protocols", type=str, default=None,
+                            help="Comma list of protocols to keep: VRHP, VRHT, VRH2, VRH3, VRH4 (default: all valid for each encoder)")
+    p_vr_bench.add_argument("--frames", type=int, default=120, help="Measured frames per combination (default: 120)")
+    p_vr_bench.add_argument("--warmup", type=int, default=10, help="Unmeasured frames before measuring (default: 10)")
+    p_vr_bench.add_argument("--source", choices=["software", "gl"], default="software",
+                            help="Frame source: numpy patterns, or OffscreenGL with glReadPixels capture (default: software)")
+    p_vr_bench.add_argument("--pattern", choices=["spiral", "checkerboard", "noise", "grid", "solid"], default=None,
+                            help="Pattern (software: spiral/checkerboard/noise, gl: grid/solid; default: spiral or grid)")
+    p_vr_bench.add_argument("--size", type=str, default="1920x1080", help="Render size WxH (default: 1920x1080)")
+    p_vr_bench.add_argument("--target", type=str, default=None,
+                            help="Streaming size WxH (default: the server's per-encoder size, 2048x1024 or 1024x512 for etc2)")
+    p_vr_bench.add_argument("--fps", type=int, default=60, help="Nominal FPS for rate control and VRH3 timing (default: 60)")
+    p_vr_bench.add_argument("--quality", type=int, default=25, help="JPEG quality (default: 25, the server default)")
+    p_vr_bench.add_argument("--bitrate", type=int, default=120_000_000, help="H.264 bitrate in bps (default: 120 Mbps)")
+    p_vr_bench.add_argument("--stereo-offset", type=int, default=0, help="Stereo parallax offset in pixels (0=mono packets)")
+    p_vr_bench.add_argument("--json", action="store_true", help="Print the JSON report instead of a table")
+    p_vr_bench.add_argument("--output", type=str, default=None, metavar="PATH", help="Also write the JSON report to PATH")
+
+    p_vr_host = add_subparser("vr-host", help="Serve several headless streaming sessions from one process (shared caches, fair encoder scheduling)")
+    p_vr_host.add_argument("--sessions", type=int, default=2, help="Number of sessions (default: 2)")
+    p_vr_host.add_argument("--host", type=str, default="0.0.0.0", help="Server host address (default: 0.0.0.0)")
+    p_vr_host.add_argument("--base-port", type=int, default=5560, help="TCP port of the first session; others follow (default: 5560)")
+    p_vr_host.add_argument("--discovery-port", type=int, default=5556, help="UDP discovery port, 0 to disable (default: 5556)")
+    p_vr_host.add_argument("--encoder", choices=["auto", "nvenc", "jpeg", "etc2", "hevc"], default="jpeg", help="Encoder for every session (default: jpeg)")
+    p_vr_host.add_argument("--fps", type=int, default=30, help="Target FPS per session (default: 30)")
+    p_vr_host.add_argument("--size", type=str, default="1920x1080", help="Render size WxH (default: 1920x1080)")
+    p_vr_host.add_argument("--target", type=str, default=None, help="Streaming size WxH (default: the server's per-encoder size)")
+    p_vr_host.add_argument("--session", action="append", default=None, metavar="FILE",
+                           help="Session file (.session.json or .mgbundle) to stream; repeat for one session per file (overrides --sessions)")
+    p_vr_host.add_argument("--cuelist", type=str, default=None, help="Cuelist to play from each session file (default: the active cuelist)")
+    p_vr_host.add_argument("--pattern", choices=["spiral", "checkerboard", "noise"], default="spiral", help="Test pattern when no --session is given (default: spiral)")
+    p_vr_host.add_argument("--quality", type=int, default=25, help="JPEG quality (default: 25)")
+    p_vr_host.add_argument("--bitrate", type=int, default=20_000_000, help="H.264 bitrate per session in bps (default: 20 Mbps)")
+    p_vr_host.add_argument("--encode-slots", type=int, default=1, help="Concurrent encodes across all sessions (default: 1)")
+    p_vr_host.add_argument("--image-pool-mb", type=float, default=None,
+                           help="Shared decoded-image pool budget in MiB (default: MESMERGLASS_SHARED_IMAGE_POOL_MB)")
+    p_vr_host.add_argument("--duration", type=float, default=0, help="Run time in seconds (0=until Ctrl+C)")
+    p_vr_host.add_argument("--load-clients", type=int, default=0,
+                           help="Attach N local load clients per session and print a capacity report (needs --duration)")
+    p_vr_host.add_argument("--json", action="store_true", help="Print JSON reports instead of tables")
+
+    p_vr_load = add_subparser("vr-load", help="Load-test streaming sessions with headset-like TCP clients and report capacity")
+    p_vr_load.add_argument("--host", type=str, default="127.0.0.1", help="Server address (default: 127.0.0.1)")
+    p_vr_load.add_argument("--ports", type=str, default="5560",
+                           help="Comma list of ports or ranges, e.g. 5560-5563 (default: 5560)")
+    p_vr_load.add_argument("--clients", type=int, default=1, help="Clients per port (default: 1)")
+    p_vr_load.add_argument("--duration", type=float, default=10.0, help="Measured seconds (default: 10)")
+    p_vr_load.add_argument("--warmup", type=float, default=1.0, help="Unmeasured seconds after connecting (default: 1)")
+    p_vr_load.add_argument("--fps", type=float, default=30.0, help="Target FPS for the capacity verdict (default: 30)")
+    p_vr_load.add_argument("--json", action="store_true", help="Print the JSON report instead of a table")
 
 
     return parser
@@ -2919,51 +3129,57 @@ def cmd_vr_stream(args) -> int:
     encoder_map = {
         "auto": EncoderType.AUTO,
         "nvenc": EncoderType.NVENC,
-        "jpeg": EncoderType.JPEG
+        "jpeg": EncoderType.JPEG,
+        "etc2": EncoderType.ETC2,
+        "hevc": EncoderType.HEVC,
     }
     encoder_type = encoder_map[args.encoder]
+    headless = bool(getattr(args, "headless", False))
     
     # Create Qt application (needed for OpenGL)
-    app = QApplication(sys.argv)
+    if headless:
+        from PyQt6.QtGui import QGuiApplication
+        from mesmerglass.vr.offscreen import ensure_headless_platform
+
+        ensure_headless_platform()
+        app = QGuiApplication(sys.argv)
+    else:
+        app = QApplication(sys.argv)
     
     # Create spiral director
     director = SpiralDirector()
     director.set_intensity(args.intensity)
     
-    # Create compositor
-    compositor = LoomCompositor(director)
-    compositor.set_active(True)
-    
-    # CRITICAL: Show compositor to start rendering (needed for VR frame capture)
-    # The compositor must be visible and actively calling paintGL() to capture frames
-    compositor.show()
-    compositor.showFullScreen()  # Fullscreen for maximum immersion
-    compositor.raise_()  # Bring to front
-    compositor.activateWindow()  # Activate window
-    
     logger.info("Creating VR streaming server...")
 
     # Cache latest frame from Qt/GL thread; server thread polls via frame_callback.
     last_frame = None
-    frame_lock = threading.Lock()
+    frame_generation = 0
+    taken = threading.local()  # per client producer thread
+    frame_cond = threading.Condition()
 
     def on_vr_frame(frame):
-        nonlocal last_frame
+        nonlocal last_frame, frame_generation
         if frame is None:
             return
         try:
-            with frame_lock:
-                last_frame = frame.copy()
+            # Capture frames are pooled per delivery and never written again; keep a reference.
+            with frame_cond:
+                last_frame = frame
+                frame_generation += 1
+                frame_cond.notify_all()
         except Exception as exc:  # pragma: no cover - defensive
             logger.debug("VR frame cache error: %s", exc)
 
-    compositor.enable_vr_streaming(on_vr_frame)
-
     def get_frame():
-        with frame_lock:
-            if last_frame is None:
-                return None
-            return last_frame.copy()
+        with frame_cond:
+            if headless:
+                # Every headless frame is rendered for the stream: encode each exactly once per client.
+                seen = getattr(taken, "generation", 0)
+                if not frame_cond.wait_for(lambda: frame_generation != seen, timeout=0.1):
+                    return None
+                taken.generation = frame_generation
+            return last_frame
 
     server = VRStreamingServer(
         host=args.host,
@@ -2976,8 +3192,36 @@ def cmd_vr_stream(args) -> int:
         quality=args.quality,
         bitrate=args.bitrate,
         stereo_offset=args.stereo_offset,
-        frame_callback=get_frame
+        frame_callback=get_frame,
+        record_path=getattr(args, "record", None),
+        hud=True if getattr(args, "hud", False) else None,
+        asset_cache=True if getattr(args, "asset_cache", False) else None,
+        multicast=getattr(args, "multicast", None),
+        adaptive_fps=True if getattr(args, "adaptive_fps", False) else None,
     )
+
+    # Create compositor
+    if headless:
+        from mesmerglass.mesmerloom.headless_compositor import LoomHeadlessCompositor
+
+        # Render straight at the streamed size so the server never resizes.
+        compositor = LoomHeadlessCompositor(director, server.target_width, server.target_height, fps=args.fps)
+        if not compositor.available:
+            logger.error("Headless OpenGL context unavailable")
+            return 1
+        compositor.enable_vr_streaming(on_vr_frame)
+        compositor.start()
+    else:
+        compositor = LoomCompositor(director)
+        compositor.set_active(True)
+
+        # CRITICAL: Show compositor to start rendering (needed for VR frame capture)
+        # The compositor must be visible and actively calling paintGL() to capture frames
+        compositor.show()
+        compositor.showFullScreen()  # Fullscreen for maximum immersion
+        compositor.raise_()  # Bring to front
+        compositor.activateWindow()  # Activate window
+        compositor.enable_vr_streaming(on_vr_frame)
     
     logger.info("=" * 60)
     logger.info("MesmerVisor VR Streaming Active")
@@ -2986,6 +3230,8 @@ def cmd_vr_stream(args) -> int:
     logger.info(f"Address: {args.host}:{args.port}")
     logger.info(f"Discovery: UDP {args.discovery_port}")
     logger.info(f"FPS: {args.fps}")
+    if headless:
+        logger.info(f"Headless render: {server.target_width}x{server.target_height}")
     logger.info("=" * 60)
     logger.info("Waiting for VR clients to connect...")
     logger.info("(Press Ctrl+C to stop)")
@@ -3008,10 +3254,294 @@ def cmd_vr_stream(args) -> int:
     except Exception:
         pass
     compositor.disable_vr_streaming()
+    if headless:
+        logger.info("Headless render stats: %s", compositor.stats())
+        compositor.cleanup()
     
     return 0
 
 
+def cmd_vr_bench(args) -> int:
+    """Benchmark render -> encode -> packetize -> loopback TCP -> receive -> decode.
+
+    Exit codes:
+      0 at least one encoder/protocol combination ran
+      1 nothing ran (all skipped or failed)
+      2 invalid arguments
+      77 OpenGL unavailable (--source gl)
+    """
+    from mesmerglass.mesmervisor.pipeline_bench import (
+        BenchConfig,
+        format_report,
+        run_benchmark,
+        select_combinations,
+    )
+
+    def _size(value: str) -> tuple:
+        w_str, h_str = value.lower().split("x", 1)
+        w, h = int(w_str), int(h_str)
+        if w <= 0 or h <= 0:
+            raise ValueError(value)
+        return w, h
+
+    try:
+        width, height = _size(args.size)
+        target = _size(args.target) if args.target else None
+        combos = select_combinations(
+            [e for e in args.encoders.split(",") if e.strip()],
+            [p for p in args.protocols.split(",") if p.strip()] if args.protocols else None,
+        )
+    except ValueError as e:
+        print(f"vr-bench: {e}", file=sys.stderr)
+        return 2
+    pattern = args.pattern or ("grid" if args.source == "gl" else "spiral")
+    if (args.source == "gl") != (pattern in ("grid", "solid")):
+        print(f"vr-bench: pattern '{pattern}' is not available for --source {args.source}", file=sys.stderr)
+        return 2
+    if not combos:
+        print("vr-bench: no encoder/protocol combination selected", file=sys.stderr)
+        return 2
+
+    cfg = BenchConfig(
+        frames=max(1, int(args.frames)),
+        warmup=max(0, int(args.warmup)),
+        source=args.source,
+        pattern=pattern,
+        width=width,
+        height=height,
+        target=target,
+        fps=max(1, int(args.fps)),
+        quality=int(args.quality),
+        bitrate=int(args.bitrate),
+        stereo_offset=int(args.stereo_offset),
+    )
+
+    def _progress(msg: str) -> None:
+        if not args.json:
+            print(msg, file=sys.stderr, flush=True)
+
+    try:
+        report = run_benchmark(combos, cfg, progress=_progress)
+    except Exception as e:
+        if args.source == "gl":
+            print(f"vr-bench: OpenGL unavailable: {e}", file=sys.stderr)
+            return 77
+        raise
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=2)
+    if args.json:
+        print(json.dumps(report, indent=2))
+    else:
+        print(format_report(report))
+    return 0 if any(r["status"] == "ok" for r in report["results"]) else 1
+
+
+def _parse_size_arg(value: str) -> tuple:
+    w_str, h_str = value.lower().split("x", 1)
+    w, h = int(w_str), int(h_str)
+    if w <= 0 or h <= 0:
+        raise ValueError(value)
+    return w, h
+
+
+def cmd_vr_host(args) -> int:
+    """Serve several headless streaming sessions from one process.
+
+    With --session each file is played by its own SessionRunner and rendered by
+    a headless compositor; the Qt event loop then runs on the main thread and
+    reporting / load clients on a worker. Without it every session streams a
+    software test pattern.
+
+    Exit codes:
+      0 success (with --load-clients: every session sustained the target fps)
+      1 with --load-clients: at least one session fell short; or a session
+        could not be rendered (no offscreen GL context)
+      2 invalid arguments
+    """
+    import asyncio
+    import threading
+    import time as _time
+    from mesmerglass.mesmervisor.load_client import capacity_summary, format_load_report, run_load
+    from mesmerglass.mesmervisor.session_host import MultiSessionHost, SessionSpec, format_host_report
+
+    logger = logging.getLogger(__name__)
+    try:
+        width, height = _parse_size_arg(args.size)
+        target = _parse_size_arg(args.target) if args.target else None
+    except ValueError as e:
+        print(f"vr-host: invalid size {e}", file=sys.stderr)
+        return 2
+    session_files = list(getattr(args, "session", None) or [])
+    count = len(session_files) or args.sessions
+    if count < 1:
+        print("vr-host: --sessions must be at least 1", file=sys.stderr)
+        return 2
+    if args.load_clients > 0 and args.duration <= 0:
+        print("vr-host: --load-clients needs --duration", file=sys.stderr)
+        return 2
+
+    specs = [
+        SessionSpec(
+            name=f"session{i + 1}",
+            port=args.base_port + i,
+            encoder=args.encoder,
+            fps=args.fps,
+            width=width,
+            height=height,
+            target=target,
+            quality=args.quality,
+            bitrate=args.bitrate,
+            pattern=args.pattern,
+            session=session_files[i] if session_files else None,
+            cuelist=getattr(args, "cuelist", None),
+        )
+        for i in range(count)
+    ]
+
+    app = None
+    if session_files:
+        from PyQt6.QtGui import QGuiApplication
+        from mesmerglass.vr.offscreen import ensure_headless_platform
+
+        ensure_headless_platform()
+        app = QGuiApplication.instance() or QGuiApplication(sys.argv)
+
+    try:
+        host = MultiSessionHost(
+            specs,
+            host=args.host,
+            discovery_port=args.discovery_port or None,
+            encode_slots=args.encode_slots,
+            image_pool_mb=args.image_pool_mb,
+        )
+    except ValueError as e:
+        print(f"vr-host: {e}", file=sys.stderr)
+        return 2
+    except RuntimeError as e:
+        print(f"vr-host: {e}", file=sys.stderr)
+        return 1
+    try:
+        host.start()
+    except RuntimeError as e:
+        print(f"vr-host: {e}", file=sys.stderr)
+        host.stop()
+        return 1
+
+    stop = threading.Event()
+
+    def serve() -> int:
+        if args.load_clients > 0:
+            _time.sleep(0.5)  # let every session bind
+            connect = "127.0.0.1" if args.host in ("0.0.0.0", "") else args.host
+            results = asyncio.run(run_load(
+                [(connect, s.port) for s in specs],
+                duration=args.duration,
+                clients_per_target=args.load_clients,
+            ))
+            summary = capacity_summary(results, args.fps)
+            summary["host"] = host.report()
+            if args.json:
+                print(json.dumps(summary, indent=2))
+            else:
+                print(format_host_report(summary["host"]))
+                print(format_load_report(summary))
+            return 0 if summary["sustained_sessions"] == summary["sessions"] else 1
+        deadline = _time.time() + args.duration if args.duration > 0 else None
+        while deadline is None or _time.time() < deadline:
+            if stop.wait(min(10.0, max(0.0, deadline - _time.time())) if deadline else 10.0):
+                break
+            report = host.report()
+            print(json.dumps(report) if args.json else format_host_report(report), flush=True)
+        return 0
+
+    exit_code = 0
+    try:
+        if app is None:
+            exit_code = serve()
+        else:
+            # Session compositors render on Qt timers, so the main thread runs the
+            # event loop while the reports or load clients run on a worker.
+            import signal
+            from PyQt6.QtCore import QTimer
+
+            result = {"code": 0}
+
+            def worker():
+                try:
+                    result["code"] = serve()
+                except Exception as e:
+                    logger.error("vr-host failed: %s", e)
+                    result["code"] = 1
+                finally:
+                    stop.set()
+
+            def on_sigint(signum, frame):
+                stop.set()
+
+            thread = threading.Thread(target=worker, name="vr-host-serve", daemon=True)
+            poll = QTimer()
+            poll.timeout.connect(lambda: app.quit() if stop.is_set() else None)
+            poll.start(100)  # also lets Python run the SIGINT handler
+            previous = signal.signal(signal.SIGINT, on_sigint)
+            try:
+                thread.start()
+                app.exec()
+            finally:
+                signal.signal(signal.SIGINT, previous)
+                poll.stop()
+            stop.set()
+            thread.join(timeout=5.0)
+            exit_code = result["code"]
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stop.set()
+        host.stop()
+    return exit_code
+
+
+def cmd_vr_load(args) -> int:
+    """Load-test streaming ports and report capacity.
+
+    Exit codes:
+      0 every session sustained the target fps
+      1 at least one session fell short or could not be reached
+      2 invalid arguments
+    """
+    import asyncio
+    from mesmerglass.mesmervisor.load_client import capacity_summary, format_load_report, run_load
+
+    ports = []
+    try:
+        for part in args.ports.split(","):
+            part = part.strip()
+            if not part:
+                continue
+            if "-" in part:
+                lo, hi = (int(x) for x in part.split("-", 1))
+                ports.extend(range(lo, hi + 1))
+            else:
+                ports.append(int(part))
+    except ValueError:
+        print(f"vr-load: invalid --ports {args.ports!r}", file=sys.stderr)
+        return 2
+    if not ports:
+        print("vr-load: no ports given", file=sys.stderr)
+        return 2
+
+    results = asyncio.run(run_load(
+        [(args.host, p) for p in ports],
+        duration=max(0.1, args.duration),
+        clients_per_target=args.clients,
+        warmup=max(0.0, args.warmup),
+    ))
+    summary = capacity_summary(results, args.fps)
+    print(json.dumps(summary, indent=2) if args.json else format_load_report(summary))
+    return 0 if summary["sustained_sessions"] == summary["sessions"] else 1
+
+
 def cmd_vr_test(args) -> int:
     """Test VR streaming with generated pattern
     
@@ -3033,7 +3563,9 @@ def cmd_vr_test(args) -> int:
     encoder_map = {
         "auto": EncoderType.AUTO,
         "nvenc": EncoderType.NVENC,
-        "jpeg": EncoderType.JPEG
+        "jpeg": EncoderType.JPEG,
+        "etc2": EncoderType.ETC2,
+        "hevc": EncoderType.HEVC,
     }
     encoder_type = encoder_map[args.encoder]
     
@@ -3061,7 +3593,11 @@ def cmd_vr_test(args) -> int:
             width=args.width,
             height=args.height,
             fps=args.fps,
-            quality=args.quality
+            quality=args.quality,
+            hud=True if args.hud else None,
+            asset_cache=True if args.asset_cache else None,
+            multicast=args.multicast,
+            adaptive_fps=True if args.adaptive_fps else None,
         ))
     except KeyboardInterrupt:
         logger.info("\nShutting down...")
@@ -3676,8 +4212,18 @@ def main(argv: Optional[list[str]] = None) -> int:
         return cmd_vr_stream(args)
     if cmd == "vr-test":
         return cmd_vr_test(args)
+    if cmd == "vr-bench":
+        return cmd_vr_bench(args)
+    if cmd == "vr-host":
+        return cmd_vr_host(args)
+    if cmd == "vr-load":
+        return cmd_vr_load(args)
     if cmd == "themebank":
         return cmd_themebank(args)
+    if cmd == "bundle":
+        return cmd_bundle(args)
+    if cmd == "session-trace":
+        return cmd_session_trace(args)
 
     parser.print_help()
     return 2
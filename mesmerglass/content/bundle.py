@@ -0,0 +1,683 @@
+"""Single-file session bundles (``.mgbundle``).
+
+A session normally references media scattered across Media Bank directories
+(see ``docs/technical/custom-media-directories.md``) and audio files anywhere
+on disk. Opening one on another machine, or from a NAS, costs thousands of
+small-file opens and directory walks before the first cue plays. A bundle
+packs the session JSON and every file it references into one file:
+
+- Members are laid out in the order the session is predicted to need them
+  (session JSON, fonts, then cue by cue: audio, then images of the Media Bank
+  entries that cue's playbacks select; videos last). Reading the bundle front
+  to back therefore follows playback order.
+- Every member starts on a 4 KiB boundary, so the file can be mapped and a
+  member handed to a decoder as a zero-copy ``memoryview``.
+- A JSON index at the end lists name, offset, size, kind and CRC-32 per member.
+
+Layout::
+
+    [64-byte header: magic, version, alignment, entry count, index offset/size]
+    [member 0][pad][member 1][pad]...
+    [index JSON]
+
+Loaders keep using paths. A mounted bundle exposes its members under the
+bundle's own path, the way zipimport does (``D:/x/trance.mgbundle/bank/0/a.jpg``).
+``lookup``/``exists``/``list_files``/``source_for`` resolve those paths, and
+image, video, audio and font loaders read straight from the mapping instead of
+opening files. ``SessionBundle.prefetch`` warms the OS cache in member order
+with large sequential reads.
+"""
+from __future__ import annotations
+
+import copy
+import io
+import json
+import logging
+import mmap
+import os
+import struct
+import threading
+import time
+import zlib
+from dataclasses import dataclass
+from datetime import datetime
+from pathlib import Path
+from typing import Any, Callable, Optional, Union
+
+logger = logging.getLogger(__name__)
+
+BUNDLE_SUFFIX = ".mgbundle"
+BUNDLE_MAGIC = b"MGBUNDLE"
+BUNDLE_VERSION = 1
+ALIGNMENT = 4096
+HEADER_SIZE = 64
+# Session strings that name a bundle member (rewritten to mount paths on open).
+MEMBER_PREFIX = "mgbundle:"
+SESSION_MEMBER = "session.json"
+
+# magic, version, alignment, entry_count, index_offset, index_size
+_HEADER = struct.Struct("<8sIIIQQ")
+_COPY_CHUNK = 8 * 1024 * 1024
+
+PathLike = Union[str, Path]
+
+
+class BundleError(ValueError):
+    """The file is not a readable session bundle."""
+
+
+@dataclass(frozen=True)
+class BundleEntry:
+    name: str  # "/"-separated member name
+    offset: int
+    size: int
+    kind: str  # session | font | audio | image | video | media
+    crc32: int
+
+
+def is_bundle_file(path: PathLike) -> bool:
+    return str(path).lower().endswith(BUNDLE_SUFFIX)
+
+
+# ---- writing ------------------------------------------------------------
+
+class _Plan:
+    """Ordered member list; each source file is packed once."""
+
+    def __init__(self) -> None:
+        self.members: list[tuple[str, Path, str]] = []
+        self._by_source: dict[str, str] = {}
+        self._names: set[str] = set()
+
+    def add(self, source: Path, name: str, kind: str) -> str:
+        key = os.path.normcase(str(source.resolve()))
+        existing = self._by_source.get(key)
+        if existing is not None:
+            return existing
+        base, n = name, 1
+        while name in self._names:
+            stem, dot, ext = base.rpartition(".")
+            name = f"{stem}-{n}.{ext}" if dot else f"{base}-{n}"
+            n += 1
+        self._names.add(name)
+        self._by_source[key] = name
+        self.members.append((name, source, kind))
+        return name
+
+
+def _cue_order(session: dict) -> list[dict]:
+    """Cues in predicted play order: the active cuelist first, then the others."""
+    cuelists = session.get("cuelists") or {}
+    if not isinstance(cuelists, dict):
+        return []
+    names = list(cuelists.keys())
+    active = (session.get("runtime") or {}).get("active_cuelist")
+    if active in cuelists:
+        names.remove(active)
+        names.insert(0, active)
+    cues: list[dict] = []
+    for name in names:
+        data = cuelists.get(name)
+        if isinstance(data, dict):
+            cues.extend(c for c in data.get("cues") or [] if isinstance(c, dict))
+    return cues
+
+
+def _audio_blocks(cue: dict) -> list[dict]:
+    """Every dict in a cue that carries an audio ``file`` (new and legacy schema)."""
+    blocks: list[dict] = []
+    audio = cue.get("audio")
+    if isinstance(audio, dict):
+        blocks.extend(v for v in audio.values() if isinstance(v, dict) and v.get("file"))
+    blocks.extend(t for t in cue.get("audio_tracks") or [] if isinstance(t, dict) and t.get("file"))
+    return blocks
+
+
+def _cue_playbacks(session: dict, cue: dict) -> list[dict]:
+    playbacks = session.get("playbacks") or {}
+    found = []
+    for entry in cue.get("playback_pool") or []:
+        key = entry.get("playback") if isinstance(entry, dict) else None
+        pb = playbacks.get(key) if isinstance(playbacks, dict) and key is not None else None
+        if isinstance(pb, dict):
+            found.append(pb)
+    return found
+
+
+def plan_bundle(session: dict) -> tuple[dict, list[tuple[str, Path, str]]]:
+    """Return the session rewritten to member references and the ordered member list.
+
+    Missing files and directories are skipped (and logged); the rewritten
+    reference then points at a member that does not exist, exactly as the
+    original pointed at a missing path.
+    """
+    from .media_scan import scan_font_directory, scan_media_directory
+
+    packed = copy.deepcopy(session)
+    plan = _Plan()
+
+    bank = packed.get("media_bank") or []
+    bank_files: dict[int, tuple[list[Path], list[Path]]] = {}
+    font_banks: list[int] = []
+    for i, entry in enumerate(bank):
+        if not isinstance(entry, dict) or not entry.get("path"):
+            continue
+        root = Path(entry["path"]).expanduser()
+        if not root.is_dir():
+            logger.warning("[bundle] Media Bank entry %r missing: %s", entry.get("name"), root)
+            continue
+        kind = (entry.get("type") or "both").lower()
+        if kind == "fonts":
+            font_banks.append(i)
+            bank_files[i] = ([Path(p) for p in sorted(scan_font_directory(root))], [])
+        else:
+            images, videos = scan_media_directory(root)
+            bank_files[i] = (
+                [Path(p) for p in sorted(images)] if kind != "videos" else [],
+                [Path(p) for p in sorted(videos)] if kind != "images" else [],
+            )
+        entry["_root"] = root  # removed below
+
+    def bank_member(i: int, path: Path) -> str:
+        rel = path.resolve().relative_to(bank[i]["_root"].resolve()).as_posix()
+        return f"bank/{i}/{rel}"
+
+    def add_file(raw: Any, folder: str, kind: str) -> Optional[str]:
+        if not isinstance(raw, str) or not raw or raw.startswith(MEMBER_PREFIX):
+            return None
+        src = Path(raw).expanduser()
+        if not src.is_file():
+            logger.warning("[bundle] Skipping missing %s file: %s", kind, src)
+            return None
+        return MEMBER_PREFIX + plan.add(src, f"{folder}/{src.name}", kind)
+
+    # Fonts are needed as soon as the first text shows.
+    for i in font_banks:
+        for path in bank_files[i][0]:
+            plan.add(path, bank_member(i, path), "font")
+
+    # Cue by cue: audio, explicit files, then images of newly selected banks.
+    used_banks: list[int] = []
+    for cue in _cue_order(packed):
+        for block in _audio_blocks(cue):
+            ref = add_file(block["file"], "audio", "audio")
+            if ref:
+                block["file"] = ref
+        for pb in _cue_playbacks(packed, cue):
+            media = pb.get("media") if isinstance(pb.get("media"), dict) else {}
+            text = pb.get("text") if isinstance(pb.get("text"), dict) else {}
+            for key, kind in (("image_path", "image"), ("video_path", "video")):
+                ref = add_file(media.get(key), "media", kind)
+                if ref:
+                    media[key] = ref
+            ref = add_file(text.get("font_path"), "fonts", "font")
+            if ref:
+                text["font_path"] = ref
+            for i in media.get("bank_selections", [0, 1]) or []:
+                if isinstance(i, int) and i in bank_files and i not in used_banks and i not in font_banks:
+                    used_banks.append(i)
+                    for path in bank_files[i][0]:
+                        plan.add(path, bank_member(i, path), "image")
+
+    # Banks no cue selects explicitly, then videos (streamed, and the bulk of the bytes).
+    rest = [i for i in sorted(bank_files) if i not in used_banks and i not in font_banks]
+    for i in rest:
+        for path in bank_files[i][0]:
+            plan.add(path, bank_member(i, path), "image")
+    for i in used_banks + rest:
+        for path in bank_files[i][1]:
+            plan.add(path, bank_member(i, path), "video")
+
+    # Any playback not used by a cue still gets its explicit files.
+    for pb in (packed.get("playbacks") or {}).values():
+        if not isinstance(pb, dict):
+            continue
+        media = pb.get("media") if isinstance(pb.get("media"), dict) else {}
+        for key, kind in (("image_path", "image"), ("video_path", "video")):
+            ref = add_file(media.get(key), "media", kind)
+            if ref:
+                media[key] = ref
+
+    for i, entry in enumerate(bank):
+        if isinstance(entry, dict) and entry.pop("_root", None) is not None:
+            entry["path"] = f"{MEMBER_PREFIX}bank/{i}"
+    return packed, plan.members
+
+
+def _pad(fh, alignment: int) -> None:
+    pos = fh.tell()
+    extra = (-pos) % alignment
+    if extra:
+        fh.write(b"\0" * extra)
+
+
+def write_bundle(
+    session_path: PathLike,
+    out_path: Optional[PathLike] = None,
+    *,
+    progress: Optional[Callable[[int, int, str], None]] = None,
+) -> dict:
+    """Pack ``session_path`` and everything it references into one bundle.
+
+    Returns a summary dict (path, entries, bytes, per-kind counts, seconds).
+    The bundle is written to a temporary name and renamed when complete.
+    """
+    session_path = Path(session_path)
+    if out_path is None:
+        name = session_path.name
+        stem = name[: -len(".session.json")] if name.endswith(".session.json") else session_path.stem
+        out_path = session_path.with_name(stem + BUNDLE_SUFFIX)
+    out_path = Path(out_path)
+    start = time.perf_counter()
+
+    with open(session_path, "r", encoding="utf-8") as f:
+        session = json.load(f)
+    packed, members = plan_bundle(session)
+    session_bytes = json.dumps(packed, indent=2, ensure_ascii=False).encode("utf-8")
+
+    entries: list[dict] = []
+    kinds: dict[str, int] = {}
+    out_path.parent.mkdir(parents=True, exist_ok=True)
+    tmp_path = out_path.with_name(out_path.name + ".part")
+    buf = bytearray(_COPY_CHUNK)
+    view = memoryview(buf)
+    try:
+        with open(tmp_path, "wb") as out:
+            out.write(b"\0" * HEADER_SIZE)
+            _pad(out, ALIGNMENT)
+
+            offset = out.tell()
+            out.write(session_bytes)
+            entries.append(
+                {"name": SESSION_MEMBER, "offset": offset, "size": len(session_bytes), "kind": "session", "crc32": zlib.crc32(session_bytes)}
+            )
+            total = len(members)
+            for n, (name, src, kind) in enumerate(members, 1):
+                _pad(out, ALIGNMENT)
+                offset = out.tell()
+                crc = 0
+                size = 0
+                with open(src, "rb") as f:
+                    while True:
+                        got = f.readinto(buf)
+                        if not got:
+                            break
+                        out.write(view[:got])
+                        crc = zlib.crc32(view[:got], crc)
+                        size += got
+                entries.append({"name": name, "offset": offset, "size": size, "kind": kind, "crc32": crc})
+                kinds[kind] = kinds.get(kind, 0) + 1
+                if progress is not None:
+                    progress(n, total, name)
+
+            _pad(out, ALIGNMENT)
+            index_offset = out.tell()
+            index = {
+                "version": BUNDLE_VERSION,
+                "created": datetime.now().isoformat(timespec="seconds"),
+                "source": session_path.name,
+                "order": "first-use",
+                "entries": entries,
+            }
+            index_bytes = json.dumps(index, separators=(",", ":"), ensure_ascii=False).encode("utf-8")
+            out.write(index_bytes)
+            out.seek(0)
+            out.write(_HEADER.pack(BUNDLE_MAGIC, BUNDLE_VERSION, ALIGNMENT, len(entries), index_offset, len(index_bytes)))
+        os.replace(tmp_path, out_path)
+    except BaseException:
+        try:
+            tmp_path.unlink()
+        except OSError:
+            pass
+        raise
+
+    return {
+        "path": str(out_path),
+        "entries": len(entries),
+        "bytes": out_path.stat().st_size,
+        "kinds": kinds,
+        "seconds": round(time.perf_counter() - start, 3),
+    }
+
+
+# ---- reading ------------------------------------------------------------
+
+class _MemberIO(io.RawIOBase):
+    """Read-only, seekable file object over one member of a mapped bundle."""
+
+    def __init__(self, data: memoryview, name: str) -> None:
+        super().__init__()
+        self._data = data
+        self._pos = 0
+        self.name = name
+
+    def readable(self) -> bool:
+        return True
+
+    def seekable(self) -> bool:
+        return True
+
+    def readinto(self, b) -> int:
+        n = max(0, min(len(b), len(self._data) - self._pos))
+        b[:n] = self._data[self._pos : self._pos + n]
+        self._pos += n
+        return n
+
+    def seek(self, offset: int, whence: int = io.SEEK_SET) -> int:
+        if whence == io.SEEK_CUR:
+            offset += self._pos
+        elif whence == io.SEEK_END:
+            offset += len(self._data)
+        self._pos = max(0, int(offset))
+        return self._pos
+
+    def tell(self) -> int:
+        return self._pos
+
+    def close(self) -> None:
+        # Drop the view so the bundle's mapping can be closed later.
+        self._data = memoryview(b"")
+        super().close()
+
+
+class SessionBundle:
+    """A mapped ``.mgbundle`` file. Members are served from the mapping without copies."""
+
+    def __init__(self, path: PathLike) -> None:
+        self.path = Path(path).expanduser().resolve()
+        self._map: Optional[mmap.mmap] = None
+        self._prefetch_thread: Optional[threading.Thread] = None
+        self._prefetch_stop = threading.Event()
+        self._fh = open(self.path, "rb")
+        try:
+            size = os.fstat(self._fh.fileno()).st_size
+            if size < HEADER_SIZE:
+                raise BundleError(f"{self.path.name}: too small to be a session bundle")
+            self._map = mmap.mmap(self._fh.fileno(), 0, access=mmap.ACCESS_READ)
+            magic, version, alignment, count, index_offset, index_size = _HEADER.unpack_from(self._map, 0)
+            if magic != BUNDLE_MAGIC:
+                raise BundleError(f"{self.path.name}: not a session bundle")
+            if version > BUNDLE_VERSION:
+                raise BundleError(f"{self.path.name}: bundle version {version} is newer than supported ({BUNDLE_VERSION})")
+            if index_offset + index_size > size:
+                raise BundleError(f"{self.path.name}: truncated (index past end of file)")
+            index = json.loads(bytes(self._map[index_offset : index_offset + index_size]).decode("utf-8"))
+        except BaseException:
+            self.close()
+            raise
+        self.alignment = int(alignment)
+        self.index = index
+        self.entries: list[BundleEntry] = [
+            BundleEntry(e["name"], int(e["offset"]), int(e["size"]), e.get("kind", "media"), int(e.get("crc32", 0)))
+            for e in index.get("entries", [])
+        ]
+        if len(self.entries) != count:
+            logger.warning("[bundle] %s: header lists %d entries, index %d", self.path.name, count, len(self.entries))
+        self._by_key = {os.path.normcase(e.name.replace("/", os.sep)): e for e in self.entries}
+        self._dirs: set[str] = set()
+        for e in self.entries:
+            parts = e.name.split("/")[:-1]
+            for n in range(1, len(parts) + 1):
+                self._dirs.add(os.path.normcase(os.sep.join(parts[:n])))
+        self._data_end = int(index_offset)
+        self.prefetched_bytes = 0
+        self.prefetch_mb_s = 0.0
+        if hasattr(mmap, "MADV_SEQUENTIAL"):
+            try:
+                self._map.madvise(mmap.MADV_SEQUENTIAL)
+            except (OSError, ValueError):
+                pass
+
+    # -- context / lifetime --
+    def __enter__(self) -> "SessionBundle":
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+    def close(self) -> None:
+        self._prefetch_stop.set()
+        thread = self._prefetch_thread
+        if thread is not None and thread is not threading.current_thread():
+            thread.join(timeout=2.0)
+        unmount(self)
+        m = self._map
+        if m is not None:
+            try:
+                m.close()
+            except BufferError:
+                # A decoder still holds a member view; the mapping goes away with it.
+                pass
+            self._map = None
+        if getattr(self, "_fh", None) is not None:
+            self._fh.close()
+            self._fh = None
+
+    # -- members --
+    def entry(self, name: str) -> Optional[BundleEntry]:
+        return self._by_key.get(os.path.normcase(name.replace("/", os.sep)))
+
+    def view(self, name: str) -> memoryview:
+        """Zero-copy view of a member's bytes (valid while the bundle is open)."""
+        e = self.entry(name)
+        if e is None:
+            raise FileNotFoundError(f"{name} not in {self.path.name}")
+        return memoryview(self._map)[e.offset : e.offset + e.size]
+
+    def open(self, name: str) -> _MemberIO:
+        e = self.entry(name)
+        if e is None:
+            raise FileNotFoundError(f"{name} not in {self.path.name}")
+        return _MemberIO(self.view(e.name), self.member_path(e.name))
+
+    def member_path(self, name: str) -> str:
+        """Path under which loaders see ``name`` while the bundle is mounted."""
+        return os.path.join(str(self.path), *name.split("/"))
+
+    def is_dir(self, rel: str) -> bool:
+        return rel == "" or os.path.normcase(rel.replace("/", os.sep)) in self._dirs
+
+    def list_files(self, rel: str = "") -> list[str]:
+        """Member paths under directory ``rel``, in bundle (first-use) order."""
+        prefix = rel.strip("/") + "/" if rel.strip("/") else ""
+        key = os.path.normcase(prefix)
+        return [self.member_path(e.name) for e in self.entries if os.path.normcase(e.name).startswith(key)]
+
+    def session(self) -> dict:
+        """The packed session with member references turned into mount paths."""
+        data = json.loads(bytes(self.view(SESSION_MEMBER)).decode("utf-8"))
+        return self._resolve_refs(data)
+
+    def _resolve_refs(self, obj: Any) -> Any:
+        if isinstance(obj, str) and obj.startswith(MEMBER_PREFIX):
+            return self.member_path(obj[len(MEMBER_PREFIX):])
+        if isinstance(obj, dict):
+            return {k: self._resolve_refs(v) for k, v in obj.items()}
+        if isinstance(obj, list):
+            return [self._resolve_refs(v) for v in obj]
+        return obj
+
+    def verify(self) -> list[str]:
+        """Names of members whose CRC-32 does not match the index."""
+        return [e.name for e in self.entries if zlib.crc32(self.view(e.name)) != e.crc32]
+
+    # -- read-ahead --
+    def prefetch(self, *, background: bool = True, chunk_bytes: int = _COPY_CHUNK) -> None:
+        """Read the data region front to back in large chunks to warm the OS cache.
+
+        Members are in first-use order, so the cue that plays first is cached
+        first. Decoders touching the mapping then hit memory instead of issuing
+        small page-sized reads against the disk or share.
+        """
+        if self._prefetch_thread is not None:
+            return
+
+        def run() -> None:
+            start = time.perf_counter()
+            buf = bytearray(max(ALIGNMENT, int(chunk_bytes)))
+            try:
+                with open(self.path, "rb", buffering=0) as f:
+                    while not self._prefetch_stop.is_set() and self.prefetched_bytes < self._data_end:
+                        got = f.readinto(buf)
+                        if not got:
+                            break
+                        self.prefetched_bytes += got
+            except OSError as exc:
+                logger.warning("[bundle] prefetch of %s stopped: %s", self.path.name, exc)
+            elapsed = time.perf_counter() - start
+            self.prefetch_mb_s = (self.prefetched_bytes / (1024 * 1024)) / elapsed if elapsed > 0 else 0.0
+            logger.info(
+                "[bundle] Prefetched %.1f MB of %s in %.2fs (%.0f MB/s)",
+                self.prefetched_bytes / (1024 * 1024),
+                self.path.name,
+                elapsed,
+                self.prefetch_mb_s,
+            )
+
+        if background:
+            self._prefetch_thread = threading.Thread(target=run, name="bundle-prefetch", daemon=True)
+            self._prefetch_thread.start()
+        else:
+            run()
+
+    def stats(self) -> dict:
+        kinds: dict[str, int] = {}
+        for e in self.entries:
+            kinds[e.kind] = kinds.get(e.kind, 0) + 1
+        return {
+            "path": str(self.path),
+            "version": int(self.index.get("version", 0)),
+            "source": self.index.get("source"),
+            "created": self.index.get("created"),
+            "entries": len(self.entries),
+            "data_bytes": sum(e.size for e in self.entries),
+            "kinds": kinds,
+        }
+
+
+# ---- mounts: path-based access for loaders ------------------------------
+
+_MOUNT_LOCK = threading.Lock()
+_MOUNTS: dict[str, SessionBundle] = {}
+
+
+def _key(path: PathLike) -> str:
+    return os.path.normcase(os.path.abspath(str(path)))
+
+
+def mount(bundle: SessionBundle) -> None:
+    with _MOUNT_LOCK:
+        _MOUNTS[_key(bundle.path)] = bundle
+
+
+def unmount(bundle: SessionBundle) -> None:
+    with _MOUNT_LOCK:
+        key = _key(bundle.path)
+        if _MOUNTS.get(key) is bundle:
+            del _MOUNTS[key]
+
+
+def mounted() -> list[SessionBundle]:
+    with _MOUNT_LOCK:
+        return list(_MOUNTS.values())
+
+
+def lookup(path: PathLike) -> Optional[tuple[SessionBundle, str]]:
+    """``(bundle, member-relative name)`` when ``path`` lies inside a mounted bundle."""
+    if not _MOUNTS:
+        return None
+    key = _key(path)
+    with _MOUNT_LOCK:
+        for root, bundle in _MOUNTS.items():
+            if key == root:
+                return bundle, ""
+            if key.startswith(root + os.sep):
+                return bundle, key[len(root) + 1 :].replace(os.sep, "/")
+    return None
+
+
+def exists(path: PathLike) -> bool:
+    """``Path.exists`` that also sees bundle members and member directories."""
+    found = lookup(path)
+    if found is None:
+        return os.path.exists(path)
+    bundle, rel = found
+    return bundle.entry(rel) is not None or bundle.is_dir(rel)
+
+
+def getsize(path: PathLike) -> int:
+    found = lookup(path)
+    if found is None:
+        return os.path.getsize(path)
+    entry = found[0].entry(found[1])
+    if entry is None:
+        raise FileNotFoundError(str(path))
+    return entry.size
+
+
+def list_files(root: PathLike) -> Optional[list[str]]:
+    """Files under a bundle directory in first-use order, or None if ``root`` is not in a bundle."""
+    found = lookup(root)
+    if found is None:
+        return None
+    bundle, rel = found
+    return bundle.list_files(rel) if bundle.is_dir(rel) else []
+
+
+def member_view(path: PathLike) -> Optional[memoryview]:
+    """Zero-copy bytes of a bundle member; None for regular files and missing members."""
+    found = lookup(path)
+    if found is None or found[0].entry(found[1]) is None:
+        return None
+    return found[0].view(found[1])
+
+
+def source_for(path: PathLike):
+    """What to hand a decoder: the path itself, or a file object for a bundle member.
+
+    pygame, PyAV, PIL, wave and mutagen accept either.
+    """
+    found = lookup(path)
+    if found is None:
+        return str(path)
+    return found[0].open(found[1])
+
+
+def open_session_bundle(path: PathLike, *, prefetch: bool = True) -> tuple[SessionBundle, dict]:
+    """Open and mount a bundle (replacing any mount of the same file); return it and its session."""
+    key = _key(Path(path).expanduser().resolve())
+    with _MOUNT_LOCK:
+        previous = _MOUNTS.get(key)
+    if previous is not None:
+        previous.close()
+    bundle = SessionBundle(path)
+    try:
+        session = bundle.session()
+    except Exception as exc:
+        bundle.close()
+        raise BundleError(f"{Path(path).name}: unreadable session ({exc})") from exc
+    mount(bundle)
+    if prefetch:
+        bundle.prefetch()
+    return bundle, session
+
+
+__all__ = [
+    "BUNDLE_SUFFIX",
+    "BundleEntry",
+    "BundleError",
+    "SessionBundle",
+    "exists",
+    "getsize",
+    "is_bundle_file",
+    "list_files",
+    "lookup",
+    "member_view",
+    "mount",
+    "mounted",
+    "open_session_bundle",
+    "plan_bundle",
+    "source_for",
+    "unmount",
+    "write_bundle",
+]
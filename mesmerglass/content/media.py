@@ -16,9 +16,10 @@ from typing import Optional, List, Callable, Tuple, Any
 from pathlib import Path
 import threading
 import queue
-from collections import deque
+from collections import OrderedDict, deque
 import numpy as np
 from ..logging_utils import BurstSampler, PerfTracer
+from . import bundle
 
 try:
     from PIL import Image as PILImage
@@ -94,19 +95,144 @@ def _perf_span(
     return tracer.span(name, category=category, metadata=meta)
 
 
+class SharedImagePool:
+    """Process-wide decoded-image pool shared by every ImageCache.
+
+    When several sessions (or windows) cycle the same theme folders, each
+    ThemeBank's ImageCache would otherwise decode and hold its own copy of every
+    image. The pool keys decoded RGBA arrays by (resolved path, mtime, size) and
+    hands out the same read-only array to all callers, evicting least recently
+    used entries once ``budget_bytes`` is exceeded. A budget of 0 disables it.
+    """
+
+    def __init__(self, budget_bytes: int = 0):
+        self._lock = threading.Lock()
+        self._entries: "OrderedDict[tuple, ImageData]" = OrderedDict()
+        self._bytes = 0
+        self.budget_bytes = max(0, int(budget_bytes))
+        self.hits = 0
+        self.misses = 0
+        self.evictions = 0
+
+    @property
+    def enabled(self) -> bool:
+        return self.budget_bytes > 0
+
+    @staticmethod
+    def key_for(path: Path) -> Optional[tuple]:
+        found = bundle.lookup(path)
+        if found is not None:
+            entry = found[0].entry(found[1])
+            return (str(path), entry.offset, entry.size) if entry is not None else None
+        try:
+            st = path.stat()
+            return (str(path.resolve()), st.st_mtime_ns, st.st_size)
+        except OSError:
+            return None
+
+    def get(self, key: tuple) -> Optional[ImageData]:
+        with self._lock:
+            image = self._entries.get(key)
+            if image is None:
+                self.misses += 1
+                return None
+            self._entries.move_to_end(key)
+            self.hits += 1
+            return image
+
+    def put(self, key: tuple, image: ImageData) -> ImageData:
+        """Store ``image`` and return the pooled instance (an existing one wins)."""
+        nbytes = int(image.data.nbytes)
+        if nbytes > self.budget_bytes:
+            return image
+        image.data.setflags(write=False)
+        with self._lock:
+            existing = self._entries.get(key)
+            if existing is not None:
+                self._entries.move_to_end(key)
+                return existing
+            self._entries[key] = image
+            self._bytes += nbytes
+            self._evict_locked()
+        return image
+
+    def set_budget(self, budget_bytes: int) -> None:
+        with self._lock:
+            self.budget_bytes = max(0, int(budget_bytes))
+            self._evict_locked()
+
+    def clear(self) -> None:
+        with self._lock:
+            self._entries.clear()
+            self._bytes = 0
+
+    def stats(self) -> dict[str, int]:
+        with self._lock:
+            return {
+                "count": len(self._entries),
+                "bytes": self._bytes,
+                "budget_bytes": self.budget_bytes,
+                "hits": self.hits,
+                "misses": self.misses,
+                "evictions": self.evictions,
+            }
+
+    def _evict_locked(self) -> None:
+        while self._entries and self._bytes > self.budget_bytes:
+            _, old = self._entries.popitem(last=False)
+            self._bytes -= int(old.data.nbytes)
+            self.evictions += 1
+
+
+def _env_pool_budget() -> int:
+    try:
+        return max(0, int(float(os.environ.get("MESMERGLASS_SHARED_IMAGE_POOL_MB", "0") or 0) * 1024 * 1024))
+    except ValueError:
+        return 0
+
+
+_SHARED_POOL = SharedImagePool(_env_pool_budget())
+
+
+def shared_image_pool() -> SharedImagePool:
+    """Return the process-wide pool (disabled unless MESMERGLASS_SHARED_IMAGE_POOL_MB > 0)."""
+    return _SHARED_POOL
+
+
 def load_image_sync(path: Path, perf_tracer: Optional[PerfTracer] = None) -> Optional[ImageData]:
-    """Load image from file synchronously with optional PerfTracer spans."""
+    """Load image from file synchronously with optional PerfTracer spans.
+
+    With the shared pool enabled, a file already decoded by another cache is
+    returned as-is (its pixel array is read-only).
+    """
+
+    pool_key = SharedImagePool.key_for(path) if _SHARED_POOL.enabled else None
+    if pool_key is not None:
+        pooled = _SHARED_POOL.get(pool_key)
+        if pooled is not None:
+            return pooled
+        image = _decode_image(path, perf_tracer)
+        return _SHARED_POOL.put(pool_key, image) if image is not None else None
+    return _decode_image(path, perf_tracer)
 
+
+def _decode_image(path: Path, perf_tracer: Optional[PerfTracer]) -> Optional[ImageData]:
     span = _perf_span(perf_tracer, "media_load_image", metadata={"path": path.name})
     backend = None
     error: Optional[str] = None
     start = time.perf_counter()
     image: Optional[ImageData] = None
 
+    # Bundle members decode straight from the mapped bundle file.
+    packed = bundle.member_view(path)
+
     with span:
         if _HAS_CV2:
             try:
-                img_bgr = cv2.imread(str(path), cv2.IMREAD_UNCHANGED)
+                if packed is not None:
+                    img_bgr = cv2.imdecode(np.frombuffer(packed, dtype=np.uint8), cv2.IMREAD_UNCHANGED)
+                else:
+                    img_bgr = cv2.imread(str(path), cv2.IMREAD_UNCHANGED)
                 if img_bgr is None:
                     raise ValueError(f"OpenCV failed to load {path}")
 
@@ -130,7 +256,7 @@ def load_image_sync(path: Path, perf_tracer: Optional[PerfTracer] = None) -> Opt
 
         if image is None and _HAS_PIL:
             try:
-                img = PILImage.open(path)
+                img = PILImage.open(bundle.source_for(path) if packed is not None else path)
                 if img.mode != "RGBA":
                     img = img.convert("RGBA")
                 data = np.array(img, dtype=np.uint8)
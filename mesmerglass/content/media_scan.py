@@ -4,6 +4,8 @@ from __future__ import annotations
 from pathlib import Path
 from typing import Iterable, Sequence
 
+from . import bundle
+
 DEFAULT_IMAGE_EXTENSIONS: tuple[str, ...] = (
     ".jpg",
     ".jpeg",
@@ -50,17 +52,28 @@ def scan_media_directory(
     The search is case-insensitive and walks the directory tree once, avoiding
     multiple rglob() passes. Paths are returned as absolute strings so callers
     can store them safely regardless of the current working directory.
+    Directories inside a mounted session bundle are listed from its index.
     """
-    root_path = Path(root)
-    if not root_path.exists():  # Nothing to scan
-        return [], []
-
     image_suffixes = _normalize_extensions(image_exts or DEFAULT_IMAGE_EXTENSIONS)
     video_suffixes = _normalize_extensions(video_exts or DEFAULT_VIDEO_EXTENSIONS)
 
     images: list[str] = []
     videos: list[str] = []
 
+    members = bundle.list_files(root)
+    if members is not None:
+        for member in members:
+            suffix = Path(member).suffix.lower()
+            if suffix in image_suffixes:
+                images.append(member)
+            elif suffix in video_suffixes:
+                videos.append(member)
+        return images, videos
+
+    root_path = Path(root)
+    if not root_path.exists():  # Nothing to scan
+        return [], []
+
     for path in root_path.rglob('*'):
         if not path.is_file():
             continue
@@ -87,11 +100,16 @@ def scan_font_directory(
     Returns:
         List of absolute font file paths
     """
+    font_suffixes = _normalize_extensions(font_exts or DEFAULT_FONT_EXTENSIONS)
+
+    members = bundle.list_files(root)
+    if members is not None:
+        return [m for m in members if Path(m).suffix.lower() in font_suffixes]
+
     root_path = Path(root)
     if not root_path.exists():
         return []
 
-    font_suffixes = _normalize_extensions(font_exts or DEFAULT_FONT_EXTENSIONS)
     fonts: list[str] = []
 
     for path in root_path.rglob('*'):
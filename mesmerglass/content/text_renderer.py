@@ -17,6 +17,8 @@ from enum import Enum
 from dataclasses import dataclass
 import numpy as np
 
+from . import bundle
+
 try:
     from PIL import Image, ImageDraw, ImageFont
 except ImportError:
@@ -135,7 +137,7 @@ class TextRenderer:
         
         # Load font
         try:
-            font = ImageFont.truetype(self._style.font_path, self._style.font_size)
+            font = ImageFont.truetype(bundle.source_for(self._style.font_path), self._style.font_size)
             self._font_cache[cache_key] = font
             self._current_font = font
         except Exception as e:
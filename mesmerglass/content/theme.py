@@ -9,7 +9,7 @@ Implements Trance-style theme system:
 
 from __future__ import annotations
 from dataclasses import dataclass, field
-from typing import List, Optional, Dict, Any
+from typing import Callable, List, Optional, Dict, Any
 from pathlib import Path
 import json
 import random
@@ -141,6 +141,9 @@ class Shuffler:
     This allows perfect prediction for preloading while maintaining
     the appearance of random weighted selection.
     """
+
+    # Process-wide pick hook, called as on_pick(count, index) (session trace recording)
+    on_pick: Optional[Callable[[int, int], None]] = None
     
     def __init__(self, count: int, default_weight: float = 1.0, queue_size: int = 100):
         """Initialize shuffler with count items.
@@ -226,7 +229,10 @@ class Shuffler:
             self._regenerate_queue()
         
         # Pop next item from queue
-        return self._queue.pop(0)
+        index = self._queue.pop(0)
+        if Shuffler.on_pick is not None:
+            Shuffler.on_pick(self._count, index)
+        return index
     
     def increase(self, index: int, amount: float = 1.0) -> None:
         """Increase weight of item at index.
@@ -21,6 +21,7 @@ import logging
 
 from ..logging_utils import BurstSampler, PerfTracer
 
+from . import bundle
 from .theme import ThemeConfig, Shuffler
 from .media import ImageCache, ImageData
 
@@ -329,7 +330,7 @@ class ThemeBank:
                     candidate = self._normalized_path(raw_path)
                 except Exception:
                     continue
-                if candidate.exists():
+                if bundle.exists(candidate):
                     return True
         return False
 
@@ -1191,3 +1192,45 @@ class ThemeBank:
         # No-op: Lookahead preloading in get_image() now handles this
         pass
 
+
+def themes_from_media_bank(entries: Sequence[Dict[str, Any]]) -> Tuple[List[ThemeConfig], List[str]]:
+    """Scan a session's Media Bank entries into themes (one per directory) and font paths.
+
+    Missing directories are skipped with a warning; ``type`` limits a directory to
+    "images", "videos" or "fonts" (default: both images and videos).
+    """
+    from .media_scan import scan_font_directory, scan_media_directory
+
+    themes: List[ThemeConfig] = []
+    font_paths: List[str] = []
+    for entry in entries:
+        if not isinstance(entry, dict):
+            continue
+        raw_path = entry.get("path")
+        if not raw_path:
+            continue
+        dir_path = Path(raw_path).expanduser()
+        if not bundle.exists(dir_path):
+            logger.warning("[themebank] Skipping missing media directory: %s", dir_path)
+            continue
+        media_type = (entry.get("type") or "both").lower()
+        if media_type == "fonts":
+            font_paths.extend(scan_font_directory(dir_path))
+            continue
+
+        images, videos = scan_media_directory(dir_path)
+        if media_type == "images":
+            videos = []
+        elif media_type == "videos":
+            images = []
+        themes.append(
+            ThemeConfig(
+                name=entry.get("name", dir_path.name),
+                enabled=True,
+                image_path=images,
+                animation_path=videos,
+                font_path=[],
+                text_line=[],
+            )
+        )
+    return themes, font_paths
@@ -15,6 +15,7 @@ from __future__ import annotations
 
 import os
 import logging
+import math
 import threading
 import time
 from pathlib import Path
@@ -24,6 +25,8 @@ from collections import deque, OrderedDict
 
 import numpy as np
 
+from . import bundle
+
 logger = logging.getLogger(__name__)
 VIDEO_IO_LOCK = threading.Lock()
 
@@ -68,6 +71,91 @@ VIDEO_DECODER_CACHE_MAX = max(0, _read_env_int("MESMERGLASS_VIDEO_DECODER_CACHE"
 _DECODER_CACHE_LOCK = threading.Lock()
 _DECODER_CACHE: "OrderedDict[Path, VideoDecoder]" = OrderedDict()  # type: ignore[name-defined]
 
+# Decode-time downscaling: background clips are sampled at display (or VR eye)
+# resolution, so decoding a 4K file at full size only to have the GPU minify it
+# wastes decode, colour conversion and upload bandwidth. Frames leave the decoder
+# no smaller than this target in either axis (aspect preserved, never upscaled).
+# MESMERGLASS_VIDEO_DECODE_SIZE=WxH pins the target; "0"/"off" decodes full size.
+VIDEO_DECODE_THREADS = max(0, _read_env_int("MESMERGLASS_VIDEO_DECODE_THREADS", 0))  # 0 = FFmpeg auto
+VIDEO_DECODE_BACKEND = (os.environ.get("MESMERGLASS_VIDEO_DECODE_BACKEND") or "auto").strip().lower()
+# Codecs whose decoders implement FFmpeg's "lowres" (IDCT at 1/2, 1/4, 1/8 size).
+_LOWRES_CODECS = frozenset({"mpeg1video", "mpeg2video", "mpeg4", "mjpeg", "h263", "msmpeg4v3", "wmv2"})
+
+
+def _parse_decode_size(raw: Optional[str]) -> Tuple[bool, Optional[Tuple[int, int]]]:
+    """Parse MESMERGLASS_VIDEO_DECODE_SIZE. Returns (pinned, size)."""
+    if raw is None or not raw.strip():
+        return False, None
+    text = raw.strip().lower()
+    if text in ("0", "off", "none", "full"):
+        return True, None
+    try:
+        w_str, h_str = text.replace(",", "x").split("x", 1)
+        w, h = int(w_str), int(h_str)
+    except ValueError:
+        logger.warning("[Video] Ignoring malformed MESMERGLASS_VIDEO_DECODE_SIZE=%r (expected WxH)", raw)
+        return False, None
+    return True, ((w, h) if w > 0 and h > 0 else None)
+
+
+_DECODE_TARGET_LOCK = threading.Lock()
+_DECODE_TARGET_PINNED, _DECODE_TARGET = _parse_decode_size(os.environ.get("MESMERGLASS_VIDEO_DECODE_SIZE"))
+
+
+def set_decode_target_size(size: Optional[Tuple[int, int]]) -> None:
+    """Set the surface size video frames are decoded for.
+
+    Called by the visual director with the largest compositor (or VR FBO) it
+    drives. Decoders opened afterwards scale to it inside FFmpeg; cached
+    decoders opened for a different target are re-opened on checkout. ``None``
+    restores full-resolution decode. Ignored when the env var pins the size.
+    """
+    global _DECODE_TARGET
+    if _DECODE_TARGET_PINNED:
+        return
+    if size is not None:
+        w, h = int(size[0]), int(size[1])
+        size = (w, h) if w > 0 and h > 0 else None
+    with _DECODE_TARGET_LOCK:
+        _DECODE_TARGET = size
+
+
+def get_decode_target_size() -> Optional[Tuple[int, int]]:
+    with _DECODE_TARGET_LOCK:
+        return _DECODE_TARGET
+
+
+def decode_output_size(
+    src_width: int, src_height: int, target: Optional[Tuple[int, int]]
+) -> Tuple[int, int]:
+    """Size a ``src_width`` x ``src_height`` clip should be decoded at.
+
+    Cover-fits the target (the compositor may crop to fill), keeps the aspect
+    ratio, rounds to even dimensions for the YUV 4:2:0 scaler and never
+    upscales.
+    """
+    if target is None or src_width <= 0 or src_height <= 0:
+        return src_width, src_height
+    scale = max(target[0] / src_width, target[1] / src_height)
+    if scale >= 1.0:
+        return src_width, src_height
+    # Round up so the even size never drops below the target.
+    out_w = max(2, math.ceil(src_width * scale / 2.0) * 2)
+    out_h = max(2, math.ceil(src_height * scale / 2.0) * 2)
+    return min(out_w, src_width), min(out_h, src_height)
+
+
+def _lowres_factor(src_width: int, src_height: int, out_width: int, out_height: int) -> int:
+    """Largest FFmpeg lowres level (0-3) that still covers the output size."""
+    level = 0
+    while level < 3:
+        div = 1 << (level + 1)
+        if -(-src_width // div) < out_width or -(-src_height // div) < out_height:
+            break
+        level += 1
+    return level
+
+
 # Warmup pacing / backpressure to avoid starving the UI thread during rapid cycling.
 VIDEO_WARMUP_QUEUE_MAX = max(
     0,
@@ -194,6 +282,13 @@ def _checkout_cached_decoder(path: Path) -> Optional["VideoDecoder"]:  # type: i
         decoder = _DECODER_CACHE.pop(path, None)
     if decoder is None:
         return None
+    if getattr(decoder, "target_size", None) != get_decode_target_size():
+        # Opened for a different surface size (window resized, VR toggled).
+        try:
+            decoder.close()
+        except Exception:
+            pass
+        return None
     try:
         decoder.reset()
     except Exception:
@@ -259,28 +354,38 @@ class VideoDecoder:
     
     Supports:
     - GIF: Entire file loaded into memory
-    - MP4/WebM: Streamed from disk via OpenCV
+    - MP4/WebM: Streamed from disk via PyAV (threaded FFmpeg decode) or OpenCV
+    
+    Frames come out at ``decode_output_size(source, target_size)``; ``width``
+    and ``height`` describe the frames, ``source_width``/``source_height`` the
+    file.
     
     Frame extraction mimics Trance's Streamer::next_frame() behavior.
     """
     
-    def __init__(self, path: str | Path):
+    def __init__(self, path: str | Path, target_size: Optional[Tuple[int, int]] = None):
         """Initialize decoder for video file.
         
         Args:
             path: Path to video file (GIF, MP4, WebM)
+            target_size: Surface size to decode for; defaults to
+                ``get_decode_target_size()``
         
         Raises:
             FileNotFoundError: If file doesn't exist
             ValueError: If file format unsupported
         """
         self.path = _normalize_path(path)
-        if not self.path.exists():
+        if not bundle.exists(self.path):
             raise FileNotFoundError(f"Video file not found: {path}")
         
         self.format = self._detect_format()
+        self.target_size = target_size if target_size is not None else get_decode_target_size()
         self.width = 0
         self.height = 0
+        self.source_width = 0
+        self.source_height = 0
+        self.backend = "opencv"
         self.fps = 30.0
         self.frame_count = 0
         self.current_frame_idx = 0
@@ -289,6 +394,12 @@ class VideoDecoder:
         # OpenCV video capture (for MP4/WebM)
         self.cap: Optional[object] = None
         
+        # PyAV container (for MP4/WebM when available)
+        self._av_container: Optional[object] = None
+        self._av_stream: Optional[object] = None
+        self._av_frames = None
+        self._av_pending: Optional[object] = None
+        
         # GIF frames (entire file in memory)
         self.gif_frames: list[VideoFrame] = []
         
@@ -325,8 +436,10 @@ class VideoDecoder:
                     logger.error(f"Failed to open GIF: {self.path}")
                     return
             
-            self.width = int(cap.get(cv2.CAP_PROP_FRAME_WIDTH))
-            self.height = int(cap.get(cv2.CAP_PROP_FRAME_HEIGHT))
+            self._set_source_size(
+                int(cap.get(cv2.CAP_PROP_FRAME_WIDTH)),
+                int(cap.get(cv2.CAP_PROP_FRAME_HEIGHT)),
+            )
             self.fps = float(cap.get(cv2.CAP_PROP_FPS) or 30.0)
             self.frame_count = int(cap.get(cv2.CAP_PROP_FRAME_COUNT))
             
@@ -338,7 +451,7 @@ class VideoDecoder:
                 if not ret:
                     break
 
-                rgb = cv2.cvtColor(frame, cv2.COLOR_BGR2RGB)
+                rgb = cv2.cvtColor(self._scale_bgr(frame), cv2.COLOR_BGR2RGB)
                 timestamp = frame_idx / self.fps
 
                 self.gif_frames.append(VideoFrame(
@@ -362,11 +475,35 @@ class VideoDecoder:
             logger.error(f"[GIF] Failed to load {self.path}: {e}")
             self.success = False
     
+    def _set_source_size(self, width: int, height: int) -> None:
+        self.source_width = width
+        self.source_height = height
+        self.width, self.height = decode_output_size(width, height, self.target_size)
+    
+    def _scale_bgr(self, frame: np.ndarray) -> np.ndarray:
+        """Downscale an OpenCV frame to the output size (before colour conversion)."""
+        if frame.shape[1] == self.width and frame.shape[0] == self.height:
+            return frame
+        import cv2
+        return cv2.resize(frame, (self.width, self.height), interpolation=cv2.INTER_AREA)
+    
     def _open_video(self) -> None:
         """Open video file for streaming.
         
         Trance behavior: WebM/MP4 streamed from disk, YUV→RGB per frame.
+        PyAV is preferred: FFmpeg decodes with frame+slice threads and swscale
+        converts straight to the output size, so a 4K clip never materialises
+        as a full-size RGB array. MESMERGLASS_VIDEO_DECODE_BACKEND=opencv
+        forces the cv2 path (which resizes each frame after decode).
         """
+        in_bundle = bundle.lookup(self.path) is not None
+        if (in_bundle or VIDEO_DECODE_BACKEND in ("auto", "pyav", "av")) and self._open_video_pyav():
+            return
+        if in_bundle:
+            # cv2.VideoCapture only opens real files.
+            logger.error(f"[Video] Failed to open bundled video {self.path.name} (PyAV required)")
+            self.success = False
+            return
         try:
             import cv2
             with VIDEO_IO_LOCK:
@@ -376,18 +513,120 @@ class VideoDecoder:
                     return
             
             with VIDEO_IO_LOCK:
-                self.width = int(self.cap.get(cv2.CAP_PROP_FRAME_WIDTH))
-                self.height = int(self.cap.get(cv2.CAP_PROP_FRAME_HEIGHT))
+                self._set_source_size(
+                    int(self.cap.get(cv2.CAP_PROP_FRAME_WIDTH)),
+                    int(self.cap.get(cv2.CAP_PROP_FRAME_HEIGHT)),
+                )
                 self.fps = float(self.cap.get(cv2.CAP_PROP_FPS) or 30.0)
                 self.frame_count = int(self.cap.get(cv2.CAP_PROP_FRAME_COUNT))
             
+            self.backend = "opencv"
             self.success = True
-            logger.info(f"[Video] Opened {self.path.name} - {self.width}x{self.height} @ {self.fps}fps, {self.frame_count} frames")
+            logger.info(
+                f"[Video] Opened {self.path.name} - {self.source_width}x{self.source_height} "
+                f"-> {self.width}x{self.height} @ {self.fps}fps, {self.frame_count} frames (opencv)"
+            )
         
         except Exception as e:
             logger.error(f"[Video] Failed to open {self.path}: {e}")
             self.success = False
     
+    def _open_video_pyav(self) -> bool:
+        """Open with PyAV; returns False (quietly) if PyAV is missing or fails."""
+        try:
+            import av
+        except ImportError:
+            return False
+        container = None
+        try:
+            container = av.open(bundle.source_for(self.path))
+            stream = container.streams.video[0]
+            ctx = stream.codec_context
+            # Codec options must be set before the first decode opens the codec.
+            stream.thread_type = "AUTO"  # frame + slice threads
+            ctx.thread_count = VIDEO_DECODE_THREADS
+            self._set_source_size(int(ctx.width), int(ctx.height))
+            lowres = 0
+            if stream.codec_context.name in _LOWRES_CODECS:
+                lowres = _lowres_factor(self.source_width, self.source_height, self.width, self.height)
+                if lowres:
+                    ctx.options = {"lowres": str(lowres)}
+            rate = stream.average_rate or stream.guessed_rate
+            self.fps = float(rate) if rate else 30.0
+            self.frame_count = int(stream.frames or 0)
+            if self.frame_count <= 0 and stream.duration is not None and stream.time_base:
+                self.frame_count = int(float(stream.duration * stream.time_base) * self.fps)
+        except Exception as e:
+            logger.warning(f"[Video] PyAV open failed for {self.path.name}, falling back to OpenCV: {e}")
+            if container is not None:
+                try:
+                    container.close()
+                except Exception:
+                    pass
+            return False
+        
+        self._av_container = container
+        self._av_stream = stream
+        self._av_frames = container.decode(stream)
+        self._av_pending = None
+        self.backend = "pyav"
+        self.success = True
+        logger.info(
+            f"[Video] Opened {self.path.name} - {self.source_width}x{self.source_height} "
+            f"-> {self.width}x{self.height} @ {self.fps}fps, {self.frame_count} frames "
+            f"(pyav {stream.codec_context.name}, threads={VIDEO_DECODE_THREADS or 'auto'}, lowres={lowres})"
+        )
+        return True
+    
+    def _next_frame_pyav(self) -> Optional[VideoFrame]:
+        # No VIDEO_IO_LOCK: each container is private to its decoder, and FFmpeg
+        # decode/swscale release the GIL, so concurrent clips decode in parallel.
+        try:
+            frame = self._av_pending
+            self._av_pending = None
+            if frame is None:
+                frame = next(self._av_frames)
+        except StopIteration:
+            return None
+        except Exception as e:
+            logger.error(f"[Video] Frame read error: {e}")
+            return None
+        
+        try:
+            rgb = frame.reformat(
+                width=self.width, height=self.height, format="rgb24", interpolation="AREA"
+            ).to_ndarray()
+        except Exception as e:
+            logger.error(f"[Video] Frame convert error: {e}")
+            return None
+        
+        timestamp = self.current_frame_idx / self.fps
+        self.current_frame_idx += 1
+        return VideoFrame(data=rgb, width=self.width, height=self.height, timestamp=timestamp)
+    
+    def _seek_pyav(self, frame_idx: int) -> bool:
+        stream = self._av_stream
+        container = self._av_container
+        try:
+            start = stream.start_time or 0
+            target_pts = start
+            if frame_idx > 0 and stream.time_base:
+                target_pts = start + int(frame_idx / self.fps / float(stream.time_base))
+            # Seek lands on the preceding keyframe; decode forward to the target.
+            container.seek(target_pts, stream=stream, backward=True, any_frame=False)
+            self._av_frames = container.decode(stream)
+            self._av_pending = None
+            if frame_idx > 0:
+                for frame in self._av_frames:
+                    if frame.pts is None or frame.pts >= target_pts:
+                        self._av_pending = frame
+                        break
+            self.current_frame_idx = frame_idx
+            return True
+        except Exception as e:
+            logger.error(f"[Video] Seek failed: {e}")
+            return False
+    
     def next_frame(self) -> Optional[VideoFrame]:
         """Get next frame from video.
         
@@ -412,6 +651,8 @@ class VideoDecoder:
         
         else:
             # Video: Stream from disk
+            if self._av_container is not None:
+                return self._next_frame_pyav()
             if self.cap is None:
                 return None
             
@@ -424,8 +665,8 @@ class VideoDecoder:
                     # End of video reached
                     return None
                 
-                # Convert BGR to RGB
-                rgb = cv2.cvtColor(frame, cv2.COLOR_BGR2RGB)
+                # Downscale to the output size, then convert BGR to RGB
+                rgb = cv2.cvtColor(self._scale_bgr(frame), cv2.COLOR_BGR2RGB)
                 timestamp = self.current_frame_idx / self.fps
                 
                 self.current_frame_idx += 1
@@ -461,6 +702,8 @@ class VideoDecoder:
             return False
         
         else:
+            if self._av_container is not None:
+                return self._seek_pyav(frame_idx)
             # Video: Use OpenCV seek
             if self.cap is None:
                 return False
@@ -488,6 +731,15 @@ class VideoDecoder:
             except Exception:
                 pass
             self.cap = None
+        if self._av_container is not None:
+            try:
+                self._av_container.close()
+            except Exception:
+                pass
+            self._av_container = None
+            self._av_stream = None
+            self._av_frames = None
+            self._av_pending = None
         
         # Clear GIF frames to free memory
         self.gif_frames.clear()
@@ -15,6 +15,8 @@ from threading import Lock
 from typing import Optional, Iterable, Tuple
 from typing import Any
 
+from ..content import bundle
+
 def clamp(x, a, b): return max(a, min(b, x))
 
 
@@ -685,7 +687,7 @@ class AudioEngine:
                     return chunks
 
                 def _open_container() -> Any:
-                    return av.open(normalized)
+                    return av.open(bundle.source_for(normalized))
 
                 while not stop_event.is_set():
                     try:
@@ -1110,7 +1112,7 @@ class AudioEngine:
         try:
             decode_start = time.perf_counter()
             with self._load_lock:
-                sound = pygame.mixer.Sound(normalized)
+                sound = pygame.mixer.Sound(bundle.source_for(normalized))
             elapsed_ms = (time.perf_counter() - decode_start) * 1000.0
             length = float(sound.get_length() or 0.0)
             self._decode_time_ms[normalized] = elapsed_ms
@@ -1182,7 +1184,7 @@ class AudioEngine:
 
     def _get_file_size(self, file_path: str) -> Optional[int]:
         try:
-            return os.path.getsize(file_path)
+            return bundle.getsize(file_path)
         except OSError:
             return None
 
@@ -1229,6 +1231,8 @@ class AudioEngine:
 
     def _validate_streamable_path(self, file_path: str) -> bool:
         try:
+            if bundle.lookup(file_path) is not None:
+                return bundle.member_view(file_path) is not None
             return os.path.isfile(file_path)
         except OSError:
             return False
@@ -1452,7 +1456,7 @@ class AudioEngine:
         try:
             from mutagen import File as MutagenFile  # type: ignore
 
-            audio = MutagenFile(normalized)
+            audio = MutagenFile(bundle.source_for(normalized))
             if audio and getattr(audio, "info", None) and getattr(audio.info, "length", None):
                 length = float(audio.info.length)
                 self._duration_cache[normalized] = length
@@ -1465,7 +1469,7 @@ class AudioEngine:
         # Fallback for WAV via stdlib wave module
         if normalized.lower().endswith(".wav"):
             try:
-                with contextlib.closing(wave.open(normalized, "rb")) as wav_file:
+                with contextlib.closing(wave.open(bundle.source_for(normalized), "rb")) as wav_file:
                     frames = wav_file.getnframes()
                     rate = wav_file.getframerate()
                     if rate > 0:
@@ -8,6 +8,15 @@ from dataclasses import dataclass
 from typing import Dict, List, Optional, Iterable, Set
 
 
+def _note_device(op: str, *fields) -> None:
+    """Log a device event into an active session trace (no-op otherwise)."""
+    try:
+        from ..session import replay
+    except Exception:
+        return
+    replay.note("device", op, *fields)
+
+
 @dataclass
 class Device:
     """Represents a discovered device (Buttplug semantics)."""
@@ -47,11 +56,13 @@ class DeviceManager:
             device_messages=device_info.get("DeviceMessages", {}),
         )
         self._devices[idx] = device
+        _note_device("add", idx, device.name)
 
     def remove_device(self, idx: int) -> None:
         """Remove a device by index; clear selections referencing it."""
         if idx in self._devices:
             del self._devices[idx]
+            _note_device("remove", idx)
         if self._selected_index == idx:
             self._selected_index = None
         if idx in self._selected_indices:
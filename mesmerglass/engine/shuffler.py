@@ -6,7 +6,7 @@ while avoiding recent repeats for better variety.
 """
 
 import random
-from typing import List, Optional
+from typing import Callable, List, Optional
 
 
 class Shuffler:
@@ -33,6 +33,9 @@ class Shuffler:
         initial_weight: Starting weight for each item (default: 10)
         history_size: How many recent selections to avoid repeating (default: 8)
     """
+
+    # Process-wide pick hook, called as on_pick(item_count, index) (session trace recording)
+    on_pick: Optional[Callable[[int, int], None]] = None
     
     def __init__(
         self,
@@ -83,6 +86,8 @@ class Shuffler:
             if value < self.weights[i]:
                 # Found the item - track selection and return
                 self._track_selection(i)
+                if Shuffler.on_pick is not None:
+                    Shuffler.on_pick(self.item_count, i)
                 return i
             value -= self.weights[i]
         
@@ -28,6 +28,9 @@ class StreamingClientSnapshot:
 
     encode_avg_ms: float | None
     send_avg_ms: float | None
+    # Lateness of packet sends versus the server's fixed frame timeline.
+    send_jitter_avg_ms: float | None
+    send_jitter_max_ms: float | None
     bandwidth_mbps: float | None
     frame_kb: float | None
 
@@ -65,6 +68,8 @@ class StreamingTelemetry:
                 "produced_fps": None,
                 "encode_avg_ms": None,
                 "send_avg_ms": None,
+                "send_jitter_avg_ms": None,
+                "send_jitter_max_ms": None,
                 "bandwidth_mbps": None,
                 "frame_kb": None,
                 "client_buffer_ms": None,
@@ -130,6 +135,8 @@ class StreamingTelemetry:
         produced_fps: float | None = None,
         encode_avg_ms: float | None = None,
         send_avg_ms: float | None = None,
+        send_jitter_avg_ms: float | None = None,
+        send_jitter_max_ms: float | None = None,
         bandwidth_mbps: float | None = None,
         frame_kb: float | None = None,
         client_buffer_ms: int | None = None,
@@ -150,6 +157,10 @@ class StreamingTelemetry:
                 st["encode_avg_ms"] = float(encode_avg_ms)
             if send_avg_ms is not None:
                 st["send_avg_ms"] = float(send_avg_ms)
+            if send_jitter_avg_ms is not None:
+                st["send_jitter_avg_ms"] = float(send_jitter_avg_ms)
+            if send_jitter_max_ms is not None:
+                st["send_jitter_max_ms"] = float(send_jitter_max_ms)
             if bandwidth_mbps is not None:
                 st["bandwidth_mbps"] = float(bandwidth_mbps)
             if frame_kb is not None:
@@ -189,6 +200,8 @@ class StreamingTelemetry:
                     produced_fps=st.get("produced_fps"),
                     encode_avg_ms=st.get("encode_avg_ms"),
                     send_avg_ms=st.get("send_avg_ms"),
+                    send_jitter_avg_ms=st.get("send_jitter_avg_ms"),
+                    send_jitter_max_ms=st.get("send_jitter_max_ms"),
                     bandwidth_mbps=st.get("bandwidth_mbps"),
                     frame_kb=st.get("frame_kb"),
                     client_buffer_ms=st.get("client_buffer_ms"),
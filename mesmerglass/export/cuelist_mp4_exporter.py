@@ -22,13 +22,21 @@ class Mp4ExportSettings:
     height: int = 1080
     fps: int = 60
     prefer_nvenc: bool = True
+    # Place keyframes on the session's cue/playback cuts and stretch the GOP in between.
+    scene_keyframes: bool = True
+
+
+# Longest keyframe interval when keyframes follow scene cuts.
+SCENE_GOP_SECONDS = 4
 
 
 class _EncodeWorker(threading.Thread):
+    """Encodes queued ``(frame, keyframe)`` items; ``None`` ends the stream."""
+
     def __init__(
         self,
         *,
-        frame_queue: "queue.Queue[Optional[np.ndarray]]",
+        frame_queue: "queue.Queue[Optional[Tuple[np.ndarray, bool]]]",
         settings: Mp4ExportSettings,
     ) -> None:
         super().__init__(daemon=True)
@@ -70,6 +78,8 @@ class _EncodeWorker(threading.Thread):
             stream.width = width
             stream.height = height
             stream.pix_fmt = "yuv420p"
+            scene_keyframes = bool(self._settings.scene_keyframes)
+            gop = max(1, min(fps * SCENE_GOP_SECONDS, 600)) if scene_keyframes else max(1, min(fps, 60))
 
             if codec_name == "libx264":
                 stream.options = {
@@ -78,6 +88,8 @@ class _EncodeWorker(threading.Thread):
                     "crf": "18",
                     "profile": "high",
                 }
+                if scene_keyframes:
+                    stream.options = {**stream.options, "g": str(gop), "forced-idr": "1"}
             else:
                 # Keep options conservative; rely on defaults unless user needs tuning.
                 stream.options = {
@@ -85,15 +97,19 @@ class _EncodeWorker(threading.Thread):
                     "rc": "vbr_hq",
                     "cq": "18",
                     "bf": "0",
-                    "g": str(max(1, min(fps, 60))),
+                    "g": str(gop),
                     "forced-idr": "1",
                     "repeat_headers": "1",
                 }
 
+            picture_type = getattr(getattr(av, "video", None), "frame", None)
+            picture_type = getattr(picture_type, "PictureType", None)
+
             while not self._stop.is_set():
-                frame = self._q.get()
-                if frame is None:
+                item = self._q.get()
+                if item is None:
                     break
+                frame, keyframe = item
 
                 # Ensure RGB uint8 contiguous
                 if frame.dtype != np.uint8:
@@ -107,6 +123,8 @@ class _EncodeWorker(threading.Thread):
                     video_frame = video_frame.reformat(width=width, height=height, format="yuv420p")
                 else:
                     video_frame = video_frame.reformat(format="yuv420p")
+                if keyframe and scene_keyframes:
+                    video_frame.pict_type = picture_type.I if picture_type is not None else "I"
 
                 for packet in stream.encode(video_frame):
                     container.mux(packet)
@@ -167,7 +185,12 @@ class CuelistMp4Exporter(QObject):
         self._time_base = 0.0
         self._sim_time = 0.0
 
-        self._frame_q: "queue.Queue[Optional[np.ndarray]]" = queue.Queue(maxsize=240)
+        self._frame_q: "queue.Queue[Optional[Tuple[np.ndarray, bool]]]" = queue.Queue(maxsize=240)
+        # Cut timeline published by the runner; frames enqueued after a new cut become keyframes.
+        from mesmerglass.session.encoder_hints import EncoderHints
+
+        self._encoder_hints = EncoderHints()
+        self._enqueued_scene_seq = 0
         self._encoder: Optional[_EncodeWorker] = None
         self._cancelled = False
 
@@ -235,16 +258,26 @@ class CuelistMp4Exporter(QObject):
             except Exception:
                 pass
 
-            # Enable capture at 60fps
-            try:
-                if hasattr(self._hidden_compositor, "set_preview_capture_enabled"):
-                    self._hidden_compositor.set_preview_capture_enabled(True, max_fps=fps)
-                elif hasattr(self._hidden_compositor, "set_capture_enabled"):
-                    self._hidden_compositor.set_capture_enabled(True, max_fps=fps)
-            except Exception:
-                pass
-
-            self._hidden_compositor.frame_ready.connect(self._on_frame_ready)
+            # Capture at export resolution. Sync readback keeps frames 1:1 with
+            # simulation steps (the async PBO path delivers a paint or two late).
+            if hasattr(self._hidden_compositor, "register_capture_consumer"):
+                self._hidden_compositor.register_capture_consumer(
+                    "export",
+                    self._on_frame_ready,
+                    width=self._settings.width,
+                    height=self._settings.height,
+                    max_fps=fps,
+                    sync=True,
+                )
+            else:
+                try:
+                    if hasattr(self._hidden_compositor, "set_preview_capture_enabled"):
+                        self._hidden_compositor.set_preview_capture_enabled(True, max_fps=fps)
+                    elif hasattr(self._hidden_compositor, "set_capture_enabled"):
+                        self._hidden_compositor.set_capture_enabled(True, max_fps=fps)
+                except Exception:
+                    pass
+                self._hidden_compositor.frame_ready.connect(self._on_frame_ready)
 
             # Swap visual/text compositor targets so *all uploads* go to the hidden compositor.
             self._prev_visual_compositor = getattr(self._visual_director, "compositor", None)
@@ -272,6 +305,7 @@ class CuelistMp4Exporter(QObject):
                 session_data=self._session_data,
                 headless=True,
                 time_provider=_time_provider,
+                encoder_hints=self._encoder_hints,
             )
             ok = self._session_runner.start()
             if not ok:
@@ -303,7 +337,7 @@ class CuelistMp4Exporter(QObject):
                         return
                     if self._last_frame is not None:
                         try:
-                            self._frame_q.put_nowait(self._last_frame)
+                            self._frame_q.put_nowait((self._last_frame, False))
                             self._frames_written += 1
                             self._emit_progress("Finalizing…")
                             return
@@ -378,8 +412,11 @@ class CuelistMp4Exporter(QObject):
         # Enforce 1:1 capture with simulation steps.
         if self._frames_written >= self._steps_done:
             return
+        # Capture is synchronous, so this frame was painted after the step that made any new cut.
+        scene_seq = self._encoder_hints.seq
         try:
-            self._frame_q.put_nowait(frame)
+            self._frame_q.put_nowait((frame, scene_seq != self._enqueued_scene_seq))
+            self._enqueued_scene_seq = scene_seq
             self._frames_written += 1
         except queue.Full:
             # If full, we’ll pause stepping in the timer.
@@ -429,7 +466,9 @@ class CuelistMp4Exporter(QObject):
         try:
             if self._hidden_compositor is not None:
                 try:
-                    if hasattr(self._hidden_compositor, "set_preview_capture_enabled"):
+                    if hasattr(self._hidden_compositor, "unregister_capture_consumer"):
+                        self._hidden_compositor.unregister_capture_consumer("export")
+                    elif hasattr(self._hidden_compositor, "set_preview_capture_enabled"):
                         self._hidden_compositor.set_preview_capture_enabled(False)
                 except Exception:
                     pass
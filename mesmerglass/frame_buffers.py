@@ -0,0 +1,134 @@
+"""Pooled, reference-counted frame buffers for the capture -> encode path.
+
+Every streamed frame used to allocate several full-size arrays (readback copy,
+cache copy, deep copy, resize output). At 2048x1024 RGB each one is 6 MB, and
+fresh allocations of that size return to the OS and get zero-filled again on
+the next frame. They also cause allocation bursts that move the GC's
+generation counters at random frame boundaries.
+
+``frame_buffers.acquire(shape)`` returns an ordinary numpy array backed by a
+pooled buffer. The array's ``base`` is a small lease object that exposes the
+memory to numpy through ``__array_interface__``. Python's own reference
+counting decides when a buffer is free: once the last array or view that
+refers to the lease is gone, the buffer goes back to the pool. Producers and
+consumers therefore need no explicit release call. A frame that is cached,
+queued or dumped stays valid for as long as anything holds it.
+
+``MESMERGLASS_FRAME_POOL_MAX`` caps the idle buffers kept per shape
+(default 6); 0 disables pooling, so ``acquire`` falls back to ``np.empty``.
+"""
+from __future__ import annotations
+
+import os
+import threading
+from collections import deque
+from typing import Deque, Dict, Optional, Tuple
+
+import numpy as np
+
+_Key = Tuple[Tuple[int, ...], str]
+
+
+def _default_max_idle() -> int:
+    try:
+        return max(0, int(os.environ.get("MESMERGLASS_FRAME_POOL_MAX", "6")))
+    except ValueError:
+        return 6
+
+
+class _Lease:
+    """Owner of one pooled buffer; returns it to the pool when no array refers to it."""
+
+    __slots__ = ("_pool", "_key", "_backing", "__array_interface__")
+
+    def __init__(self, pool: "FrameBufferPool", key: _Key, backing: np.ndarray) -> None:
+        self._pool = pool
+        self._key = key
+        self._backing = backing
+        self.__array_interface__ = backing.__array_interface__
+
+    def __del__(self) -> None:
+        try:
+            self._pool._release(self._key, self._backing)
+        except Exception:
+            # Interpreter shutdown: module state may already be gone.
+            pass
+
+
+class FrameBufferPool:
+    """Per-shape free lists of frame-sized arrays, handed out as reference-counted leases."""
+
+    def __init__(self, max_idle: Optional[int] = None) -> None:
+        self.max_idle = _default_max_idle() if max_idle is None else max(0, int(max_idle))
+        # Reentrant: a lease can be released by a GC pass triggered inside acquire().
+        self._lock = threading.RLock()
+        self._free: Dict[_Key, Deque[np.ndarray]] = {}
+        self.hits = 0
+        self.misses = 0
+        self.returned = 0
+        self.dropped = 0
+
+    @property
+    def enabled(self) -> bool:
+        return self.max_idle > 0
+
+    def acquire(self, shape, dtype=np.uint8) -> np.ndarray:
+        """An uninitialised array of ``shape``/``dtype`` whose memory returns to the pool when freed."""
+        shape = tuple(int(s) for s in shape)
+        dt = np.dtype(dtype)
+        if not self.enabled:
+            return np.empty(shape, dtype=dt)
+        key = (shape, dt.str)
+        backing = None
+        with self._lock:
+            free = self._free.get(key)
+            if free:
+                backing = free.pop()
+                self.hits += 1
+            else:
+                self.misses += 1
+        if backing is None:
+            backing = np.empty(shape, dtype=dt)
+        return np.asarray(_Lease(self, key, backing))
+
+    def copy(self, src: np.ndarray) -> np.ndarray:
+        """Pooled equivalent of ``np.array(src, copy=True)`` (C-contiguous)."""
+        out = self.acquire(src.shape, src.dtype)
+        np.copyto(out, src)
+        return out
+
+    def stats(self) -> dict:
+        with self._lock:
+            idle = sum(len(v) for v in self._free.values())
+            idle_bytes = sum(b.nbytes for v in self._free.values() for b in v)
+        total = self.hits + self.misses
+        return {
+            "max_idle": self.max_idle,
+            "idle": idle,
+            "idle_mb": round(idle_bytes / (1024 * 1024), 1),
+            "hits": self.hits,
+            "misses": self.misses,
+            "hit_rate": round(self.hits / total, 3) if total else 0.0,
+            "returned": self.returned,
+            "dropped": self.dropped,
+        }
+
+    def clear(self) -> None:
+        """Drop idle buffers (outstanding leases still return when released)."""
+        with self._lock:
+            self._free.clear()
+
+    def _release(self, key: _Key, backing: np.ndarray) -> None:
+        with self._lock:
+            free = self._free.setdefault(key, deque())
+            if len(free) < self.max_idle:
+                free.append(backing)
+                self.returned += 1
+            else:
+                self.dropped += 1
+
+
+# Shared by capture, the VR producers and the encoders.
+frame_buffers = FrameBufferPool()
+
+__all__ = ["FrameBufferPool", "frame_buffers"]
@@ -0,0 +1,639 @@
+"""Multi-consumer frame capture bus for the window compositor.
+
+Consumers (Home preview, VR streaming, MP4 export, ...) register the
+resolution, pixel format and rate they actually want. Once per painted frame
+the compositor asks the bus which consumers are due, groups them into
+variants (one per distinct size/format/sync combination) and produces each
+variant from the same rendered frame:
+
+- The GPU downsamples the window framebuffer into a per-variant FBO with
+  ``glBlitFramebuffer`` (halving chain for large reductions, vertical flip
+  folded into the final blit so no CPU ``flipud`` copy is needed).
+- NV12 variants get one more pass: a small shader writes the Y plane and the
+  interleaved, 2x2-averaged UV plane (BT.601 limited range) into an R8 target,
+  so the readback is already encoder layout and 1.5 bytes per pixel instead of
+  3. Only if that program cannot be built does ``rgb_to_nv12`` convert on the
+  CPU instead.
+- Readback goes through a small ring of pixel-pack buffers, so the CPU maps
+  a buffer that the GPU finished filling one or two frames ago instead of
+  stalling the pipeline in ``glReadPixels``.
+
+Consumers that need strict frame-accurate capture (offline export) can opt
+into ``sync=True`` to read back in the same paint. While a callback runs,
+``CaptureBus.rendered_at`` holds the paint time of the frame being delivered
+(PBO frames arrive a paint or two after they were rendered).
+
+The scheduling/grouping logic in :class:`CaptureBus` is GL-free so it can be
+unit tested; :class:`GLCaptureReadback` holds the GL objects and must only be
+used with the compositor context current.
+"""
+
+from __future__ import annotations
+
+import logging
+import os
+import threading
+import time
+from dataclasses import dataclass, field
+from enum import Enum
+from typing import Callable, Optional
+
+import numpy as np
+
+from mesmerglass.frame_buffers import frame_buffers
+
+logger = logging.getLogger(__name__)
+
+
+class CaptureFormat(str, Enum):
+    """Pixel layout delivered to a consumer."""
+
+    RGB = "rgb"  # (h, w, 3) uint8, top-down
+    NV12 = "nv12"  # (h * 3 // 2, w) uint8: Y plane followed by interleaved UV
+    PREVIEW = "preview"  # RGB, downsampled to fit inside (width, height), aspect kept
+
+
+# Default bounding box for PREVIEW consumers when no size is given.
+DEFAULT_PREVIEW_SIZE = (480, 270)
+
+
+@dataclass
+class CaptureConsumer:
+    name: str
+    callback: Callable[[np.ndarray], None]
+    width: int = 0  # 0 => source size
+    height: int = 0
+    fmt: CaptureFormat = CaptureFormat.RGB
+    max_fps: float = 30.0
+    sync: bool = False
+    last_t: float = field(default=0.0, repr=False)
+    delivered: int = field(default=0, repr=False)
+
+    @property
+    def interval_s(self) -> float:
+        return 1.0 / max(1.0, float(self.max_fps))
+
+
+@dataclass(frozen=True)
+class CaptureVariant:
+    """One readback produced per frame, shared by every consumer that wants it."""
+
+    width: int
+    height: int
+    fmt: CaptureFormat
+    sync: bool
+
+    @property
+    def readback_format(self) -> str:
+        # PREVIEW is an RGB readback; NV12 comes back as one R8 plane from the shader pass.
+        return "nv12" if self.fmt == CaptureFormat.NV12 else "rgb"
+
+    @property
+    def readback_shape(self) -> tuple[int, ...]:
+        if self.readback_format == "nv12":
+            return (self.height * 3 // 2, self.width)
+        return (self.height, self.width, 3)
+
+
+def _even(v: int) -> int:
+    v = max(2, int(v))
+    return v - (v & 1)
+
+
+def resolve_variant_size(consumer: CaptureConsumer, src_w: int, src_h: int) -> tuple[int, int]:
+    """Resolve the output size a consumer wants for a given source size."""
+    src_w = max(1, int(src_w))
+    src_h = max(1, int(src_h))
+    w = int(consumer.width or 0)
+    h = int(consumer.height or 0)
+
+    if consumer.fmt == CaptureFormat.PREVIEW:
+        box_w, box_h = (w, h) if (w > 0 and h > 0) else DEFAULT_PREVIEW_SIZE
+        scale = min(float(box_w) / src_w, float(box_h) / src_h, 1.0)
+        w = max(1, int(round(src_w * scale)))
+        h = max(1, int(round(src_h * scale)))
+    elif w <= 0 or h <= 0:
+        w, h = src_w, src_h
+
+    if consumer.fmt == CaptureFormat.NV12:
+        # 4:2:0 chroma subsampling needs even dimensions.
+        w, h = _even(w), _even(h)
+    return w, h
+
+
+def rgb_to_nv12(frame: np.ndarray) -> np.ndarray:
+    """Convert an RGB uint8 frame to NV12 (BT.601 limited range).
+
+    Returns a single (h * 3 // 2, w) uint8 array: the Y plane followed by the
+    interleaved UV plane, which is the layout hardware encoders expect. This is
+    the CPU reference for ``_NV12_FRAGMENT_SHADER`` and the fallback when that
+    program is unavailable.
+    """
+    h, w = int(frame.shape[0]), int(frame.shape[1])
+    if (h & 1) or (w & 1):
+        frame = frame[: h - (h & 1), : w - (w & 1)]
+        h, w = int(frame.shape[0]), int(frame.shape[1])
+
+    rgb = frame.astype(np.int32, copy=False)
+    r = rgb[:, :, 0]
+    g = rgb[:, :, 1]
+    b = rgb[:, :, 2]
+
+    out = np.empty((h * 3 // 2, w), dtype=np.uint8)
+    y = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16
+    out[:h] = np.clip(y, 0, 255)
+
+    # Average 2x2 blocks before chroma conversion.
+    r2 = (r[0::2, 0::2] + r[1::2, 0::2] + r[0::2, 1::2] + r[1::2, 1::2] + 2) >> 2
+    g2 = (g[0::2, 0::2] + g[1::2, 0::2] + g[0::2, 1::2] + g[1::2, 1::2] + 2) >> 2
+    b2 = (b[0::2, 0::2] + b[1::2, 0::2] + b[0::2, 1::2] + b[1::2, 1::2] + 2) >> 2
+    u = ((-38 * r2 - 74 * g2 + 112 * b2 + 128) >> 8) + 128
+    v = ((112 * r2 - 94 * g2 - 18 * b2 + 128) >> 8) + 128
+    uv = out[h:].reshape(h // 2, w // 2, 2)
+    uv[:, :, 0] = np.clip(u, 0, 255)
+    uv[:, :, 1] = np.clip(v, 0, 255)
+    return out
+
+
+class CaptureBus:
+    """Consumer registry + per-frame scheduling (GL-free)."""
+
+    def __init__(self) -> None:
+        self._lock = threading.Lock()
+        self._consumers: dict[str, CaptureConsumer] = {}
+        # Bumped on every (un)registration so GL targets can be pruned lazily.
+        self.generation = 0
+        # perf_counter time the frame currently being delivered was painted.
+        self.rendered_at: Optional[float] = None
+
+    # ---- registration -------------------------------------------------
+    def register(
+        self,
+        name: str,
+        callback: Callable[[np.ndarray], None],
+        *,
+        width: int = 0,
+        height: int = 0,
+        fmt: CaptureFormat | str = CaptureFormat.RGB,
+        max_fps: float = 30.0,
+        sync: bool = False,
+    ) -> CaptureConsumer:
+        """Register (or replace) a consumer by name."""
+        try:
+            fmt_eff = CaptureFormat(fmt)
+        except ValueError:
+            logger.warning("[capture] Unknown capture format %r for %s; using rgb", fmt, name)
+            fmt_eff = CaptureFormat.RGB
+        consumer = CaptureConsumer(
+            name=str(name),
+            callback=callback,
+            width=max(0, int(width or 0)),
+            height=max(0, int(height or 0)),
+            fmt=fmt_eff,
+            max_fps=max(1.0, min(240.0, float(max_fps or 1.0))),
+            sync=bool(sync),
+        )
+        with self._lock:
+            self._consumers[consumer.name] = consumer
+            self.generation += 1
+        return consumer
+
+    def unregister(self, name: str) -> None:
+        with self._lock:
+            if self._consumers.pop(str(name), None) is not None:
+                self.generation += 1
+
+    def has_consumers(self) -> bool:
+        with self._lock:
+            return bool(self._consumers)
+
+    def consumer(self, name: str) -> Optional[CaptureConsumer]:
+        with self._lock:
+            return self._consumers.get(str(name))
+
+    def consumers(self) -> list[CaptureConsumer]:
+        with self._lock:
+            return list(self._consumers.values())
+
+    def live_variants(self, src_w: int, src_h: int) -> set[CaptureVariant]:
+        """Variants any registered consumer would currently need."""
+        with self._lock:
+            out = set()
+            for c in self._consumers.values():
+                w, h = resolve_variant_size(c, src_w, src_h)
+                out.add(CaptureVariant(width=w, height=h, fmt=c.fmt, sync=c.sync))
+            return out
+
+    # ---- per-frame scheduling -----------------------------------------
+    def plan(self, src_w: int, src_h: int, now: Optional[float] = None) -> dict[CaptureVariant, list[CaptureConsumer]]:
+        """Return the variants to produce this frame and who gets each one.
+
+        Rate limiting is per consumer, so a 15 fps preview no longer throttles a
+        60 fps export (or vice versa). Consumers marked due here have their
+        timestamp advanced immediately.
+        """
+        t = time.perf_counter() if now is None else float(now)
+        out: dict[CaptureVariant, list[CaptureConsumer]] = {}
+        with self._lock:
+            for c in self._consumers.values():
+                # Allow a little slack so a 30 fps consumer on a 60 Hz paint loop
+                # doesn't alias down to 20 fps due to timer jitter.
+                if c.last_t and (t - c.last_t) < (c.interval_s * 0.9):
+                    continue
+                c.last_t = t
+                w, h = resolve_variant_size(c, src_w, src_h)
+                key = CaptureVariant(width=w, height=h, fmt=c.fmt, sync=c.sync)
+                out.setdefault(key, []).append(c)
+        return out
+
+    def deliver(
+        self,
+        variant: CaptureVariant,
+        consumers: list[CaptureConsumer],
+        rgb: np.ndarray,
+        rendered_at: Optional[float] = None,
+    ) -> None:
+        """Hand a read-back frame for ``variant`` to its consumers.
+
+        NV12 frames normally arrive converted by the GPU pass; an RGB readback
+        for an NV12 variant (shader unavailable) is converted here.
+        """
+        if rgb is None or getattr(rgb, "size", 0) == 0:
+            return
+        self.rendered_at = time.perf_counter() if rendered_at is None else float(rendered_at)
+        frame = rgb_to_nv12(rgb) if variant.fmt == CaptureFormat.NV12 and rgb.ndim == 3 else rgb
+        for c in consumers:
+            try:
+                c.callback(frame)
+                c.delivered += 1
+            except Exception as exc:  # pragma: no cover - consumer bug must not break paint
+                logger.debug("[capture] consumer %s failed: %s", c.name, exc)
+
+
+_NV12_VERTEX_SHADER = """#version 330 core
+void main() {
+    // Full-screen triangle from gl_VertexID; no vertex buffer needed.
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+}
+"""
+
+# Target is w x (h * 3 / 2) R8. Rows [0, h) are Y; rows [h, 3h/2) hold U,V pairs
+# for 2x2 blocks. The source is already top-down, so target row r maps to array
+# row r of the readback and no flip is needed. Same integer BT.601 coefficients
+# as rgb_to_nv12.
+_NV12_FRAGMENT_SHADER = """#version 330 core
+uniform sampler2D uSrc;
+uniform int uHeight;
+out vec4 FragColor;
+
+vec3 fetch(ivec2 p) { return texelFetch(uSrc, p, 0).rgb * 255.0; }
+
+void main() {
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    float value;
+    if (p.y < uHeight) {
+        vec3 c = fetch(p);
+        value = dot(c, vec3(66.0, 129.0, 25.0)) / 256.0 + 16.0;
+    } else {
+        ivec2 q = ivec2(p.x & ~1, (p.y - uHeight) * 2);
+        vec3 c = (fetch(q) + fetch(q + ivec2(1, 0)) + fetch(q + ivec2(0, 1)) + fetch(q + ivec2(1, 1))) * 0.25;
+        value = (p.x & 1) == 0
+            ? dot(c, vec3(-38.0, -74.0, 112.0)) / 256.0 + 128.0
+            : dot(c, vec3(112.0, -94.0, -18.0)) / 256.0 + 128.0;
+    }
+    FragColor = vec4(clamp(value, 0.0, 255.0) / 255.0, 0.0, 0.0, 1.0);
+}
+"""
+
+
+class GLCaptureReadback:
+    """GPU downsampling + asynchronous pixel-pack-buffer readback ring.
+
+    Must be created and used with the compositor GL context current.
+    """
+
+    def __init__(self, ring_size: Optional[int] = None) -> None:
+        if ring_size is None:
+            try:
+                ring_size = int(os.environ.get("MESMERGLASS_CAPTURE_RING", "3"))
+            except Exception:
+                ring_size = 3
+        self._ring_size = max(2, min(8, int(ring_size)))
+        # variant -> {"fbo", "tex", "pbos", "next", "pending": deque[(slot, consumers, rendered_at)]}
+        self._targets: dict[CaptureVariant, dict] = {}
+        # (w, h) -> (fbo, tex) scratch targets for the halving chain
+        self._scratch: dict[tuple[int, int], tuple[int, int]] = {}
+        self._pbo_supported = True
+        # NV12 pass: (program, vao, uHeight location) once built, False if it can't be.
+        self._nv12 = None
+        self._bus_generation = -1
+        self._src_size = (0, 0)
+
+    def has_pending(self) -> bool:
+        return any(tgt["pending"] for tgt in self._targets.values())
+
+    # ---- GL object helpers --------------------------------------------
+    @staticmethod
+    def _make_fbo(w: int, h: int, single_channel: bool = False) -> tuple[int, int]:
+        from OpenGL import GL
+
+        tex = GL.glGenTextures(1)
+        GL.glBindTexture(GL.GL_TEXTURE_2D, tex)
+        GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_MIN_FILTER, GL.GL_LINEAR)
+        GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_MAG_FILTER, GL.GL_LINEAR)
+        if single_channel:
+            GL.glTexImage2D(GL.GL_TEXTURE_2D, 0, GL.GL_R8, int(w), int(h), 0, GL.GL_RED, GL.GL_UNSIGNED_BYTE, None)
+        else:
+            GL.glTexImage2D(GL.GL_TEXTURE_2D, 0, GL.GL_RGBA8, int(w), int(h), 0, GL.GL_RGBA, GL.GL_UNSIGNED_BYTE, None)
+        GL.glBindTexture(GL.GL_TEXTURE_2D, 0)
+        fbo = GL.glGenFramebuffers(1)
+        GL.glBindFramebuffer(GL.GL_FRAMEBUFFER, fbo)
+        GL.glFramebufferTexture2D(GL.GL_FRAMEBUFFER, GL.GL_COLOR_ATTACHMENT0, GL.GL_TEXTURE_2D, tex, 0)
+        status = GL.glCheckFramebufferStatus(GL.GL_FRAMEBUFFER)
+        GL.glBindFramebuffer(GL.GL_FRAMEBUFFER, 0)
+        if status != GL.GL_FRAMEBUFFER_COMPLETE:
+            raise RuntimeError(f"capture FBO incomplete 0x{int(status):04X}")
+        return int(fbo), int(tex)
+
+    def _target(self, variant: CaptureVariant) -> dict:
+        from OpenGL import GL
+
+        tgt = self._targets.get(variant)
+        if tgt is not None:
+            return tgt
+        fbo, tex = self._make_fbo(variant.width, variant.height)
+        nv12_fbo = nv12_tex = 0
+        if variant.readback_format == "nv12" and self._nv12_pass() is not None:
+            try:
+                nv12_fbo, nv12_tex = self._make_fbo(variant.width, variant.height * 3 // 2, single_channel=True)
+            except Exception as exc:
+                logger.warning("[capture] NV12 target unavailable (%s); converting on the CPU", exc)
+                self._nv12 = False
+        shape = variant.readback_shape if nv12_fbo else (variant.height, variant.width, 3)
+        pbos: list[int] = []
+        if self._pbo_supported and not variant.sync:
+            try:
+                ids = GL.glGenBuffers(self._ring_size)
+                pbos = [int(ids)] if isinstance(ids, (int, np.integer)) else [int(x) for x in ids]
+                nbytes = int(np.prod(shape))
+                for pbo in pbos:
+                    GL.glBindBuffer(GL.GL_PIXEL_PACK_BUFFER, pbo)
+                    GL.glBufferData(GL.GL_PIXEL_PACK_BUFFER, nbytes, None, GL.GL_STREAM_READ)
+                GL.glBindBuffer(GL.GL_PIXEL_PACK_BUFFER, 0)
+            except Exception as exc:
+                logger.warning("[capture] PBO readback unavailable (%s); falling back to sync readback", exc)
+                self._pbo_supported = False
+                pbos = []
+        from collections import deque
+
+        tgt = {
+            "fbo": fbo,
+            "tex": tex,
+            "nv12_fbo": nv12_fbo,
+            "nv12_tex": nv12_tex,
+            "shape": shape,
+            "pbos": pbos,
+            "next": 0,
+            "pending": deque(),
+        }
+        self._targets[variant] = tgt
+        return tgt
+
+    def _nv12_pass(self) -> Optional[tuple[int, int, int]]:
+        """(program, vao, uHeight location) for the NV12 pass, or None if it can't be built."""
+        if self._nv12 is None:
+            from OpenGL import GL
+
+            from . import shader_cache
+
+            def compile_shader(src: str, shader_type: int) -> int:
+                sid = GL.glCreateShader(shader_type)
+                GL.glShaderSource(sid, src)
+                GL.glCompileShader(sid)
+                if not GL.glGetShaderiv(sid, GL.GL_COMPILE_STATUS):
+                    raise RuntimeError(GL.glGetShaderInfoLog(sid).decode("utf-8", "ignore"))
+                return sid
+
+            try:
+                prog = shader_cache.link_program(
+                    [(GL.GL_VERTEX_SHADER, _NV12_VERTEX_SHADER), (GL.GL_FRAGMENT_SHADER, _NV12_FRAGMENT_SHADER)],
+                    label="Capture NV12 program",
+                    compile_shader=compile_shader,
+                )
+                GL.glUseProgram(prog)
+                GL.glUniform1i(GL.glGetUniformLocation(prog, "uSrc"), 0)
+                GL.glUseProgram(0)
+                self._nv12 = (int(prog), int(GL.glGenVertexArrays(1)), int(GL.glGetUniformLocation(prog, "uHeight")))
+            except Exception as exc:
+                logger.warning("[capture] NV12 shader unavailable (%s); converting on the CPU", exc)
+                self._nv12 = False
+        return self._nv12 or None
+
+    def _convert_nv12(self, tgt: dict, w: int, h: int) -> None:
+        """Render the NV12 planes of ``tgt``'s RGB texture into its R8 target."""
+        from OpenGL import GL
+
+        prog, vao, height_loc = self._nv12
+        prev_prog = GL.glGetIntegerv(GL.GL_CURRENT_PROGRAM)
+        prev_vao = GL.glGetIntegerv(GL.GL_VERTEX_ARRAY_BINDING)
+        prev_unit = GL.glGetIntegerv(GL.GL_ACTIVE_TEXTURE)
+        prev_viewport = GL.glGetIntegerv(GL.GL_VIEWPORT)
+        blend = GL.glIsEnabled(GL.GL_BLEND)
+        scissor = GL.glIsEnabled(GL.GL_SCISSOR_TEST)
+        GL.glActiveTexture(GL.GL_TEXTURE0)
+        prev_tex = GL.glGetIntegerv(GL.GL_TEXTURE_BINDING_2D)
+        try:
+            GL.glDisable(GL.GL_BLEND)
+            GL.glDisable(GL.GL_SCISSOR_TEST)
+            GL.glBindFramebuffer(GL.GL_DRAW_FRAMEBUFFER, tgt["nv12_fbo"])
+            GL.glViewport(0, 0, int(w), int(h) * 3 // 2)
+            GL.glUseProgram(prog)
+            GL.glUniform1i(height_loc, int(h))
+            GL.glBindTexture(GL.GL_TEXTURE_2D, tgt["tex"])
+            GL.glBindVertexArray(vao)
+            GL.glDrawArrays(GL.GL_TRIANGLES, 0, 3)
+        finally:
+            GL.glBindVertexArray(int(prev_vao))
+            GL.glBindTexture(GL.GL_TEXTURE_2D, int(prev_tex))
+            GL.glActiveTexture(int(prev_unit))
+            GL.glUseProgram(int(prev_prog))
+            GL.glViewport(*[int(v) for v in prev_viewport])
+            if blend:
+                GL.glEnable(GL.GL_BLEND)
+            if scissor:
+                GL.glEnable(GL.GL_SCISSOR_TEST)
+
+    def _scratch_fbo(self, w: int, h: int) -> int:
+        key = (int(w), int(h))
+        entry = self._scratch.get(key)
+        if entry is None:
+            entry = self._make_fbo(w, h)
+            self._scratch[key] = entry
+        return entry[0]
+
+    # ---- per-frame work -------------------------------------------------
+    def _downsample(self, src_fbo: int, src_w: int, src_h: int, dst_fbo: int, dst_w: int, dst_h: int) -> None:
+        """Blit source into dst (top-down), halving first when the reduction is large."""
+        from OpenGL import GL
+
+        cur_fbo, cur_w, cur_h = int(src_fbo), int(src_w), int(src_h)
+        # A single linear blit only samples 2x2 texels; halve until within 2x so
+        # tiny previews don't alias the spiral into moire.
+        while cur_w >= dst_w * 4 and cur_h >= dst_h * 4:
+            nw, nh = max(1, cur_w // 2), max(1, cur_h // 2)
+            nxt = self._scratch_fbo(nw, nh)
+            GL.glBindFramebuffer(GL.GL_READ_FRAMEBUFFER, cur_fbo)
+            GL.glBindFramebuffer(GL.GL_DRAW_FRAMEBUFFER, nxt)
+            GL.glBlitFramebuffer(0, 0, cur_w, cur_h, 0, 0, nw, nh, GL.GL_COLOR_BUFFER_BIT, GL.GL_LINEAR)
+            cur_fbo, cur_w, cur_h = nxt, nw, nh
+
+        GL.glBindFramebuffer(GL.GL_READ_FRAMEBUFFER, cur_fbo)
+        GL.glBindFramebuffer(GL.GL_DRAW_FRAMEBUFFER, dst_fbo)
+        # Flip vertically in the blit (GL origin is bottom-left) so readback is top-down.
+        GL.glBlitFramebuffer(0, 0, cur_w, cur_h, 0, dst_h, dst_w, 0, GL.GL_COLOR_BUFFER_BIT, GL.GL_LINEAR)
+
+    def capture(
+        self,
+        bus: CaptureBus,
+        plan: dict[CaptureVariant, list[CaptureConsumer]],
+        src_fbo: int,
+        src_w: int,
+        src_h: int,
+    ) -> None:
+        """Produce every planned variant and deliver any completed readbacks."""
+        from OpenGL import GL
+
+        try:
+            prev_read = GL.glGetIntegerv(GL.GL_READ_FRAMEBUFFER_BINDING)
+            prev_draw = GL.glGetIntegerv(GL.GL_DRAW_FRAMEBUFFER_BINDING)
+        except Exception:
+            prev_read = prev_draw = 0
+
+        if bus.generation != self._bus_generation or self._src_size != (int(src_w), int(src_h)):
+            self._bus_generation = bus.generation
+            self._src_size = (int(src_w), int(src_h))
+            self.drop_unused(bus.live_variants(src_w, src_h) | set(plan.keys()))
+
+        rendered_at = time.perf_counter()
+        try:
+            GL.glPixelStorei(GL.GL_PACK_ALIGNMENT, 1)
+            for variant, consumers in plan.items():
+                tgt = self._target(variant)
+                self._downsample(src_fbo, src_w, src_h, tgt["fbo"], variant.width, variant.height)
+                if tgt["nv12_fbo"]:
+                    self._convert_nv12(tgt, variant.width, variant.height)
+                    GL.glBindFramebuffer(GL.GL_READ_FRAMEBUFFER, tgt["nv12_fbo"])
+                    read_fmt = GL.GL_RED
+                else:
+                    GL.glBindFramebuffer(GL.GL_READ_FRAMEBUFFER, tgt["fbo"])
+                    read_fmt = GL.GL_RGB
+                rows, cols = tgt["shape"][0], tgt["shape"][1]
+
+                if variant.sync or not tgt["pbos"]:
+                    pixels = GL.glReadPixels(0, 0, cols, rows, read_fmt, GL.GL_UNSIGNED_BYTE)
+                    frame = np.frombuffer(pixels, dtype=np.uint8).reshape(tgt["shape"])
+                    bus.deliver(variant, consumers, frame, rendered_at)
+                    continue
+
+                slot = tgt["next"]
+                tgt["next"] = (slot + 1) % len(tgt["pbos"])
+                GL.glBindBuffer(GL.GL_PIXEL_PACK_BUFFER, tgt["pbos"][slot])
+                GL.glReadPixels(0, 0, cols, rows, read_fmt, GL.GL_UNSIGNED_BYTE, 0)
+                GL.glBindBuffer(GL.GL_PIXEL_PACK_BUFFER, 0)
+                tgt["pending"].append((slot, consumers, rendered_at))
+
+            # Map ring slots the GPU has had at least one frame to finish. Variants
+            # not produced this paint drain fully so rate-limited consumers don't
+            # wait a whole extra interval for their frame.
+            for variant, tgt in self._targets.items():
+                pending = tgt["pending"]
+                keep = max(1, len(tgt["pbos"]) - 2) if variant in plan else 0
+                while len(pending) > keep:
+                    slot, consumers, painted_at = pending.popleft()
+                    frame = self._map_slot(tgt["pbos"][slot], tgt["shape"])
+                    if frame is not None:
+                        bus.deliver(variant, consumers, frame, painted_at)
+        finally:
+            try:
+                GL.glBindFramebuffer(GL.GL_READ_FRAMEBUFFER, int(prev_read))
+                GL.glBindFramebuffer(GL.GL_DRAW_FRAMEBUFFER, int(prev_draw))
+            except Exception:
+                pass
+
+    @staticmethod
+    def _map_slot(pbo: int, shape: tuple[int, ...]) -> Optional[np.ndarray]:
+        import ctypes
+        from OpenGL import GL
+
+        nbytes = int(np.prod(shape))
+        GL.glBindBuffer(GL.GL_PIXEL_PACK_BUFFER, pbo)
+        try:
+            ptr = GL.glMapBufferRange(GL.GL_PIXEL_PACK_BUFFER, 0, nbytes, GL.GL_MAP_READ_BIT)
+            if not ptr:
+                return None
+            try:
+                buf = (ctypes.c_ubyte * nbytes).from_address(int(ptr))
+                # Copy out before unmapping; this is the only CPU copy on the path. The
+                # destination is pooled and returns to the pool once consumers drop it.
+                return frame_buffers.copy(np.frombuffer(buf, dtype=np.uint8).reshape(shape))
+            finally:
+                GL.glUnmapBuffer(GL.GL_PIXEL_PACK_BUFFER)
+        except Exception as exc:
+            logger.debug("[capture] PBO map failed: %s", exc)
+            return None
+        finally:
+            GL.glBindBuffer(GL.GL_PIXEL_PACK_BUFFER, 0)
+
+    def drop_unused(self, live: set[CaptureVariant]) -> None:
+        """Free targets for variants no consumer wants anymore."""
+        for variant in [v for v in self._targets if v not in live]:
+            self._release_target(self._targets.pop(variant))
+
+    def _release_target(self, tgt: dict) -> None:
+        from OpenGL import GL
+
+        try:
+            if tgt.get("pbos"):
+                GL.glDeleteBuffers(len(tgt["pbos"]), tgt["pbos"])
+            GL.glDeleteFramebuffers(1, [int(tgt["fbo"])])
+            GL.glDeleteTextures(1, [int(tgt["tex"])])
+            if tgt.get("nv12_fbo"):
+                GL.glDeleteFramebuffers(1, [int(tgt["nv12_fbo"])])
+                GL.glDeleteTextures(1, [int(tgt["nv12_tex"])])
+        except Exception:
+            pass
+
+    def release(self) -> None:
+        from OpenGL import GL
+
+        for tgt in self._targets.values():
+            self._release_target(tgt)
+        self._targets.clear()
+        for fbo, tex in self._scratch.values():
+            try:
+                GL.glDeleteFramebuffers(1, [int(fbo)])
+                GL.glDeleteTextures(1, [int(tex)])
+            except Exception:
+                pass
+        self._scratch.clear()
+        if self._nv12:
+            prog, vao, _loc = self._nv12
+            try:
+                GL.glDeleteProgram(prog)
+                GL.glDeleteVertexArrays(1, [vao])
+            except Exception:
+                pass
+        self._nv12 = None
+
+
+__all__ = [
+    "CaptureBus",
+    "CaptureConsumer",
+    "CaptureFormat",
+    "CaptureVariant",
+    "DEFAULT_PREVIEW_SIZE",
+    "GLCaptureReadback",
+    "resolve_variant_size",
+    "rgb_to_nv12",
+]
@@ -1566,7 +1566,7 @@ class LoomCompositor(QOpenGLWidget):  # type: ignore[misc]
         self._video_pool_width = 0
         self._video_pool_height = 0
     
-    def set_background_video_frame(self, frame_data: 'np.ndarray', width: int, height: int, zoom: float = 1.0, new_video: bool = False) -> None:
+    def set_background_video_frame(self, frame_data: 'np.ndarray', width: int, height: int, zoom: float = 1.0, new_video: bool = False, frame_key: Optional[tuple] = None) -> None:
         """Update background with video frame (efficient GPU upload).
         
         This method uploads a video frame directly to GPU, reusing the same texture ID
@@ -1578,6 +1578,8 @@ class LoomCompositor(QOpenGLWidget):  # type: ignore[misc]
             height: Frame height in pixels
             zoom: Zoom factor (1.0 = fit to screen, >1.0 = zoomed in)
             new_video: True if this is the first frame of a new video (triggers fade transition)
+            frame_key: Accepted for parity with LoomWindowCompositor; the widget's context
+                does not share textures, so every frame is uploaded
         
         Note:
             - For video playback, call this every frame with new frame data
@@ -0,0 +1,383 @@
+"""Textures shared by the compositors' GL contexts.
+
+Each compositor window (primary, one per extra monitor, the export's hidden
+window) used to upload its own copy of every background image, video frame and
+text texture. VRAM and upload bandwidth therefore grew with the number of
+outputs. Window compositors are now created sharing one context group
+(``share_context``). Their uploads go through ``SharedTextures``: the first
+compositor of a group that needs a texture uploads it, and the others get the
+same texture id. A texture is released once no compositor holds it; each
+compositor holds a texture once, however many of its layers show it.
+
+Textures are found by a key and, optionally, the object they were uploaded
+from. That object is held weakly, so a recycled ``id()`` never matches a stale
+texture. A released texture is kept for reuse while its source is alive, up to
+``MESMERGLASS_GPU_IDLE_MB`` per group. This matters for the subtext carousel,
+which clears and re-adds the same text every frame. Released video textures are
+kept the same way and their storage is reused for later frames of that size.
+
+Contexts that do not share (a widget compositor, or a driver that refuses the
+share) each form their own group, which is the old per-compositor behaviour.
+All calls come from the GUI thread with a context of the group current. That is
+also when unused textures are deleted.
+
+Env:
+- ``MESMERGLASS_GPU_SHARE=0`` creates window compositors without the shared context.
+- ``MESMERGLASS_GPU_IDLE_MB`` sets the idle texture budget per group (default 64).
+"""
+
+from __future__ import annotations
+
+import logging
+import os
+import weakref
+from collections import OrderedDict
+from dataclasses import dataclass, field
+from typing import Any, Callable, Dict, Hashable, List, Optional, Set, Tuple
+
+logger = logging.getLogger(__name__)
+
+_DEFAULT_IDLE_MB = 64
+
+
+def sharing_enabled() -> bool:
+    return os.environ.get("MESMERGLASS_GPU_SHARE", "1").strip().lower() not in ("0", "false", "off", "no")
+
+
+def _idle_budget_bytes() -> int:
+    try:
+        return max(0, int(float(os.environ.get("MESMERGLASS_GPU_IDLE_MB", _DEFAULT_IDLE_MB)) * 1024 * 1024))
+    except ValueError:
+        return _DEFAULT_IDLE_MB * 1024 * 1024
+
+
+def _gl_delete(texture_ids: List[int]) -> None:
+    from OpenGL import GL
+
+    GL.glDeleteTextures(texture_ids)
+
+
+@dataclass
+class _Texture:
+    texture_id: int
+    kind: str
+    size: Tuple[int, int]
+    nbytes: int
+    key: Optional[Hashable] = None
+    source: Optional[Callable[[], Any]] = None  # weakref to the uploaded object
+    holders: Set[Hashable] = field(default_factory=set)
+
+    def matches(self, source: Any) -> bool:
+        if self.source is None:
+            return source is None
+        return source is not None and self.source() is source
+
+    def reusable(self) -> bool:
+        """Worth keeping without holders: a later lookup can still hit it."""
+        if self.kind == "video":
+            return True  # storage is reused for the next frame of this size
+        return self.key is not None and (self.source is None or self.source() is not None)
+
+
+@dataclass
+class _Group:
+    textures: Dict[int, _Texture] = field(default_factory=dict)
+    by_key: Dict[Hashable, int] = field(default_factory=dict)
+    members: set = field(default_factory=set)
+    idle: "OrderedDict[int, None]" = field(default_factory=OrderedDict)  # least recently released first
+    doomed: List[int] = field(default_factory=list)  # deleted at the next call with a context current
+    uploads: int = 0
+    hits: int = 0
+
+    def idle_bytes(self) -> int:
+        return sum(self.textures[t].nbytes for t in self.idle)
+
+
+class SharedTextures:
+    """Textures per GL share group and the compositors holding them.
+
+    ``group`` is any hashable naming the share group (see ``group_key``) and
+    ``holder`` any hashable naming the compositor. A holder holds a texture at
+    most once: acquiring it again is a no-op, and the holder releases it when
+    none of its layers show it any more. Texture ids are only meaningful inside
+    their group.
+    """
+
+    def __init__(self, idle_budget_bytes: Optional[int] = None, delete: Optional[Callable[[List[int]], None]] = None):
+        self._groups: Dict[Hashable, _Group] = {}
+        self._idle_budget = _idle_budget_bytes() if idle_budget_bytes is None else int(idle_budget_bytes)
+        self._delete = delete or _gl_delete
+
+    # ----- membership -----
+
+    def join(self, group: Hashable, holder: Hashable) -> None:
+        self._groups.setdefault(group, _Group()).members.add(holder)
+
+    def leave(self, group: Hashable, holder: Hashable) -> None:
+        """Drop everything ``holder`` holds; the last member to leave deletes the rest.
+
+        Call with the leaving compositor's context current. If it is already
+        gone the deletes fail quietly and the textures die with the group.
+        """
+        g = self._groups.get(group)
+        if g is None:
+            return
+        g.members.discard(holder)
+        for tex in list(g.textures.values()):
+            if holder in tex.holders:
+                tex.holders.discard(holder)
+                if not tex.holders:
+                    self._on_unheld(g, tex, delete_now=False)
+        if not g.members:
+            for tex in list(g.textures.values()):
+                self._doom(g, tex)
+        self._flush(g)
+        if not g.members:
+            del self._groups[group]
+
+    # ----- lookup / upload -----
+
+    def lookup(self, group: Hashable, holder: Hashable, key: Hashable, source: Any = None) -> Optional[int]:
+        """Texture already uploaded for ``key`` (from ``source``), now held by ``holder``."""
+        g = self._groups.get(group)
+        if g is None:
+            return None
+        self._flush(g)
+        texture_id = g.by_key.get(key)
+        if texture_id is None:
+            return None
+        tex = g.textures[texture_id]
+        if not tex.matches(source):
+            # Same key, different object: the old upload can never be hit again.
+            del g.by_key[key]
+            tex.key = None
+            if not tex.holders:
+                self._on_unheld(g, tex, delete_now=True)
+            return None
+        self._hold(g, tex, holder)
+        g.hits += 1
+        return texture_id
+
+    def acquire(
+        self,
+        group: Hashable,
+        holder: Hashable,
+        key: Hashable,
+        upload: Callable[[], int],
+        *,
+        source: Any = None,
+        kind: str = "image",
+        size: Tuple[int, int] = (0, 0),
+        nbytes: int = 0,
+    ) -> int:
+        """Return the group's texture for ``key``, calling ``upload`` only if there is none."""
+        texture_id = self.lookup(group, holder, key, source)
+        if texture_id is not None:
+            return texture_id
+        texture_id = int(upload())
+        self.register(group, holder, texture_id, key=key, source=source, kind=kind, size=size, nbytes=nbytes)
+        return texture_id
+
+    def register(
+        self,
+        group: Hashable,
+        holder: Hashable,
+        texture_id: int,
+        *,
+        key: Optional[Hashable] = None,
+        source: Any = None,
+        kind: str = "image",
+        size: Tuple[int, int] = (0, 0),
+        nbytes: int = 0,
+    ) -> None:
+        """Track a texture ``holder`` just created and holds."""
+        g = self._groups.setdefault(group, _Group())
+        g.members.add(holder)
+        self._flush(g)
+        tex = _Texture(int(texture_id), kind, (int(size[0]), int(size[1])), int(nbytes))
+        g.textures[tex.texture_id] = tex
+        if key is not None:
+            g.uploads += 1
+        self._set_key(g, tex, key, source)
+        self._hold(g, tex, holder)
+
+    def rekey(self, group: Hashable, texture_id: int, key: Optional[Hashable], source: Any = None) -> None:
+        """``texture_id`` was overwritten in place; it now holds the content for ``key``."""
+        g = self._groups.get(group)
+        tex = g.textures.get(int(texture_id)) if g else None
+        if tex is None:
+            return
+        if tex.key is not None and g.by_key.get(tex.key) == tex.texture_id:
+            del g.by_key[tex.key]
+        self._set_key(g, tex, key, source)
+        g.uploads += 1
+
+    def take_idle(self, group: Hashable, holder: Hashable, kind: str, size: Tuple[int, int]) -> Optional[int]:
+        """An unheld texture of ``kind`` and ``size`` to upload into, now held by ``holder``."""
+        g = self._groups.get(group)
+        if g is None:
+            return None
+        self._flush(g)
+        size = (int(size[0]), int(size[1]))
+        for texture_id in g.idle:
+            tex = g.textures[texture_id]
+            if tex.kind == kind and tex.size == size:
+                if tex.key is not None and g.by_key.get(tex.key) == texture_id:
+                    del g.by_key[tex.key]
+                tex.key = None
+                tex.source = None
+                self._hold(g, tex, holder)
+                return texture_id
+        return None
+
+    # ----- references -----
+
+    def release(self, group: Hashable, holder: Hashable, texture_id: Optional[int]) -> bool:
+        """``holder`` no longer shows the texture. False if the group does not manage the id."""
+        g = self._groups.get(group)
+        if g is None or texture_id is None:
+            return False
+        tex = g.textures.get(int(texture_id))
+        if tex is None:
+            return False
+        if holder in tex.holders:
+            tex.holders.discard(holder)
+            if not tex.holders:
+                self._on_unheld(g, tex, delete_now=True)
+        self._flush(g)
+        return True
+
+    def drop_idle(self, group: Hashable, kind: Optional[str] = None) -> None:
+        """Delete unheld textures (of ``kind``) now; a context of the group must be current."""
+        g = self._groups.get(group)
+        if g is None:
+            return
+        for texture_id in [t for t in g.idle if kind is None or g.textures[t].kind == kind]:
+            self._doom(g, g.textures[texture_id])
+        self._flush(g)
+
+    # ----- diagnostics -----
+
+    def stats(self) -> Dict[str, int]:
+        out = {"groups": 0, "textures": 0, "bytes": 0, "idle": 0, "idle_bytes": 0, "uploads": 0, "hits": 0}
+        for g in self._groups.values():
+            out["groups"] += 1
+            out["textures"] += len(g.textures)
+            out["bytes"] += sum(t.nbytes for t in g.textures.values())
+            out["idle"] += len(g.idle)
+            out["idle_bytes"] += g.idle_bytes()
+            out["uploads"] += g.uploads
+            out["hits"] += g.hits
+        return out
+
+    def holders(self, group: Hashable, texture_id: int) -> int:
+        g = self._groups.get(group)
+        tex = g.textures.get(int(texture_id)) if g else None
+        return len(tex.holders) if tex else 0
+
+    # ----- internals -----
+
+    def _set_key(self, g: _Group, tex: _Texture, key: Optional[Hashable], source: Any) -> None:
+        tex.key = key
+        tex.source = None
+        if source is not None:
+            try:
+                tex.source = weakref.ref(source)
+            except TypeError:
+                tex.key = None  # cannot prove identity later; never shared by key
+        if tex.key is None:
+            return
+        previous = g.by_key.get(tex.key)
+        if previous is not None and previous != tex.texture_id:
+            g.textures[previous].key = None
+            if not g.textures[previous].holders:
+                self._on_unheld(g, g.textures[previous], delete_now=True)
+        g.by_key[tex.key] = tex.texture_id
+
+    def _hold(self, g: _Group, tex: _Texture, holder: Hashable) -> None:
+        tex.holders.add(holder)
+        g.idle.pop(tex.texture_id, None)
+
+    def _on_unheld(self, g: _Group, tex: _Texture, *, delete_now: bool) -> None:
+        if tex.reusable():
+            g.idle[tex.texture_id] = None
+            g.idle.move_to_end(tex.texture_id)
+            while g.idle and g.idle_bytes() > self._idle_budget:
+                oldest = next(iter(g.idle))
+                self._doom(g, g.textures[oldest])
+        else:
+            self._doom(g, tex)
+        if delete_now:
+            self._flush(g)
+
+    def _doom(self, g: _Group, tex: _Texture) -> None:
+        g.idle.pop(tex.texture_id, None)
+        g.textures.pop(tex.texture_id, None)
+        if tex.key is not None and g.by_key.get(tex.key) == tex.texture_id:
+            del g.by_key[tex.key]
+        g.doomed.append(tex.texture_id)
+
+    def _flush(self, g: _Group) -> None:
+        # Idle textures whose source died can never be hit again.
+        for texture_id in [t for t in g.idle if not g.textures[t].reusable()]:
+            self._doom(g, g.textures[texture_id])
+        if not g.doomed:
+            return
+        doomed, g.doomed = g.doomed, []
+        try:
+            self._delete(doomed)
+        except Exception as exc:
+            logger.debug("[gpu] Failed to delete %d shared textures: %s", len(doomed), exc)
+
+
+_MANAGER: Optional[SharedTextures] = None
+_ANCHOR: Any = None  # QOpenGLContext, or False once creating it failed
+
+
+def manager() -> SharedTextures:
+    global _MANAGER
+    if _MANAGER is None:
+        _MANAGER = SharedTextures()
+    return _MANAGER
+
+
+def share_context(make_format: Optional[Callable[[], Any]] = None) -> Any:
+    """Context new window compositors share with, or None to create them unshared.
+
+    Uses Qt's global share context when the application enables
+    ``AA_ShareOpenGLContexts`` (widget compositors then join the group too);
+    otherwise a context created here, never made current, anchors the group.
+    """
+    global _ANCHOR
+    if not sharing_enabled():
+        return None
+    if _ANCHOR is None:
+        try:
+            from PyQt6.QtGui import QOpenGLContext
+
+            anchor = QOpenGLContext.globalShareContext()
+            if anchor is None:
+                anchor = QOpenGLContext()
+                if make_format is not None:
+                    anchor.setFormat(make_format())
+                if not anchor.create():
+                    raise RuntimeError("QOpenGLContext.create() failed")
+            _ANCHOR = anchor
+            logger.info("[gpu] Compositor windows share one GL context group")
+        except Exception as exc:
+            logger.info("[gpu] GL context sharing unavailable (%s); compositors upload their own textures", exc)
+            _ANCHOR = False
+    return _ANCHOR or None
+
+
+def group_key(context: Any) -> Optional[Hashable]:
+    """Hashable identity of ``context``'s share group (None without a context)."""
+    if context is None:
+        return None
+    try:
+        from PyQt6 import sip
+
+        return ("gl-share-group", sip.unwrapinstance(context.shareGroup()))
+    except Exception:
+        return ("gl-context", id(context))
+
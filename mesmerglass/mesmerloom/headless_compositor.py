@@ -0,0 +1,297 @@
+"""
+MesmerLoom headless compositor for streaming-only sessions.
+
+When MesmerGlass only streams to headsets, the window compositor still paints
+an on-screen overlay at monitor refresh (layered-window handling, vsync,
+present) and the capture bus keeps a subset of those frames for VR. The
+headless compositor runs the same paint code into an OffscreenGL FBO instead:
+
+- no platform window is ever created and the context is EGL surfaceless where
+  available, so it runs on a display-less server
+  (see ``vr.offscreen.ensure_headless_platform``);
+- it paints on a fixed timeline at the stream's frame rate and size, so every
+  rendered frame is streamed and none is presented;
+- the VR consumer reads back synchronously in the same paint. With nothing to
+  present there is no pipeline to keep busy, and the frame reaches the encoder
+  one stream frame earlier than through the PBO ring.
+
+It keeps LoomWindowCompositor's public API (uploads, background/video, text,
+capture consumers, ``enable_vr_streaming``), so VisualDirector, TextDirector
+and SessionRunner can drive it unchanged.
+"""
+
+import logging
+import time
+from collections import deque
+from typing import Callable, Optional, Tuple
+
+from OpenGL import GL
+from PyQt6.QtCore import Qt, QTimer
+from PyQt6.QtOpenGL import QOpenGLBuffer
+
+from mesmerglass.mesmerloom.capture_bus import CaptureFormat
+from mesmerglass.mesmerloom.window_compositor import LoomWindowCompositor
+from mesmerglass.mesmervisor.frame_pacer import FixedTimeline
+from mesmerglass.vr.offscreen import OffscreenGL
+
+logger = logging.getLogger(__name__)
+
+
+class _VertexArray:
+    """QOpenGLVertexArrayObject stand-in on a raw GL name.
+
+    The offscreen context may be an EGL context Qt does not know about, and Qt's
+    GL wrappers refuse to work without a Qt-current context.
+    """
+
+    def __init__(self) -> None:
+        self.id = int(GL.glGenVertexArrays(1))
+
+    def bind(self) -> None:
+        GL.glBindVertexArray(self.id)
+
+    def release(self) -> None:
+        GL.glBindVertexArray(0)
+
+    def isCreated(self) -> bool:
+        return bool(self.id)
+
+    def destroy(self) -> None:
+        GL.glDeleteVertexArrays(1, [self.id])
+        self.id = 0
+
+
+class _Buffer:
+    """QOpenGLBuffer stand-in on a raw GL name (see _VertexArray)."""
+
+    def __init__(self, target: int, data) -> None:
+        self.target = target
+        self.id = int(GL.glGenBuffers(1))
+        self.bind()
+        GL.glBufferData(target, data.nbytes, data, GL.GL_STATIC_DRAW)
+
+    def bind(self) -> None:
+        GL.glBindBuffer(self.target, self.id)
+
+    def release(self) -> None:
+        GL.glBindBuffer(self.target, 0)
+
+    def isCreated(self) -> bool:
+        return bool(self.id)
+
+    def destroy(self) -> None:
+        GL.glDeleteBuffers(1, [self.id])
+        self.id = 0
+
+
+class LoomHeadlessCompositor(LoomWindowCompositor):
+    """LoomWindowCompositor that paints into an offscreen FBO at a fixed rate.
+
+    Call ``start()`` (or ``show()``) to begin rendering and ``stop()`` to pause.
+    The GL context stays current on the owning (Qt main) thread between paints
+    so uploads from the directors never have to wait for a window to expose.
+    """
+
+    def __init__(self, director, width: int, height: int, fps: float = 30.0, text_director=None, is_primary=True):
+        self._stream_size = (max(1, int(width)), max(1, int(height)))
+        self._gl: Optional[OffscreenGL] = None
+        super().__init__(director, text_director=text_director, is_primary=is_primary)
+
+        self.fps = max(1.0, float(fps))
+        self._director_dt = 1.0 / self.fps
+        self._vr_safe = False  # already rendering into an FBO
+        self.resize(*self._stream_size)
+        self.set_virtual_screen_size(*self._stream_size)
+
+        self._timeline = FixedTimeline(self.fps)
+        self._tick_timer = QTimer()
+        self._tick_timer.setTimerType(Qt.TimerType.PreciseTimer)
+        self._tick_timer.setSingleShot(True)
+        self._tick_timer.timeout.connect(self._on_tick)
+        self._running = False
+        # Called with the frame interval before each timed paint, e.g. to step a SessionRunner
+        # in lockstep with the stream clock.
+        self.tick_callback: Optional[Callable[[float], None]] = None
+        self.frames_rendered = 0
+        self._render_ms: deque[float] = deque(maxlen=120)
+
+        self.initializeGL()
+
+    # ---- surface -------------------------------------------------------
+    def _init_window(self) -> None:
+        try:
+            self._gl = OffscreenGL(*self._stream_size)
+            self._gl.make_current()
+        except Exception as e:
+            logger.error(f"[headless] Offscreen GL context unavailable: {e}")
+            self._gl = None
+
+    def initializeGL(self):
+        """Build GL resources in the offscreen context (no swap, no window timer)."""
+        if self._gl is None:
+            return
+        init_start = time.perf_counter()
+        try:
+            self._gl.make_current()
+            self._init_gl_resources()
+            self.initialized = True
+            self.available = True
+            self._gl_init_ms = (time.perf_counter() - init_start) * 1000.0
+            logger.info(
+                "[headless] Compositor ready: %dx%d @ %.1f fps (%s)",
+                self._stream_size[0],
+                self._stream_size[1],
+                self.fps,
+                GL.glGetString(GL.GL_RENDERER).decode(errors="replace"),
+            )
+        except Exception as e:
+            logger.error(f"[headless] initializeGL failed: {e}")
+            self.available = False
+
+    def _create_vertex_array(self):
+        return _VertexArray()
+
+    def _create_buffer(self, kind, data):
+        target = GL.GL_ELEMENT_ARRAY_BUFFER if kind == QOpenGLBuffer.Type.IndexBuffer else GL.GL_ARRAY_BUFFER
+        return _Buffer(target, data)
+
+    def context(self):
+        return self._gl.ctx if self._gl is not None else None
+
+    def makeCurrent(self):
+        if self._gl is not None:
+            self._gl.make_current()
+
+    def doneCurrent(self):
+        # Keep the offscreen context current between paints; nothing else renders here.
+        pass
+
+    def _restore_previous_context(self, previous_ctx, previous_surface) -> None:
+        if previous_ctx is not None and previous_surface is not None and previous_ctx is not self.context():
+            previous_ctx.makeCurrent(previous_surface)
+        else:
+            self.makeCurrent()
+
+    def devicePixelRatioF(self) -> float:
+        return 1.0
+
+    def screen(self):
+        # No display: resolution comes from the stream size.
+        return None
+
+    def isExposed(self) -> bool:
+        return self._gl is not None
+
+    def isVisible(self) -> bool:
+        return self._gl is not None
+
+    def winId(self):
+        # Callers only test for a native handle before uploading; QWindow.winId() would
+        # create a platform window, which is exactly what this class avoids.
+        return 1 if self._gl is not None else 0
+
+    def update(self):
+        # Repaints follow the stream clock, not invalidation.
+        pass
+
+    def requestUpdate(self):
+        pass
+
+    def _apply_win32_layered_styles(self):
+        pass
+
+    def _refresh_win32_styles(self):
+        pass
+
+    def _set_layered_alpha(self, alpha: int):
+        pass
+
+    def _force_topmost_windows(self):
+        pass
+
+    # ---- render clock --------------------------------------------------
+    def show(self):
+        self.start()
+
+    def showFullScreen(self):
+        self.start()
+
+    def hide(self):
+        self.stop()
+
+    def start(self) -> None:
+        if self._running or not self.available:
+            return
+        self._running = True
+        self._schedule()
+
+    def stop(self) -> None:
+        self._running = False
+        self._tick_timer.stop()
+
+    def _schedule(self) -> None:
+        now = time.perf_counter()
+        tick = self._timeline.next_tick(now)
+        self._tick_timer.start(max(0, int(round((tick - now) * 1000.0))))
+
+    def _on_tick(self) -> None:
+        if not self._running:
+            return
+        if self.tick_callback is not None:
+            try:
+                self.tick_callback(self._director_dt)
+            except Exception as e:
+                logger.error(f"[headless] Tick callback failed: {e}", exc_info=True)
+        self.render_frame()
+        self._schedule()
+
+    def render_frame(self) -> None:
+        """Paint one frame into the FBO and feed capture consumers."""
+        if self._gl is None or not self.initialized:
+            return
+        start = time.perf_counter()
+        self._gl.make_current()
+        # paintGL draws into whatever is bound and captures from the read binding.
+        GL.glBindFramebuffer(GL.GL_FRAMEBUFFER, self._gl.fbo)
+        self.paintGL()
+        self.frames_rendered += 1
+        self._render_ms.append((time.perf_counter() - start) * 1000.0)
+
+    def stats(self) -> dict:
+        samples = list(self._render_ms)
+        return {
+            "frames": self.frames_rendered,
+            "skipped": self._timeline.skipped,
+            "render_ms_avg": round(sum(samples) / len(samples), 3) if samples else 0.0,
+            "render_ms_max": round(max(samples), 3) if samples else 0.0,
+        }
+
+    # ---- capture -------------------------------------------------------
+    def set_vr_capture_enabled(self, enabled: bool, max_fps: int = 30, size: Optional[Tuple[int, int]] = None) -> None:
+        """Deliver every rendered frame to ``frame_ready`` at ``size`` (default: the render size).
+
+        ``max_fps`` is ignored: the render clock already runs at the stream rate.
+        """
+        self._vr_capture_enabled = bool(enabled)
+        if not enabled:
+            self._capture_bus.unregister("vr")
+            return
+        w, h = size if size else (0, 0)
+        self._capture_bus.register(
+            "vr",
+            self.frame_ready.emit,
+            width=int(w),
+            height=int(h),
+            fmt=CaptureFormat.RGB,
+            max_fps=240,
+            sync=True,
+        )
+
+    def cleanup(self):
+        self.stop()
+        if self._gl is None:
+            return
+        self._gl.make_current()
+        super().cleanup()
+        self._gl.delete()
+        self._gl = None
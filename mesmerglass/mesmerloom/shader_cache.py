@@ -0,0 +1,215 @@
+"""Program-binary cache for the desktop compositors.
+
+Linking the spiral program from source costs tens of milliseconds on some
+drivers, and every compositor window (primary, mirrors, recreated contexts)
+pays it again. ``link_program`` stores the driver's program binary under the
+user data dir, keyed by GL vendor/renderer/version and a hash of the sources,
+and reloads it with ``glProgramBinary`` next time.
+
+Everything is best-effort: no ARB_get_program_binary, a corrupt or stale file,
+or a driver that rejects the binary all fall back to compiling from source
+(and re-populating the cache).
+
+Env:
+- ``MESMERGLASS_SHADER_CACHE=0`` disables the cache.
+- ``MESMERGLASS_SHADER_CACHE_DIR`` overrides the location.
+"""
+
+from __future__ import annotations
+
+import hashlib
+import logging
+import os
+import struct
+import threading
+import time
+from pathlib import Path
+from typing import Callable, Optional, Sequence, Tuple
+
+import numpy as np
+from OpenGL import GL
+
+logger = logging.getLogger(__name__)
+
+# magic, header version, binary format, binary length
+_HEADER = struct.Struct("<4sIII")
+_MAGIC = b"MGPB"
+_HEADER_VERSION = 1
+
+_STATS_LOCK = threading.Lock()
+_STATS = {"hits": 0, "misses": 0, "rejected": 0, "link_ms": 0.0}
+
+
+def cache_enabled() -> bool:
+    return os.environ.get("MESMERGLASS_SHADER_CACHE", "1").strip().lower() not in ("0", "false", "off", "no")
+
+
+def cache_dir() -> Path:
+    override = os.environ.get("MESMERGLASS_SHADER_CACHE_DIR")
+    if override:
+        return Path(override)
+    from ..platform_paths import get_user_data_dir
+
+    return get_user_data_dir() / "shader_cache"
+
+
+def stats() -> dict:
+    """Process-wide counters: binaries loaded, programs compiled, binaries the driver refused."""
+    with _STATS_LOCK:
+        return dict(_STATS)
+
+
+def _bump(key: str, value: float = 1) -> None:
+    with _STATS_LOCK:
+        _STATS[key] += value
+
+
+def _gl_string(name: int) -> str:
+    try:
+        raw = GL.glGetString(name)
+    except Exception:
+        return ""
+    if isinstance(raw, bytes):
+        return raw.decode("utf-8", "replace")
+    return str(raw or "")
+
+
+def program_key(stages: Sequence[Tuple[int, str]]) -> str:
+    """Cache key for ``stages`` on the current context's driver."""
+    h = hashlib.sha256()
+    for name in (GL.GL_VENDOR, GL.GL_RENDERER, GL.GL_VERSION):
+        h.update(_gl_string(name).encode("utf-8"))
+        h.update(b"\0")
+    for shader_type, source in stages:
+        h.update(struct.pack("<I", int(shader_type)))
+        h.update(source.encode("utf-8"))
+        h.update(b"\0")
+    return h.hexdigest()[:32]
+
+
+def _binary_supported() -> bool:
+    try:
+        if not bool(GL.glProgramBinary) or not bool(GL.glGetProgramBinary):
+            return False
+        return int(GL.glGetIntegerv(GL.GL_NUM_PROGRAM_BINARY_FORMATS)) > 0
+    except Exception:
+        return False
+
+
+def _linked(prog: int) -> bool:
+    return bool(GL.glGetProgramiv(prog, GL.GL_LINK_STATUS))
+
+
+def _load_binary(path: Path) -> Optional[int]:
+    try:
+        blob = path.read_bytes()
+    except OSError:
+        return None
+    if len(blob) < _HEADER.size:
+        return None
+    magic, version, fmt, length = _HEADER.unpack_from(blob)
+    payload = blob[_HEADER.size:]
+    if magic != _MAGIC or version != _HEADER_VERSION or length != len(payload) or length == 0:
+        return None
+
+    prog = GL.glCreateProgram()
+    if not prog:
+        return None
+    try:
+        GL.glProgramBinary(prog, fmt, np.frombuffer(payload, dtype=np.uint8), length)
+        if _linked(prog):
+            return int(prog)
+    except GL.GLError as e:
+        # Some drivers raise GL_INVALID_ENUM for a format they no longer accept
+        # instead of just failing the link; treat it as a stale binary.
+        logger.debug(f"[shader.cache] glProgramBinary rejected {path.name}: {e}")
+    try:
+        GL.glDeleteProgram(prog)
+    except Exception:
+        pass
+    return None
+
+
+def _store_binary(prog: int, path: Path) -> None:
+    length = int(GL.glGetProgramiv(prog, GL.GL_PROGRAM_BINARY_LENGTH))
+    if length <= 0:
+        return
+    buf = np.zeros(length, dtype=np.uint8)
+    out_len = np.zeros(1, dtype=np.int32)
+    fmt = np.zeros(1, dtype=np.uint32)
+    GL.glGetProgramBinary(prog, length, out_len, fmt, buf)
+    written = int(out_len[0])
+    if written <= 0:
+        return
+    path.parent.mkdir(parents=True, exist_ok=True)
+    tmp = path.with_suffix(f".{os.getpid()}.tmp")
+    tmp.write_bytes(_HEADER.pack(_MAGIC, _HEADER_VERSION, int(fmt[0]), written) + buf[:written].tobytes())
+    os.replace(tmp, path)  # atomic: concurrent windows never read a torn file
+
+
+def link_program(
+    stages: Sequence[Tuple[int, str]],
+    *,
+    label: str,
+    compile_shader: Callable[[str, int], int],
+) -> int:
+    """Return a linked program for ``stages`` (``(shader_type, source)`` pairs).
+
+    Loads a cached binary when one matches this driver and these sources,
+    otherwise compiles with ``compile_shader(source, shader_type)``, links and
+    stores the result. Raises RuntimeError("<label> link failed: ...") like the
+    compositors' own builders did.
+    """
+    start = time.perf_counter()
+    path: Optional[Path] = None
+    use_cache = cache_enabled() and _binary_supported()
+    if use_cache:
+        try:
+            path = cache_dir() / f"{program_key(stages)}.bin"
+            prog = _load_binary(path) if path.exists() else None
+            if prog is not None:
+                elapsed = (time.perf_counter() - start) * 1000.0
+                _bump("hits")
+                _bump("link_ms", elapsed)
+                logger.info(f"[shader.cache] {label}: loaded program binary in {elapsed:.1f} ms")
+                return prog
+            if path.exists():
+                # Driver update or corrupt file: drop it and rebuild below.
+                _bump("rejected")
+                path.unlink(missing_ok=True)
+        except Exception as e:
+            logger.debug(f"[shader.cache] {label}: cache lookup failed: {e}")
+            if path is not None:
+                try:
+                    path.unlink(missing_ok=True)
+                except OSError:
+                    pass
+
+    shader_ids = [compile_shader(source, shader_type) for shader_type, source in stages]
+    prog = GL.glCreateProgram()
+    if not prog:
+        raise RuntimeError("glCreateProgram returned 0")
+    if use_cache:
+        try:
+            GL.glProgramParameteri(prog, GL.GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL.GL_TRUE)
+        except Exception:
+            pass
+    for sid in shader_ids:
+        GL.glAttachShader(prog, sid)
+    GL.glLinkProgram(prog)
+    if not _linked(prog):
+        log = GL.glGetProgramInfoLog(prog).decode("utf-8", "ignore")
+        raise RuntimeError(f"{label} link failed: {log}")
+    for sid in shader_ids:
+        GL.glDeleteShader(sid)
+
+    elapsed = (time.perf_counter() - start) * 1000.0
+    _bump("misses")
+    _bump("link_ms", elapsed)
+    if path is not None:
+        try:
+            _store_binary(int(prog), path)
+        except Exception as e:
+            logger.debug(f"[shader.cache] {label}: could not store program binary: {e}")
+    logger.info(f"[shader.cache] {label}: compiled from source in {elapsed:.1f} ms")
+    return int(prog)
@@ -155,6 +155,35 @@ class VisualDirector:
         compositors.extend(self._secondary_compositors)
         return compositors
 
+    # Background zoom animates up to 1.5x; decode with that much headroom so the
+    # zoomed-in end of the cycle is not visibly softer than the display.
+    _VIDEO_DECODE_ZOOM_HEADROOM = 1.5
+
+    def _update_video_decode_target(self) -> None:
+        """Tell the video decoders the largest surface a background is drawn to."""
+        width = height = 0
+        for comp in self._get_all_compositors():
+            try:
+                if hasattr(comp, "_physical_window_size"):
+                    w, h = comp._physical_window_size()
+                else:
+                    dpr = float(getattr(comp, "devicePixelRatioF", lambda: 1.0)())
+                    w, h = int(comp.width() * dpr), int(comp.height() * dpr)
+                vr_w, vr_h = getattr(comp, "_vr_size", (0, 0)) or (0, 0)
+                width = max(width, int(w), int(vr_w))
+                height = max(height, int(h), int(vr_h))
+            except Exception:
+                continue
+        if width <= 1 or height <= 1:
+            return  # Not laid out yet; keep the previous target.
+        try:
+            from ..content.video import set_decode_target_size
+
+            headroom = self._VIDEO_DECODE_ZOOM_HEADROOM
+            set_decode_target_size((int(width * headroom), int(height * headroom)))
+        except Exception:
+            pass
+
     def _record_perf_event(
         self,
         label: str,
@@ -610,6 +639,7 @@ class VisualDirector:
                                             height=frame.height,
                                             zoom=frame_zoom,
                                             new_video=is_first_frame,  # Trigger fade on first frame
+                                            frame_key=frame_key,  # compositors sharing a GL context group upload it once
                                         )
                                     except Exception as exc:
                                         self.logger.debug("[visual.video] Failed to upload frame to compositor: %s", exc)
@@ -923,6 +953,12 @@ class VisualDirector:
                     self.logger.debug(f"[visual] Loading NEW image from ThemeBank: {image_path_str}")
                 else:
                     self.logger.debug(f"[visual] Loading FIRST image from ThemeBank: {image_path_str}")
+                try:
+                    from mesmerglass.session import replay
+
+                    replay.note("media", "image", image_path_str)
+                except Exception:
+                    pass
                 
                 # ImageData has width, height, and data (numpy array) - ready for GPU upload
                 self.logger.debug(f"[visual] Image loaded: {image_data.width}x{image_data.height}")
@@ -939,7 +975,8 @@ class VisualDirector:
                 compositor_texture_map[self.compositor] = texture_id
                 compositor_zoom_map[self.compositor] = getattr(self.compositor, '_background_zoom', 1.0)
                 
-                # Upload to all SECONDARY compositors (each gets its own texture_id)
+                # Upload to all SECONDARY compositors (window compositors sharing a GL context
+                # group get the primary's texture_id back; the others upload their own)
                 for i, secondary in enumerate(self._secondary_compositors, start=1):
                     try:
                         secondary_texture_id = secondary.upload_image_to_gpu(image_data, generate_mipmaps=False)
@@ -1274,6 +1311,10 @@ class VisualDirector:
                 self._warned_missing_compositor = True
             return
         
+        # Decoders opened for this clip (and the warmups queued below) scale to
+        # the current surface size instead of decoding at source resolution.
+        self._update_video_decode_target()
+
         # Reset diagnostic counters for the upcoming video
         self._video_frame_miss_count = 0
         self._video_frame_miss_logged = False
@@ -1297,6 +1338,12 @@ class VisualDirector:
 
                 if not isinstance(path, Path):
                     path = Path(path)
+                try:
+                    from mesmerglass.session import replay
+
+                    replay.note("media", "video", str(path))
+                except Exception:
+                    pass
 
                 # If a video switch is already pending (decoder warmup), don't keep
                 # calling load_video() from here. Instead coalesce to the latest request
@@ -17,6 +17,9 @@ import numpy as np
 from mesmerglass.logging_utils import BurstSampler
 from mesmerglass.engine.perf import perf_metrics
 from mesmerglass.session import perf_blockers
+from mesmerglass.mesmerloom.capture_bus import CaptureBus, CaptureFormat, GLCaptureReadback
+from mesmerglass.mesmerloom import shader_cache
+from mesmerglass.mesmerloom import gpu_resources
 
 # Windows-specific imports for forcing window to top
 if sys.platform == "win32":
@@ -49,9 +52,17 @@ class LoomWindowCompositor(QOpenGLWindow):
     frame_drawn = pyqtSignal()
     # Emit captured RGB frames when VR streaming capture is enabled
     frame_ready = pyqtSignal(object)
+    # Emit downsampled RGB frames for the Home tab preview
+    preview_frame_ready = pyqtSignal(object)
 
     def __init__(self, director, text_director=None, is_primary=True, parent=None):
-        super().__init__(parent)
+        # All window compositors share one context group so each texture is uploaded once.
+        share = gpu_resources.share_context(self._surface_format)
+        if share is not None:
+            super().__init__(share, QOpenGLWindow.UpdateBehavior.NoPartialUpdate, parent)
+        else:
+            super().__init__(parent)
+        self._gpu_group = None  # share group key, set in initializeGL
         self.director = director
         self.text_director = text_director
         self.is_primary = bool(is_primary)
@@ -77,6 +88,11 @@ class LoomWindowCompositor(QOpenGLWindow):
         # Paint/present attribution (used by SessionRunner frame spike logs)
         self._paint_start_perf: float | None = None
         self._paint_end_perf: float | None = None
+
+        # Startup attribution: window creation -> first presented frame
+        self._created_perf = time.perf_counter()
+        self._gl_init_ms: float | None = None
+        self._first_frame_logged = False
         try:
             self._gl_paint_warn_ms = float(os.environ.get("MESMERGLASS_GL_PAINT_WARN_MS", "20"))
         except Exception:
@@ -182,9 +198,9 @@ class LoomWindowCompositor(QOpenGLWindow):
         self._preview_capture_enabled = False  # flipped on when Home preview is visible
         # Optional callback wiring for MesmerVisor streaming.
         self._vr_frame_callback = None
-        # Capture throttling (used by both GUI preview and VR streaming).
-        self._capture_interval_s = 1.0 / 15.0
-        self._capture_last_t = 0.0
+        # Capture consumers; each has its own size/format/rate (see capture_bus).
+        self._capture_bus = CaptureBus()
+        self._capture_readback: Optional[GLCaptureReadback] = None
 
         # Animation timer
         self.timer = QTimer()
@@ -195,36 +211,14 @@ class LoomWindowCompositor(QOpenGLWindow):
         self._first_transparent_swap_done = False
         # Start fully transparent; restore after first transparent swap
         self._window_opacity = 1.0
-        try:
-            super().setOpacity(0.0)
-        except Exception:
-            pass
-
-        # Set window properties for overlay behavior
-        try:
-            # WindowTransparentForInput may not exist on older Qt; guard it
-            flags = (Qt.WindowType.FramelessWindowHint |
-                     Qt.WindowType.WindowStaysOnTopHint |
-                     Qt.WindowType.Tool |
-                     Qt.WindowType.BypassWindowManagerHint)
-            if hasattr(Qt.WindowType, "WindowTransparentForInput"):
-                flags |= Qt.WindowType.WindowTransparentForInput  # default to click-through
-            self.setFlags(flags)
-        except Exception:
-            # Fallback to basic flags
-            try:
-                self.setFlags(Qt.WindowType.FramelessWindowHint |
-                              Qt.WindowType.WindowStaysOnTopHint |
-                              Qt.WindowType.Tool)
-            except Exception:
-                pass
+        # Spiral time step per painted frame (the window paints at ~60 Hz).
+        self._director_dt = 1.0 / 60.0
 
-        # Establish a transparent base color for the QWindow backbuffer (enables per-pixel alpha)
-        try:
-            self.setColor(QColor(0, 0, 0, 0))  # Transparent window background
-        except Exception:
-            pass
+        self._init_window()
+        logger.info(f"[spiral.trace] LoomWindowCompositor.__init__ called: director={director}")
 
+    @staticmethod
+    def _surface_format() -> QSurfaceFormat:
         # Configure surface format for transparency support
         format = QSurfaceFormat()
         format.setVersion(3, 3)
@@ -254,7 +248,41 @@ class LoomWindowCompositor(QOpenGLWindow):
             format.setSwapInterval(swap_interval)
         except Exception:
             pass
-        self.setFormat(format)
+        return format
+
+    def _init_window(self) -> None:
+        """Create the transparent, click-through overlay window and its GL surface format."""
+        try:
+            super().setOpacity(0.0)
+        except Exception:
+            pass
+
+        # Set window properties for overlay behavior
+        try:
+            # WindowTransparentForInput may not exist on older Qt; guard it
+            flags = (Qt.WindowType.FramelessWindowHint |
+                     Qt.WindowType.WindowStaysOnTopHint |
+                     Qt.WindowType.Tool |
+                     Qt.WindowType.BypassWindowManagerHint)
+            if hasattr(Qt.WindowType, "WindowTransparentForInput"):
+                flags |= Qt.WindowType.WindowTransparentForInput  # default to click-through
+            self.setFlags(flags)
+        except Exception:
+            # Fallback to basic flags
+            try:
+                self.setFlags(Qt.WindowType.FramelessWindowHint |
+                              Qt.WindowType.WindowStaysOnTopHint |
+                              Qt.WindowType.Tool)
+            except Exception:
+                pass
+
+        # Establish a transparent base color for the QWindow backbuffer (enables per-pixel alpha)
+        try:
+            self.setColor(QColor(0, 0, 0, 0))  # Transparent window background
+        except Exception:
+            pass
+
+        self.setFormat(self._surface_format())
 
         # Ensure the native window is created so we can apply styles BEFORE first show/paint
         try:
@@ -274,7 +302,6 @@ class LoomWindowCompositor(QOpenGLWindow):
         except Exception:
             pass
 
-        logger.info(f"[spiral.trace] LoomWindowCompositor.__init__ called: director={director}")
         # Apply layered/click-through styles ASAP after native handle exists
         try:
             QTimer.singleShot(0, self._apply_win32_layered_styles)
@@ -518,6 +545,7 @@ class LoomWindowCompositor(QOpenGLWindow):
     def initializeGL(self):
         """Initialize OpenGL resources"""
         logger.info("[spiral.trace] LoomWindowCompositor.initializeGL called")
+        init_start = time.perf_counter()
         # Re-assert layered styles after GL init (some drivers recreate surfaces)
         self._apply_win32_layered_styles()
         try:
@@ -536,44 +564,15 @@ class LoomWindowCompositor(QOpenGLWindow):
                 logger.warning(f"[spiral.trace] Window format swapInterval={self.format().swapInterval()}")
             except Exception:
                 pass
-            
-            # Build shader program
-            self._build_shader_program()
 
-            # GPU instrumentation setup (timers + best-effort VRAM)
-            self._init_gpu_instrumentation()
-            try:
-                # Populate VRAM metrics as soon as the GL context is valid.
-                # Otherwise they won't appear until the first paintGL.
-                self._gpu_vram_poll()
-            except Exception:
-                pass
-            
-            # Setup geometry
-            self._setup_geometry()
-            
-            # Configure OpenGL state for transparency
-            GL.glEnable(GL.GL_BLEND)         # Enable blending for transparency
-            # Use premultiplied alpha blending to match spiral.frag output
-            GL.glBlendFunc(GL.GL_ONE, GL.GL_ONE_MINUS_SRC_ALPHA)
-            GL.glDisable(GL.GL_DEPTH_TEST)   # No depth testing needed
-            GL.glDisable(GL.GL_DITHER)       # Disable dithering completely
-            GL.glDisable(GL.GL_MULTISAMPLE)  # Disable multisampling
-            
-            # Disable any legacy smoothing
-            try:
-                GL.glDisable(GL.GL_POLYGON_SMOOTH)
-                GL.glDisable(GL.GL_LINE_SMOOTH)
-                GL.glDisable(GL.GL_POINT_SMOOTH)
-                GL.glDisable(0x8C36)  # GL_SAMPLE_SHADING
-            except Exception:
-                pass
-            # Mark compositor as available after successful GL init
-            try:
-                self.available = True
-            except Exception:
-                pass
-            
+            group = gpu_resources.group_key(self.context())
+            if self._gpu_group is not None and self._gpu_group != group:
+                gpu_resources.manager().leave(self._gpu_group, id(self))  # context was recreated
+            self._gpu_group = group
+            gpu_resources.manager().join(group, id(self))
+
+            self._init_gl_resources()
+
             # One-time transparent clear/swap before any regular paint to avoid initial black
             try:
                 phys_w, phys_h = self._physical_window_size()
@@ -598,6 +597,7 @@ class LoomWindowCompositor(QOpenGLWindow):
             
             self.initialized = True
             self.available = True
+            self._gl_init_ms = (time.perf_counter() - init_start) * 1000.0
             
             logger.info("[spiral.trace] LoomWindowCompositor.initializeGL complete")
             print("MesmerLoom: QOpenGLWindow initialized - no FBO blit artifacts!")
@@ -605,7 +605,46 @@ class LoomWindowCompositor(QOpenGLWindow):
         except Exception as e:
             logger.error(f"[spiral.trace] LoomWindowCompositor.initializeGL failed: {e}")
             self.available = False
-    
+
+    def _init_gl_resources(self) -> None:
+        """Build programs, geometry and blend state in the current context (window or headless)."""
+        # Build shader program
+        self._build_shader_program()
+
+        # GPU instrumentation setup (timers + best-effort VRAM)
+        self._init_gpu_instrumentation()
+        try:
+            # Populate VRAM metrics as soon as the GL context is valid.
+            # Otherwise they won't appear until the first paintGL.
+            self._gpu_vram_poll()
+        except Exception:
+            pass
+        
+        # Setup geometry
+        self._setup_geometry()
+        
+        # Configure OpenGL state for transparency
+        GL.glEnable(GL.GL_BLEND)         # Enable blending for transparency
+        # Use premultiplied alpha blending to match spiral.frag output
+        GL.glBlendFunc(GL.GL_ONE, GL.GL_ONE_MINUS_SRC_ALPHA)
+        GL.glDisable(GL.GL_DEPTH_TEST)   # No depth testing needed
+        GL.glDisable(GL.GL_DITHER)       # Disable dithering completely
+        GL.glDisable(GL.GL_MULTISAMPLE)  # Disable multisampling
+        
+        # Disable any legacy smoothing
+        try:
+            GL.glDisable(GL.GL_POLYGON_SMOOTH)
+            GL.glDisable(GL.GL_LINE_SMOOTH)
+            GL.glDisable(GL.GL_POINT_SMOOTH)
+            GL.glDisable(0x8C36)  # GL_SAMPLE_SHADING
+        except Exception:
+            pass
+        # Mark compositor as available after successful GL init
+        try:
+            self.available = True
+        except Exception:
+            pass
+
     def _build_shader_program(self):
         """Build the spiral shader program using the same shader files as the original compositor"""
         logger.info("[spiral.trace] Building spiral shader program...")
@@ -620,24 +659,12 @@ class LoomWindowCompositor(QOpenGLWindow):
             logger.info(f"[spiral.debug] Vertex shader length: {len(vertex_shader)} chars")
             logger.info(f"[spiral.debug] Fragment shader length: {len(fragment_shader)} chars")
         
-        # Use raw OpenGL shader compilation (same as existing compositor)
-        vs_id = self._compile_shader(vertex_shader, GL.GL_VERTEX_SHADER)
-        fs_id = self._compile_shader(fragment_shader, GL.GL_FRAGMENT_SHADER)
-        
-        self.program_id = GL.glCreateProgram()
-        if not self.program_id:
-            raise RuntimeError("glCreateProgram returned 0")
-            
-        GL.glAttachShader(self.program_id, vs_id)
-        GL.glAttachShader(self.program_id, fs_id)
-        GL.glLinkProgram(self.program_id)
-        
-        if not GL.glGetProgramiv(self.program_id, GL.GL_LINK_STATUS):
-            log = GL.glGetProgramInfoLog(self.program_id).decode("utf-8", "ignore")
-            raise RuntimeError(f"Shader program link failed: {log}")
-            
-        GL.glDeleteShader(vs_id)
-        GL.glDeleteShader(fs_id)
+        # Raw OpenGL compile/link, served from the program-binary cache when possible
+        self.program_id = shader_cache.link_program(
+            [(GL.GL_VERTEX_SHADER, vertex_shader), (GL.GL_FRAGMENT_SHADER, fragment_shader)],
+            label="Shader program",
+            compile_shader=self._compile_shader,
+        )
             
         logger.info("[spiral.trace] Spiral shader program linked successfully")
     
@@ -677,21 +704,12 @@ class LoomWindowCompositor(QOpenGLWindow):
         indices = np.array([0, 1, 2, 2, 3, 0], dtype=np.uint32)
         
         # Create VAO
-        self.vao = QOpenGLVertexArrayObject()
-        self.vao.create()
+        self.vao = self._create_vertex_array()
         self.vao.bind()
         
-        # Create VBO
-        self.vbo = QOpenGLBuffer(QOpenGLBuffer.Type.VertexBuffer)
-        self.vbo.create()
-        self.vbo.bind()
-        self.vbo.allocate(vertices.tobytes(), vertices.nbytes)
-        
-        # Create EBO
-        self.ebo = QOpenGLBuffer(QOpenGLBuffer.Type.IndexBuffer)
-        self.ebo.create()
-        self.ebo.bind()
-        self.ebo.allocate(indices.tobytes(), indices.nbytes)
+        # Create VBO and EBO
+        self.vbo = self._create_buffer(QOpenGLBuffer.Type.VertexBuffer, vertices)
+        self.ebo = self._create_buffer(QOpenGLBuffer.Type.IndexBuffer, indices)
         
         # Setup vertex attributes
         import ctypes
@@ -704,6 +722,19 @@ class LoomWindowCompositor(QOpenGLWindow):
         self.vao.release()
         logger.info("[spiral.trace] Geometry setup complete")
 
+    def _create_vertex_array(self):
+        vao = QOpenGLVertexArrayObject()
+        vao.create()
+        return vao
+
+    def _create_buffer(self, kind, data: np.ndarray):
+        """Create, bind and fill a buffer object of ``kind`` (QOpenGLBuffer.Type)."""
+        buf = QOpenGLBuffer(kind)
+        buf.create()
+        buf.bind()
+        buf.allocate(data.tobytes(), data.nbytes)
+        return buf
+
     # --- VR safe FBO helpers ---
     def _ensure_vr_fbo(self, w: int, h: int) -> None:
         """Create or resize the offscreen FBO used to mirror frames to VR."""
@@ -1040,8 +1071,9 @@ class LoomWindowCompositor(QOpenGLWindow):
                 # Fallback to window size if screen detection fails
                 self.director.set_resolution(w_px, h_px)
             
-            # Use fixed dt=1/60 to match Visual Mode Creator's timing (ensures 1:1 parity)
-            self.director.update(dt=1/60.0)
+            # Fixed dt (1/60 on the window) to match Visual Mode Creator's timing (ensures 1:1 parity);
+            # the headless compositor advances one stream frame per paint instead.
+            self.director.update(dt=self._director_dt)
             uniforms = self.director.export_uniforms()
                 
         except Exception as e:
@@ -1196,28 +1228,22 @@ class LoomWindowCompositor(QOpenGLWindow):
         self._gpu_timer_end()
         self._gpu_vram_poll()
 
-        # Capture frame for VR streaming / GUI preview BEFORE swapping buffers (GL context is current here)
-        try:
-            if getattr(self, '_vr_capture_enabled', False) or getattr(self, '_preview_capture_enabled', False):
-                now = time.time()
-                interval = getattr(self, '_capture_interval_s', 0.0)
-                if interval > 0.0 and (now - getattr(self, '_capture_last_t', 0.0)) < interval:
-                    raise RuntimeError("capture throttled")
-                self._capture_last_t = now
-
-                # Read pixels from the current framebuffer.
-                # Do NOT crop here: VR uses a dedicated square compositor surface.
-                pixels = GL.glReadPixels(0, 0, w_px, h_px, GL.GL_RGB, GL.GL_UNSIGNED_BYTE)
-                frame = np.frombuffer(pixels, dtype=np.uint8).reshape(h_px, w_px, 3)
-                # Flip vertically (GL origin is bottom-left) and force contiguous memory.
-                # A non-contiguous view (negative strides) can render as black/garbage in QImage.
-                frame = np.flipud(frame).copy()
-                # Emit frame data to VR streaming handler
-                self.frame_ready.emit(frame)
+        # Feed capture consumers (VR streaming, Home preview, export) BEFORE swapping
+        # buffers while the GL context is current. The bus downsamples on the GPU
+        # per consumer and reads back through a PBO ring, so no per-frame CPU flip.
+        try:
+            readback = self._capture_readback
+            if self._capture_bus.has_consumers() or (readback is not None and readback.has_pending()):
+                plan = self._capture_bus.plan(int(w_px), int(h_px))
+                if plan or (readback is not None and readback.has_pending()):
+                    if self._capture_readback is None:
+                        self._capture_readback = GLCaptureReadback()
+                    src_fbo = int(GL.glGetIntegerv(GL.GL_READ_FRAMEBUFFER_BINDING))
+                    self._capture_readback.capture(self._capture_bus, plan, src_fbo, int(w_px), int(h_px))
         except Exception as e:
             if self.frame_count <= 3:
                 logger.error(f"[VR] Frame capture failed: {e}")
-            t_section["capture"] = time.perf_counter()
+        t_section["capture"] = time.perf_counter()
 
         # Notify listeners (duplicate/mirror windows) that a new frame is available
         try:
@@ -1286,12 +1312,33 @@ class LoomWindowCompositor(QOpenGLWindow):
         except Exception:
             pass
 
+    def _log_first_frame(self, now: float) -> None:
+        """Log time from window creation to the first presented frame."""
+        try:
+            cache = shader_cache.stats()
+            init_ms = self._gl_init_ms
+            logger.info(
+                "[startup] First frame presented %.1f ms after compositor creation "
+                "(initializeGL %s ms; shader cache so far: %d loaded, %d compiled, %.1f ms linking) is_primary=%s",
+                (now - self._created_perf) * 1000.0,
+                f"{init_ms:.1f}" if init_ms is not None else "?",
+                int(cache["hits"]),
+                int(cache["misses"]),
+                float(cache["link_ms"]),
+                bool(getattr(self, "is_primary", True)),
+            )
+        except Exception:
+            pass
+
     def _on_frame_swapped(self) -> None:
         """Called after Qt swaps/presents the backbuffer."""
         end = self._paint_end_perf
         if end is None:
             return
         now = time.perf_counter()
+        if not self._first_frame_logged:
+            self._first_frame_logged = True
+            self._log_first_frame(now)
         present_ms = (now - end) * 1000.0
         if present_ms < float(self._gl_present_warn_ms or 0.0):
             return
@@ -1350,24 +1397,73 @@ class LoomWindowCompositor(QOpenGLWindow):
         if self._trace:
             logger.info(f"[spiral.trace] LoomWindowCompositor.set_active: {active}")
 
-    def _set_capture_interval(self, max_fps: int) -> None:
-        try:
-            fps = int(max_fps)
-        except Exception:
-            fps = 15
-        fps = max(1, min(60, fps))
-        self._capture_interval_s = 1.0 / float(fps)
-        self._capture_last_t = 0.0
-
-    def set_preview_capture_enabled(self, enabled: bool, max_fps: int = 15) -> None:
-        """Enable capture for the Home tab preview (independent of VR streaming)."""
-        self._set_capture_interval(max_fps)
-        self._preview_capture_enabled = bool(enabled)
+    def register_capture_consumer(
+        self,
+        name: str,
+        callback,
+        *,
+        width: int = 0,
+        height: int = 0,
+        fmt: Union[CaptureFormat, str] = CaptureFormat.RGB,
+        max_fps: float = 30.0,
+        sync: bool = False,
+    ) -> None:
+        """Register a frame consumer with its own resolution, format and rate.
+
+        ``width``/``height`` of 0 mean the window's physical size. ``sync=True``
+        reads back in the same paint (frame-accurate, but stalls the GPU); the
+        default path delivers frames one or two paints late via a PBO ring.
+        """
+        self._capture_bus.register(
+            name, callback, width=width, height=height, fmt=fmt, max_fps=max_fps, sync=sync
+        )
+
+    def unregister_capture_consumer(self, name: str) -> None:
+        self._capture_bus.unregister(name)
+
+    def capture_rendered_at(self) -> Optional[float]:
+        """perf_counter paint time of the frame being delivered; valid inside a capture callback."""
+        return self._capture_bus.rendered_at
 
-    def set_vr_capture_enabled(self, enabled: bool, max_fps: int = 30) -> None:
-        """Enable capture for VR streaming (independent of Home preview)."""
-        self._set_capture_interval(max_fps)
+    def set_preview_capture_enabled(self, enabled: bool, max_fps: int = 15, size: Optional[Tuple[int, int]] = None) -> None:
+        """Enable capture for the Home tab preview (independent of VR streaming).
+
+        Frames are emitted on ``preview_frame_ready``, downsampled on the GPU to
+        fit ``size`` (default 480x270).
+        """
+        self._preview_capture_enabled = bool(enabled)
+        if not enabled:
+            self._capture_bus.unregister("preview")
+            return
+        w, h = size if size else (0, 0)
+        self._capture_bus.register(
+            "preview",
+            self.preview_frame_ready.emit,
+            width=int(w),
+            height=int(h),
+            fmt=CaptureFormat.PREVIEW,
+            max_fps=max(1, min(60, int(max_fps))),
+        )
+
+    def set_vr_capture_enabled(self, enabled: bool, max_fps: int = 30, size: Optional[Tuple[int, int]] = None) -> None:
+        """Enable capture for VR streaming (independent of Home preview).
+
+        Frames are emitted on ``frame_ready``. Passing the stream's target
+        ``size`` lets the GPU do the resize instead of the streaming server.
+        """
         self._vr_capture_enabled = bool(enabled)
+        if not enabled:
+            self._capture_bus.unregister("vr")
+            return
+        w, h = size if size else (0, 0)
+        self._capture_bus.register(
+            "vr",
+            self.frame_ready.emit,
+            width=int(w),
+            height=int(h),
+            fmt=CaptureFormat.RGB,
+            max_fps=max(1, min(60, int(max_fps))),
+        )
 
     # ---- MesmerVisor VR Streaming Methods (API parity with LoomCompositor) ----
     def enable_vr_streaming(self, frame_callback) -> None:
@@ -1474,50 +1570,66 @@ class LoomWindowCompositor(QOpenGLWindow):
             raise
 
         try:
-            # Generate new texture
-            texture_id = GL.glGenTextures(1)
-            
-            # Bind texture
-            GL.glBindTexture(GL.GL_TEXTURE_2D, texture_id)
-            
-            # Set texture parameters
-            GL.glTexParameteri(
-                GL.GL_TEXTURE_2D,
-                GL.GL_TEXTURE_MIN_FILTER,
-                GL.GL_LINEAR_MIPMAP_LINEAR if generate_mipmaps else GL.GL_LINEAR,
-            )
-            GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_MAG_FILTER, GL.GL_LINEAR)
-            
-            # Wrap mode: clamp to edge
-            GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_WRAP_S, GL.GL_CLAMP_TO_EDGE)
-            GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_WRAP_T, GL.GL_CLAMP_TO_EDGE)
-            
-            # Upload pixel data (RGBA8)
-            GL.glTexImage2D(
-                GL.GL_TEXTURE_2D,
-                0,
-                GL.GL_RGBA8,
-                image_data.width,
-                image_data.height,
-                0,
-                GL.GL_RGBA,
-                GL.GL_UNSIGNED_BYTE,
-                image_data.data,
-            )
-            
-            # Generate mipmaps if requested
-            if generate_mipmaps:
-                GL.glGenerateMipmap(GL.GL_TEXTURE_2D)
-            
-            # Unbind
-            GL.glBindTexture(GL.GL_TEXTURE_2D, 0)
-            
-            logger.info(
-                f"[visual] Uploaded texture {texture_id} in compositor context: {image_data.width}x{image_data.height}"
-            )
-            return texture_id
+            if self._gpu_group is not None:
+                # Every compositor is handed the same texture for the same image.
+                return gpu_resources.manager().acquire(
+                    self._gpu_group,
+                    id(self),
+                    ("image", id(image_data.data), bool(generate_mipmaps)),
+                    lambda: self._upload_image_texture(image_data, generate_mipmaps),
+                    source=image_data.data,
+                    kind="image",
+                    size=(image_data.width, image_data.height),
+                    nbytes=image_data.width * image_data.height * (6 if generate_mipmaps else 4),
+                )
+            return self._upload_image_texture(image_data, generate_mipmaps)
         finally:
             self._restore_previous_context(previous_ctx, previous_surface)
+
+    def _upload_image_texture(self, image_data, generate_mipmaps: bool) -> int:
+        """Create and fill an RGBA8 texture; the GL context must be current."""
+        # Generate new texture
+        texture_id = GL.glGenTextures(1)
+        
+        # Bind texture
+        GL.glBindTexture(GL.GL_TEXTURE_2D, texture_id)
+        
+        # Set texture parameters
+        GL.glTexParameteri(
+            GL.GL_TEXTURE_2D,
+            GL.GL_TEXTURE_MIN_FILTER,
+            GL.GL_LINEAR_MIPMAP_LINEAR if generate_mipmaps else GL.GL_LINEAR,
+        )
+        GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_MAG_FILTER, GL.GL_LINEAR)
+        
+        # Wrap mode: clamp to edge
+        GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_WRAP_S, GL.GL_CLAMP_TO_EDGE)
+        GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_WRAP_T, GL.GL_CLAMP_TO_EDGE)
+        
+        # Upload pixel data (RGBA8)
+        GL.glTexImage2D(
+            GL.GL_TEXTURE_2D,
+            0,
+            GL.GL_RGBA8,
+            image_data.width,
+            image_data.height,
+            0,
+            GL.GL_RGBA,
+            GL.GL_UNSIGNED_BYTE,
+            image_data.data,
+        )
+        
+        # Generate mipmaps if requested
+        if generate_mipmaps:
+            GL.glGenerateMipmap(GL.GL_TEXTURE_2D)
+        
+        # Unbind
+        GL.glBindTexture(GL.GL_TEXTURE_2D, 0)
+        
+        logger.info(
+            f"[visual] Uploaded texture {texture_id} in compositor context: {image_data.width}x{image_data.height}"
+        )
+        return texture_id
         
     def get_background_debug_state(self) -> Dict[str, Union[bool, int, float, tuple]]:
         """Return lightweight diagnostics for CLI/tests without needing GL access."""
@@ -1559,9 +1671,9 @@ class LoomWindowCompositor(QOpenGLWindow):
                     # If fade is enabled, DON'T delete yet - it will be deleted after fade completes
                     if not (self._fade_enabled and self._background_enabled):
                         try:
-                            if GL.glIsTexture(self._background_texture):
-                                GL.glDeleteTextures([self._background_texture])
-                                logger.debug(f"[visual] Deleted old texture {self._background_texture} (no fade)")
+                            old_texture, self._background_texture = self._background_texture, None
+                            self._recycle_video_texture(old_texture)
+                            logger.debug(f"[visual] Released old texture {old_texture} (no fade)")
                         except Exception as e:
                             logger.warning(f"[visual] Failed to delete old texture: {e}")
             finally:
@@ -1622,8 +1734,8 @@ class LoomWindowCompositor(QOpenGLWindow):
             logger.warning(f"[visual] Failed to make context current in clear_background_texture: {exc}")
         if ctx_acquired:
             try:
-                if self._background_texture is not None and GL.glIsTexture(self._background_texture):
-                    self._recycle_video_texture(self._background_texture)
+                old_texture, self._background_texture = self._background_texture, None
+                self._recycle_video_texture(old_texture)
             except Exception as exc:
                 logger.warning(f"[visual] Failed to delete background texture: {exc}")
             finally:
@@ -1660,10 +1772,11 @@ class LoomWindowCompositor(QOpenGLWindow):
 
             if ctx_acquired:
                 try:
-                    for item in list(self._fade_queue):
-                        self._recycle_video_texture(item.get('texture'))
+                    fading = [item.get('texture') for item in self._fade_queue] + [self._fade_old_texture]
                     self._fade_queue.clear()
-                    self._recycle_video_texture(self._fade_old_texture)
+                    self._fade_old_texture = None
+                    for texture_id in fading:
+                        self._recycle_video_texture(texture_id)
                 except Exception:
                     self._fade_queue.clear()
                 finally:
@@ -1856,16 +1969,29 @@ class LoomWindowCompositor(QOpenGLWindow):
                 pass
         self._owned_video_textures.clear()
         self._free_video_textures.clear()
+        if self._gpu_group is not None:
+            gpu_resources.manager().drop_idle(self._gpu_group, kind="video")
         self._video_pool_width = 0
         self._video_pool_height = 0
 
-    def _acquire_video_texture(self) -> int:
+    def _acquire_video_texture(self, width: int, height: int) -> int:
         """Acquire a texture id for video uploads (recycled if possible).
 
         Must be called with a current GL context.
         """
         from OpenGL import GL
 
+        if self._gpu_group is not None:
+            # Shared video textures are pooled by the group, not per compositor.
+            textures = gpu_resources.manager()
+            tex_id = textures.take_idle(self._gpu_group, id(self), "video", (width, height))
+            if tex_id is None:
+                tex_id = int(GL.glGenTextures(1))
+                textures.register(
+                    self._gpu_group, id(self), tex_id, kind="video", size=(width, height), nbytes=width * height * 3
+                )
+            return tex_id
+
         while self._free_video_textures:
             tex_id = int(self._free_video_textures.pop())
             try:
@@ -1878,8 +2004,18 @@ class LoomWindowCompositor(QOpenGLWindow):
         self._owned_video_textures.add(tex_id)
         return tex_id
 
+    def _texture_in_use(self, tex_id: int) -> bool:
+        """Whether the background or a fade layer still shows ``tex_id``."""
+        if tex_id == self._background_texture or tex_id == self._fade_old_texture:
+            return True
+        return any(item.get('texture') == tex_id for item in self._fade_queue)
+
     def _recycle_video_texture(self, texture_id: Optional[int]) -> None:
-        """Recycle a texture into the pool if it's compositor-owned."""
+        """Recycle a texture into the pool if it's compositor-owned.
+
+        Callers clear the slot that showed the texture first; a texture still
+        shown by another layer of this compositor is left alone.
+        """
         if texture_id is None:
             return
         try:
@@ -1887,7 +2023,10 @@ class LoomWindowCompositor(QOpenGLWindow):
         except Exception:
             return
 
-        if tex_id == self._background_texture:
+        if self._texture_in_use(tex_id):
+            return
+
+        if self._gpu_group is not None and gpu_resources.manager().release(self._gpu_group, id(self), tex_id):
             return
 
         from OpenGL import GL
@@ -1908,7 +2047,15 @@ class LoomWindowCompositor(QOpenGLWindow):
         except Exception:
             pass
     
-    def set_background_video_frame(self, frame_data, width: int, height: int, zoom: float = 1.0, new_video: bool = False) -> None:
+    def set_background_video_frame(
+        self,
+        frame_data,
+        width: int,
+        height: int,
+        zoom: float = 1.0,
+        new_video: bool = False,
+        frame_key: Optional[tuple] = None,
+    ) -> None:
         """Update background with video frame (efficient GPU upload).
         
         Args:
@@ -1917,6 +2064,8 @@ class LoomWindowCompositor(QOpenGLWindow):
             height: Frame height in pixels
             zoom: Zoom factor (1.0 = fit to screen, >1.0 = zoomed in)
             new_video: True if this is the first frame of a new video (triggers fade transition)
+            frame_key: Identity of the frame; a compositor sharing this one's GL context
+                group that already uploaded it hands over its texture instead
         """
         try:
             from OpenGL import GL
@@ -2077,18 +2226,38 @@ class LoomWindowCompositor(QOpenGLWindow):
                         return
 
                     active_tex = self._background_texture
-                    if needs_new_texture:
+                    shared = None
+                    if self._gpu_group is not None and frame_key is not None:
+                        shared = gpu_resources.manager().lookup(self._gpu_group, id(self), ("video", frame_key))
+                    if (
+                        shared is None
+                        and not needs_new_texture
+                        and self._gpu_group is not None
+                        and gpu_resources.manager().holders(self._gpu_group, active_tex) > 1
+                    ):
+                        # Another compositor still shows (or fades out) this texture;
+                        # writing the new frame into it would change its picture too.
+                        needs_new_texture = True
+                    if shared is not None:
+                        # Another compositor of the context group already uploaded this frame.
+                        if shared != self._background_texture and not old_texture_enqueued_for_fade:
+                            old_texture, self._background_texture = self._background_texture, None
+                            self._recycle_video_texture(old_texture)
+                        active_tex = shared
+                        upload_mode = "shared"
+                    elif needs_new_texture:
                         # If we're not fading the old texture out, recycle it.
                         if (
                             self._background_texture is not None
                             and GL.glIsTexture(self._background_texture)
                             and not old_texture_enqueued_for_fade
                         ):
-                            self._recycle_video_texture(self._background_texture)
+                            old_texture, self._background_texture = self._background_texture, None
+                            self._recycle_video_texture(old_texture)
 
                         # IMPORTANT: When fading, the old texture stays alive in the fade queue.
                         # Upload the new clip into a different texture so we don't overwrite it.
-                        active_tex = self._acquire_video_texture()
+                        active_tex = self._acquire_video_texture(width, height)
                         GL.glBindTexture(GL.GL_TEXTURE_2D, active_tex)
                         
                         # Set texture parameters
@@ -2174,6 +2343,10 @@ class LoomWindowCompositor(QOpenGLWindow):
 
                 # Commit active texture after upload.
                 self._background_texture = active_tex
+                if self._gpu_group is not None and shared is None:
+                    # The texture's contents changed; a stale key must not be found again.
+                    key = ("video", frame_key) if frame_key is not None else None
+                    gpu_resources.manager().rekey(self._gpu_group, active_tex, key)
 
                 upload_ms = (time.perf_counter() - upload_start) * 1000.0
                 if upload_ms >= _VIDEO_UPLOAD_WARN_MS:
@@ -2231,21 +2404,12 @@ void main() {
         # Fragment shader with zoom, aspect ratio, and kaleidoscope support
         fs_src = self._background_fs_source()
         
-        # Compile and link
-        vs = self._compile_shader(vs_src, GL.GL_VERTEX_SHADER)
-        fs = self._compile_shader(fs_src, GL.GL_FRAGMENT_SHADER)
-        
-        prog = GL.glCreateProgram()
-        GL.glAttachShader(prog, vs)
-        GL.glAttachShader(prog, fs)
-        GL.glLinkProgram(prog)
-        
-        if not GL.glGetProgramiv(prog, GL.GL_LINK_STATUS):
-            log = GL.glGetProgramInfoLog(prog).decode('utf-8', 'ignore')
-            raise RuntimeError(f"Background program link failed: {log}")
-        
-        GL.glDeleteShader(vs)
-        GL.glDeleteShader(fs)
+        # Compile and link (or load the cached program binary)
+        prog = shader_cache.link_program(
+            [(GL.GL_VERTEX_SHADER, vs_src), (GL.GL_FRAGMENT_SHADER, fs_src)],
+            label="Background program",
+            compile_shader=self._compile_shader,
+        )
         
         logger.info(f"[visual] Built background shader program: {prog}")
         return int(prog)
@@ -2443,12 +2607,12 @@ void main() {
             if self._fade_progress >= 1.0:
                 self._fade_active = False
                 # Recycle old texture after fade completes.
-                if self._fade_old_texture is not None:
+                old_texture, self._fade_old_texture = self._fade_old_texture, None
+                if old_texture is not None:
                     try:
-                        self._recycle_video_texture(self._fade_old_texture)
+                        self._recycle_video_texture(old_texture)
                     except Exception as e:
                         logger.warning(f"[visual] Failed to recycle old fade texture: {e}")
-                self._fade_old_texture = None
                 elapsed_seconds = frames_elapsed / 60.0
                 logger.info(f"[fade] Fade complete after {elapsed_seconds:.2f}s")
         
@@ -2664,6 +2828,20 @@ void main() {
                 self.program_id = None
         except Exception:
             pass
+        try:
+            if self._capture_readback is not None:
+                self._capture_readback.release()
+                self._capture_readback = None
+        except Exception:
+            pass
+        if self._gpu_group is not None:
+            # Shared textures outlive this context; release what it held.
+            try:
+                self.makeCurrent()
+            except Exception:
+                pass
+            gpu_resources.manager().leave(self._gpu_group, id(self))
+            self._gpu_group = None
             
         self.available = False
         logger.info("[spiral.trace] LoomWindowCompositor cleaned up")
@@ -2901,24 +3079,20 @@ void main() {
         try:
             height, width = texture_data.shape[:2]
 
-            tex_id = GL.glGenTextures(1)
-            GL.glBindTexture(GL.GL_TEXTURE_2D, tex_id)
-            GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_MIN_FILTER, GL.GL_LINEAR)
-            GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_MAG_FILTER, GL.GL_LINEAR)
-            GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_WRAP_S, GL.GL_CLAMP_TO_EDGE)
-            GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_WRAP_T, GL.GL_CLAMP_TO_EDGE)
-
-            GL.glTexImage2D(
-                GL.GL_TEXTURE_2D,
-                0,
-                GL.GL_RGBA,
-                width,
-                height,
-                0,
-                GL.GL_RGBA,
-                GL.GL_UNSIGNED_BYTE,
-                texture_data,
-            )
+            if self._gpu_group is not None:
+                # Subtext tiles and the other compositors reuse one texture per rendered text.
+                tex_id = gpu_resources.manager().acquire(
+                    self._gpu_group,
+                    id(self),
+                    ("text", id(texture_data)),
+                    lambda: self._upload_text_texture(texture_data, width, height),
+                    source=texture_data,
+                    kind="text",
+                    size=(width, height),
+                    nbytes=width * height * 4,
+                )
+            else:
+                tex_id = self._upload_text_texture(texture_data, width, height)
 
             text_info = (tex_id, width, height, x, y, alpha, scale)
             self._text_textures.append(text_info)
@@ -2940,6 +3114,28 @@ void main() {
         finally:
             self._restore_previous_context(previous_ctx, previous_surface)
 
+    def _upload_text_texture(self, texture_data, width: int, height: int) -> int:
+        """Create and fill an RGBA texture for a text overlay; the GL context must be current."""
+        tex_id = GL.glGenTextures(1)
+        GL.glBindTexture(GL.GL_TEXTURE_2D, tex_id)
+        GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_MIN_FILTER, GL.GL_LINEAR)
+        GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_MAG_FILTER, GL.GL_LINEAR)
+        GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_WRAP_S, GL.GL_CLAMP_TO_EDGE)
+        GL.glTexParameteri(GL.GL_TEXTURE_2D, GL.GL_TEXTURE_WRAP_T, GL.GL_CLAMP_TO_EDGE)
+
+        GL.glTexImage2D(
+            GL.GL_TEXTURE_2D,
+            0,
+            GL.GL_RGBA,
+            width,
+            height,
+            0,
+            GL.GL_RGBA,
+            GL.GL_UNSIGNED_BYTE,
+            texture_data,
+        )
+        return tex_id
+
     def set_virtual_screen_size(self, width: Optional[int], height: Optional[int]) -> None:
         """Override the logical screen size used for text scaling."""
         if width and height and width > 0 and height > 0:
@@ -2985,8 +3181,6 @@ void main() {
         Args:
             index: Text texture index (from add_text_texture)
         """
-        from OpenGL import GL
-        
         if index < 0 or index >= len(self._text_textures):
             return
         
@@ -2994,19 +3188,15 @@ void main() {
         previous_surface = previous_ctx.surface() if previous_ctx else None
         self.makeCurrent()
         try:
-            tex_id = self._text_textures[index][0]
-            if GL.glIsTexture(tex_id):
-                GL.glDeleteTextures([tex_id])
-
-            self._text_textures.pop(index)
+            tex_id = self._text_textures.pop(index)[0]
+            if not any(info[0] == tex_id for info in self._text_textures):
+                self._release_text_texture(tex_id)
             logger.debug(f"[Text] Removed texture {tex_id}")
         finally:
             self._restore_previous_context(previous_ctx, previous_surface)
     
     def clear_text_textures(self):
         """Remove all text textures."""
-        from OpenGL import GL
-        
         if not self.initialized:
             return
         
@@ -3014,15 +3204,21 @@ void main() {
         previous_surface = previous_ctx.surface() if previous_ctx else None
         self.makeCurrent()
         try:
-            for tex_id, _, _, _, _, _, _ in self._text_textures:
-                if GL.glIsTexture(tex_id):
-                    GL.glDeleteTextures([tex_id])
+            for tex_id in {info[0] for info in self._text_textures}:
+                self._release_text_texture(tex_id)
 
             self._text_textures.clear()
             logger.debug("[Text] Cleared all text textures")
         finally:
             self._restore_previous_context(previous_ctx, previous_surface)
 
+    def _release_text_texture(self, tex_id: int) -> None:
+        """Drop a text texture no overlay of this compositor shows any more."""
+        if self._gpu_group is not None and gpu_resources.manager().release(self._gpu_group, id(self), tex_id):
+            return
+        if GL.glIsTexture(tex_id):
+            GL.glDeleteTextures([tex_id])
+
     def _render_text_overlays(self, screen_width: int, screen_height: int):
         """Render all text overlays on top of everything.
         
@@ -3220,22 +3416,12 @@ void main() {
 }
 """
         
-        # Compile shaders
-        vs = self._compile_shader(vs_src, GL.GL_VERTEX_SHADER)
-        fs = self._compile_shader(fs_src, GL.GL_FRAGMENT_SHADER)
-        
-        # Link program
-        prog = GL.glCreateProgram()
-        GL.glAttachShader(prog, vs)
-        GL.glAttachShader(prog, fs)
-        GL.glLinkProgram(prog)
-        
-        if not GL.glGetProgramiv(prog, GL.GL_LINK_STATUS):
-            log = GL.glGetProgramInfoLog(prog).decode('utf-8', 'ignore')
-            raise RuntimeError(f"Text shader program link failed: {log}")
-        
-        GL.glDeleteShader(vs)
-        GL.glDeleteShader(fs)
+        # Compile and link (or load the cached program binary)
+        prog = shader_cache.link_program(
+            [(GL.GL_VERTEX_SHADER, vs_src), (GL.GL_FRAGMENT_SHADER, fs_src)],
+            label="Text shader program",
+            compile_shader=self._compile_shader,
+        )
         
         logger.info(f"[Text] Built text shader program: {prog}")
         return int(prog)
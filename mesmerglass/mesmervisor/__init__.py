@@ -8,6 +8,12 @@ Components:
 - streaming_server.py: TCP/UDP server with auto-discovery
 - frame_encoder.py: GPU-accelerated H.264 or CPU JPEG encoding
 - gpu_utils.py: GPU detection and capability checking
+- texture_codec.py: ETC2 block encoder for compressed-texture streaming (VRHT)
+- frame_dump.py: Background writer for forensic frame / .h264 dumps (drops, never blocks)
+- stream_recorder.py: Fragmented-MP4 recording of the encoded stream (no re-encode)
+- pipeline_bench.py: End-to-end loopback benchmark behind `vr-bench`
+- multicast.py: FEC-protected multicast transport for rooms of headsets (`--multicast`)
+- motion_rate.py: Motion-adaptive frame rate for calm content (`--adaptive-fps`)
 
 Protocol: VRHP (VR Hypnotic Protocol)
 - UDP Discovery: Port 5556
@@ -27,10 +33,13 @@ from .frame_encoder import (
     FrameEncoder,
     NVENCEncoder,
     JPEGEncoder,
+    ETC2Encoder,
     create_encoder,
     encode_stereo_frames
 )
 
+from .stream_recorder import StreamRecorder
+
 from .streaming_server import (
     VRStreamingServer,
     DiscoveryService
@@ -46,8 +55,10 @@ __all__ = [
     'FrameEncoder',
     'NVENCEncoder',
     'JPEGEncoder',
+    'ETC2Encoder',
     'create_encoder',
     'encode_stereo_frames',
+    'StreamRecorder',
     'VRStreamingServer',
     'DiscoveryService',
 ]
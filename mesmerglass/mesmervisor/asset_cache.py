@@ -0,0 +1,180 @@
+"""
+Headset asset cache - server side
+
+The headset keeps decoded images (and ETC2 texture payloads) in a native LRU
+cache keyed by a 64-bit content hash. Whenever the server would send bytes the
+headset has already seen, it sends a VRHC SHOW with the hash instead: zero
+bandwidth and zero decode.
+
+Exchange (all on the existing TCP connection):
+
+    server -> headset  VRHC OFFER                  once per connection; the cache is available
+    headset -> server  HAVE  u16 count, u64 ids    what survived from earlier connections
+    server -> headset  VRHC PUT  u64 id, u8 format  asset bytes in the right-eye slot
+    server -> headset  VRHC SHOW u64 left, u64 right
+    headset -> server  NEED  u64 id                 SHOW named an asset it has evicted
+
+Only content that recurs is worth caching, so an asset is PUT the second time
+it is seen; the first time it goes out as an ordinary frame packet. Clients
+that never answer OFFER keep receiving ordinary packets.
+"""
+
+import hashlib
+import struct
+from collections import OrderedDict
+from typing import Iterable, List, Optional, Tuple
+
+from .multicast import CLIENT_REPAIR
+
+# VRHC commands (server -> headset); CONTROL_HUD is 0x01.
+CONTROL_ASSET_OFFER = 0x02  # no args
+CONTROL_ASSET_PUT = 0x03  # args: u64 id, u8 format; asset bytes in the right-eye slot
+CONTROL_ASSET_SHOW = 0x04  # args: u64 left id, u64 right id
+
+# Headset -> server control bytes (0x01 is NEED_IDR).
+CLIENT_ASSET_HAVE = 0x02  # u16 count, then count x u64 id
+CLIENT_ASSET_NEED = 0x03  # u64 id
+
+ASSET_FORMAT_JPEG = 0
+ASSET_FORMAT_TEXTURE = 1  # VRHT payload (ETC2 blocks, optionally LZ4)
+
+
+def asset_id(data: bytes) -> int:
+    """64-bit content hash used as the cache key on both ends."""
+    return int.from_bytes(hashlib.blake2b(data, digest_size=8).digest(), "big")
+
+
+class AssetLedger:
+    """Per-connection view of what the headset holds, and the routing policy.
+
+    The headset's byte budget applies to decoded pixels, which the server
+    cannot see; the ledger is therefore optimistic and relies on NEED to learn
+    about evictions. Both sets are bounded so a long session of unique frames
+    costs a fixed amount of memory.
+    """
+
+    def __init__(self, fmt: int = ASSET_FORMAT_JPEG, max_seen: int = 512, max_held: int = 256):
+        self.format = fmt
+        self.enabled = False  # set once the headset answers OFFER
+        self._seen: "OrderedDict[int, None]" = OrderedDict()
+        self._held: "OrderedDict[int, None]" = OrderedDict()
+        self._max_seen = max(1, int(max_seen))
+        self._max_held = max(1, int(max_held))
+        self.shows = 0
+        self.puts = 0
+        self.misses_reported = 0
+        self.bytes_saved = 0
+
+    # ---- headset messages ------------------------------------------------
+
+    def have(self, ids: Iterable[int]) -> None:
+        self.enabled = True
+        for aid in ids:
+            self._remember(self._held, aid, self._max_held)
+
+    def need(self, aid: int) -> None:
+        self.misses_reported += 1
+        self._held.pop(aid, None)
+        # Still recurring content; PUT it the next time it comes round.
+        self._remember(self._seen, aid, self._max_seen)
+
+    # ---- routing -----------------------------------------------------------
+
+    def route(self, left: bytes, right: bytes) -> Optional[List[bytes]]:
+        """Control packets that replace this frame, or None to send it as usual.
+
+        ``right`` may be empty (mono); the headset then shows the left asset in
+        both eyes, as it does for ordinary mono packets.
+        """
+        if not self.enabled or not left:
+            return None
+        eyes: List[Tuple[int, bytes]] = [(asset_id(left), left)]
+        if right:
+            eyes.append((asset_id(right), right))
+
+        if not all(aid in self._held or aid in self._seen for aid, _ in eyes):
+            for aid, _ in eyes:
+                if aid not in self._held:
+                    self._remember(self._seen, aid, self._max_seen)
+            return None
+
+        packets: List[bytes] = []
+        for aid, data in eyes:
+            if aid in self._held:
+                self._held.move_to_end(aid)
+                self.bytes_saved += len(data)
+            else:
+                packets.append(build_put_packet(aid, self.format, data))
+                self._seen.pop(aid, None)
+                self._remember(self._held, aid, self._max_held)
+                self.puts += 1
+        left_id = eyes[0][0]
+        right_id = eyes[1][0] if len(eyes) > 1 else left_id
+        packets.append(build_show_packet(left_id, right_id))
+        self.shows += 1
+        return packets
+
+    @staticmethod
+    def _remember(table: "OrderedDict[int, None]", aid: int, limit: int) -> None:
+        table[aid] = None
+        table.move_to_end(aid)
+        while len(table) > limit:
+            table.popitem(last=False)
+
+
+def build_put_packet(aid: int, fmt: int, data: bytes) -> bytes:
+    from .streaming_server import build_control_packet
+
+    return build_control_packet(CONTROL_ASSET_PUT, struct.pack("!QB", aid, fmt), payload=data)
+
+
+def build_show_packet(left_id: int, right_id: int) -> bytes:
+    from .streaming_server import build_control_packet
+
+    return build_control_packet(CONTROL_ASSET_SHOW, struct.pack("!QQ", left_id, right_id))
+
+
+class ControlParser:
+    """Incremental parser for headset -> server control bytes.
+
+    Yields ("need_idr", None), ("have", [ids]), ("need", id) and, in multicast
+    mode, ("repair", (seq, block, count)). Unknown bytes are skipped one at a
+    time for forward compatibility.
+    """
+
+    def __init__(self):
+        self._buf = bytearray()
+
+    def feed(self, data: bytes) -> List[Tuple[str, object]]:
+        self._buf += data
+        out: List[Tuple[str, object]] = []
+        buf = self._buf
+        pos = 0
+        while pos < len(buf):
+            op = buf[pos]
+            if op == 0x01:
+                out.append(("need_idr", None))
+                pos += 1
+            elif op == CLIENT_ASSET_HAVE:
+                if len(buf) - pos < 3:
+                    break
+                (count,) = struct.unpack_from("!H", buf, pos + 1)
+                end = pos + 3 + 8 * count
+                if len(buf) < end:
+                    break
+                out.append(("have", list(struct.unpack_from(f"!{count}Q", buf, pos + 3))))
+                pos = end
+            elif op == CLIENT_ASSET_NEED:
+                if len(buf) - pos < 9:
+                    break
+                out.append(("need", struct.unpack_from("!Q", buf, pos + 1)[0]))
+                pos += 9
+            elif op == CLIENT_REPAIR:
+                if len(buf) - pos < 8:
+                    break
+                out.append(("repair", struct.unpack_from("!IHB", buf, pos + 1)))
+                pos += 8
+            else:
+                pos += 1
+        del buf[:pos]
+        return out
@@ -0,0 +1,336 @@
+"""
+Warm Encoder Pool
+
+Creating an encoder is slow: NVENC opens a hardware session and libx264 builds
+its lookahead and rate-control state, which together cost tens to hundreds of
+milliseconds. The streaming server used to pay that on every connect and every
+anomaly reset, while the headset looked at a black screen.
+
+EncoderPool keeps ``spares`` ready encoders per EncoderProfile (type, size, fps,
+quality, bitrate), built and ``warm_up()``-ed (codec opened) ahead of time.
+``checkout`` hands one out immediately, and a background worker builds the
+replacement. ``checkin`` calls ``FrameEncoder.reset()``:
+- Encoders that can return to their post-construction state (JPEG, ETC2) go
+  back to the pool.
+- Others (H.264, HEVC) are closed on the worker thread. A reused H.264 session would
+  carry reference pictures and timestamps into the next stream.
+
+Spares come from ``MESMERGLASS_ENCODER_POOL_SPARES`` (default 1). Each NVENC
+spare holds a hardware session, so 0 disables the pool and restores
+create-on-connect behaviour. For the same reason a profile nobody has checked
+out for ``MESMERGLASS_ENCODER_POOL_TTL`` seconds (default 120), for example
+after a resolution change, is forgotten and its spares closed. At most
+``max_profiles`` (default 4) profiles keep spares; the least recently used
+idle one goes first.
+"""
+
+import logging
+import os
+import threading
+import time
+from collections import deque
+from dataclasses import dataclass
+from typing import Callable, Deque, Dict, Optional, Set
+
+from .frame_encoder import FrameEncoder, create_encoder
+from .gpu_utils import EncoderType
+
+logger = logging.getLogger(__name__)
+
+
+def _default_ttl() -> float:
+    raw = (os.environ.get("MESMERGLASS_ENCODER_POOL_TTL") or "").strip()
+    if not raw:
+        return 120.0
+    try:
+        return max(0.0, float(raw))
+    except ValueError:
+        logger.warning("Invalid MESMERGLASS_ENCODER_POOL_TTL=%r (expected seconds)", raw)
+        return 120.0
+
+
+def _default_spares() -> int:
+    raw = (os.environ.get("MESMERGLASS_ENCODER_POOL_SPARES") or "").strip()
+    if not raw:
+        return 1
+    try:
+        return max(0, int(raw))
+    except ValueError:
+        logger.warning("Invalid MESMERGLASS_ENCODER_POOL_SPARES=%r (expected integer)", raw)
+        return 1
+
+
+@dataclass(frozen=True)
+class EncoderProfile:
+    """Everything that distinguishes one encoder configuration from another."""
+
+    encoder_type: EncoderType
+    width: int
+    height: int
+    fps: int = 30
+    quality: int = 25
+    bitrate: int = 50_000_000
+    scene_cuts: bool = False  # H.264/HEVC: IDRs follow session cuts (long GOP)
+    codec_name: Optional[str] = None  # H.264/HEVC: explicit libavcodec encoder
+
+    def create(self) -> FrameEncoder:
+        if self.encoder_type in (EncoderType.NVENC, EncoderType.HEVC):
+            return create_encoder(
+                self.encoder_type,
+                self.width,
+                self.height,
+                fps=self.fps,
+                bitrate=self.bitrate,
+                codec_name=self.codec_name,
+                scene_cuts=self.scene_cuts,
+            )
+        if self.encoder_type == EncoderType.ETC2:
+            return create_encoder(EncoderType.ETC2, self.width, self.height)
+        return create_encoder(EncoderType.JPEG, self.width, self.height, quality=self.quality)
+
+    def describe(self) -> str:
+        return f"{self.encoder_type.value} {self.width}x{self.height}@{self.fps}"
+
+
+class EncoderPool:
+    """Pre-initialised encoders per profile, refilled by a background thread."""
+
+    def __init__(
+        self,
+        spares: Optional[int] = None,
+        factory: Optional[Callable[[EncoderProfile], FrameEncoder]] = None,
+        ttl_s: Optional[float] = None,
+        max_profiles: int = 4,
+        clock: Callable[[], float] = time.monotonic,
+    ):
+        self.spares = _default_spares() if spares is None else max(0, int(spares))
+        self.ttl_s = _default_ttl() if ttl_s is None else max(0.0, float(ttl_s))
+        self.max_profiles = max(1, int(max_profiles))
+        self._clock = clock
+        self._factory = factory or (lambda profile: profile.create())
+        self._lock = threading.Lock()
+        self._work = threading.Condition(self._lock)
+        self._idle: Dict[EncoderProfile, Deque[FrameEncoder]] = {}
+        self._building: Dict[EncoderProfile, int] = {}
+        self._failed: Set[EncoderProfile] = set()
+        self._last_used: Dict[EncoderProfile, float] = {}
+        self._active: Dict[EncoderProfile, int] = {}  # checked out, not yet back
+        self._retired: Deque[FrameEncoder] = deque()
+        self._worker: Optional[threading.Thread] = None
+        self._stopping = False
+
+        self.hits = 0
+        self.misses = 0
+        self.warmed = 0
+        self.reused = 0
+        self.discarded = 0
+        self.evicted = 0
+        self._checkout_ms: Deque[float] = deque(maxlen=64)
+        self._create_ms: Deque[float] = deque(maxlen=64)
+
+    @property
+    def enabled(self) -> bool:
+        return self.spares > 0
+
+    def prewarm(self, profile: EncoderProfile) -> None:
+        """Start building spares for ``profile`` in the background."""
+        if not self.enabled:
+            return
+        with self._lock:
+            self._touch_locked(profile)
+            self._ensure_worker_locked()
+            self._work.notify()
+
+    def checkout(self, profile: EncoderProfile) -> FrameEncoder:
+        """A ready encoder for ``profile``; built synchronously when no spare is idle.
+
+        Raises whatever the encoder constructor raises on a miss.
+        """
+        start = time.perf_counter()
+        encoder: Optional[FrameEncoder] = None
+        if self.enabled:
+            with self._lock:
+                idle = self._touch_locked(profile)
+                if idle:
+                    encoder = idle.popleft()
+                    self.hits += 1
+                self._ensure_worker_locked()
+                self._work.notify()
+        if encoder is None:
+            encoder = self._build(profile)
+            with self._lock:
+                self.misses += 1
+        with self._lock:
+            self._active[profile] = self._active.get(profile, 0) + 1
+        self._checkout_ms.append((time.perf_counter() - start) * 1000.0)
+        return encoder
+
+    def checkin(self, profile: EncoderProfile, encoder: Optional[FrameEncoder]) -> None:
+        """Return an encoder after its stream ended; it is reset for reuse or closed."""
+        if encoder is None:
+            return
+        try:
+            reusable = bool(encoder.reset())
+        except Exception as e:
+            logger.warning("[encoder-pool] reset failed (%s); closing encoder", e)
+            reusable = False
+        with self._lock:
+            active = self._active.get(profile, 0) - 1
+            if active > 0:
+                self._active[profile] = active
+            else:
+                self._active.pop(profile, None)
+            if self.enabled and not self._stopping:
+                idle = self._touch_locked(profile)
+                if reusable and len(idle) < self.spares:
+                    idle.append(encoder)
+                    self.reused += 1
+                    return
+                if self._worker is not None:
+                    # Closing flushes the codec; keep that off the caller's thread.
+                    self._retired.append(encoder)
+                    self._work.notify()
+                    return
+        self._close(encoder)
+
+    def close(self) -> None:
+        """Close idle and retired encoders. The pool stays usable; spares are rebuilt on demand."""
+        with self._lock:
+            self._stopping = True
+            self._work.notify_all()
+            worker = self._worker
+        if worker is not None:
+            worker.join(timeout=5.0)
+        with self._lock:
+            leftovers = list(self._retired)
+            for idle in self._idle.values():
+                leftovers.extend(idle)
+            self._retired.clear()
+            self._idle.clear()
+            self._failed.clear()
+            self._last_used.clear()
+            self._worker = None
+            self._stopping = False
+        for encoder in leftovers:
+            self._close(encoder)
+
+    def stats(self) -> dict:
+        with self._lock:
+            idle = sum(len(v) for v in self._idle.values())
+            failed = sorted(p.describe() for p in self._failed)
+            counters = (self.hits, self.misses, self.warmed, self.reused, self.discarded, self.evicted)
+        checkout = list(self._checkout_ms)
+        create = list(self._create_ms)
+        return {
+            "spares": self.spares,
+            "idle": idle,
+            "hits": counters[0],
+            "misses": counters[1],
+            "warmed": counters[2],
+            "reused": counters[3],
+            "discarded": counters[4],
+            "evicted": counters[5],
+            "checkout_ms_avg": round(sum(checkout) / len(checkout), 3) if checkout else 0.0,
+            "checkout_ms_max": round(max(checkout), 3) if checkout else 0.0,
+            "create_ms_avg": round(sum(create) / len(create), 3) if create else 0.0,
+            "failed_profiles": failed,
+        }
+
+    # ---- internals -----------------------------------------------------
+    def _build(self, profile: EncoderProfile) -> FrameEncoder:
+        start = time.perf_counter()
+        encoder = self._factory(profile)
+        encoder.warm_up()
+        self._create_ms.append((time.perf_counter() - start) * 1000.0)
+        return encoder
+
+    def _close(self, encoder: FrameEncoder) -> None:
+        try:
+            encoder.close()
+        except Exception as e:
+            logger.debug("[encoder-pool] close failed: %s", e)
+        with self._lock:
+            self.discarded += 1
+
+    def _touch_locked(self, profile: EncoderProfile) -> Deque[FrameEncoder]:
+        """Marks ``profile`` as used now (evicting stale ones) and returns its idle spares."""
+        now = self._clock()
+        self._last_used[profile] = now
+        idle = self._idle.setdefault(profile, deque())
+        self._evict_locked(now)
+        return idle
+
+    def _evict_locked(self, now: float) -> None:
+        """Forget profiles unused for ``ttl_s`` or beyond ``max_profiles``; their spares are retired."""
+        unused = [p for p in self._idle if not self._active.get(p) and not self._building.get(p)]
+        stale = [p for p in unused if now - self._last_used.get(p, now) >= self.ttl_s]
+        unused = sorted((p for p in unused if p not in stale), key=lambda p: self._last_used.get(p, now))
+        excess = len(self._idle) - len(stale) - self.max_profiles
+        for profile in stale + unused[: max(0, excess)]:
+            spares = self._idle.pop(profile)
+            self._last_used.pop(profile, None)
+            self._failed.discard(profile)
+            if spares:
+                logger.info("[encoder-pool] evicting %d spare(s) of %s", len(spares), profile.describe())
+                self.evicted += len(spares)
+                self._retired.extend(spares)
+                self._work.notify()
+
+    def _next_expiry_locked(self) -> Optional[float]:
+        """Seconds until the oldest idle profile goes stale, or None when nothing can."""
+        times = [
+            t
+            for p, t in self._last_used.items()
+            if self._idle.get(p) and not self._active.get(p) and not self._building.get(p)
+        ]
+        if not times:
+            return None
+        return max(0.0, min(times) + self.ttl_s - self._clock())
+
+    def _ensure_worker_locked(self) -> None:
+        if self._worker is None or not self._worker.is_alive():
+            self._worker = threading.Thread(target=self._worker_loop, name="encoder-pool", daemon=True)
+            self._worker.start()
+
+    def _next_short_profile_locked(self) -> Optional[EncoderProfile]:
+        for profile, idle in self._idle.items():
+            if profile not in self._failed and len(idle) + self._building.get(profile, 0) < self.spares:
+                return profile
+        return None
+
+    def _worker_loop(self) -> None:
+        while True:
+            with self._lock:
+                while not self._stopping and not self._retired and self._next_short_profile_locked() is None:
+                    # Wake up when an idle profile expires so its spares are closed.
+                    self._work.wait(timeout=self._next_expiry_locked())
+                    self._evict_locked(self._clock())
+                if self._stopping:
+                    return
+                retired = self._retired.popleft() if self._retired else None
+                profile = None if retired is not None else self._next_short_profile_locked()
+                if profile is not None:
+                    self._building[profile] = self._building.get(profile, 0) + 1
+
+            if retired is not None:
+                self._close(retired)
+                continue
+
+            encoder = None
+            try:
+                encoder = self._build(profile)
+            except Exception as e:
+                logger.warning("[encoder-pool] cannot prewarm %s: %s", profile.describe(), e)
+            with self._lock:
+                self._building[profile] -= 1
+                if encoder is None:
+                    # Don't spin on a profile that cannot be built (e.g. no NVENC); checkout still
+                    # tries synchronously and reports the error to the connecting client's handler.
+                    self._failed.add(profile)
+                    continue
+                if not self._stopping and profile in self._idle:
+                    self._idle[profile].append(encoder)
+                    self.warmed += 1
+                    encoder = None
+            if encoder is not None:
+                self._close(encoder)
@@ -0,0 +1,214 @@
+"""
+Forensic Frame Dumps
+
+Background writer for the diagnostic dumps the streaming server can produce
+(raw pre-encode frames and the outgoing .h264 elementary stream). The producer
+and send loop only enqueue; checksums, compression and disk I/O happen on a
+writer thread. When the writer falls behind, new items are dropped and counted
+instead of blocking, so enabling dumps does not change stream timing.
+
+Raw frames are written as ``.vrraw`` files::
+
+    magic "VRRW"(4) width(4) height(4) channels(2) codec(2) crc32(4) body_size(4)
+    body: RGB/RGBA pixels, row-major; LZ4 block (codec 1) or zlib (codec 2)
+
+``crc32`` is zlib.crc32 of the uncompressed pixels (the value the PNG dumps
+used to carry in their file name). Use :func:`load_raw_frame` to read one back.
+"""
+
+import logging
+import os
+import queue
+import struct
+import threading
+import zlib
+from pathlib import Path
+from typing import Dict, Optional, Tuple, Union
+
+import numpy as np
+
+logger = logging.getLogger(__name__)
+
+RAW_MAGIC = b"VRRW"
+RAW_HEADER = struct.Struct("!4sIIHHII")
+
+RAW_CODEC_NONE = 0
+RAW_CODEC_LZ4 = 1
+RAW_CODEC_ZLIB = 2
+
+try:  # Optional: LZ4 is ~10x faster than zlib level 1 for raw frames.
+    import lz4.block as _lz4_block  # type: ignore
+except Exception:  # pragma: no cover - depends on environment
+    _lz4_block = None
+
+
+def _compress(body: bytes, fmt: str) -> Tuple[int, bytes]:
+    if fmt == "raw":
+        return RAW_CODEC_NONE, body
+    if _lz4_block is not None:
+        return RAW_CODEC_LZ4, _lz4_block.compress(body, store_size=False)
+    return RAW_CODEC_ZLIB, zlib.compress(body, 1)
+
+
+def load_raw_frame(path: Union[str, Path]) -> Tuple[np.ndarray, int]:
+    """Read a ``.vrraw`` dump; returns ``(frame, crc32)`` and verifies the checksum."""
+    data = Path(path).read_bytes()
+    magic, width, height, channels, codec, crc, body_size = RAW_HEADER.unpack_from(data, 0)
+    if magic != RAW_MAGIC:
+        raise ValueError(f"{path}: not a raw frame dump")
+    body = data[RAW_HEADER.size:]
+    if codec == RAW_CODEC_LZ4:
+        if _lz4_block is None:
+            raise RuntimeError("dump is LZ4-compressed but the lz4 package is not installed")
+        body = _lz4_block.decompress(body, uncompressed_size=body_size)
+    elif codec == RAW_CODEC_ZLIB:
+        body = zlib.decompress(body)
+    if len(body) != body_size or (zlib.crc32(body) & 0xFFFFFFFF) != crc:
+        raise ValueError(f"{path}: checksum mismatch")
+    shape = (height, width, channels) if channels else (height, width)
+    return np.frombuffer(body, dtype=np.uint8).reshape(shape), crc
+
+
+class FrameDumpWriter:
+    """Bounded, drop-on-full dump queue with its own writer thread.
+
+    ``submit_frame`` copies the frame (the caller's buffer may be reused) only
+    after a queue slot has been reserved, so a saturated writer costs the
+    producer nothing but a counter increment.
+    """
+
+    def __init__(self, max_pending: int = 32, raw_format: str = "lz4", name: str = "frame-dump"):
+        """
+        Args:
+            max_pending: Queued items before new ones are dropped
+            raw_format: "lz4" (LZ4, zlib if lz4 is missing), "raw" (uncompressed) or "png"
+            name: Writer thread name / log prefix
+        """
+        self.raw_format = raw_format if raw_format in ("lz4", "raw", "png") else "lz4"
+        self.name = name
+        self.frames_written = 0
+        self.chunks_written = 0
+        self.bytes_written = 0
+        self.dropped = 0
+        self.failures = 0
+
+        self._slots = threading.BoundedSemaphore(max(1, int(max_pending)))
+        self._queue: "queue.Queue[Optional[tuple]]" = queue.Queue()
+        self._streams: Dict[int, object] = {}  # handle -> file (writer thread only)
+        self._next_handle = 0
+        self._closed = False
+        self._writer = threading.Thread(target=self._writer_loop, name=name, daemon=True)
+        self._writer.start()
+
+    # ---- producer side ------------------------------------------------------
+    def _reserve(self) -> bool:
+        if self._closed or not self._slots.acquire(blocking=False):
+            self.dropped += 1
+            return False
+        return True
+
+    def submit_frame(self, path_stem: Union[str, Path], frame: np.ndarray) -> bool:
+        """Queue a raw frame dump to ``path_stem`` + extension. Returns False if dropped."""
+        if not self._reserve():
+            return False
+        self._queue.put(("frame", Path(path_stem), np.array(frame, dtype=np.uint8, copy=True)))
+        return True
+
+    def open_stream(self, path: Union[str, Path]) -> int:
+        """Open an append-only dump file (e.g. .h264); returns a handle for :meth:`append`."""
+        self._next_handle += 1
+        handle = self._next_handle
+        self._queue.put(("open", handle, Path(path)))
+        return handle
+
+    def append(self, handle: int, data: bytes) -> bool:
+        """Queue ``data`` for the stream. Returns False if dropped (the stream now has a gap)."""
+        if not data:
+            return True
+        if not self._reserve():
+            return False
+        self._queue.put(("append", handle, data))
+        return True
+
+    def close_stream(self, handle: int) -> None:
+        self._queue.put(("close", handle, None))
+
+    # ---- writer thread ------------------------------------------------------
+    def _writer_loop(self) -> None:
+        while True:
+            item = self._queue.get()
+            if item is None:
+                break
+            kind, key, payload = item
+            try:
+                if kind == "frame":
+                    self._write_frame(key, payload)
+                elif kind == "append":
+                    fp = self._streams.get(key)
+                    if fp is not None:
+                        fp.write(payload)
+                        self.chunks_written += 1
+                        self.bytes_written += len(payload)
+                elif kind == "open":
+                    payload.parent.mkdir(parents=True, exist_ok=True)
+                    self._streams[key] = open(payload, "wb")
+                elif kind == "close":
+                    fp = self._streams.pop(key, None)
+                    if fp is not None:
+                        fp.close()
+            except Exception as e:
+                self.failures += 1
+                if self.failures <= 3:
+                    logger.warning("[%s] %s failed: %s", self.name, kind, e)
+            finally:
+                if kind in ("frame", "append"):
+                    self._slots.release()
+
+    def _write_frame(self, path_stem: Path, frame: np.ndarray) -> None:
+        body = frame.tobytes()
+        crc = zlib.crc32(body) & 0xFFFFFFFF
+        if self.raw_format == "png":
+            import cv2
+
+            out_path = path_stem.with_name(f"{path_stem.name}_crc{crc:08x}.png")
+            # Frame is documented as RGB; OpenCV expects BGR.
+            bgr = frame[:, :, ::-1] if (frame.ndim == 3 and frame.shape[2] == 3) else frame
+            tmp_path = out_path.with_name(f".{out_path.stem}.tmp.png")
+            if not cv2.imwrite(str(tmp_path), bgr):
+                raise RuntimeError("cv2.imwrite returned False")
+            size = tmp_path.stat().st_size
+        else:
+            out_path = path_stem.with_name(f"{path_stem.name}_crc{crc:08x}.vrraw")
+            codec, packed = _compress(body, self.raw_format)
+            height, width = frame.shape[:2]
+            channels = frame.shape[2] if frame.ndim == 3 else 0
+            header = RAW_HEADER.pack(RAW_MAGIC, width, height, channels, codec, crc, len(body))
+            tmp_path = out_path.with_name(f".{out_path.name}.tmp")
+            with open(tmp_path, "wb") as fp:
+                fp.write(header)
+                fp.write(packed)
+            size = len(header) + len(packed)
+        # Atomic rename so watchers never see partial files.
+        os.replace(str(tmp_path), str(out_path))
+        self.frames_written += 1
+        self.bytes_written += size
+
+    # ---- shutdown -----------------------------------------------------------
+    def close(self, timeout: float = 5.0) -> None:
+        """Drain what is queued (up to ``timeout``) and close all streams."""
+        if self._closed:
+            return
+        self._closed = True
+        for handle in list(range(1, self._next_handle + 1)):
+            self._queue.put(("close", handle, None))
+        self._queue.put(None)
+        self._writer.join(timeout=timeout)
+        logger.info(
+            "[%s] closed: frames=%d chunks=%d bytes=%d dropped=%d failures=%d",
+            self.name,
+            self.frames_written,
+            self.chunks_written,
+            self.bytes_written,
+            self.dropped,
+            self.failures,
+        )
@@ -1,8 +1,8 @@
 """
 Frame Encoding for VR Streaming
 
-Supports both GPU-accelerated H.264 (NVENC) and CPU JPEG encoding.
-Automatically selects best available encoder.
+Supports GPU-accelerated H.264 (NVENC), HEVC (x265 / NVENC), CPU JPEG and
+ETC2 compressed textures (VRHT). Automatically selects best available encoder.
 """
 
 import logging
@@ -17,6 +17,27 @@ from .gpu_utils import EncoderType
 logger = logging.getLogger(__name__)
 
 
+def _gop_length(fps: int, scene_cuts: bool) -> int:
+    """Keyframe interval in frames for the H.264 / HEVC encoders."""
+    # Allow overriding GOP size (keyframe interval) for diagnostics / robustness.
+    # Smaller GOP => more frequent IDR => artifacts don't persist as long.
+    gop_env = (os.environ.get("MESMERGLASS_H264_GOP") or "").strip()
+    if gop_env:
+        try:
+            return max(1, min(int(gop_env), 300))
+        except ValueError:
+            return min(fps, 30)
+    if scene_cuts:
+        # Keyframes come from the session's cuts; the GOP is only a safety net for
+        # long steady stretches (clients can still ask for an IDR after loss).
+        try:
+            scene_gop_s = float(os.environ.get("MESMERGLASS_H264_SCENE_GOP_S") or 4.0)
+        except ValueError:
+            scene_gop_s = 4.0
+        return max(1, min(int(scene_gop_s * fps), 300))
+    return min(fps, 30)  # <=1s GOP; at 60fps this is a keyframe every 0.5s
+
+
 class FrameEncoder(ABC):
     """Base class for frame encoders"""
     
@@ -47,6 +68,19 @@ class FrameEncoder(ABC):
         """Request an IDR/keyframe on the next encode (best-effort)."""
         return
 
+    def warm_up(self) -> None:
+        """Do one-time setup now (e.g. open the codec session) instead of on the first encode."""
+        return
+
+    def reset(self) -> bool:
+        """
+        Return the encoder to its just-constructed state so another stream can use it
+
+        Returns:
+            False when the encoder cannot be reused and must be closed instead
+        """
+        return False
+
 
 class NVENCEncoder(FrameEncoder):
     """H.264 encoder (NVENC or software via libx264).
@@ -54,7 +88,15 @@ class NVENCEncoder(FrameEncoder):
     Historical name: NVENCEncoder. If codec_name != 'h264_nvenc', this acts as a software H.264 encoder.
     """
     
-    def __init__(self, width: int, height: int, fps: int = 30, bitrate: int = 120_000_000, codec_name: Optional[str] = None):
+    def __init__(
+        self,
+        width: int,
+        height: int,
+        fps: int = 30,
+        bitrate: int = 120_000_000,
+        codec_name: Optional[str] = None,
+        scene_cuts: bool = False,
+    ):
         """
         Initialize NVENC encoder
         
@@ -63,32 +105,10 @@ class NVENCEncoder(FrameEncoder):
             height: Frame height
             fps: Target frames per second
             bitrate: Target bitrate in bits/second (default 50 Mbps)
+            scene_cuts: The caller forces IDRs on scene cuts (session encoder hints), so
+                run long GOPs and give the rate control room for the cut frames
         """
-        self.width = width
-        self.height = height
-        self.fps = fps
-        self.bitrate = bitrate
-
-        # Thread-safe flag: streaming server may request an IDR from another thread.
-        self._force_idr_next = threading.Event()
-
-        # Diagnostic knobs for investigating intermittent mosaic/corruption:
-        # - Reformatting to yuv420p forces a copy into AVFrame-owned planes.
-        # - Keeping recent AVFrames alive can cover any internal encoder latency.
-        # Default to ON for NVENC: this favors robustness/smoothness over minimal latency.
-        refmt_env = (os.environ.get("MESMERGLASS_VRH2_REFORMAT_YUV420P") or "").strip().lower()
-        if refmt_env == "":
-            self._reformat_yuv420p = True
-        else:
-            self._reformat_yuv420p = refmt_env in {"1", "true", "on", "yes"}
-
-        keep_n_env = (os.environ.get("MESMERGLASS_VRH2_KEEP_AVFRAMES") or "").strip()
-        try:
-            # Default to a small buffer for NVENC unless explicitly overridden.
-            keep_n = int(keep_n_env) if keep_n_env else 4
-        except Exception:
-            keep_n = 4
-        self._keep_avframes = deque(maxlen=max(0, keep_n)) if keep_n > 0 else None
+        self._init_common(width, height, fps, bitrate, scene_cuts)
         
         try:
             import av
@@ -114,17 +134,10 @@ class NVENCEncoder(FrameEncoder):
             # NVENC options tuned for visual quality + robustness.
             # Mesmer visuals are extremely high-frequency; strict CBR tends to macroblock heavily.
             # Default to VBR HQ with a constant-quality target while still capping peak rate.
-            # Allow overriding GOP size (keyframe interval) for diagnostics / robustness.
-            # Smaller GOP => more frequent IDR => artifacts don't persist as long.
-            gop_env = (os.environ.get("MESMERGLASS_H264_GOP") or "").strip()
-            if gop_env:
-                try:
-                    gop = max(1, min(int(gop_env), 300))
-                except ValueError:
-                    gop = min(fps, 30)
-            else:
-                gop = min(fps, 30)  # <=1s GOP; at 60fps this is a keyframe every 0.5s
-            bufsize = max(int(bitrate * 2), bitrate)
+            gop = _gop_length(fps, self.scene_cuts)
+            # Scene-cut mode spends far fewer bits on periodic IDRs; let the VBV buffer lend
+            # the cut frame the savings instead of crushing it to the per-frame average.
+            bufsize = max(int(bitrate * (4 if self.scene_cuts else 2)), bitrate)
 
             # Env overrides for rapid tuning (no UX changes required).
             # Examples:
@@ -221,6 +234,34 @@ class NVENCEncoder(FrameEncoder):
         except Exception as e:
             raise RuntimeError(f"Failed to initialize NVENC encoder: {e}")
 
+    def _init_common(self, width: int, height: int, fps: int, bitrate: int, scene_cuts: bool) -> None:
+        self.width = width
+        self.height = height
+        self.fps = fps
+        self.bitrate = bitrate
+        self.scene_cuts = bool(scene_cuts)
+
+        # Thread-safe flag: streaming server may request an IDR from another thread.
+        self._force_idr_next = threading.Event()
+
+        # Diagnostic knobs for investigating intermittent mosaic/corruption:
+        # - Reformatting to yuv420p forces a copy into AVFrame-owned planes.
+        # - Keeping recent AVFrames alive can cover any internal encoder latency.
+        # Default to ON for NVENC: this favors robustness/smoothness over minimal latency.
+        refmt_env = (os.environ.get("MESMERGLASS_VRH2_REFORMAT_YUV420P") or "").strip().lower()
+        if refmt_env == "":
+            self._reformat_yuv420p = True
+        else:
+            self._reformat_yuv420p = refmt_env in {"1", "true", "on", "yes"}
+
+        keep_n_env = (os.environ.get("MESMERGLASS_VRH2_KEEP_AVFRAMES") or "").strip()
+        try:
+            # Default to a small buffer for NVENC unless explicitly overridden.
+            keep_n = int(keep_n_env) if keep_n_env else 4
+        except Exception:
+            keep_n = 4
+        self._keep_avframes = deque(maxlen=max(0, keep_n)) if keep_n > 0 else None
+
     def is_nvenc(self) -> bool:
         return getattr(self, "codec_name", "h264_nvenc") == "h264_nvenc"
     
@@ -282,6 +323,17 @@ class NVENCEncoder(FrameEncoder):
 
     def request_idr(self) -> None:
         self._force_idr_next.set()
+
+    def warm_up(self) -> None:
+        """Open the codec now; for NVENC this is where the hardware session is created."""
+        try:
+            self.container.start_encoding()
+        except Exception as e:
+            # Older PyAV may not expose this; the first encode opens the codec instead.
+            logger.debug("H.264 warm-up skipped: %s", e)
+
+    # reset() stays False: the codec context holds reference pictures, the GOP position and
+    # timestamps, so a reused session would start the next client mid-stream. Close it instead.
     
     def get_encoder_type(self) -> EncoderType:
         # Treat both NVENC and libx264 paths as "H.264" for the server.
@@ -306,6 +358,108 @@ class NVENCEncoder(FrameEncoder):
                 logger.warning(f"Error closing NVENC encoder: {e}")
 
 
+class HEVCEncoder(NVENCEncoder):
+    """HEVC encoder (libx265 zero-latency software, or hevc_nvenc).
+
+    Same frame path, IDR forcing and lifetime rules as the H.264 encoder; only
+    the codec setup differs. Output is Annex-B with VPS/SPS/PPS repeated on
+    every IDR so a headset can join at any keyframe.
+    """
+
+    def __init__(
+        self,
+        width: int,
+        height: int,
+        fps: int = 30,
+        bitrate: int = 120_000_000,
+        codec_name: Optional[str] = None,
+        scene_cuts: bool = False,
+    ):
+        self._init_common(width, height, fps, bitrate, scene_cuts)
+        try:
+            import av
+            self._av = av
+
+            if codec_name is None:
+                codec_name = (os.environ.get("MESMERGLASS_HEVC_CODEC") or "libx265").strip()
+            self.codec_name = codec_name
+
+            self.container = av.open('pipe:', 'w', format='hevc')
+            self.stream = self.container.add_stream(codec_name, rate=fps)
+            self.stream.width = width
+            self.stream.height = height
+            self.stream.pix_fmt = 'yuv420p'
+
+            gop = _gop_length(fps, self.scene_cuts)
+            bufsize = max(int(bitrate * (4 if self.scene_cuts else 2)), bitrate)
+
+            if codec_name == "hevc_nvenc":
+                self.stream.bit_rate = bitrate
+                rc_mode = (os.environ.get("MESMERGLASS_NVENC_RC") or "vbr_hq").strip()
+                opts = {
+                    'preset': (os.environ.get("MESMERGLASS_NVENC_PRESET") or "p7").strip(),
+                    'delay': '0',
+                    'bf': '0',
+                    'g': str(gop),
+                    'forced-idr': '1',
+                    'gpu': '0',
+                    'rc-lookahead': '0',
+                    'zerolatency': '1',
+                    'rc': rc_mode,
+                }
+                if rc_mode in {"vbr", "vbr_hq"}:
+                    opts['cq'] = (os.environ.get("MESMERGLASS_NVENC_CQ") or "16").strip()
+                    opts['maxrate'] = str(bitrate)
+                    opts['bufsize'] = str(bufsize)
+                elif rc_mode == "cbr":
+                    opts['maxrate'] = str(bitrate)
+                    opts['minrate'] = str(bitrate)
+                    opts['bufsize'] = str(bufsize)
+                self.stream.options = opts
+                quality = opts.get('cq', '')
+            else:
+                # x265 with tune=zerolatency: no B-frames, no lookahead, no frame threads,
+                # so every submitted frame comes straight back out (no reorder delay).
+                # Closed GOPs and forced IDRs keep the keyframe rules identical to H.264:
+                # a headset can start decoding at any IDR, and IDR requests are honoured.
+                quality = (os.environ.get("MESMERGLASS_X265_CRF") or "24").strip()
+                x265_params = (
+                    f"repeat-headers=1:aud=1:scenecut=0:open-gop=0:bframes=0"
+                    f":keyint={gop}:min-keyint={gop}:log-level=error"
+                )
+                extra = (os.environ.get("MESMERGLASS_X265_PARAMS") or "").strip()
+                if extra:
+                    x265_params += ":" + extra
+                self.stream.options = {
+                    'preset': (os.environ.get("MESMERGLASS_X265_PRESET") or "ultrafast").strip(),
+                    'tune': 'zerolatency',
+                    'crf': quality,
+                    'forced-idr': '1',
+                    'x265-params': x265_params,
+                }
+
+            logger.info(
+                "HEVC encoder initialized: codec=%s %sx%s @ %s FPS, target %.1f Mbps (gop=%s q=%s)",
+                codec_name,
+                width,
+                height,
+                fps,
+                bitrate / 1_000_000.0,
+                gop,
+                quality,
+            )
+        except ImportError:
+            raise RuntimeError("PyAV not installed. Install with: pip install av")
+        except Exception as e:
+            raise RuntimeError(f"Failed to initialize HEVC encoder: {e}")
+
+    def is_nvenc(self) -> bool:
+        return getattr(self, "codec_name", "") == "hevc_nvenc"
+
+    def get_encoder_type(self) -> EncoderType:
+        return EncoderType.HEVC
+
+
 class JPEGEncoder(FrameEncoder):
     """CPU JPEG encoder (fallback)"""
     
@@ -361,12 +515,75 @@ class JPEGEncoder(FrameEncoder):
     
     def get_encoder_type(self) -> EncoderType:
         return EncoderType.JPEG
+
+    def reset(self) -> bool:
+        """Stateless: every frame is a complete image"""
+        return True
     
     def close(self):
         """No cleanup needed for JPEG encoder"""
         logger.info("JPEG encoder closed")
 
 
+class ETC2Encoder(FrameEncoder):
+    """ETC2 compressed-texture encoder (VRHT payloads)"""
+    
+    def __init__(self, width: int, height: int, use_lz4: Optional[bool] = None):
+        """
+        Initialize ETC2 encoder
+        
+        Args:
+            width: Frame width (expected input size)
+            height: Frame height (expected input size)
+            use_lz4: LZ4-compress the block data (default: MESMERGLASS_VRHT_LZ4,
+                     on when the lz4 package is installed)
+        """
+        from . import texture_codec
+        
+        self._codec = texture_codec
+        self.width = width
+        self.height = height
+        if use_lz4 is None:
+            use_lz4 = os.environ.get("MESMERGLASS_VRHT_LZ4", "1").strip().lower() not in ("0", "false", "no", "off")
+        self.use_lz4 = bool(use_lz4) and texture_codec.lz4_available()
+        self._cache = texture_codec.TileCachedETC2()
+        
+        logger.info(f"ETC2 encoder initialized: {width}x{height}, lz4={self.use_lz4}")
+    
+    def encode(self, frame: np.ndarray) -> bytes:
+        """
+        Encode frame as a VRHT texture payload
+        
+        Args:
+            frame: RGB frame (height, width, 3) uint8
+        
+        Returns:
+            Texture header + ETC2 blocks
+        """
+        try:
+            height, width = frame.shape[:2]
+            blocks = self._cache.encode(frame)
+            return self._codec.pack_texture_payload(width, height, blocks, use_lz4=self.use_lz4)
+        except Exception as e:
+            logger.error(f"ETC2 encoding error: {e}")
+            return b''
+    
+    def get_encoder_type(self) -> EncoderType:
+        return EncoderType.ETC2
+
+    def reset(self) -> bool:
+        """Forget the tile cache so the next frame is encoded in full"""
+        self._cache.reset()
+        return True
+    
+    def close(self):
+        """Drop cached reference frames"""
+        self._cache.reset()
+        logger.info(
+            f"ETC2 encoder closed (tiles encoded={self._cache.tiles_encoded}, reused={self._cache.tiles_reused})"
+        )
+
+
 def create_encoder(
     encoder_type: EncoderType,
     width: int,
@@ -374,7 +591,8 @@ def create_encoder(
     fps: int = 30,
     quality: int = 85,
     bitrate: int = 120_000_000,
-    codec_name: Optional[str] = None
+    codec_name: Optional[str] = None,
+    scene_cuts: bool = False,
 ) -> FrameEncoder:
     """
     Factory function to create appropriate encoder
@@ -386,6 +604,7 @@ def create_encoder(
         fps: Target FPS (for H.264)
         quality: JPEG quality (for JPEG encoder)
         bitrate: Bitrate for H.264 (bits/second)
+        scene_cuts: H.264 / HEVC only: IDRs are forced on scene cuts, use long GOPs
     
     Returns:
         Configured encoder instance
@@ -394,11 +613,17 @@ def create_encoder(
         RuntimeError: If requested encoder cannot be created
     """
     if encoder_type == EncoderType.NVENC:
-        return NVENCEncoder(width, height, fps, bitrate, codec_name=codec_name)
+        return NVENCEncoder(width, height, fps, bitrate, codec_name=codec_name, scene_cuts=scene_cuts)
+    
+    elif encoder_type == EncoderType.HEVC:
+        return HEVCEncoder(width, height, fps, bitrate, codec_name=codec_name, scene_cuts=scene_cuts)
     
     elif encoder_type == EncoderType.JPEG:
         return JPEGEncoder(quality)
     
+    elif encoder_type == EncoderType.ETC2:
+        return ETC2Encoder(width, height)
+    
     else:
         raise ValueError(f"Unknown encoder type: {encoder_type}")
 
@@ -0,0 +1,155 @@
+"""
+Frame pacing for the streaming send loop
+
+``asyncio.sleep`` wakes on the event loop's timer, which adds several ms of
+scheduling jitter (more on Windows) that the headset sees directly as packet
+inter-arrival jitter and has to absorb in its jitter buffer. FramePacer keeps a
+fixed timeline (``t0 + k * period``) and splits each tick in two: the event
+loop wakes a small lead ahead of the tick to pick up the latest frame and build
+the packet, then hands the packet to the client's sender thread, which owns the
+deadline: ``time.sleep`` to just short of it (clock_nanosleep on Linux, a
+high-resolution waitable timer on Windows, Python 3.11+), a short spin, and the
+socket write itself. Loop wakeup jitter only eats into the lead; it never
+reaches the wire.
+
+The timeline is never re-anchored to "now": an overrun shorter than one period
+is absorbed by sending immediately, longer ones skip the missed ticks instead
+of sending a burst. Either way there is no drift.
+
+Env:
+- ``MESMERGLASS_VR_PACING=loop`` paces and sends on the event loop instead (same
+  timeline), for comparison.
+- ``MESMERGLASS_VR_PACING_SPIN_US`` spin before each deadline (default 300).
+- ``MESMERGLASS_VR_PACING_LEAD_US`` how early the loop prepares each packet
+  (default 4000).
+"""
+
+import asyncio
+import os
+import select
+import socket
+import time
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
+from typing import Optional, Tuple
+
+PACING_PRECISE = "precise"
+PACING_LOOP = "loop"
+
+_DEFAULT_SPIN_US = 300
+_DEFAULT_LEAD_US = 4000
+
+
+def _env_us(name: str, default: int) -> float:
+    try:
+        return max(0, int(os.environ.get(name, default))) / 1e6
+    except ValueError:
+        return default / 1e6
+
+
+def sleep_until(deadline: float, spin_s: float = _DEFAULT_SPIN_US / 1e6) -> None:
+    """Block until ``time.perf_counter() >= deadline``."""
+    remaining = deadline - time.perf_counter() - spin_s
+    if remaining > 0:
+        time.sleep(remaining)
+    while time.perf_counter() < deadline:
+        pass
+
+
+def sendall_blocking(sock: socket.socket, data: bytes) -> None:
+    """``sendall`` for a non-blocking socket from a plain thread (waits in select)."""
+    view = memoryview(data)
+    while view:
+        try:
+            sent = sock.send(view)
+        except (BlockingIOError, InterruptedError):
+            select.select([], [sock], [], 1.0)
+            continue
+        view = view[sent:]
+
+
+class FixedTimeline:
+    """The ``t0 + k * period`` schedule shared by FramePacer and the headless compositor.
+
+    ``next_tick(now)`` returns the next tick to wait for (possibly already due);
+    ticks missed by more than a period are skipped and counted, never bursted.
+    """
+
+    def __init__(self, fps: float):
+        self.period = 1.0 / max(1e-3, float(fps))
+        self._next: Optional[float] = None
+        self.skipped = 0
+
+    def next_tick(self, now: float) -> float:
+        if self._next is None:
+            self._next = now
+        elif now - self._next > self.period:
+            missed = int((now - self._next) / self.period)
+            self._next += missed * self.period
+            self.skipped += missed
+        tick = self._next
+        self._next += self.period
+        return tick
+
+
+class FramePacer:
+    """Fixed-rate tick source and paced sender for one client's send loop.
+
+    ``await wait()`` returns the next tick's scheduled time once it is time to
+    prepare that tick's packet; ``await send(sock, packet, tick)`` writes it at
+    the tick and records how late the write started.
+    """
+
+    def __init__(self, fps: float, mode: Optional[str] = None, window: int = 120):
+        self._timeline = FixedTimeline(fps)
+        self.period = self._timeline.period
+        if mode is None:
+            mode = (os.environ.get("MESMERGLASS_VR_PACING") or PACING_PRECISE).strip().lower()
+        self.mode = PACING_LOOP if mode == PACING_LOOP else PACING_PRECISE
+        self._spin_s = _env_us("MESMERGLASS_VR_PACING_SPIN_US", _DEFAULT_SPIN_US)
+        self._lead_s = min(_env_us("MESMERGLASS_VR_PACING_LEAD_US", _DEFAULT_LEAD_US), self.period / 2)
+        self._executor: Optional[ThreadPoolExecutor] = None
+        if self.mode == PACING_PRECISE:
+            self._executor = ThreadPoolExecutor(max_workers=1, thread_name_prefix="vr-pacer")
+        self._lateness = deque(maxlen=max(1, int(window)))  # seconds
+
+    @property
+    def skipped(self) -> int:
+        return self._timeline.skipped
+
+    async def wait(self) -> float:
+        now = time.perf_counter()
+        tick = self._timeline.next_tick(now)
+        # Precise mode only needs the packet ready by the tick; the sender thread hits it.
+        wake = tick - self._lead_s if self._executor is not None else tick
+        if wake > now:
+            await asyncio.sleep(wake - now)
+        return tick
+
+    async def send(self, sock: socket.socket, packet: bytes, tick: float) -> None:
+        """Write ``packet`` to ``sock`` at ``tick`` (immediately if already late)."""
+        if self._executor is not None:
+            await asyncio.get_running_loop().run_in_executor(self._executor, self._send_at, sock, packet, tick)
+            return
+        self.mark_sent(tick)
+        await asyncio.get_running_loop().sock_sendall(sock, packet)
+
+    def _send_at(self, sock: socket.socket, packet: bytes, tick: float) -> None:
+        sleep_until(tick, self._spin_s)
+        self.mark_sent(tick)
+        sendall_blocking(sock, packet)
+
+    def mark_sent(self, tick: float) -> None:
+        self._lateness.append(max(0.0, time.perf_counter() - tick))
+
+    def send_jitter_ms(self) -> Tuple[float, float]:
+        """(average, max) lateness of recent sends versus their ticks, in ms."""
+        if not self._lateness:
+            return 0.0, 0.0
+        samples = list(self._lateness)
+        return sum(samples) * 1000.0 / len(samples), max(samples) * 1000.0
+
+    def close(self) -> None:
+        if self._executor is not None:
+            self._executor.shutdown(wait=False)
+            self._executor = None
@@ -17,6 +17,8 @@ class EncoderType(Enum):
     """Available encoder types"""
     NVENC = "nvenc"      # NVIDIA hardware encoder
     JPEG = "jpeg"        # CPU JPEG fallback
+    ETC2 = "etc2"        # ETC2 compressed textures (VRHT), no client decode
+    HEVC = "hevc"        # H.265 (x265 or NVENC), negotiated per headset
     AUTO = "auto"        # Auto-detect best available
 
 
@@ -46,6 +48,26 @@ def has_nvenc_support() -> bool:
         return False
 
 
+def hevc_encoder_codec() -> Optional[str]:
+    """Return the HEVC encoder PyAV would use, or None if none is available.
+
+    ``MESMERGLASS_HEVC_CODEC`` names it explicitly; otherwise libx265 (software,
+    zero-latency tuned) is preferred over hevc_nvenc so NVENC sessions stay free.
+    """
+    try:
+        import av
+    except ImportError:
+        return None
+    forced = (os.environ.get("MESMERGLASS_HEVC_CODEC") or "").strip()
+    for name in ([forced] if forced else ["libx265", "hevc_nvenc"]):
+        try:
+            av.codec.Codec(name, 'w')
+            return name
+        except Exception:
+            continue
+    return None
+
+
 def get_gpu_info() -> Dict[str, Any]:
     """
     Get detailed GPU information
@@ -122,7 +144,7 @@ def select_encoder(requested: EncoderType = EncoderType.AUTO) -> EncoderType:
     Select optimal encoder based on hardware and user preference
     
     Args:
-        requested: User-requested encoder type (AUTO, NVENC, or JPEG)
+        requested: User-requested encoder type (AUTO, NVENC, JPEG, ETC2 or HEVC)
     
     Returns:
         Selected encoder type
@@ -154,6 +176,22 @@ def select_encoder(requested: EncoderType = EncoderType.AUTO) -> EncoderType:
         logger.info("Using CPU JPEG (user requested)")
         return EncoderType.JPEG
     
+    elif requested == EncoderType.ETC2:
+        # Never auto-selected: trades bandwidth for headset CPU
+        logger.info("Using ETC2 compressed textures (user requested)")
+        return EncoderType.ETC2
+    
+    elif requested == EncoderType.HEVC:
+        # Never auto-selected: only headsets that advertise an HEVC decoder get it
+        codec = hevc_encoder_codec()
+        if codec is None:
+            raise RuntimeError(
+                "HEVC requested but no HEVC encoder is available. "
+                "Install a PyAV build with libx265 (pip install av) or set MESMERGLASS_HEVC_CODEC=hevc_nvenc"
+            )
+        logger.info(f"Using HEVC via {codec} (user requested)")
+        return EncoderType.HEVC
+    
     else:
         raise ValueError(f"Unknown encoder type: {requested}")
 
@@ -183,7 +221,7 @@ def log_encoder_info():
         
         # List available encoders
         encoders = []
-        for name in ['h264_nvenc', 'libx264', 'mjpeg']:
+        for name in ['h264_nvenc', 'libx264', 'hevc_nvenc', 'libx265', 'mjpeg']:
             try:
                 codec = av.codec.Codec(name, 'w')
                 encoders.append(name)
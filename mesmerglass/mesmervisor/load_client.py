@@ -0,0 +1,167 @@
+"""
+Streaming Load Generator
+
+Opens many headset-like TCP connections against one or more streaming ports,
+reads and parses every packet the way the client does (size prefix, header,
+eye payloads), and reports per-connection frame rate, throughput and
+inter-arrival jitter. Backs ``python -m mesmerglass vr-load`` and
+``vr-host --load-clients``.
+
+Payloads are not decoded: the point is how many sessions the host sustains
+at the target frame rate, and decode cost lives on the headset. VRHC control
+packets (HUD, asset cache) are counted separately and not as frames.
+"""
+
+import asyncio
+import statistics
+import struct
+import time
+from dataclasses import asdict, dataclass, field
+from typing import Dict, List, Optional, Sequence, Tuple
+
+SUSTAINED_FRACTION = 0.95
+
+_FRAME_MAGICS = {b"VRHP", b"VRHT", b"VRH2", b"VRH3", b"VRH4"}
+
+
+@dataclass
+class LoadClientStats:
+    port: int
+    index: int
+    protocol: str = ""
+    frames: int = 0
+    control_packets: int = 0
+    bytes: int = 0
+    elapsed_s: float = 0.0
+    intervals_ms: List[float] = field(default_factory=list, repr=False)
+    error: Optional[str] = None
+
+    @property
+    def fps(self) -> float:
+        return self.frames / self.elapsed_s if self.elapsed_s > 0 else 0.0
+
+    @property
+    def mbps(self) -> float:
+        return self.bytes * 8 / 1e6 / self.elapsed_s if self.elapsed_s > 0 else 0.0
+
+    @property
+    def jitter_ms(self) -> float:
+        """Standard deviation of frame inter-arrival times."""
+        return statistics.pstdev(self.intervals_ms) if len(self.intervals_ms) > 1 else 0.0
+
+    @property
+    def max_gap_ms(self) -> float:
+        return max(self.intervals_ms, default=0.0)
+
+    def to_dict(self) -> dict:
+        d = asdict(self)
+        del d["intervals_ms"]
+        d.update(
+            fps=round(self.fps, 2),
+            mbps=round(self.mbps, 2),
+            jitter_ms=round(self.jitter_ms, 3),
+            max_gap_ms=round(self.max_gap_ms, 3),
+        )
+        return d
+
+
+async def _run_client(host: str, port: int, index: int, duration: float, warmup: float) -> LoadClientStats:
+    stats = LoadClientStats(port=port, index=index)
+    writer = None
+    try:
+        reader, writer = await asyncio.wait_for(asyncio.open_connection(host, port), timeout=5.0)
+        start = time.perf_counter()
+        measure_from = start + warmup
+        end = measure_from + duration
+        last_arrival: Optional[float] = None
+        while True:
+            remaining = end - time.perf_counter()
+            if remaining <= 0:
+                break
+            try:
+                (size,) = struct.unpack("!I", await asyncio.wait_for(reader.readexactly(4), timeout=remaining))
+                packet = await asyncio.wait_for(reader.readexactly(size), timeout=max(1.0, remaining))
+            except asyncio.TimeoutError:
+                break
+            now = time.perf_counter()
+            magic = bytes(packet[:4])
+            if magic not in _FRAME_MAGICS:
+                if now >= measure_from:
+                    stats.control_packets += 1
+                continue
+            stats.protocol = magic.decode("ascii")
+            if now < measure_from:
+                continue
+            stats.frames += 1
+            stats.bytes += 4 + size
+            if last_arrival is not None:
+                stats.intervals_ms.append((now - last_arrival) * 1000.0)
+            last_arrival = now
+        stats.elapsed_s = max(0.0, min(time.perf_counter(), end) - measure_from)
+    except (OSError, asyncio.IncompleteReadError, asyncio.TimeoutError) as e:
+        stats.error = f"{type(e).__name__}: {e}"
+    finally:
+        if writer is not None:
+            writer.close()
+            try:
+                await writer.wait_closed()
+            except OSError:
+                pass
+    return stats
+
+
+async def run_load(
+    targets: Sequence[Tuple[str, int]],
+    duration: float = 10.0,
+    clients_per_target: int = 1,
+    warmup: float = 1.0,
+) -> List[LoadClientStats]:
+    """Connect ``clients_per_target`` clients to every (host, port) and measure for ``duration`` seconds."""
+    tasks = [
+        _run_client(host, port, i, duration, warmup)
+        for host, port in targets
+        for i in range(max(1, int(clients_per_target)))
+    ]
+    return list(await asyncio.gather(*tasks))
+
+
+def capacity_summary(results: Sequence[LoadClientStats], target_fps: float) -> dict:
+    """Group by port; a session is sustained when every client got >= 95% of ``target_fps``."""
+    by_port: Dict[int, List[LoadClientStats]] = {}
+    for r in results:
+        by_port.setdefault(r.port, []).append(r)
+    threshold = SUSTAINED_FRACTION * float(target_fps)
+    sessions = []
+    for port, clients in sorted(by_port.items()):
+        sustained = all(c.error is None and c.fps >= threshold for c in clients)
+        sessions.append({
+            "port": port,
+            "clients": len(clients),
+            "min_fps": round(min(c.fps for c in clients), 2),
+            "mbps": round(sum(c.mbps for c in clients), 2),
+            "max_jitter_ms": round(max(c.jitter_ms for c in clients), 3),
+            "sustained": sustained,
+        })
+    return {
+        "target_fps": float(target_fps),
+        "sessions": len(sessions),
+        "sustained_sessions": sum(1 for s in sessions if s["sustained"]),
+        "total_mbps": round(sum(s["mbps"] for s in sessions), 2),
+        "per_session": sessions,
+        "clients": [r.to_dict() for r in results],
+    }
+
+
+def format_load_report(summary: dict) -> str:
+    lines = [f"{'port':>5} {'client':>6} {'proto':>5} {'fps':>7} {'Mbps':>7} {'jitter ms':>9} {'max gap':>8}  status"]
+    for c in summary["clients"]:
+        status = c["error"] or "ok"
+        lines.append(
+            f"{c['port']:>5} {c['index']:>6} {c['protocol'] or '-':>5} {c['fps']:>7.2f} {c['mbps']:>7.2f} "
+            f"{c['jitter_ms']:>9.2f} {c['max_gap_ms']:>8.1f}  {status}"
+        )
+    lines.append(
+        f"capacity: {summary['sustained_sessions']}/{summary['sessions']} sessions at >= "
+        f"{SUSTAINED_FRACTION:.0%} of {summary['target_fps']:g} fps, {summary['total_mbps']:.1f} Mbps total"
+    )
+    return "\n".join(lines)
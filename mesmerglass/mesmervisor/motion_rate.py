@@ -0,0 +1,148 @@
+"""
+Motion-adaptive frame rate for VR streams
+
+A slow spiral over a still image looks the same at 10 fps as at 30, but the
+producer used to capture, encode and send every tick of the FramePacer
+timeline. MotionRate lets the producer skip ticks while the content is calm.
+Each frame covers ``interval`` ticks, and the interval is recomputed from three
+signals before every tick:
+
+- the spiral's speed (``EncoderHints.motion``): enough frames per second to keep
+  each step of the rotation under ``MESMERGLASS_VR_ADAPTIVE_STEP_DEG``;
+- the media cycler's schedule: full rate from just before an expected image
+  change, and while an announced cut is due, so a change is not held back by
+  a long interval;
+- the measured difference between consecutive sent frames (mean absolute
+  change of a subsampled channel, per tick): full rate at
+  ``MESMERGLASS_VR_ADAPTIVE_DIFF`` levels per tick, proportionally less below.
+
+The interval shrinks as soon as any signal asks for more frames and grows by one
+tick at a time once it has been calm for ``decay_s``. Frame ids count ticks, not
+frames. With the header's ``fps_milli`` still the tick rate, the headset's
+frame-id based PTS is the real timeline, so a frame is presented for as long as
+it covers. The only side effect on older clients is that skipped ticks show up
+as frame-id gaps in the receive stats.
+
+Env:
+- ``MESMERGLASS_VR_ADAPTIVE_FPS=1`` enables it on servers not configured explicitly.
+- ``MESMERGLASS_VR_ADAPTIVE_MIN_FPS`` lowest rate (default 10).
+- ``MESMERGLASS_VR_ADAPTIVE_STEP_DEG`` largest spiral rotation per frame (default 3).
+- ``MESMERGLASS_VR_ADAPTIVE_DIFF`` frame difference per tick that needs full rate (default 2.0).
+"""
+
+import os
+import time
+from typing import Optional
+
+import numpy as np
+
+_DEFAULT_MIN_FPS = 10.0
+_DEFAULT_STEP_DEG = 3.0
+_DEFAULT_FULL_DIFF = 2.0
+_SAMPLE_STRIDE = 16  # pixels between difference samples in each direction
+
+
+def adaptive_enabled() -> bool:
+    return (os.environ.get("MESMERGLASS_VR_ADAPTIVE_FPS") or "").strip().lower() in {"1", "true", "on", "yes"}
+
+
+def _env_float(name: str, default: float) -> float:
+    try:
+        return float(os.environ.get(name, default))
+    except ValueError:
+        return default
+
+
+def _sample(frame: np.ndarray) -> np.ndarray:
+    plane = frame[::_SAMPLE_STRIDE, ::_SAMPLE_STRIDE]
+    if plane.ndim == 3:
+        plane = plane[:, :, min(1, plane.shape[2] - 1)]  # green carries most of the luma
+    return plane.astype(np.int16)
+
+
+class MotionRate:
+    """Chooses which ticks of a ``fps`` timeline carry a frame.
+
+    Call ``due(index)`` before capturing for tick ``index`` (ticks since the
+    stream started) and ``sent(index, frame)`` after the frame was encoded.
+    """
+
+    def __init__(
+        self,
+        fps: float,
+        hints=None,
+        min_fps: Optional[float] = None,
+        step_deg: Optional[float] = None,
+        full_diff: Optional[float] = None,
+        decay_s: float = 0.25,
+    ):
+        self.fps = max(1.0, float(fps))
+        self.period = 1.0 / self.fps
+        self.hints = hints  # session.encoder_hints.EncoderHints, optional
+        min_fps = _env_float("MESMERGLASS_VR_ADAPTIVE_MIN_FPS", _DEFAULT_MIN_FPS) if min_fps is None else min_fps
+        self.min_fps = max(1.0, min(self.fps, float(min_fps)))
+        self.max_interval = max(1, int(self.fps // self.min_fps))
+        step = _env_float("MESMERGLASS_VR_ADAPTIVE_STEP_DEG", _DEFAULT_STEP_DEG) if step_deg is None else step_deg
+        self.step_deg = max(0.1, float(step))
+        diff = _env_float("MESMERGLASS_VR_ADAPTIVE_DIFF", _DEFAULT_FULL_DIFF) if full_diff is None else full_diff
+        self.full_diff = max(1e-3, float(diff))
+        self.decay_s = max(0.0, float(decay_s))
+
+        self.interval = 1
+        self._changed_at: Optional[float] = None
+        self._last_index: Optional[int] = None
+        self._last_sample: Optional[np.ndarray] = None
+        self._diff_per_tick = self.full_diff  # unknown: start at full rate
+        self.frames = 0
+        self.ticks = 0
+
+    @property
+    def current_fps(self) -> float:
+        return self.fps / self.interval
+
+    def needed_fps(self, now: Optional[float] = None) -> float:
+        """Frame rate the content needs right now (between min_fps and fps)."""
+        t = time.perf_counter() if now is None else float(now)
+        needed = self.fps * min(1.0, self._diff_per_tick / self.full_diff)
+        hints = self.hints
+        if hints is not None:
+            if hints.cut_due_within(self.max_interval * self.period, now=t):
+                return self.fps
+            motion = hints.motion(now=t)
+            if motion is not None:
+                needed = max(needed, motion.spiral_rpm / 60.0 * 360.0 / self.step_deg)
+                lead = (self.max_interval + 1) * self.period
+                if motion.next_media_at is not None and motion.next_media_at - t <= lead:
+                    return self.fps
+        return max(self.min_fps, min(self.fps, needed))
+
+    def due(self, index: int, now: Optional[float] = None) -> bool:
+        """Whether tick ``index`` should carry a frame."""
+        if self._last_index is None:
+            return True
+        t = time.perf_counter() if now is None else float(now)
+        target = max(1, min(self.max_interval, int(self.fps // self.needed_fps(t))))
+        if target < self.interval:
+            self.interval = target
+            self._changed_at = t
+        elif target > self.interval and (self._changed_at is None or t - self._changed_at >= self.decay_s):
+            self.interval += 1
+            self._changed_at = t
+        return index - self._last_index >= self.interval
+
+    def sent(self, index: int, frame: Optional[np.ndarray] = None) -> None:
+        """Tick ``index`` carried ``frame``; measures how much it changed per tick."""
+        if frame is not None:
+            sample = _sample(frame)
+            if self._last_sample is not None and self._last_sample.shape == sample.shape and self._last_index is not None:
+                ticks = max(1, index - self._last_index)
+                self._diff_per_tick = float(np.abs(sample - self._last_sample).mean()) / ticks
+            self._last_sample = sample
+        if self._last_index is not None:
+            self.ticks += max(1, index - self._last_index)
+        self._last_index = index
+        self.frames += 1
+
+    def average_fps(self) -> float:
+        """Frames per second actually sent so far."""
+        return self.fps * self.frames / max(1, self.ticks + 1)
@@ -0,0 +1,590 @@
+"""
+Multicast stream transport
+
+Every TCP stream is a separate copy of each frame on the air, so a room of N
+headsets costs N times the Wi-Fi airtime of one. In multicast mode the server
+encodes once and sends each frame once to a UDP multicast group; headsets join
+the group and reassemble. The TCP connection each headset opens stays up as its
+control channel (JOIN, HUD, NEED_IDR, REPAIR) and carries no frames.
+
+A frame is the ordinary size-prefixed stream packet (VRH3, VRHP, ...), cut into
+shards of ``shard_size`` bytes (the last one zero-padded) and grouped into FEC
+blocks of at most ``block_shards`` data shards, spread evenly. Each block is
+followed by ``ceil(k * fec_ratio)`` parity shards of a systematic Reed-Solomon
+code over GF(2^8) (Cauchy matrix), so a headset that loses up to that many
+datagrams of a block recovers on its own. One datagram per shard:
+
+    magic 'VRHM' | u16 epoch | u8 flags | u8 k | u32 seq | u32 length
+    | u16 block | u16 blocks | u8 index | u8 m | u16 shard_size | shard
+
+``index < k`` is a data shard, anything above is parity shard ``index - k``.
+``epoch`` is picked per server start and announced in JOIN so datagrams from an
+earlier run are ignored; FLAG_KEYFRAME marks frames a decoder can start at
+(IDRs; every JPEG/ETC2 frame).
+
+Repair: a headset still missing shards once the frame has gone by sends
+REPAIR (u32 seq, u16 block, u8 count) on its TCP connection. The answer is
+``count`` parity shards that have not been sent yet, to the group, so one
+repair serves every headset that lost part of the same block; a request no
+larger than a repair sent moments ago is absorbed. Frames that cannot be
+completed in time are dropped, and the headset waits for a keyframe and asks
+for one with NEED_IDR as it would over TCP.
+"""
+
+import math
+import os
+import socket
+import struct
+import threading
+import time
+from collections import OrderedDict
+from typing import Dict, List, Optional, Tuple
+
+import numpy as np
+
+MULTICAST_MAGIC = b"VRHM"
+_HEADER = struct.Struct("!4sHBBIIHHBBH")
+HEADER_SIZE = _HEADER.size  # 24
+FLAG_KEYFRAME = 0x01
+
+# VRHC command (server -> headset); see streaming_server and asset_cache for 0x01-0x04.
+CONTROL_MULTICAST_JOIN = 0x05  # args: 4s group (IPv4), u16 port, u16 epoch
+# Headset -> server control byte (0x01 NEED_IDR, 0x02/0x03 asset cache).
+CLIENT_REPAIR = 0x04  # u32 seq, u16 block, u8 count
+
+DEFAULT_GROUP = "239.255.77.1"
+DEFAULT_PORT = 5557
+DEFAULT_SHARD_SIZE = 1400  # 1424-byte datagrams fit a 1500-byte MTU with IPv4 + UDP headers
+DEFAULT_BLOCK_SHARDS = 64
+DEFAULT_FEC_RATIO = 0.10
+MAX_BLOCK_SHARDS = 128  # data shards use Cauchy x in [0, 128), parity shards x in [128, 256)
+MAX_PARITY = 128
+
+
+def parse_group(spec: str, default_port: int = DEFAULT_PORT) -> Tuple[str, int]:
+    """``group[:port]`` (``1``/``on`` for the default group) -> (group, port)."""
+    spec = (spec or "").strip()
+    if spec.lower() in {"1", "true", "on", "yes"}:
+        return DEFAULT_GROUP, default_port
+    host, sep, port = spec.rpartition(":")
+    if not sep:
+        host, port = spec, ""
+    group = host or DEFAULT_GROUP
+    if (socket.inet_aton(group)[0] & 0xF0) != 0xE0:
+        raise ValueError(f"{group} is not an IPv4 multicast address")
+    return group, int(port) if port else default_port
+
+
+def repair_request(seq: int, block: int, count: int) -> bytes:
+    """Headset -> server REPAIR message."""
+    return struct.pack("!BIHB", CLIENT_REPAIR, seq & 0xFFFFFFFF, block & 0xFFFF, max(0, min(255, count)))
+
+
+def block_layout(length: int, shard_size: int, blocks: int) -> List[Tuple[int, int]]:
+    """(first shard, data shard count) per block; shards are spread evenly so no block is a runt."""
+    shards = max(1, -(-length // shard_size))
+    base, extra = divmod(shards, blocks)
+    out = []
+    first = 0
+    for b in range(blocks):
+        k = base + (1 if b < extra else 0)
+        out.append((first, k))
+        first += k
+    return out
+
+
+def parity_count(k: int, fec_ratio: float) -> int:
+    return max(1, min(MAX_PARITY, int(math.ceil(k * max(0.0, fec_ratio)))))
+
+
+# ---- GF(2^8) Reed-Solomon (polynomial 0x11d) ------------------------------------
+
+def _gf_tables():
+    exp = np.zeros(512, dtype=np.int32)
+    log = np.zeros(256, dtype=np.int32)
+    x = 1
+    for i in range(255):
+        exp[i] = x
+        log[x] = i
+        x <<= 1
+        if x & 0x100:
+            x ^= 0x11D
+    exp[255:510] = exp[:255]
+    a = np.arange(256)
+    mul = exp[log[a][:, None] + log[a][None, :]].astype(np.uint8)
+    mul[0, :] = 0
+    mul[:, 0] = 0
+    inv = np.zeros(256, dtype=np.uint8)
+    inv[1:] = exp[255 - log[1:]]
+    return mul, inv
+
+
+_GF_MUL, _GF_INV = _gf_tables()
+
+
+def _cauchy(parity: np.ndarray, k: int) -> np.ndarray:
+    """Coefficients (len(parity) x k) of the given parity shards over data shards 0..k-1."""
+    return _GF_INV[(128 + parity[:, None]) ^ np.arange(k)[None, :]]
+
+
+_LOW7 = np.uint64(0x7F7F7F7F7F7F7F7F)
+_LOW1 = np.uint64(0x0101010101010101)
+
+
+def _gf_combine(coef: np.ndarray, data: np.ndarray) -> np.ndarray:
+    """``coef`` (r x k) times ``data`` (k x size) over GF(2^8).
+
+    Multiplying by a constant is linear over GF(2), so each output row is the
+    XOR of the ``data * 2^b`` planes picked by the coefficient bits. The planes
+    are computed eight bytes at a time on uint64 words; parity for a 250 KB
+    frame takes a few milliseconds.
+    """
+    k, size = data.shape
+    padded = -(-size // 8) * 8
+    if padded != size or not data.flags.c_contiguous:
+        data = np.pad(data, ((0, 0), (0, padded - size)))
+    planes = np.empty((8, k, padded // 8), dtype=np.uint64)
+    planes[0] = data.view(np.uint64)
+    for b in range(1, 8):
+        w = planes[b - 1]
+        planes[b] = ((w & _LOW7) << np.uint64(1)) ^ (((w >> np.uint64(7)) & _LOW1) * np.uint64(0x1D))
+    planes = planes.reshape(8 * k, -1)
+    bits = ((coef[:, None, :] >> np.arange(8, dtype=np.uint8)[None, :, None]) & 1).astype(bool).reshape(len(coef), -1, 1)
+    out = np.empty((len(coef), padded // 8), dtype=np.uint64)
+    for r in range(len(coef)):
+        np.bitwise_xor.reduce(planes, axis=0, where=bits[r], initial=0, out=out[r])
+    return out.view(np.uint8)[:, :size]
+
+
+def encode_parity(data: np.ndarray, first: int, count: int) -> np.ndarray:
+    """Parity shards ``first .. first+count-1`` for ``data`` (k x shard_size uint8)."""
+    return _gf_combine(_cauchy(np.arange(first, first + count), data.shape[0]), data)
+
+
+def recover_block(k: int, shards: Dict[int, np.ndarray]) -> Optional[np.ndarray]:
+    """Data shards (k x shard_size) from any k of a block's shards, or None if too few arrived."""
+    if len(shards) < k:
+        return None
+    size = len(next(iter(shards.values())))
+    data = np.zeros((k, size), dtype=np.uint8)
+    missing = []
+    for i in range(k):
+        if i in shards:
+            data[i] = shards[i]
+        else:
+            missing.append(i)
+    if not missing:
+        return data
+    parity = sorted(idx - k for idx in shards if idx >= k)[: len(missing)]
+    coef = _cauchy(np.array(parity), k)
+    # Move the known data shards to the right-hand side: rhs = parity - C_known * known.
+    rhs = np.array([shards[k + p] for p in parity], dtype=np.uint8)
+    known = [i for i in range(k) if i not in missing]
+    if known:
+        rhs ^= _gf_combine(coef[:, known], data[known])
+    # Gauss-Jordan on the square Cauchy submatrix (always invertible).
+    a = coef[:, missing].copy()
+    n = len(missing)
+    for col in range(n):
+        pivot = next(r for r in range(col, n) if a[r, col])
+        if pivot != col:
+            a[[col, pivot]] = a[[pivot, col]]
+            rhs[[col, pivot]] = rhs[[pivot, col]]
+        scale = _GF_INV[a[col, col]]
+        a[col] = _GF_MUL[scale][a[col]]
+        rhs[col] = _GF_MUL[scale][rhs[col]]
+        for r in range(n):
+            f = a[r, col]
+            if r != col and f:
+                a[r] ^= _GF_MUL[f][a[col]]
+                rhs[r] ^= _GF_MUL[f][rhs[col]]
+    data[missing] = rhs
+    return data
+
+
+# ---- sender ----------------------------------------------------------------------
+
+class _SentFrame:
+    """One frame's data shards, kept for a short while to answer repairs."""
+
+    def __init__(self, seq: int, packet: bytes, keyframe: bool, shard_size: int, block_shards: int, fec_ratio: float):
+        self.seq = seq
+        self.length = len(packet)
+        self.flags = FLAG_KEYFRAME if keyframe else 0
+        shards = max(1, -(-self.length // shard_size))
+        self.layout = block_layout(self.length, shard_size, -(-shards // block_shards))
+        self.buf = np.zeros((shards, shard_size), dtype=np.uint8)
+        self.buf.reshape(-1)[: self.length] = np.frombuffer(packet, dtype=np.uint8)
+        self.parity = [parity_count(k, fec_ratio) for _first, k in self.layout]
+        self.next_parity = list(self.parity)
+        self.repaired_at = [0.0] * len(self.layout)
+        self.repaired_count = [0] * len(self.layout)
+
+    def header(self, epoch: int, block: int, index: int) -> bytes:
+        k = self.layout[block][1]
+        return _HEADER.pack(
+            MULTICAST_MAGIC, epoch, self.flags, k, self.seq, self.length,
+            block, len(self.layout), index, self.parity[block], self.buf.shape[1],
+        )
+
+    def datagrams(self, epoch: int) -> List[bytes]:
+        out = []
+        for block, (first, k) in enumerate(self.layout):
+            data = self.buf[first:first + k]
+            for i in range(k):
+                out.append(self.header(epoch, block, i) + data[i].tobytes())
+            for j, shard in enumerate(encode_parity(data, 0, self.parity[block])):
+                out.append(self.header(epoch, block, k + j) + shard.tobytes())
+        return out
+
+    def reserve_parity(self, block: int, count: int) -> Tuple[int, int]:
+        """Claims the next ``count`` unsent parity indices of ``block``; returns (start, count)."""
+        k = self.layout[block][1]
+        start = self.next_parity[block]
+        count = max(0, min(count, MAX_PARITY - start, 256 - k - start))  # index k + parity fits a byte
+        self.next_parity[block] = start + count
+        return start, count
+
+    def repair(self, epoch: int, block: int, start: int, count: int) -> List[bytes]:
+        first, k = self.layout[block]
+        shards = encode_parity(self.buf[first:first + k], start, count)
+        return [self.header(epoch, block, k + start + j) + shard.tobytes() for j, shard in enumerate(shards)]
+
+
+class MulticastSender:
+    """Sends whole stream packets to a multicast group as FEC-protected shards.
+
+    ``send_frame`` runs on the producer thread, ``repair`` on an executor thread
+    (never on the event loop). The lock only guards sequence numbers, history and
+    counters; parity encoding and ``sendto`` happen outside it, on a non-blocking
+    socket, so a full send buffer drops datagrams instead of stalling anyone.
+    """
+
+    def __init__(
+        self,
+        group: str = DEFAULT_GROUP,
+        port: int = DEFAULT_PORT,
+        interface: Optional[str] = None,
+        ttl: int = 1,
+        shard_size: int = DEFAULT_SHARD_SIZE,
+        block_shards: int = DEFAULT_BLOCK_SHARDS,
+        fec_ratio: Optional[float] = None,
+        history: int = 32,
+        epoch: Optional[int] = None,
+        repair_holdoff_s: float = 0.02,
+    ):
+        if fec_ratio is None:
+            fec_ratio = _env_fec_ratio()
+        self.group = group
+        self.port = int(port)
+        self.shard_size = max(64, min(int(shard_size), 65000))
+        self.block_shards = max(1, min(int(block_shards), MAX_BLOCK_SHARDS))
+        self.fec_ratio = max(0.0, float(fec_ratio))
+        self.epoch = (int.from_bytes(os.urandom(2), "big") if epoch is None else int(epoch)) & 0xFFFF
+        self.repair_holdoff_s = float(repair_holdoff_s)
+        self.next_seq = 0
+        self._history: "OrderedDict[int, _SentFrame]" = OrderedDict()
+        self._history_len = max(1, int(history))
+        self._lock = threading.Lock()
+        self.frames = 0
+        self.datagrams = 0
+        self.bytes_sent = 0
+        self.payload_bytes = 0
+        self.repair_requests = 0
+        self.repairs_sent = 0
+        self.repairs_absorbed = 0
+
+        self._sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+        self._sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, max(1, int(ttl)))
+        # Receivers on this machine (tests, a desktop viewer) see the group too.
+        self._sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_LOOP, 1)
+        if interface:
+            self._sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_IF, socket.inet_aton(interface))
+        try:
+            # A keyframe is a burst of several hundred datagrams.
+            self._sock.setsockopt(socket.SOL_SOCKET, socket.SO_SNDBUF, 4 * 1_048_576)
+        except OSError:
+            pass
+        self._sock.setblocking(False)
+
+    def join_args(self) -> bytes:
+        """Arguments of the VRHC JOIN command that points a headset at this group."""
+        return socket.inet_aton(self.group) + struct.pack("!HH", self.port, self.epoch)
+
+    def send_frame(self, packet: bytes, keyframe: bool) -> int:
+        """Shard, protect and send one stream packet; returns its sequence number."""
+        with self._lock:
+            seq = self.next_seq
+            self.next_seq = (self.next_seq + 1) & 0xFFFFFFFF
+        frame = _SentFrame(seq, packet, keyframe, self.shard_size, self.block_shards, self.fec_ratio)
+        datagrams = frame.datagrams(self.epoch)
+        with self._lock:
+            self._history[frame.seq] = frame
+            while len(self._history) > self._history_len:
+                self._history.popitem(last=False)
+            self.frames += 1
+            self.payload_bytes += frame.length
+        self._send(datagrams)
+        return frame.seq
+
+    def repair(self, seq: int, block: int, count: int) -> int:
+        """Answer a headset's REPAIR; returns the number of parity shards sent."""
+        with self._lock:
+            self.repair_requests += 1
+            frame = self._history.get(seq)
+            if frame is None or not 0 <= block < len(frame.layout) or count <= 0:
+                return 0
+            now = time.perf_counter()
+            if now - frame.repaired_at[block] < self.repair_holdoff_s and count <= frame.repaired_count[block]:
+                self.repairs_absorbed += 1
+                return 0
+            start, count = frame.reserve_parity(block, count)
+            frame.repaired_at[block] = now
+            frame.repaired_count[block] = count
+            self.repairs_sent += count
+        if count <= 0:
+            return 0
+        self._send(frame.repair(self.epoch, block, start, count))
+        return count
+
+    def _send(self, datagrams: List[bytes]) -> None:
+        target = (self.group, self.port)
+        sent = 0
+        sent_bytes = 0
+        for datagram in datagrams:
+            try:
+                self._sock.sendto(datagram, target)
+            except BlockingIOError:
+                continue  # send buffer full: FEC and repair cover it
+            sent += 1
+            sent_bytes += len(datagram)
+        with self._lock:
+            self.datagrams += sent
+            self.bytes_sent += sent_bytes
+
+    def stats(self) -> dict:
+        with self._lock:
+            return {
+                "group": f"{self.group}:{self.port}",
+                "frames": self.frames,
+                "datagrams": self.datagrams,
+                "bytes": self.bytes_sent,
+                "overhead": round(self.bytes_sent / self.payload_bytes - 1.0, 4) if self.payload_bytes else 0.0,
+                "repair_requests": self.repair_requests,
+                "repairs_sent": self.repairs_sent,
+                "repairs_absorbed": self.repairs_absorbed,
+            }
+
+    def close(self) -> None:
+        try:
+            self._sock.close()
+        except OSError:
+            pass
+
+
+def _env_fec_ratio() -> float:
+    raw = (os.environ.get("MESMERGLASS_VR_MULTICAST_FEC") or "").strip()
+    if not raw:
+        return DEFAULT_FEC_RATIO
+    try:
+        return max(0.0, float(raw)) / 100.0
+    except ValueError:
+        return DEFAULT_FEC_RATIO
+
+
+# ---- receiver --------------------------------------------------------------------
+
+class _PendingFrame:
+    def __init__(self, header: tuple, now: float):
+        _magic, _epoch, self.flags, _k, self.seq, self.length, _block, blocks, _index, _m, self.shard_size = header
+        self.layout = block_layout(self.length, self.shard_size, blocks)
+        self.shards: List[Dict[int, np.ndarray]] = [{} for _ in self.layout]
+        self.data: List[Optional[np.ndarray]] = [None] * blocks
+        self.recovered = False
+        self.first_seen = now
+        self.last_seen = now
+        self.requested_at = 0.0
+        self.requests = 0
+
+    @property
+    def complete(self) -> bool:
+        return all(d is not None for d in self.data)
+
+    def packet(self) -> bytes:
+        return np.concatenate(self.data).reshape(-1)[: self.length].tobytes()
+
+
+class Reassembler:
+    """Headset side of the multicast transport, in Python for tests and tools.
+
+    Mirrors the native MulticastReassembler (multicast_rx.cpp): packets come out
+    in sequence order; a missing frame holds later ones back for ``hold_s``
+    after the first newer frame arrived, then is dropped (a burst of losses
+    together), after which only a keyframe restarts delivery. A frame of which
+    no shard arrived cannot be repaired, so it asks for a keyframe at once.
+    Datagrams more than ``max_pending * 4`` frames from the next expected one
+    are strays and dropped, unless nothing in the window arrived for ``hold_s``
+    (the server moved on during an outage); then the receiver resyncs to them.
+    """
+
+    def __init__(
+        self,
+        epoch: Optional[int] = None,
+        hold_s: float = 0.05,
+        repair_after_s: float = 0.005,
+        repair_retry_s: float = 0.03,
+        max_repairs: int = 3,
+        max_pending: int = 16,
+    ):
+        self.epoch = epoch
+        self.hold_s = hold_s
+        self.repair_after_s = repair_after_s
+        self.repair_retry_s = repair_retry_s
+        self.max_repairs = max_repairs
+        self.max_pending = max_pending
+        self._pending: Dict[int, _PendingFrame] = {}
+        self._next: Optional[int] = None
+        self._newest: Optional[int] = None
+        self._awaiting_key = True
+        self._keyframe_request = False
+        self._key_requested_through: Optional[int] = None  # a NEED_IDR covers losses up to here
+        self._last_accepted = 0.0  # last datagram inside the window
+        self.delivered = 0
+        self.recovered = 0
+        self.repaired = 0
+        self.lost = 0
+        self.requests = 0
+
+    def push(self, datagram: bytes, now: float) -> List[bytes]:
+        """Take one datagram; returns the packets it completes, in order."""
+        if len(datagram) < HEADER_SIZE:
+            return []
+        header = _HEADER.unpack_from(datagram)
+        magic, epoch, _flags, k, seq, length, block, blocks, index, _m, shard_size = header
+        if magic != MULTICAST_MAGIC or (self.epoch is not None and epoch != self.epoch):
+            return []
+        if len(datagram) != HEADER_SIZE + shard_size or shard_size == 0 or blocks == 0 or block >= blocks:
+            return []
+        if index - k >= MAX_PARITY:
+            return []
+        if self._next is not None and abs(seq - self._next) > self.max_pending * 4:
+            # A stray must not move _newest (and poll) far ahead; an outage's resumed stream may.
+            if now - self._last_accepted < self.hold_s:
+                return []
+            self._resync(seq)
+        self._last_accepted = now
+        if self._next is not None and seq < self._next:
+            return []  # already delivered or given up
+        frame = self._pending.get(seq)
+        if frame is None:
+            frame = self._pending[seq] = _PendingFrame(header, now)
+            if self._next is None:
+                self._next = seq
+            if self._newest is None or seq > self._newest:
+                self._newest = seq
+        frame.last_seen = now
+        if frame.layout[block][1] != k or frame.data[block] is not None:
+            return self.poll(now)
+        frame.shards[block][index] = np.frombuffer(datagram, dtype=np.uint8, offset=HEADER_SIZE)
+        if len(frame.shards[block]) >= k:
+            if any(i >= k for i in frame.shards[block]) and any(i not in frame.shards[block] for i in range(k)):
+                frame.recovered = True
+            frame.data[block] = recover_block(k, frame.shards[block])
+            frame.shards[block] = {}
+        return self.poll(now)
+
+    def poll(self, now: float) -> List[bytes]:
+        """Deliver what is ready and give up on frames held back longer than ``hold_s``."""
+        out: List[bytes] = []
+        while self._next is not None and self._newest is not None and self._next <= self._newest:
+            frame = self._pending.get(self._next)
+            if frame is not None and frame.complete:
+                del self._pending[self._next]
+                self._next += 1
+                if self._awaiting_key and not frame.flags & FLAG_KEYFRAME:
+                    continue
+                self._awaiting_key = False
+                self.delivered += 1
+                self.recovered += frame.recovered
+                self.repaired += frame.requests > 0
+                out.append(frame.packet())
+                continue
+            if self._next == self._newest:
+                break  # still arriving
+            # Held back: something newer exists. Wait a while for FEC/repair, then skip.
+            # The wait runs from the newer frame's arrival, so a burst expires at once.
+            overtaken = self._overtaken_at(self._next)
+            if overtaken is not None and now - overtaken < self.hold_s and len(self._pending) <= self.max_pending:
+                break
+            # Expired: skip the whole run of missing frames up to the oldest pending one.
+            if self._pending.pop(self._next, None) is not None:
+                skip_to = self._next + 1
+            else:
+                skip_to = min(self._pending) if self._pending else self._newest + 1
+            self.lost += skip_to - self._next
+            if not self._awaiting_key:
+                self._awaiting_key = True
+                self._request_keyframe(skip_to - 1)
+            self._next = skip_to
+        return out
+
+    def _resync(self, seq: int) -> None:
+        self.lost += len(self._pending)
+        self._pending.clear()
+        self._next = self._newest = seq
+        self._awaiting_key = True
+        self._key_requested_through = None
+        self._request_keyframe(seq)
+
+    def _overtaken_at(self, seq: int) -> Optional[float]:
+        times = [f.first_seen for s, f in self._pending.items() if s > seq]
+        return min(times) if times else None
+
+    def _request_keyframe(self, through: int) -> None:
+        if self._key_requested_through is not None and through <= self._key_requested_through:
+            return
+        self._key_requested_through = max(self._newest, through)
+        self._keyframe_request = True
+
+    def repair_requests(self, now: float) -> List[Tuple[int, int, int]]:
+        """(seq, block, missing shards) for frames whose datagrams have stopped arriving."""
+        out = []
+        for seq, frame in sorted(self._pending.items()):
+            if frame.complete or frame.requests >= self.max_repairs:
+                continue
+            gone_by = seq < self._newest or now - frame.last_seen >= self.repair_after_s
+            if not gone_by or (frame.requests and now - frame.requested_at < self.repair_retry_s):
+                continue
+            for block, (_first, k) in enumerate(frame.layout):
+                if frame.data[block] is None:
+                    out.append((seq, block, k - len(frame.shards[block])))
+            frame.requested_at = now
+            frame.requests += 1
+            self.requests += 1
+        # A frame with no shard at all has no layout to repair: ask for a keyframe.
+        if self._next is not None:
+            start = self._next
+            if self._key_requested_through is not None:
+                start = max(start, self._key_requested_through + 1)
+            for seq in range(start, self._newest):
+                if seq in self._pending:
+                    continue
+                overtaken = self._overtaken_at(seq)
+                if overtaken is not None and now - overtaken >= self.repair_after_s:
+                    self._request_keyframe(seq)
+                break
+        return out
+
+    def take_keyframe_request(self) -> bool:
+        """True once after a frame was dropped; the caller sends NEED_IDR."""
+        requested, self._keyframe_request = self._keyframe_request, False
+        return requested
+
+    def stats(self) -> dict:
+        return {
+            "delivered": self.delivered,
+            "recovered": self.recovered,
+            "repaired": self.repaired,
+            "lost": self.lost,
+            "requests": self.requests,
+        }
@@ -0,0 +1,77 @@
+"""
+Payload checksums (CRC32C) for VRH4
+
+Uses a hardware-accelerated implementation when one is installed (the
+``crc32c`` or ``google-crc32c`` packages use SSE4.2 / ARMv8 CRC instructions),
+otherwise falls back to a table-driven pure-Python version that is correct but
+slow (~10 ms per 100 KB access unit).
+"""
+
+import logging
+from typing import Callable
+
+logger = logging.getLogger(__name__)
+
+_POLY = 0x82F63B78  # reflected Castagnoli polynomial
+
+
+def _make_table():
+    table = []
+    for i in range(256):
+        c = i
+        for _ in range(8):
+            c = (c >> 1) ^ _POLY if (c & 1) else (c >> 1)
+        table.append(c)
+    return tuple(table)
+
+
+_TABLE = _make_table()
+
+
+def crc32c_py(data: bytes, crc: int = 0) -> int:
+    """Reference CRC32C (reflected, init/xorout 0xFFFFFFFF)."""
+    c = (crc ^ 0xFFFFFFFF) & 0xFFFFFFFF
+    table = _TABLE
+    for b in data:
+        c = table[(c ^ b) & 0xFF] ^ (c >> 8)
+    return c ^ 0xFFFFFFFF
+
+
+def _select_backend() -> tuple:
+    try:
+        import crc32c as _crc32c_mod  # type: ignore
+
+        return "crc32c", (lambda data, crc=0: _crc32c_mod.crc32c(data, crc))
+    except Exception:
+        pass
+    try:
+        import google_crc32c  # type: ignore
+
+        if getattr(google_crc32c, "implementation", "c") == "c":
+            return "google_crc32c", (lambda data, crc=0: google_crc32c.extend(crc, bytes(data)))
+    except Exception:
+        pass
+    return "python", crc32c_py
+
+
+CRC32C_BACKEND: str
+_crc32c: Callable[..., int]
+CRC32C_BACKEND, _crc32c = _select_backend()
+
+
+def crc32c(data: bytes, crc: int = 0) -> int:
+    """CRC32C of ``data`` (optionally continuing from ``crc``)."""
+    return int(_crc32c(data, crc)) & 0xFFFFFFFF
+
+
+def is_hardware_accelerated() -> bool:
+    return CRC32C_BACKEND != "python"
+
+
+def log_backend() -> None:
+    if is_hardware_accelerated():
+        logger.info("CRC32C backend: %s", CRC32C_BACKEND)
+    else:
+        logger.warning(
+            "CRC32C backend: pure Python (slow). Install 'crc32c' for hardware CRC on the send path."
+        )
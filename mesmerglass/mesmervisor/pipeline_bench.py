@@ -0,0 +1,543 @@
+"""
+End-to-End Streaming Benchmark
+
+Drives the server chain (render -> capture -> resize -> encode -> packetize ->
+send) into a loopback TCP receiver that reads, parses and decodes packets the
+way the headset does (receive -> parse -> decode), and reports per-stage
+latency, CPU time, bytes per frame and the fps ceiling for each
+encoder/protocol combination. Backs ``python -m mesmerglass vr-bench``.
+
+Frames are rendered at a fixed virtual time per index (not wall time), so
+bytes per frame are reproducible and runs can be compared commit to commit.
+Sender and receiver stages run on separate threads; ``cpu_ms`` is the
+calling thread's CPU time, so encoder worker threads (x264, NVENC) only show
+up in the per-run ``cpu_ms_per_frame`` (whole process).
+"""
+
+import logging
+import platform
+import socket
+import struct
+import subprocess
+import threading
+import time
+from dataclasses import asdict, dataclass
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Sequence, Tuple
+
+import numpy as np
+
+from ..frame_buffers import frame_buffers
+from .frame_encoder import FrameEncoder, NVENCEncoder, create_encoder, encode_stereo_frames
+from .gpu_utils import EncoderType
+from .payload_crc import crc32c
+from .streaming_server import H264_PROTOCOLS, VRH4_FLAG_CRC32C, build_packet
+
+logger = logging.getLogger(__name__)
+
+BENCH_VERSION = 1
+
+# Encoder name -> protocols it can be carried by.
+ENCODER_PROTOCOLS: Dict[str, Tuple[str, ...]] = {
+    "jpeg": ("VRHP",),
+    "etc2": ("VRHT",),
+    "x264": ("VRH2", "VRH3", "VRH4"),
+    "nvenc": ("VRH2", "VRH3", "VRH4"),
+    "x265": ("VRH4",),  # HEVC is only signalled by the VRH4 flags word
+}
+
+# Streaming resolution per encoder (matches VRStreamingServer defaults).
+DEFAULT_TARGETS: Dict[str, Tuple[int, int]] = {
+    "jpeg": (2048, 1024),
+    "etc2": (1024, 512),
+    "x264": (2048, 1024),
+    "nvenc": (2048, 1024),
+    "x265": (2048, 1024),
+}
+
+SENDER_STAGES = ("render", "capture", "resize", "encode", "packetize", "send")
+RECEIVER_STAGES = ("receive", "parse", "decode")
+# Stages whose cost bounds throughput (send/receive mostly wait on the other side).
+_SENDER_WORK = ("render", "capture", "resize", "encode", "packetize")
+_RECEIVER_WORK = ("parse", "decode")
+
+SOFTWARE_PATTERNS = ("spiral", "checkerboard", "noise")
+GL_PATTERNS = ("grid", "solid")
+
+
+@dataclass
+class BenchConfig:
+    frames: int = 120
+    warmup: int = 10
+    source: str = "software"  # "software" (numpy patterns) or "gl" (OffscreenGL + readback)
+    pattern: str = "spiral"
+    width: int = 1920  # render size
+    height: int = 1080
+    target: Optional[Tuple[int, int]] = None  # streaming size; default per encoder
+    fps: int = 60  # nominal rate: encoder rate control, VRH3 fps_milli, pattern time step
+    quality: int = 25
+    bitrate: int = 120_000_000
+    stereo_offset: int = 0
+
+
+def all_combinations() -> List[Tuple[str, str]]:
+    return [(enc, proto) for enc, protos in ENCODER_PROTOCOLS.items() for proto in protos]
+
+
+def select_combinations(encoders: Optional[Sequence[str]] = None, protocols: Optional[Sequence[str]] = None) -> List[Tuple[str, str]]:
+    """Filter :func:`all_combinations`; raises ValueError on unknown names."""
+    enc_set = {e.strip().lower() for e in encoders} if encoders else None
+    proto_set = {p.strip().upper() for p in protocols} if protocols else None
+    if enc_set:
+        unknown = enc_set - set(ENCODER_PROTOCOLS)
+        if unknown:
+            raise ValueError(f"unknown encoder(s): {', '.join(sorted(unknown))}")
+    if proto_set:
+        known = {p for protos in ENCODER_PROTOCOLS.values() for p in protos}
+        unknown = proto_set - known
+        if unknown:
+            raise ValueError(f"unknown protocol(s): {', '.join(sorted(unknown))}")
+    return [
+        (enc, proto)
+        for enc, proto in all_combinations()
+        if (enc_set is None or enc in enc_set) and (proto_set is None or proto in proto_set)
+    ]
+
+
+# ---- frame sources ---------------------------------------------------------
+
+class SoftwareRenderer:
+    """Vectorised numpy test patterns (no GL needed)."""
+
+    def __init__(self, width: int, height: int, pattern: str = "spiral"):
+        if pattern not in SOFTWARE_PATTERNS:
+            raise ValueError(f"unknown software pattern: {pattern}")
+        self.width = width
+        self.height = height
+        self.pattern = pattern
+        yy, xx = np.mgrid[0:height, 0:width].astype(np.float32)
+        if pattern == "spiral":
+            cx, cy = (width - 1) / 2.0, (height - 1) / 2.0
+            self._theta = np.arctan2(yy - cy, xx - cx)
+            self._logr = np.log1p(np.hypot(xx - cx, yy - cy))
+            ramp = np.linspace(0.0, 1.0, 256, dtype=np.float32)
+            self._lut = np.stack([ramp * 200 + 30, ramp * 40, ramp * 230 + 20], axis=1).astype(np.uint8)
+        elif pattern == "checkerboard":
+            self._cells = ((xx // 32) + (yy // 32)).astype(np.int32)
+            self._lut = np.array([[255, 0, 255], [0, 255, 255]], dtype=np.uint8)
+        else:
+            self._rng = np.random.default_rng(1234)
+
+    def render(self, t: float) -> np.ndarray:
+        if self.pattern == "spiral":
+            v = np.sin(4.0 * self._theta + 6.0 * self._logr - t * np.float32(2.0 * np.pi * 0.5))
+            return self._lut[((v + 1.0) * 127.5).astype(np.uint8)]
+        if self.pattern == "checkerboard":
+            return self._lut[(self._cells + int(t * 50) // 32) & 1]
+        return self._rng.integers(0, 256, (self.height, self.width, 3), dtype=np.uint8)
+
+    def capture(self, frame: np.ndarray) -> np.ndarray:
+        # Same hand-off as the capture readback: one copy into a pooled buffer.
+        return frame_buffers.copy(np.ascontiguousarray(frame))
+
+    def close(self) -> None:
+        pass
+
+
+class GLRenderer:
+    """OffscreenGL patterns read back with glReadPixels (the compositor's capture path)."""
+
+    def __init__(self, width: int, height: int, pattern: str = "grid"):
+        if pattern not in GL_PATTERNS:
+            raise ValueError(f"unknown GL pattern: {pattern}")
+        from PyQt6.QtGui import QGuiApplication
+
+        self._app = QGuiApplication.instance() or QGuiApplication([])
+        from ..vr.offscreen import OffscreenGL
+
+        self.pattern = pattern
+        self._gl = OffscreenGL(width, height)
+
+    def render(self, t: float) -> None:
+        self._gl.make_current()
+        try:
+            self._gl.render_pattern(self.pattern, t)
+        finally:
+            self._gl.done_current()
+        return None
+
+    def capture(self, _frame) -> np.ndarray:
+        self._gl.make_current()
+        try:
+            return self._gl.read_rgb()
+        finally:
+            self._gl.done_current()
+
+    def close(self) -> None:
+        try:
+            self._gl.delete()
+        except Exception:
+            pass
+
+
+def _make_renderer(cfg: BenchConfig):
+    if cfg.source == "gl":
+        return GLRenderer(cfg.width, cfg.height, cfg.pattern)
+    return SoftwareRenderer(cfg.width, cfg.height, cfg.pattern)
+
+
+def _make_encoder(name: str, width: int, height: int, cfg: BenchConfig) -> FrameEncoder:
+    if name == "jpeg":
+        return create_encoder(EncoderType.JPEG, width, height, quality=cfg.quality)
+    if name == "etc2":
+        return create_encoder(EncoderType.ETC2, width, height)
+    if name == "x265":
+        return create_encoder(EncoderType.HEVC, width, height, fps=cfg.fps, bitrate=cfg.bitrate, codec_name="libx265")
+    codec = "h264_nvenc" if name == "nvenc" else "libx264"
+    return NVENCEncoder(width, height, fps=cfg.fps, bitrate=cfg.bitrate, codec_name=codec)
+
+
+def _resize(frame: np.ndarray, width: int, height: int) -> np.ndarray:
+    if frame.shape[1] == width and frame.shape[0] == height:
+        return frame
+    import cv2
+
+    return cv2.resize(frame, (width, height), interpolation=cv2.INTER_LINEAR)
+
+
+# ---- receiver --------------------------------------------------------------
+
+class _Decoder:
+    """Per-protocol client-side decode; ``name`` is None when no decoder is available."""
+
+    def __init__(self, protocol: str, hevc: bool = False):
+        self.protocol = protocol
+        self.name: Optional[str] = None
+        self._contexts: list = []
+        if protocol == "VRHP":
+            try:
+                import cv2
+
+                self._cv2 = cv2
+                self.name = "cv2.imdecode"
+            except ImportError:
+                pass
+        elif protocol == "VRHT":
+            from . import texture_codec
+
+            self._texture_codec = texture_codec
+            self.name = "texture unpack"  # the headset uploads ETC2 blocks as-is
+        elif protocol.encode() in H264_PROTOCOLS:
+            try:
+                import av
+
+                # One decoder per eye, like the client.
+                codec = "hevc" if hevc else "h264"
+                self._contexts = [av.CodecContext.create(codec, "r") for _ in range(2)]
+                self._av = av
+                self.name = f"libavcodec {codec}"
+            except Exception:
+                pass
+
+    def decode(self, eye: int, payload: memoryview) -> None:
+        if self.name is None or not len(payload):
+            return
+        if self.protocol == "VRHP":
+            self._cv2.imdecode(np.frombuffer(payload, dtype=np.uint8), self._cv2.IMREAD_COLOR)
+        elif self.protocol == "VRHT":
+            self._texture_codec.unpack_texture_payload(bytes(payload))
+        else:
+            for _ in self._contexts[eye].decode(self._av.Packet(bytes(payload))):
+                pass
+
+
+def _recv_exact(sock: socket.socket, view: memoryview) -> bool:
+    got = 0
+    while got < len(view):
+        n = sock.recv_into(view[got:])
+        if n == 0:
+            return False
+        got += n
+    return True
+
+
+class _Receiver(threading.Thread):
+    def __init__(
+        self,
+        sock: socket.socket,
+        protocol: str,
+        send_start: Dict[int, float],
+        render_start: Dict[int, float],
+        hevc: bool = False,
+    ):
+        super().__init__(name="vr-bench-recv", daemon=True)
+        self._sock = sock
+        self._send_start = send_start
+        self._render_start = render_start
+        self.decoder = _Decoder(protocol, hevc)
+        self.samples: Dict[int, Dict[str, Tuple[float, float]]] = {}
+        self.end_to_end: Dict[int, float] = {}
+        self.crc_errors = 0
+        self.error: Optional[BaseException] = None
+
+    def run(self) -> None:
+        try:
+            self._loop()
+        except BaseException as e:  # pragma: no cover - surfaced in the report
+            self.error = e
+
+    def _loop(self) -> None:
+        size_buf = bytearray(4)
+        buf = bytearray(1 << 20)
+        while True:
+            if not _recv_exact(self._sock, memoryview(size_buf)):
+                return
+            size = struct.unpack("!I", size_buf)[0]
+            if size > len(buf):
+                buf = bytearray(size)
+            view = memoryview(buf)[:size]
+            if not _recv_exact(self._sock, view):
+                return
+            t_recv = time.perf_counter()
+            c_recv = time.thread_time()
+
+            magic, frame_id, left_size, right_size = struct.unpack_from("!4sIII", view, 0)
+            header = 16
+            if magic in (b"VRH3", b"VRH4"):
+                header = 20
+            if magic == b"VRH4":
+                flags, crc_left, crc_right = struct.unpack_from("!III", view, 20)
+                header = 32
+            left = view[header:header + left_size]
+            right = view[header + left_size:header + left_size + right_size]
+            if magic == b"VRH4" and flags & VRH4_FLAG_CRC32C:
+                if crc32c(left) != crc_left or (right_size and crc32c(right) != crc_right):
+                    self.crc_errors += 1
+            t_parse = time.perf_counter()
+            c_parse = time.thread_time()
+
+            self.decoder.decode(0, left)
+            self.decoder.decode(1, right)
+            t_dec = time.perf_counter()
+            c_dec = time.thread_time()
+
+            sent = self._send_start.get(frame_id, t_recv)
+            self.samples[frame_id] = {
+                "receive": ((t_recv - sent) * 1000.0, 0.0),
+                "parse": ((t_parse - t_recv) * 1000.0, (c_parse - c_recv) * 1000.0),
+                "decode": ((t_dec - t_parse) * 1000.0, (c_dec - c_parse) * 1000.0),
+            }
+            started = self._render_start.get(frame_id)
+            if started is not None:
+                self.end_to_end[frame_id] = (t_dec - started) * 1000.0
+
+
+# ---- run -------------------------------------------------------------------
+
+def _summary(values: Sequence[float]) -> Dict[str, float]:
+    if not values:
+        return {"p50_ms": 0.0, "p99_ms": 0.0, "mean_ms": 0.0}
+    arr = np.asarray(values, dtype=np.float64)
+    return {
+        "p50_ms": round(float(np.percentile(arr, 50)), 3),
+        "p99_ms": round(float(np.percentile(arr, 99)), 3),
+        "mean_ms": round(float(arr.mean()), 3),
+    }
+
+
+def run_combination(encoder_name: str, protocol: str, cfg: BenchConfig) -> dict:
+    """Benchmark one encoder/protocol pair; never raises for a missing encoder."""
+    result: dict = {"encoder": encoder_name, "protocol": protocol, "status": "ok"}
+    if protocol not in ENCODER_PROTOCOLS.get(encoder_name, ()):
+        raise ValueError(f"{encoder_name} cannot be carried by {protocol}")
+    width, height = cfg.target or DEFAULT_TARGETS[encoder_name]
+    if encoder_name == "etc2":
+        width, height = width // 4 * 4, height // 4 * 4
+    result["target"] = f"{width}x{height}"
+
+    try:
+        encoder = _make_encoder(encoder_name, width, height, cfg)
+    except Exception as e:
+        result.update(status="skipped", reason=str(e))
+        return result
+    renderer = _make_renderer(cfg)
+
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listener.bind(("127.0.0.1", 0))
+    listener.listen(1)
+    sender = socket.create_connection(listener.getsockname())
+    sender.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    receiving, _ = listener.accept()
+    listener.close()
+
+    send_start: Dict[int, float] = {}
+    render_start: Dict[int, float] = {}
+    hevc = encoder_name == "x265"
+    receiver = _Receiver(receiving, protocol, send_start, render_start, hevc=hevc)
+    receiver.start()
+
+    magic = protocol.encode("ascii")
+    fps_milli = int(cfg.fps * 1000)
+    mono = cfg.stereo_offset == 0
+    samples: Dict[int, Dict[str, Tuple[float, float]]] = {}
+    packet_bytes: Dict[int, int] = {}
+    empty_encodes = 0
+    total = cfg.warmup + cfg.frames
+    measured_start = None
+    cpu_start = None
+    try:
+        for i in range(total):
+            frame_id = i + 1
+            if i == cfg.warmup:
+                measured_start = time.perf_counter()
+                cpu_start = time.process_time()
+            stamps = [(time.perf_counter(), time.thread_time())]
+            render_start[frame_id] = stamps[0][0]
+            frame = renderer.render(i / float(cfg.fps))
+            stamps.append((time.perf_counter(), time.thread_time()))
+            frame = renderer.capture(frame)
+            stamps.append((time.perf_counter(), time.thread_time()))
+            frame = _resize(frame, width, height)
+            stamps.append((time.perf_counter(), time.thread_time()))
+            left, right = encode_stereo_frames(encoder, frame, cfg.stereo_offset)
+            if mono:
+                right = b""
+            stamps.append((time.perf_counter(), time.thread_time()))
+            if not left:
+                # Encoder still buffering (or failed); nothing to send this frame.
+                empty_encodes += 1
+                continue
+            packet = build_packet(
+                magic, left, right, frame_id, fps_milli=fps_milli, payload_crc=(magic == b"VRH4"), hevc=hevc
+            )
+            stamps.append((time.perf_counter(), time.thread_time()))
+            send_start[frame_id] = stamps[-1][0]
+            sender.sendall(packet)
+            stamps.append((time.perf_counter(), time.thread_time()))
+            if i >= cfg.warmup:
+                samples[frame_id] = {
+                    stage: ((stamps[k + 1][0] - stamps[k][0]) * 1000.0, (stamps[k + 1][1] - stamps[k][1]) * 1000.0)
+                    for k, stage in enumerate(SENDER_STAGES)
+                }
+                packet_bytes[frame_id] = len(packet)
+    finally:
+        try:
+            sender.shutdown(socket.SHUT_WR)
+        except OSError:
+            pass
+        receiver.join(timeout=30.0)
+        sender.close()
+        receiving.close()
+        try:
+            encoder.close()
+        except Exception:
+            pass
+        renderer.close()
+    wall_s = (time.perf_counter() - measured_start) if measured_start is not None else 0.0
+    cpu_s = (time.process_time() - cpu_start) if cpu_start is not None else 0.0
+
+    if receiver.error is not None:
+        result.update(status="error", reason=f"receiver: {receiver.error}")
+        return result
+    for frame_id, recv in receiver.samples.items():
+        if frame_id in samples:
+            samples[frame_id].update(recv)
+    frames = [fid for fid, s in samples.items() if "decode" in s]
+    if not frames:
+        result.update(status="error", reason="no frames reached the receiver")
+        return result
+
+    stages = {}
+    for stage in SENDER_STAGES + RECEIVER_STAGES:
+        stat = _summary([samples[f][stage][0] for f in frames])
+        stat["cpu_ms"] = round(float(np.mean([samples[f][stage][1] for f in frames])), 3)
+        stages[stage] = stat
+    sender_busy = sum(stages[s]["mean_ms"] for s in _SENDER_WORK)
+    receiver_busy = sum(stages[s]["mean_ms"] for s in _RECEIVER_WORK)
+    sizes = np.asarray([packet_bytes[f] for f in frames], dtype=np.float64)
+    result.update(
+        frames=len(frames),
+        empty_encodes=empty_encodes,
+        decoder=receiver.decoder.name,
+        wall_s=round(wall_s, 3),
+        fps=round(len(frames) / wall_s, 2) if wall_s > 0 else 0.0,
+        fps_ceiling=round(1000.0 / max(sender_busy, receiver_busy, 1e-6), 2),
+        bottleneck="sender" if sender_busy >= receiver_busy else "receiver",
+        cpu_ms_per_frame=round(cpu_s * 1000.0 / len(frames), 3),
+        bytes_per_frame={
+            "mean": int(sizes.mean()),
+            "p50": int(np.percentile(sizes, 50)),
+            "p99": int(np.percentile(sizes, 99)),
+            "max": int(sizes.max()),
+        },
+        crc_errors=receiver.crc_errors,
+        end_to_end=_summary([receiver.end_to_end[f] for f in frames if f in receiver.end_to_end]),
+        stages=stages,
+    )
+    return result
+
+
+def _git_revision() -> Optional[str]:
+    try:
+        out = subprocess.run(
+            ["git", "rev-parse", "--short", "HEAD"],
+            cwd=str(Path(__file__).resolve().parent),
+            capture_output=True,
+            text=True,
+            timeout=5,
+        )
+    except Exception:
+        return None
+    if out.returncode != 0:
+        return None
+    return out.stdout.strip() or None
+
+
+def run_benchmark(
+    combinations: Sequence[Tuple[str, str]],
+    cfg: BenchConfig,
+    progress: Optional[Callable[[str], None]] = None,
+) -> dict:
+    """Run every combination and return the JSON-serialisable report."""
+    results = []
+    for encoder_name, protocol in combinations:
+        if progress:
+            progress(f"{encoder_name}/{protocol}: {cfg.warmup}+{cfg.frames} frames")
+        results.append(run_combination(encoder_name, protocol, cfg))
+        if progress:
+            r = results[-1]
+            if r["status"] == "ok":
+                progress(f"  {r['fps']:.1f} fps (ceiling {r['fps_ceiling']:.1f}), {r['bytes_per_frame']['mean']} B/frame")
+            else:
+                progress(f"  {r['status']}: {r.get('reason', '')}")
+    config = asdict(cfg)
+    config["target"] = f"{cfg.target[0]}x{cfg.target[1]}" if cfg.target else None
+    return {
+        "bench": "vr-pipeline",
+        "version": BENCH_VERSION,
+        "git": _git_revision(),
+        "platform": platform.platform(),
+        "python": platform.python_version(),
+        "config": config,
+        "results": results,
+    }
+
+
+def format_report(report: dict) -> str:
+    """Fixed-width table of the headline numbers (JSON carries the rest)."""
+    stages = SENDER_STAGES + RECEIVER_STAGES
+    head = f"{'encoder':<7} {'proto':<5} {'fps':>7} {'ceil':>7} {'KB/fr':>8} {'e2e p50':>8} {'e2e p99':>8}  " + " ".join(
+        f"{s[:7]:>7}" for s in stages
+    )
+    lines = [head, "-" * len(head)]
+    for r in report["results"]:
+        if r["status"] != "ok":
+            lines.append(f"{r['encoder']:<7} {r['protocol']:<5} {r['status']}: {r.get('reason', '')}")
+            continue
+        lines.append(
+            f"{r['encoder']:<7} {r['protocol']:<5} {r['fps']:>7.1f} {r['fps_ceiling']:>7.1f} "
+            f"{r['bytes_per_frame']['mean'] / 1024.0:>8.1f} {r['end_to_end']['p50_ms']:>8.2f} {r['end_to_end']['p99_ms']:>8.2f}  "
+            + " ".join(f"{r['stages'][s]['p50_ms']:>7.2f}" for s in stages)
+        )
+    lines.append("(stage columns: p50 ms; full p50/p99/mean/cpu per stage in --json output)")
+    return "\n".join(lines)
@@ -0,0 +1,569 @@
+"""
+Multi-Session Streaming Host
+
+Runs several independent VR streaming sessions in one process, one
+VRStreamingServer (own TCP port, encoder profile and headless frame source) per
+session, so a single box can feed several headsets with different content.
+A session given a session file plays it through its own SessionRunner and
+LoomHeadlessCompositor (SessionRenderSource); without one it streams a
+software test pattern.
+
+What is shared across sessions:
+- Encoder time. Every session's encodes go through one EncodeScheduler, which
+  grants its slots to the waiting session that has used the least encoder time
+  so far. A session with an expensive profile or several clients cannot starve
+  the others, and one slot (the default) keeps NVENC encodes serialised as the
+  single-session server does.
+- Warm encoders. One EncoderPool serves every session, so sessions with the
+  same profile share spares and a connect or reset rarely waits for encoder setup.
+- Decoded images. Sessions that load media go through content.media's shared
+  image pool (``MESMERGLASS_SHARED_IMAGE_POOL_MB`` or ``image_pool_mb``, else
+  ``DEFAULT_SESSION_IMAGE_POOL_MB`` when session files are served), so each
+  file is decoded and held once per process instead of once per ThemeBank.
+  Videos share the process-wide decoder cache the same way.
+- Discovery. A single UDP discovery service answers every headset and points it
+  at a session: the one listing its device name or IP, otherwise the session
+  with the fewest assigned headsets. Assignments are sticky per IP.
+
+Capacity is measured with ``load_client`` (``python -m mesmerglass vr-load`` or
+``vr-host --load-clients``): a session counts as sustained when its clients
+receive at least 95% of the target frame rate.
+"""
+
+import itertools
+import logging
+import threading
+import time
+from dataclasses import dataclass, field
+from typing import Callable, Dict, List, Optional, Tuple
+
+import numpy as np
+
+from ..content.bundle import exists as bundle_exists
+from .encoder_pool import EncoderPool
+from .frame_pacer import sleep_until
+from .gpu_utils import EncoderType
+from .pipeline_bench import SOFTWARE_PATTERNS, SoftwareRenderer
+from .streaming_server import DiscoveryService, VRStreamingServer
+
+logger = logging.getLogger(__name__)
+
+# Shared decoded-image budget when session files are served and none was configured.
+DEFAULT_SESSION_IMAGE_POOL_MB = 1024
+
+ENCODER_NAMES: Dict[str, EncoderType] = {
+    "auto": EncoderType.AUTO,
+    "nvenc": EncoderType.NVENC,
+    "jpeg": EncoderType.JPEG,
+    "etc2": EncoderType.ETC2,
+    "hevc": EncoderType.HEVC,
+}
+
+
+# ---- encoder scheduling ----------------------------------------------------
+
+@dataclass
+class SessionEncodeStats:
+    encodes: int = 0
+    busy_s: float = 0.0
+    wait_s: float = 0.0
+    max_wait_s: float = 0.0
+
+
+class EncodeScheduler:
+    """Fair-share lock over ``slots`` concurrent encodes.
+
+    Waiters are served lowest accumulated encoder time first (ties by arrival),
+    so sessions converge on equal encoder time regardless of how many clients
+    or threads each one has. A session that joins late starts at the current
+    minimum instead of with a backlog of credit.
+    """
+
+    def __init__(self, slots: int = 1):
+        self.slots = max(1, int(slots))
+        self._cond = threading.Condition()
+        self._active = 0
+        self._seq = itertools.count()
+        self._waiting: List[Tuple[int, str]] = []
+        self._vtime: Dict[str, float] = {}
+        self._stats: Dict[str, SessionEncodeStats] = {}
+
+    def slot(self, session: str) -> "EncodeSlot":
+        """Context manager that VRStreamingServer can hold as its encode lock."""
+        with self._cond:
+            self._register(session)
+        return EncodeSlot(self, session)
+
+    def acquire(self, session: str) -> float:
+        start = time.perf_counter()
+        with self._cond:
+            self._register(session)
+            ticket = (next(self._seq), session)
+            self._waiting.append(ticket)
+            while self._active >= self.slots or self._next() != ticket:
+                self._cond.wait()
+            self._waiting.remove(ticket)
+            self._active += 1
+            granted = time.perf_counter()
+            stats = self._stats[session]
+            stats.wait_s += granted - start
+            stats.max_wait_s = max(stats.max_wait_s, granted - start)
+            # Another slot may still be free for the next waiter.
+            self._cond.notify_all()
+        return granted
+
+    def release(self, session: str, granted: float) -> None:
+        busy = time.perf_counter() - granted
+        with self._cond:
+            self._active -= 1
+            self._vtime[session] += busy
+            stats = self._stats[session]
+            stats.encodes += 1
+            stats.busy_s += busy
+            self._cond.notify_all()
+
+    def stats(self) -> Dict[str, SessionEncodeStats]:
+        with self._cond:
+            return {name: SessionEncodeStats(**vars(s)) for name, s in self._stats.items()}
+
+    def _register(self, session: str) -> None:
+        if session not in self._vtime:
+            self._vtime[session] = min(self._vtime.values(), default=0.0)
+            self._stats[session] = SessionEncodeStats()
+
+    def _next(self) -> Tuple[int, str]:
+        return min(self._waiting, key=lambda t: (self._vtime[t[1]], t[0]))
+
+
+class EncodeSlot:
+    """Per-session handle on an EncodeScheduler; re-entrant across threads, not within one."""
+
+    def __init__(self, scheduler: EncodeScheduler, session: str):
+        self._scheduler = scheduler
+        self.session = session
+        self._granted = threading.local()
+
+    def __enter__(self) -> "EncodeSlot":
+        self._granted.value = self._scheduler.acquire(self.session)
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self._scheduler.release(self.session, self._granted.value)
+
+
+# ---- sessions --------------------------------------------------------------
+
+@dataclass
+class SessionSpec:
+    """One streaming session: where it listens, how it encodes and what it renders."""
+
+    name: str
+    port: int
+    encoder: str = "jpeg"
+    fps: int = 30
+    width: int = 1920
+    height: int = 1080
+    target: Optional[Tuple[int, int]] = None  # streaming size; None keeps the server default
+    quality: int = 25
+    bitrate: int = 20_000_000
+    pattern: str = "spiral"  # software test pattern, used when no session file is given
+    devices: Tuple[str, ...] = ()  # headset names or IPs routed to this session by discovery
+    session: Optional[str] = None  # .session.json or .mgbundle rendered by a headless compositor
+    cuelist: Optional[str] = None  # cuelist key in the session (default: its active or first cuelist)
+
+
+class HeadlessPatternSource:
+    """Frame callback rendering a software pattern at the session's frame rate.
+
+    The server's producer thread calls frame callbacks back to back, so the
+    source paces itself; otherwise every session would render and encode flat
+    out and capacity would not reflect the target fps.
+    """
+
+    def __init__(self, width: int, height: int, fps: float, pattern: str = "spiral"):
+        self._renderer = SoftwareRenderer(width, height, pattern)
+        self._period = 1.0 / max(1e-3, float(fps))
+        self._t0 = time.perf_counter()
+        self._next = self._t0
+
+    def __call__(self) -> np.ndarray:
+        now = time.perf_counter()
+        if self._next > now:
+            sleep_until(self._next)
+        else:
+            self._next = now
+        self._next += self._period
+        return self._renderer.render(time.perf_counter() - self._t0)
+
+
+def _resolve_playbacks(cuelist, session_data: dict, session_name: str) -> None:
+    """Point cue playback names at JSON files written from the session's playbacks.
+
+    Same approach as the session runner tab, with one directory per hosted
+    session so two sessions' same-named playbacks never overwrite each other.
+    """
+    import json
+
+    from ..platform_paths import ensure_dir, get_user_data_dir
+
+    playbacks = session_data.get("playbacks") or {}
+    if not playbacks:
+        return
+    temp_dir = ensure_dir(get_user_data_dir() / "runtime" / "playbacks" / session_name)
+    for cue in cuelist.cues:
+        for entry in cue.playback_pool:
+            playback_name = str(entry.playback_path)
+            if playback_name not in playbacks:
+                continue
+            playback_data = playbacks[playback_name]
+            if isinstance(playback_data, dict) and "version" not in playback_data:
+                playback_data["version"] = "1.0"
+            playback_file = temp_dir / f"{playback_name}.json"
+            playback_file.write_text(json.dumps(playback_data, indent=2))
+            entry.playback_path = playback_file
+
+
+class SessionRenderSource:
+    """Frame callback streaming a session file rendered by a LoomHeadlessCompositor.
+
+    Builds the GUI's director stack (spiral, text, and a visual director over a
+    ThemeBank scanned from the session's Media Bank) and plays one cuelist with
+    a headless SessionRunner stepped once per rendered frame. Images decode
+    through content.media's shared pool and videos open through the
+    process-wide decoder cache, so sessions showing the same files decode them
+    once.
+
+    Build, start and close it on the Qt main thread (a QGuiApplication must
+    exist). Each server producer thread gets every rendered frame exactly once,
+    or None after 0.1 s without a new one.
+    """
+
+    def __init__(
+        self,
+        name: str,
+        session_path: str,
+        width: int,
+        height: int,
+        fps: float,
+        cuelist: Optional[str] = None,
+    ):
+        from pathlib import Path
+
+        from ..content.simple_video_streamer import SimpleVideoStreamer
+        from ..content.text_renderer import TextRenderer
+        from ..content.theme import ThemeConfig
+        from ..content.themebank import ThemeBank, themes_from_media_bank
+        from ..engine.text_director import TextDirector
+        from ..mesmerloom.headless_compositor import LoomHeadlessCompositor
+        from ..mesmerloom.spiral import SpiralDirector
+        from ..mesmerloom.visual_director import VisualDirector
+        from ..session.cuelist import Cuelist
+        from ..session.encoder_hints import EncoderHints
+        from ..session.runner import SessionRunner
+        from ..session_manager import SessionManager
+
+        self.name = name
+        path = Path(session_path)
+        self.session_data = SessionManager().load_session(path)
+        cuelists = self.session_data.get("cuelists") or {}
+        key = cuelist or (self.session_data.get("runtime") or {}).get("active_cuelist") or next(iter(cuelists), None)
+        if key not in cuelists:
+            raise ValueError(f"session {name}: {path.name} has no cuelist {key!r}")
+        self.cuelist = Cuelist.from_dict(cuelists[key])
+        _resolve_playbacks(self.cuelist, self.session_data, name)
+
+        themes, fonts = themes_from_media_bank(self.session_data.get("media_bank") or [])
+        if not themes:
+            themes = [ThemeConfig(name="Empty", enabled=True, image_path=[], animation_path=[], font_path=[], text_line=[])]
+        self.theme_bank = ThemeBank(themes=themes, root_path=Path("."), image_cache_size=256)
+        self.theme_bank.set_active_themes(primary_index=1, alt_index=2 if len(themes) > 1 else None)
+        self.theme_bank.set_font_library(fonts)
+
+        self.spiral_director = SpiralDirector()
+        self.text_renderer = TextRenderer()
+        self.text_director = TextDirector(text_renderer=self.text_renderer)
+        self.compositor = LoomHeadlessCompositor(
+            self.spiral_director, width, height, fps=fps, text_director=self.text_director
+        )
+        if not self.compositor.available:
+            self.compositor.cleanup()
+            self.theme_bank.shutdown()
+            raise RuntimeError(f"session {name}: no offscreen GL context")
+        self.text_director.compositor = self.compositor
+        self.video_streamer = SimpleVideoStreamer(buffer_size=180, prefill_frames=0)
+        self.visual_director = VisualDirector(
+            theme_bank=self.theme_bank,
+            compositor=self.compositor,
+            text_renderer=self.text_renderer,
+            video_streamer=self.video_streamer,
+            text_director=self.text_director,
+            mesmer_server=None,
+        )
+        self.text_director._on_text_change = self.visual_director._on_change_text
+        self.encoder_hints = EncoderHints()
+        self.runner = SessionRunner(
+            cuelist=self.cuelist,
+            visual_director=self.visual_director,
+            audio_engine=None,
+            compositor=self.compositor,
+            display_tab=None,
+            session_data=self.session_data,
+            headless=True,
+            encoder_hints=self.encoder_hints,
+        )
+
+        self._cond = threading.Condition()
+        self._frame: Optional[np.ndarray] = None
+        self._rendered_at: Optional[float] = None
+        self._generation = 0
+        self._taken = threading.local()  # per producer thread
+
+    def start(self) -> None:
+        if not self.runner.start():
+            raise RuntimeError(f"session {self.name}: cuelist '{self.cuelist.name}' did not start")
+        self.compositor.tick_callback = self._tick
+        self.compositor.enable_vr_streaming(self._on_frame)
+        self.compositor.start()
+
+    def close(self) -> None:
+        self.compositor.stop()
+        self.compositor.tick_callback = None
+        try:
+            self.runner.stop()
+        except Exception as e:
+            logger.warning("Session %s runner did not stop cleanly: %s", self.name, e)
+        self.compositor.disable_vr_streaming()
+        self.video_streamer.stop()
+        self.compositor.cleanup()
+        self.theme_bank.shutdown()
+
+    def _tick(self, dt: float) -> None:
+        self.runner.update(dt=dt)
+
+    def _on_frame(self, frame) -> None:
+        if frame is None:
+            return
+        # Capture frames are pooled per delivery and never written again; keep a reference.
+        with self._cond:
+            self._frame = frame
+            self._rendered_at = self.compositor.capture_rendered_at()
+            self._generation += 1
+            self._cond.notify_all()
+
+    def __call__(self):
+        with self._cond:
+            seen = getattr(self._taken, "generation", 0)
+            if not self._cond.wait_for(lambda: self._generation != seen, timeout=0.1):
+                return None
+            self._taken.generation = self._generation
+            # The paint time lets the server key the first frame after a cut.
+            return self._frame, self._rendered_at
+
+
+@dataclass
+class _Session:
+    spec: SessionSpec
+    server: VRStreamingServer
+    assigned: set = field(default_factory=set)
+
+
+class MultiSessionHost:
+    """Starts, routes and reports on a set of streaming sessions."""
+
+    def __init__(
+        self,
+        specs: List[SessionSpec],
+        host: str = "0.0.0.0",
+        discovery_port: Optional[int] = 5556,
+        encode_slots: int = 1,
+        image_pool_mb: Optional[float] = None,
+        frame_sources: Optional[Dict[str, Callable[[], Optional[np.ndarray]]]] = None,
+    ):
+        if not specs:
+            raise ValueError("at least one session is required")
+        names = [s.name for s in specs]
+        ports = [s.port for s in specs]
+        if len(set(names)) != len(names) or len(set(ports)) != len(ports):
+            raise ValueError("session names and ports must be unique")
+        for spec in specs:
+            if spec.encoder not in ENCODER_NAMES:
+                raise ValueError(f"unknown encoder for session {spec.name}: {spec.encoder}")
+            if frame_sources is not None and spec.name in frame_sources:
+                continue
+            if spec.session is not None:
+                if not bundle_exists(spec.session):
+                    raise ValueError(f"session file not found for session {spec.name}: {spec.session}")
+            elif spec.pattern not in SOFTWARE_PATTERNS:
+                raise ValueError(f"unknown pattern for session {spec.name}: {spec.pattern}")
+
+        self.host = host
+        self.discovery_port = discovery_port
+        self.scheduler = EncodeScheduler(encode_slots)
+        self.encoder_pool = EncoderPool()
+        self.discovery_service: Optional[DiscoveryService] = None
+        self._routes: Dict[str, str] = {}  # headset ip -> session name
+        self._routes_lock = threading.Lock()
+        self.started_at: Optional[float] = None
+
+        from ..content.media import shared_image_pool
+
+        if image_pool_mb is None and any(s.session for s in specs) and not shared_image_pool().enabled:
+            image_pool_mb = DEFAULT_SESSION_IMAGE_POOL_MB  # sessions with media should share decodes
+        if image_pool_mb is not None:
+            shared_image_pool().set_budget(int(float(image_pool_mb) * 1024 * 1024))
+
+        self.sessions: Dict[str, _Session] = {}
+        self._render_sources: List[SessionRenderSource] = []
+        try:
+            for spec in specs:
+                self._add_session(spec, (frame_sources or {}).get(spec.name))
+        except Exception:
+            self._close_render_sources()
+            raise
+
+    def _add_session(self, spec: SessionSpec, source: Optional[Callable[[], Optional[np.ndarray]]]) -> None:
+        if source is None and spec.session is None:
+            source = HeadlessPatternSource(spec.width, spec.height, spec.fps, spec.pattern)
+        server = VRStreamingServer(
+            host=self.host,
+            port=spec.port,
+            discovery_port=None,
+            encoder_type=ENCODER_NAMES[spec.encoder],
+            width=spec.width,
+            height=spec.height,
+            fps=spec.fps,
+            quality=spec.quality,
+            bitrate=spec.bitrate,
+            frame_callback=source,
+            encode_lock=self.scheduler.slot(spec.name),
+            encoder_pool=self.encoder_pool,
+        )
+        if spec.target is not None:
+            server.target_width, server.target_height = spec.target
+        if source is None:
+            # Render straight at the streamed size so the server never resizes.
+            renderer = SessionRenderSource(
+                spec.name, spec.session, server.target_width, server.target_height, spec.fps, spec.cuelist
+            )
+            self._render_sources.append(renderer)
+            server.frame_callback = renderer
+            server.scene_hints = renderer.encoder_hints
+        self.sessions[spec.name] = _Session(spec, server)
+
+    def _close_render_sources(self) -> None:
+        for renderer in self._render_sources:
+            try:
+                renderer.close()
+            except Exception as e:
+                logger.warning("Session %s renderer did not close cleanly: %s", renderer.name, e)
+        self._render_sources = []
+
+    def start(self) -> None:
+        for renderer in self._render_sources:
+            renderer.start()
+        for session in self.sessions.values():
+            session.server.start_server()
+        if self.discovery_port is not None:
+            first = next(iter(self.sessions.values())).spec.port
+            self.discovery_service = DiscoveryService(self.discovery_port, first, port_for=self.route)
+            self.discovery_service.start()
+        self.started_at = time.time()
+        logger.info(
+            "Multi-session host: %d sessions on ports %s (encode slots=%d)",
+            len(self.sessions),
+            ",".join(str(s.spec.port) for s in self.sessions.values()),
+            self.scheduler.slots,
+        )
+
+    def stop(self) -> None:
+        if self.discovery_service is not None:
+            self.discovery_service.stop()
+            self.discovery_service = None
+        for session in self.sessions.values():
+            try:
+                session.server.stop_server()
+            except Exception as e:
+                logger.warning("Session %s did not stop cleanly: %s", session.spec.name, e)
+        self._close_render_sources()
+        self.encoder_pool.close()
+
+    def route(self, ip: str, device_name: str) -> int:
+        """Pick the session for a discovered headset and return its streaming port."""
+        with self._routes_lock:
+            name = self._routes.get(ip)
+            if name is None:
+                for session in self.sessions.values():
+                    if ip in session.spec.devices or device_name in session.spec.devices:
+                        name = session.spec.name
+                        break
+            if name is None:
+                name = min(self.sessions.values(), key=lambda s: len(s.assigned)).spec.name
+            if self._routes.get(ip) != name:
+                logger.info("Routing headset %s (%s) to session %s", device_name, ip, name)
+            self._routes[ip] = name
+            self.sessions[name].assigned.add(ip)
+            return self.sessions[name].spec.port
+
+    def report(self) -> dict:
+        """Per-session clients, send rate and encoder share, plus shared cache stats."""
+        from ..content.media import shared_image_pool
+
+        elapsed = max(1e-6, time.time() - (self.started_at or time.time()))
+        encode = self.scheduler.stats()
+        total_busy = sum(s.busy_s for s in encode.values()) or 1e-9
+        sessions = []
+        for name, session in self.sessions.items():
+            server = session.server
+            stats = encode.get(name, SessionEncodeStats())
+            startup = server.startup_stats()
+            sessions.append({
+                "name": name,
+                "port": session.spec.port,
+                "encoder": server.encoder_type.value,
+                "protocol": server.protocol_magic.decode("ascii"),
+                "target_fps": session.spec.fps,
+                "clients": len(server.clients),
+                "frames_sent": server.frames_sent,
+                "encodes": stats.encodes,
+                "encode_ms_avg": round(stats.busy_s * 1000.0 / stats.encodes, 3) if stats.encodes else 0.0,
+                "encode_wait_ms_avg": round(stats.wait_s * 1000.0 / stats.encodes, 3) if stats.encodes else 0.0,
+                "encode_wait_ms_max": round(stats.max_wait_s * 1000.0, 3),
+                "encoder_share": round(stats.busy_s / total_busy, 3),
+                "encoder_utilisation": round(stats.busy_s / elapsed, 3),
+                "first_frame_ms_avg": startup["first_frame_ms"]["avg"],
+                "first_frame_ms_max": startup["first_frame_ms"]["max"],
+            })
+        return {
+            "elapsed_s": round(elapsed, 3),
+            "encode_slots": self.scheduler.slots,
+            "sessions": sessions,
+            "image_pool": shared_image_pool().stats(),
+            "encoder_pool": self.encoder_pool.stats(),
+        }
+
+
+def format_host_report(report: dict) -> str:
+    lines = [
+        f"{'session':<12} {'port':>5} {'proto':>5} {'fps':>4} {'clients':>7} {'encodes':>8} "
+        f"{'enc ms':>7} {'wait ms':>8} {'share':>6} {'1st ms':>7}",
+    ]
+    for s in report["sessions"]:
+        lines.append(
+            f"{s['name']:<12} {s['port']:>5} {s['protocol']:>5} {s['target_fps']:>4} {s['clients']:>7} "
+            f"{s['encodes']:>8} {s['encode_ms_avg']:>7.2f} {s['encode_wait_ms_avg']:>8.2f} {s['encoder_share']:>6.2f} "
+            f"{s['first_frame_ms_avg']:>7.1f}"
+        )
+    encoders = report["encoder_pool"]
+    if encoders["spares"]:
+        lines.append(
+            f"encoder pool: {encoders['hits']} warm / {encoders['misses']} cold checkouts "
+            f"({encoders['checkout_ms_avg']:.1f} ms avg, build {encoders['create_ms_avg']:.1f} ms), "
+            f"{encoders['reused']} reused, {encoders['discarded']} closed"
+        )
+    pool = report["image_pool"]
+    if pool["budget_bytes"]:
+        lines.append(
+            f"shared image pool: {pool['count']} images, {pool['bytes'] / 1048576:.1f}/"
+            f"{pool['budget_bytes'] / 1048576:.0f} MiB, {pool['hits']} hits, {pool['misses']} misses"
+        )
+    return "\n".join(lines)
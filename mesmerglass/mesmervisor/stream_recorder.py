@@ -0,0 +1,318 @@
+"""
+Stream Recorder
+
+Tees already-encoded H.264 access units from the VR stream into a fragmented
+MP4 file. No decode or re-encode happens: Annex-B NAL units are rewritten as
+length-prefixed samples and wrapped in moof/mdat fragments, so recording a live
+session costs disk I/O only.
+
+Timestamps come from the caller (the streaming server passes the time each
+frame was queued by its producer), so the recording keeps the produced cadence
+without the send loop's queueing delay. File writes happen on a background
+thread to keep the asyncio send loop free of disk stalls; a write error stops
+the recording (``failed``) rather than the stream.
+"""
+
+import logging
+import queue
+import struct
+import threading
+import time
+from pathlib import Path
+from typing import List, Optional, Tuple, Union
+
+from .annexb import NAL_AUD, NAL_IDR, NAL_PPS, NAL_SPS, h264_sps_dimensions, iter_annexb_nal_units
+
+logger = logging.getLogger(__name__)
+
+# 90 kHz is the conventional video timescale and divides common frame rates well.
+TIMESCALE = 90_000
+
+_SAMPLE_FLAGS_SYNC = 0x02000000  # sample_depends_on=2 (does not depend on others)
+_SAMPLE_FLAGS_NON_SYNC = 0x01010000  # sample_depends_on=1, sample_is_non_sync_sample=1
+
+_UNITY_MATRIX = struct.pack(">9I", 0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000)
+
+
+def _box(box_type: bytes, *payloads: bytes) -> bytes:
+    body = b"".join(payloads)
+    return struct.pack(">I4s", 8 + len(body), box_type) + body
+
+
+def _full_box(box_type: bytes, version: int, flags: int, *payloads: bytes) -> bytes:
+    return _box(box_type, struct.pack(">I", ((version & 0xFF) << 24) | (flags & 0xFFFFFF)), *payloads)
+
+
+def build_avcc(sps: bytes, pps: bytes) -> bytes:
+    """AVCDecoderConfigurationRecord for a single SPS/PPS pair."""
+    return (
+        bytes([1, sps[1], sps[2], sps[3], 0xFF, 0xE1])
+        + struct.pack(">H", len(sps))
+        + sps
+        + b"\x01"
+        + struct.pack(">H", len(pps))
+        + pps
+    )
+
+
+def build_init_segment(width: int, height: int, sps: bytes, pps: bytes) -> bytes:
+    """ftyp + moov for a single fragmented H.264 video track."""
+    ftyp = _box(b"ftyp", b"isom", struct.pack(">I", 0x200), b"isom", b"iso6", b"avc1", b"mp41")
+
+    mvhd = _full_box(
+        b"mvhd", 0, 0,
+        struct.pack(">IIII", 0, 0, 1000, 0),
+        struct.pack(">IH", 0x00010000, 0x0100),
+        bytes(10),
+        _UNITY_MATRIX,
+        bytes(24),
+        struct.pack(">I", 2),
+    )
+    tkhd = _full_box(
+        b"tkhd", 0, 0x000003,
+        struct.pack(">IIIII", 0, 0, 1, 0, 0),
+        bytes(8),
+        struct.pack(">hhhH", 0, 0, 0, 0),
+        _UNITY_MATRIX,
+        struct.pack(">II", int(width) << 16, int(height) << 16),
+    )
+    mdhd = _full_box(b"mdhd", 0, 0, struct.pack(">IIIIHH", 0, 0, TIMESCALE, 0, 0x55C4, 0))
+    hdlr = _full_box(b"hdlr", 0, 0, struct.pack(">I4s", 0, b"vide"), bytes(12), b"MesmerVisor\x00")
+
+    avc1 = _box(
+        b"avc1",
+        bytes(6),
+        struct.pack(">H", 1),  # data_reference_index
+        bytes(16),
+        struct.pack(">HH", int(width), int(height)),
+        struct.pack(">II", 0x00480000, 0x00480000),
+        bytes(4),
+        struct.pack(">H", 1),  # frame_count
+        bytes(32),  # compressorname
+        struct.pack(">Hh", 0x0018, -1),
+        _box(b"avcC", build_avcc(sps, pps)),
+    )
+    stbl = _box(
+        b"stbl",
+        _full_box(b"stsd", 0, 0, struct.pack(">I", 1), avc1),
+        _full_box(b"stts", 0, 0, struct.pack(">I", 0)),
+        _full_box(b"stsc", 0, 0, struct.pack(">I", 0)),
+        _full_box(b"stsz", 0, 0, struct.pack(">II", 0, 0)),
+        _full_box(b"stco", 0, 0, struct.pack(">I", 0)),
+    )
+    minf = _box(
+        b"minf",
+        _full_box(b"vmhd", 0, 1, bytes(8)),
+        _box(b"dinf", _full_box(b"dref", 0, 0, struct.pack(">I", 1), _full_box(b"url ", 0, 1))),
+        stbl,
+    )
+    trak = _box(b"trak", tkhd, _box(b"mdia", mdhd, hdlr, minf))
+    mvex = _box(b"mvex", _full_box(b"trex", 0, 0, struct.pack(">IIIII", 1, 1, 0, 0, 0)))
+    return ftyp + _box(b"moov", mvhd, trak, mvex)
+
+
+def build_fragment(sequence: int, base_decode_time: int, samples: List[Tuple[int, bytes, bool]]) -> bytes:
+    """moof + mdat for ``samples`` given as (duration_ticks, avcc_payload, is_sync)."""
+
+    def _moof(data_offset: int) -> bytes:
+        trun_entries = b"".join(
+            struct.pack(">III", dur, len(payload), _SAMPLE_FLAGS_SYNC if sync else _SAMPLE_FLAGS_NON_SYNC)
+            for dur, payload, sync in samples
+        )
+        traf = _box(
+            b"traf",
+            _full_box(b"tfhd", 0, 0x020000, struct.pack(">I", 1)),  # default-base-is-moof
+            _full_box(b"tfdt", 1, 0, struct.pack(">Q", int(base_decode_time))),
+            # data-offset | sample-duration | sample-size | sample-flags
+            _full_box(b"trun", 0, 0x000701, struct.pack(">Ii", len(samples), data_offset), trun_entries),
+        )
+        return _box(b"moof", _full_box(b"mfhd", 0, 0, struct.pack(">I", int(sequence))), traf)
+
+    moof = _moof(0)
+    moof = _moof(len(moof) + 8)
+    return moof + _box(b"mdat", *(payload for _dur, payload, _sync in samples))
+
+
+def annexb_to_avcc(access_unit: bytes) -> Tuple[bytes, bool, Optional[bytes], Optional[bytes]]:
+    """Convert an Annex-B access unit to a length-prefixed sample.
+
+    Returns (sample, is_idr, sps, pps). AUDs are dropped; SPS/PPS stay in-band so
+    encoder resets with new parameter sets still decode.
+    """
+    out = bytearray()
+    is_idr = False
+    sps = pps = None
+    for nal_type, unit in iter_annexb_nal_units(access_unit):
+        if nal_type == NAL_AUD:
+            continue
+        if nal_type == NAL_SPS:
+            sps = bytes(unit)
+        elif nal_type == NAL_PPS:
+            pps = bytes(unit)
+        elif nal_type == NAL_IDR:
+            is_idr = True
+        out += struct.pack(">I", len(unit))
+        out += unit
+    return bytes(out), is_idr, sps, pps
+
+
+class StreamRecorder:
+    """Fragmented-MP4 writer fed with encoded H.264 access units."""
+
+    def __init__(
+        self,
+        path: Union[str, Path],
+        fps: float = 30.0,
+        fragment_seconds: float = 1.0,
+        queue_size: int = 64,
+    ):
+        """
+        Args:
+            path: Output .mp4 path (parent directories are created)
+            fps: Nominal frame rate (used for the final sample's duration)
+            fragment_seconds: Max fragment length; fragments also cut at every IDR
+            queue_size: Fragments buffered for the writer thread before dropping
+        """
+        self.path = Path(path)
+        self.fps = max(1.0, float(fps))
+        self._fragment_ticks = max(1, int(float(fragment_seconds) * TIMESCALE))
+
+        self._t0: Optional[float] = None
+        self._pending: List[Tuple[int, bytes, bool]] = []  # (pts_ticks, sample, is_sync)
+        self._fragment_start_ticks = 0
+        self._sequence = 0
+        self._init_written = False
+        self._resync = True  # wait for an IDR (with SPS/PPS) before recording
+
+        self.samples_written = 0
+        self.fragments_written = 0
+        self.dropped_fragments = 0
+        self.bytes_written = 0
+        self.failed = False
+
+        self._queue: "queue.Queue[Optional[bytes]]" = queue.Queue(maxsize=max(1, int(queue_size)))
+        self._closed = False
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        self._fp = open(self.path, "wb")
+        self._writer = threading.Thread(target=self._writer_loop, name="stream-recorder", daemon=True)
+        self._writer.start()
+
+    # ---- producer side (streaming loop) -------------------------------------
+    def write(self, access_unit: bytes, t_s: Optional[float] = None) -> None:
+        """Append one access unit presented at ``t_s`` (seconds, any monotonic clock).
+
+        Pass the time the frame was queued; ``t_s=None`` stamps it now.
+        """
+        if self._closed or self.failed or not access_unit:
+            return
+        t = time.perf_counter() if t_s is None else float(t_s)
+        sample, is_idr, sps, pps = annexb_to_avcc(access_unit)
+        if not sample:
+            return
+
+        if self._resync:
+            if not is_idr:
+                return
+            if not self._init_written:
+                if sps is None or pps is None:
+                    return
+                dims = h264_sps_dimensions(sps)
+                if dims is None:
+                    logger.warning("[vrh2-rec] could not parse SPS; recording disabled")
+                    self._closed = True
+                    return
+                self._enqueue(build_init_segment(dims[0], dims[1], sps, pps))
+                self._init_written = True
+                logger.info("[vrh2-rec] recording %dx%d H.264 to %s", dims[0], dims[1], str(self.path))
+            self._resync = False
+
+        if self._t0 is None:
+            self._t0 = t
+        pts = max(0, int(round((t - self._t0) * TIMESCALE)))
+        if self._pending and pts <= self._pending[-1][0]:
+            pts = self._pending[-1][0] + 1
+
+        if self._pending and (is_idr or (pts - self._fragment_start_ticks) >= self._fragment_ticks):
+            self._flush(next_pts=pts)
+            if self._resync and not is_idr:
+                return
+        if not self._pending:
+            self._fragment_start_ticks = pts
+        self._pending.append((pts, sample, is_idr))
+
+    def _flush(self, next_pts: Optional[int] = None) -> None:
+        if not self._pending:
+            return
+        nominal = max(1, int(round(TIMESCALE / self.fps)))
+        samples: List[Tuple[int, bytes, bool]] = []
+        for i, (pts, sample, sync) in enumerate(self._pending):
+            if i + 1 < len(self._pending):
+                nxt = self._pending[i + 1][0]
+            else:
+                nxt = next_pts if next_pts is not None else pts + nominal
+            samples.append((max(1, nxt - pts), sample, sync))
+        base = self._pending[0][0]
+        self._pending = []
+
+        self._sequence += 1
+        if self._enqueue(build_fragment(self._sequence, base, samples)):
+            self.samples_written += len(samples)
+            self.fragments_written += 1
+        else:
+            # A missing fragment breaks references until the next IDR.
+            self.dropped_fragments += 1
+            self._resync = True
+            logger.warning("[vrh2-rec] writer behind; dropped fragment %d (resync at next IDR)", self._sequence)
+
+    def _enqueue(self, data: bytes) -> bool:
+        try:
+            self._queue.put_nowait(data)
+            return True
+        except queue.Full:
+            return False
+
+    # ---- writer thread ------------------------------------------------------
+    def _writer_loop(self) -> None:
+        while True:
+            data = self._queue.get()
+            if data is None:
+                break
+            if self.failed:
+                continue  # drain until close() so producers never block on a dead writer
+            try:
+                self._fp.write(data)
+                self._fp.flush()
+                self.bytes_written += len(data)
+            except Exception as e:
+                logger.error("[vrh2-rec] write to %s failed; recording stopped: %s", str(self.path), e)
+                self.failed = True
+                try:
+                    self._fp.close()
+                except Exception:
+                    pass
+
+    def close(self, timeout: float = 5.0) -> None:
+        """Flush the final fragment and close the file."""
+        if self._fp is None:
+            return
+        if not self._closed and not self.failed:
+            self._flush()
+        self._closed = True
+        try:
+            self._queue.put(None, timeout=timeout)
+        except queue.Full:
+            pass
+        self._writer.join(timeout=timeout)
+        try:
+            self._fp.close()
+        except Exception:
+            pass
+        self._fp = None
+        logger.info(
+            "[vrh2-rec] closed %s (samples=%d fragments=%d dropped=%d bytes=%d)",
+            str(self.path),
+            self.samples_written,
+            self.fragments_written,
+            self.dropped_fragments,
+            self.bytes_written,
+        )
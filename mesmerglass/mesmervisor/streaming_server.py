@@ -11,10 +11,10 @@ import struct
 import logging
 import time
 import threading
-import zlib
 from collections import deque
 import numpy as np
 import cv2
+from dataclasses import replace
 from typing import Optional, Set, Tuple, Callable
 from queue import Queue, Empty
 
@@ -22,18 +22,172 @@ from pathlib import Path
 import os
 import datetime
 
-from .frame_encoder import FrameEncoder, create_encoder, encode_stereo_frames
-from .gpu_utils import EncoderType, select_encoder
+from .annexb import (
+    HEVC_NAL_CRA,
+    access_unit_contains_idr,
+    h264_rewrite_access_unit,
+    h264_slice_header_brief,
+    hevc_slice_brief,
+    iter_annexb_nal_units,
+    iter_annexb_nals,
+)
+from .asset_cache import (
+    ASSET_FORMAT_JPEG,
+    ASSET_FORMAT_TEXTURE,
+    CONTROL_ASSET_OFFER,
+    AssetLedger,
+    ControlParser,
+)
+from .frame_pacer import FixedTimeline, FramePacer, sleep_until
+from .payload_crc import crc32c, log_backend as log_crc32c_backend
+from .encoder_pool import EncoderPool, EncoderProfile
+from .frame_encoder import FrameEncoder, encode_stereo_frames
+from .stream_recorder import StreamRecorder
+from .frame_dump import FrameDumpWriter
+from ..frame_buffers import frame_buffers
+from .gpu_utils import EncoderType, hevc_encoder_codec, select_encoder
+from .multicast import CONTROL_MULTICAST_JOIN, MulticastSender, parse_group
+from .motion_rate import MotionRate, adaptive_enabled
 
 logger = logging.getLogger(__name__)
 
 _WIN_ABORT_ERRNOS = {995, 10038}
 
+# Magics that carry H.264 access units (HEVC too when VRH4 sets VRH4_FLAG_HEVC).
+H264_PROTOCOLS = frozenset({b"VRH2", b"VRH3", b"VRH4"})
+
+# VRH4 header flags.
+VRH4_FLAG_CRC32C = 0x00000001  # crc_left/crc_right hold CRC32C of each eye payload
+VRH4_FLAG_HEVC = 0x00000002  # eye payloads are HEVC (H.265) access units, not H.264
+
+# Headsets append ";codecs=avc,hevc" to VR_HEADSET_HELLO to advertise their decoders.
+# Discovery records them per IP so the streaming server can pick a codec per client;
+# the registry is module-wide because MultiSessionHost answers discovery for several servers.
+_headset_codecs: dict = {}
+_headset_codecs_lock = threading.Lock()
+
+
+def parse_headset_hello(message: str) -> Tuple[str, Optional[frozenset]]:
+    """Split ``VR_HEADSET_HELLO:<name>[;codecs=a,b]`` into (name, codecs or None)."""
+    parts = message.split(":", 1)
+    name = parts[1] if len(parts) > 1 else "Unknown Device"
+    codecs: Optional[frozenset] = None
+    head, sep, tail = name.rpartition(";codecs=")
+    if sep:
+        name = head
+        codecs = frozenset(c.strip().lower() for c in tail.split(",") if c.strip())
+    return (name or "Unknown Device"), codecs
+
+
+def note_headset_codecs(ip: str, codecs: Optional[frozenset]) -> None:
+    """Remember the decoders a headset advertised (None: older client, H.264 only)."""
+    with _headset_codecs_lock:
+        if codecs is None:
+            _headset_codecs.pop(ip, None)
+        else:
+            _headset_codecs[ip] = codecs
+
+
+def headset_codecs(ip: str) -> Optional[frozenset]:
+    """Decoders advertised by the headset at ``ip``, or None if it never said."""
+    with _headset_codecs_lock:
+        return _headset_codecs.get(ip)
+
+# Server -> headset control packets: VRHP-style header with frame_id 0 and the
+# command (one byte, then arguments) in the left-eye slot; bulk data, if any, in
+# the right-eye slot. Clients that predate VRHC only receive them when a control
+# feature is switched on. Asset cache commands (0x02-0x04) live in asset_cache,
+# the multicast JOIN (0x05) in multicast.
+CONTROL_MAGIC = b"VRHC"
+CONTROL_HUD = 0x01  # args: [enabled]
+
+# A recovery IDR requested this close to an announced scene cut waits for the cut's IDR.
+SCENE_CUT_IDR_WINDOW_S = 0.25
+
+
+def _streaming_telemetry():
+    """The UI's telemetry sink, or None when the engine package cannot be imported."""
+    try:
+        from ..engine.streaming_telemetry import streaming_telemetry
+    except Exception:
+        return None
+    return streaming_telemetry
+
+
+def _perf_blockers():
+    """The session perf-blocker log (GC pauses, paint spikes), or None outside the app."""
+    try:
+        from ..session import perf_blockers
+    except Exception:
+        return None
+    return perf_blockers
+
+
+def _close_off_loop(close: Callable[[], None]) -> None:
+    """Run a draining ``close()`` (dump writer, stream recorder) on an executor thread.
+
+    Their joins wait up to seconds for disk I/O; on the event loop that would
+    stall every connected client.
+    """
+    def run() -> None:
+        try:
+            close()
+        except Exception as e:
+            logger.warning("Background close failed: %s", e)
+
+    try:
+        asyncio.get_running_loop().run_in_executor(None, run)
+    except RuntimeError:  # no running loop (shutdown)
+        run()
+
+
+def build_packet(
+    magic: bytes,
+    left_frame: bytes,
+    right_frame: bytes,
+    frame_id: int,
+    fps_milli: int = 30000,
+    payload_crc: bool = False,
+    hevc: bool = False,
+) -> bytes:
+    """Size-prefixed stream packet; see VRStreamingServer.create_packet for the layout."""
+    left_size = len(left_frame)
+    right_size = len(right_frame)
+    if magic in (b"VRH3", b"VRH4"):
+        header = struct.pack('!4sIIII', magic, frame_id, left_size, right_size, int(fps_milli))
+        if magic == b"VRH4":
+            flags = VRH4_FLAG_HEVC if hevc else 0
+            crc_left = crc_right = 0
+            if payload_crc:
+                flags |= VRH4_FLAG_CRC32C
+                crc_left = crc32c(left_frame)
+                crc_right = crc32c(right_frame) if right_size else 0
+            header += struct.pack('!III', flags, crc_left, crc_right)
+    else:
+        header = struct.pack('!4sIII', magic, frame_id, left_size, right_size)
+
+    # Combine header + frames
+    packet_data = header + left_frame + right_frame
+
+    # Prepend packet size (ALL protocols need this for the Android client)
+    return struct.pack('!I', len(packet_data)) + packet_data
+
+
+def build_control_packet(command: int, args: bytes = b"", payload: bytes = b"") -> bytes:
+    """Size-prefixed VRHC control packet carrying one command."""
+    return build_packet(CONTROL_MAGIC, bytes([command & 0xFF]) + bytes(args), bytes(payload), 0)
+
 
 class DiscoveryService:
     """UDP discovery service for automatic VR headset detection"""
     
-    def __init__(self, discovery_port: int = 5556, streaming_port: int = 5555, manual_devices: list = None):
+    def __init__(
+        self,
+        discovery_port: int = 5556,
+        streaming_port: int = 5555,
+        manual_devices: list = None,
+        port_for: Optional[Callable[[str, str], int]] = None,
+    ):
         """
         Initialize discovery service
         
@@ -41,9 +195,12 @@ class DiscoveryService:
             discovery_port: UDP port for discovery broadcasts (5556 - original working port)
             streaming_port: TCP port for streaming (5555 - original working port)
             manual_devices: List of manually configured devices [{"ip": str, "name": str}]
+            port_for: Optional (ip, device_name) -> streaming port, used by the multi-session
+                host to point each headset at its own session. Defaults to streaming_port.
         """
         self.discovery_port = discovery_port
         self.streaming_port = streaming_port
+        self.port_for = port_for
         self.socket: Optional[socket.socket] = None
         self.running = False
         self.thread: Optional[threading.Thread] = None
@@ -152,10 +309,10 @@ class DiscoveryService:
                     logger.info(f"📥 Received UDP packet: {message[:80]} from {addr[0]}:{addr[1]}")
                     
                     if message.startswith("VR_HEADSET_HELLO"):
-                        # Parse message: "VR_HEADSET_HELLO:device_name"
-                        parts = message.split(":", 1)
-                        device_name = parts[1] if len(parts) > 1 else "Unknown Device"
+                        # Parse message: "VR_HEADSET_HELLO:device_name[;codecs=avc,hevc]"
+                        device_name, codecs = parse_headset_hello(message)
                         client_ip = addr[0]
+                        note_headset_codecs(client_ip, codecs)
                         
                         # Store or update device info (THREAD-SAFE)
                         with self._devices_lock:
@@ -168,13 +325,17 @@ class DiscoveryService:
                                 "name": device_name,
                                 "ip": client_ip,
                                 "last_seen": time.time(),
-                                "type": "vr"  # CRITICAL: Add type field for display filtering
+                                "type": "vr",  # CRITICAL: Add type field for display filtering
+                                "codecs": sorted(codecs) if codecs is not None else ["avc"],
                             }
                         
                         # Send back server info
-                        response = f"VR_SERVER_INFO:{self.streaming_port}"
+                        port = self.streaming_port
+                        if self.port_for is not None:
+                            port = int(self.port_for(client_ip, device_name))
+                        response = f"VR_SERVER_INFO:{port}"
                         self.socket.sendto(response.encode('utf-8'), addr)
-                        logger.info(f"📤 Sent VR_SERVER_INFO:{self.streaming_port} to {client_ip}:{addr[1]}")
+                        logger.info(f"📤 Sent VR_SERVER_INFO:{port} to {client_ip}:{addr[1]}")
                     else:
                         logger.warning(f"❓ Unknown UDP message: {message[:80]} from {addr[0]}")
                 
@@ -198,7 +359,7 @@ class VRStreamingServer:
         self,
         host: str = "0.0.0.0",
         port: int = 5555,
-        discovery_port: int = 5556,
+        discovery_port: Optional[int] = 5556,
         encoder_type: EncoderType = EncoderType.AUTO,
         width: int = 1920,
         height: int = 1080,
@@ -206,7 +367,16 @@ class VRStreamingServer:
         quality: int = 25,  # VERY aggressive: 85→50→35→25 for Oculus Go low-res displays
         bitrate: int = 120_000_000,
         stereo_offset: int = 0,
-        frame_callback: Optional[Callable[[], Optional[np.ndarray]]] = None
+        frame_callback: Optional[Callable[[], Optional[np.ndarray]]] = None,
+        record_path: Optional[str] = None,
+        hud: Optional[bool] = None,
+        asset_cache: Optional[bool] = None,
+        encode_lock=None,
+        encoder_pool: Optional[EncoderPool] = None,
+        scene_hints=None,
+        multicast: Optional[str] = None,
+        multicast_interface: Optional[str] = None,
+        adaptive_fps: Optional[bool] = None,
     ):
         """
         Initialize VR streaming server
@@ -214,15 +384,41 @@ class VRStreamingServer:
         Args:
             host: Server host address
             port: TCP streaming port (default 5555)
-            discovery_port: UDP discovery port (default 5556)
-            encoder_type: Encoder to use (AUTO, NVENC, or JPEG)
+            discovery_port: UDP discovery port (default 5556); None when another component
+                (e.g. MultiSessionHost) answers discovery for this server
+            encoder_type: Encoder to use (AUTO, NVENC, JPEG, ETC2 or HEVC). HEVC goes to
+                headsets that advertise an HEVC decoder; others get H.264 from the same server
             width: Frame width
             height: Frame height
             fps: Target frames per second
             quality: JPEG quality (1-100, ignored for NVENC)
             bitrate: H.264 bitrate (bits/second, ignored for JPEG)
             stereo_offset: Stereo parallax offset (pixels, 0 = mono)
-            frame_callback: Function that returns RGB frames (height, width, 3) uint8
+            frame_callback: Function that returns RGB frames (height, width, 3) uint8, or
+                (frame, rendered_at) with the perf_counter paint time used for scene cuts
+            record_path: Tee the encoded H.264 stream into a fragmented MP4 (no re-encode).
+                A path ending in .mp4 is used as-is; anything else is treated as a directory.
+                Defaults to MESMERGLASS_VRH2_RECORD when unset.
+            hud: Show the headset's performance overlay. Defaults to MESMERGLASS_VR_HUD
+                when unset; can be changed while streaming with set_hud().
+            asset_cache: Offer the headset's content-addressed asset cache (VRHP/VRHT only):
+                recurring frames are sent once and then shown by hash. Defaults to
+                MESMERGLASS_VR_ASSET_CACHE when unset.
+            encode_lock: Context manager held around every encode. Defaults to a private
+                lock; MultiSessionHost passes a slot of its shared EncodeScheduler.
+            encoder_pool: Warm encoders handed out on connect and encoder reset. Defaults to a
+                private pool (MESMERGLASS_ENCODER_POOL_SPARES spares, filled when the server
+                starts); MultiSessionHost shares one pool between its sessions.
+            scene_hints: session.encoder_hints.EncoderHints from the SessionRunner. H.264
+                streams then place IDRs on cue/playback cuts and run long GOPs in between.
+            multicast: ``group[:port]`` (or ``1`` for 239.255.77.1:5557): encode once and send
+                every frame once to a UDP multicast group with FEC; headset TCP connections
+                carry control only (see multicast). Defaults to MESMERGLASS_VR_MULTICAST.
+            multicast_interface: Local IPv4 address to send the group on. Defaults to
+                MESMERGLASS_VR_MULTICAST_IF, else the route the OS picks.
+            adaptive_fps: Capture, encode and send only as many of the ``fps`` ticks as the
+                content's motion needs (see motion_rate; uses ``scene_hints`` when given).
+                Defaults to MESMERGLASS_VR_ADAPTIVE_FPS.
         """
         self.host = host
         self.port = port
@@ -232,6 +428,29 @@ class VRStreamingServer:
         self.fps = fps
         self.stereo_offset = stereo_offset
         self.frame_callback = frame_callback
+        if record_path is None:
+            record_path = (os.environ.get("MESMERGLASS_VRH2_RECORD") or "").strip() or None
+        self.record_path = record_path
+        if hud is None:
+            hud = (os.environ.get("MESMERGLASS_VR_HUD") or "").strip().lower() in {"1", "true", "on", "yes"}
+        self.hud_enabled = bool(hud)
+        if asset_cache is None:
+            asset_cache = (os.environ.get("MESMERGLASS_VR_ASSET_CACHE") or "").strip().lower() in {"1", "true", "on", "yes"}
+        self.asset_cache = bool(asset_cache)
+        if multicast is None:
+            multicast = (os.environ.get("MESMERGLASS_VR_MULTICAST") or "").strip() or None
+        self.multicast: Optional[Tuple[str, int]] = None
+        if multicast:
+            try:
+                self.multicast = parse_group(multicast)
+            except (OSError, ValueError) as e:
+                logger.warning("Invalid multicast group %r (%s); streaming over TCP", multicast, e)
+        if multicast_interface is None:
+            multicast_interface = (os.environ.get("MESMERGLASS_VR_MULTICAST_IF") or "").strip() or None
+        self.multicast_interface = multicast_interface
+        if self.multicast is not None and self.asset_cache:
+            logger.warning("The asset cache is per connection; disabled in multicast mode")
+            self.asset_cache = False
 
         # Allow runtime bitrate override without changing code.
         # Expected in bits/sec, e.g. 150000000 for 150 Mbps.
@@ -255,24 +474,63 @@ class VRStreamingServer:
         self.encoder_type = select_encoder(encoder_type)
         logger.info(f"Selected encoder: {self.encoder_type.value.upper()}")
 
-        # Store encoder configuration. Encoder instances are created per-client in handle_client.
-        # This avoids reserving an NVENC session before any client connects.
+        # Store encoder configuration. Each client gets its own encoder from the pool, which
+        # keeps a small number of initialised spares (one NVENC session by default) so connects
+        # and resets don't wait for encoder setup.
         self.bitrate = int(bitrate)
         self.quality = int(quality)
         self.encoder: Optional[FrameEncoder] = None
+        self._owns_encoder_pool = encoder_pool is None
+        self.scene_hints = scene_hints
+        self.scene_cut_idrs = 0
+        self.adaptive_fps = adaptive_enabled() if adaptive_fps is None else bool(adaptive_fps)
+        self.encoder_pool = encoder_pool if encoder_pool is not None else EncoderPool()
 
         # Protocol magic:
         # - VRHP: JPEG
         # - VRH2: H.264 (legacy header)
         # - VRH3: H.264 (extended header includes fps_milli)
+        # - VRH4: H.264 (VRH3 + flags + per-eye CRC32C); HEVC when flags has VRH4_FLAG_HEVC
+        # - VRHT: ETC2 compressed textures (VRHP header, texture_codec payloads)
         # Default to VRH3 for H.264 to improve client smoothness (timed playout scheduling).
-        self.protocol_magic = (b"VRH3" if self.encoder_type == EncoderType.NVENC else b"VRHP")
+        video = self.encoder_type in (EncoderType.NVENC, EncoderType.HEVC)
+        self.protocol_magic = (b"VRH3" if video else b"VRHP")
+        self.hevc_codec: Optional[str] = None
+        if self.encoder_type == EncoderType.HEVC:
+            # Only VRH4 can flag HEVC payloads. protocol_magic stays the H.264 magic for
+            # headsets that don't advertise an HEVC decoder (see _client_stream).
+            self.hevc_codec = hevc_encoder_codec() or "libx265"
+        if self.encoder_type == EncoderType.ETC2:
+            self.protocol_magic = b"VRHT"
+            # ETC2 is 4 bpp before LZ4, so default to a quarter of the pixels.
+            # Override with MESMERGLASS_VRHT_SIZE=WxH (rounded down to multiples of 4).
+            self.target_width, self.target_height = 1024, 512
+            size_env = (os.environ.get("MESMERGLASS_VRHT_SIZE") or "").strip().lower()
+            if size_env:
+                try:
+                    w_str, h_str = size_env.split("x", 1)
+                    w_val, h_val = int(w_str) // 4 * 4, int(h_str) // 4 * 4
+                    if w_val <= 0 or h_val <= 0:
+                        raise ValueError(size_env)
+                    self.target_width, self.target_height = w_val, h_val
+                except ValueError:
+                    logger.warning("Invalid MESMERGLASS_VRHT_SIZE=%r (expected WxH)", size_env)
+
+        # Optional per-eye CRC32C so the headset can drop corrupted access units precisely
+        # instead of guessing from NAL structure. Implies VRH4.
+        self.payload_crc = False
+        if (os.environ.get("MESMERGLASS_VRH2_CRC") or "").strip().lower() in {"1", "true", "on", "yes"}:
+            if video:
+                self.payload_crc = True
+                self.protocol_magic = b"VRH4"
+            else:
+                logger.warning("MESMERGLASS_VRH2_CRC ignored (current encoder=%s)", self.encoder_type.value)
 
-        # Optional: allow forcing VRH2 or VRH3 when using NVENC.
+        # Optional: allow forcing VRH2, VRH3 or VRH4 when using NVENC (HEVC: for the H.264 fallback).
         protocol_env = (os.environ.get("MESMERGLASS_VRH2_PROTOCOL") or "").strip().lower()
-        if protocol_env in {"vrh2", "vrh3"}:
-            if self.encoder_type == EncoderType.NVENC:
-                self.protocol_magic = (b"VRH3" if protocol_env == "vrh3" else b"VRH2")
+        if protocol_env in {"vrh2", "vrh3", "vrh4"}:
+            if video:
+                self.protocol_magic = protocol_env.upper().encode("ascii")
                 logger.info("VRH2 protocol override: %s", protocol_env)
             else:
                 logger.warning(
@@ -280,6 +538,11 @@ class VRStreamingServer:
                     protocol_env,
                     self.encoder_type.value,
                 )
+        if self.payload_crc and self.protocol_magic != b"VRH4":
+            logger.warning("MESMERGLASS_VRH2_CRC needs VRH4; checksums disabled for %s", self.protocol_magic.decode())
+            self.payload_crc = False
+        if self.payload_crc:
+            log_crc32c_backend()
         
         # Server state
         self.server_socket: Optional[socket.socket] = None
@@ -287,6 +550,12 @@ class VRStreamingServer:
         self.clients = []
         self._client_tasks: set[asyncio.Task] = set()
         self.running = False
+
+        # Multicast mode: one producer for every joined headset.
+        self._multicast: Optional[MulticastSender] = None
+        self._multicast_thread: Optional[threading.Thread] = None
+        self._multicast_members: Set[str] = set()
+        self._multicast_need_idr = threading.Event()
         
         # Frame timing
         self.frame_delay = 1.0 / fps
@@ -300,6 +569,9 @@ class VRStreamingServer:
         self.encode_times = []
         self.send_times = []
         self.last_stats_time = time.time()
+        # Connect -> first frame sent, and anomaly reset request -> first decodable frame sent.
+        self.first_frame_ms: deque[float] = deque(maxlen=64)
+        self.reset_recovery_ms: deque[float] = deque(maxlen=64)
         
         logger.info(f"VRStreamingServer initialized: {width}x{height} @ {fps} FPS")
         
@@ -309,7 +581,7 @@ class VRStreamingServer:
 
         # Encoder instances are not guaranteed thread-safe. If multiple clients connect, or if we
         # run capture/encode in a background thread, we must serialize access.
-        self._encode_lock = threading.Lock()
+        self._encode_lock = encode_lock if encode_lock is not None else threading.Lock()
     
     def start_server(self):
         """
@@ -361,6 +633,76 @@ class VRStreamingServer:
             self._server_thread.join(timeout=2.0)
             logger.info("VR streaming server stopped")
     
+    def set_hud(self, enabled: bool) -> None:
+        """Toggle the headset performance overlay; each client is told before its next frame."""
+        self.hud_enabled = bool(enabled)
+
+    def _encoder_profile(self) -> EncoderProfile:
+        """Per-client encoder configuration (read at connect time: target size may change after init)."""
+        return EncoderProfile(
+            self.encoder_type,
+            int(self.target_width),
+            int(self.target_height),
+            fps=int(self.fps),
+            quality=int(getattr(self, "quality", 25) or 25),
+            bitrate=int(getattr(self, "bitrate", 50_000_000) or 50_000_000),
+            scene_cuts=self.scene_hints is not None and self.encoder_type in (EncoderType.NVENC, EncoderType.HEVC),
+            codec_name=self.hevc_codec,
+        )
+
+    def _client_stream(self, address: tuple) -> Tuple[EncoderProfile, bytes, bool]:
+        """(encoder profile, protocol magic, hevc) for a connecting client.
+
+        HEVC servers only send HEVC to headsets that advertised it in their discovery
+        HELLO; anything else (older clients, manual connections) gets the matching H.264
+        encoder on the usual VRH3/VRH4 protocol.
+        """
+        profile = self._encoder_profile()
+        if self.encoder_type != EncoderType.HEVC:
+            return profile, self.protocol_magic, False
+        codecs = headset_codecs(str(address[0]))
+        if codecs is not None and "hevc" in codecs:
+            return profile, b"VRH4", True
+        fallback = self._h264_fallback(profile)
+        logger.warning(
+            "%s did not advertise an HEVC decoder; streaming H.264 (%s) on %s",
+            address[0],
+            fallback.codec_name,
+            self.protocol_magic.decode("ascii"),
+        )
+        return fallback, self.protocol_magic, False
+
+    def _h264_fallback(self, profile: EncoderProfile) -> EncoderProfile:
+        """The H.264 encoder that stands in for an HEVC profile."""
+        codec = "h264_nvenc" if self.hevc_codec == "hevc_nvenc" else "libx264"
+        return replace(profile, encoder_type=EncoderType.NVENC, codec_name=codec)
+
+    def _multicast_profile(self) -> EncoderProfile:
+        """Encoder of the shared multicast stream.
+
+        Every headset in the group decodes the same bytes and one may join later without
+        an HEVC decoder, so HEVC servers multicast H.264.
+        """
+        profile = self._encoder_profile()
+        return self._h264_fallback(profile) if self.encoder_type == EncoderType.HEVC else profile
+
+    def startup_stats(self) -> dict:
+        """Connect-to-first-frame and reset recovery times (ms) plus encoder pool counters."""
+
+        def _summary(samples) -> dict:
+            samples = list(samples)
+            return {
+                "count": len(samples),
+                "avg": round(sum(samples) / len(samples), 3) if samples else 0.0,
+                "max": round(max(samples), 3) if samples else 0.0,
+            }
+
+        return {
+            "first_frame_ms": _summary(self.first_frame_ms),
+            "reset_recovery_ms": _summary(self.reset_recovery_ms),
+            "encoder_pool": self.encoder_pool.stats(),
+        }
+
     def create_packet(
         self,
         left_frame: bytes,
@@ -368,14 +710,18 @@ class VRStreamingServer:
         frame_id: int,
         protocol_magic: Optional[bytes] = None,
         fps_milli: Optional[int] = None,
+        hevc: bool = False,
     ) -> bytes:
         """
         Create network packet with stereo frames
         
         Packet format (ALL PROTOCOLS):
         - Packet size (4 bytes, big-endian int)
-        - Header (VRHP/VRH2 = 16 bytes): magic(4) + frame_id(4) + left_size(4) + right_size(4)
+        - Header (VRHP/VRH2/VRHT = 16 bytes): magic(4) + frame_id(4) + left_size(4) + right_size(4)
         - Header (VRH3 = 20 bytes): magic(4) + frame_id(4) + left_size(4) + right_size(4) + fps_milli(4)
+        - Header (VRH4 = 32 bytes): VRH3 fields + flags(4) + crc_left(4) + crc_right(4)
+          (CRCs are CRC32C of each eye payload when flags has VRH4_FLAG_CRC32C, else 0;
+          VRH4_FLAG_HEVC marks HEVC access units)
         - Left eye frame data
         - Right eye frame data (optional; right_size may be 0 to indicate "reuse left")
         
@@ -387,24 +733,18 @@ class VRStreamingServer:
         Returns:
             Complete packet as bytes
         """
-        left_size = len(left_frame)
-        right_size = len(right_frame)
-
         magic = self.protocol_magic if protocol_magic is None else protocol_magic
-        if magic == b"VRH3":
-            # fps_milli is required for VRH3; fall back to server fps if missing.
-            fps_milli_eff = int(fps_milli) if fps_milli is not None else int(float(getattr(self, "fps", 30) or 30) * 1000.0)
-            header = struct.pack('!4sIIII', magic, frame_id, left_size, right_size, fps_milli_eff)
-        else:
-            header = struct.pack('!4sIII', magic, frame_id, left_size, right_size)
-        
-        # Combine header + frames
-        packet_data = header + left_frame + right_frame
-        
-        # Prepend packet size (ALL protocols need this for the Android client)
-        packet_size = len(packet_data)
-        size_header = struct.pack('!I', packet_size)
-        return size_header + packet_data
+        # fps_milli is required for VRH3; fall back to server fps if missing.
+        fps_milli_eff = int(fps_milli) if fps_milli is not None else int(float(getattr(self, "fps", 30) or 30) * 1000.0)
+        return build_packet(
+            magic,
+            left_frame,
+            right_frame,
+            frame_id,
+            fps_milli=fps_milli_eff,
+            payload_crc=bool(getattr(self, "payload_crc", False)),
+            hevc=hevc,
+        )
     
     async def handle_client(self, client_socket: socket.socket, address: tuple):
         """
@@ -415,14 +755,25 @@ class VRStreamingServer:
             address: Client address tuple
         """
         logger.info(f"🎯 Client connected from {address}")
+        connected_at = time.perf_counter()
 
         # IMPORTANT: Use a fresh encoder per client.
         # If we reuse the encoder across connections, a newly connected client can start mid-GOP
         # (receiving P-frames that reference pictures it never saw), which looks like heavy mosaic
         # until the next IDR. A per-client encoder ensures the first access units are decodable.
+        # The pool only hands back encoders whose reset() restored them (never H.264 sessions).
         client_encoder: Optional[FrameEncoder] = None
-        dump_fp: Optional[object] = None
+        encoder_profile, protocol_magic, hevc = self._client_stream(address)
+        dump_writer: Optional[FrameDumpWriter] = None
+        dump_handle: Optional[int] = None
         dump_started: bool = False
+        recorder: Optional[StreamRecorder] = None
+        pacer: Optional[FramePacer] = None
+        client_id = f"{address[0]}:{address[1]}"
+        protocol_name = protocol_magic.decode() + ("/HEVC" if hevc else "")
+        telemetry = _streaming_telemetry()
+        if telemetry is not None:
+            telemetry.set_connected(client_id, True, address=str(address[0]), protocol=protocol_name)
 
         def _env_truthy(name: str) -> bool:
             v = os.environ.get(name)
@@ -459,11 +810,14 @@ class VRStreamingServer:
 
         frame_log = _env_truthy_default("MESMERGLASS_VRH2_FRAME_LOG", False)
 
-        # Optional debugging: dump raw pre-encode frames to PNG. This decisively answers whether
+        # Optional debugging: dump raw pre-encode frames. This decisively answers whether
         # corruption exists before encoding (capture/compositor/race) or only after encoding.
+        # Written by a FrameDumpWriter thread (.vrraw, LZ4/zlib; "png" for images) so the
+        # producer never waits on disk; frames are dropped and counted when it falls behind.
         raw_dump_dir_env = (os.environ.get("MESMERGLASS_VRH2_RAW_DUMP_DIR") or "").strip()
         raw_dump_every = _env_int("MESMERGLASS_VRH2_RAW_DUMP_EVERY", 0)
         raw_dump_max = _env_int("MESMERGLASS_VRH2_RAW_DUMP_MAX", 0)
+        raw_dump_format = (os.environ.get("MESMERGLASS_VRH2_RAW_DUMP_FORMAT") or "lz4").strip().lower()
         deep_copy_input = _env_truthy_default("MESMERGLASS_VRH2_DEEPCOPY_INPUT", False)
 
         if (
@@ -487,11 +841,13 @@ class VRStreamingServer:
                 if not raw_dump_dir.is_absolute():
                     raw_dump_dir = Path.cwd() / raw_dump_dir
                 raw_dump_dir.mkdir(parents=True, exist_ok=True)
+                dump_writer = FrameDumpWriter(raw_format=raw_dump_format, name="vrh2-dump")
                 logger.warning(
-                    "[vrh2-raw] enabled: dir=%s every=%d max=%s deep_copy=%s",
+                    "[vrh2-raw] enabled: dir=%s every=%d max=%s format=%s deep_copy=%s",
                     str(raw_dump_dir),
                     raw_dump_every,
                     (raw_dump_max if raw_dump_max > 0 else ""),
+                    dump_writer.raw_format,
                     ("1" if deep_copy_input else "0"),
                 )
             except Exception as e:
@@ -512,190 +868,6 @@ class VRStreamingServer:
         reset_cooldown_frames = max(0, _env_int("MESMERGLASS_VRH2_RESET_COOLDOWN_FRAMES", 120))
         strip_sei = _env_truthy("MESMERGLASS_VRH2_STRIP_SEI")
 
-        def _iter_annexb_nals(data: bytes):
-            # Yield (nal_type, nal_payload_size) for Annex-B streams.
-            if not data:
-                return
-            n = len(data)
-            starts = []
-            i = 0
-            while i + 3 < n:
-                if data[i] == 0 and data[i + 1] == 0:
-                    if data[i + 2] == 1:
-                        starts.append((i, 3))
-                        i += 3
-                        continue
-                    if i + 4 < n and data[i + 2] == 0 and data[i + 3] == 1:
-                        starts.append((i, 4))
-                        i += 4
-                        continue
-                i += 1
-
-            for idx, (pos, start_len) in enumerate(starts):
-                hdr = pos + start_len
-                if hdr >= n:
-                    continue
-                nxt = starts[idx + 1][0] if idx + 1 < len(starts) else n
-                nal_type = data[hdr] & 0x1F
-                payload_size = max(0, nxt - hdr)
-                yield nal_type, payload_size
-
-        def _iter_annexb_nal_units(data: bytes):
-            # Yield (nal_type, nal_unit_bytes_without_start_code) for Annex-B streams.
-            if not data:
-                return
-            n = len(data)
-            starts = []
-            i = 0
-            while i + 3 < n:
-                if data[i] == 0 and data[i + 1] == 0:
-                    if data[i + 2] == 1:
-                        starts.append((i, 3))
-                        i += 3
-                        continue
-                    if i + 4 < n and data[i + 2] == 0 and data[i + 3] == 1:
-                        starts.append((i, 4))
-                        i += 4
-                        continue
-                i += 1
-
-            for idx, (pos, start_len) in enumerate(starts):
-                hdr = pos + start_len
-                if hdr >= n:
-                    continue
-                nxt = starts[idx + 1][0] if idx + 1 < len(starts) else n
-                unit = data[hdr:nxt]
-                if not unit:
-                    continue
-                nal_type = unit[0] & 0x1F
-                yield nal_type, unit
-
-        def _h264_ebsp_to_rbsp(ebsp: bytes) -> bytes:
-            # Remove emulation-prevention bytes (0x03 after 0x0000) per H.264 spec.
-            if not ebsp:
-                return ebsp
-            out = bytearray()
-            zeros = 0
-            for b in ebsp:
-                if zeros >= 2 and b == 0x03:
-                    zeros = 0
-                    continue
-                out.append(b)
-                if b == 0:
-                    zeros += 1
-                else:
-                    zeros = 0
-            return bytes(out)
-
-        class _BitReader:
-            __slots__ = ("_data", "_bitpos", "_n")
-
-            def __init__(self, data: bytes):
-                self._data = data
-                self._bitpos = 0
-                self._n = len(data) * 8
-
-            def _read_bit(self) -> int:
-                if self._bitpos >= self._n:
-                    raise EOFError()
-                byte_i = self._bitpos >> 3
-                bit_i = 7 - (self._bitpos & 7)
-                self._bitpos += 1
-                return (self._data[byte_i] >> bit_i) & 1
-
-            def read_bits(self, nbits: int) -> int:
-                v = 0
-                for _ in range(nbits):
-                    v = (v << 1) | self._read_bit()
-                return v
-
-            def read_ue(self) -> int:
-                # Unsigned Exp-Golomb.
-                zeros = 0
-                while True:
-                    bit = self._read_bit()
-                    if bit == 0:
-                        zeros += 1
-                        if zeros > 31:
-                            raise ValueError("UE too large")
-                    else:
-                        break
-                if zeros == 0:
-                    return 0
-                return (1 << zeros) - 1 + self.read_bits(zeros)
-
-        def _h264_slice_header_brief(nal_unit: bytes):
-            # Best-effort parse of the first few fields in slice header:
-            # first_mb_in_slice (ue), slice_type (ue), pic_parameter_set_id (ue)
-            # We do NOT attempt full parsing (needs SPS/PPS).
-            try:
-                if not nal_unit or len(nal_unit) < 2:
-                    return None
-                nal_type = nal_unit[0] & 0x1F
-                if nal_type not in (1, 5):
-                    return None
-                rbsp = _h264_ebsp_to_rbsp(nal_unit[1:])
-                br = _BitReader(rbsp)
-                first_mb = br.read_ue()
-                slice_type = br.read_ue()
-                pps_id = br.read_ue()
-                return (first_mb, slice_type, pps_id)
-            except Exception:
-                return None
-
-        def _h264_insert_aud_if_missing(data: bytes) -> bytes:
-            # Access Unit Delimiter NAL (type 9) with primary_pic_type=7 (111) + rbsp_trailing_bits.
-            # Common byte pattern: 00 00 00 01 09 F0
-            if not data:
-                return data
-
-            # If stream doesn't look Annex-B, don't touch it.
-            if not (data.startswith(b"\x00\x00\x01") or data.startswith(b"\x00\x00\x00\x01")):
-                return data
-
-            # If first NAL is already an AUD, don't double-insert.
-            for nal_type, _sz in _iter_annexb_nals(data):
-                return data if nal_type == 9 else (b"\x00\x00\x00\x01\x09\xF0" + data)
-            return data
-
-        def _h264_strip_sei_nals(data: bytes) -> bytes:
-            # Remove SEI (nal type 6) NAL units from Annex-B. Best-effort.
-            if not data:
-                return data
-            if not (data.startswith(b"\x00\x00\x01") or data.startswith(b"\x00\x00\x00\x01")):
-                return data
-
-            n = len(data)
-            starts = []
-            i = 0
-            while i + 3 < n:
-                if data[i] == 0 and data[i + 1] == 0:
-                    if data[i + 2] == 1:
-                        starts.append((i, 3))
-                        i += 3
-                        continue
-                    if i + 4 < n and data[i + 2] == 0 and data[i + 3] == 1:
-                        starts.append((i, 4))
-                        i += 4
-                        continue
-                i += 1
-
-            if not starts:
-                return data
-
-            out = bytearray()
-            for idx, (pos, start_len) in enumerate(starts):
-                hdr = pos + start_len
-                if hdr >= n:
-                    continue
-                nxt = starts[idx + 1][0] if idx + 1 < len(starts) else n
-                nal_type = data[hdr] & 0x1F
-                if nal_type == 6:
-                    continue
-                out += data[pos:nxt]
-
-            return bytes(out) if out else data
-
         def _maybe_log_nal_diag(label: str, frame_id: int, data: bytes) -> None:
             if not nal_diag_mode:
                 return
@@ -703,9 +875,10 @@ class VRStreamingServer:
             total = len(data)
             nal_types = []
             has_key = False
-            for t, _sz in _iter_annexb_nals(data):
+            key_types = (19, 20, 21, 32, 33, 34) if hevc else (5, 7, 8)
+            for t, _sz in iter_annexb_nals(data, hevc):
                 nal_types.append(t)
-                if t in (5, 7, 8):
+                if t in key_types:
                     has_key = True
 
             if not nal_types:
@@ -723,12 +896,18 @@ class VRStreamingServer:
                 # Stable ordering for readability.
                 ordered = " ".join([f"{k}:{counts[k]}" for k in sorted(counts.keys())])
 
-                # For slice NALs, try to log first_mb_in_slice / slice_type / pps_id.
+                # For slice NALs, try to log first_mb_in_slice / slice_type / pps_id
+                # (HEVC: first_slice_segment_in_pic_flag / pps_id).
                 slice_briefs = []
                 try:
-                    for t, unit in _iter_annexb_nal_units(data):
-                        if t in (1, 5):
-                            brief = _h264_slice_header_brief(unit)
+                    for t, unit in iter_annexb_nal_units(data, hevc):
+                        if hevc:
+                            if t <= HEVC_NAL_CRA:
+                                hbrief = hevc_slice_brief(unit)
+                                if hbrief is not None:
+                                    slice_briefs.append(f"{t}@first{hbrief[0]}:pps{hbrief[1]}")
+                        elif t in (1, 5):
+                            brief = h264_slice_header_brief(unit)
                             if brief is not None:
                                 first_mb, slice_type, pps_id = brief
                                 slice_briefs.append(f"{t}@mb{first_mb}:st{slice_type}:pps{pps_id}")
@@ -746,46 +925,8 @@ class VRStreamingServer:
                     slices_str,
                 )
 
-        def _h264_access_unit_contains_idr(data: bytes) -> bool:
-            # Annex-B scan for IDR slices (NAL type 5).
-            if not data:
-                return False
-            n = len(data)
-            i = 0
-            while i + 4 < n:
-                if data[i] == 0 and data[i + 1] == 0:
-                    start_len = 0
-                    if data[i + 2] == 1:
-                        start_len = 3
-                    elif data[i + 2] == 0 and data[i + 3] == 1:
-                        start_len = 4
-                    if start_len:
-                        hdr = i + start_len
-                        if hdr < n:
-                            nal_type = data[hdr] & 0x1F
-                            if nal_type == 5:
-                                return True
-                        i = hdr + 1
-                        continue
-                i += 1
-            return False
-        
         try:
-            if self.encoder_type == EncoderType.NVENC:
-                client_encoder = create_encoder(
-                    EncoderType.NVENC,
-                    width=self.target_width,
-                    height=self.target_height,
-                    fps=self.fps,
-                    bitrate=int(getattr(self, "bitrate", 50_000_000) or 50_000_000),
-                )
-            else:
-                client_encoder = create_encoder(
-                    EncoderType.JPEG,
-                    width=self.target_width,
-                    height=self.target_height,
-                    quality=int(getattr(self, "quality", 25) or 25),
-                )
+            client_encoder = self.encoder_pool.checkout(encoder_profile)
 
             # Producer thread continuously refreshes the *latest* encoded frame.
             # The send loop runs at a steady tick and re-sends the latest encoded bytes when the
@@ -797,6 +938,8 @@ class VRStreamingServer:
             latest_left: Optional[bytes] = None
             latest_right: Optional[bytes] = None
             latest_generation: int = 0
+            latest_tick: int = 0  # timeline tick of the latest frame (motion-adaptive rate)
+            latest_queued_at: float = 0.0  # perf_counter when the producer published it (recording)
             last_left_kb: float = 0.0
             last_right_kb: float = 0.0
             last_encode_s: float = 0.0
@@ -808,53 +951,50 @@ class VRStreamingServer:
             producer_warn_count = 0
 
             reset_encoder_requested = threading.Event()
-
-            def _recreate_client_encoder() -> Optional[FrameEncoder]:
-                # Create a new encoder instance with the same configuration.
-                try:
-                    if self.encoder_type == EncoderType.NVENC:
-                        return create_encoder(
-                            EncoderType.NVENC,
-                            width=self.target_width,
-                            height=self.target_height,
-                            fps=self.fps,
-                            bitrate=int(getattr(self, "bitrate", 50_000_000) or 50_000_000),
-                        )
-                    return create_encoder(
-                        EncoderType.JPEG,
-                        width=self.target_width,
-                        height=self.target_height,
-                        quality=int(getattr(self, "quality", 25) or 25),
-                    )
-                except Exception as e:
-                    logger.warning("[vrh2-reset] Failed to recreate encoder: %s", e)
-                    return None
+            # Cuts published before this client connected are covered by its first IDR.
+            scene_seq = self.scene_hints.seq if self.scene_hints is not None else 0
+            # Motion-adaptive: the producer captures only on the ticks the content needs.
+            motion_rate = MotionRate(self.fps, self.scene_hints) if self.adaptive_fps else None
 
             def _producer_loop():
-                nonlocal latest_left, latest_right, latest_generation, last_left_kb, last_right_kb, last_encode_s, produced_frames, last_producer_warn, producer_warn_count, client_encoder
+                nonlocal latest_left, latest_right, latest_generation, latest_tick, latest_queued_at, last_left_kb, last_right_kb, last_encode_s, produced_frames, last_producer_warn, producer_warn_count, client_encoder, scene_seq
                 raw_dump_count = 0
-                raw_dump_fail_count = 0
+                raw_dump_drop_count = 0
+                timeline = FixedTimeline(self.fps)
+                first_tick: Optional[float] = None
+                tick_index = 0
                 while self.running and (not stop_producer.is_set()):
                     try:
+                        if motion_rate is not None:
+                            tick = timeline.next_tick(time.perf_counter())
+                            sleep_until(tick)
+                            first_tick = tick if first_tick is None else first_tick
+                            tick_index = int(round((tick - first_tick) / timeline.period))
+                            if not motion_rate.due(tick_index, tick):
+                                continue
+
                         if reset_encoder_requested.is_set():
-                            # Reset encoder under the encode lock to avoid concurrent usage.
+                            # Swap in a warm encoder under the encode lock to avoid concurrent usage.
+                            # The old one goes back to the pool, which closes it off this thread.
                             reset_encoder_requested.clear()
                             with self._encode_lock:
                                 try:
-                                    if client_encoder is not None:
-                                        client_encoder.close()
+                                    new_enc = self.encoder_pool.checkout(encoder_profile)
                                 except Exception as e:
-                                    # Only log when raw dumping is enabled, to avoid noise.
-                                    logger.warning("[vrh2-raw] write failed: %s", e)
-                                new_enc = _recreate_client_encoder()
+                                    new_enc = None
+                                    logger.warning("[vrh2-reset] Failed to recreate encoder: %s", e)
                                 if new_enc is not None:
-                                    client_encoder = new_enc
+                                    old_enc, client_encoder = client_encoder, new_enc
+                                    self.encoder_pool.checkin(encoder_profile, old_enc)
                                     logger.warning("[vrh2-reset] Encoder recreated")
 
                         if self.frame_callback is None:
                             frame = self._generate_test_frame()
                         else:
                             frame = self.frame_callback()
+                        rendered_at = None
+                        if isinstance(frame, tuple):
+                            frame, rendered_at = frame
 
                         # Ensure the encoder sees a stable, contiguous RGB buffer. If the producer
                         # returns a reused buffer that can be modified concurrently, enabling
@@ -865,47 +1005,22 @@ class VRStreamingServer:
                         try:
                             frame = np.ascontiguousarray(frame)
                             if deep_copy_input:
-                                frame = frame.copy()
+                                frame = frame_buffers.copy(frame)
                         except Exception:
                             time.sleep(0.005)
                             continue
 
-                        # Optional: write raw frames to disk for forensics.
-                        if raw_dump_dir is not None and raw_dump_every > 0:
+                        # Optional: queue raw frames for the dump writer (never blocks).
+                        if raw_dump_dir is not None and raw_dump_every > 0 and dump_writer is not None and frame is not None:
                             if (produced_frames % raw_dump_every) == 0 and (raw_dump_max <= 0 or raw_dump_count < raw_dump_max):
-                                try:
-                                    ts = datetime.datetime.now().strftime("%Y%m%d_%H%M%S_%f")
-                                    crc = zlib.crc32(frame.tobytes()) & 0xFFFFFFFF
-                                    out_path = raw_dump_dir / f"vrh2_raw_{produced_frames:06d}_{ts}_crc{crc:08x}.png"
-                                    # Keep a .png extension so OpenCV can select an encoder.
-                                    tmp_path = raw_dump_dir / f".{out_path.stem}.tmp.png"
-                                    # Frame is documented as RGB; OpenCV expects BGR.
-                                    bgr = frame[:, :, ::-1] if (frame.ndim == 3 and frame.shape[2] == 3) else frame
-                                    ok = cv2.imwrite(str(tmp_path), bgr)
-                                    if not ok:
-                                        raise RuntimeError("cv2.imwrite returned False")
-                                    try:
-                                        os.replace(str(tmp_path), str(out_path))
-                                    except Exception:
-                                        # Best-effort fallback.
-                                        try:
-                                            if not out_path.exists():
-                                                os.rename(str(tmp_path), str(out_path))
-                                        except Exception:
-                                            pass
+                                ts = datetime.datetime.now().strftime("%Y%m%d_%H%M%S_%f")
+                                if dump_writer.submit_frame(raw_dump_dir / f"vrh2_raw_{produced_frames:06d}_{ts}", frame):
                                     raw_dump_count += 1
-                                    logger.info(
-                                        "[vrh2-raw] wrote gen=%d path=%s crc=%08x shape=%s",
-                                        produced_frames,
-                                        str(out_path),
-                                        crc,
-                                        str(getattr(frame, "shape", "")),
-                                    )
-                                except Exception as e:
-                                    raw_dump_fail_count += 1
-                                    # Don't spam: log the first few failures then sample.
-                                    if raw_dump_fail_count <= 3 or (produced_frames % 60) == 0:
-                                        logger.warning("[vrh2-raw] write failed gen=%d dir=%s: %s", produced_frames, str(raw_dump_dir), e)
+                                else:
+                                    raw_dump_drop_count += 1
+                                    # Don't spam: log the first few drops then sample.
+                                    if raw_dump_drop_count <= 3 or (produced_frames % 60) == 0:
+                                        logger.warning("[vrh2-raw] writer behind; dropped gen=%d (total %d)", produced_frames, dump_writer.dropped)
 
                         if frame is None:
                             producer_warn_count += 1
@@ -922,12 +1037,24 @@ class VRStreamingServer:
 
                         # Downscale to target resolution if needed (for Oculus Go optimization)
                         if frame.shape[1] != self.target_width or frame.shape[0] != self.target_height:
+                            resized = frame_buffers.acquire((self.target_height, self.target_width) + frame.shape[2:], frame.dtype)
                             frame = cv2.resize(
                                 frame,
                                 (self.target_width, self.target_height),
+                                dst=resized,
                                 interpolation=cv2.INTER_LINEAR,
                             )
 
+                        # Key the first frame that shows a session cut instead of coding the cut as a P-frame.
+                        if self.scene_hints is not None and protocol_magic in H264_PROTOCOLS:
+                            cut = self.scene_hints.cut_for_frame(
+                                scene_seq, rendered_at if rendered_at is not None else time.perf_counter()
+                            )
+                            if cut is not None:
+                                scene_seq = cut.seq
+                                client_encoder.request_idr()
+                                self.scene_cut_idrs += 1
+
                         encode_start = time.time()
                         # Serialize GPU encode by default; multiple encoders can exist if multiple
                         # clients connect, but not all systems handle parallel NVENC sessions well.
@@ -949,12 +1076,17 @@ class VRStreamingServer:
                             time.sleep(0.005)
                             continue
 
+                        if motion_rate is not None:
+                            motion_rate.sent(tick_index, frame)
+
                         with latest_lock:
                             latest_left = left_encoded
                             latest_right = right_encoded
                             last_left_kb = len(left_encoded) / 1024.0
                             last_right_kb = len(right_encoded) / 1024.0
                             latest_generation += 1
+                            latest_tick = tick_index
+                            latest_queued_at = time.perf_counter()
                             produced_frames += 1
                             latest_ready.set()
 
@@ -976,7 +1108,8 @@ class VRStreamingServer:
             #   $env:MESMERGLASS_VRH2_DUMP_DIR = "C:\\temp"
             #   $env:MESMERGLASS_VRH2_DUMP_START = "idr"   # (default) or "immediate"
             #
-            # The dump is a raw elementary stream (.h264) and is written per client connection.
+            # The dump is a raw elementary stream (.h264, or .h265 for HEVC clients) and is
+            # written per client connection.
             dump_dir_raw = os.environ.get("MESMERGLASS_VRH2_DUMP_DIR")
             dump_start_mode = (os.environ.get("MESMERGLASS_VRH2_DUMP_START") or "idr").strip().lower()
 
@@ -995,50 +1128,78 @@ class VRStreamingServer:
                     candidate = Path(token)
                     dump_dir = candidate if candidate.is_absolute() else (Path.cwd() / candidate)
 
-            if dump_enabled and dump_dir is not None and self.protocol_magic in {b"VRH2", b"VRH3"}:
+            if dump_enabled and dump_dir is not None and protocol_magic in H264_PROTOCOLS:
                 try:
                     dump_dir.mkdir(parents=True, exist_ok=True)
                     ts = datetime.datetime.now().strftime("%Y%m%d_%H%M%S")
                     safe_host = str(address[0]).replace(":", "_").replace(".", "-")
                     safe_port = str(address[1])
-                    out_path = dump_dir / f"vrh2_{safe_host}_{safe_port}_{ts}.h264"
-                    dump_fp = open(out_path, "wb")
+                    out_path = dump_dir / f"vrh2_{safe_host}_{safe_port}_{ts}.{'h265' if hevc else 'h264'}"
+                    if dump_writer is None:
+                        dump_writer = FrameDumpWriter(name="vrh2-dump")
+                    dump_handle = dump_writer.open_stream(out_path)
                     dump_started = (dump_start_mode != "idr")
                     logger.warning(
-                        "[vrh2-dump] Writing raw H.264 to %s (start=%s)",
+                        "[vrh2-dump] Writing raw %s to %s (start=%s)",
+                        "HEVC" if hevc else "H.264",
                         str(out_path),
                         "immediate" if dump_started else "idr",
                     )
                 except Exception as e:
-                    dump_fp = None
+                    dump_handle = None
                     logger.warning("[vrh2-dump] Failed to open dump file in %s: %s", str(dump_dir), e)
 
+            # Optional: record the outgoing left-eye stream as fragmented MP4 (remux only).
+            if self.record_path and protocol_magic in H264_PROTOCOLS and not hevc:
+                try:
+                    recorder = StreamRecorder(self._resolve_record_path(address), fps=self.fps)
+                    logger.warning("[vrh2-rec] Recording stream to %s", str(recorder.path))
+                except Exception as e:
+                    recorder = None
+                    logger.warning("[vrh2-rec] Failed to start recording (%s): %s", self.record_path, e)
+            elif self.record_path:
+                logger.warning("[vrh2-rec] Recording needs an H.264 stream; ignored for %s", protocol_name)
+
             # Optional: allow the receiver to request a keyframe over the same TCP socket.
             # This is far more reliable than guessing corruption from access-unit byte size.
-            # Protocol: client may send 1-byte control messages at any time.
+            # Protocol: client may send control messages at any time (see asset_cache.ControlParser).
             #   0x01 => NEED_IDR
+            #   0x02 => ASSET_HAVE, 0x03 => ASSET_NEED (asset cache only)
             enable_control = _env_truthy_default("MESMERGLASS_VRH2_CONTROL", False)
 
             need_idr_from_client = False
             last_client_need_idr_at = 0.0
 
+            # Headset asset cache: frame payloads are whole JPEG/ETC2 images, so a recurring
+            # frame can be shown by hash. H.264 access units depend on their references.
+            assets: Optional[AssetLedger] = None
+            if self.asset_cache and protocol_magic in (b"VRHP", b"VRHT"):
+                assets = AssetLedger(ASSET_FORMAT_TEXTURE if protocol_magic == b"VRHT" else ASSET_FORMAT_JPEG)
+
             async def _control_reader() -> None:
                 nonlocal need_idr_from_client, last_client_need_idr_at
-                # Keep reads tiny; client messages are intentionally minimal.
+                # Keep reads small; client messages are intentionally minimal.
                 loop = asyncio.get_event_loop()
+                parser = ControlParser()
                 while self.running:
                     try:
-                        data = await loop.sock_recv(client_socket, 16)
+                        data = await loop.sock_recv(client_socket, 4096)
                         if not data:
                             return
-                        for b in data:
-                            if b == 0x01:
+                        for kind, value in parser.feed(data):
+                            if kind == "need_idr":
                                 now_s = time.time()
                                 # Rate-limit flagging to avoid log spam if client loops.
                                 if (now_s - last_client_need_idr_at) >= 0.10:
                                     need_idr_from_client = True
                                     last_client_need_idr_at = now_s
-                            # Unknown bytes are ignored for forward-compat.
+                            elif assets is not None and kind == "have":
+                                if not assets.enabled:
+                                    logger.info("[assets] headset cache active (%d assets retained)", len(value))
+                                assets.have(value)
+                            elif assets is not None and kind == "need":
+                                assets.need(value)
+                            # Unknown messages are ignored for forward-compat.
                     except (ConnectionResetError, BrokenPipeError, OSError):
                         return
                     except asyncio.CancelledError:
@@ -1048,17 +1209,24 @@ class VRStreamingServer:
                         await asyncio.sleep(0.05)
 
             control_task: Optional[asyncio.Task] = None
-            if enable_control and self.protocol_magic in {b"VRH2", b"VRH3"}:
+            if (enable_control and protocol_magic in H264_PROTOCOLS) or assets is not None:
                 try:
                     control_task = asyncio.create_task(_control_reader())
                     logger.info("[vrh2-ctl] control channel enabled (client may send NEED_IDR)")
                 except Exception:
                     control_task = None
+            if assets is not None and control_task is not None:
+                try:
+                    await asyncio.get_event_loop().sock_sendall(client_socket, build_control_packet(CONTROL_ASSET_OFFER))
+                except OSError:
+                    pass
 
             frame_id = 0
-            next_frame_ts = time.perf_counter()
+            pacer = FramePacer(self.fps)
+            logger.info("[pacing] %s timeline at %.3f ms", pacer.mode, pacer.period * 1000.0)
             last_produced_at_log = 0
             last_sent_generation = 0
+            hud_sent = False  # clients start with the overlay off
 
             last_idr_at = None
 
@@ -1066,19 +1234,14 @@ class VRStreamingServer:
             last_idr_request_frame = -10_000
             last_reset_request_frame = -10_000
             need_idr_resync = False
+            reset_requested_at: Optional[float] = None
+            first_frame_sent = False
             
             while self.running:
-                # Maintain target FPS
-                now = time.perf_counter()
-                sleep_s = next_frame_ts - now
-                if sleep_s > 0:
-                    await asyncio.sleep(sleep_s)
-                else:
-                    # If we're behind, don't try to "catch up" by sending bursts.
-                    # Resync to avoid jitter/latency spikes.
-                    next_frame_ts = now
-
-                next_frame_ts += self.frame_delay
+                # Maintain target FPS on a fixed timeline. wait() returns just ahead of the tick
+                # and pacer.send() writes on it; missed ticks are skipped rather than sent as a
+                # burst (see frame_pacer).
+                tick = await pacer.wait()
 
                 # Wait for the producer to deliver at least one encoded frame.
                 if not latest_ready.is_set():
@@ -1091,6 +1254,8 @@ class VRStreamingServer:
                     left_kb = last_left_kb
                     right_kb = last_right_kb
                     gen = latest_generation
+                    frame_tick = latest_tick
+                    queued_at = latest_queued_at
 
                 if not left_encoded:
                     await asyncio.sleep(0.002)
@@ -1106,9 +1271,14 @@ class VRStreamingServer:
                 # Also optionally log NAL composition for tiny/key access units.
                 # IMPORTANT: do this only for frames we will actually send/dump, so diagnostics
                 # correlate with captured dumps and packet sequence numbers.
-                if self.protocol_magic in {b"VRH2", b"VRH3"}:
+                if protocol_magic in H264_PROTOCOLS:
                     # Receiver-driven keyframe request (preferred over size-based heuristics).
-                    if need_idr_from_client and hasattr(client_encoder, "request_idr"):
+                    # An IDR already on its way (e.g. a scene cut) answers it; one due within
+                    # SCENE_CUT_IDR_WINDOW_S is awaited rather than sending two IDRs back to back.
+                    if need_idr_from_client and access_unit_contains_idr(left_encoded, hevc):
+                        need_idr_from_client = False
+                    cut_due = self.scene_hints is not None and self.scene_hints.cut_due_within(SCENE_CUT_IDR_WINDOW_S)
+                    if need_idr_from_client and not cut_due and hasattr(client_encoder, "request_idr"):
                         if (frame_id - last_idr_request_frame) >= idr_cooldown_frames:
                             need_idr_from_client = False
                             last_idr_request_frame = frame_id
@@ -1118,20 +1288,16 @@ class VRStreamingServer:
                             except Exception:
                                 pass
 
-                    if insert_aud:
-                        left_encoded = _h264_insert_aud_if_missing(left_encoded)
+                    # H.264 only: x265 already writes AUDs, and HEVC SEI uses other NAL types.
+                    if (insert_aud or strip_sei) and not hevc:
+                        left_encoded = h264_rewrite_access_unit(left_encoded, insert_aud, strip_sei)
                         if right_encoded:
-                            right_encoded = _h264_insert_aud_if_missing(right_encoded)
-
-                    if strip_sei:
-                        left_encoded = _h264_strip_sei_nals(left_encoded)
-                        if right_encoded:
-                            right_encoded = _h264_strip_sei_nals(right_encoded)
+                            right_encoded = h264_rewrite_access_unit(right_encoded, insert_aud, strip_sei)
 
                     # Per-frame telemetry (opt-in): log AU size + IDR cadence.
                     if frame_log:
                         try:
-                            is_idr = _h264_access_unit_contains_idr(left_encoded)
+                            is_idr = access_unit_contains_idr(left_encoded, hevc)
                             now_idr_t = time.perf_counter()
                             if is_idr or (last_idr_at is None):
                                 if is_idr:
@@ -1174,6 +1340,7 @@ class VRStreamingServer:
                             if reset_on_anomaly and (frame_id - last_reset_request_frame) >= reset_cooldown_frames:
                                 last_reset_request_frame = frame_id
                                 need_idr_resync = True
+                                reset_requested_at = time.perf_counter()
                                 reset_encoder_requested.set()
                                 logger.warning(
                                     "[vrh2-reset] requested encoder reset (reason=%s frame=%d bytes=%d median=%s cooldown=%d)",
@@ -1183,7 +1350,11 @@ class VRStreamingServer:
                                     (int(median) if median is not None else ""),
                                     reset_cooldown_frames,
                                 )
-                            elif hasattr(client_encoder, "request_idr") and (frame_id - last_idr_request_frame) >= idr_cooldown_frames:
+                            elif (
+                                hasattr(client_encoder, "request_idr")
+                                and not cut_due
+                                and (frame_id - last_idr_request_frame) >= idr_cooldown_frames
+                            ):
                                 # Fallback: best-effort keyframe request.
                                 last_idr_request_frame = frame_id
                                 client_encoder.request_idr()
@@ -1199,41 +1370,69 @@ class VRStreamingServer:
                         pass
 
                 # If we're resyncing after a reset, drop frames until we see an IDR.
-                if need_idr_resync and self.protocol_magic in {b"VRH2", b"VRH3"}:
-                    if _h264_access_unit_contains_idr(left_encoded):
+                if need_idr_resync and protocol_magic in H264_PROTOCOLS:
+                    if access_unit_contains_idr(left_encoded, hevc):
                         need_idr_resync = False
-                        logger.warning("[vrh2-reset] IDR resync achieved at frame=%d", frame_id)
+                        recovery_ms = (time.perf_counter() - reset_requested_at) * 1000.0 if reset_requested_at else 0.0
+                        self.reset_recovery_ms.append(recovery_ms)
+                        logger.warning("[vrh2-reset] IDR resync achieved at frame=%d (%.1f ms after reset)", frame_id, recovery_ms)
                     else:
                         # Skip sending/dumping this access unit.
                         frame_id += 1
                         continue
 
-                # Dump access units to disk (left eye only). Optionally wait until first IDR.
-                if dump_fp is not None:
+                # Dump access units (left eye only) via the writer thread. Optionally wait until
+                # first IDR; after a dropped unit the dump resumes at the next IDR so it stays decodable.
+                if dump_handle is not None and dump_writer is not None:
                     try:
-                        if (not dump_started) and _h264_access_unit_contains_idr(left_encoded):
+                        if (not dump_started) and access_unit_contains_idr(left_encoded, hevc):
                             dump_started = True
-                        if dump_started:
-                            dump_fp.write(left_encoded)
-                            # Avoid excessive flush overhead; flush about once per second.
-                            if frame_id % 60 == 0:
-                                dump_fp.flush()
+                        if dump_started and not dump_writer.append(dump_handle, left_encoded):
+                            dump_started = False
+                            logger.warning("[vrh2-dump] writer behind; dropped frame=%d, resuming at next IDR", frame_id)
                     except Exception:
                         # Best-effort; never fail the stream due to debug dumping.
                         pass
+
+                if recorder is not None:
+                    try:
+                        recorder.write(left_encoded, queued_at)
+                    except Exception as e:
+                        logger.warning("[vrh2-rec] Recording stopped: %s", e)
+                        _close_off_loop(recorder.close)
+                        recorder = None
+                    else:
+                        if recorder.failed:
+                            _close_off_loop(recorder.close)
+                            recorder = None
                 
-                # Create packet
-                packet = self.create_packet(left_encoded, right_encoded, frame_id)
+                # Create packet (or the asset cache PUT/SHOW packets that replace it)
+                asset_packets = assets.route(left_encoded, right_encoded) if assets is not None else None
+                if asset_packets is not None:
+                    packet = b"".join(asset_packets)
+                else:
+                    # Adaptive rate: the header's frame id counts fps ticks, so the headset's
+                    # frameId * (1000 / fps_milli) PTS holds each frame for the ticks it covers.
+                    packet_id = frame_tick if motion_rate is not None else frame_id
+                    packet = self.create_packet(left_encoded, right_encoded, packet_id, protocol_magic=protocol_magic, hevc=hevc)
                 packet_size = len(packet)
                 self.total_bytes_sent += packet_size
                 
-                # Send packet (measure send time)
-                send_start = time.time()
+                # Send packet on the pacer's sender thread at the tick (measure send time)
+                send_start = time.perf_counter()
                 try:
                     loop = asyncio.get_event_loop()
-                    await loop.sock_sendall(client_socket, packet)
-                    send_time = time.time() - send_start
+                    if hud_sent != self.hud_enabled:
+                        hud_sent = self.hud_enabled
+                        await loop.sock_sendall(client_socket, build_control_packet(CONTROL_HUD, bytes([int(hud_sent)])))
+                    await pacer.send(client_socket, packet, tick)
+                    send_time = time.perf_counter() - max(send_start, tick)
                     self.send_times.append(send_time)
+                    if not first_frame_sent:
+                        first_frame_sent = True
+                        first_ms = (time.perf_counter() - connected_at) * 1000.0
+                        self.first_frame_ms.append(first_ms)
+                        logger.info("First frame to %s %.1f ms after connect", address, first_ms)
                     
                     frame_id += 1
                     self.frames_sent += 1
@@ -1266,7 +1465,46 @@ class VRStreamingServer:
                         logger.warning(f"   Latency: {total_latency_ms:.1f}ms (encode: {avg_encode_ms:.1f}ms, send: {avg_send_ms:.1f}ms)")
                         logger.warning(f"   Bandwidth: {bandwidth_mbps:.2f} Mbps")
                         logger.warning(f"   Frame size: {total_kb:.1f} KB (L: {left_kb:.1f} KB, R: {right_kb:.1f} KB)")
+                        jitter_avg_ms, jitter_max_ms = pacer.send_jitter_ms()
+                        logger.warning(
+                            f"   Send jitter: {jitter_avg_ms:.2f} ms avg, {jitter_max_ms:.2f} ms max "
+                            f"({pacer.mode}, {pacer.skipped} ticks skipped)"
+                        )
+                        if self.scene_hints is not None and protocol_magic in H264_PROTOCOLS:
+                            logger.warning(f"   Scene cuts: {self.scene_cut_idrs} keyframes placed on cuts")
+                        if motion_rate is not None:
+                            logger.warning(
+                                f"   Adaptive rate: {motion_rate.current_fps:.1f} fps now, "
+                                f"{motion_rate.average_fps():.1f} fps average of {self.fps}"
+                            )
+                        blockers = _perf_blockers()
+                        if blockers is not None:
+                            gc_info = blockers.gc_stats()
+                            pool = frame_buffers.stats()
+                            logger.warning(
+                                f"   Memory: frame pool {pool['hit_rate'] * 100:.0f}% reused | "
+                                f"GC {sum(gc_info['pauses'])} collections, worst {max(gc_info['max_ms']):.1f} ms "
+                                f"(gen2 {gc_info['pauses'][2]}x, {gc_info['max_ms'][2]:.1f} ms)"
+                            )
+                        if assets is not None and assets.enabled:
+                            logger.warning(
+                                f"   Assets: {assets.shows} shown, {assets.puts} sent, "
+                                f"{assets.misses_reported} evicted, {assets.bytes_saved / 1e6:.1f} MB saved"
+                            )
                         
+                        if telemetry is not None:
+                            telemetry.update_server_stats(
+                                client_id,
+                                send_fps=window_fps,
+                                produced_fps=produced_fps,
+                                encode_avg_ms=avg_encode_ms,
+                                send_avg_ms=avg_send_ms,
+                                bandwidth_mbps=bandwidth_mbps,
+                                frame_kb=total_kb,
+                                send_jitter_avg_ms=jitter_avg_ms,
+                                send_jitter_max_ms=jitter_max_ms,
+                            )
+
                         self.last_stats_time = current_time
                         
                         # Keep only last 120 measurements to avoid memory growth
@@ -1290,6 +1528,11 @@ class VRStreamingServer:
             except Exception:
                 pass
 
+            if pacer is not None:
+                pacer.close()
+            if telemetry is not None:
+                telemetry.set_connected(client_id, False)
+
             try:
                 stop_producer.set()
                 producer_thread.join(timeout=1.0)
@@ -1297,22 +1540,86 @@ class VRStreamingServer:
                 pass
 
             try:
-                if client_encoder is not None:
-                    client_encoder.close()
+                self.encoder_pool.checkin(encoder_profile, client_encoder)
             except Exception:
                 pass
 
-            try:
-                if dump_fp is not None:
-                    dump_fp.flush()
-                    dump_fp.close()
-            except Exception:
-                pass
+            if dump_writer is not None:
+                _close_off_loop(dump_writer.close)
+
+            if recorder is not None:
+                _close_off_loop(recorder.close)
 
             client_socket.close()
             if client_socket in self.clients:
                 self.clients.remove(client_socket)
     
+    async def _handle_multicast_client(self, client_socket: socket.socket, address: tuple):
+        """Multicast mode: the headset's TCP connection is its control channel only.
+
+        Sends JOIN (and HUD changes), then feeds NEED_IDR and REPAIR from the headset to
+        the shared producer. Frames go to the group from _multicast_loop.
+        """
+        logger.info(f"🎯 Client connected from {address} (multicast control)")
+        loop = asyncio.get_event_loop()
+        sender = self._multicast
+        client_id = f"{address[0]}:{address[1]}"
+        telemetry = _streaming_telemetry()
+        if telemetry is not None:
+            telemetry.set_connected(
+                client_id, True, address=str(address[0]), protocol=self.protocol_magic.decode() + "/multicast"
+            )
+        parser = ControlParser()
+        hud_sent = False
+        try:
+            await loop.sock_sendall(client_socket, build_control_packet(CONTROL_MULTICAST_JOIN, sender.join_args()))
+            # A headset joining mid-GOP waits for the next keyframe; ask for one now.
+            self._multicast_need_idr.set()
+            self._multicast_members.add(client_id)
+            while self.running:
+                if hud_sent != self.hud_enabled:
+                    hud_sent = self.hud_enabled
+                    await loop.sock_sendall(client_socket, build_control_packet(CONTROL_HUD, bytes([int(hud_sent)])))
+                try:
+                    data = await asyncio.wait_for(loop.sock_recv(client_socket, 4096), timeout=0.25)
+                except asyncio.TimeoutError:
+                    continue
+                if not data:
+                    break
+                for kind, value in parser.feed(data):
+                    if kind == "need_idr":
+                        self._multicast_need_idr.set()
+                    elif kind == "repair":
+                        # Parity encode + sendto stay off the loop every client shares.
+                        await loop.run_in_executor(None, sender.repair, *value)
+        except (BrokenPipeError, ConnectionResetError, OSError) as e:
+            logger.info("Client %s disconnected (%s)", address, e.__class__.__name__)
+        except asyncio.CancelledError:
+            pass
+        finally:
+            self._multicast_members.discard(client_id)
+            if telemetry is not None:
+                telemetry.set_connected(client_id, False)
+            client_socket.close()
+            if client_socket in self.clients:
+                self.clients.remove(client_socket)
+
+    def _resolve_record_path(self, address: tuple) -> Path:
+        """Output file for a client's recording; never overwrites an existing file."""
+        target = Path(str(self.record_path))
+        if not target.is_absolute():
+            target = Path.cwd() / target
+        if target.suffix.lower() != ".mp4":
+            ts = datetime.datetime.now().strftime("%Y%m%d_%H%M%S")
+            safe_host = str(address[0]).replace(":", "_").replace(".", "-")
+            target = target / f"vrh2_{safe_host}_{address[1]}_{ts}.mp4"
+        candidate = target
+        n = 1
+        while candidate.exists():
+            candidate = target.with_name(f"{target.stem}_{n}{target.suffix}")
+            n += 1
+        return candidate
+
     def _generate_test_frame(self) -> np.ndarray:
         """Generate test pattern frame"""
         # Simple checkerboard pattern
@@ -1331,6 +1638,133 @@ class VRStreamingServer:
         
         return frame
     
+    def _capture_frame(self) -> Optional[Tuple[np.ndarray, Optional[float]]]:
+        """Next source frame at the target size, with its paint time if the callback gives one."""
+        frame = self._generate_test_frame() if self.frame_callback is None else self.frame_callback()
+        rendered_at = None
+        if isinstance(frame, tuple):
+            frame, rendered_at = frame
+        if frame is None:
+            return None
+        frame = np.ascontiguousarray(frame)
+        if frame.shape[1] != self.target_width or frame.shape[0] != self.target_height:
+            resized = frame_buffers.acquire((self.target_height, self.target_width) + frame.shape[2:], frame.dtype)
+            frame = cv2.resize(frame, (self.target_width, self.target_height), dst=resized, interpolation=cv2.INTER_LINEAR)
+        return frame, rendered_at
+
+    def _multicast_loop(self) -> None:
+        """Multicast producer: one encode and one send per frame however many headsets joined.
+
+        Runs on the FramePacer timeline. The encoder is only held while a headset is
+        joined, so the first frame after an empty room is an IDR. Keyframe requests from
+        all headsets collapse into one, honour MESMERGLASS_VRH2_IDR_COOLDOWN_FRAMES and
+        wait for a scene cut that is about to key the stream anyway.
+        """
+        sender = self._multicast
+        profile = self._multicast_profile()
+        magic = self.protocol_magic
+        video = magic in H264_PROTOCOLS
+        try:
+            cooldown = max(0, int(os.environ.get("MESMERGLASS_VRH2_IDR_COOLDOWN_FRAMES", "15")))
+        except ValueError:
+            cooldown = 15
+        encoder: Optional[FrameEncoder] = None
+        timeline = FixedTimeline(self.fps)
+        motion_rate = MotionRate(self.fps, self.scene_hints) if self.adaptive_fps else None
+        first_tick: Optional[float] = None
+        scene_seq = 0
+        last_key_seq = -10_000
+        stats_at, stats_bytes = time.time(), 0
+        while self.running:
+            tick = timeline.next_tick(time.perf_counter())
+            sleep_until(tick)
+            first_tick = tick if first_tick is None else first_tick
+            tick_index = int(round((tick - first_tick) / timeline.period))
+            if not self._multicast_members:
+                if encoder is not None:
+                    self.encoder_pool.checkin(profile, encoder)
+                    encoder = None
+                continue
+            try:
+                if encoder is None:
+                    encoder = self.encoder_pool.checkout(profile)
+                    scene_seq = self.scene_hints.seq if self.scene_hints is not None else 0
+                    self._multicast_need_idr.clear()  # a fresh encoder opens with an IDR
+                if motion_rate is not None and not motion_rate.due(tick_index, tick):
+                    continue
+                captured = self._capture_frame()
+                if captured is None:
+                    continue
+                frame, rendered_at = captured
+                seq = sender.next_seq
+
+                if video:
+                    if self.scene_hints is not None:
+                        cut = self.scene_hints.cut_for_frame(
+                            scene_seq, rendered_at if rendered_at is not None else time.perf_counter()
+                        )
+                        if cut is not None:
+                            scene_seq = cut.seq
+                            encoder.request_idr()
+                            self.scene_cut_idrs += 1
+                    cut_due = self.scene_hints is not None and self.scene_hints.cut_due_within(SCENE_CUT_IDR_WINDOW_S)
+                    if self._multicast_need_idr.is_set() and not cut_due and seq - last_key_seq >= cooldown:
+                        self._multicast_need_idr.clear()
+                        encoder.request_idr()
+
+                encode_start = time.time()
+                with self._encode_lock:
+                    left_encoded, right_encoded = encode_stereo_frames(encoder, frame, self.stereo_offset)
+                self.encode_times.append(time.time() - encode_start)
+                if len(self.encode_times) > 120:
+                    self.encode_times = self.encode_times[-120:]
+                if self.stereo_offset == 0:
+                    right_encoded = b""
+                if not left_encoded:
+                    logger.error("Encoding failed")
+                    continue
+
+                keyframe = access_unit_contains_idr(left_encoded, False) if video else True
+                if keyframe:
+                    last_key_seq = seq
+                    self._multicast_need_idr.clear()
+                if motion_rate is not None:
+                    motion_rate.sent(tick_index, frame)
+                # Adaptive rate: frame ids count ticks (see motion_rate); the multicast seq stays dense.
+                packet = self.create_packet(
+                    left_encoded, right_encoded, tick_index if motion_rate is not None else seq, protocol_magic=magic
+                )
+                send_start = time.time()
+                sender.send_frame(packet, keyframe)
+                self.send_times.append(time.time() - send_start)
+                if len(self.send_times) > 120:
+                    self.send_times = self.send_times[-120:]
+                self.frames_sent += 1
+                self.total_bytes_sent += len(packet)
+
+                if self.frames_sent % 60 == 0:
+                    now = time.time()
+                    stats = sender.stats()
+                    window = max(1e-6, now - stats_at)
+                    logger.warning(
+                        f"📊 Multicast {stats['group']}: {len(self._multicast_members)} headsets | "
+                        f"{(stats['bytes'] - stats_bytes) * 8 / window / 1e6:.2f} Mbps on air "
+                        f"({stats['overhead'] * 100:.0f}% FEC + repair) | repairs: {stats['repairs_sent']} shards for "
+                        f"{stats['repair_requests']} requests ({stats['repairs_absorbed']} absorbed)"
+                    )
+                    stats_at, stats_bytes = now, stats["bytes"]
+            except Exception as e:
+                logger.error("Multicast producer error: %s", e, exc_info=True)
+                time.sleep(0.05)
+        if encoder is not None:
+            self.encoder_pool.checkin(profile, encoder)
+
+    def multicast_stats(self) -> Optional[dict]:
+        """Sender counters plus the joined headset count, or None outside multicast mode."""
+        if self._multicast is None:
+            return None
+        return dict(self._multicast.stats(), headsets=len(self._multicast_members))
+
     async def start(self):
         """Start the VR streaming server"""
         if self.running:
@@ -1340,8 +1774,21 @@ class VRStreamingServer:
         self.running = True
         
         # Start discovery service
-        self.discovery_service = DiscoveryService(self.discovery_port, self.port)
-        self.discovery_service.start()
+        if self.discovery_port is not None:
+            self.discovery_service = DiscoveryService(self.discovery_port, self.port)
+            self.discovery_service.start()
+
+        # Build the first client's encoder while we wait for it to connect.
+        self.encoder_pool.prewarm(self._encoder_profile() if self.multicast is None else self._multicast_profile())
+        if self.multicast is not None:
+            group, group_port = self.multicast
+            self._multicast = MulticastSender(group, group_port, interface=self.multicast_interface)
+            self._multicast_thread = threading.Thread(target=self._multicast_loop, name="vr-multicast", daemon=True)
+            self._multicast_thread.start()
+        # Attribute any GC pauses that still land on the frame path.
+        blockers = _perf_blockers()
+        if blockers is not None:
+            blockers.install_gc_monitor()
         
         # Create TCP socket
         self.server_socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
@@ -1360,16 +1807,27 @@ class VRStreamingServer:
         logger.info("=" * 60)
         logger.warning(f"Address: {self.host}:{self.port}")
         logger.warning(f"Resolution: {self.target_width}x{self.target_height} (source {self.width}x{self.height})")
-        logger.warning(f"Target FPS: {self.fps}")
+        logger.warning(f"Target FPS: {self.fps}" + (" (motion-adaptive)" if self.adaptive_fps else ""))
         logger.warning(f"Encoder: {self.encoder_type.value.upper()}")
-        if self.encoder_type == EncoderType.NVENC:
+        if self.encoder_type in (EncoderType.NVENC, EncoderType.HEVC):
             try:
                 bitrate_mbps = float(getattr(self, "bitrate", 0) or 0) / 1_000_000.0
                 if bitrate_mbps > 0:
                     logger.warning(f"Bitrate: {bitrate_mbps:.1f} Mbps")
             except Exception:
                 pass
-        logger.warning(f"Protocol: {self.protocol_magic.decode('ascii')}")
+        if self.encoder_type == EncoderType.HEVC:
+            logger.warning(
+                f"Protocol: VRH4 + HEVC ({self.hevc_codec}) for headsets that advertise it, "
+                f"otherwise {self.protocol_magic.decode('ascii')} H.264"
+            )
+        else:
+            logger.warning(f"Protocol: {self.protocol_magic.decode('ascii')}")
+        if self._multicast is not None:
+            logger.warning(
+                f"Multicast: {self._multicast.group}:{self._multicast.port} "
+                f"(FEC {self._multicast.fec_ratio * 100:.0f}%, TCP carries control only)"
+            )
         logger.info("🎯 Server will automatically connect to discovered VR headsets!")
         logger.info("   Just launch the app on your VR headset - no IP entry needed!")
         logger.info("=" * 60)
@@ -1409,7 +1867,8 @@ class VRStreamingServer:
                 self.clients.append(client_socket)
                 
                 # Handle client in separate task and track it for clean shutdown
-                task = asyncio.create_task(self.handle_client(client_socket, address))
+                handler = self._handle_multicast_client if self._multicast is not None else self.handle_client
+                task = asyncio.create_task(handler(client_socket, address))
                 self._client_tasks.add(task)
                 task.add_done_callback(lambda t: self._client_tasks.discard(t))
         
@@ -1442,6 +1901,13 @@ class VRStreamingServer:
                 task.cancel()
             await asyncio.gather(*self._client_tasks, return_exceptions=True)
             self._client_tasks.clear()
+
+        if self._multicast_thread is not None:
+            self._multicast_thread.join(timeout=1.0)
+            self._multicast_thread = None
+        if self._multicast is not None:
+            self._multicast.close()
+            self._multicast = None
         
         # Close server socket
         if self.server_socket:
@@ -1455,6 +1921,8 @@ class VRStreamingServer:
         if self.encoder:
             if self.encoder is not None:
                 self.encoder.close()
+        if self._owns_encoder_pool:
+            self.encoder_pool.close()
         
         logger.info("Server stopped")
 
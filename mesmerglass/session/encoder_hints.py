@@ -0,0 +1,117 @@
+"""
+Encoder hints published by the session runner.
+
+The runner knows when the picture is about to change completely (a cue
+transition or a playback switch). Encoders otherwise learn about a cut only by
+encoding it. A hard cut coded as a P-frame costs about as much as an IDR, and a
+fixed GOP then adds periodic IDRs on top during steady spiral motion.
+
+SessionRunner publishes three things here:
+- ``publish_upcoming`` when a transition has been requested and is waiting for
+  a cycle boundary, with an estimated time of arrival.
+- ``publish_cut`` when the cut actually happens, stamped with ``perf_counter``.
+- ``publish_motion`` every frame: how fast the spiral turns and when the media
+  cycler is expected to change image next. Motion-adaptive VR streams use it to
+  choose their frame rate (see mesmervisor.motion_rate).
+
+Encoders (VR streaming producers, the MP4 export worker) poll it with their own
+cursor, so each stream places its IDR on the first frame rendered after the
+cut. Encoders in scene-cut mode also run much longer GOPs.
+
+Thread-safe and Qt/GL-free: the runner publishes from the Qt thread, and
+encoders read from their own threads.
+"""
+
+from __future__ import annotations
+
+import threading
+import time
+from collections import deque
+from dataclasses import dataclass
+from typing import Optional
+
+
+@dataclass(frozen=True)
+class SceneCut:
+    seq: int
+    kind: str  # "cue" or "playback"
+    at: float  # perf_counter time the new content became current
+
+
+@dataclass(frozen=True)
+class MotionHint:
+    spiral_rpm: float  # absolute rotation speed of the spiral
+    next_media_at: Optional[float]  # perf_counter time the cycler should change media, if known
+    at: float  # perf_counter time this was published
+
+
+class EncoderHints:
+    """Scene-cut timeline shared between the session runner and its encoders."""
+
+    # Keep enough history for a consumer that lags a few seconds behind.
+    HISTORY = 32
+
+    def __init__(self) -> None:
+        self._lock = threading.Lock()
+        self._cuts: deque[SceneCut] = deque(maxlen=self.HISTORY)
+        self._seq = 0
+        self._upcoming_kind: Optional[str] = None
+        self._upcoming_at: Optional[float] = None
+        self._motion: Optional[MotionHint] = None
+
+    @property
+    def seq(self) -> int:
+        """Sequence number of the latest cut (0 before the first one)."""
+        with self._lock:
+            return self._seq
+
+    def publish_upcoming(self, kind: str, eta_s: float) -> None:
+        """A cut of ``kind`` is expected in about ``eta_s`` seconds."""
+        with self._lock:
+            self._upcoming_kind = str(kind)
+            self._upcoming_at = time.perf_counter() + max(0.0, float(eta_s))
+
+    def publish_cut(self, kind: str, at: Optional[float] = None) -> SceneCut:
+        """The picture changes completely from now on (frames rendered at/after ``at``)."""
+        with self._lock:
+            self._seq += 1
+            cut = SceneCut(self._seq, str(kind), time.perf_counter() if at is None else float(at))
+            self._cuts.append(cut)
+            self._upcoming_kind = None
+            self._upcoming_at = None
+            return cut
+
+    def cut_for_frame(self, since_seq: int, rendered_at: float) -> Optional[SceneCut]:
+        """Newest cut after ``since_seq`` that a frame rendered at ``rendered_at`` already shows."""
+        with self._lock:
+            for cut in reversed(self._cuts):
+                if cut.seq <= since_seq:
+                    return None
+                if cut.at <= rendered_at:
+                    return cut
+        return None
+
+    def cut_due_within(self, window_s: float, now: Optional[float] = None) -> bool:
+        """True while an announced cut is expected within ``window_s`` (stale announcements expire)."""
+        t = time.perf_counter() if now is None else float(now)
+        with self._lock:
+            if self._upcoming_at is None:
+                return False
+            # A transition can wait longer than estimated for its cycle boundary; give up after a second.
+            return (self._upcoming_at - window_s) <= t <= (self._upcoming_at + 1.0)
+
+    def publish_motion(self, spiral_rpm: float, next_media_in_s: Optional[float] = None) -> None:
+        """Current spiral speed and, if known, the time until the media cycler changes image."""
+        now = time.perf_counter()
+        next_media_at = None if next_media_in_s is None else now + max(0.0, float(next_media_in_s))
+        with self._lock:
+            self._motion = MotionHint(abs(float(spiral_rpm)), next_media_at, now)
+
+    def motion(self, max_age_s: float = 1.0, now: Optional[float] = None) -> Optional[MotionHint]:
+        """Latest motion hint, or None when nothing was published within ``max_age_s`` (e.g. paused)."""
+        t = time.perf_counter() if now is None else float(now)
+        with self._lock:
+            motion = self._motion
+        if motion is None or t - motion.at > max_age_s:
+            return None
+        return motion
@@ -1,5 +1,7 @@
 from __future__ import annotations
 
+import gc
+import os
 import threading
 import time
 from collections import deque
@@ -11,6 +13,29 @@ _LOCK = threading.Lock()
 # happens slightly after the blocking operation completes.
 _RECENT: deque[dict[str, Any]] = deque(maxlen=64)
 
+# GC pauses are queued here by the gc callback and folded into _RECENT on the
+# next record()/recent*() call. The callback runs inside whatever allocation
+# triggered the collection, possibly while this thread holds _LOCK, so it must
+# not take the lock itself. deque.append is atomic.
+_GC_PENDING: deque[dict[str, Any]] = deque(maxlen=64)
+_GC_STATE: dict[str, Any] = {
+    "installed": False,
+    "min_ms": 2.0,
+    "start": 0.0,
+    "pauses": [0, 0, 0],
+    "total_ms": [0.0, 0.0, 0.0],
+    "max_ms": [0.0, 0.0, 0.0],
+    "collected": 0,
+}
+
+
+def _drain_gc_locked() -> None:
+    while _GC_PENDING:
+        try:
+            _RECENT.append(_GC_PENDING.popleft())
+        except IndexError:
+            break
+
 
 def record(operation: str, duration_ms: float, **metadata: Any) -> None:
     if not operation:
@@ -29,6 +54,7 @@ def record(operation: str, duration_ms: float, **metadata: Any) -> None:
         "timestamp": time.time(),
     }
     with _LOCK:
+        _drain_gc_locked()
         _RECENT.append(rec)
 
 
@@ -36,6 +62,7 @@ def recent(ttl_s: float = 3.0) -> Optional[dict[str, Any]]:
     now = time.time()
     best: Optional[dict[str, Any]] = None
     with _LOCK:
+        _drain_gc_locked()
         # Iterate newest → oldest.
         for rec in reversed(_RECENT):
             ts = float(rec.get("timestamp", 0.0) or 0.0)
@@ -50,6 +77,7 @@ def recent_all(ttl_s: float = 3.0) -> list[dict[str, Any]]:
     now = time.time()
     out: list[dict[str, Any]] = []
     with _LOCK:
+        _drain_gc_locked()
         for rec in reversed(_RECENT):
             ts = float(rec.get("timestamp", 0.0) or 0.0)
             if (now - ts) > float(ttl_s):
@@ -104,3 +132,70 @@ def recent_best(local: Optional[dict[str, Any]], ttl_s: float = 3.0) -> Optional
         global_ts = 0.0
 
     return global_rec if global_ts >= local_ts else local
+
+
+def _gc_callback(phase: str, info: dict[str, Any]) -> None:
+    if phase == "start":
+        _GC_STATE["start"] = time.perf_counter()
+        return
+    start = float(_GC_STATE["start"] or 0.0)
+    if start <= 0.0:
+        return
+    _GC_STATE["start"] = 0.0
+    dur_ms = (time.perf_counter() - start) * 1000.0
+    gen = min(2, max(0, int(info.get("generation", 0))))
+    _GC_STATE["pauses"][gen] += 1
+    _GC_STATE["total_ms"][gen] += dur_ms
+    _GC_STATE["collected"] += int(info.get("collected", 0))
+    if dur_ms > _GC_STATE["max_ms"][gen]:
+        _GC_STATE["max_ms"][gen] = dur_ms
+    if dur_ms >= float(_GC_STATE["min_ms"]):
+        _GC_PENDING.append(
+            {
+                "operation": f"gc.gen{gen}",
+                "duration_ms": dur_ms,
+                "metadata": {
+                    "collected": int(info.get("collected", 0)),
+                    "uncollectable": int(info.get("uncollectable", 0)),
+                    "thread": threading.current_thread().name,
+                },
+                "timestamp": time.time(),
+            }
+        )
+
+
+def install_gc_monitor(min_ms: Optional[float] = None) -> None:
+    """Time every garbage collection and record pauses of at least ``min_ms`` as ``gc.genN``.
+
+    ``min_ms`` defaults to ``MESMERGLASS_GC_PAUSE_MS`` (2.0). Idempotent; the
+    callback costs two ``perf_counter`` calls per collection.
+    """
+    if min_ms is None:
+        try:
+            min_ms = float(os.environ.get("MESMERGLASS_GC_PAUSE_MS", "2.0"))
+        except ValueError:
+            min_ms = 2.0
+    _GC_STATE["min_ms"] = max(0.0, float(min_ms))
+    if not _GC_STATE["installed"]:
+        gc.callbacks.append(_gc_callback)
+        _GC_STATE["installed"] = True
+
+
+def uninstall_gc_monitor() -> None:
+    try:
+        gc.callbacks.remove(_gc_callback)
+    except ValueError:
+        pass
+    _GC_STATE["installed"] = False
+    _GC_STATE["start"] = 0.0
+
+
+def gc_stats() -> dict[str, Any]:
+    """Collections, total and worst pause per generation since the monitor was installed."""
+    return {
+        "installed": bool(_GC_STATE["installed"]),
+        "pauses": list(_GC_STATE["pauses"]),
+        "total_ms": [round(v, 3) for v in _GC_STATE["total_ms"]],
+        "max_ms": [round(v, 3) for v in _GC_STATE["max_ms"]],
+        "collected": int(_GC_STATE["collected"]),
+    }
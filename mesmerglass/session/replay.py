@@ -0,0 +1,614 @@
+"""Deterministic session record/replay.
+
+Stutters in ``SessionRunner.update`` often depend on one particular sequence of
+playback picks, cue timings and media, and all of those come from ``random`` and
+the wall clock. A :class:`TraceRecorder` captures those inputs while a session
+runs:
+
+- the seed of the runner's random source (playback picks and durations)
+- every clock read the runner makes, grouped by the public call that made it
+  (``start``, ``frame`` for ``update(dt)``, ``pause``, ``skip_to`` ...)
+- cycle boundaries from the visual director
+- ``Shuffler`` picks, media paths, and device add/remove events
+
+The trace is gzip'd JSON lines. The first line is a header with the seed, the
+cuelist and the session data. Each record after it is
+``[kind, t, args, reads, events]``: ``t`` is the offset in seconds from the
+start of the trace, ``reads`` holds the runner's clock reads as offsets from
+the same origin, and ``events`` is a list of ``[name, *fields]``. Events that arrive between calls
+(a cycle fired from a compositor paint, for example) open an ``idle`` record.
+
+:func:`replay` feeds a trace back into a headless runner. The runner gets a
+stub visual director that fires the recorded cycles, a clock that returns the
+recorded reads, and a random source with the recorded seed. Playback selection
+and cue timing then repeat exactly, so ``update`` can be timed or profiled, as
+fast as possible or at the recorded pace. Any playback pick that differs from
+the recording is counted as a divergence.
+
+Recording is off unless ``MESMERGLASS_SESSION_TRACE`` names a file or directory.
+When no recorder is active the hooks cost a single global lookup.
+"""
+
+from __future__ import annotations
+
+import functools
+import gzip
+import json
+import logging
+import os
+import random
+import threading
+import time
+from collections import Counter, deque
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import TYPE_CHECKING, Any, Callable, Optional
+
+if TYPE_CHECKING:
+    from .runner import SessionRunner
+
+
+logger = logging.getLogger(__name__)
+
+FORMAT = "mesmerglass.session-trace"
+VERSION = 1
+ENV_VAR = "MESMERGLASS_SESSION_TRACE"
+SUFFIX = ".mgtrace.gz"
+
+# Recorder (live session) or verifier (replay); None keeps every hook a no-op.
+_ACTIVE: Optional["_Sink"] = None
+
+
+def traced(kind: str) -> Callable[[Callable[..., Any]], Callable[..., Any]]:
+    """Mark a ``SessionRunner`` entry point as a replayable trace record.
+
+    Positional arguments after ``self`` are stored with the record. Calls made
+    while another record is open (``stop()`` from inside ``update()``) are only
+    logged as ``["call", kind, *args]`` events, since replaying the outer call
+    repeats them.
+    """
+
+    def decorate(fn: Callable[..., Any]) -> Callable[..., Any]:
+        @functools.wraps(fn)
+        def wrapper(*args: Any, **kwargs: Any) -> Any:
+            sink = _ACTIVE
+            if sink is None:
+                return fn(*args, **kwargs)
+            sink.enter(kind, args[1:])
+            try:
+                return fn(*args, **kwargs)
+            finally:
+                sink.exit()
+
+        return wrapper
+
+    return decorate
+
+
+def note(kind: str, *fields: Any) -> None:
+    """Log a nondeterministic input (media path, device event ...) to the active trace."""
+    sink = _ACTIVE
+    if sink is not None:
+        sink.event([kind, *fields])
+
+
+class _Sink:
+    def __init__(self) -> None:
+        self._lock = threading.RLock()
+        self._depth = 0
+
+    def enter(self, kind: str, args: tuple) -> None:
+        with self._lock:
+            self._depth += 1
+            if self._depth > 1:
+                self._on_event(["call", kind, *args])
+            else:
+                self._on_open(kind, list(args))
+
+    def exit(self) -> None:
+        with self._lock:
+            if self._depth <= 0:
+                return
+            self._depth -= 1
+            if self._depth == 0:
+                self._on_close()
+
+    def event(self, ev: list) -> None:
+        with self._lock:
+            self._on_event(ev)
+
+    def _on_open(self, kind: str, args: list) -> None:
+        pass
+
+    def _on_close(self) -> None:
+        pass
+
+    def _on_event(self, ev: list) -> None:
+        pass
+
+
+# ===== Recording =====
+
+
+class TraceRecorder(_Sink):
+    """Write a session trace while a live ``SessionRunner`` runs.
+
+    Pass :meth:`clock` and :attr:`rng` to the runner, then :meth:`attach` it
+    before ``start()``::
+
+        recorder = TraceRecorder(path)
+        runner = SessionRunner(..., time_provider=recorder.clock, rng=recorder.rng)
+        recorder.attach(runner)
+        runner.start()
+        ...
+        recorder.close()
+    """
+
+    def __init__(
+        self,
+        path: str | Path,
+        *,
+        seed: Optional[int] = None,
+        time_source: Callable[[], float] = time.time,
+    ) -> None:
+        super().__init__()
+        self.path = Path(path)
+        self.seed = int(seed) if seed is not None else random.SystemRandom().randrange(1 << 32)
+        self.rng = random.Random(self.seed)
+        self.records = 0
+        self._time = time_source
+        self._t0 = time_source()
+        self._record: Optional[list] = None
+        self._runner: Optional["SessionRunner"] = None
+        self._hooks: list[tuple[Any, Callable[[int, int], None]]] = []
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        self._fh: Any = gzip.open(self.path, "wt", encoding="utf-8", compresslevel=6)
+
+    # --- runner inputs ---
+
+    def clock(self) -> float:
+        """Wall clock for the runner; reads inside a record are logged."""
+        now = self._time()
+        rec = self._record
+        if rec is not None:
+            # Offsets from a nearby origin are exact, so replay gets the
+            # same floats back and duration checks cannot flip at a boundary.
+            rec[3].append(now - self._t0)
+        return now
+
+    # --- lifecycle ---
+
+    def attach(self, runner: "SessionRunner") -> None:
+        """Write the header and start capturing ``runner``'s inputs."""
+        global _ACTIVE
+        from ..content import theme
+        from ..engine import shuffler
+
+        self._runner = runner
+        director = runner.visual_director
+        cycles = 0
+        if director is not None:
+            try:
+                cycles = int(director.get_cycle_count())
+            except Exception:
+                cycles = 0
+        header = {
+            "format": FORMAT,
+            "version": VERSION,
+            "seed": self.seed,
+            "t0": self._t0,
+            "created": time.strftime("%Y-%m-%dT%H:%M:%S"),
+            "cycle_count": cycles,
+            "cuelist": runner.cuelist.to_dict(),
+            "session": runner.session_data or {},
+        }
+        self._write(header)
+        # Registered before the runner's own callback, so the cycle event is
+        # in the record ahead of the clock reads it causes.
+        if director is not None:
+            director.register_cycle_callback(self._on_cycle)
+        for cls, tag in ((shuffler.Shuffler, "engine"), (theme.Shuffler, "theme")):
+            hook = functools.partial(self._on_pick, tag)
+            cls.on_pick = hook
+            self._hooks.append((cls, hook))
+        _ACTIVE = self
+        logger.info("[trace] Recording session to %s (seed=%d)", self.path, self.seed)
+
+    def close(self) -> None:
+        """Flush the open record, unhook, and close the file (idempotent)."""
+        global _ACTIVE
+        with self._lock:
+            if self._fh is None:
+                return
+            if _ACTIVE is self:
+                _ACTIVE = None
+            for cls, hook in self._hooks:
+                if cls.on_pick is hook:
+                    cls.on_pick = None
+            self._hooks.clear()
+            director = self._runner.visual_director if self._runner is not None else None
+            if director is not None:
+                try:
+                    director.unregister_cycle_callback(self._on_cycle)
+                except Exception:
+                    pass
+            self._flush()
+            self._depth = 0
+            self._fh.close()
+            self._fh = None
+        logger.info("[trace] Wrote %d records to %s", self.records, self.path)
+
+    # --- sink ---
+
+    def _on_open(self, kind: str, args: list) -> None:
+        self._flush()
+        self._record = [kind, round(self._time() - self._t0, 6), args, [], []]
+
+    def _on_close(self) -> None:
+        self._flush()
+
+    def _on_event(self, ev: list) -> None:
+        if self._fh is None:
+            return
+        if self._record is None:
+            self._record = ["idle", round(self._time() - self._t0, 6), [], [], []]
+        self._record[4].append(ev)
+
+    def _on_cycle(self) -> None:
+        self.event(["cycle"])
+
+    def _on_pick(self, tag: str, count: int, index: int) -> None:
+        self.event(["pick", tag, count, index])
+
+    def _flush(self) -> None:
+        rec, self._record = self._record, None
+        if rec is not None and self._fh is not None:
+            self._write(rec)
+            self.records += 1
+
+    def _write(self, obj: Any) -> None:
+        self._fh.write(json.dumps(obj, separators=(",", ":"), default=str))
+        self._fh.write("\n")
+
+
+def recorder_from_env() -> Optional[TraceRecorder]:
+    """Return a recorder when ``MESMERGLASS_SESSION_TRACE`` is set, else None.
+
+    A directory (existing, or given with a trailing separator) gets a
+    timestamped ``session-*.mgtrace.gz`` file.
+    """
+    raw = os.environ.get(ENV_VAR, "").strip()
+    if not raw:
+        return None
+    path = Path(raw).expanduser()
+    if path.is_dir() or raw.endswith(("/", os.sep)):
+        path = path / f"session-{time.strftime('%Y%m%d-%H%M%S')}{SUFFIX}"
+    try:
+        return TraceRecorder(path)
+    except OSError as exc:
+        logger.warning("[trace] Cannot record session to %s: %s", path, exc)
+        return None
+
+
+# ===== Loading =====
+
+
+@dataclass
+class SessionTrace:
+    header: dict[str, Any]
+    records: list[list]
+
+    @classmethod
+    def load(cls, path: str | Path) -> "SessionTrace":
+        with gzip.open(Path(path), "rt", encoding="utf-8") as fh:
+            lines = (line for line in fh if line.strip())
+            try:
+                header = json.loads(next(lines))
+            except StopIteration:
+                raise ValueError(f"{path}: empty trace") from None
+            if not isinstance(header, dict) or header.get("format") != FORMAT:
+                raise ValueError(f"{path}: not a session trace")
+            if int(header.get("version", 0)) > VERSION:
+                raise ValueError(f"{path}: trace version {header.get('version')} is newer than {VERSION}")
+            records = [json.loads(line) for line in lines]
+        return cls(header, records)
+
+    def duration_s(self) -> float:
+        return float(self.records[-1][1]) if self.records else 0.0
+
+    def stats(self) -> dict[str, Any]:
+        kinds = Counter(rec[0] for rec in self.records)
+        events = Counter(ev[0] for rec in self.records for ev in rec[4])
+        return {
+            "seed": self.header.get("seed"),
+            "created": self.header.get("created"),
+            "cuelist": (self.header.get("cuelist") or {}).get("name"),
+            "duration_s": self.duration_s(),
+            "records": dict(kinds),
+            "events": dict(events),
+            "clock_reads": sum(len(rec[3]) for rec in self.records),
+        }
+
+
+# ===== Replay =====
+
+
+class _ReplayClock:
+    """Hands the runner its recorded clock reads, record by record."""
+
+    def __init__(self, t0: float) -> None:
+        self.t0 = t0
+        self.misses = 0
+        self.unused = 0
+        self._reads: deque[float] = deque()
+        self._now = t0
+
+    def begin(self, t: float, reads: list[float]) -> None:
+        self._reads = deque(reads)
+        self._now = self.t0 + t
+
+    def end(self, strict: bool) -> None:
+        # Idle records may hold UI polls the replay never makes.
+        if strict:
+            self.unused += len(self._reads)
+        self._reads.clear()
+
+    def __call__(self) -> float:
+        if self._reads:
+            self._now = self.t0 + self._reads.popleft()
+        else:
+            self.misses += 1
+        return self._now
+
+
+class ReplayVisualDirector:
+    """Stands in for ``VisualDirector``: fires recorded cycles, optionally decodes media."""
+
+    text_director = None
+
+    def __init__(self, cycle_count: int = 0, *, decode_media: bool = False) -> None:
+        self.cycle_count = int(cycle_count)
+        self.decode_media = decode_media
+        self.current_playback: Optional[Path] = None
+        self.media_ms: list[tuple[float, str]] = []
+        self._callbacks: list[Callable[[], None]] = []
+        self._pending: list[list] = []
+
+    def queue(self, events: list[list]) -> None:
+        self._pending.extend(ev for ev in events if ev and ev[0] in ("cycle", "media"))
+
+    def flush(self) -> None:
+        pending, self._pending = self._pending, []
+        for ev in pending:
+            if ev[0] == "cycle":
+                self.cycle_count += 1
+                for callback in list(self._callbacks):
+                    callback()
+            elif self.decode_media and len(ev) >= 3 and ev[1] == "image":
+                self._decode(str(ev[2]))
+
+    def _decode(self, path: str) -> None:
+        from ..content.media import load_image_sync
+
+        start = time.perf_counter()
+        try:
+            load_image_sync(path)
+        except Exception as exc:
+            logger.debug("[trace] Media decode failed for %s: %s", path, exc)
+        self.media_ms.append(((time.perf_counter() - start) * 1000.0, path))
+
+    # --- VisualDirector surface used by SessionRunner ---
+
+    def update(self, dt: float = 0.0) -> None:
+        self.flush()
+
+    def get_cycle_count(self) -> int:
+        return self.cycle_count
+
+    def register_cycle_callback(self, callback: Callable[[], None]) -> None:
+        if callback not in self._callbacks:
+            self._callbacks.append(callback)
+
+    def unregister_cycle_callback(self, callback: Callable[[], None]) -> None:
+        if callback in self._callbacks:
+            self._callbacks.remove(callback)
+
+    def load_playback(self, playback_path: Any) -> bool:
+        self.current_playback = Path(playback_path)
+        return True
+
+    def start_playback(self) -> None:
+        pass
+
+    def pause(self) -> None:
+        pass
+
+    def resume(self) -> None:
+        pass
+
+    def set_current_cue_settings(self, settings: Any) -> None:
+        pass
+
+    def stop_video_audio(self, fade_ms: int = 0) -> None:
+        pass
+
+    def register_secondary_compositor(self, compositor: Any) -> None:
+        pass
+
+    def unregister_secondary_compositor(self, compositor: Any) -> None:
+        pass
+
+
+class _ReplayVerifier(_Sink):
+    """Collects the replay's playback picks and nested calls for comparison."""
+
+    def __init__(self) -> None:
+        super().__init__()
+        self.events: list[list] = []
+
+    def _on_event(self, ev: list) -> None:
+        if ev[0] in ("playback", "call"):
+            self.events.append(ev)
+
+
+def _percentile(values: list[float], pct: float) -> float:
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    idx = min(len(ordered) - 1, max(0, int(round(pct / 100.0 * (len(ordered) - 1)))))
+    return ordered[idx]
+
+
+@dataclass
+class ReplayReport:
+    records: int = 0
+    frames: int = 0
+    virtual_s: float = 0.0
+    wall_s: float = 0.0
+    update_ms: list[float] = field(default_factory=list)
+    slowest: list[dict[str, Any]] = field(default_factory=list)
+    divergences: int = 0
+    first_divergence: Optional[dict[str, Any]] = None
+    clock_misses: int = 0
+    clock_unused: int = 0
+    events: dict[str, int] = field(default_factory=dict)
+    media_ms: list[tuple[float, str]] = field(default_factory=list)
+    perf: Optional[dict[str, Any]] = None
+
+    def to_dict(self) -> dict[str, Any]:
+        media = [ms for ms, _ in self.media_ms]
+        return {
+            "records": self.records,
+            "frames": self.frames,
+            "virtual_s": round(self.virtual_s, 3),
+            "wall_s": round(self.wall_s, 3),
+            "update_ms": {
+                "p50": round(_percentile(self.update_ms, 50), 3),
+                "p95": round(_percentile(self.update_ms, 95), 3),
+                "p99": round(_percentile(self.update_ms, 99), 3),
+                "max": round(max(self.update_ms, default=0.0), 3),
+            },
+            "slowest": self.slowest,
+            "divergences": self.divergences,
+            "first_divergence": self.first_divergence,
+            "clock_misses": self.clock_misses,
+            "clock_unused": self.clock_unused,
+            "events": self.events,
+            "media": {
+                "decoded": len(media),
+                "p95_ms": round(_percentile(media, 95), 3),
+                "max_ms": round(max(media, default=0.0), 3),
+                "slowest": [
+                    {"ms": round(ms, 3), "path": path} for ms, path in sorted(self.media_ms, reverse=True)[:5]
+                ],
+            },
+            "perf": self.perf,
+        }
+
+
+_CALLS: dict[str, Callable[["SessionRunner", list], Any]] = {
+    "start": lambda r, a: r.start(),
+    "stop": lambda r, a: r.stop(),
+    "pause": lambda r, a: r.pause(),
+    "resume": lambda r, a: r.resume(),
+    "frame": lambda r, a: r.update(*a),
+    "skip_next": lambda r, a: r.skip_to_next_cue(),
+    "skip_previous": lambda r, a: r.skip_to_previous_cue(),
+    "skip_to": lambda r, a: r.skip_to_cue(*a),
+}
+
+
+def _expected_events(trace: SessionTrace) -> list[list]:
+    return [ev for rec in trace.records for ev in rec[4] if ev[0] in ("playback", "call")]
+
+
+def replay(
+    trace: SessionTrace | str | Path,
+    *,
+    realtime: bool = False,
+    decode_media: bool = False,
+    top: int = 10,
+) -> ReplayReport:
+    """Drive a headless ``SessionRunner`` through ``trace`` and time every record.
+
+    Args:
+        trace: Loaded trace or path to a ``.mgtrace.gz`` file
+        realtime: Sleep between records to keep the recorded pace (default: as fast as possible)
+        decode_media: Decode recorded images when they were shown, to include decode cost
+        top: Number of slowest frames to keep in the report
+    """
+    global _ACTIVE
+    from .cuelist import Cuelist
+    from .runner import SessionRunner
+
+    if not isinstance(trace, SessionTrace):
+        trace = SessionTrace.load(trace)
+    header = trace.header
+    clock = _ReplayClock(float(header.get("t0", 0.0)))
+    director = ReplayVisualDirector(int(header.get("cycle_count", 0)), decode_media=decode_media)
+    runner = SessionRunner(
+        cuelist=Cuelist.from_dict(header["cuelist"]),
+        visual_director=director,
+        audio_engine=None,
+        compositor=None,
+        session_data=header.get("session") or None,
+        headless=True,
+        time_provider=clock,
+        rng=random.Random(header.get("seed")),
+    )
+
+    report = ReplayReport(events=dict(trace.stats()["events"]))
+    verifier = _ReplayVerifier()
+    prev_sink, _ACTIVE = _ACTIVE, verifier
+    wall_start = time.perf_counter()
+    try:
+        for rec in trace.records:
+            kind, t, args, reads, events = rec
+            if realtime:
+                delay = t - (time.perf_counter() - wall_start)
+                if delay > 0:
+                    time.sleep(delay)
+            clock.begin(t, reads)
+            director.queue(events)
+            call = _CALLS.get(kind)
+            start = time.perf_counter()
+            if call is not None:
+                call(runner, args)
+            # Cycles fired outside update() (idle records, or a call that never
+            # reached the director) are delivered after the call.
+            director.flush()
+            elapsed_ms = (time.perf_counter() - start) * 1000.0
+            clock.end(strict=call is not None)
+            report.records += 1
+            if kind == "frame":
+                report.frames += 1
+                report.update_ms.append(elapsed_ms)
+                report.slowest.append({"ms": elapsed_ms, "t_s": t, "cue": runner.get_current_cue_index()})
+                if len(report.slowest) > top * 4:
+                    report.slowest = sorted(report.slowest, key=lambda s: s["ms"], reverse=True)[:top]
+        if not runner.is_stopped():
+            runner.stop()
+    finally:
+        _ACTIVE = prev_sink
+
+    report.wall_s = time.perf_counter() - wall_start
+    report.virtual_s = trace.duration_s()
+    report.slowest = [
+        {"ms": round(s["ms"], 3), "t_s": round(s["t_s"], 3), "cue": s["cue"]}
+        for s in sorted(report.slowest, key=lambda s: s["ms"], reverse=True)[:top]
+    ]
+    report.clock_misses = clock.misses
+    report.clock_unused = clock.unused
+    report.media_ms = director.media_ms
+    report.perf = runner.get_perf_snapshot()
+
+    expected = _expected_events(trace)
+    actual = verifier.events
+    for idx in range(max(len(expected), len(actual))):
+        want = expected[idx] if idx < len(expected) else None
+        got = actual[idx] if idx < len(actual) else None
+        if want != got:
+            report.divergences += 1
+            if report.first_divergence is None:
+                report.first_divergence = {"index": idx, "expected": want, "actual": got}
+    return report
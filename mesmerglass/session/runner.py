@@ -29,7 +29,7 @@ else:
     _PSUTIL_IMPORT_ERROR = None
 from dataclasses import dataclass
 from enum import Enum, auto
-from typing import TYPE_CHECKING, Optional, Any
+from typing import TYPE_CHECKING, Callable, Optional, Any
 from pathlib import Path
 
 if TYPE_CHECKING:
@@ -43,6 +43,9 @@ from .cue import PlaybackSelectionMode, AudioRole
 from .cuelist import CuelistLoopMode, CuelistTransitionMode
 from .events import SessionEventEmitter, SessionEvent, SessionEventType
 from .audio_prefetch_worker import AudioPrefetchWorker, PrefetchJob
+from .encoder_hints import EncoderHints
+from . import perf_blockers
+from . import replay
 from ..logging_utils import PerfTracer
 
 
@@ -98,7 +101,11 @@ class SessionRunner:
         audio_engine: Optional[AudioEngine] = None,
         compositor: Optional[LoomCompositor] = None,
         display_tab = None,  # DisplayTab for monitor selection
-        session_data: Optional[dict] = None  # Session data for accessing playback configs
+        session_data: Optional[dict] = None,  # Session data for accessing playback configs
+        encoder_hints: Optional[EncoderHints] = None,
+        headless: bool = False,
+        time_provider: Optional[Callable[[], float]] = None,
+        rng: Optional[random.Random] = None,
     ):
         """
         Initialize session runner.
@@ -111,6 +118,12 @@ class SessionRunner:
             compositor: OpenGL compositor (primary compositor, used as template for multi-display)
             display_tab: DisplayTab widget for monitor selection (optional)
             session_data: Full session data dict for accessing playback configs (optional)
+            encoder_hints: Scene-cut timeline for encoders fed by this session (optional; one is
+                created when omitted and handed to the VR streaming server)
+            headless: Never put the compositor on a display (offline export, trace replay)
+            time_provider: Clock for cue/playback/transition timing in seconds (default: time.time).
+                Frame-time measurements always use the real perf counter.
+            rng: Random source for playback picks and durations (default: the random module)
         """
         self.cuelist = cuelist
         self.visual_director = visual_director
@@ -119,6 +132,12 @@ class SessionRunner:
         self.compositor = compositor  # Primary compositor (template)
         self.display_tab = display_tab
         self.session_data = session_data
+        self.encoder_hints = encoder_hints or EncoderHints()
+        self.headless = headless
+        # Session timing and random picks go through these so a trace can
+        # record and replay them (see replay.py).
+        self._now: Callable[[], float] = time_provider or time.time
+        self._rng = rng if rng is not None else random
         
         self.logger = logging.getLogger(__name__)
         
@@ -193,6 +212,7 @@ class SessionRunner:
         self.vr_streaming_server = None
         self._vr_streaming_active = False
         self._vr_last_frame = None
+        self._vr_last_frame_rendered_at: Optional[float] = None
         self._vr_frame_lock = None
         self._vr_frame_handler = None
 
@@ -258,11 +278,10 @@ class SessionRunner:
 
     def _recent_blocking_operation(self, ttl_s: float = 3.0) -> Optional[dict[str, Any]]:
         ctx = self._last_blocking_operation
-        if not ctx:
-            return None
-        if (time.time() - ctx.get("timestamp", 0.0)) > ttl_s:
-            return None
-        return ctx
+        if ctx and (time.time() - ctx.get("timestamp", 0.0)) > ttl_s:
+            ctx = None
+        # Compositor paint sections and GC pauses are recorded globally.
+        return perf_blockers.recent_best(ctx, ttl_s=ttl_s)
 
     def _record_frame_spike(self, frame_delta_ms: float) -> None:
         """Remember the worst frame spike so we can summarize later."""
@@ -655,6 +674,7 @@ class SessionRunner:
     
     # ===== Lifecycle Methods =====
     
+    @replay.traced("start")
     def start(self) -> bool:
         """Start cuelist execution from first cue.
         
@@ -683,14 +703,15 @@ class SessionRunner:
         
         # Initialize session state
         self._state = SessionState.RUNNING
-        self._session_start_time = time.time()
+        self._session_start_time = self._now()
         self._total_paused_time = 0.0
         self._loop_direction = 1
         self._worst_frame_spike = None
         self._last_blocking_operation = None
+        perf_blockers.install_gc_monitor()
         
         # Activate compositor(s) on selected display(s)
-        if self.compositor:
+        if self.compositor and not self.headless:
             from PyQt6.QtGui import QGuiApplication
             
             # Get selected displays from DisplayTab
@@ -822,11 +843,13 @@ class SessionRunner:
                         if not self._vr_streaming_active:
                             return None
                         
-                        # Return cached frame (NEVER call GL functions from streaming thread)
+                        # Return cached frame (NEVER call GL functions from streaming thread).
+                        # The paint time lets the server key the first frame after a cut.
                         with self._vr_frame_lock:
                             if self._vr_last_frame is not None:
-                                frame = self._vr_last_frame.copy()  # Copy to avoid race conditions
-                                return frame
+                                # Capture frames are pooled and reference counted: the compositor
+                                # never writes into a frame after delivering it, so no copy is needed.
+                                return self._vr_last_frame, self._vr_last_frame_rendered_at
                         
                         return None  # No frame available yet
                     
@@ -837,7 +860,8 @@ class SessionRunner:
                         fps=30,
                         encoder_type=EncoderType.AUTO,
                         quality=25,  # Optimized for Oculus Go
-                        frame_callback=capture_frame
+                        frame_callback=capture_frame,
+                        scene_hints=self.encoder_hints,
                     )
                     
                     # Start streaming server (TCP 5555)
@@ -851,8 +875,14 @@ class SessionRunner:
                                 """Cache frame from compositor (called from Qt main thread with GL context active)"""
                                 if self._vr_streaming_active and frame is not None and frame.size > 0:
                                     try:
+                                        # Capture-bus frames are freshly read back per paint and
+                                        # never reused by the compositor, so no copy is needed.
+                                        rendered_at = None
+                                        if hasattr(streaming_compositor, "capture_rendered_at"):
+                                            rendered_at = streaming_compositor.capture_rendered_at()
                                         with self._vr_frame_lock:
-                                            self._vr_last_frame = frame.copy()
+                                            self._vr_last_frame = frame
+                                            self._vr_last_frame_rendered_at = rendered_at
                                     except Exception as e:  # pragma: no cover - defensive
                                         self.logger.error(f"[session] VR frame cache error: {e}")
 
@@ -860,6 +890,16 @@ class SessionRunner:
 
                         if hasattr(streaming_compositor, 'set_vr_capture_enabled'):
                             try:
+                                # Let the GPU resize to the stream's target size so the
+                                # producer thread can skip its CPU resize.
+                                target = (
+                                    int(getattr(self.vr_streaming_server, "target_width", 0) or 0),
+                                    int(getattr(self.vr_streaming_server, "target_height", 0) or 0),
+                                )
+                                streaming_compositor.set_vr_capture_enabled(
+                                    True, max_fps=30, size=target if all(target) else None
+                                )
+                            except TypeError:
                                 streaming_compositor.set_vr_capture_enabled(True, max_fps=30)
                             except Exception:
                                 pass
@@ -911,6 +951,7 @@ class SessionRunner:
         self._prefetch_cue_audio(0, async_allowed=False)
         return self._start_cue(0)
     
+    @replay.traced("stop")
     def stop(self) -> None:
         """Stop session execution and cleanup."""
         if self._state == SessionState.STOPPED:
@@ -1033,6 +1074,7 @@ class SessionRunner:
         self._pending_transition_since_ts = None
         self._transition_target_cue = None
     
+    @replay.traced("pause")
     def pause(self) -> bool:
         """Pause session execution.
         
@@ -1044,7 +1086,7 @@ class SessionRunner:
             return False
         
         self._state = SessionState.PAUSED
-        self._pause_start_time = time.time()
+        self._pause_start_time = self._now()
         
         self.logger.info("[session] Session paused")
         
@@ -1064,6 +1106,7 @@ class SessionRunner:
         
         return True
     
+    @replay.traced("resume")
     def resume(self) -> bool:
         """Resume session execution from pause.
         
@@ -1076,7 +1119,7 @@ class SessionRunner:
         
         # Calculate pause duration
         if self._pause_start_time:
-            pause_duration = time.time() - self._pause_start_time
+            pause_duration = self._now() - self._pause_start_time
             self._total_paused_time += pause_duration
             self._pause_start_time = None
         
@@ -1380,7 +1423,7 @@ class SessionRunner:
         self._prefetched_cues.discard(cue_index)
         self._prefetch_backlog.discard(cue_index)
         self._current_cue_index = cue_index
-        self._cue_start_time = time.time()
+        self._cue_start_time = self._now()
         self._cue_start_cycle = self.visual_director.get_cycle_count()
         self._playback_history.clear()  # Reset history for new cue
         
@@ -1417,11 +1460,9 @@ class SessionRunner:
         
         # Track current playback for time-based switching
         self._current_playback_entry = playback_entry
-        self._playback_start_time = time.time()
+        self._playback_start_time = self._now()
         
         # Determine target duration (random between min and max in seconds)
-        import random
-        
         # Use duration-based fields if available, otherwise fall back to legacy cycle-based
         if playback_entry.min_duration_s is not None or playback_entry.max_duration_s is not None:
             min_duration = playback_entry.min_duration_s or 5.0
@@ -1433,7 +1474,7 @@ class SessionRunner:
             min_duration = min_cycles * 10.0
             max_duration = max_cycles * 10.0
         
-        self._playback_target_duration = random.uniform(min_duration, max_duration)
+        self._playback_target_duration = self._rng.uniform(min_duration, max_duration)
         self._playback_switch_pending = False
         self.logger.debug(f"[session] Playback will run for {self._playback_target_duration:.1f}s (range: {min_duration:.1f}-{max_duration:.1f}s)")
         
@@ -1983,10 +2024,10 @@ class SessionRunner:
         total_weight = sum(entry.weight for entry in available)
         if total_weight <= 0:
             self.logger.warning("[session] All weights are zero, using equal probability")
-            selected = random.choice(available)
+            selected = self._rng.choice(available)
         else:
             # Weighted random selection
-            rand_value = random.uniform(0, total_weight)
+            rand_value = self._rng.uniform(0, total_weight)
             cumulative = 0.0
             selected = available[-1]  # Fallback
             
@@ -2002,11 +2043,13 @@ class SessionRunner:
             self._playback_history.pop(0)
         
         playback_path = Path(selected.playback_path)
+        replay.note("playback", str(playback_path))
         self.logger.info(f"[session] Selected playback (weighted): {playback_path.name}")
         return selected, playback_path
     
     # ===== Update Loop and Transition Detection =====
     
+    @replay.traced("frame")
     def update(self, dt: float = 0.0) -> None:
         """Update session state (called every frame at 60fps).
         
@@ -2019,7 +2062,6 @@ class SessionRunner:
         self._process_completed_prefetch_jobs()
         
         # Track frame timing
-        import time
         current_time = time.perf_counter()
         frame_delta_ms = 0.0
         if self._last_frame_time is not None:
@@ -2068,6 +2110,7 @@ class SessionRunner:
         # === VISUAL DIRECTOR: Advance media cycler and process async image loading ===
         if self.visual_director:
             self.visual_director.update(dt)
+        self._publish_motion_hint()
         
         visual_duration = (time.perf_counter() - visual_start) * 1000.0
         if visual_duration > 20.0:  # Log if visual update takes >20ms
@@ -2123,10 +2166,10 @@ class SessionRunner:
             return
 
         if self._pending_transition_since_ts is None:
-            self._pending_transition_since_ts = time.perf_counter()
+            self._pending_transition_since_ts = self._now()
             return
 
-        waited_s = time.perf_counter() - self._pending_transition_since_ts
+        waited_s = self._now() - self._pending_transition_since_ts
 
         # Timeout scales with observed cycle interval; if we've never observed a
         # cycle boundary, fall back to a small constant.
@@ -2160,13 +2203,15 @@ class SessionRunner:
             return
         
         # Check if target duration has elapsed
-        elapsed = time.time() - self._playback_start_time
+        elapsed = self._now() - self._playback_start_time
         
         if elapsed >= self._playback_target_duration and not self._playback_switch_pending:
             # Duration reached - mark switch as pending and wait for next cycle boundary
             self._playback_switch_pending = True
             self.logger.info(f"[session] Playback duration reached ({elapsed:.1f}s >= {self._playback_target_duration:.1f}s), waiting for cycle boundary...")
             
+            self._announce_upcoming_cut("playback")
+
             # Register playback cycle callback if not already registered
             if not self._playback_callback_registered:
                 self.visual_director.register_cycle_callback(self._on_playback_cycle_boundary)
@@ -2239,13 +2284,12 @@ class SessionRunner:
             self.logger.info(f"[session] Applied {len(cue.text_messages)} custom text messages for cue '{cue.name}'")
         
         self.visual_director.start_playback()
+        self.encoder_hints.publish_cut("playback")
         self.logger.info(f"[session] Switched to playback: {playback_path.name}")
         
         # Update tracking and set new target duration
         self._current_playback_entry = playback_entry
-        self._playback_start_time = time.time()
-        
-        import random
+        self._playback_start_time = self._now()
         
         # Use duration-based fields if available, otherwise fall back to legacy cycle-based
         if playback_entry.min_duration_s is not None or playback_entry.max_duration_s is not None:
@@ -2258,7 +2302,7 @@ class SessionRunner:
             min_duration = min_cycles * 10.0
             max_duration = max_cycles * 10.0
         
-        self._playback_target_duration = random.uniform(min_duration, max_duration)
+        self._playback_target_duration = self._rng.uniform(min_duration, max_duration)
         self.logger.debug(f"[session] New playback will run for {self._playback_target_duration:.1f}s (range: {min_duration:.1f}-{max_duration:.1f}s)")
     
     def _apply_custom_text(self, text_messages: list[str]) -> None:
@@ -2309,15 +2353,38 @@ class SessionRunner:
         
         self.logger.info("[session] Transition requested, waiting for cycle boundary...")
         self._pending_transition = True
-        self._pending_transition_since_ts = time.perf_counter()
+        self._pending_transition_since_ts = self._now()
 
         # Determine next cue index
         self._transition_target_cue = self._calculate_next_cue_index()
         self._prefetch_cue_audio(self._transition_target_cue, force=True, async_allowed=True)
+        self._announce_upcoming_cut("cue")
     
+    def _announce_upcoming_cut(self, kind: str) -> None:
+        """Tell encoders a cut is coming at the next cycle boundary (estimated from recent boundaries)."""
+        eta_s = self._cycle_boundary_interval_ema_s
+        if self._last_cycle_boundary_ts is not None:
+            eta_s -= self._now() - self._last_cycle_boundary_ts
+        self.encoder_hints.publish_upcoming(kind, max(0.0, eta_s))
+
+    def _publish_motion_hint(self) -> None:
+        """Tell motion-adaptive encoders how fast the spiral turns and when the media changes next."""
+        spiral = getattr(self.compositor, "director", None)
+        try:
+            rpm = float(getattr(spiral, "rotation_speed", 0.0) or 0.0)
+        except (TypeError, ValueError):
+            rpm = 0.0
+        next_media_in_s = None
+        if self._last_cycle_boundary_ts is not None:
+            elapsed = self._now() - self._last_cycle_boundary_ts
+            # Long overdue means the cycler stopped (e.g. one image held); don't keep expecting it.
+            if elapsed <= 2.0 * self._cycle_boundary_interval_ema_s:
+                next_media_in_s = self._cycle_boundary_interval_ema_s - elapsed
+        self.encoder_hints.publish_motion(rpm, next_media_in_s)
+
     def _on_cycle_boundary(self) -> None:
         """Callback fired when visual director crosses a cycle boundary."""
-        now = time.perf_counter()
+        now = self._now()
         if self._last_cycle_boundary_ts is not None:
             interval = now - self._last_cycle_boundary_ts
             interval = max(0.05, min(60.0, float(interval)))
@@ -2408,6 +2475,15 @@ class SessionRunner:
                 self.logger.warning(f"  ⚠️  MEMORY LEAK DETECTED: {final_mem:.0f}MB is excessive!")
             self.logger.warning("")
 
+        gc_info = perf_blockers.gc_stats()
+        if gc_info["installed"]:
+            self.logger.warning(
+                "🧹 GC: %d/%d/%d collections (gen0/1/2), worst %.1fms, gen2 total %.1fms",
+                *gc_info["pauses"],
+                max(gc_info["max_ms"]),
+                gc_info["total_ms"][2],
+            )
+
         if self._worst_frame_spike:
             blocker = self._worst_frame_spike.get("blocker")
             if blocker:
@@ -2480,6 +2556,8 @@ class SessionRunner:
                 # Start next cue immediately
                 success = self._start_cue(next_cue_index)
                 span.annotate(success=success)
+                if success:
+                    self.encoder_hints.publish_cut("cue")
                 
                 # Emit transition end event
                 self.event_emitter.emit(SessionEvent(
@@ -2509,9 +2587,12 @@ class SessionRunner:
                 span.annotate(success=success)
                 
                 if success:
+                    # The visual fade is not rendered yet, so the new cue is still a hard cut.
+                    self.encoder_hints.publish_cut("cue")
+
                     # Initialize fade state
                     self._transition_in_progress = True
-                    self._transition_start_time = time.time()
+                    self._transition_start_time = self._now()
                     self._transition_fade_alpha = 1.0  # Start fully showing old cue
                     
                     # Note: The fade will be updated in update() method
@@ -2536,7 +2617,7 @@ class SessionRunner:
             return
         
         # Calculate fade progress
-        elapsed = time.time() - self._transition_start_time
+        elapsed = self._now() - self._transition_start_time
         fade_duration_s = (self.cuelist.transition_duration_ms or 2000.0) / 1000.0
         
         # Calculate alpha (1.0 = old cue visible, 0.0 = new cue visible)
@@ -2649,6 +2730,7 @@ class SessionRunner:
     
     # ===== Manual Control =====
     
+    @replay.traced("skip_next")
     def skip_to_next_cue(self) -> bool:
         """Manually skip to next cue (cycle-synchronized)."""
         if self._state != SessionState.RUNNING:
@@ -2661,6 +2743,7 @@ class SessionRunner:
         self._request_transition()
         return True
     
+    @replay.traced("skip_previous")
     def skip_to_previous_cue(self) -> bool:
         """Manually skip to previous cue (cycle-synchronized)."""
         if self._state != SessionState.RUNNING:
@@ -2678,8 +2761,10 @@ class SessionRunner:
         self._pending_transition = True
         self._transition_target_cue = prev_index
         self._prefetch_cue_audio(prev_index)
+        self._announce_upcoming_cut("cue")
         return True
     
+    @replay.traced("skip_to")
     def skip_to_cue(self, cue_index: int) -> bool:
         """Manually skip to specific cue (cycle-synchronized)."""
         if self._state != SessionState.RUNNING:
@@ -2696,6 +2781,7 @@ class SessionRunner:
         self._pending_transition = True
         self._transition_target_cue = cue_index
         self._prefetch_cue_audio(cue_index)
+        self._announce_upcoming_cut("cue")
         return True
     
     # ===== Helper Methods =====
@@ -2705,11 +2791,12 @@ class SessionRunner:
         if not self._session_start_time:
             return 0.0
         
-        elapsed = time.time() - self._session_start_time - self._total_paused_time
+        now = self._now()
+        elapsed = now - self._session_start_time - self._total_paused_time
         
         # If currently paused, don't count current pause duration
         if self._state == SessionState.PAUSED and self._pause_start_time:
-            elapsed -= (time.time() - self._pause_start_time)
+            elapsed -= (now - self._pause_start_time)
         
         return elapsed
     
@@ -2718,4 +2805,4 @@ class SessionRunner:
         if not self._cue_start_time:
             return 0.0
         
-        return time.time() - self._cue_start_time
+        return self._now() - self._cue_start_time
@@ -11,6 +11,7 @@ from pathlib import Path
 from datetime import datetime
 from typing import Optional, Dict, Any
 
+from .content import bundle as session_bundle
 from .platform_paths import ensure_dir, get_sessions_dir
 
 logger = logging.getLogger(__name__)
@@ -118,7 +119,9 @@ class SessionManager:
         """Load session from file.
         
         Args:
-            filepath: Path to .session.json file
+            filepath: Path to .session.json or .mgbundle file. A bundle is
+                mounted so its media resolves from inside it, and read ahead
+                in the background; saving then writes a .session.json beside it.
         
         Returns:
             Loaded session dictionary
@@ -133,8 +136,11 @@ class SessionManager:
         if not filepath.exists():
             raise FileNotFoundError(f"Session file not found: {filepath}")
         
-        with open(filepath, 'r', encoding='utf-8') as f:
-            session = json.load(f)
+        if session_bundle.is_bundle_file(filepath):
+            _bundle, session = session_bundle.open_session_bundle(filepath)
+        else:
+            with open(filepath, 'r', encoding='utf-8') as f:
+                session = json.load(f)
         
         # Validate session structure
         self._validate_session(session)
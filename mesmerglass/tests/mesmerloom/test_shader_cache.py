@@ -0,0 +1,132 @@
+"""Program-binary cache: hit on the second link, fall back to source when the
+driver rejects a binary, and key on the driver as well as the sources."""
+
+import numpy as np
+import pytest
+
+from mesmerglass.mesmerloom import shader_cache
+
+
+class _FakeGL:
+    """Just enough of PyOpenGL for link_program; binaries are b"BIN:" + linked sources."""
+
+    GL_VENDOR, GL_RENDERER, GL_VERSION = 1, 2, 3
+    GL_VERTEX_SHADER, GL_FRAGMENT_SHADER = 10, 11
+    GL_LINK_STATUS, GL_PROGRAM_BINARY_LENGTH = 20, 21
+    GL_NUM_PROGRAM_BINARY_FORMATS = 30
+    GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE = 40, 1
+    FORMAT = 0x8E21
+
+    def __init__(self, renderer="FakeGPU"):
+        self.renderer = renderer
+        self.reject_binaries = False
+        self.sources = {}
+        self.programs = {}  # id -> {"shaders": [...], "linked": bool, "binary": bytes}
+        self.compiles = 0
+
+    def compile(self, src, stype):
+        self.compiles += 1
+        sid = 100 + len(self.sources)
+        self.sources[sid] = src
+        return sid
+
+    def glGetString(self, name):
+        return {1: b"Fake", 2: self.renderer.encode(), 3: b"4.6 fake"}[name]
+
+    def glGetIntegerv(self, name):
+        return 1
+
+    def glCreateProgram(self):
+        pid = len(self.programs) + 1
+        self.programs[pid] = {"shaders": [], "linked": False, "binary": b""}
+        return pid
+
+    def glProgramParameteri(self, prog, pname, value):
+        pass
+
+    def glAttachShader(self, prog, sid):
+        self.programs[prog]["shaders"].append(sid)
+
+    def glLinkProgram(self, prog):
+        p = self.programs[prog]
+        p["linked"] = True
+        p["binary"] = b"BIN:" + "|".join(self.sources[s] for s in p["shaders"]).encode()
+
+    def glGetProgramiv(self, prog, pname):
+        p = self.programs[prog]
+        return p["linked"] if pname == self.GL_LINK_STATUS else len(p["binary"])
+
+    def glGetProgramInfoLog(self, prog):
+        return b""
+
+    def glDeleteShader(self, sid):
+        pass
+
+    def glDeleteProgram(self, prog):
+        self.programs.pop(prog, None)
+
+    def glProgramBinary(self, prog, fmt, data, length):
+        blob = bytes(np.asarray(data)[:length])
+        self.programs[prog]["linked"] = not self.reject_binaries and fmt == self.FORMAT and blob.startswith(b"BIN:")
+        self.programs[prog]["binary"] = blob
+
+    def glGetProgramBinary(self, prog, size, out_len, fmt, buf):
+        blob = self.programs[prog]["binary"]
+        buf[: len(blob)] = np.frombuffer(blob, dtype=np.uint8)
+        out_len[0] = len(blob)
+        fmt[0] = self.FORMAT
+
+
+@pytest.fixture
+def fake_gl(monkeypatch, tmp_path):
+    gl = _FakeGL()
+    monkeypatch.setattr(shader_cache, "GL", gl)
+    monkeypatch.setenv("MESMERGLASS_SHADER_CACHE_DIR", str(tmp_path))
+    monkeypatch.delenv("MESMERGLASS_SHADER_CACHE", raising=False)
+    return gl
+
+
+STAGES = [(_FakeGL.GL_VERTEX_SHADER, "void main(){}"), (_FakeGL.GL_FRAGMENT_SHADER, "out vec4 c;")]
+
+
+def _link(gl):
+    return shader_cache.link_program(STAGES, label="Test program", compile_shader=gl.compile)
+
+
+def test_second_link_loads_binary(fake_gl, tmp_path):
+    before = shader_cache.stats()
+    first = _link(fake_gl)
+    second = _link(fake_gl)
+
+    assert fake_gl.programs[first]["linked"] and fake_gl.programs[second]["linked"]
+    assert fake_gl.compiles == 2  # only the first link compiled
+    assert len(list(tmp_path.glob("*.bin"))) == 1
+    after = shader_cache.stats()
+    assert after["hits"] - before["hits"] == 1
+    assert after["misses"] - before["misses"] == 1
+
+
+def test_rejected_binary_falls_back_and_is_replaced(fake_gl, tmp_path):
+    _link(fake_gl)
+    fake_gl.reject_binaries = True  # e.g. driver update
+
+    prog = _link(fake_gl)
+
+    assert fake_gl.programs[prog]["linked"]
+    assert fake_gl.compiles == 4
+    assert len(list(tmp_path.glob("*.bin"))) == 1
+
+
+def test_key_changes_with_driver_and_source(fake_gl):
+    key = shader_cache.program_key(STAGES)
+    assert shader_cache.program_key(STAGES[:1]) != key
+    fake_gl.renderer = "OtherGPU"
+    assert shader_cache.program_key(STAGES) != key
+
+
+def test_disabled_cache_writes_nothing(fake_gl, tmp_path, monkeypatch):
+    monkeypatch.setenv("MESMERGLASS_SHADER_CACHE", "0")
+    _link(fake_gl)
+    _link(fake_gl)
+    assert fake_gl.compiles == 4
+    assert not list(tmp_path.iterdir())
@@ -0,0 +1,116 @@
+"""
+Annex-B helper tests
+
+Covers the NAL table scan and the per-frame access-unit rewrite used by the
+streaming server (AUD insertion, SEI stripping, IDR detection), plus the HEVC
+NAL header variants.
+"""
+
+from mesmerglass.mesmervisor.annexb import (
+    HEVC_NAL_AUD,
+    HEVC_NAL_IDR_N_LP,
+    HEVC_NAL_SPS,
+    HEVC_NAL_VPS,
+    NAL_AUD,
+    NAL_IDR,
+    NAL_SEI,
+    NAL_SPS,
+    access_unit_contains_idr,
+    annexb_nal_table,
+    h264_access_unit_contains_idr,
+    h264_ebsp_to_rbsp,
+    h264_rewrite_access_unit,
+    hevc_slice_brief,
+    hevc_sps_dimensions,
+    iter_annexb_nal_units,
+    iter_annexb_nals,
+)
+
+SC4 = b"\x00\x00\x00\x01"
+SC3 = b"\x00\x00\x01"
+AUD = SC4 + b"\x09\xF0"
+SPS = SC4 + b"\x67\x42\x00\x1f"
+SEI = SC3 + b"\x06\x05\x01\x80"
+IDR = SC3 + b"\x65\x88\x84\x21"
+SLICE = SC4 + b"\x41\x9a\x00"
+
+# HEVC: two-byte NAL headers, type in bits 1-6 of the first byte.
+H265_AUD = SC4 + b"\x46\x01\x50"
+H265_VPS = SC4 + b"\x40\x01\x0c\x01"
+H265_IDR = SC4 + b"\x28\x01\xaf\x1d"  # IDR_N_LP, first slice of the picture
+H265_TRAIL = SC4 + b"\x02\x01\xd0\x10"
+# SPS from libx265 for a 200x120 picture (coded as 200x128 + conformance window).
+H265_SPS = bytes.fromhex(
+    "42010101600000030090000003000003003ca01a202072cb96e92930b9a020000003002000000303c1"
+)
+
+
+class TestNalTable:
+    def test_mixed_start_codes(self):
+        data = SPS + SEI + IDR
+        assert [t for t, _ in iter_annexb_nals(data)] == [NAL_SPS, NAL_SEI, NAL_IDR]
+        assert annexb_nal_table(data)[0] == (0, 4, 8)
+        # A trailing zero before a 4-byte start code belongs to the start code.
+        units = list(iter_annexb_nal_units(SEI + SLICE))
+        assert units == [(NAL_SEI, b"\x06\x05\x01\x80"), (1, b"\x41\x9a\x00")]
+
+    def test_not_annexb(self):
+        assert annexb_nal_table(b"") == []
+        assert annexb_nal_table(b"\x12\x34\x56") == []
+        assert list(iter_annexb_nals(SC3)) == []
+
+
+class TestRewrite:
+    def test_insert_aud_once(self):
+        out = h264_rewrite_access_unit(SPS + IDR, insert_aud=True)
+        assert out == AUD + SPS + IDR
+        assert h264_rewrite_access_unit(out, insert_aud=True) == out
+
+    def test_strip_sei(self):
+        out = h264_rewrite_access_unit(SPS + SEI + IDR + SEI, strip_sei=True)
+        assert out == SPS + IDR
+        assert NAL_SEI not in [t for t, _ in iter_annexb_nals(out)]
+
+    def test_aud_and_sei_together(self):
+        out = h264_rewrite_access_unit(SEI + SLICE, insert_aud=True, strip_sei=True)
+        assert [t for t, _ in iter_annexb_nals(out)] == [NAL_AUD, 1]
+
+    def test_non_annexb_untouched(self):
+        data = b"\x01\x02\x03\x04"
+        assert h264_rewrite_access_unit(data, insert_aud=True, strip_sei=True) is data
+
+
+class TestScans:
+    def test_contains_idr(self):
+        assert h264_access_unit_contains_idr(AUD + SPS + IDR)
+        assert not h264_access_unit_contains_idr(AUD + SLICE)
+        assert not h264_access_unit_contains_idr(b"")
+
+    def test_ebsp_to_rbsp(self):
+        assert h264_ebsp_to_rbsp(b"\x00\x00\x03\x01") == b"\x00\x00\x01"
+        assert h264_ebsp_to_rbsp(b"\x00\x00\x03\x00\x00\x03") == b"\x00\x00\x00\x00"
+        assert h264_ebsp_to_rbsp(b"\x00\x00\x03\x03") == b"\x00\x00\x03"
+        assert h264_ebsp_to_rbsp(b"\x12\x03") == b"\x12\x03"
+
+
+class TestHevc:
+    def test_nal_types(self):
+        data = H265_AUD + H265_VPS + SC3 + H265_SPS + H265_IDR
+        assert [t for t, _ in iter_annexb_nals(data, hevc=True)] == [
+            HEVC_NAL_AUD,
+            HEVC_NAL_VPS,
+            HEVC_NAL_SPS,
+            HEVC_NAL_IDR_N_LP,
+        ]
+
+    def test_contains_idr(self):
+        assert access_unit_contains_idr(H265_AUD + H265_VPS + H265_IDR, hevc=True)
+        assert not access_unit_contains_idr(H265_AUD + H265_TRAIL, hevc=True)
+        # The H.264 reading of the same bytes must not be used for HEVC streams.
+        assert not access_unit_contains_idr(H265_IDR, hevc=False)
+
+    def test_slice_brief_and_sps(self):
+        assert hevc_slice_brief(H265_IDR[4:]) == (1, 0)
+        assert hevc_slice_brief(H265_VPS[4:]) is None
+        assert hevc_sps_dimensions(H265_SPS) == (200, 120)
+        assert hevc_sps_dimensions(H265_VPS[4:]) is None
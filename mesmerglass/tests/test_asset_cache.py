@@ -0,0 +1,74 @@
+"""
+Headset asset cache tests
+
+Checks the server-side routing policy (ordinary packet, then PUT + SHOW, then
+SHOW only), eviction handling via NEED, and the control-byte parser.
+"""
+
+import struct
+
+from mesmerglass.mesmervisor.asset_cache import (
+    ASSET_FORMAT_JPEG,
+    CONTROL_ASSET_PUT,
+    CONTROL_ASSET_SHOW,
+    AssetLedger,
+    ControlParser,
+    asset_id,
+)
+
+
+def _unpack(packet):
+    (size,) = struct.unpack_from("!I", packet)
+    magic, frame_id, left_len, right_len = struct.unpack_from("!4sIII", packet, 4)
+    assert magic == b"VRHC" and frame_id == 0 and size == 16 + left_len + right_len
+    left = packet[20:20 + left_len]
+    return left[0], left[1:], packet[20 + left_len:20 + left_len + right_len]
+
+
+def test_ledger_sends_recurring_frames_once():
+    ledger = AssetLedger(ASSET_FORMAT_JPEG)
+    left, right = b"left-jpeg" * 10, b"right-jpeg" * 10
+    assert ledger.route(left, right) is None  # cache not active yet
+
+    ledger.have([])
+    assert ledger.route(left, right) is None  # first sighting: ordinary packet
+
+    packets = ledger.route(left, right)
+    assert [_unpack(p)[0] for p in packets] == [CONTROL_ASSET_PUT, CONTROL_ASSET_PUT, CONTROL_ASSET_SHOW]
+    cmd, args, payload = _unpack(packets[0])
+    assert struct.unpack("!QB", args) == (asset_id(left), ASSET_FORMAT_JPEG)
+    assert payload == left
+
+    packets = ledger.route(left, right)
+    assert len(packets) == 1 and len(packets[0]) == 37
+    assert struct.unpack("!QQ", _unpack(packets[0])[1]) == (asset_id(left), asset_id(right))
+    assert ledger.puts == 2 and ledger.shows == 2
+    assert ledger.bytes_saved == len(left) + len(right)
+
+
+def test_ledger_trusts_have_and_resends_after_need():
+    data = b"mono-frame"
+    ledger = AssetLedger()
+    ledger.have([asset_id(data)])
+
+    packets = ledger.route(data, b"")
+    assert len(packets) == 1
+    assert struct.unpack("!QQ", _unpack(packets[0])[1]) == (asset_id(data), asset_id(data))
+
+    ledger.need(asset_id(data))
+    packets = ledger.route(data, b"")
+    assert [_unpack(p)[0] for p in packets] == [CONTROL_ASSET_PUT, CONTROL_ASSET_SHOW]
+    assert ledger.misses_reported == 1
+
+
+def test_control_parser_handles_fragments():
+    parser = ControlParser()
+    have = bytes([0x02]) + struct.pack("!H", 2) + struct.pack("!QQ", 7, 9)
+    need = bytes([0x03]) + struct.pack("!Q", 42)
+    stream = bytes([0x01, 0x7F]) + have + need
+
+    events = []
+    for i in range(len(stream)):
+        events += parser.feed(stream[i:i + 1])
+    assert events == [("need_idr", None), ("have", [7, 9]), ("need", 42)]
+    assert parser.feed(b"") == []
@@ -0,0 +1,130 @@
+"""Tests for the compositor capture bus (GL-free scheduling and conversion)."""
+
+import numpy as np
+import pytest
+
+from mesmerglass.mesmerloom.capture_bus import (
+    CaptureBus,
+    CaptureFormat,
+    CaptureVariant,
+    rgb_to_nv12,
+)
+
+
+def _sink(store):
+    return lambda frame: store.append(frame)
+
+
+def test_consumers_are_rate_limited_independently():
+    bus = CaptureBus()
+    fast, slow = [], []
+    bus.register("fast", _sink(fast), max_fps=60)
+    bus.register("slow", _sink(slow), max_fps=15)
+
+    due_counts = {"fast": 0, "slow": 0}
+    for i in range(60):  # one second of 60 Hz paints
+        plan = bus.plan(1920, 1080, now=1.0 + i / 60.0)
+        for consumers in plan.values():
+            for c in consumers:
+                due_counts[c.name] += 1
+
+    assert due_counts["fast"] == 60
+    assert 14 <= due_counts["slow"] <= 16
+
+
+def test_consumers_with_same_request_share_one_variant():
+    bus = CaptureBus()
+    bus.register("vr", _sink([]), width=2048, height=1024)
+    bus.register("recorder", _sink([]), width=2048, height=1024)
+    bus.register("preview", _sink([]), fmt=CaptureFormat.PREVIEW)
+
+    plan = bus.plan(1920, 1080, now=1.0)
+
+    assert len(plan) == 2
+    shared = plan[CaptureVariant(2048, 1024, CaptureFormat.RGB, False)]
+    assert sorted(c.name for c in shared) == ["recorder", "vr"]
+
+
+def test_preview_keeps_aspect_inside_bounding_box():
+    bus = CaptureBus()
+    bus.register("preview", _sink([]), width=480, height=270, fmt="preview")
+
+    (variant,) = bus.plan(1000, 1000, now=1.0).keys()
+
+    assert (variant.width, variant.height) == (270, 270)
+
+
+def test_zero_size_means_source_size_and_nv12_is_even():
+    bus = CaptureBus()
+    bus.register("full", _sink([]))
+    bus.register("enc", _sink([]), fmt=CaptureFormat.NV12)
+
+    sizes = {v.fmt: (v.width, v.height) for v in bus.plan(1281, 721, now=1.0)}
+
+    assert sizes[CaptureFormat.RGB] == (1281, 721)
+    assert sizes[CaptureFormat.NV12] == (1280, 720)
+
+
+def test_unregister_bumps_generation_and_removes_consumer():
+    bus = CaptureBus()
+    bus.register("a", _sink([]))
+    gen = bus.generation
+    bus.unregister("a")
+    bus.unregister("a")
+
+    assert bus.generation == gen + 1
+    assert not bus.has_consumers()
+    assert bus.plan(64, 64, now=1.0) == {}
+
+
+def test_deliver_converts_nv12_and_isolates_consumer_errors():
+    bus = CaptureBus()
+    got = []
+
+    def boom(_frame):
+        raise RuntimeError("consumer bug")
+
+    bus.register("bad", boom, fmt=CaptureFormat.NV12)
+    bus.register("good", _sink(got), fmt=CaptureFormat.NV12)
+    plan = bus.plan(4, 4, now=1.0)
+    (variant, consumers), = plan.items()
+
+    bus.deliver(variant, consumers, np.zeros((4, 4, 3), dtype=np.uint8))
+
+    assert len(got) == 1
+    assert got[0].shape == (6, 4)
+
+
+def test_nv12_readback_from_gpu_pass_is_delivered_as_is():
+    bus = CaptureBus()
+    got = []
+    bus.register("enc", _sink(got), fmt=CaptureFormat.NV12)
+    (variant, consumers), = bus.plan(8, 4, now=1.0).items()
+    planes = np.arange(6 * 8, dtype=np.uint8).reshape(6, 8)
+
+    assert variant.readback_format == "nv12"
+    assert variant.readback_shape == planes.shape
+    bus.deliver(variant, consumers, planes)
+
+    assert got[0] is planes
+
+
+@pytest.mark.parametrize(
+    "rgb, y, u, v",
+    [
+        ((0, 0, 0), 16, 128, 128),
+        ((255, 255, 255), 235, 128, 128),
+        ((255, 0, 0), 82, 90, 240),
+    ],
+)
+def test_rgb_to_nv12_bt601_reference_values(rgb, y, u, v):
+    frame = np.empty((4, 6, 3), dtype=np.uint8)
+    frame[:, :] = rgb
+
+    out = rgb_to_nv12(frame)
+
+    assert out.shape == (6, 6)
+    assert np.all(np.abs(out[:4].astype(int) - y) <= 1)
+    uv = out[4:].reshape(2, 3, 2)
+    assert np.all(np.abs(uv[:, :, 0].astype(int) - u) <= 1)
+    assert np.all(np.abs(uv[:, :, 1].astype(int) - v) <= 1)
@@ -0,0 +1,63 @@
+"""
+Encoder hint tests
+
+Checks that each consumer sees a scene cut exactly once, on the first frame
+rendered after it, and that announced cuts and motion hints expire.
+"""
+
+import numpy as np
+
+from mesmerglass.mesmerloom.capture_bus import CaptureBus
+from mesmerglass.session.encoder_hints import EncoderHints
+
+
+def test_cut_applies_to_first_frame_rendered_after_it():
+    hints = EncoderHints()
+    assert hints.seq == 0
+    cut = hints.publish_cut("cue", at=10.0)
+    assert hints.seq == cut.seq == 1
+
+    assert hints.cut_for_frame(0, rendered_at=9.9) is None  # frame still shows the old cue
+    assert hints.cut_for_frame(0, rendered_at=10.0) == cut
+    assert hints.cut_for_frame(cut.seq, rendered_at=11.0) is None  # already consumed
+
+
+def test_back_to_back_cuts_collapse_to_newest():
+    hints = EncoderHints()
+    hints.publish_cut("cue", at=1.0)
+    newest = hints.publish_cut("playback", at=1.5)
+    assert hints.cut_for_frame(0, rendered_at=2.0) == newest
+
+
+def test_upcoming_cut_window_and_expiry():
+    hints = EncoderHints()
+    assert not hints.cut_due_within(0.25)
+    hints.publish_upcoming("cue", eta_s=0.5)
+    now = hints._upcoming_at - 0.5
+    assert not hints.cut_due_within(0.25, now=now)
+    assert hints.cut_due_within(0.25, now=now + 0.3)
+    assert not hints.cut_due_within(0.25, now=now + 2.0)  # stale announcement
+    hints.publish_cut("cue")
+    assert not hints.cut_due_within(0.25, now=now + 0.5)
+
+
+def test_motion_hint_goes_stale():
+    hints = EncoderHints()
+    assert hints.motion() is None
+    hints.publish_motion(-12.0, next_media_in_s=0.4)
+    motion = hints.motion(now=hints._motion.at + 0.5)
+    assert motion.spiral_rpm == 12.0
+    assert motion.next_media_at == motion.at + 0.4
+    assert hints.motion(now=motion.at + 2.0) is None
+
+
+def test_capture_bus_stamps_render_time():
+    bus = CaptureBus()
+    seen = []
+    bus.register("vr", seen.append, width=4, height=4)
+    frame = np.zeros((4, 4, 3), dtype=np.uint8)
+    plan = bus.plan(4, 4, now=0.0)
+    for variant, consumers in plan.items():
+        bus.deliver(variant, consumers, frame, rendered_at=42.0)
+    assert len(seen) == 1
+    assert bus.rendered_at == 42.0
@@ -0,0 +1,171 @@
+"""
+Warm encoder pool tests
+
+Checks that checkouts are served from prebuilt spares, that the pool refills in
+the background, that reusable encoders are reset and kept while H.264-style
+encoders are closed, that spares of profiles no longer used are closed, and
+that a streaming client's first frame comes from a warm encoder.
+"""
+
+import asyncio
+import socket
+import threading
+import time
+
+import numpy as np
+
+from mesmerglass.mesmervisor.encoder_pool import EncoderPool, EncoderProfile
+from mesmerglass.mesmervisor.frame_encoder import FrameEncoder, create_encoder
+from mesmerglass.mesmervisor.gpu_utils import EncoderType
+from mesmerglass.mesmervisor.load_client import run_load
+from mesmerglass.mesmervisor.streaming_server import VRStreamingServer
+
+PROFILE = EncoderProfile(EncoderType.JPEG, 64, 32)
+
+
+class FakeEncoder(FrameEncoder):
+    def __init__(self, reusable):
+        self.reusable = reusable
+        self.resets = 0
+        self.closed = threading.Event()
+
+    def encode(self, frame):
+        return b"x"
+
+    def get_encoder_type(self):
+        return EncoderType.JPEG
+
+    def close(self):
+        self.closed.set()
+
+    def reset(self):
+        self.resets += 1
+        return self.reusable
+
+
+def _slow_factory(built, reusable=True, delay=0.05):
+    def factory(profile):
+        time.sleep(delay)
+        enc = FakeEncoder(reusable)
+        built.append(enc)
+        return enc
+
+    return factory
+
+
+def _wait_for(predicate, timeout=2.0):
+    deadline = time.perf_counter() + timeout
+    while not predicate() and time.perf_counter() < deadline:
+        time.sleep(0.005)
+    return predicate()
+
+
+def test_checkout_uses_warm_spare_and_refills():
+    built = []
+    pool = EncoderPool(spares=1, factory=_slow_factory(built))
+    try:
+        pool.prewarm(PROFILE)
+        assert _wait_for(lambda: pool.stats()["idle"] == 1)
+        start = time.perf_counter()
+        enc = pool.checkout(PROFILE)
+        assert (time.perf_counter() - start) < 0.04  # no 50 ms build on the connect path
+        assert enc is built[0]
+        assert _wait_for(lambda: pool.stats()["idle"] == 1)  # replacement built in the background
+        stats = pool.stats()
+        assert stats["hits"] == 1 and stats["misses"] == 0 and stats["warmed"] == 2
+    finally:
+        pool.close()
+
+
+def test_checkin_keeps_reusable_and_closes_the_rest():
+    built = []
+    pool = EncoderPool(spares=1, factory=_slow_factory(built, reusable=False, delay=0.0))
+    try:
+        enc = pool.checkout(PROFILE)  # cold: nothing prewarmed
+        assert pool.stats()["misses"] == 1
+        pool.checkin(PROFILE, enc)
+        assert enc.resets == 1 and enc.closed.wait(1.0)
+
+        reusable = FakeEncoder(True)
+        assert _wait_for(lambda: pool.stats()["idle"] == 1)
+        pool.checkin(PROFILE, reusable)  # pool already full: closed, not kept
+        assert reusable.closed.wait(1.0)
+    finally:
+        pool.close()
+    assert all(e.closed.is_set() for e in built)
+
+    disabled = EncoderPool(spares=0, factory=_slow_factory([], delay=0.0))
+    enc = disabled.checkout(PROFILE)
+    disabled.checkin(PROFILE, enc)
+    assert enc.closed.is_set() and disabled.stats()["idle"] == 0
+
+
+
+def test_unused_profiles_are_evicted():
+    built = []
+    now = [0.0]
+    pool = EncoderPool(spares=1, factory=_slow_factory(built, delay=0.0), ttl_s=60.0, max_profiles=2,
+                       clock=lambda: now[0])
+    small, large = PROFILE, EncoderProfile(EncoderType.JPEG, 128, 64)
+    try:
+        pool.prewarm(small)
+        assert _wait_for(lambda: pool.stats()["idle"] == 1)
+        enc = pool.checkout(large)  # e.g. resolution change
+        now[0] = 30.0
+        pool.prewarm(EncoderProfile(EncoderType.JPEG, 32, 16))  # third profile: LRU idle one goes
+        assert _wait_for(lambda: built[0].closed.is_set())
+        assert pool.stats()["evicted"] == 1
+
+        now[0] = 200.0
+        with pool._lock:
+            pool._evict_locked(now[0])
+        assert _wait_for(lambda: pool.stats()["idle"] == 1)  # only the checked-out profile's spare
+        assert list(pool._idle) == [large]
+        pool.checkin(large, enc)
+    finally:
+        pool.close()
+
+def test_etc2_reset_forgets_tile_cache():
+    enc = create_encoder(EncoderType.ETC2, 16, 16)
+    frame = np.full((16, 16, 3), 128, np.uint8)
+    enc.encode(frame)
+    assert enc.reset() is True
+    before = enc._cache.tiles_encoded
+    enc.encode(frame)
+    assert enc._cache.tiles_encoded > before  # full frame again, nothing reused
+
+
+def test_server_first_frame_uses_prewarmed_encoder(monkeypatch):
+    monkeypatch.delenv("MESMERGLASS_VRHT_SIZE", raising=False)
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        port = s.getsockname()[1]
+    frame = np.zeros((32, 64, 3), np.uint8)
+    pool = EncoderPool(spares=1)
+    server = VRStreamingServer(
+        host="127.0.0.1",
+        port=port,
+        discovery_port=None,
+        encoder_type=EncoderType.ETC2,
+        width=64,
+        height=32,
+        fps=30,
+        frame_callback=lambda: frame,
+        encoder_pool=pool,
+    )
+    server.target_width, server.target_height = 64, 32
+    server.start_server()
+    try:
+        assert _wait_for(lambda: pool.stats()["idle"] == 1)
+        results = asyncio.run(run_load([("127.0.0.1", port)], duration=0.3, warmup=0.0))
+        assert results[0].error is None and results[0].frames > 0
+    finally:
+        server.stop_server()
+    try:
+        # Returned on disconnect; the refilled spare already fills the pool, so it is closed.
+        assert _wait_for(lambda: pool.stats()["discarded"] == 1)
+        stats = server.startup_stats()
+    finally:
+        pool.close()
+    assert stats["first_frame_ms"]["count"] == 1
+    assert stats["encoder_pool"]["hits"] == 1 and stats["encoder_pool"]["misses"] == 0
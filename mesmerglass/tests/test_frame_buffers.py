@@ -0,0 +1,60 @@
+"""
+Frame buffer pool and GC monitor tests
+
+Checks that pooled frames return to the pool only when the last view is gone,
+and that garbage collections show up in perf_blockers.
+"""
+
+import gc
+
+import numpy as np
+
+from mesmerglass.frame_buffers import FrameBufferPool
+from mesmerglass.session import perf_blockers
+
+
+def test_buffer_returns_when_last_view_dies():
+    pool = FrameBufferPool(max_idle=2)
+    frame = pool.acquire((4, 6, 3))
+    assert frame.shape == (4, 6, 3) and frame.dtype == np.uint8 and frame.flags.c_contiguous
+    frame[:] = 7
+    view = frame[::-1]
+    del frame
+    assert pool.stats()["idle"] == 0  # the view still holds the buffer
+    assert int(view.sum()) == 7 * view.size
+    del view
+    assert pool.stats()["idle"] == 1
+
+    again = pool.acquire((4, 6, 3))
+    assert pool.hits == 1 and pool.misses == 1
+    assert int(again.sum()) == 7 * again.size  # same memory, not cleared
+
+
+def test_copy_and_idle_cap():
+    pool = FrameBufferPool(max_idle=1)
+    src = np.arange(24, dtype=np.uint8).reshape(2, 4, 3)
+    a, b = pool.copy(src), pool.copy(src[:, ::-1])
+    assert np.array_equal(a, src) and np.array_equal(b, src[:, ::-1])
+    del a, b
+    stats = pool.stats()
+    assert stats["idle"] == 1 and stats["returned"] == 1 and stats["dropped"] == 1
+
+
+def test_disabled_pool_allocates():
+    pool = FrameBufferPool(max_idle=0)
+    frame = pool.acquire((2, 2, 3))
+    assert frame.base is None
+    del frame
+    assert pool.stats()["idle"] == 0
+
+
+def test_gc_pauses_are_recorded():
+    perf_blockers.install_gc_monitor(min_ms=0.0)
+    try:
+        before = perf_blockers.gc_stats()["pauses"][2]
+        gc.collect()
+        assert perf_blockers.gc_stats()["pauses"][2] == before + 1
+        ops = [rec["operation"] for rec in perf_blockers.recent_all(ttl_s=5.0)]
+        assert "gc.gen2" in ops
+    finally:
+        perf_blockers.uninstall_gc_monitor()
@@ -0,0 +1,58 @@
+"""
+Frame dump writer tests
+
+The writer must round-trip raw frames, keep .h264 appends in order, and drop
+(not block) when its queue is full.
+"""
+
+import threading
+import zlib
+
+import numpy as np
+
+from mesmerglass.mesmervisor.frame_dump import FrameDumpWriter, load_raw_frame
+
+
+def test_raw_frame_round_trip(tmp_path):
+    frame = (np.arange(48 * 64 * 3) % 251).astype(np.uint8).reshape(48, 64, 3)
+    writer = FrameDumpWriter()
+    assert writer.submit_frame(tmp_path / "vrh2_raw_000001", frame)
+    frame[:] = 0  # the writer must have taken a copy
+    writer.close()
+
+    files = list(tmp_path.glob("vrh2_raw_000001_crc*.vrraw"))
+    assert len(files) == 1
+    loaded, crc = load_raw_frame(files[0])
+    expected = (np.arange(48 * 64 * 3) % 251).astype(np.uint8).reshape(48, 64, 3)
+    np.testing.assert_array_equal(loaded, expected)
+    assert crc == zlib.crc32(expected.tobytes()) & 0xFFFFFFFF
+    assert files[0].name.endswith(f"_crc{crc:08x}.vrraw")
+    assert writer.frames_written == 1 and writer.dropped == 0
+
+
+def test_stream_appends_in_order(tmp_path):
+    writer = FrameDumpWriter(max_pending=64)
+    handle = writer.open_stream(tmp_path / "out.h264")
+    for i in range(20):
+        assert writer.append(handle, bytes([i]) * 10)
+    writer.close()
+    assert (tmp_path / "out.h264").read_bytes() == b"".join(bytes([i]) * 10 for i in range(20))
+
+
+def test_full_queue_drops_instead_of_blocking(tmp_path):
+    writer = FrameDumpWriter(max_pending=2)
+    release = threading.Event()
+    original = writer._write_frame
+
+    def slow_write(path_stem, frame):
+        release.wait(5)
+        original(path_stem, frame)
+
+    writer._write_frame = slow_write
+    frame = np.zeros((8, 8, 3), np.uint8)
+    accepted = [writer.submit_frame(tmp_path / f"f{i}", frame) for i in range(5)]
+    assert accepted[:2] == [True, True]
+    assert accepted.count(False) == 3 and writer.dropped == 3
+    release.set()
+    writer.close()
+    assert writer.frames_written == 2
@@ -0,0 +1,123 @@
+"""
+Frame pacer tests
+
+Checks that sends stay on a fixed timeline, that overruns skip ticks instead of
+bursting, and that both pacing modes report send lateness.
+"""
+
+import asyncio
+import socket
+import threading
+import time
+
+import pytest
+
+from mesmerglass.mesmervisor.frame_pacer import (
+    PACING_LOOP,
+    PACING_PRECISE,
+    FixedTimeline,
+    FramePacer,
+    sendall_blocking,
+    sleep_until,
+)
+
+
+def test_sleep_until_reaches_deadline():
+    deadline = time.perf_counter() + 0.01
+    sleep_until(deadline)
+    assert time.perf_counter() >= deadline
+
+
+@pytest.mark.parametrize("mode", [PACING_PRECISE, PACING_LOOP])
+def test_sends_follow_fixed_timeline(mode):
+    pacer = FramePacer(200, mode=mode)
+    tx, rx = socket.socketpair()
+    tx.setblocking(False)
+
+    async def run():
+        ticks = []
+        for i in range(10):
+            tick = await pacer.wait()
+            await pacer.send(tx, bytes([i]) * 16, tick)
+            assert time.perf_counter() >= tick  # never written ahead of its tick
+            ticks.append(tick)
+        return ticks
+
+    try:
+        ticks = asyncio.run(run())
+        received = b""
+        while len(received) < 160:
+            received += rx.recv(4096)
+    finally:
+        pacer.close()
+        tx.close()
+        rx.close()
+    assert received == b"".join(bytes([i]) * 16 for i in range(10))
+    # A loaded host may skip ticks, but every send stays on the 5 ms grid.
+    for a, b in zip(ticks, ticks[1:]):
+        steps = (b - a) / 0.005
+        assert round(steps) >= 1
+        assert steps == pytest.approx(round(steps), abs=1e-6)
+    avg_ms, max_ms = pacer.send_jitter_ms()
+    assert 0.0 <= avg_ms <= max_ms
+
+
+def test_precise_wait_returns_ahead_of_the_tick():
+    pacer = FramePacer(50, mode=PACING_PRECISE)
+
+    async def run():
+        await pacer.wait()
+        tick = await pacer.wait()
+        return tick, time.perf_counter()
+
+    try:
+        tick, woke = asyncio.run(run())
+    finally:
+        pacer.close()
+    assert woke < tick  # the packet is built during the lead; the sender thread owns the deadline
+
+
+def test_sendall_blocking_drains_a_full_socket():
+    tx, rx = socket.socketpair()
+    tx.setblocking(False)
+    payload = bytes(range(256)) * 4096  # larger than the socket buffers
+    received = bytearray()
+
+    def drain():
+        while len(received) < len(payload):
+            received.extend(rx.recv(65536))
+
+    reader = threading.Thread(target=drain)
+    reader.start()
+    try:
+        sendall_blocking(tx, payload)
+        reader.join(timeout=5.0)
+    finally:
+        tx.close()
+        rx.close()
+    assert bytes(received) == payload
+
+
+def test_overrun_skips_ticks_without_drift():
+    pacer = FramePacer(100, mode=PACING_LOOP)
+
+    async def run():
+        first = await pacer.wait()
+        time.sleep(0.035)  # miss three ticks
+        return first, await pacer.wait()
+
+    first, after = asyncio.run(run())
+    pacer.close()
+    assert pacer.skipped >= 2
+    steps = (after - first) / 0.01
+    assert steps == pytest.approx(round(steps), abs=1e-6)
+    assert after <= time.perf_counter()
+
+
+def test_timeline_skips_missed_ticks():
+    timeline = FixedTimeline(10)
+    assert timeline.next_tick(100.0) == 100.0
+    assert timeline.next_tick(100.05) == pytest.approx(100.1)  # early: wait for the tick
+    assert timeline.next_tick(100.45) == pytest.approx(100.4)  # 0.2, 0.3 missed
+    assert timeline.skipped == 2
+    assert timeline.next_tick(100.45) == pytest.approx(100.5)
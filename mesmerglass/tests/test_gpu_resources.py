@@ -0,0 +1,151 @@
+"""Tests for textures shared between compositor GL contexts (GL-free bookkeeping)."""
+
+import gc
+import itertools
+
+import numpy as np
+
+from mesmerglass.mesmerloom.gpu_resources import SharedTextures
+
+GROUP = "group"
+
+
+class _FakeGL:
+    def __init__(self):
+        self._ids = itertools.count(1)
+        self.uploads = 0
+        self.deleted = []
+
+    def upload(self):
+        self.uploads += 1
+        return next(self._ids)
+
+    def delete(self, ids):
+        self.deleted.extend(ids)
+
+
+def _textures(gl, idle_budget_bytes=1 << 20):
+    textures = SharedTextures(idle_budget_bytes=idle_budget_bytes, delete=gl.delete)
+    for holder in ("primary", "secondary"):
+        textures.join(GROUP, holder)
+    return textures
+
+
+def _acquire(textures, gl, holder, source, kind="text"):
+    return textures.acquire(
+        GROUP, holder, (kind, id(source)), gl.upload, source=source, kind=kind, size=(4, 4), nbytes=source.nbytes
+    )
+
+
+def test_compositors_in_a_group_get_one_upload():
+    gl = _FakeGL()
+    textures = _textures(gl)
+    image = np.zeros((4, 4, 4), np.uint8)
+
+    first = _acquire(textures, gl, "primary", image, kind="image")
+    second = _acquire(textures, gl, "secondary", image, kind="image")
+
+    assert first == second
+    assert gl.uploads == 1
+    assert textures.holders(GROUP, first) == 2
+    assert textures.stats()["hits"] == 1
+
+
+def test_holder_holds_a_texture_once():
+    gl = _FakeGL()
+    textures = _textures(gl)
+    text = np.zeros((4, 4, 4), np.uint8)
+
+    tex = _acquire(textures, gl, "primary", text)
+    assert _acquire(textures, gl, "primary", text) == tex  # e.g. several subtext tiles
+
+    assert textures.holders(GROUP, tex) == 1
+    textures.release(GROUP, "primary", tex)
+    assert textures.holders(GROUP, tex) == 0
+
+
+def test_released_texture_stays_until_its_source_dies():
+    gl = _FakeGL()
+    textures = _textures(gl)
+    text = np.zeros((4, 4, 4), np.uint8)
+
+    tex = _acquire(textures, gl, "primary", text)
+    textures.release(GROUP, "primary", tex)
+    assert gl.deleted == []
+    assert _acquire(textures, gl, "primary", text) == tex  # carousel re-adds the same text
+    assert gl.uploads == 1
+
+    textures.release(GROUP, "primary", tex)
+    del text
+    gc.collect()
+    textures.lookup(GROUP, "primary", ("text", 0))  # any call flushes
+    assert gl.deleted == [tex]
+
+
+def test_recycled_object_id_does_not_hit_a_stale_texture():
+    gl = _FakeGL()
+    textures = _textures(gl)
+    old = np.zeros((4, 4, 4), np.uint8)
+    new = np.ones((4, 4, 4), np.uint8)
+
+    stale = _acquire(textures, gl, "primary", old)
+    # Same key, different object: what a reused id() looks like.
+    fresh = textures.acquire(GROUP, "primary", ("text", id(old)), gl.upload, source=new, kind="text", nbytes=64)
+
+    assert fresh != stale
+    assert gl.uploads == 2
+
+
+def test_idle_budget_evicts_least_recently_released():
+    gl = _FakeGL()
+    textures = _textures(gl, idle_budget_bytes=128)
+    texts = [np.zeros((4, 4, 4), np.uint8) for _ in range(3)]  # 64 bytes each
+
+    ids = [_acquire(textures, gl, "primary", t) for t in texts]
+    for tex in ids:
+        textures.release(GROUP, "primary", tex)
+
+    assert gl.deleted == [ids[0]]
+    assert textures.stats()["idle_bytes"] == 128
+
+
+def test_video_textures_are_reused_by_size_and_rekeyed():
+    gl = _FakeGL()
+    textures = _textures(gl)
+
+    tex = gl.upload()
+    textures.register(GROUP, "primary", tex, kind="video", size=(640, 360), nbytes=640 * 360 * 3)
+    textures.rekey(GROUP, tex, ("video", ("clip", 0.0)))
+    assert textures.lookup(GROUP, "secondary", ("video", ("clip", 0.0))) == tex
+
+    # Overwritten in place: the old frame must not be found any more.
+    textures.rekey(GROUP, tex, ("video", ("clip", 0.1)))
+    assert textures.lookup(GROUP, "secondary", ("video", ("clip", 0.0))) is None
+
+    textures.release(GROUP, "primary", tex)
+    textures.release(GROUP, "secondary", tex)
+    assert textures.take_idle(GROUP, "primary", "video", (1280, 720)) is None
+    assert textures.take_idle(GROUP, "primary", "video", (640, 360)) == tex
+    assert textures.lookup(GROUP, "secondary", ("video", ("clip", 0.1))) is None
+
+
+def test_leaving_releases_and_last_member_deletes_everything():
+    gl = _FakeGL()
+    textures = _textures(gl)
+    image = np.zeros((4, 4, 4), np.uint8)
+    tex = _acquire(textures, gl, "primary", image, kind="image")
+    _acquire(textures, gl, "secondary", image, kind="image")
+
+    textures.leave(GROUP, "secondary")
+    assert textures.holders(GROUP, tex) == 1
+    assert gl.deleted == []
+
+    textures.leave(GROUP, "primary")
+    assert gl.deleted == [tex]
+    assert textures.stats()["groups"] == 0
+
+
+def test_unmanaged_texture_is_not_released():
+    textures = _textures(_FakeGL())
+    assert textures.release(GROUP, "primary", 42) is False
+    assert textures.release("other", "primary", 42) is False
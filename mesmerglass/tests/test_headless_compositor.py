@@ -0,0 +1,53 @@
+"""
+Headless compositor tests
+
+Renders a spiral frame through LoomHeadlessCompositor with no window or
+display. Skipped where PyOpenGL or an offscreen GL context is unavailable.
+"""
+
+import numpy as np
+import pytest
+
+pytest.importorskip("OpenGL")
+
+from PyQt6.QtGui import QGuiApplication
+
+from mesmerglass.vr.offscreen import ensure_headless_platform
+
+
+@pytest.fixture(scope="module")
+def compositor():
+    ensure_headless_platform()
+    app = QGuiApplication.instance() or QGuiApplication([])
+
+    from mesmerglass.mesmerloom.headless_compositor import LoomHeadlessCompositor
+    from mesmerglass.mesmerloom.spiral import SpiralDirector
+
+    director = SpiralDirector()
+    director.set_intensity(0.8)
+    comp = LoomHeadlessCompositor(director, 160, 96, fps=30)
+    if not comp.available:
+        comp.cleanup()
+        pytest.skip("no offscreen GL context")
+    yield comp
+    comp.cleanup()
+    del app
+
+
+def test_render_frame_delivers_one_stream_sized_frame(compositor):
+    frames = []
+    compositor.set_vr_capture_enabled(True)
+    compositor.frame_ready.connect(frames.append)
+    try:
+        compositor.render_frame()
+    finally:
+        compositor.frame_ready.disconnect(frames.append)
+        compositor.set_vr_capture_enabled(False)
+
+    assert len(frames) == 1
+    frame = np.asarray(frames[0])
+    assert frame.shape == (96, 160, 3)
+    assert frame.dtype == np.uint8
+    # The spiral arms leave both dark and light pixels.
+    assert frame.min() < 64 and frame.max() > 192
+    assert compositor.stats()["frames"] == 1
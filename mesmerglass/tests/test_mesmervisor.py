@@ -5,6 +5,7 @@ Comprehensive tests for VR streaming functionality:
 - Import tests
 - GPU detection tests
 - NVENC encoder tests
+- HEVC (x265) encoder tests
 - JPEG encoder tests
 - Server initialization tests
 - Protocol packet tests
@@ -32,6 +33,7 @@ from mesmerglass.mesmervisor import (
     DiscoveryService,
 )
 from mesmerglass.mesmervisor.frame_encoder import (
+    HEVCEncoder,
     NVENCEncoder,
     JPEGEncoder,
     FrameEncoder,
@@ -39,6 +41,16 @@ from mesmerglass.mesmervisor.frame_encoder import (
 )
 
 
+def _has_libx265() -> bool:
+    try:
+        import av
+
+        av.codec.Codec("libx265", "w")
+        return True
+    except Exception:
+        return False
+
+
 # ============================================================================
 # Import Tests
 # ============================================================================
@@ -305,6 +317,33 @@ class TestNVENCEncoder:
         assert avg_high >= avg_low * 0.8
 
 
+# ============================================================================
+# HEVC Encoder Tests
+# ============================================================================
+
+class TestHEVCEncoder:
+    """Test the x265 zero-latency HEVC encoder (if PyAV has libx265)."""
+
+    @pytest.mark.skipif(not _has_libx265(), reason="libx265 not available")
+    def test_x265_keyframes_carry_parameter_sets(self):
+        """Test every access unit comes out immediately and IDRs repeat VPS/SPS/PPS."""
+        from mesmerglass.mesmervisor.annexb import access_unit_contains_idr, iter_annexb_nals
+
+        encoder = HEVCEncoder(width=320, height=240, fps=30, codec_name="libx265")
+        assert encoder.get_encoder_type() == EncoderType.HEVC
+        try:
+            units = []
+            for i in range(4):
+                if i == 2:
+                    encoder.request_idr()
+                units.append(encoder.encode(np.full((240, 320, 3), i * 40, dtype=np.uint8)))
+            assert all(units)  # no B-frame / lookahead delay
+            assert [access_unit_contains_idr(u, hevc=True) for u in units] == [True, False, True, False]
+            assert {32, 33, 34} <= {t for t, _ in iter_annexb_nals(units[2], hevc=True)}
+        finally:
+            encoder.close()
+
+
 # ============================================================================
 # Encoder Factory Tests
 # ============================================================================
@@ -340,6 +379,21 @@ class TestEncoderFactory:
         assert encoder.get_encoder_type() == EncoderType.NVENC
         encoder.close()
     
+    def test_create_etc2_encoder(self):
+        """Test creating ETC2 texture encoder via factory."""
+        from mesmerglass.mesmervisor.frame_encoder import ETC2Encoder
+        from mesmerglass.mesmervisor.texture_codec import TEXTURE_HEADER
+        
+        encoder = create_encoder(EncoderType.ETC2, width=64, height=32)
+        
+        assert isinstance(encoder, ETC2Encoder)
+        assert encoder.get_encoder_type() == EncoderType.ETC2
+        frame = np.random.randint(0, 255, (32, 64, 3), dtype=np.uint8)
+        payload = encoder.encode(frame)
+        width, height = TEXTURE_HEADER.unpack_from(payload)[:2]
+        assert (width, height) == (64, 32)
+        encoder.close()
+    
     def test_create_auto_encoder(self):
         """Test auto encoder selection via factory."""
         # AUTO should resolve to NVENC or JPEG, not stay as AUTO
@@ -457,6 +511,86 @@ class TestProtocolPackets:
         magic = packet[4:8].decode('ascii')
         assert magic == "VRH3"
 
+    def test_create_packet_vrh4_crc32c(self):
+        """Test VRH4 packets carry flags + per-eye CRC32C when checksums are enabled."""
+        import struct
+        from mesmerglass.mesmervisor.payload_crc import crc32c
+        from mesmerglass.mesmervisor.streaming_server import VRH4_FLAG_CRC32C
+
+        server = VRStreamingServer(encoder_type=EncoderType.JPEG, fps=30)
+        server.payload_crc = True
+        left, right = b"\x00\x00\x00\x01\x65LEFT", b"\x00\x00\x00\x01\x65RIGHT"
+        packet = server.create_packet(left, right, 7, protocol_magic=b"VRH4")
+
+        magic, frame_id, left_size, right_size, fps_milli, flags, crc_l, crc_r = struct.unpack(
+            '!4sIIIIIII', packet[4:36]
+        )
+        assert magic == b"VRH4"
+        assert (frame_id, left_size, right_size, fps_milli) == (7, len(left), len(right), 30000)
+        assert flags & VRH4_FLAG_CRC32C
+        assert crc_l == crc32c(left)
+        assert crc_r == crc32c(right)
+        assert packet[36:] == left + right
+
+    def test_create_packet_vrh4_hevc_flag(self):
+        """Test HEVC payloads are flagged in the VRH4 flags word alongside the CRC flag."""
+        import struct
+        from mesmerglass.mesmervisor.streaming_server import VRH4_FLAG_CRC32C, VRH4_FLAG_HEVC, build_packet
+
+        packet = build_packet(b"VRH4", b"\x00\x00\x01\x28\x01", b"", 3, payload_crc=True, hevc=True)
+        flags = struct.unpack('!I', packet[24:28])[0]
+        assert flags == VRH4_FLAG_CRC32C | VRH4_FLAG_HEVC
+        plain = build_packet(b"VRH4", b"L", b"", 3)
+        assert struct.unpack('!I', plain[24:28])[0] == 0
+
+    def test_create_packet_vrh4_mono_without_crc(self):
+        """Test VRH4 mono packets without checksums zero the CRC fields."""
+        import struct
+
+        server = VRStreamingServer(encoder_type=EncoderType.JPEG)
+        packet = server.create_packet(b"L", b"", 1, protocol_magic=b"VRH4")
+        _magic, _fid, _ls, right_size, _fps, flags, crc_l, crc_r = struct.unpack('!4sIIIIIII', packet[4:36])
+        assert right_size == 0
+        assert (flags, crc_l, crc_r) == (0, 0, 0)
+
+    def test_crc32c_known_vectors(self):
+        """Test CRC32C against the standard check value (hardware and Python paths)."""
+        from mesmerglass.mesmervisor.payload_crc import crc32c, crc32c_py
+
+        assert crc32c(b"123456789") == 0xE3069283
+        assert crc32c_py(b"123456789") == 0xE3069283
+        data = bytes(range(256)) * 17
+        assert crc32c(data[100:], crc32c(data[:100])) == crc32c(data)
+
+
+    def test_vrht_server_uses_texture_protocol(self):
+        """Test ETC2 servers send VRHT with the 16-byte header at texture resolution."""
+        import struct
+        
+        server = VRStreamingServer(encoder_type=EncoderType.ETC2, width=320, height=240)
+        assert server.protocol_magic == b"VRHT"
+        assert (server.target_width, server.target_height) == (1024, 512)
+        
+        packet = server.create_packet(b"T" * 12, b"", 3)
+        magic, frame_id, left_size, right_size = struct.unpack('!4sIII', packet[4:20])
+        assert (magic, frame_id, left_size, right_size) == (b"VRHT", 3, 12, 0)
+
+    def test_control_packet_toggles_hud(self, monkeypatch):
+        """Test VRHC control packets use the 16-byte header with the command in the left slot."""
+        import struct
+        from mesmerglass.mesmervisor.streaming_server import CONTROL_HUD, build_control_packet
+
+        packet = build_control_packet(CONTROL_HUD, b"\x01")
+        size, magic, frame_id, left_size, right_size = struct.unpack('!I4sIII', packet[:20])
+        assert (size, magic, frame_id, left_size, right_size) == (len(packet) - 4, b"VRHC", 0, 2, 0)
+        assert packet[20:] == bytes([CONTROL_HUD, 1])
+
+        monkeypatch.setenv("MESMERGLASS_VR_HUD", "1")
+        assert VRStreamingServer(encoder_type=EncoderType.JPEG).hud_enabled
+        server = VRStreamingServer(encoder_type=EncoderType.JPEG, hud=False)
+        assert not server.hud_enabled
+        server.set_hud(True)
+        assert server.hud_enabled
 
 # ============================================================================
 # Server Initialization Tests
@@ -527,6 +661,37 @@ class TestDiscoveryService:
         assert service.discovery_port == 5556
         assert service.streaming_port == 5555
 
+    def test_hello_codec_advertisement(self):
+        """Test HELLO parsing keeps old clients H.264-only and strips the codec suffix."""
+        from mesmerglass.mesmervisor.streaming_server import parse_headset_hello
+
+        assert parse_headset_hello("VR_HEADSET_HELLO:Quest 2") == ("Quest 2", None)
+        assert parse_headset_hello("VR_HEADSET_HELLO:Quest 3;codecs=avc,HEVC") == (
+            "Quest 3",
+            frozenset({"avc", "hevc"}),
+        )
+
+    @pytest.mark.skipif(not _has_libx265(), reason="libx265 not available")
+    def test_hevc_server_negotiates_per_headset(self, monkeypatch):
+        """Test HEVC goes only to headsets that advertised it; the rest get H.264 on VRH3."""
+        from mesmerglass.mesmervisor import streaming_server as ss
+
+        monkeypatch.delenv("MESMERGLASS_HEVC_CODEC", raising=False)
+        monkeypatch.delenv("MESMERGLASS_VRH2_CRC", raising=False)
+        monkeypatch.delenv("MESMERGLASS_VRH2_PROTOCOL", raising=False)
+        server = VRStreamingServer(encoder_type=EncoderType.HEVC, discovery_port=None)
+        ss.note_headset_codecs("10.0.0.2", frozenset({"avc", "hevc"}))
+        ss.note_headset_codecs("10.0.0.3", frozenset({"avc"}))
+        try:
+            profile, magic, hevc = server._client_stream(("10.0.0.2", 1))
+            assert (profile.encoder_type, profile.codec_name, magic, hevc) == (EncoderType.HEVC, "libx265", b"VRH4", True)
+            for ip in ("10.0.0.3", "10.0.0.4"):  # avc only, never announced
+                profile, magic, hevc = server._client_stream((ip, 1))
+                assert (profile.encoder_type, profile.codec_name, magic, hevc) == (EncoderType.NVENC, "libx264", b"VRH3", False)
+        finally:
+            ss.note_headset_codecs("10.0.0.2", None)
+            ss.note_headset_codecs("10.0.0.3", None)
+
 
 # ============================================================================
 # Integration Tests
@@ -0,0 +1,93 @@
+"""Tests for the motion-adaptive stream frame rate (no GL, no sockets)."""
+
+import numpy as np
+
+from mesmerglass.mesmervisor.motion_rate import MotionRate
+from mesmerglass.session.encoder_hints import EncoderHints
+
+FPS = 30
+
+
+def _frame(value):
+    return np.full((64, 64, 3), value, dtype=np.uint8)
+
+
+def _run(rate, ticks, frame_at, dt=1.0 / FPS, start=0.0):
+    """Drives ``rate`` over ``ticks`` ticks; returns the indices that carried a frame."""
+    sent = []
+    for index in range(ticks):
+        now = start + index * dt
+        if rate.due(index, now=now):
+            rate.sent(index, frame_at(index))
+            sent.append(index)
+    return sent
+
+
+def test_static_content_settles_at_min_fps():
+    rate = MotionRate(FPS, min_fps=10, decay_s=0.0)
+    sent = _run(rate, 60, lambda i: _frame(0))
+    assert rate.interval == rate.max_interval == 3
+    assert sent[-1] - sent[-2] == 3
+    assert abs(rate.average_fps() - 10.0) < 2.5
+
+
+def test_changing_frames_keep_full_rate():
+    rate = MotionRate(FPS, min_fps=10, full_diff=2.0, decay_s=0.0)
+    sent = _run(rate, 30, lambda i: _frame((i * 5) % 256))
+    assert sent == list(range(30))
+    assert rate.current_fps == FPS
+
+
+def test_fast_spiral_keeps_full_rate():
+    hints = EncoderHints()
+    rate = MotionRate(FPS, hints=hints, min_fps=10, step_deg=3.0, decay_s=0.0)
+    hints.publish_motion(30.0)  # 180 deg/s: 60 fps at 3 deg per frame
+    now = hints._motion.at
+    sent = _run(rate, 20, lambda i: _frame(0), start=now)
+    assert sent == list(range(20))
+
+
+def test_slow_spiral_only_asks_for_what_it_needs():
+    hints = EncoderHints()
+    rate = MotionRate(FPS, hints=hints, min_fps=5, step_deg=3.0)
+    hints.publish_motion(2.5)  # 15 deg/s -> 5 fps
+    rate._diff_per_tick = 0.0
+    assert rate.needed_fps(now=hints._motion.at) == 5.0
+
+
+def test_upcoming_media_change_restores_full_rate():
+    hints = EncoderHints()
+    rate = MotionRate(FPS, hints=hints, min_fps=10, decay_s=0.0)
+    hints.publish_motion(0.0, next_media_in_s=1.0)
+    now = hints._motion.at
+    _run(rate, 20, lambda i: _frame(0), start=now)
+    assert rate.interval == 3
+
+    assert rate.needed_fps(now=now + 0.9) == FPS
+    rate.due(27, now=now + 0.9)
+    assert rate.interval == 1
+
+
+def test_announced_cut_restores_full_rate():
+    hints = EncoderHints()
+    rate = MotionRate(FPS, hints=hints, min_fps=10, decay_s=0.0)
+    _run(rate, 30, lambda i: _frame(0))
+    assert rate.interval == 3
+    hints.publish_upcoming("cue", eta_s=0.05)
+    rate.due(30)
+    assert rate.interval == 1
+
+
+def test_interval_grows_one_tick_per_decay():
+    rate = MotionRate(FPS, min_fps=5, decay_s=0.25)
+    rate.sent(0, _frame(0))
+    rate.sent(1, _frame(0))
+    intervals = []
+    for step in range(4):
+        rate.due(2 + step, now=step * 0.3)
+        intervals.append(rate.interval)
+    assert intervals == [2, 3, 4, 5]
+    rate.due(10, now=1.0)
+    assert rate.interval == 5  # 0.1 s since the last step
+    rate.due(11, now=1.2)
+    assert rate.interval == 6 == rate.max_interval
@@ -0,0 +1,89 @@
+"""
+Streaming pipeline benchmark tests
+
+vr-bench must cover every stage for each combination it runs, carry packets
+over loopback TCP intact (VRH4 CRCs included), and report missing encoders as
+skipped instead of failing the whole run.
+"""
+
+import json
+
+import pytest
+
+from mesmerglass.mesmervisor import pipeline_bench
+from mesmerglass.mesmervisor.frame_encoder import FrameEncoder
+from mesmerglass.mesmervisor.gpu_utils import EncoderType
+from mesmerglass.mesmervisor.pipeline_bench import (
+    BenchConfig,
+    RECEIVER_STAGES,
+    SENDER_STAGES,
+    format_report,
+    run_benchmark,
+    run_combination,
+    select_combinations,
+)
+
+
+class _FixedAccessUnitEncoder(FrameEncoder):
+    """Stands in for x264/NVENC: one IDR-shaped access unit per frame."""
+
+    AU = b"\x00\x00\x00\x01\x09\xf0\x00\x00\x00\x01\x65\x88\x84\x21" + bytes(range(200))
+
+    def encode(self, frame):
+        return self.AU
+
+    def get_encoder_type(self):
+        return EncoderType.NVENC
+
+    def close(self):
+        pass
+
+
+def test_select_combinations_filters_and_validates():
+    assert select_combinations(["jpeg"]) == [("jpeg", "VRHP")]
+    assert select_combinations(["x264", "nvenc"], ["vrh4"]) == [("x264", "VRH4"), ("nvenc", "VRH4")]
+    assert ("etc2", "VRHT") in select_combinations()
+    with pytest.raises(ValueError):
+        select_combinations(["vp9"])
+    with pytest.raises(ValueError):
+        select_combinations(None, ["VRH9"])
+
+
+def test_etc2_run_reports_every_stage():
+    cfg = BenchConfig(frames=4, warmup=1, width=64, height=32, target=(64, 32), pattern="checkerboard")
+    result = run_combination("etc2", "VRHT", cfg)
+
+    assert result["status"] == "ok", result
+    assert result["frames"] == 4
+    assert set(result["stages"]) == set(SENDER_STAGES + RECEIVER_STAGES)
+    assert all(stage["p99_ms"] >= stage["p50_ms"] >= 0.0 for stage in result["stages"].values())
+    # 64x32 ETC2 = 128 blocks of 8 bytes plus texture and VRHP headers (LZ4 may shrink it).
+    assert 0 < result["bytes_per_frame"]["mean"] <= 128 * 8 + 12 + 20
+    assert result["fps_ceiling"] > 0 and result["end_to_end"]["p50_ms"] > 0
+
+
+def test_h264_vrh4_packets_round_trip_with_crc(monkeypatch):
+    monkeypatch.setattr(pipeline_bench, "_make_encoder", lambda *a, **k: _FixedAccessUnitEncoder())
+    # The stand-in AU is not a decodable slice; keep libavcodec (when installed) out of it.
+    monkeypatch.setattr(pipeline_bench._Decoder, "decode", lambda self, eye, payload: None)
+    cfg = BenchConfig(frames=5, warmup=0, width=32, height=16, target=(32, 16), pattern="spiral")
+    result = run_combination("x264", "VRH4", cfg)
+
+    assert result["status"] == "ok", result
+    assert result["crc_errors"] == 0
+    # Mono: 4-byte size + 32-byte VRH4 header + left eye only.
+    assert result["bytes_per_frame"]["max"] == 4 + 32 + len(_FixedAccessUnitEncoder.AU)
+
+
+def test_unavailable_encoder_is_skipped(monkeypatch):
+    def _missing(*_a, **_k):
+        raise RuntimeError("PyAV not installed")
+
+    monkeypatch.setattr(pipeline_bench, "_make_encoder", _missing)
+    report = run_benchmark([("nvenc", "VRH3")], BenchConfig(frames=2, warmup=0, width=32, height=16))
+
+    assert report["results"] == [
+        {"encoder": "nvenc", "protocol": "VRH3", "status": "skipped", "target": "2048x1024", "reason": "PyAV not installed"}
+    ]
+    json.dumps(report)  # report must stay JSON-serialisable
+    assert "skipped" in format_report(report)
@@ -0,0 +1,114 @@
+"""
+Session bundle tests
+
+Packs a small session with a Media Bank, cue audio and a font bank, then checks
+member order, alignment, reference rewriting and that mounted bundle paths
+resolve through the media scanner and loaders.
+"""
+
+import json
+import os
+
+from mesmerglass.content import bundle
+from mesmerglass.content.media_scan import scan_font_directory, scan_media_directory
+from mesmerglass.session_manager import SessionManager
+
+
+def _write(path, data: bytes):
+    path.parent.mkdir(parents=True, exist_ok=True)
+    path.write_bytes(data)
+    return path
+
+
+def _make_session(tmp_path):
+    media = tmp_path / "media"
+    _write(media / "late" / "z.png", b"late-image")
+    _write(media / "early" / "a.jpg", b"early-image")
+    _write(media / "early" / "sub" / "b.jpg", b"early-image-2")
+    _write(media / "early" / "clip.mp4", b"video-bytes")
+    _write(tmp_path / "fonts" / "f.ttf", b"font-bytes")
+    audio = _write(tmp_path / "audio" / "hypno.wav", b"audio-bytes")
+    session = {
+        "version": "1.0",
+        "metadata": {"name": "Bundled", "created": "x", "modified": "x"},
+        "media_bank": [
+            {"name": "Late", "path": str(media / "late"), "type": "images"},
+            {"name": "Early", "path": str(media / "early"), "type": "both"},
+            {"name": "Fonts", "path": str(tmp_path / "fonts"), "type": "fonts"},
+        ],
+        "playbacks": {"p1": {"media": {"bank_selections": [1]}}},
+        "cuelists": {
+            "main": {
+                "cues": [
+                    {
+                        "name": "c1",
+                        "playback_pool": [{"playback": "p1"}],
+                        "audio": {"hypno": {"file": str(audio)}},
+                        "audio_tracks": [{"file": str(audio)}],
+                    }
+                ]
+            }
+        },
+        "runtime": {"active_cuelist": "main"},
+    }
+    path = tmp_path / "bundled.session.json"
+    path.write_text(json.dumps(session), encoding="utf-8")
+    return path
+
+
+def test_pack_orders_members_by_first_use(tmp_path):
+    summary = bundle.write_bundle(_make_session(tmp_path))
+    assert summary["path"].endswith("bundled.mgbundle")
+    with bundle.SessionBundle(summary["path"]) as packed:
+        names = [e.name for e in packed.entries]
+        assert names == [
+            "session.json",
+            "bank/2/f.ttf",
+            "audio/hypno.wav",  # packed once for both references
+            "bank/1/a.jpg",
+            "bank/1/sub/b.jpg",
+            "bank/0/z.png",  # not selected by any cue
+            "bank/1/clip.mp4",
+        ]
+        assert all(e.offset % bundle.ALIGNMENT == 0 for e in packed.entries)
+        assert bytes(packed.view("bank/1/sub/b.jpg")) == b"early-image-2"
+        assert packed.verify() == []
+
+        raw = json.loads(bytes(packed.view("session.json")))
+        assert raw["media_bank"][1]["path"] == "mgbundle:bank/1"
+        assert raw["cuelists"]["main"]["cues"][0]["audio_tracks"][0]["file"] == "mgbundle:audio/hypno.wav"
+
+
+def test_mounted_bundle_resolves_through_loaders(tmp_path):
+    out = tmp_path / "out" / "b.mgbundle"
+    bundle.write_bundle(_make_session(tmp_path), out)
+    session = SessionManager(session_dir=tmp_path).load_session(out)
+    try:
+        root = session["media_bank"][1]["path"]
+        assert bundle.exists(root) and not (tmp_path / "out" / "b.mgbundle" / "bank").exists()
+        images, videos = scan_media_directory(root)
+        assert [os.path.relpath(p, root) for p in images] == ["a.jpg", os.path.join("sub", "b.jpg")]
+        assert len(videos) == 1
+        assert len(scan_font_directory(session["media_bank"][2]["path"])) == 1
+
+        audio = session["cuelists"]["main"]["cues"][0]["audio"]["hypno"]["file"]
+        assert bundle.getsize(audio) == len(b"audio-bytes")
+        with bundle.source_for(audio) as fh:
+            fh.seek(6)
+            assert fh.read() == b"bytes"
+        assert bundle.source_for(str(tmp_path / "fonts" / "f.ttf")) == str(tmp_path / "fonts" / "f.ttf")
+    finally:
+        for mounted in bundle.mounted():
+            mounted.close()
+    assert bundle.lookup(root) is None
+
+
+def test_verify_detects_corruption(tmp_path):
+    summary = bundle.write_bundle(_make_session(tmp_path))
+    with bundle.SessionBundle(summary["path"]) as packed:
+        offset = packed.entry("audio/hypno.wav").offset
+    with open(summary["path"], "r+b") as fh:
+        fh.seek(offset)
+        fh.write(b"X")
+    with bundle.SessionBundle(summary["path"]) as packed:
+        assert packed.verify() == ["audio/hypno.wav"]
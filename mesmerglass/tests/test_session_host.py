@@ -0,0 +1,209 @@
+"""
+Multi-session streaming host tests
+
+Checks that the encode scheduler shares encoder time fairly, that discovery
+routing honours device lists and balances the rest, that the shared image pool
+decodes each file once, and that a loopback host with load clients delivers
+frames to every session.
+"""
+
+import asyncio
+import threading
+import time
+
+import numpy as np
+import pytest
+
+from mesmerglass.content import media
+from mesmerglass.mesmervisor.load_client import capacity_summary, run_load
+from mesmerglass.mesmervisor.session_host import EncodeScheduler, MultiSessionHost, SessionSpec
+
+
+def test_scheduler_balances_encoder_time_between_sessions():
+    scheduler = EncodeScheduler(slots=1)
+    stop = threading.Event()
+
+    def worker(session, cost_s):
+        slot = scheduler.slot(session)
+        while not stop.is_set():
+            with slot:
+                time.sleep(cost_s)
+
+    # "busy" has three threads and twice the per-encode cost; it must not get more time.
+    threads = [threading.Thread(target=worker, args=("busy", 0.004)) for _ in range(3)]
+    threads.append(threading.Thread(target=worker, args=("light", 0.002)))
+    for t in threads:
+        t.start()
+    time.sleep(0.6)
+    stop.set()
+    for t in threads:
+        t.join()
+
+    stats = scheduler.stats()
+    assert stats["light"].encodes > stats["busy"].encodes
+    share = stats["light"].busy_s / (stats["light"].busy_s + stats["busy"].busy_s)
+    assert share == pytest.approx(0.5, abs=0.15)
+
+
+def test_route_prefers_device_lists_then_least_loaded():
+    specs = [
+        SessionSpec("a", 7001, encoder="etc2", devices=("Quest Lobby",)),
+        SessionSpec("b", 7002, encoder="etc2"),
+        SessionSpec("c", 7003, encoder="etc2"),
+    ]
+    host = MultiSessionHost(specs, discovery_port=None)
+    assert host.route("10.0.0.5", "Quest Lobby") == 7001
+    assert host.route("10.0.0.6", "Go") == 7002
+    assert host.route("10.0.0.7", "Go") == 7003
+    assert host.route("10.0.0.6", "Go") == 7002  # sticky
+    with pytest.raises(ValueError):
+        MultiSessionHost([SessionSpec("a", 7001), SessionSpec("a", 7002)], discovery_port=None)
+
+
+def test_shared_image_pool_decodes_each_file_once(tmp_path, monkeypatch):
+    path = tmp_path / "img.png"
+    path.write_bytes(b"not decoded for real")
+    decodes = []
+
+    def fake_decode(p, _tracer):
+        decodes.append(p)
+        return media.ImageData(width=2, height=2, data=np.zeros((2, 2, 4), np.uint8), path=p)
+
+    pool = media.SharedImagePool(1 << 20)
+    monkeypatch.setattr(media, "_SHARED_POOL", pool)
+    monkeypatch.setattr(media, "_decode_image", fake_decode)
+
+    first = media.load_image_sync(path)
+    second = media.load_image_sync(path)
+    assert first is second and len(decodes) == 1
+    assert not first.data.flags.writeable
+    assert pool.stats()["hits"] == 1
+
+    pool.set_budget(0)
+    assert pool.stats()["count"] == 0 and not pool.enabled
+
+
+def test_loopback_host_serves_every_session(monkeypatch):
+    monkeypatch.delenv("MESMERGLASS_VRHT_SIZE", raising=False)
+    specs = [
+        SessionSpec(f"s{i}", 0, encoder="etc2", fps=20, width=64, height=32, target=(64, 32), pattern="checkerboard")
+        for i in range(2)
+    ]
+    # Distinct ephemeral ports: bind/close once to pick them.
+    import socket
+
+    for spec in specs:
+        with socket.socket() as s:
+            s.bind(("127.0.0.1", 0))
+            spec.port = s.getsockname()[1]
+
+    host = MultiSessionHost(specs, host="127.0.0.1", discovery_port=None)
+    host.start()
+    try:
+        time.sleep(0.3)
+        results = asyncio.run(run_load([("127.0.0.1", s.port) for s in specs], duration=1.0, warmup=0.3))
+        report = host.report()
+    finally:
+        host.stop()
+
+    assert all(r.error is None and r.protocol == "VRHT" for r in results), results
+    summary = capacity_summary(results, 20)
+    assert summary["sessions"] == 2
+    assert all(s["min_fps"] >= 10 for s in summary["per_session"]), summary
+    assert all(s["encodes"] > 0 for s in report["sessions"])
+
+
+def _write_session(path, arm_color, image_dir):
+    import json
+
+    playback = {
+        "version": "1.0",
+        "name": "solid",
+        "spiral": {"type": "logarithmic", "rotation_speed": 2.0, "opacity": 1.0,
+                   "arm_color": arm_color, "gap_color": [0.0, 0.0, 0.0]},
+        "media": {"mode": "none"},
+        "text": {"enabled": False},
+        "zoom": {"mode": "none"},
+    }
+    cue = {"name": "hold", "duration_seconds": 60, "playback_pool": [{"playback": "solid"}]}
+    session = {
+        "version": "1.0",
+        "metadata": {"name": path.stem, "created": "2026-01-01T00:00:00", "modified": "2026-01-01T00:00:00"},
+        "playbacks": {"solid": playback},
+        "cuelists": {"main": {"name": "main", "cues": [cue]}},
+        "runtime": {"active_cuelist": "main"},
+        "media_bank": [{"name": "Images", "path": str(image_dir), "type": "images"}],
+    }
+    path.write_text(json.dumps(session))
+    return str(path)
+
+
+def test_host_streams_a_different_session_file_per_spec(tmp_path, monkeypatch):
+    pytest.importorskip("OpenGL")
+    Image = pytest.importorskip("PIL.Image")
+    from PyQt6.QtCore import QCoreApplication
+    from PyQt6.QtGui import QGuiApplication
+
+    from mesmerglass.vr.offscreen import ensure_headless_platform
+
+    monkeypatch.delenv("MESMERGLASS_VRHT_SIZE", raising=False)
+    monkeypatch.setattr(media, "_SHARED_POOL", media.SharedImagePool(0))
+    monkeypatch.setattr("mesmerglass.platform_paths.get_user_data_dir", lambda *_a, **_k: tmp_path)
+    ensure_headless_platform()
+    app = QGuiApplication.instance() or QGuiApplication([])
+
+    # The runner only starts with media in the bank; both sessions share one image.
+    images = tmp_path / "images"
+    images.mkdir()
+    Image.new("RGB", (8, 8)).save(images / "black.png")
+    red = _write_session(tmp_path / "red.session.json", [1.0, 0.0, 0.0], images)
+    blue = _write_session(tmp_path / "blue.session.json", [0.0, 0.0, 1.0], images)
+    specs = [
+        SessionSpec(name, 0, encoder="etc2", fps=20, width=64, height=32, target=(64, 32), session=path)
+        for name, path in (("red", red), ("blue", blue))
+    ]
+    import socket
+
+    for spec in specs:
+        with socket.socket() as s:
+            s.bind(("127.0.0.1", 0))
+            spec.port = s.getsockname()[1]
+
+    try:
+        host = MultiSessionHost(specs, host="127.0.0.1", discovery_port=None)
+    except RuntimeError as e:
+        pytest.skip(str(e))
+    assert media.shared_image_pool().enabled
+
+    results = []
+    host.start()
+    try:
+        settle = time.time() + 0.3  # let every session bind
+        while time.time() < settle:
+            QCoreApplication.processEvents()
+            time.sleep(0.005)
+        loader = threading.Thread(target=lambda: results.extend(asyncio.run(
+            run_load([("127.0.0.1", s.port) for s in specs], duration=1.0, warmup=0.3))))
+        loader.start()
+        while loader.is_alive():
+            QCoreApplication.processEvents()
+            time.sleep(0.005)
+        frames = {}
+        deadline = time.time() + 2.0
+        while len(frames) < 2 and time.time() < deadline:
+            QCoreApplication.processEvents()
+            for name, session in host.sessions.items():
+                got = session.server.frame_callback()
+                if got is not None:
+                    frames[name] = np.asarray(got[0])
+    finally:
+        host.stop()
+        del app
+
+    assert all(r.error is None for r in results), results
+    assert all(s["min_fps"] > 0 for s in capacity_summary(results, 20)["per_session"])
+    assert frames["red"].shape == (32, 64, 3)
+    # RGB frames: each session shows its own playback's arm colour.
+    red_px, blue_px = frames["red"].reshape(-1, 3).max(axis=0), frames["blue"].reshape(-1, 3).max(axis=0)
+    assert red_px[0] > 128 and red_px[2] < 64, red_px
+    assert blue_px[2] > 128 and blue_px[0] < 64, blue_px
@@ -0,0 +1,199 @@
+"""
+Stream recorder tests
+
+Builds synthetic Annex-B access units and checks the fragmented MP4 layout
+produced by the zero-re-encode recorder.
+"""
+
+import struct
+import time
+
+import pytest
+
+from mesmerglass.mesmervisor.annexb import h264_sps_dimensions, iter_annexb_nal_units
+from mesmerglass.mesmervisor.stream_recorder import TIMESCALE, StreamRecorder, annexb_to_avcc
+
+
+# ============================================================================
+# Helpers
+# ============================================================================
+
+class _BitWriter:
+    def __init__(self):
+        self.bits = []
+
+    def u(self, n, v):
+        self.bits += [(v >> (n - 1 - i)) & 1 for i in range(n)]
+
+    def ue(self, v):
+        v += 1
+        n = v.bit_length()
+        self.bits += [0] * (n - 1)
+        self.u(n, v)
+
+    def rbsp(self):
+        bits = self.bits + [1]
+        bits += [0] * (-len(bits) % 8)
+        return bytes(int("".join(map(str, bits[i:i + 8])), 2) for i in range(0, len(bits), 8))
+
+
+def _sps(width, height):
+    bw = _BitWriter()
+    bw.u(8, 66)  # baseline
+    bw.u(8, 0)
+    bw.u(8, 30)
+    bw.ue(0)  # sps id
+    bw.ue(0)  # log2_max_frame_num_minus4
+    bw.ue(2)  # poc type
+    bw.ue(1)  # max_num_ref_frames
+    bw.u(1, 0)
+    mbs_w, mbs_h = (width + 15) // 16, (height + 15) // 16
+    bw.ue(mbs_w - 1)
+    bw.ue(mbs_h - 1)
+    bw.u(1, 1)  # frame_mbs_only
+    bw.u(1, 1)  # direct_8x8
+    crop_r, crop_b = (mbs_w * 16 - width) // 2, (mbs_h * 16 - height) // 2
+    if crop_r or crop_b:
+        bw.u(1, 1)
+        for v in (0, crop_r, 0, crop_b):
+            bw.ue(v)
+    else:
+        bw.u(1, 0)
+    bw.u(1, 0)  # vui
+    return b"\x67" + bw.rbsp()
+
+
+_SC = b"\x00\x00\x00\x01"
+_PPS = b"\x68\xce\x38\x80"
+
+
+def _idr_au(width=64, height=48):
+    return _SC + b"\x09\xf0" + _SC + _sps(width, height) + _SC + _PPS + _SC + b"\x65\x88\x84\x21\xa0"
+
+
+def _p_au():
+    return _SC + b"\x41\x9a\x02\x04"
+
+
+def _boxes(data, start=0, end=None):
+    end = len(data) if end is None else end
+    out = []
+    pos = start
+    while pos + 8 <= end:
+        size, typ = struct.unpack(">I4s", data[pos:pos + 8])
+        out.append((typ, pos, size))
+        pos += size
+    return out
+
+
+# ============================================================================
+# Annex-B helpers
+# ============================================================================
+
+class TestAnnexB:
+    def test_sps_dimensions_with_cropping(self):
+        assert h264_sps_dimensions(_sps(1920, 1080)) == (1920, 1080)
+        assert h264_sps_dimensions(_sps(2048, 1024)) == (2048, 1024)
+
+    def test_iter_nal_units(self):
+        types = [t for t, _unit in iter_annexb_nal_units(_idr_au())]
+        assert types == [9, 7, 8, 5]
+
+    def test_annexb_to_avcc_drops_aud_and_keeps_parameter_sets(self):
+        sample, is_idr, sps, pps = annexb_to_avcc(_idr_au())
+        assert is_idr
+        assert sps[0] == 0x67 and pps == _PPS
+        n = struct.unpack(">I", sample[:4])[0]
+        assert sample[4] == 0x67 and n == len(sps)
+
+
+# ============================================================================
+# Fragmented MP4 output
+# ============================================================================
+
+class TestStreamRecorder:
+    def test_waits_for_idr_and_fragments_on_idr(self, tmp_path):
+        out = tmp_path / "rec.mp4"
+        rec = StreamRecorder(out, fps=30)
+        t = 100.0
+        rec.write(_p_au(), t)  # ignored: no IDR yet
+        for i in range(60):
+            au = _idr_au() if i % 30 == 0 else _p_au()
+            rec.write(au, t + i / 30.0)
+        rec.close()
+
+        data = out.read_bytes()
+        top = [typ for typ, _pos, _size in _boxes(data)]
+        assert top[:2] == [b"ftyp", b"moov"]
+        assert top[2:] == [b"moof", b"mdat"] * 2
+        assert rec.samples_written == 60
+        assert rec.dropped_fragments == 0
+        assert b"avcC" in data
+
+    def test_sample_durations_follow_send_timestamps(self, tmp_path):
+        out = tmp_path / "rec.mp4"
+        rec = StreamRecorder(out, fps=30)
+        times = [0.0, 1 / 30.0, 3 / 30.0]  # one late frame
+        for i, t in enumerate(times):
+            rec.write(_idr_au() if i == 0 else _p_au(), t)
+        rec.close()
+
+        data = out.read_bytes()
+        pos = data.index(b"trun") - 4
+        _size, _typ, _vf, count, _offset = struct.unpack(">I4sIIi", data[pos:pos + 20])
+        entries = [struct.unpack(">III", data[pos + 20 + 12 * i:pos + 32 + 12 * i]) for i in range(count)]
+        durations = [d for d, _s, _f in entries]
+        assert durations == [TIMESCALE // 30, 2 * TIMESCALE // 30, TIMESCALE // 30]
+        assert entries[0][2] == 0x02000000  # sync sample
+
+    def test_trun_data_offset_points_into_mdat(self, tmp_path):
+        out = tmp_path / "rec.mp4"
+        rec = StreamRecorder(out, fps=30)
+        rec.write(_idr_au(), 0.0)
+        rec.close()
+
+        data = out.read_bytes()
+        boxes = _boxes(data)
+        (_t, moof_pos, moof_size), (_t2, mdat_pos, _mdat_size) = boxes[2], boxes[3]
+        trun = data.index(b"trun", moof_pos) - 4
+        offset = struct.unpack(">i", data[trun + 16:trun + 20])[0]
+        assert moof_pos + offset == mdat_pos + 8
+        assert data[moof_pos + offset + 4] == 0x67  # first NAL is the in-band SPS
+
+    def test_unknown_sps_disables_recording(self, tmp_path):
+        out = tmp_path / "rec.mp4"
+        rec = StreamRecorder(out, fps=30)
+        rec.write(_SC + b"\x67" + _SC + _PPS + _SC + b"\x65\x88", 0.0)
+        rec.close()
+        assert out.read_bytes() == b""
+
+    def test_write_error_stops_recording(self, tmp_path):
+        class _FullDisk:
+            closed = False
+
+            def write(self, _data):
+                raise OSError(28, "No space left on device")
+
+            def flush(self):
+                pass
+
+            def close(self):
+                self.closed = True
+
+        rec = StreamRecorder(tmp_path / "rec.mp4", fps=30, fragment_seconds=0.05)
+        rec._fp.close()
+        disk = rec._fp = _FullDisk()
+        for i in range(10):
+            rec.write(_idr_au() if i == 0 else _p_au(), i / 30.0)
+        deadline = time.monotonic() + 2.0
+        while not rec.failed and time.monotonic() < deadline:
+            time.sleep(0.005)
+
+        assert rec.failed
+        assert disk.closed
+        fragments = rec.fragments_written
+        for i in range(10, 20):
+            rec.write(_p_au(), i / 30.0)
+        assert rec.fragments_written == fragments  # nothing queued after the failure
+        rec.close(timeout=1.0)
+        assert not rec._writer.is_alive()
@@ -0,0 +1,109 @@
+"""
+Texture codec tests
+
+Checks the ETC2 block encoder against its reference decoder, the VRHT payload
+header, and that tile-cached encodes match a full re-encode.
+"""
+
+import numpy as np
+import pytest
+
+from mesmerglass.mesmervisor import texture_codec
+from mesmerglass.mesmervisor.texture_codec import (
+    TEXTURE_FLAG_LZ4,
+    TEXTURE_FORMAT_ETC2_RGB8,
+    TEXTURE_HEADER,
+    TileCachedETC2,
+    etc2_decode_blocks,
+    etc2_encode_blocks,
+    etc2_encode_frame,
+    frame_to_blocks,
+    pack_texture_payload,
+    unpack_texture_payload,
+)
+
+
+def _gradient(h=64, w=128):
+    y, x = np.mgrid[0:h, 0:w]
+    return np.stack([x * 255 // (w - 1), y * 255 // (h - 1), (x + y) % 256], axis=-1).astype(np.uint8)
+
+
+def _decode_frame(blocks, h, w):
+    pixels = etc2_decode_blocks(blocks).reshape(h // 4, w // 4, 4, 4, 3)
+    return pixels.swapaxes(1, 2).reshape(h, w, 3)
+
+
+def _psnr(a, b):
+    mse = np.mean((a.astype(np.float64) - b.astype(np.float64)) ** 2)
+    return 99.0 if mse == 0 else 10 * np.log10(255.0 ** 2 / mse)
+
+
+class TestETC2Blocks:
+    def test_solid_block_bit_layout(self):
+        """A flat block uses differential mode with a zero delta."""
+        block = np.full((1, 4, 4, 3), (200, 100, 50), dtype=np.uint8)
+        out = etc2_encode_blocks(block)
+        assert out.shape == (1, 8)
+        assert out[0, 3] & 0x2  # diff bit
+        for c in range(3):
+            assert out[0, c] & 0x7 == 0  # dR/dG/dB = 0
+        decoded = etc2_decode_blocks(out)
+        assert np.abs(decoded.astype(int) - (200, 100, 50)).max() <= 8
+
+    def test_gradient_round_trip_quality(self):
+        frame = _gradient()
+        decoded = _decode_frame(etc2_encode_frame(frame), *frame.shape[:2])
+        assert _psnr(frame, decoded) > 30.0
+
+    def test_frame_and_block_paths_agree(self):
+        frame = _gradient()
+        blocks = frame_to_blocks(frame).reshape(-1, 4, 4, 3)
+        np.testing.assert_array_equal(etc2_encode_frame(frame), etc2_encode_blocks(blocks))
+
+    def test_unaligned_frame_is_padded(self):
+        frame = _gradient(30, 50)
+        assert etc2_encode_frame(frame).shape == (8 * 13, 8)
+
+    def test_empty_input(self):
+        assert etc2_encode_blocks(np.zeros((0, 4, 4, 3), np.uint8)).shape == (0, 8)
+
+
+class TestTexturePayload:
+    def test_pack_unpack(self):
+        blocks = etc2_encode_frame(_gradient())
+        payload = pack_texture_payload(128, 64, blocks)
+        width, height, fmt, flags, _reserved, body_size = TEXTURE_HEADER.unpack_from(payload)
+        assert (width, height, fmt, flags) == (128, 64, TEXTURE_FORMAT_ETC2_RGB8, 0)
+        assert body_size == blocks.size == len(payload) - TEXTURE_HEADER.size
+        assert unpack_texture_payload(payload) == (128, 64, TEXTURE_FORMAT_ETC2_RGB8, 0, blocks.tobytes())
+
+    @pytest.mark.skipif(not texture_codec.lz4_available(), reason="lz4 not installed")
+    def test_pack_unpack_lz4(self):
+        blocks = etc2_encode_frame(_gradient())
+        payload = pack_texture_payload(128, 64, blocks, use_lz4=True)
+        _w, _h, _fmt, flags, body = unpack_texture_payload(payload)
+        assert flags & TEXTURE_FLAG_LZ4
+        assert body == blocks.tobytes()
+
+
+class TestTileCache:
+    def test_partial_update_matches_full_encode(self):
+        cache = TileCachedETC2()
+        frame = _gradient(128, 192)
+        cache.encode(frame)
+        changed = frame.copy()
+        changed[70:90, 10:30] = (255, 0, 0)
+        out = cache.encode(changed)
+        np.testing.assert_array_equal(out, etc2_encode_frame(changed))
+        assert cache.tiles_reused == 5  # one of six 64x64 tiles changed
+
+    def test_stereo_eyes_keep_separate_slots(self):
+        cache = TileCachedETC2()
+        left = _gradient(128, 128)
+        right = np.ascontiguousarray(left[:, ::-1])
+        cache.encode(left)
+        cache.encode(right)
+        reused = cache.tiles_reused
+        cache.encode(left)
+        cache.encode(right)
+        assert cache.tiles_reused == reused + 8
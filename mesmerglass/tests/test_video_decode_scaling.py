@@ -0,0 +1,89 @@
+"""
+Decode-time downscaling for background videos
+
+Frames must leave VideoDecoder no smaller than the target surface in either
+axis, keep their aspect ratio, never be upscaled, and cached decoders opened
+for a different target must not be reused.
+"""
+
+import sys
+from types import SimpleNamespace
+from unittest.mock import MagicMock
+
+import numpy as np
+import pytest
+
+from mesmerglass.content import video
+from mesmerglass.content.video import VideoDecoder, _lowres_factor, decode_output_size
+
+
+def test_output_size_covers_target_without_upscaling():
+    assert decode_output_size(3840, 2160, (1920, 1080)) == (1920, 1080)
+    # Portrait target: cover-fit keeps height >= target, width follows aspect.
+    assert decode_output_size(3840, 2160, (1080, 1920)) == (3414, 1920)
+    assert decode_output_size(1280, 720, (1920, 1080)) == (1280, 720)
+    assert decode_output_size(3840, 2160, None) == (3840, 2160)
+    w, h = decode_output_size(4095, 2161, (1001, 501))
+    assert w % 2 == 0 and h % 2 == 0 and w >= 1001 and h >= 501
+
+
+def test_lowres_factor_never_undershoots_output():
+    assert _lowres_factor(3840, 2160, 1920, 1080) == 1
+    assert _lowres_factor(3840, 2160, 960, 540) == 2
+    assert _lowres_factor(3840, 2160, 100, 100) == 3
+    assert _lowres_factor(1920, 1080, 1920, 1080) == 0
+
+
+def _fake_cv2(src_w, src_h, frames):
+    cap = MagicMock()
+    cap.isOpened.return_value = True
+    props = {1: float(src_w), 2: float(src_h), 3: 30.0, 4: float(frames)}
+    cap.get.side_effect = lambda prop: props[prop]
+    cap.read.side_effect = [(True, np.zeros((src_h, src_w, 3), np.uint8))] * frames + [(False, None)]
+
+    def resize(img, size, interpolation=None):
+        return np.zeros((size[1], size[0], img.shape[2]), img.dtype)
+
+    return SimpleNamespace(
+        VideoCapture=MagicMock(return_value=cap),
+        CAP_PROP_FRAME_WIDTH=1, CAP_PROP_FRAME_HEIGHT=2, CAP_PROP_FPS=3, CAP_PROP_FRAME_COUNT=4,
+        CAP_PROP_POS_FRAMES=5, INTER_AREA=3, COLOR_BGR2RGB=4,
+        resize=MagicMock(side_effect=resize),
+        cvtColor=lambda img, code: img,
+    )
+
+
+@pytest.fixture
+def opencv_backend(monkeypatch):
+    monkeypatch.setattr(video, "VIDEO_DECODE_BACKEND", "opencv")
+    monkeypatch.setattr(video, "_DECODE_TARGET_PINNED", False)
+    monkeypatch.setattr(video, "_DECODE_TARGET", None)
+
+
+def test_opencv_fallback_scales_frames_to_target(tmp_path, monkeypatch, opencv_backend):
+    clip = tmp_path / "bg.mp4"
+    clip.write_bytes(b"\0")
+    cv2 = _fake_cv2(640, 360, frames=2)
+    monkeypatch.setitem(sys.modules, "cv2", cv2)
+
+    decoder = VideoDecoder(clip, target_size=(320, 180))
+    frame = decoder.next_frame()
+
+    assert (decoder.source_width, decoder.source_height) == (640, 360)
+    assert (frame.width, frame.height) == (320, 180)
+    assert frame.data.shape == (180, 320, 3)
+    assert cv2.resize.call_args.kwargs["interpolation"] == cv2.INTER_AREA
+
+
+def test_cached_decoder_for_other_target_is_reopened(tmp_path, monkeypatch, opencv_backend):
+    clip = tmp_path / "bg.mp4"
+    clip.write_bytes(b"\0")
+    monkeypatch.setitem(sys.modules, "cv2", _fake_cv2(640, 360, frames=1))
+    monkeypatch.setattr(video, "_DECODER_CACHE", video.OrderedDict())
+
+    video.set_decode_target_size((320, 180))
+    video._return_cached_decoder(VideoDecoder(clip))
+    video.set_decode_target_size((640, 360))
+
+    assert video._checkout_cached_decoder(clip) is None
+    assert not video._DECODER_CACHE
@@ -0,0 +1,299 @@
+"""
+Multicast stream transport tests
+
+Runs several receivers on the loopback interface: FEC recovers scattered
+losses, REPAIR recovers a block that lost more than its parity, and the server
+in multicast mode sends one copy of each frame to the group while its TCP
+connections carry JOIN and control only.
+"""
+
+import random
+import select
+import socket
+import struct
+import time
+
+import numpy as np
+import pytest
+
+from mesmerglass.mesmervisor.asset_cache import ControlParser
+from mesmerglass.mesmervisor.gpu_utils import EncoderType
+from mesmerglass.mesmervisor.multicast import (
+    CONTROL_MULTICAST_JOIN,
+    MulticastSender,
+    Reassembler,
+    parse_group,
+    repair_request,
+)
+from mesmerglass.mesmervisor.streaming_server import VRStreamingServer
+
+LOOPBACK = "127.0.0.1"
+
+
+def _free_port(kind=socket.SOCK_DGRAM):
+    with socket.socket(socket.AF_INET, kind) as s:
+        s.bind((LOOPBACK, 0))
+        return s.getsockname()[1]
+
+
+def _join(group, port):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 * 1_048_576)
+    sock.bind(("", port))
+    try:
+        sock.setsockopt(
+            socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, socket.inet_aton(group) + socket.inet_aton(LOOPBACK)
+        )
+    except OSError as e:
+        sock.close()
+        pytest.skip(f"multicast on loopback unavailable: {e}")
+    sock.setblocking(False)
+    return sock
+
+
+def _drain(sock):
+    out = []
+    while True:
+        try:
+            out.append(sock.recv(65536))
+        except BlockingIOError:
+            return out
+
+
+def test_parse_group_and_repair_message():
+    assert parse_group("1") == ("239.255.77.1", 5557)
+    assert parse_group("239.1.2.3:6000") == ("239.1.2.3", 6000)
+    with pytest.raises(ValueError):
+        parse_group("192.168.1.5")
+    parser = ControlParser()
+    message = repair_request(70000, 3, 5)
+    assert parser.feed(b"\x01" + message[:4]) == [("need_idr", None)]
+    assert parser.feed(message[4:]) == [("repair", (70000, 3, 5))]
+
+
+def test_loopback_receivers_recover_losses():
+    group, port = "239.255.77.3", _free_port()
+    receivers = [_join(group, port) for _ in range(3)]
+    sender = MulticastSender(group, port, interface=LOOPBACK, fec_ratio=0.1, epoch=42)
+    rng = np.random.default_rng(7)
+    packets = [rng.integers(0, 256, size, dtype=np.uint8).tobytes() for size in (900, 20_000, 150_000, 400_000)] * 3
+    try:
+        losses = [random.Random(i) for i in range(len(receivers))]
+        reassemblers = [Reassembler(epoch=42) for _ in receivers]
+        delivered = [[] for _ in receivers]
+
+        def pump(seq, now):
+            time.sleep(0.02)
+            for r, (sock, reasm) in enumerate(zip(receivers, reassemblers)):
+                for n, datagram in enumerate(_drain(sock)):
+                    # Receiver 0 also loses a burst of frame 2: more than its block's parity.
+                    if losses[r].random() < 0.04 or (r == 0 and seq == 2 and 10 <= n < 30):
+                        continue
+                    delivered[r] += reasm.push(datagram, now)
+
+        for seq, packet in enumerate(packets):
+            now = seq / 60
+            sender.send_frame(packet, keyframe=True)
+            pump(seq, now)
+            # Repairs go to the whole group, so every receiver sees them.
+            for reasm in reassemblers:
+                for request in reasm.repair_requests(now + 0.01):
+                    sender.repair(*request)
+            pump(None, now + 0.01)
+        for r, reasm in enumerate(reassemblers):
+            delivered[r] += reasm.poll(now + 1.0)
+
+        for r, reasm in enumerate(reassemblers):
+            assert delivered[r] == packets, (r, reasm.stats())
+            assert reasm.stats()["recovered"] > 0
+        assert reassemblers[0].stats()["repaired"] >= 1
+        stats = sender.stats()
+        assert stats["repairs_sent"] > 0
+        # One copy on the air regardless of receivers: payload plus ~10% parity, headers and repairs.
+        assert stats["bytes"] < 1.2 * sum(len(p) for p in packets)
+    finally:
+        sender.close()
+        for sock in receivers:
+            sock.close()
+
+
+
+def test_full_send_buffer_drops_instead_of_blocking():
+    group, port = "239.255.77.5", _free_port()
+    sender = MulticastSender(group, port, interface=LOOPBACK, epoch=3)
+    assert sender._sock.getblocking() is False
+    real = sender._sock
+
+    class _FullSocket:
+        calls = 0
+
+        def sendto(self, datagram, target):
+            self.calls += 1
+            if self.calls % 2:
+                raise BlockingIOError
+            return len(datagram)
+
+    sender._sock = _FullSocket()
+    try:
+        seq = sender.send_frame(b"x" * 20_000, keyframe=True)
+        stats = sender.stats()
+        assert 0 < stats["datagrams"] < sender._sock.calls
+        assert sender.repair(seq, 0, 2) == 2
+        assert sender.stats()["repairs_sent"] == 2
+    finally:
+        sender._sock = real
+        sender.close()
+
+
+def test_burst_of_lost_frames_expires_together():
+    sender = MulticastSender("239.255.77.6", _free_port(), interface=LOOPBACK, epoch=5)
+    captured = []
+
+    class _Capture:
+        def sendto(self, datagram, target):
+            captured.append(datagram)
+            return len(datagram)
+
+    real, sender._sock = sender._sock, _Capture()
+    frames = []
+    try:
+        for seq in range(10):
+            del captured[:]
+            sender.send_frame(bytes([seq]) * 3000, keyframe=seq in (0, 9))
+            frames.append(list(captured))
+    finally:
+        sender._sock = real
+        sender.close()
+
+    reasm = Reassembler(epoch=5, hold_s=0.05)
+    delivered = []
+    for seq in (0, 1, 2, 8):  # 3..7 never arrive
+        for datagram in frames[seq]:
+            delivered += reasm.push(datagram, now=seq * 0.001)
+    assert reasm.repair_requests(0.02) == []
+    assert reasm.take_keyframe_request()  # no shard of 3..7 to repair
+    assert reasm.poll(0.05) == [] and reasm.lost == 0
+    reasm.poll(0.06)
+    assert reasm.lost == 5  # one hold for the whole burst
+    assert not reasm.take_keyframe_request()  # already asked
+    for datagram in frames[9]:
+        delivered += reasm.push(datagram, now=0.07)
+    assert [p[-1] for p in delivered] == [0, 1, 2, 9]
+
+
+def test_stray_far_ahead_datagram_is_rejected():
+    sender = MulticastSender("239.255.77.7", _free_port(), interface=LOOPBACK, epoch=6)
+    captured = []
+
+    class _Capture:
+        def sendto(self, datagram, target):
+            captured.append(datagram)
+            return len(datagram)
+
+    real, sender._sock = sender._sock, _Capture()
+    frames = {}
+    try:
+        for seq, key in [(0, True), (1, False), (3_000_000_000, False), (2, False), (3_000_000_100, True)]:
+            del captured[:]
+            sender.next_seq = seq
+            sender.send_frame(bytes([seq & 0xFF]) * 3000, keyframe=key)
+            frames[seq] = list(captured)
+    finally:
+        sender._sock = real
+        sender.close()
+
+    reasm = Reassembler(epoch=6, hold_s=0.05)
+    delivered = []
+    for t, seq in enumerate((0, 1, 3_000_000_000, 2)):
+        for datagram in frames[seq]:
+            delivered += reasm.push(datagram, now=t * 0.001)
+    start = time.perf_counter()
+    delivered += reasm.poll(10.0)
+    reasm.repair_requests(10.0)
+    assert time.perf_counter() - start < 0.5  # no walk towards the stray's seq
+    assert [p[-1] for p in delivered] == [0, 1, 2]
+    assert reasm.lost == 0
+
+    # After an outage longer than the hold the stream is followed wherever it resumed.
+    for datagram in frames[3_000_000_100]:
+        delivered += reasm.push(datagram, now=10.0)
+    assert [p[-1] for p in delivered] == [0, 1, 2, 3_000_000_100 & 0xFF]
+
+
+def test_dropped_frame_waits_for_keyframe():
+    group, port = "239.255.77.4", _free_port()
+    sock = _join(group, port)
+    sender = MulticastSender(group, port, interface=LOOPBACK, epoch=1)
+    reasm = Reassembler(epoch=1, hold_s=0.01)
+    try:
+        delivered = []
+        for seq, key in enumerate([True, False, False, False, True]):
+            sender.send_frame(bytes([seq]) * 3000, keyframe=key)
+            time.sleep(0.01)
+            for datagram in _drain(sock):
+                if seq != 1:  # frame 1 never arrives
+                    delivered += reasm.push(datagram, seq * 0.02)
+        delivered += reasm.poll(1.0)
+        assert [p[0] for p in delivered] == [0, 4]
+        assert reasm.stats()["lost"] == 1 and reasm.take_keyframe_request()
+        assert not reasm.take_keyframe_request()
+    finally:
+        sender.close()
+        sock.close()
+
+
+def _recv_packet(sock):
+    (size,) = struct.unpack("!I", sock.recv(4, socket.MSG_WAITALL))
+    return sock.recv(size, socket.MSG_WAITALL)
+
+
+def test_server_multicasts_one_stream_to_every_headset(monkeypatch):
+    monkeypatch.delenv("MESMERGLASS_VRHT_SIZE", raising=False)
+    group, group_port = "239.255.77.5", _free_port()
+    server = VRStreamingServer(
+        host=LOOPBACK,
+        port=_free_port(socket.SOCK_STREAM),
+        discovery_port=None,
+        encoder_type=EncoderType.ETC2,
+        width=64,
+        height=32,
+        fps=30,
+        multicast=f"{group}:{group_port}",
+        multicast_interface=LOOPBACK,
+    )
+    server.target_width, server.target_height = 64, 32
+    server.start_server()
+    headsets = []
+    try:
+        time.sleep(0.3)
+        for _ in range(3):
+            control = socket.create_connection((LOOPBACK, server.port), timeout=2.0)
+            packet = _recv_packet(control)
+            assert packet[:4] == b"VRHC" and packet[16] == CONTROL_MULTICAST_JOIN
+            joined_group, joined_port, epoch = struct.unpack("!4sHH", packet[17:25])
+            assert (socket.inet_ntoa(joined_group), joined_port) == (group, group_port)
+            headsets.append((control, _join(group, group_port), Reassembler(epoch=epoch), []))
+
+        deadline = time.time() + 1.5
+        while time.time() < deadline:
+            select.select([h[1] for h in headsets], [], [], 0.05)
+            now = time.perf_counter()
+            for _control, sock, reasm, frames in headsets:
+                for datagram in _drain(sock):
+                    frames += reasm.push(datagram, now)
+        headsets[0][0].sendall(b"\x01" + repair_request(0, 0, 1))
+        time.sleep(0.2)
+
+        for _control, _sock, reasm, frames in headsets:
+            assert len(frames) >= 15, reasm.stats()
+            assert all(f[4:8] == b"VRHT" for f in frames)
+        stats = server.multicast_stats()
+        assert stats["headsets"] == 3 and stats["repair_requests"] == 1
+        # Every headset saw the same frames, sent once each.
+        assert server.frames_sent <= stats["frames"] + 1
+    finally:
+        server.stop_server()
+        for control, sock, _reasm, _frames in headsets:
+            control.close()
+            sock.close()
@@ -27,6 +27,7 @@ from .tabs.display_tab import DisplayTab
 from .tabs.devices_tab import DevicesTab
 from .pages.performance import PerformancePage
 from ..content.simple_video_streamer import SimpleVideoStreamer
+from ..content import bundle as session_bundle
 from ..content.media_scan import scan_media_directory, scan_font_directory
 from ..content.themebank import ThemeBank
 from ..content.theme import ThemeConfig
@@ -628,7 +629,7 @@ class MainApplication(QMainWindow):
             self, 
             "Open Session",
             str(initial_dir),
-            "Session Files (*.session.json);;All Files (*)"
+            "Session Files (*.session.json *.mgbundle);;All Files (*)"
         )
         
         if not file_path:
@@ -1171,7 +1172,7 @@ class MainApplication(QMainWindow):
                     media_type = entry.get('type', 'images')
 
                     try:
-                        exists_now = media_dir.exists()
+                        exists_now = session_bundle.exists(media_dir)
                     except Exception:
                         exists_now = False
                     self.logger.info(
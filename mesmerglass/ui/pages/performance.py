@@ -380,18 +380,22 @@ class PerformancePage(QWidget):
         self._stream_clients_grid.setColumnStretch(2, 0)
         self._stream_clients_grid.setColumnStretch(3, 0)
         self._stream_clients_grid.setColumnStretch(4, 0)
+        self._stream_clients_grid.setColumnStretch(5, 0)
 
         self._stream_clients_grid.setColumnMinimumWidth(1, 90)
         self._stream_clients_grid.setColumnMinimumWidth(2, 90)
         self._stream_clients_grid.setColumnMinimumWidth(3, 70)
         self._stream_clients_grid.setColumnMinimumWidth(4, 70)
+        self._stream_clients_grid.setColumnMinimumWidth(5, 110)
 
         hdr_name = QLabel("Device")
         hdr_buf = QLabel("Buffer (ms)")
         hdr_fps = QLabel("Client FPS")
         hdr_bitrate = QLabel("Bitrate")
         hdr_proto = QLabel("Proto")
-        for h in (hdr_name, hdr_buf, hdr_fps, hdr_bitrate, hdr_proto):
+        hdr_jitter = QLabel("Send jitter (ms)")
+        hdr_jitter.setToolTip("Average / max lateness of packet sends versus the server's frame timeline")
+        for h in (hdr_name, hdr_buf, hdr_fps, hdr_bitrate, hdr_proto, hdr_jitter):
             h.setStyleSheet("font-weight: 600;")
             h.setAlignment(Qt.AlignmentFlag.AlignLeft)
 
@@ -400,9 +404,10 @@ class PerformancePage(QWidget):
         self._stream_clients_grid.addWidget(hdr_fps, 0, 2)
         self._stream_clients_grid.addWidget(hdr_bitrate, 0, 3)
         self._stream_clients_grid.addWidget(hdr_proto, 0, 4)
+        self._stream_clients_grid.addWidget(hdr_jitter, 0, 5)
 
         stream_metrics_v.addLayout(self._stream_clients_grid)
-        self._stream_row_cells: dict[str, tuple[QLabel, QLabel, QLabel, QLabel, QLabel]] = {}
+        self._stream_row_cells: dict[str, tuple[QLabel, QLabel, QLabel, QLabel, QLabel, QLabel]] = {}
 
         streaming_layout.addWidget(stream_metrics_box)
 
@@ -891,6 +896,10 @@ class PerformancePage(QWidget):
             if c.client_fps_milli is not None and c.client_fps_milli > 0:
                 fps = f"{(float(c.client_fps_milli) / 1000.0):.2f}"
 
+            jitter = "--"
+            if c.send_jitter_avg_ms is not None and c.send_jitter_max_ms is not None:
+                jitter = f"{c.send_jitter_avg_ms:.2f} / {c.send_jitter_max_ms:.1f}"
+
             cells = self._stream_row_cells.get(c.client_id)
             if cells is None:
                 lab_name = QLabel()
@@ -898,9 +907,10 @@ class PerformancePage(QWidget):
                 lab_fps = QLabel()
                 lab_bitrate = QLabel()
                 lab_proto = QLabel()
-                for w in (lab_name, lab_buf, lab_fps, lab_bitrate, lab_proto):
+                lab_jitter = QLabel()
+                for w in (lab_name, lab_buf, lab_fps, lab_bitrate, lab_proto, lab_jitter):
                     w.setAlignment(Qt.AlignmentFlag.AlignLeft)
-                cells = (lab_name, lab_buf, lab_fps, lab_bitrate, lab_proto)
+                cells = (lab_name, lab_buf, lab_fps, lab_bitrate, lab_proto, lab_jitter)
                 self._stream_row_cells[c.client_id] = cells
 
             cells[0].setText(name)
@@ -908,12 +918,14 @@ class PerformancePage(QWidget):
             cells[2].setText(fps)
             cells[3].setText(bitrate)
             cells[4].setText(proto)
+            cells[5].setText(jitter)
 
             self._stream_clients_grid.addWidget(cells[0], row_index, 0)
             self._stream_clients_grid.addWidget(cells[1], row_index, 1)
             self._stream_clients_grid.addWidget(cells[2], row_index, 2)
             self._stream_clients_grid.addWidget(cells[3], row_index, 3)
             self._stream_clients_grid.addWidget(cells[4], row_index, 4)
+            self._stream_clients_grid.addWidget(cells[5], row_index, 5)
 
     def _client_color(self, client_id: str, base_color) -> "QColor":
         # Deterministic hue shift based on client_id.
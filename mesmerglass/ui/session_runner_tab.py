@@ -20,6 +20,7 @@ from PyQt6.QtWidgets import (
     QProgressBar, QFrame, QMessageBox, QDialog
 )
 
+from mesmerglass.session import replay
 from mesmerglass.session.audio_prefetch import (
     gather_audio_paths_for_cuelist,
     prefetch_audio_for_cuelist,
@@ -55,6 +56,7 @@ class SessionRunnerTab(QWidget):
         # Session state
         self.cuelist = None
         self.session_runner = None
+        self._trace_recorder = None
         self.cuelist_path = None
 
         # Legacy placeholder: used by some stop-session cleanup paths.
@@ -548,6 +550,12 @@ class SessionRunnerTab(QWidget):
                             
                             self.logger.debug(f"Resolved playback '{playback_name}' -> {playback_file}")
             
+            # Optional trace of timing/random inputs for headless replay
+            # (MESMERGLASS_SESSION_TRACE; see session/replay.py)
+            self._close_trace_recorder()
+            self._trace_recorder = replay.recorder_from_env()
+            recorder = self._trace_recorder
+
             # Create SessionRunner
             self.session_runner = SessionRunner(
                 cuelist=self.cuelist,
@@ -555,8 +563,12 @@ class SessionRunnerTab(QWidget):
                 audio_engine=self.audio_engine,
                 compositor=self.compositor,
                 display_tab=self.display_tab,  # Pass display selection
-                session_data=self.session_data  # Pass session data for playback config access
+                session_data=self.session_data,  # Pass session data for playback config access
+                time_provider=recorder.clock if recorder else None,
+                rng=recorder.rng if recorder else None,
             )
+            if recorder:
+                recorder.attach(self.session_runner)
             
             # Connect events (use .subscribe() not .on())
             self.session_runner.event_emitter.subscribe(
@@ -625,6 +637,7 @@ class SessionRunnerTab(QWidget):
             except Exception as e:
                 self.logger.error(f"Error stopping session: {e}", exc_info=True)
             pass
+        self._close_trace_recorder()
         
         # Reset UI
         self.update_timer.stop()
@@ -716,6 +729,15 @@ class SessionRunnerTab(QWidget):
         """Handle CUE_ENDED event."""
         pass  # Just for logging if needed
     
+    def _close_trace_recorder(self):
+        """Finish the session trace, if one is being recorded."""
+        recorder, self._trace_recorder = self._trace_recorder, None
+        if recorder:
+            try:
+                recorder.close()
+            except Exception as e:
+                self.logger.warning(f"Failed to close session trace: {e}")
+    
     def _on_session_ended(self, event):
         """Handle SESSION_ENDED event."""
         self._on_stop_session()
@@ -376,12 +376,22 @@ class HomeTab(BaseTab):
             except Exception:
                 pass
 
-        if not self._preview_frame_connected and hasattr(primary, "frame_ready"):
-            try:
-                primary.frame_ready.connect(self._on_preview_frame)
-                self._preview_frame_connected = True
-            except Exception:
-                pass
+        if not self._preview_frame_connected:
+            signal = self._preview_signal(primary)
+            if signal is not None:
+                try:
+                    signal.connect(self._on_preview_frame)
+                    self._preview_frame_connected = True
+                except Exception:
+                    pass
+
+    @staticmethod
+    def _preview_signal(compositor):
+        """Prefer the dedicated (GPU-downsampled) preview signal when available."""
+        signal = getattr(compositor, "preview_frame_ready", None)
+        if signal is None:
+            signal = getattr(compositor, "frame_ready", None)
+        return signal
 
     def _unregister_preview_compositor(self) -> None:
         if not self._preview_registered:
@@ -389,9 +399,10 @@ class HomeTab(BaseTab):
 
         primary = getattr(self.main_window, "compositor", None)
         if primary is not None:
-            if self._preview_frame_connected and hasattr(primary, "frame_ready"):
+            signal = self._preview_signal(primary)
+            if self._preview_frame_connected and signal is not None:
                 try:
-                    primary.frame_ready.disconnect(self._on_preview_frame)
+                    signal.disconnect(self._on_preview_frame)
                 except Exception:
                     pass
                 self._preview_frame_connected = False
@@ -0,0 +1,130 @@
+/**
+ * H.264 / HEVC Annex-B helpers
+ */
+
+#include "annexb.h"
+
+#include "h264_syntax.h"
+#include "hevc_syntax.h"
+
+#include <cstring>
+
+namespace vrrenderer {
+namespace annexb {
+
+size_t findStartCode(const uint8_t* data, size_t len, size_t from, size_t* startLen) {
+    size_t i = from;
+    while (i + 3 <= len) {
+        // memchr skips long runs of slice data quickly; start codes begin with 0x00.
+        const void* z = std::memchr(data + i, 0, len - i);
+        if (z == nullptr) {
+            break;
+        }
+        i = static_cast<size_t>(static_cast<const uint8_t*>(z) - data);
+        if (i + 3 > len) {
+            break;
+        }
+        if (data[i + 1] == 0) {
+            if (data[i + 2] == 1) {
+                *startLen = 3;
+                return i;
+            }
+            if (i + 4 <= len && data[i + 2] == 0 && data[i + 3] == 1) {
+                *startLen = 4;
+                return i;
+            }
+        }
+        i++;
+    }
+    *startLen = 0;
+    return len;
+}
+
+bool hasStartCode(const uint8_t* data, size_t len) {
+    size_t scLen = 0;
+    return len >= 4 && findStartCode(data, len > 64 ? 64 : len, 0, &scLen) == 0;
+}
+
+bool containsIdr(const uint8_t* data, size_t len, Codec codec) {
+    bool found = false;
+    forEachNal(data, len, [&](const NalUnit& nal) {
+        found = isIdr(nal.type, codec);
+        return !found;
+    }, codec);
+    return found;
+}
+
+bool containsSlice(const uint8_t* data, size_t len, Codec codec) {
+    bool found = false;
+    forEachNal(data, len, [&](const NalUnit& nal) {
+        found = isVcl(nal.type, codec);
+        return !found;
+    }, codec);
+    return found;
+}
+
+bool isFirstSliceOfPicture(const NalUnit& nal, Codec codec) {
+    if (codec == Codec::kHevc) {
+        // first_slice_segment_in_pic_flag is the first bit after the two-byte header.
+        return isVcl(nal.type, codec) && nal.size > 2 && (nal.data[2] & 0x80) != 0;
+    }
+    // first_mb_in_slice is ue(v); a value of 0 codes as a single '1' bit.
+    return isVcl(nal.type) && nal.size > 1 && (nal.data[1] & 0x80) != 0;
+}
+
+bool extractParameterSets(const uint8_t* data, size_t len, std::vector<uint8_t>* sps, std::vector<uint8_t>* pps,
+                          Codec codec, std::vector<uint8_t>* vps) {
+    const bool hevc = codec == Codec::kHevc;
+    const int spsType = hevc ? static_cast<int>(kHevcNalSps) : static_cast<int>(kNalSps);
+    const int ppsType = hevc ? static_cast<int>(kHevcNalPps) : static_cast<int>(kNalPps);
+    bool haveVps = !hevc;
+    bool haveSps = false;
+    bool havePps = false;
+    forEachNal(data, len, [&](const NalUnit& nal) {
+        if (nal.type == spsType && !haveSps) {
+            sps->assign(nal.data, nal.data + nal.size);
+            haveSps = true;
+        } else if (nal.type == ppsType && !havePps) {
+            pps->assign(nal.data, nal.data + nal.size);
+            havePps = true;
+        } else if (hevc && nal.type == kHevcNalVps && !haveVps) {
+            if (vps != nullptr) {
+                vps->assign(nal.data, nal.data + nal.size);
+            }
+            haveVps = true;
+        }
+        return !(haveVps && haveSps && havePps) && !isVcl(nal.type, codec);
+    }, codec);
+    return haveVps && haveSps && havePps;
+}
+
+bool spsDimensions(const uint8_t* sps, size_t len, int* width, int* height, Codec codec) {
+    if (codec == Codec::kHevc) {
+        hevc::Sps parsed;
+        if (!hevc::parseSps(sps, len, &parsed)) {
+            return false;
+        }
+        *width = parsed.width;
+        *height = parsed.height;
+        return true;
+    }
+    h264::Sps parsed;
+    if (!h264::parseSps(sps, len, &parsed)) {
+        return false;
+    }
+    *width = parsed.width;
+    *height = parsed.height;
+    return true;
+}
+
+std::vector<std::vector<uint8_t>> splitAccessUnits(const uint8_t* data, size_t len, Codec codec) {
+    std::vector<std::vector<uint8_t>> units;
+    forEachAccessUnit(data, len, [&](const uint8_t* begin, const uint8_t* end) {
+        units.emplace_back(begin, end);
+        return true;
+    }, codec);
+    return units;
+}
+
+}  // namespace annexb
+}  // namespace vrrenderer
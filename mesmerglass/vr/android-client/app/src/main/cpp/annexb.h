@@ -0,0 +1,163 @@
+/**
+ * H.264 / HEVC Annex-B helpers
+ *
+ * Start-code scanning and the few bitstream fields the decode pipeline needs
+ * (NAL types, SPS dimensions, first slice of a picture). Mirrors the
+ * server-side mesmervisor/annexb.py so both ends agree on what an access unit
+ * contains. Both codecs share the start-code layout; HEVC NAL headers are two
+ * bytes with the type in bits 1-6 of the first.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vrrenderer {
+namespace annexb {
+
+enum NalType : int {
+    kNalSlice = 1,
+    kNalIdr = 5,
+    kNalSei = 6,
+    kNalSps = 7,
+    kNalPps = 8,
+    kNalAud = 9,
+};
+
+enum HevcNalType : int {
+    kHevcNalIdrWRadl = 19,
+    kHevcNalIdrNLp = 20,
+    kHevcNalCra = 21,
+    kHevcNalVps = 32,
+    kHevcNalSps = 33,
+    kHevcNalPps = 34,
+    kHevcNalAud = 35,
+    kHevcNalSeiPrefix = 39,
+};
+
+enum class Codec : int { kH264 = 0, kHevc = 1 };
+
+struct NalUnit {
+    const uint8_t* data;  // first byte is the NAL header (start code excluded)
+    size_t size;
+    int type;
+};
+
+inline int nalType(uint8_t header, Codec codec) {
+    return codec == Codec::kHevc ? (header >> 1) & 0x3F : header & 0x1F;
+}
+
+// Position of the next start code at or after `from`, or `len` if none.
+// `startLen` receives 3 or 4.
+size_t findStartCode(const uint8_t* data, size_t len, size_t from, size_t* startLen);
+
+// Invoke fn(const NalUnit&) for every NAL unit; return false from fn to stop early.
+template <typename Fn>
+void forEachNal(const uint8_t* data, size_t len, Fn fn, Codec codec = Codec::kH264) {
+    size_t scLen = 0;
+    size_t pos = findStartCode(data, len, 0, &scLen);
+    while (pos < len) {
+        size_t hdr = pos + scLen;
+        size_t nextLen = 0;
+        size_t next = findStartCode(data, len, hdr, &nextLen);
+        if (hdr < next) {
+            NalUnit nal{data + hdr, next - hdr, nalType(data[hdr], codec)};
+            if (!fn(nal)) {
+                return;
+            }
+        }
+        pos = next;
+        scLen = nextLen;
+    }
+}
+
+bool hasStartCode(const uint8_t* data, size_t len);
+bool containsIdr(const uint8_t* data, size_t len, Codec codec = Codec::kH264);
+bool containsSlice(const uint8_t* data, size_t len, Codec codec = Codec::kH264);
+
+// True for VCL NAL units that start a new picture (H.264: first_mb_in_slice is 0,
+// HEVC: first_slice_segment_in_pic_flag is set).
+bool isFirstSliceOfPicture(const NalUnit& nal, Codec codec = Codec::kH264);
+
+// Copy SPS/PPS NAL units (without start codes) out of an access unit. For HEVC
+// the VPS is required too and copied into `vps`.
+bool extractParameterSets(const uint8_t* data, size_t len, std::vector<uint8_t>* sps, std::vector<uint8_t>* pps,
+                          Codec codec = Codec::kH264, std::vector<uint8_t>* vps = nullptr);
+
+// Cropped picture size coded in an SPS NAL unit (NAL header included).
+bool spsDimensions(const uint8_t* sps, size_t len, int* width, int* height, Codec codec = Codec::kH264);
+
+inline bool isVcl(int type, Codec codec = Codec::kH264) {
+    if (codec == Codec::kHevc) {
+        return type < 32;
+    }
+    return type == kNalSlice || type == kNalIdr;
+}
+
+inline bool isIdr(int type, Codec codec) {
+    if (codec == Codec::kHevc) {
+        return type == kHevcNalIdrWRadl || type == kHevcNalIdrNLp;
+    }
+    return type == kNalIdr;
+}
+
+inline bool isAud(int type, Codec codec) {
+    return codec == Codec::kHevc ? type == kHevcNalAud : type == kNalAud;
+}
+
+// Parameter sets and SEI that may only open an access unit once a picture has been seen.
+inline bool isAccessUnitPrefix(int type, Codec codec) {
+    if (codec == Codec::kHevc) {
+        return (type >= kHevcNalVps && type <= kHevcNalPps) || type == kHevcNalSeiPrefix;
+    }
+    return type == kNalSps || type == kNalPps || type == kNalSei;
+}
+
+// Invoke fn(begin, end) for every access unit of a raw elementary stream (start
+// codes included), without copying. Boundaries: AUD, or SPS/PPS/SEI/first slice
+// of a picture after a VCL NAL. Return false from fn to stop early.
+template <typename Fn>
+void forEachAccessUnit(const uint8_t* data, size_t len, Fn fn, Codec codec = Codec::kH264) {
+    const uint8_t* auStart = nullptr;
+    bool sawVcl = false;
+    bool stopped = false;
+    forEachNal(data, len, [&](const NalUnit& nal) {
+        // Include the start code (3 or 4 bytes) that precedes the header.
+        const uint8_t* begin = nal.data - 3;
+        if (begin > data && begin[-1] == 0) {
+            begin--;
+        }
+        bool boundary = false;
+        if (isAud(nal.type, codec)) {
+            boundary = true;
+        } else if (sawVcl && isAccessUnitPrefix(nal.type, codec)) {
+            boundary = true;
+        } else if (sawVcl && isFirstSliceOfPicture(nal, codec)) {
+            boundary = true;
+        }
+        if (boundary && auStart != nullptr) {
+            if (!fn(auStart, begin)) {
+                stopped = true;
+                return false;
+            }
+            auStart = nullptr;
+            sawVcl = false;
+        }
+        if (auStart == nullptr) {
+            auStart = begin;
+        }
+        sawVcl = sawVcl || isVcl(nal.type, codec);
+        return true;
+    }, codec);
+    if (!stopped && auStart != nullptr) {
+        fn(auStart, data + len);
+    }
+}
+
+// Split a raw elementary stream (e.g. a server .h264 / .h265 dump) into access units.
+std::vector<std::vector<uint8_t>> splitAccessUnits(const uint8_t* data, size_t len, Codec codec = Codec::kH264);
+
+}  // namespace annexb
+}  // namespace vrrenderer
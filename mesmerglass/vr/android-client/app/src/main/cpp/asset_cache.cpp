@@ -0,0 +1,79 @@
+/**
+ * Asset cache - LRU bookkeeping
+ *
+ * See asset_cache.h. Nothing here touches GL or JNI.
+ */
+
+#include "asset_cache.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace vrrenderer {
+
+const Asset* AssetCache::find(uint64_t id) {
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    ++hits_;
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return &it->second.asset;
+}
+
+bool AssetCache::put(uint64_t id, Asset&& asset) {
+    const size_t size = asset.bytes.size();
+    if (size > budget_) {
+        return false;
+    }
+    auto it = entries_.find(id);
+    if (it != entries_.end()) {
+        bytes_ -= it->second.asset.bytes.size();
+        lru_.erase(it->second.lru);
+        entries_.erase(it);
+    }
+    evictToFit(budget_ - size);
+    lru_.push_front(id);
+    Entry entry;
+    entry.asset = std::move(asset);
+    entry.lru = lru_.begin();
+    entries_.emplace(id, std::move(entry));
+    bytes_ += size;
+    return true;
+}
+
+void AssetCache::setBudget(size_t budgetBytes) {
+    budget_ = budgetBytes;
+    evictToFit(budget_);
+}
+
+void AssetCache::clear() {
+    entries_.clear();
+    lru_.clear();
+    bytes_ = 0;
+}
+
+std::vector<uint64_t> AssetCache::ids(size_t maxCount) const {
+    std::vector<uint64_t> out;
+    out.reserve(std::min(maxCount, lru_.size()));
+    for (uint64_t id : lru_) {
+        if (out.size() >= maxCount) {
+            break;
+        }
+        out.push_back(id);
+    }
+    return out;
+}
+
+void AssetCache::evictToFit(size_t budgetBytes) {
+    while (bytes_ > budgetBytes && !lru_.empty()) {
+        auto it = entries_.find(lru_.back());
+        bytes_ -= it->second.asset.bytes.size();
+        entries_.erase(it);
+        lru_.pop_back();
+        ++evictions_;
+    }
+}
+
+}  // namespace vrrenderer
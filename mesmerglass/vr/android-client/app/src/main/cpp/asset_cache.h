@@ -0,0 +1,78 @@
+/**
+ * Asset cache - content-addressed images kept on the headset
+ *
+ * Holds decoded frames (RGBA8 from JPEG) and inflated ETC2 blocks keyed by the
+ * server's 64-bit content hash (mesmerglass/mesmervisor/asset_cache.py), so a
+ * recurring frame costs a texture upload and nothing else: no bytes on the
+ * wire, no JPEG decode, no LZ4 inflate.
+ *
+ * Plain LRU under a byte budget. Not thread-safe; asset_jni.cpp serialises the
+ * network thread (put) and the GL thread (find/upload).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace vrrenderer {
+
+enum class AssetFormat : uint8_t {
+    kRgba8 = 0,       // width * height * 4 bytes, rows top to bottom
+    kEtc2Rgb8 = 1,    // etc2ImageSize(width, height) bytes of blocks
+};
+
+struct Asset {
+    AssetFormat format = AssetFormat::kRgba8;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> bytes;
+};
+
+class AssetCache {
+public:
+    explicit AssetCache(size_t budgetBytes) : budget_(budgetBytes) {}
+
+    // Marks the asset most recently used. Counts a hit or a miss.
+    const Asset* find(uint64_t id);
+    bool contains(uint64_t id) const { return entries_.count(id) != 0; }
+
+    // Replaces any asset with the same id, then evicts least recently used
+    // assets until the cache fits the budget. Returns false (and stores
+    // nothing) if the asset alone is larger than the budget.
+    bool put(uint64_t id, Asset&& asset);
+
+    void setBudget(size_t budgetBytes);
+    void clear();
+
+    // Most recently used first; what the headset reports as HAVE on connect.
+    std::vector<uint64_t> ids(size_t maxCount) const;
+
+    size_t bytes() const { return bytes_; }
+    size_t budget() const { return budget_; }
+    size_t count() const { return entries_.size(); }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+    uint64_t evictions() const { return evictions_; }
+
+private:
+    struct Entry {
+        Asset asset;
+        std::list<uint64_t>::iterator lru;
+    };
+
+    void evictToFit(size_t budgetBytes);
+
+    std::unordered_map<uint64_t, Entry> entries_;
+    std::list<uint64_t> lru_;  // front = most recently used
+    size_t budget_;
+    size_t bytes_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+};
+
+}  // namespace vrrenderer
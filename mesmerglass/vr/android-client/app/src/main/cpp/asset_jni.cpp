@@ -0,0 +1,166 @@
+/**
+ * JNI bridge for NativeAssetCache.kt - headset asset cache
+ *
+ * put* runs on the network thread as VRHC PUT packets arrive; upload runs on
+ * the GL thread when a SHOW names an asset. Decoded pixels are copied once
+ * into the cache here, so a cache hit is a single glTexImage2D (RGBA) or
+ * glCompressedTex(Sub)Image2D (ETC2) with no Java-side buffers involved.
+ */
+
+#if defined(__ANDROID__)
+
+#include "asset_cache.h"
+#include "texture_payload.h"
+#include "texture_upload.h"
+
+#include <jni.h>
+#include <android/bitmap.h>
+#include <android/log.h>
+#include <GLES3/gl3.h>
+
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#define LOG_TAG "VRAssets"
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+constexpr size_t kDefaultBudgetBytes = 128u * 1024u * 1024u;
+constexpr size_t kMaxReportedIds = 4096;  // HAVE carries a u16 count
+
+std::mutex gMutex;
+vrrenderer::AssetCache gCache(kDefaultBudgetBytes);
+
+bool store(uint64_t id, vrrenderer::Asset&& asset) {
+    std::lock_guard<std::mutex> lock(gMutex);
+    if (!gCache.put(id, std::move(asset))) {
+        LOGE("asset %016llx exceeds the %zu byte budget", static_cast<unsigned long long>(id), gCache.budget());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+extern "C" {
+
+JNIEXPORT jboolean JNICALL
+Java_com_hypnotic_vrreceiver_NativeAssetCache_nativePutBitmap(JNIEnv* env, jclass, jlong id, jobject bitmap) {
+    AndroidBitmapInfo info;
+    if (bitmap == nullptr || AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS ||
+        info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 || info.width == 0 || info.height == 0) {
+        return JNI_FALSE;
+    }
+    void* pixels = nullptr;
+    if (AndroidBitmap_lockPixels(env, bitmap, &pixels) != ANDROID_BITMAP_RESULT_SUCCESS || pixels == nullptr) {
+        return JNI_FALSE;
+    }
+    vrrenderer::Asset asset;
+    asset.format = vrrenderer::AssetFormat::kRgba8;
+    asset.width = static_cast<int>(info.width);
+    asset.height = static_cast<int>(info.height);
+    const size_t rowBytes = static_cast<size_t>(info.width) * 4;
+    asset.bytes.resize(rowBytes * info.height);
+    for (uint32_t y = 0; y < info.height; ++y) {
+        std::memcpy(asset.bytes.data() + y * rowBytes, static_cast<const uint8_t*>(pixels) + y * info.stride, rowBytes);
+    }
+    AndroidBitmap_unlockPixels(env, bitmap);
+    return store(static_cast<uint64_t>(id), std::move(asset)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_hypnotic_vrreceiver_NativeAssetCache_nativePutTexture(JNIEnv* env, jclass, jlong id, jbyteArray data,
+                                                               jint offset, jint length) {
+    if (data == nullptr || offset < 0 || length <= 0 || length > env->GetArrayLength(data) - offset) {
+        return JNI_FALSE;
+    }
+    // Copy out and parse without any lock: nativeUpload holds gMutex across GL
+    // work, and a critical region must not wait on that (or pin the array for GC).
+    thread_local std::vector<uint8_t> input;
+    thread_local std::vector<uint8_t> scratch;  // LZ4 inflate buffer
+    input.resize(static_cast<size_t>(length));
+    env->GetByteArrayRegion(data, offset, length, reinterpret_cast<jbyte*>(input.data()));
+    vrrenderer::TexturePayload payload;
+    if (!vrrenderer::parseTexturePayload(input.data(), input.size(), scratch, payload)) {
+        return JNI_FALSE;
+    }
+    vrrenderer::Asset asset;
+    asset.format = vrrenderer::AssetFormat::kEtc2Rgb8;
+    asset.width = payload.width;
+    asset.height = payload.height;
+    asset.bytes.assign(payload.blocks, payload.blocks + payload.blocksSize);
+    return store(static_cast<uint64_t>(id), std::move(asset)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_hypnotic_vrreceiver_NativeAssetCache_nativeContains(JNIEnv*, jclass, jlong id) {
+    std::lock_guard<std::mutex> lock(gMutex);
+    return gCache.contains(static_cast<uint64_t>(id)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_hypnotic_vrreceiver_NativeAssetCache_nativeUpload(JNIEnv*, jclass, jint textureId, jlong id) {
+    // Holding the lock across the upload keeps the asset alive; puts from the
+    // network thread wait for one texture upload at most.
+    std::lock_guard<std::mutex> lock(gMutex);
+    const vrrenderer::Asset* asset = gCache.find(static_cast<uint64_t>(id));
+    if (asset == nullptr) {
+        return 0;
+    }
+    const GLuint texture = static_cast<GLuint>(textureId);
+    const bool ok = asset->format == vrrenderer::AssetFormat::kEtc2Rgb8
+                        ? vrrenderer::uploadEtc2Texture(texture, asset->width, asset->height, asset->bytes.data(),
+                                                        asset->bytes.size())
+                        : vrrenderer::uploadRgbaTexture(texture, asset->width, asset->height, asset->bytes.data());
+    return ok ? ((asset->width << 16) | asset->height) : 0;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_hypnotic_vrreceiver_NativeAssetCache_nativeIds(JNIEnv* env, jclass) {
+    std::vector<uint64_t> ids;
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        ids = gCache.ids(kMaxReportedIds);
+    }
+    jlongArray out = env->NewLongArray(static_cast<jsize>(ids.size()));
+    if (out != nullptr && !ids.empty()) {
+        std::vector<jlong> values(ids.begin(), ids.end());
+        env->SetLongArrayRegion(out, 0, static_cast<jsize>(values.size()), values.data());
+    }
+    return out;
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeAssetCache_nativeStats(JNIEnv* env, jclass, jlongArray out) {
+    jlong values[5];
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        values[0] = static_cast<jlong>(gCache.count());
+        values[1] = static_cast<jlong>(gCache.bytes());
+        values[2] = static_cast<jlong>(gCache.hits());
+        values[3] = static_cast<jlong>(gCache.misses());
+        values[4] = static_cast<jlong>(gCache.evictions());
+    }
+    if (out != nullptr && env->GetArrayLength(out) >= 5) {
+        env->SetLongArrayRegion(out, 0, 5, values);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeAssetCache_nativeSetBudget(JNIEnv*, jclass, jlong budgetBytes) {
+    std::lock_guard<std::mutex> lock(gMutex);
+    gCache.setBudget(budgetBytes > 0 ? static_cast<size_t>(budgetBytes) : 0);
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeAssetCache_nativeClear(JNIEnv*, jclass) {
+    std::lock_guard<std::mutex> lock(gMutex);
+    gCache.clear();
+}
+
+}
+
+#endif  // __ANDROID__
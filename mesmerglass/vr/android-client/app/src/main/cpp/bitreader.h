@@ -0,0 +1,80 @@
+/**
+ * Exp-Golomb bit reader shared by the H.264 / HEVC parsers (annexb, h264_syntax, hevc_syntax)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vrrenderer {
+
+// MSB-first reader over an RBSP (emulation prevention bytes already removed).
+// Reading past the end sets a sticky error instead of faulting; check ok().
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t len) : data_(data), bits_(len * 8) {}
+
+    bool ok() const { return pos_ <= bits_; }
+    size_t position() const { return pos_; }
+
+    uint32_t bits(int n) {
+        uint32_t v = 0;
+        for (int i = 0; i < n; i++) {
+            v = (v << 1) | bit();
+        }
+        return v;
+    }
+
+    uint32_t ue() {
+        int zeros = 0;
+        while (bit() == 0) {
+            if (++zeros > 31 || pos_ > bits_) {
+                pos_ = bits_ + 1;
+                return 0;
+            }
+        }
+        return ((1u << zeros) - 1) + bits(zeros);
+    }
+
+    int32_t se() {
+        uint32_t k = ue();
+        return (k & 1) ? static_cast<int32_t>((k + 1) / 2) : -static_cast<int32_t>(k / 2);
+    }
+
+private:
+    uint32_t bit() {
+        if (pos_ >= bits_) {
+            pos_ = bits_ + 1;
+            return 0;
+        }
+        uint32_t b = (data_[pos_ >> 3] >> (7 - (pos_ & 7))) & 1;
+        pos_++;
+        return b;
+    }
+
+    const uint8_t* data_;
+    size_t bits_;
+    size_t pos_ = 0;
+};
+
+// Strip emulation prevention bytes (0x000003 -> 0x0000) from at most `limit` input bytes.
+inline std::vector<uint8_t> ebspToRbsp(const uint8_t* data, size_t len, size_t limit = SIZE_MAX) {
+    std::vector<uint8_t> out;
+    const size_t n = len < limit ? len : limit;
+    out.reserve(n);
+    int zeros = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t b = data[i];
+        if (zeros >= 2 && b == 0x03) {
+            zeros = 0;
+            continue;
+        }
+        out.push_back(b);
+        zeros = (b == 0) ? zeros + 1 : 0;
+    }
+    return out;
+}
+
+}  // namespace vrrenderer
@@ -0,0 +1,177 @@
+/**
+ * CRC32C (Castagnoli) - hardware accelerated with table fallback
+ *
+ * The receiver verifies every VRH4 eye payload before it reaches MediaCodec,
+ * so this runs on the network thread for every packet. At ~100 KB per access
+ * unit the hardware path costs well under 0.1 ms; the table path ~0.3 ms.
+ */
+
+#include "crc32c.h"
+
+#include <jni.h>
+#include <cstring>
+
+#if defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#endif
+
+namespace vrrenderer {
+namespace {
+
+constexpr uint32_t kPoly = 0x82F63B78u;  // reflected Castagnoli polynomial
+
+struct SlicingTable {
+    uint32_t t[8][256];
+
+    SlicingTable() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (c >> 1) ^ kPoly : (c >> 1);
+            }
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int s = 1; s < 8; s++) {
+                t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const SlicingTable& table() {
+    static const SlicingTable kTable;
+    return kTable;
+}
+
+uint32_t crc32cTable(uint32_t c, const uint8_t* p, size_t len) {
+    const SlicingTable& tb = table();
+    while (len >= 8) {
+        uint32_t lo;
+        uint32_t hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= c;
+        c = tb.t[7][lo & 0xFF] ^ tb.t[6][(lo >> 8) & 0xFF] ^ tb.t[5][(lo >> 16) & 0xFF] ^ tb.t[4][lo >> 24] ^
+            tb.t[3][hi & 0xFF] ^ tb.t[2][(hi >> 8) & 0xFF] ^ tb.t[1][(hi >> 16) & 0xFF] ^ tb.t[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) {
+        c = tb.t[0][(c ^ *p++) & 0xFF] ^ (c >> 8);
+    }
+    return c;
+}
+
+#if defined(__aarch64__)
+
+__attribute__((target("crc")))
+uint32_t crc32cHw(uint32_t c, const uint8_t* p, size_t len) {
+    while (len && (reinterpret_cast<uintptr_t>(p) & 7)) {
+        c = __crc32cb(c, *p++);
+        len--;
+    }
+    while (len >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        c = __crc32cd(c, v);
+        p += 8;
+        len -= 8;
+    }
+    while (len--) {
+        c = __crc32cb(c, *p++);
+    }
+    return c;
+}
+
+bool detectHw() {
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+}
+
+#elif defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse4.2")))
+uint32_t crc32cHw(uint32_t c, const uint8_t* p, size_t len) {
+#if defined(__x86_64__)
+    uint64_t c64 = c;
+    while (len >= 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        c64 = _mm_crc32_u64(c64, v);
+        p += 8;
+        len -= 8;
+    }
+    c = static_cast<uint32_t>(c64);
+#endif
+    while (len--) {
+        c = _mm_crc32_u8(c, *p++);
+    }
+    return c;
+}
+
+bool detectHw() {
+    return __builtin_cpu_supports("sse4.2") != 0;
+}
+
+#else
+
+uint32_t crc32cHw(uint32_t c, const uint8_t* p, size_t len) {
+    return crc32cTable(c, p, len);
+}
+
+bool detectHw() {
+    return false;
+}
+
+#endif
+
+}  // namespace
+
+bool crc32cHardware() {
+    static const bool kHw = detectHw();
+    return kHw;
+}
+
+uint32_t crc32c(const uint8_t* data, size_t len, uint32_t crc) {
+    uint32_t c = ~crc;
+    if (data && len) {
+        c = crc32cHardware() ? crc32cHw(c, data, len) : crc32cTable(c, data, len);
+    }
+    return ~c;
+}
+
+}  // namespace vrrenderer
+
+// JNI exports
+extern "C" {
+
+JNIEXPORT jint JNICALL
+Java_com_hypnotic_vrreceiver_NativeCrc_nativeCrc32c(JNIEnv* env, jclass, jbyteArray data, jint offset, jint length) {
+    if (data == nullptr || offset < 0 || length <= 0) {
+        return 0;
+    }
+    if (offset + length > env->GetArrayLength(data)) {
+        return 0;
+    }
+    // Critical access avoids copying multi-hundred-KB payloads; no JNI calls until release.
+    auto* bytes = static_cast<uint8_t*>(env->GetPrimitiveArrayCritical(data, nullptr));
+    if (bytes == nullptr) {
+        return 0;
+    }
+    uint32_t crc = vrrenderer::crc32c(bytes + offset, static_cast<size_t>(length));
+    env->ReleasePrimitiveArrayCritical(data, bytes, JNI_ABORT);
+    return static_cast<jint>(crc);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_hypnotic_vrreceiver_NativeCrc_nativeCrc32cHardware(JNIEnv*, jclass) {
+    return vrrenderer::crc32cHardware() ? JNI_TRUE : JNI_FALSE;
+}
+
+}
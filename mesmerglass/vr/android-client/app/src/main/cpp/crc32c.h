@@ -0,0 +1,21 @@
+/**
+ * CRC32C (Castagnoli) - VRH4 payload checksums
+ *
+ * Uses the ARMv8 CRC32 instructions when the CPU has them (Oculus Go / Quest),
+ * SSE4.2 on x86 hosts, and a slicing-by-8 table otherwise (ARMv7).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vrrenderer {
+
+// CRC32C of `data`, continuing from `crc` (0 for a fresh checksum).
+uint32_t crc32c(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+// True when crc32c() is using CPU CRC instructions.
+bool crc32cHardware();
+
+}  // namespace vrrenderer
@@ -0,0 +1,138 @@
+/**
+ * JNI bridge for NativeVideoDecoder.kt
+ *
+ * One handle per eye: a VideoDecoder driving a MediaCodecBackend bound to the
+ * eye's Surface. IDR requests are latched and polled from Kotlin, which owns
+ * the socket and already rate-limits NEED_IDR.
+ */
+
+#if defined(__ANDROID__)
+
+#include "video_decoder.h"
+
+#include <jni.h>
+#include <android/native_window.h>
+#include <android/native_window_jni.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct DecoderHandle {
+    std::unique_ptr<vrrenderer::VideoDecoder> decoder;
+    std::atomic<bool> idrWanted{false};
+};
+
+DecoderHandle* fromJava(jlong handle) {
+    return reinterpret_cast<DecoderHandle*>(handle);
+}
+
+}  // namespace
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_hypnotic_vrreceiver_NativeVideoDecoder_nativeCreate(JNIEnv* env, jclass, jobject surface,
+                                                             jint targetBufferMs, jint queueMaxFrames, jboolean hevc) {
+    ANativeWindow* window = surface ? ANativeWindow_fromSurface(env, surface) : nullptr;
+    if (window == nullptr) {
+        return 0;
+    }
+    vrrenderer::VideoDecoder::Options opts;
+    opts.targetBufferMs = targetBufferMs > 0 ? targetBufferMs : opts.targetBufferMs;
+    opts.queueMaxFrames = queueMaxFrames > 0 ? static_cast<size_t>(queueMaxFrames) : opts.queueMaxFrames;
+    opts.codec = hevc ? vrrenderer::annexb::Codec::kHevc : vrrenderer::annexb::Codec::kH264;
+
+    auto* handle = new DecoderHandle();
+    // The backend takes its own window reference.
+    handle->decoder.reset(new vrrenderer::VideoDecoder(vrrenderer::createMediaCodecBackend(window), opts));
+    ANativeWindow_release(window);
+    handle->decoder->setIdrRequestCallback([handle](const char*) { handle->idrWanted = true; });
+    handle->decoder->start();
+    return reinterpret_cast<jlong>(handle);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_hypnotic_vrreceiver_NativeVideoDecoder_nativeSubmit(JNIEnv* env, jclass, jlong handle, jbyteArray data,
+                                                             jint offset, jint length, jlong ptsUs) {
+    DecoderHandle* h = fromJava(handle);
+    if (h == nullptr || data == nullptr || offset < 0 || length <= 0 ||
+        length > env->GetArrayLength(data) - offset) {
+        return JNI_FALSE;
+    }
+    // submit() takes the queue mutex, which must not happen inside a critical region.
+    thread_local std::vector<uint8_t> unit;
+    unit.resize(static_cast<size_t>(length));
+    env->GetByteArrayRegion(data, offset, length, reinterpret_cast<jbyte*>(unit.data()));
+    const bool ok = h->decoder->submit(unit.data(), unit.size(), ptsUs);
+    return ok ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeVideoDecoder_nativeRequestResync(JNIEnv* env, jclass, jlong handle,
+                                                                    jstring reason) {
+    DecoderHandle* h = fromJava(handle);
+    if (h == nullptr) {
+        return;
+    }
+    std::string why = "external";
+    if (reason != nullptr) {
+        const char* chars = env->GetStringUTFChars(reason, nullptr);
+        if (chars != nullptr) {
+            why = chars;
+            env->ReleaseStringUTFChars(reason, chars);
+        }
+    }
+    h->decoder->requestResync(why.c_str());
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_hypnotic_vrreceiver_NativeVideoDecoder_nativeTakeIdrRequest(JNIEnv*, jclass, jlong handle) {
+    DecoderHandle* h = fromJava(handle);
+    return (h != nullptr && h->idrWanted.exchange(false)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_hypnotic_vrreceiver_NativeVideoDecoder_nativeStats(JNIEnv* env, jclass, jlong handle) {
+    DecoderHandle* h = fromJava(handle);
+    if (h == nullptr) {
+        return nullptr;
+    }
+    const vrrenderer::DecoderStats s = h->decoder->stats();
+    // Order must match NativeVideoDecoder.Stats.
+    const jlong values[] = {
+        static_cast<jlong>(s.submitted),
+        static_cast<jlong>(s.queued),
+        static_cast<jlong>(s.decoded),
+        static_cast<jlong>(s.dropped),
+        static_cast<jlong>(s.late),
+        static_cast<jlong>(s.resyncs),
+        static_cast<jlong>(s.flushes),
+        static_cast<jlong>(s.lastLatencyUs),
+        static_cast<jlong>(s.maxLatencyUs),
+        static_cast<jlong>(s.playoutBufferMs),
+        static_cast<jlong>(s.queueDepth),
+    };
+    const jsize count = static_cast<jsize>(sizeof(values) / sizeof(values[0]));
+    jlongArray out = env->NewLongArray(count);
+    if (out != nullptr) {
+        env->SetLongArrayRegion(out, 0, count, values);
+    }
+    return out;
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeVideoDecoder_nativeDestroy(JNIEnv*, jclass, jlong handle) {
+    DecoderHandle* h = fromJava(handle);
+    if (h == nullptr) {
+        return;
+    }
+    h->decoder->stop();
+    delete h;
+}
+
+}
+
+#endif  // __ANDROID__
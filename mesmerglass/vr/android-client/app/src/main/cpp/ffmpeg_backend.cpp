@@ -0,0 +1,123 @@
+/**
+ * FFmpeg Backend - libavcodec software H.264 / HEVC decode for host builds
+ *
+ * Slice threading only: frame threading would add one frame of latency per
+ * thread, which the low-latency stream (no B-frames) can't afford. Pictures
+ * stay owned by libavcodec; DecodedFrame::luma points into the current frame
+ * until releaseOutput().
+ */
+
+#if defined(VRRENDERER_WITH_FFMPEG)
+
+#include "video_decoder.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/frame.h>
+}
+
+#include <cstdio>
+#include <cstring>
+
+namespace vrrenderer {
+namespace {
+
+class FFmpegBackend : public DecoderBackend {
+public:
+    FFmpegBackend(int threads, bool keepLuma) : threads_(threads), keepLuma_(keepLuma) {}
+
+    ~FFmpegBackend() override { stop(); }
+
+    const char* name() const override { return "ffmpeg"; }
+
+    bool configure(const CodecConfig& config) override {
+        // Parameter sets travel in-band with every IDR, so a fresh context is all
+        // a parameter change needs.
+        stop();
+        const bool hevc = config.codec == annexb::Codec::kHevc;
+        const AVCodec* codec = avcodec_find_decoder(hevc ? AV_CODEC_ID_HEVC : AV_CODEC_ID_H264);
+        if (codec == nullptr) {
+            std::fprintf(stderr, "[FFmpegBackend] %s decoder not available\n", hevc ? "HEVC" : "H.264");
+            return false;
+        }
+        ctx_ = avcodec_alloc_context3(codec);
+        if (ctx_ == nullptr) {
+            return false;
+        }
+        ctx_->thread_count = threads_;
+        ctx_->thread_type = FF_THREAD_SLICE;
+        ctx_->flags |= AV_CODEC_FLAG_LOW_DELAY;
+        if (avcodec_open2(ctx_, codec, nullptr) < 0) {
+            avcodec_free_context(&ctx_);
+            return false;
+        }
+        packet_ = av_packet_alloc();
+        frame_ = av_frame_alloc();
+        return packet_ != nullptr && frame_ != nullptr;
+    }
+
+    InputStatus queueInput(const uint8_t* data, size_t size, int64_t ptsUs, int64_t) override {
+        if (ctx_ == nullptr) {
+            return InputStatus::kError;
+        }
+        av_packet_unref(packet_);
+        if (av_new_packet(packet_, static_cast<int>(size)) < 0) {
+            return InputStatus::kError;
+        }
+        std::memcpy(packet_->data, data, size);
+        packet_->pts = ptsUs;
+        const int rc = avcodec_send_packet(ctx_, packet_);
+        if (rc == AVERROR(EAGAIN)) {
+            return InputStatus::kTryAgain;
+        }
+        // Damaged slices are concealed by libavcodec; only hard errors resync.
+        return (rc < 0 && rc != AVERROR_INVALIDDATA) ? InputStatus::kError : InputStatus::kQueued;
+    }
+
+    bool dequeueOutput(DecodedFrame* frame, int64_t) override {
+        if (ctx_ == nullptr) {
+            return false;
+        }
+        if (avcodec_receive_frame(ctx_, frame_) < 0) {
+            return false;
+        }
+        frame->ptsUs = frame_->best_effort_timestamp;
+        frame->width = frame_->width;
+        frame->height = frame_->height;
+        frame->bufferIndex = 0;
+        frame->luma = keepLuma_ ? frame_->data[0] : nullptr;
+        frame->lumaStride = keepLuma_ ? frame_->linesize[0] : 0;
+        return true;
+    }
+
+    void releaseOutput(const DecodedFrame&, int64_t) override { av_frame_unref(frame_); }
+
+    void flush() override {
+        if (ctx_ != nullptr) {
+            avcodec_flush_buffers(ctx_);
+        }
+    }
+
+    void stop() override {
+        av_frame_free(&frame_);
+        av_packet_free(&packet_);
+        avcodec_free_context(&ctx_);
+    }
+
+private:
+    int threads_;
+    bool keepLuma_;
+    AVCodecContext* ctx_ = nullptr;
+    AVPacket* packet_ = nullptr;
+    AVFrame* frame_ = nullptr;
+};
+
+}  // namespace
+
+std::unique_ptr<DecoderBackend> createFFmpegBackend(int threads, bool keepLuma) {
+    return std::unique_ptr<DecoderBackend>(new FFmpegBackend(threads, keepLuma));
+}
+
+}  // namespace vrrenderer
+
+#endif  // VRRENDERER_WITH_FFMPEG
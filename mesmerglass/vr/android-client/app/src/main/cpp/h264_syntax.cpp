@@ -0,0 +1,358 @@
+/**
+ * H.264 parameter set and slice header parsing
+ */
+
+#include "h264_syntax.h"
+
+#include "bitreader.h"
+
+namespace vrrenderer {
+namespace h264 {
+namespace {
+
+// Slice headers never need more than this many payload bytes, so avoid
+// unescaping whole slices.
+constexpr size_t kHeaderBytes = 512;
+
+void skipScalingList(BitReader& br, int size) {
+    int last = 8;
+    int next = 8;
+    for (int i = 0; i < size; i++) {
+        if (next != 0) {
+            next = (last + br.se() + 256) % 256;
+        }
+        last = (next == 0) ? last : next;
+    }
+}
+
+bool highProfile(int profile) {
+    switch (profile) {
+        case 100: case 110: case 122: case 244: case 44: case 83: case 86:
+        case 118: case 128: case 138: case 139: case 134: case 135:
+            return true;
+        default:
+            return false;
+    }
+}
+
+int ceilLog2(uint32_t v) {
+    int n = 0;
+    while ((1u << n) < v) {
+        n++;
+    }
+    return n;
+}
+
+void skipRefPicListModification(BitReader& br) {
+    if (!br.bits(1)) {
+        return;
+    }
+    for (int i = 0; i < 64 && br.ok(); i++) {
+        uint32_t idc = br.ue();
+        if (idc == 3) {
+            return;
+        }
+        br.ue();  // abs_diff_pic_num_minus1 or long_term_pic_num
+    }
+}
+
+void skipPredWeightTable(BitReader& br, int chromaArrayType, int numL0, int numL1, bool bSlice) {
+    br.ue();  // luma_log2_weight_denom
+    if (chromaArrayType != 0) {
+        br.ue();  // chroma_log2_weight_denom
+    }
+    for (int list = 0; list < (bSlice ? 2 : 1); list++) {
+        const int count = list == 0 ? numL0 : numL1;
+        for (int i = 0; i < count && br.ok(); i++) {
+            if (br.bits(1)) {
+                br.se();
+                br.se();
+            }
+            if (chromaArrayType != 0 && br.bits(1)) {
+                for (int c = 0; c < 2; c++) {
+                    br.se();
+                    br.se();
+                }
+            }
+        }
+    }
+}
+
+void skipDecRefPicMarking(BitReader& br, bool idr) {
+    if (idr) {
+        br.bits(2);  // no_output_of_prior_pics_flag, long_term_reference_flag
+        return;
+    }
+    if (!br.bits(1)) {
+        return;
+    }
+    for (int i = 0; i < 64 && br.ok(); i++) {
+        uint32_t op = br.ue();
+        if (op == 0) {
+            return;
+        }
+        if (op == 1 || op == 3) {
+            br.ue();  // difference_of_pic_nums_minus1
+        }
+        if (op == 2) {
+            br.ue();  // long_term_pic_num
+        }
+        if (op == 3 || op == 6) {
+            br.ue();  // long_term_frame_idx
+        }
+        if (op == 4) {
+            br.ue();  // max_long_term_frame_idx_plus1
+        }
+    }
+}
+
+}  // namespace
+
+bool parseSps(const uint8_t* nal, size_t len, Sps* out) {
+    if (len < 4 || (nal[0] & 0x1F) != 7) {
+        return false;
+    }
+    std::vector<uint8_t> rbsp = ebspToRbsp(nal + 1, len - 1, kHeaderBytes);
+    BitReader br(rbsp.data(), rbsp.size());
+    Sps s;
+
+    s.profile = static_cast<int>(br.bits(8));
+    br.bits(8);  // constraint flags
+    s.level = static_cast<int>(br.bits(8));
+    s.id = static_cast<int>(br.ue());
+
+    if (highProfile(s.profile)) {
+        s.chromaFormat = static_cast<int>(br.ue());
+        if (s.chromaFormat == 3) {
+            s.separateColourPlane = br.bits(1) != 0;
+        }
+        br.ue();     // bit_depth_luma_minus8
+        br.ue();     // bit_depth_chroma_minus8
+        br.bits(1);  // qpprime_y_zero_transform_bypass_flag
+        if (br.bits(1)) {
+            int lists = (s.chromaFormat != 3) ? 8 : 12;
+            for (int i = 0; i < lists; i++) {
+                if (br.bits(1)) {
+                    skipScalingList(br, i < 6 ? 16 : 64);
+                }
+            }
+        }
+    }
+
+    s.log2MaxFrameNum = static_cast<int>(br.ue()) + 4;
+    s.pocType = static_cast<int>(br.ue());
+    if (s.pocType == 0) {
+        s.log2MaxPocLsb = static_cast<int>(br.ue()) + 4;
+    } else if (s.pocType == 1) {
+        s.deltaPicOrderAlwaysZero = br.bits(1) != 0;
+        br.se();
+        br.se();
+        uint32_t cycle = br.ue();
+        for (uint32_t i = 0; i < cycle && br.ok(); i++) {
+            br.se();
+        }
+    }
+    s.maxRefFrames = static_cast<int>(br.ue());
+    br.bits(1);  // gaps_in_frame_num_allowed_flag
+    uint32_t mbW = br.ue() + 1;
+    uint32_t mapH = br.ue() + 1;
+    s.frameMbsOnly = br.bits(1) != 0;
+    if (!s.frameMbsOnly) {
+        br.bits(1);  // mb_adaptive_frame_field_flag
+    }
+    br.bits(1);  // direct_8x8_inference_flag
+
+    uint32_t cropL = 0, cropR = 0, cropT = 0, cropB = 0;
+    if (br.bits(1)) {
+        cropL = br.ue();
+        cropR = br.ue();
+        cropT = br.ue();
+        cropB = br.ue();
+    }
+    if (!br.ok() || s.log2MaxFrameNum > 16 || s.log2MaxPocLsb > 16) {
+        return false;
+    }
+
+    const uint32_t frameMbs = s.frameMbsOnly ? 1 : 0;
+    const uint32_t cropX = (s.chromaFormat == 1 || s.chromaFormat == 2) ? 2 : 1;
+    const uint32_t cropY = ((s.chromaFormat == 1) ? 2 : 1) * (2 - frameMbs);
+    s.width = static_cast<int>(mbW * 16 - (cropL + cropR) * cropX);
+    s.height = static_cast<int>(mapH * 16 * (2 - frameMbs) - (cropT + cropB) * cropY);
+    if (s.width <= 0 || s.height <= 0) {
+        return false;
+    }
+    *out = s;
+    return true;
+}
+
+bool parsePps(const uint8_t* nal, size_t len, Pps* out) {
+    if (len < 2 || (nal[0] & 0x1F) != 8) {
+        return false;
+    }
+    std::vector<uint8_t> rbsp = ebspToRbsp(nal + 1, len - 1, kHeaderBytes);
+    BitReader br(rbsp.data(), rbsp.size());
+    Pps p;
+
+    p.id = static_cast<int>(br.ue());
+    p.spsId = static_cast<int>(br.ue());
+    p.cabac = br.bits(1) != 0;
+    p.bottomFieldPicOrderPresent = br.bits(1) != 0;
+    uint32_t sliceGroups = br.ue() + 1;
+    if (sliceGroups > 1) {
+        uint32_t mapType = br.ue();
+        if (mapType == 0) {
+            for (uint32_t i = 0; i < sliceGroups; i++) {
+                br.ue();  // run_length_minus1
+            }
+        } else if (mapType == 2) {
+            for (uint32_t i = 0; i + 1 < sliceGroups; i++) {
+                br.ue();  // top_left
+                br.ue();  // bottom_right
+            }
+        } else if (mapType >= 3 && mapType <= 5) {
+            br.bits(1);  // slice_group_change_direction_flag
+            br.ue();     // slice_group_change_rate_minus1
+        } else if (mapType == 6) {
+            uint32_t units = br.ue() + 1;
+            int idBits = ceilLog2(sliceGroups);
+            for (uint32_t i = 0; i < units && br.ok(); i++) {
+                br.bits(idBits);
+            }
+        }
+    }
+    p.numRefIdxL0 = static_cast<int>(br.ue()) + 1;
+    p.numRefIdxL1 = static_cast<int>(br.ue()) + 1;
+    p.weightedPred = br.bits(1) != 0;
+    p.weightedBipredIdc = static_cast<int>(br.bits(2));
+    p.picInitQp = 26 + br.se();
+    br.se();     // pic_init_qs_minus26
+    br.se();     // chroma_qp_index_offset
+    br.bits(1);  // deblocking_filter_control_present_flag
+    br.bits(1);  // constrained_intra_pred_flag
+    p.redundantPicCntPresent = br.bits(1) != 0;
+    if (!br.ok()) {
+        return false;
+    }
+    *out = p;
+    return true;
+}
+
+bool parseSliceHeaderPrefix(const uint8_t* nal, size_t len, SliceHeader* out) {
+    if (len < 2) {
+        return false;
+    }
+    std::vector<uint8_t> rbsp = ebspToRbsp(nal + 1, len - 1, 16);
+    BitReader br(rbsp.data(), rbsp.size());
+    SliceHeader h;
+    h.firstMb = static_cast<int>(br.ue());
+    h.sliceType = static_cast<int>(br.ue() % 5);
+    h.ppsId = static_cast<int>(br.ue());
+    if (!br.ok()) {
+        return false;
+    }
+    *out = h;
+    return true;
+}
+
+bool parseSliceHeader(const uint8_t* nal, size_t len, const Sps& sps, const Pps& pps, SliceHeader* out) {
+    if (len < 2) {
+        return false;
+    }
+    const int nalType = nal[0] & 0x1F;
+    const int nalRefIdc = (nal[0] >> 5) & 0x3;
+    const bool idr = nalType == 5;
+    std::vector<uint8_t> rbsp = ebspToRbsp(nal + 1, len - 1, kHeaderBytes);
+    BitReader br(rbsp.data(), rbsp.size());
+    SliceHeader h;
+
+    h.firstMb = static_cast<int>(br.ue());
+    h.sliceType = static_cast<int>(br.ue() % 5);
+    h.ppsId = static_cast<int>(br.ue());
+    if (!br.ok()) {
+        return false;
+    }
+    *out = h;
+    if (h.ppsId != pps.id || pps.spsId != sps.id) {
+        return true;  // prefix only; caller passed mismatched parameter sets
+    }
+
+    const bool bSlice = h.sliceType == kSliceB;
+    const bool pSlice = h.sliceType == kSliceP || h.sliceType == kSliceSP;
+    if (sps.separateColourPlane) {
+        br.bits(2);  // colour_plane_id
+    }
+    h.frameNum = static_cast<int>(br.bits(sps.log2MaxFrameNum));
+    bool field = false;
+    if (!sps.frameMbsOnly) {
+        field = br.bits(1) != 0;
+        if (field) {
+            br.bits(1);  // bottom_field_flag
+        }
+    }
+    if (idr) {
+        br.ue();  // idr_pic_id
+    }
+    if (sps.pocType == 0) {
+        br.bits(sps.log2MaxPocLsb);
+        if (pps.bottomFieldPicOrderPresent && !field) {
+            br.se();
+        }
+    } else if (sps.pocType == 1 && !sps.deltaPicOrderAlwaysZero) {
+        br.se();
+        if (pps.bottomFieldPicOrderPresent && !field) {
+            br.se();
+        }
+    }
+    if (pps.redundantPicCntPresent) {
+        br.ue();
+    }
+    if (bSlice) {
+        br.bits(1);  // direct_spatial_mv_pred_flag
+    }
+    int numL0 = pps.numRefIdxL0;
+    int numL1 = pps.numRefIdxL1;
+    if (pSlice || bSlice) {
+        if (br.bits(1)) {  // num_ref_idx_active_override_flag
+            numL0 = static_cast<int>(br.ue()) + 1;
+            if (bSlice) {
+                numL1 = static_cast<int>(br.ue()) + 1;
+            }
+        }
+    }
+    if (h.sliceType != kSliceI && h.sliceType != kSliceSI) {
+        skipRefPicListModification(br);
+        if (bSlice) {
+            skipRefPicListModification(br);
+        }
+    }
+    if ((pps.weightedPred && pSlice) || (pps.weightedBipredIdc == 1 && bSlice)) {
+        skipPredWeightTable(br, sps.separateColourPlane ? 0 : sps.chromaFormat, numL0, numL1, bSlice);
+    }
+    if (nalRefIdc != 0) {
+        skipDecRefPicMarking(br, idr);
+    }
+    if (pps.cabac && h.sliceType != kSliceI && h.sliceType != kSliceSI) {
+        br.ue();  // cabac_init_idc
+    }
+    const int qp = pps.picInitQp + br.se();
+    if (br.ok() && qp >= -12 && qp <= 51) {
+        h.qp = qp;
+    }
+    out->frameNum = h.frameNum;
+    out->qp = h.qp;
+    return true;
+}
+
+char sliceTypeChar(int sliceType) {
+    switch (sliceType) {
+        case kSliceP: return 'P';
+        case kSliceB: return 'B';
+        case kSliceI: return 'I';
+        case kSliceSP: return 'p';
+        case kSliceSI: return 'i';
+        default: return '?';
+    }
+}
+
+}  // namespace h264
+}  // namespace vrrenderer
@@ -0,0 +1,70 @@
+/**
+ * H.264 parameter set and slice header parsing
+ *
+ * Enough of the syntax to recover per-slice type, frame_num and QP from a
+ * recorded stream (vranalyze) and picture size for decoder setup. Only the
+ * progressive/interlaced profiles NVENC and x264 emit are covered (no MVC/SVC).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vrrenderer {
+namespace h264 {
+
+enum SliceType : int { kSliceP = 0, kSliceB = 1, kSliceI = 2, kSliceSP = 3, kSliceSI = 4 };
+
+struct Sps {
+    int id = -1;
+    int profile = 0;
+    int level = 0;
+    int chromaFormat = 1;
+    bool separateColourPlane = false;
+    int log2MaxFrameNum = 4;
+    int pocType = 0;
+    int log2MaxPocLsb = 4;
+    bool deltaPicOrderAlwaysZero = false;
+    int maxRefFrames = 0;
+    bool frameMbsOnly = true;
+    int width = 0;   // cropped
+    int height = 0;  // cropped
+};
+
+struct Pps {
+    int id = -1;
+    int spsId = -1;
+    bool cabac = false;
+    bool bottomFieldPicOrderPresent = false;
+    int numRefIdxL0 = 1;
+    int numRefIdxL1 = 1;
+    bool weightedPred = false;
+    int weightedBipredIdc = 0;
+    int picInitQp = 26;
+    bool redundantPicCntPresent = false;
+};
+
+struct SliceHeader {
+    int firstMb = 0;
+    int sliceType = kSliceP;  // 0..4 (slice_type % 5)
+    int ppsId = 0;
+    int frameNum = 0;
+    int qp = -1;  // -1 when the header could not be parsed up to slice_qp_delta
+};
+
+// NAL units include the one-byte NAL header and exclude the start code.
+bool parseSps(const uint8_t* nal, size_t len, Sps* out);
+bool parsePps(const uint8_t* nal, size_t len, Pps* out);
+
+// Needs the PPS referenced by the slice and its SPS; returns false if the
+// leading fields could not be read. `out->qp` stays -1 if parsing stopped early.
+bool parseSliceHeader(const uint8_t* nal, size_t len, const Sps& sps, const Pps& pps, SliceHeader* out);
+
+// Reads first_mb_in_slice / slice_type / pic_parameter_set_id only (no parameter sets needed).
+bool parseSliceHeaderPrefix(const uint8_t* nal, size_t len, SliceHeader* out);
+
+char sliceTypeChar(int sliceType);
+
+}  // namespace h264
+}  // namespace vrrenderer
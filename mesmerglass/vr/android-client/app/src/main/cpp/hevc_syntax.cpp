@@ -0,0 +1,91 @@
+/**
+ * HEVC parameter set parsing
+ */
+
+#include "hevc_syntax.h"
+
+#include "bitreader.h"
+
+namespace vrrenderer {
+namespace hevc {
+namespace {
+
+constexpr size_t kHeaderBytes = 512;
+
+void skipProfileTierLevel(BitReader& br, int maxSubLayersMinus1, Sps* s) {
+    br.bits(2);  // general_profile_space
+    br.bits(1);  // general_tier_flag
+    s->profile = static_cast<int>(br.bits(5));
+    br.bits(32);  // general_profile_compatibility_flags
+    br.bits(16);  // progressive/interlaced/constraint flags (48 bits)
+    br.bits(16);
+    br.bits(16);
+    s->level = static_cast<int>(br.bits(8));
+    bool profilePresent[8] = {};
+    bool levelPresent[8] = {};
+    for (int i = 0; i < maxSubLayersMinus1; i++) {
+        profilePresent[i] = br.bits(1) != 0;
+        levelPresent[i] = br.bits(1) != 0;
+    }
+    if (maxSubLayersMinus1 > 0) {
+        for (int i = maxSubLayersMinus1; i < 8; i++) {
+            br.bits(2);  // reserved_zero_2bits
+        }
+    }
+    for (int i = 0; i < maxSubLayersMinus1; i++) {
+        if (profilePresent[i]) {
+            br.bits(32);  // sub_layer profile: 88 bits
+            br.bits(32);
+            br.bits(24);
+        }
+        if (levelPresent[i]) {
+            br.bits(8);
+        }
+    }
+}
+
+}  // namespace
+
+bool parseSps(const uint8_t* nal, size_t len, Sps* out) {
+    if (len < 4 || ((nal[0] >> 1) & 0x3F) != 33) {
+        return false;
+    }
+    std::vector<uint8_t> rbsp = ebspToRbsp(nal + 2, len - 2, kHeaderBytes);
+    BitReader br(rbsp.data(), rbsp.size());
+    Sps s;
+
+    br.bits(4);  // sps_video_parameter_set_id
+    const int maxSubLayersMinus1 = static_cast<int>(br.bits(3));
+    br.bits(1);  // sps_temporal_id_nesting_flag
+    skipProfileTierLevel(br, maxSubLayersMinus1, &s);
+    s.id = static_cast<int>(br.ue());
+    s.chromaFormat = static_cast<int>(br.ue());
+    if (s.chromaFormat == 3) {
+        br.bits(1);  // separate_colour_plane_flag
+    }
+    const uint32_t width = br.ue();
+    const uint32_t height = br.ue();
+    uint32_t winL = 0, winR = 0, winT = 0, winB = 0;
+    if (br.bits(1)) {  // conformance_window_flag
+        winL = br.ue();
+        winR = br.ue();
+        winT = br.ue();
+        winB = br.ue();
+    }
+    if (!br.ok() || s.chromaFormat > 3) {
+        return false;
+    }
+
+    const uint32_t subW = (s.chromaFormat == 1 || s.chromaFormat == 2) ? 2 : 1;
+    const uint32_t subH = (s.chromaFormat == 1) ? 2 : 1;
+    s.width = static_cast<int>(width) - static_cast<int>((winL + winR) * subW);
+    s.height = static_cast<int>(height) - static_cast<int>((winT + winB) * subH);
+    if (s.width <= 0 || s.height <= 0) {
+        return false;
+    }
+    *out = s;
+    return true;
+}
+
+}  // namespace hevc
+}  // namespace vrrenderer
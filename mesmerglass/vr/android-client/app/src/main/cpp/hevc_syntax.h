@@ -0,0 +1,30 @@
+/**
+ * HEVC parameter set parsing
+ *
+ * Only what decoder setup needs: the SPS picture size (conformance window
+ * applied) and profile/level for logging. x265 and NVENC emit single-layer
+ * Main / Main10 streams, so multi-layer extensions are not covered.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vrrenderer {
+namespace hevc {
+
+struct Sps {
+    int id = -1;
+    int profile = 0;
+    int level = 0;  // general_level_idc (30 x level number)
+    int chromaFormat = 1;
+    int width = 0;   // conformance window applied
+    int height = 0;
+};
+
+// NAL units include the two-byte NAL header and exclude the start code.
+bool parseSps(const uint8_t* nal, size_t len, Sps* out);
+
+}  // namespace hevc
+}  // namespace vrrenderer
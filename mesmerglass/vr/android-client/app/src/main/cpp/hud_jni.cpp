@@ -0,0 +1,336 @@
+/**
+ * JNI bridge for NativeHud.kt - in-headset performance overlay
+ *
+ * Everything runs on the GL thread. The overlay for both eyes is a single
+ * glDrawArrays: text and panels sample the font atlas, graph quads read the
+ * per-stage ring texture (see perf_hud.h). Steady-state cost per frame is one
+ * 1x5 texel upload plus the draw; the vertex buffer is only re-uploaded when
+ * PerfHud re-lays out its text.
+ */
+
+#if defined(__ANDROID__)
+
+#include "perf_hud.h"
+
+#include <jni.h>
+#include <android/log.h>
+#include <GLES3/gl3.h>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#define LOG_TAG "VRHud"
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+const char* kHudVertexShader = R"(#version 300 es
+layout(location = 0) in vec2 aPosition;
+layout(location = 1) in vec2 aTexCoord;
+layout(location = 2) in vec4 aColor;
+layout(location = 3) in float aMode;
+out vec2 vTexCoord;
+out vec4 vColor;
+flat out int vMode;
+void main() {
+    gl_Position = vec4(aPosition, 0.0, 1.0);
+    vTexCoord = aTexCoord;
+    vColor = aColor;
+    vMode = int(aMode + 0.5);
+}
+)";
+
+// Colors are premultiplied; blending is ONE, ONE_MINUS_SRC_ALPHA.
+const char* kHudFragmentShader = R"(#version 300 es
+precision mediump float;
+uniform sampler2D uFont;
+uniform sampler2D uGraph;
+uniform int uHead;
+uniform float uBudget;
+in vec2 vTexCoord;
+in vec4 vColor;
+flat in int vMode;
+out vec4 fragColor;
+void main() {
+    if (vMode == 0) {
+        fragColor = vColor * texture(uFont, vTexCoord).r;
+        return;
+    }
+    // Oldest sample on the left, newest (uHead) at the right edge.
+    int samples = textureSize(uGraph, 0).x;
+    int column = (uHead + 1 + int(vTexCoord.x * float(samples))) % samples;
+    float value = texelFetch(uGraph, ivec2(column, vMode - 1), 0).r;
+    if (abs(vTexCoord.y - uBudget) < 0.04) {
+        fragColor = vec4(0.5, 0.5, 0.5, 0.5);
+    } else if (vTexCoord.y <= value) {
+        fragColor = value > uBudget ? vec4(1.0, 0.25, 0.2, 1.0) : vColor;
+    } else {
+        fragColor = vec4(0.0, 0.0, 0.0, 0.25);
+    }
+}
+)";
+
+struct HudGl {
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint fontTexture = 0;
+    GLuint graphTexture = 0;
+    GLint headUniform = -1;
+    GLsizei vertexCount = 0;
+    uint64_t uploadedSamples = 0;
+    bool failed = false;  // don't retry a broken setup every frame
+};
+
+// Only touched from the GL thread.
+vrrenderer::PerfHud gHud;
+HudGl gGl;
+
+GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (ok != GL_TRUE) {
+        char log[512];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        LOGE("HUD shader compile failed: %s", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GLuint createTexture(GLsizei width, GLsizei height, const void* pixels) {
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels);
+    return texture;
+}
+
+bool ensureGl() {
+    if (gGl.program != 0) {
+        return true;
+    }
+    if (gGl.failed) {
+        return false;
+    }
+    gGl.failed = true;
+
+    GLuint vs = compileShader(GL_VERTEX_SHADER, kHudVertexShader);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, kHudFragmentShader);
+    if (vs == 0 || fs == 0) {
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        return false;
+    }
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        LOGE("HUD program link failed");
+        glDeleteProgram(program);
+        return false;
+    }
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "uFont"), 0);
+    glUniform1i(glGetUniformLocation(program, "uGraph"), 1);
+    glUniform1f(glGetUniformLocation(program, "uBudget"), vrrenderer::PerfHud::budgetFraction());
+    gGl.headUniform = glGetUniformLocation(program, "uHead");
+
+    GLint unpack = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    std::vector<uint8_t> atlas;
+    vrrenderer::PerfHud::buildFontAtlas(atlas);
+    gGl.fontTexture = createTexture(vrrenderer::kHudAtlasWidth, vrrenderer::kHudAtlasHeight, atlas.data());
+    gGl.graphTexture = createTexture(vrrenderer::kHudGraphSamples, vrrenderer::kHudStageCount, gHud.graphPixels());
+    gGl.uploadedSamples = gHud.sampleCount();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, unpack);
+
+    using vrrenderer::HudVertex;
+    glGenVertexArrays(1, &gGl.vao);
+    glGenBuffers(1, &gGl.vbo);
+    glBindVertexArray(gGl.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, gGl.vbo);
+    const GLsizei stride = sizeof(HudVertex);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(HudVertex, x)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(HudVertex, u)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, reinterpret_cast<void*>(offsetof(HudVertex, rgba)));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(HudVertex, mode)));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    const GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        LOGE("HUD setup failed: 0x%x", err);
+    }
+    gGl.program = program;
+    gGl.failed = false;
+    return true;
+}
+
+// Renderer state the HUD draw touches; restored afterwards so the Kotlin renderer's blend
+// function, texture units and bindings are exactly as it left them.
+struct SavedGlState {
+    GLint program = 0;
+    GLint vao = 0;
+    GLint arrayBuffer = 0;
+    GLint activeTexture = GL_TEXTURE0;
+    GLint texture0 = 0;
+    GLint texture1 = 0;
+    GLint blendSrcRgb = GL_ONE;
+    GLint blendDstRgb = GL_ZERO;
+    GLint blendSrcAlpha = GL_ONE;
+    GLint blendDstAlpha = GL_ZERO;
+    GLint viewport[4] = {0, 0, 0, 0};
+    GLboolean blend = GL_FALSE;
+
+    static SavedGlState capture() {
+        SavedGlState s;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &s.program);
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &s.vao);
+        glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &s.arrayBuffer);
+        glGetIntegerv(GL_ACTIVE_TEXTURE, &s.activeTexture);
+        glActiveTexture(GL_TEXTURE1);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &s.texture1);
+        glActiveTexture(GL_TEXTURE0);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &s.texture0);
+        glGetIntegerv(GL_BLEND_SRC_RGB, &s.blendSrcRgb);
+        glGetIntegerv(GL_BLEND_DST_RGB, &s.blendDstRgb);
+        glGetIntegerv(GL_BLEND_SRC_ALPHA, &s.blendSrcAlpha);
+        glGetIntegerv(GL_BLEND_DST_ALPHA, &s.blendDstAlpha);
+        glGetIntegerv(GL_VIEWPORT, s.viewport);
+        s.blend = glIsEnabled(GL_BLEND);
+        return s;
+    }
+
+    void restore() const {
+        if (blend) {
+            glEnable(GL_BLEND);
+        } else {
+            glDisable(GL_BLEND);
+        }
+        glBlendFuncSeparate(static_cast<GLenum>(blendSrcRgb), static_cast<GLenum>(blendDstRgb),
+                            static_cast<GLenum>(blendSrcAlpha), static_cast<GLenum>(blendDstAlpha));
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture1));
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(texture0));
+        glActiveTexture(static_cast<GLenum>(activeTexture));
+        glBindVertexArray(static_cast<GLuint>(vao));
+        glBindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(arrayBuffer));
+        glUseProgram(static_cast<GLuint>(program));
+    }
+};
+
+double nowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+extern "C" {
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeHud_nativeRecord(JNIEnv* env, jclass, jfloatArray stageMs) {
+    if (stageMs == nullptr || env->GetArrayLength(stageMs) < vrrenderer::kHudStageCount) {
+        return;
+    }
+    float samples[vrrenderer::kHudStageCount];
+    env->GetFloatArrayRegion(stageMs, 0, vrrenderer::kHudStageCount, samples);
+    gHud.record(samples, nowMs());
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeHud_nativeSetCounters(JNIEnv* env, jclass, jlongArray counters) {
+    if (counters == nullptr || env->GetArrayLength(counters) < vrrenderer::kHudCounterCount) {
+        return;
+    }
+    jlong values[vrrenderer::kHudCounterCount];
+    env->GetLongArrayRegion(counters, 0, vrrenderer::kHudCounterCount, values);
+    int64_t copy[vrrenderer::kHudCounterCount];
+    for (int i = 0; i < vrrenderer::kHudCounterCount; ++i) {
+        copy[i] = static_cast<int64_t>(values[i]);
+    }
+    gHud.setCounters(copy);
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeHud_nativeDraw(JNIEnv*, jclass, jint surfaceWidth, jint surfaceHeight,
+                                                  jboolean stereo) {
+    const double start = nowMs();
+    if (!ensureGl()) {
+        return;
+    }
+
+    const SavedGlState saved = SavedGlState::capture();
+    glUseProgram(gGl.program);
+    glBindVertexArray(gGl.vao);
+    if (gHud.update(surfaceWidth, surfaceHeight, stereo == JNI_TRUE, start)) {
+        const std::vector<vrrenderer::HudVertex>& vertices = gHud.vertices();
+        glBindBuffer(GL_ARRAY_BUFFER, gGl.vbo);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(vrrenderer::HudVertex)),
+                     vertices.data(), GL_DYNAMIC_DRAW);
+        gGl.vertexCount = static_cast<GLsizei>(vertices.size());
+    }
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, gGl.graphTexture);
+    GLint unpack = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    const uint64_t pending = gHud.sampleCount() - gGl.uploadedSamples;
+    if (pending == 1) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, gHud.head(), 0, 1, vrrenderer::kHudStageCount, GL_RED, GL_UNSIGNED_BYTE,
+                        gHud.latestColumn());
+    } else if (pending > 1) {
+        // First draw after enabling, or frames recorded without a draw.
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, vrrenderer::kHudGraphSamples, vrrenderer::kHudStageCount, GL_RED,
+                        GL_UNSIGNED_BYTE, gHud.graphPixels());
+    }
+    gGl.uploadedSamples = gHud.sampleCount();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, unpack);
+    glUniform1i(gGl.headUniform, gHud.head());
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, gGl.fontTexture);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glViewport(0, 0, surfaceWidth, surfaceHeight);
+    glDrawArrays(GL_TRIANGLES, 0, gGl.vertexCount);
+
+    saved.restore();
+
+    gHud.setDrawCost(static_cast<float>(nowMs() - start));
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeHud_nativeReset(JNIEnv*, jclass) {
+    // GL objects died with the old context; rebuild lazily on the next draw.
+    gGl = HudGl();
+    gHud.reset();
+}
+
+}
+
+#endif  // __ANDROID__
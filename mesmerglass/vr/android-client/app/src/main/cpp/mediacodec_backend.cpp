@@ -0,0 +1,333 @@
+/**
+ * MediaCodec Backend - NDK AMediaCodec decode straight to a Surface
+ *
+ * With API 28+ headers the codec runs in async mode: AMediaCodec callbacks
+ * post free input buffers and finished output buffers to queues, and
+ * queueInput()/dequeueOutput() just wait on those. Older targets (minSdk 21,
+ * Oculus Go) fall back to the dequeue*Buffer() polling calls with the same
+ * timeouts, so VideoDecoder sees identical semantics either way.
+ */
+
+#if defined(__ANDROID__)
+
+#include "video_decoder.h"
+
+#include <android/log.h>
+#include <android/native_window.h>
+#include <media/NdkMediaCodec.h>
+#include <media/NdkMediaFormat.h>
+
+#include <chrono>
+#include <cstring>
+
+#define LOG_TAG "MediaCodecBackend"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+#if __ANDROID_API__ >= 28
+#define VRRENDERER_MEDIACODEC_ASYNC 1
+#endif
+
+namespace vrrenderer {
+namespace {
+
+const char* kMimeAvc = "video/avc";
+const char* kMimeHevc = "video/hevc";
+
+void appendNal(std::vector<uint8_t>* csd, const std::vector<uint8_t>& nal) {
+    static const uint8_t kStartCode[] = {0, 0, 0, 1};
+    csd->insert(csd->end(), kStartCode, kStartCode + 4);
+    csd->insert(csd->end(), nal.begin(), nal.end());
+}
+
+void setCsd(AMediaFormat* format, const char* key, const std::vector<uint8_t>& nal) {
+    std::vector<uint8_t> csd;
+    appendNal(&csd, nal);
+    AMediaFormat_setBuffer(format, key, csd.data(), csd.size());
+}
+
+class MediaCodecBackend : public DecoderBackend {
+public:
+    explicit MediaCodecBackend(ANativeWindow* window) : window_(window) {
+        if (window_ != nullptr) {
+            ANativeWindow_acquire(window_);
+        }
+    }
+
+    ~MediaCodecBackend() override {
+        stop();
+        if (window_ != nullptr) {
+            ANativeWindow_release(window_);
+        }
+    }
+
+    const char* name() const override { return "mediacodec"; }
+
+    bool configure(const CodecConfig& config) override {
+        stop();
+        const bool hevc = config.codec == annexb::Codec::kHevc;
+        const char* mime = hevc ? kMimeHevc : kMimeAvc;
+        codec_ = AMediaCodec_createDecoderByType(mime);
+        if (codec_ == nullptr) {
+            LOGE("createDecoderByType(%s) failed", mime);
+            return false;
+        }
+        width_ = config.width > 0 ? config.width : 1920;
+        height_ = config.height > 0 ? config.height : 1080;
+
+        AMediaFormat* format = AMediaFormat_new();
+        AMediaFormat_setString(format, AMEDIAFORMAT_KEY_MIME, mime);
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_WIDTH, width_);
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_HEIGHT, height_);
+        if (hevc && !config.vps.empty() && !config.sps.empty() && !config.pps.empty()) {
+            // HEVC takes every parameter set in csd-0.
+            std::vector<uint8_t> csd;
+            appendNal(&csd, config.vps);
+            appendNal(&csd, config.sps);
+            appendNal(&csd, config.pps);
+            AMediaFormat_setBuffer(format, "csd-0", csd.data(), csd.size());
+        } else if (!hevc && !config.sps.empty() && !config.pps.empty()) {
+            setCsd(format, "csd-0", config.sps);
+            setCsd(format, "csd-1", config.pps);
+        }
+
+#if defined(VRRENDERER_MEDIACODEC_ASYNC)
+        AMediaCodecOnAsyncNotifyCallback callbacks{};
+        callbacks.onAsyncInputAvailable = &MediaCodecBackend::onInput;
+        callbacks.onAsyncOutputAvailable = &MediaCodecBackend::onOutput;
+        callbacks.onAsyncFormatChanged = &MediaCodecBackend::onFormat;
+        callbacks.onAsyncError = &MediaCodecBackend::onError;
+        if (AMediaCodec_setAsyncNotifyCallback(codec_, callbacks, this) != AMEDIA_OK) {
+            LOGE("setAsyncNotifyCallback failed");
+        }
+#endif
+
+        media_status_t rc = AMediaCodec_configure(codec_, format, window_, nullptr, 0);
+        AMediaFormat_delete(format);
+        if (rc != AMEDIA_OK || AMediaCodec_start(codec_) != AMEDIA_OK) {
+            LOGE("configure/start failed (%d)", static_cast<int>(rc));
+            AMediaCodec_delete(codec_);
+            codec_ = nullptr;
+            return false;
+        }
+        LOGI("AMediaCodec %s started %dx%d (%s)", mime, width_.load(), height_.load(),
+#if defined(VRRENDERER_MEDIACODEC_ASYNC)
+             "async"
+#else
+             "sync"
+#endif
+        );
+        return true;
+    }
+
+    InputStatus queueInput(const uint8_t* data, size_t size, int64_t ptsUs, int64_t timeoutUs) override {
+        if (codec_ == nullptr) {
+            return InputStatus::kError;
+        }
+        ssize_t index = nextInput(timeoutUs);
+        if (index == -2) {
+            return InputStatus::kError;
+        }
+        if (index < 0) {
+            return InputStatus::kTryAgain;
+        }
+        size_t capacity = 0;
+        uint8_t* buf = AMediaCodec_getInputBuffer(codec_, static_cast<size_t>(index), &capacity);
+        if (buf == nullptr || capacity < size) {
+            LOGE("input buffer too small (%zu < %zu)", capacity, size);
+            AMediaCodec_queueInputBuffer(codec_, static_cast<size_t>(index), 0, 0, static_cast<uint64_t>(ptsUs), 0);
+            return InputStatus::kError;
+        }
+        std::memcpy(buf, data, size);
+        // Decoders ignore input flags other than EOS; KEY_FRAME is not set.
+        media_status_t rc =
+            AMediaCodec_queueInputBuffer(codec_, static_cast<size_t>(index), 0, size, static_cast<uint64_t>(ptsUs), 0);
+        return rc == AMEDIA_OK ? InputStatus::kQueued : InputStatus::kError;
+    }
+
+    bool dequeueOutput(DecodedFrame* frame, int64_t timeoutUs) override {
+        if (codec_ == nullptr) {
+            return false;
+        }
+#if defined(VRRENDERER_MEDIACODEC_ASYNC)
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (outputs_.empty() && timeoutUs > 0) {
+            cv_.wait_for(lock, std::chrono::microseconds(timeoutUs));
+        }
+        if (outputs_.empty()) {
+            return false;
+        }
+        Output out = outputs_.front();
+        outputs_.pop_front();
+        lock.unlock();
+        frame->bufferIndex = out.index;
+        frame->ptsUs = out.ptsUs;
+#else
+        AMediaCodecBufferInfo info;
+        while (true) {
+            ssize_t index = AMediaCodec_dequeueOutputBuffer(codec_, &info, timeoutUs);
+            if (index == AMEDIACODEC_INFO_OUTPUT_FORMAT_CHANGED) {
+                readOutputFormat(AMediaCodec_getOutputFormat(codec_));
+                continue;
+            }
+            if (index == AMEDIACODEC_INFO_OUTPUT_BUFFERS_CHANGED) {
+                continue;
+            }
+            if (index < 0) {
+                return false;
+            }
+            frame->bufferIndex = static_cast<int32_t>(index);
+            frame->ptsUs = info.presentationTimeUs;
+            break;
+        }
+#endif
+        frame->width = width_;
+        frame->height = height_;
+        frame->luma = nullptr;
+        frame->lumaStride = 0;
+        return true;
+    }
+
+    void releaseOutput(const DecodedFrame& frame, int64_t renderTimeNs) override {
+        if (codec_ == nullptr || frame.bufferIndex < 0) {
+            return;
+        }
+        const size_t index = static_cast<size_t>(frame.bufferIndex);
+        if (renderTimeNs < 0) {
+            AMediaCodec_releaseOutputBuffer(codec_, index, false);
+        } else {
+            AMediaCodec_releaseOutputBufferAtTime(codec_, index, renderTimeNs);
+        }
+    }
+
+    void flush() override {
+        if (codec_ == nullptr) {
+            return;
+        }
+        AMediaCodec_flush(codec_);
+#if defined(VRRENDERER_MEDIACODEC_ASYNC)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            inputs_.clear();
+            outputs_.clear();
+        }
+        // Async codecs stay paused after flush until restarted.
+        AMediaCodec_start(codec_);
+#endif
+    }
+
+    void stop() override {
+        if (codec_ == nullptr) {
+            return;
+        }
+        AMediaCodec_stop(codec_);
+        AMediaCodec_delete(codec_);
+        codec_ = nullptr;
+#if defined(VRRENDERER_MEDIACODEC_ASYNC)
+        std::lock_guard<std::mutex> lock(mutex_);
+        inputs_.clear();
+        outputs_.clear();
+        error_ = false;
+#endif
+    }
+
+private:
+    void readOutputFormat(AMediaFormat* format) {
+        if (format == nullptr) {
+            return;
+        }
+        int32_t w = 0;
+        int32_t h = 0;
+        if (AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_WIDTH, &w) &&
+            AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_HEIGHT, &h)) {
+            width_ = w;
+            height_ = h;
+        }
+        AMediaFormat_delete(format);
+    }
+
+    // Index of a free input buffer, -1 on timeout, -2 on codec error.
+    ssize_t nextInput(int64_t timeoutUs) {
+#if defined(VRRENDERER_MEDIACODEC_ASYNC)
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (inputs_.empty() && !error_ && timeoutUs > 0) {
+            cv_.wait_for(lock, std::chrono::microseconds(timeoutUs));
+        }
+        if (error_) {
+            error_ = false;
+            return -2;
+        }
+        if (inputs_.empty()) {
+            return -1;
+        }
+        ssize_t index = static_cast<ssize_t>(inputs_.front());
+        inputs_.pop_front();
+        return index;
+#else
+        ssize_t index = AMediaCodec_dequeueInputBuffer(codec_, timeoutUs);
+        return index >= 0 ? index : -1;
+#endif
+    }
+
+#if defined(VRRENDERER_MEDIACODEC_ASYNC)
+    struct Output {
+        int32_t index;
+        int64_t ptsUs;
+    };
+
+    static void onInput(AMediaCodec*, void* userdata, int32_t index) {
+        auto* self = static_cast<MediaCodecBackend*>(userdata);
+        std::lock_guard<std::mutex> lock(self->mutex_);
+        self->inputs_.push_back(index);
+        self->cv_.notify_all();
+    }
+
+    static void onOutput(AMediaCodec*, void* userdata, int32_t index, AMediaCodecBufferInfo* info) {
+        auto* self = static_cast<MediaCodecBackend*>(userdata);
+        std::lock_guard<std::mutex> lock(self->mutex_);
+        self->outputs_.push_back(Output{index, info->presentationTimeUs});
+        self->cv_.notify_all();
+    }
+
+    static void onFormat(AMediaCodec*, void* userdata, AMediaFormat* format) {
+        auto* self = static_cast<MediaCodecBackend*>(userdata);
+        // The callback owns `format`; copy out what we need.
+        int32_t w = 0;
+        int32_t h = 0;
+        if (AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_WIDTH, &w) &&
+            AMediaFormat_getInt32(format, AMEDIAFORMAT_KEY_HEIGHT, &h)) {
+            self->width_ = w;
+            self->height_ = h;
+        }
+    }
+
+    static void onError(AMediaCodec*, void* userdata, media_status_t error, int32_t code, const char* detail) {
+        auto* self = static_cast<MediaCodecBackend*>(userdata);
+        LOGE("codec error %d/%d: %s", static_cast<int>(error), code, detail ? detail : "");
+        std::lock_guard<std::mutex> lock(self->mutex_);
+        self->error_ = true;
+        self->cv_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<int32_t> inputs_;
+    std::deque<Output> outputs_;
+    bool error_ = false;
+#endif
+
+    ANativeWindow* window_;
+    AMediaCodec* codec_ = nullptr;
+    std::atomic<int> width_{0};
+    std::atomic<int> height_{0};
+};
+
+}  // namespace
+
+std::unique_ptr<DecoderBackend> createMediaCodecBackend(ANativeWindow* window) {
+    return std::unique_ptr<DecoderBackend>(new MediaCodecBackend(window));
+}
+
+}  // namespace vrrenderer
+
+#endif  // __ANDROID__
@@ -0,0 +1,159 @@
+/**
+ * JNI bridge for NativeMulticast.kt
+ *
+ * One handle per multicast session. The receive loop in NetworkReceiver pushes
+ * datagrams, takes packets and repair requests; stats may be read from the HUD
+ * thread, hence the mutex.
+ */
+
+#if defined(__ANDROID__)
+
+#include "multicast_rx.h"
+
+#include <jni.h>
+
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct MulticastHandle {
+    explicit MulticastHandle(int epoch) : reassembler(epoch) {}
+
+    std::mutex mutex;
+    vrrenderer::MulticastReassembler reassembler;
+    std::vector<uint8_t> packet;
+    std::vector<vrrenderer::RepairRequest> requests;
+};
+
+MulticastHandle* fromJava(jlong handle) {
+    return reinterpret_cast<MulticastHandle*>(handle);
+}
+
+}  // namespace
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_hypnotic_vrreceiver_NativeMulticast_nativeCreate(JNIEnv*, jclass, jint epoch) {
+    return reinterpret_cast<jlong>(new MulticastHandle(epoch));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_hypnotic_vrreceiver_NativeMulticast_nativePush(JNIEnv* env, jclass, jlong handle, jbyteArray data,
+                                                        jint length, jlong nowUs) {
+    MulticastHandle* h = fromJava(handle);
+    if (h == nullptr || data == nullptr || length <= 0 || length > env->GetArrayLength(data)) {
+        return JNI_FALSE;
+    }
+    // Datagrams are small: copy instead of taking the mutex inside a critical region.
+    thread_local std::vector<uint8_t> datagram;
+    datagram.resize(static_cast<size_t>(length));
+    env->GetByteArrayRegion(data, 0, length, reinterpret_cast<jbyte*>(datagram.data()));
+    std::lock_guard<std::mutex> lock(h->mutex);
+    h->reassembler.push(datagram.data(), datagram.size(), nowUs);
+    return h->reassembler.ready() > 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_hypnotic_vrreceiver_NativeMulticast_nativePoll(JNIEnv*, jclass, jlong handle, jlong nowUs) {
+    MulticastHandle* h = fromJava(handle);
+    if (h == nullptr) {
+        return JNI_FALSE;
+    }
+    std::lock_guard<std::mutex> lock(h->mutex);
+    h->reassembler.poll(nowUs);
+    return h->reassembler.ready() > 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_com_hypnotic_vrreceiver_NativeMulticast_nativeNextPacket(JNIEnv* env, jclass, jlong handle) {
+    MulticastHandle* h = fromJava(handle);
+    if (h == nullptr) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(h->mutex);
+    if (!h->reassembler.popPacket(h->packet) || h->packet.size() <= 4) {
+        return nullptr;
+    }
+    // Without the size prefix: the same bytes the TCP path hands to parsePacket.
+    const jsize size = static_cast<jsize>(h->packet.size() - 4);
+    jbyteArray out = env->NewByteArray(size);
+    if (out != nullptr) {
+        env->SetByteArrayRegion(out, 0, size, reinterpret_cast<const jbyte*>(h->packet.data() + 4));
+    }
+    return out;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_hypnotic_vrreceiver_NativeMulticast_nativeRepairRequests(JNIEnv* env, jclass, jlong handle, jlong nowUs) {
+    MulticastHandle* h = fromJava(handle);
+    if (h == nullptr) {
+        return nullptr;
+    }
+    std::vector<jlong> packed;
+    {
+        std::lock_guard<std::mutex> lock(h->mutex);
+        h->requests.clear();
+        h->reassembler.repairRequests(nowUs, h->requests);
+        // seq << 24 | block << 8 | count, unpacked by NativeMulticast.repairRequests.
+        for (const auto& r : h->requests) {
+            packed.push_back((static_cast<jlong>(r.seq) << 24) | (static_cast<jlong>(r.block) << 8) | r.count);
+        }
+    }
+    if (packed.empty()) {
+        return nullptr;
+    }
+    jlongArray out = env->NewLongArray(static_cast<jsize>(packed.size()));
+    if (out != nullptr) {
+        env->SetLongArrayRegion(out, 0, static_cast<jsize>(packed.size()), packed.data());
+    }
+    return out;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_hypnotic_vrreceiver_NativeMulticast_nativeTakeKeyframeRequest(JNIEnv*, jclass, jlong handle) {
+    MulticastHandle* h = fromJava(handle);
+    if (h == nullptr) {
+        return JNI_FALSE;
+    }
+    std::lock_guard<std::mutex> lock(h->mutex);
+    return h->reassembler.takeKeyframeRequest() ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_hypnotic_vrreceiver_NativeMulticast_nativeStats(JNIEnv* env, jclass, jlong handle) {
+    MulticastHandle* h = fromJava(handle);
+    if (h == nullptr) {
+        return nullptr;
+    }
+    vrrenderer::MulticastStats s;
+    {
+        std::lock_guard<std::mutex> lock(h->mutex);
+        s = h->reassembler.stats();
+    }
+    // Order must match NativeMulticast.Stats.
+    const jlong values[] = {
+        static_cast<jlong>(s.datagrams),
+        static_cast<jlong>(s.delivered),
+        static_cast<jlong>(s.recovered),
+        static_cast<jlong>(s.repaired),
+        static_cast<jlong>(s.lost),
+        static_cast<jlong>(s.requests),
+    };
+    const jsize count = static_cast<jsize>(sizeof(values) / sizeof(values[0]));
+    jlongArray out = env->NewLongArray(count);
+    if (out != nullptr) {
+        env->SetLongArrayRegion(out, 0, count, values);
+    }
+    return out;
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeMulticast_nativeDestroy(JNIEnv*, jclass, jlong handle) {
+    delete fromJava(handle);
+}
+
+}
+
+#endif  // __ANDROID__
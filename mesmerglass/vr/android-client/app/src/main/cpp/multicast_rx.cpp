@@ -0,0 +1,413 @@
+/**
+ * Multicast receiver - see multicast_rx.h
+ */
+
+#include "multicast_rx.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vrrenderer {
+
+namespace {
+
+constexpr uint8_t kFlagKeyframe = 0x01;
+constexpr int kMaxParity = 128;
+constexpr uint32_t kMaxPacketBytes = 32u * 1000u * 1000u;  // matches NetworkReceiver
+
+struct GfTables {
+    uint8_t mul[256][256];
+    uint8_t inv[256];
+
+    GfTables() {
+        uint8_t exp[512];
+        int log[256] = {0};
+        int x = 1;
+        for (int i = 0; i < 255; i++) {
+            exp[i] = static_cast<uint8_t>(x);
+            log[x] = i;
+            x <<= 1;
+            if (x & 0x100) {
+                x ^= 0x11D;
+            }
+        }
+        for (int i = 255; i < 512; i++) {
+            exp[i] = exp[i - 255];
+        }
+        for (int a = 0; a < 256; a++) {
+            for (int b = 0; b < 256; b++) {
+                mul[a][b] = (a == 0 || b == 0) ? 0 : exp[log[a] + log[b]];
+            }
+        }
+        inv[0] = 0;
+        for (int a = 1; a < 256; a++) {
+            inv[a] = exp[255 - log[a]];
+        }
+    }
+};
+
+const GfTables& gf() {
+    static const GfTables tables;
+    return tables;
+}
+
+// dst ^= c * src
+void mulAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t size) {
+    if (c == 0) {
+        return;
+    }
+    const uint8_t* row = gf().mul[c];
+    for (size_t n = 0; n < size; n++) {
+        dst[n] ^= row[src[n]];
+    }
+}
+
+void scale(uint8_t* dst, uint8_t c, size_t size) {
+    const uint8_t* row = gf().mul[c];
+    for (size_t n = 0; n < size; n++) {
+        dst[n] = row[dst[n]];
+    }
+}
+
+uint16_t be16(const uint8_t* p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+uint32_t be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+}  // namespace
+
+namespace fec {
+
+uint8_t coefficient(int parity, int dataIndex) {
+    return gf().inv[static_cast<uint8_t>((128 + parity) ^ dataIndex)];
+}
+
+void encode(const uint8_t* const* data, int k, size_t size, int first, int count, uint8_t* const* out) {
+    for (int j = 0; j < count; j++) {
+        std::memset(out[j], 0, size);
+        for (int i = 0; i < k; i++) {
+            mulAdd(out[j], data[i], coefficient(first + j, i), size);
+        }
+    }
+}
+
+bool recover(uint8_t* const* data, const uint8_t* present, int k, size_t size,
+             const std::vector<std::pair<int, const uint8_t*>>& parity) {
+    std::vector<int> missing;
+    for (int i = 0; i < k; i++) {
+        if (!present[i]) {
+            missing.push_back(i);
+        }
+    }
+    const size_t n = missing.size();
+    if (n == 0) {
+        return true;
+    }
+    if (parity.size() < n) {
+        return false;
+    }
+    // rhs_r = parity_r - sum over known i of C(r, i) * d_i; then solve C_missing * x = rhs.
+    std::vector<std::vector<uint8_t>> a(n, std::vector<uint8_t>(n));
+    for (size_t r = 0; r < n; r++) {
+        uint8_t* rhs = data[missing[r]];
+        std::memcpy(rhs, parity[r].second, size);
+        for (int i = 0; i < k; i++) {
+            if (present[i]) {
+                mulAdd(rhs, data[i], coefficient(parity[r].first, i), size);
+            }
+        }
+        for (size_t c = 0; c < n; c++) {
+            a[r][c] = coefficient(parity[r].first, missing[c]);
+        }
+    }
+    // Gauss-Jordan; row r of the system lives in data[missing[r]]. A square Cauchy
+    // matrix is always invertible, so a pivot always exists.
+    for (size_t col = 0; col < n; col++) {
+        size_t pivot = col;
+        while (pivot < n && a[pivot][col] == 0) {
+            pivot++;
+        }
+        if (pivot == n) {
+            return false;
+        }
+        if (pivot != col) {
+            std::swap(a[pivot], a[col]);
+            std::swap_ranges(data[missing[pivot]], data[missing[pivot]] + size, data[missing[col]]);
+        }
+        const uint8_t s = gf().inv[a[col][col]];
+        for (size_t c = 0; c < n; c++) {
+            a[col][c] = gf().mul[s][a[col][c]];
+        }
+        scale(data[missing[col]], s, size);
+        for (size_t r = 0; r < n; r++) {
+            const uint8_t f = a[r][col];
+            if (r == col || f == 0) {
+                continue;
+            }
+            for (size_t c = 0; c < n; c++) {
+                a[r][c] ^= gf().mul[f][a[col][c]];
+            }
+            mulAdd(data[missing[r]], data[missing[col]], f, size);
+        }
+    }
+    return true;
+}
+
+}  // namespace fec
+
+MulticastReassembler::MulticastReassembler(int epoch) : MulticastReassembler(epoch, Options()) {}
+
+MulticastReassembler::MulticastReassembler(int epoch, const Options& options) : options_(options), epoch_(epoch) {}
+
+bool MulticastReassembler::push(const uint8_t* p, size_t len, int64_t nowUs) {
+    // magic 'VRHM' | u16 epoch | u8 flags | u8 k | u32 seq | u32 length
+    // | u16 block | u16 blocks | u8 index | u8 m | u16 shard_size | shard
+    if (len < kMulticastHeaderSize || std::memcmp(p, "VRHM", 4) != 0) {
+        return false;
+    }
+    const int epoch = be16(p + 4);
+    const uint8_t flags = p[6];
+    const int k = p[7];
+    const uint32_t seq = be32(p + 8);
+    const uint32_t length = be32(p + 12);
+    const int blockIndex = be16(p + 16);
+    const int blocks = be16(p + 18);
+    const int index = p[20];
+    const uint16_t shardSize = be16(p + 22);
+    if ((epoch_ >= 0 && epoch != epoch_) || len != kMulticastHeaderSize + shardSize || shardSize == 0 ||
+        blocks == 0 || blockIndex >= blocks || length == 0 || length > kMaxPacketBytes || k == 0) {
+        return false;
+    }
+    const uint32_t shards = (length + shardSize - 1) / shardSize;
+    if (static_cast<uint32_t>(blocks) > shards || index - k >= kMaxParity) {
+        return false;
+    }
+    if (started_ && !inWindow(seq)) {
+        // One stray datagram must not drag newest_ (and poll) billions of frames ahead,
+        // but a stream that resumed elsewhere after an outage is followed.
+        if (nowUs - lastAcceptedUs_ < options_.holdUs) {
+            return false;
+        }
+        resync(seq);
+    }
+    stats_.datagrams++;
+    lastAcceptedUs_ = nowUs;
+    if (started_ && seq < next_) {
+        return true;  // delivered or given up
+    }
+
+    auto it = pending_.find(seq);
+    if (it == pending_.end()) {
+        Frame frame;
+        frame.length = length;
+        frame.shardSize = shardSize;
+        frame.flags = flags;
+        frame.data.resize(static_cast<size_t>(shards) * shardSize);
+        frame.blocks.resize(blocks);
+        const uint32_t base = shards / blocks;
+        const uint32_t extra = shards % blocks;
+        uint32_t first = 0;
+        for (int b = 0; b < blocks; b++) {
+            Block& block = frame.blocks[b];
+            block.first = first;
+            block.k = static_cast<int>(base + (static_cast<uint32_t>(b) < extra ? 1 : 0));
+            block.present.assign(block.k, 0);
+            first += block.k;
+        }
+        frame.firstSeenUs = nowUs;
+        it = pending_.emplace(seq, std::move(frame)).first;
+        if (!started_) {
+            started_ = true;
+            next_ = seq;
+            newest_ = seq;
+        } else if (seq > newest_) {
+            newest_ = seq;
+        }
+    }
+    Frame& frame = it->second;
+    frame.lastSeenUs = nowUs;
+    if (frame.length != length || frame.shardSize != shardSize || frame.blocks.size() != static_cast<size_t>(blocks)) {
+        return false;
+    }
+    Block& block = frame.blocks[blockIndex];
+    if (block.k != k || block.done) {
+        poll(nowUs);
+        return true;
+    }
+    const uint8_t* shard = p + kMulticastHeaderSize;
+    if (index < k) {
+        if (!block.present[index]) {
+            std::memcpy(frame.data.data() + static_cast<size_t>(block.first + index) * shardSize, shard, shardSize);
+            block.present[index] = 1;
+            block.have++;
+        }
+    } else {
+        const int j = index - k;
+        const bool duplicate = std::any_of(block.parity.begin(), block.parity.end(),
+                                           [j](const std::pair<int, std::vector<uint8_t>>& e) { return e.first == j; });
+        if (!duplicate) {
+            block.parity.emplace_back(j, std::vector<uint8_t>(shard, shard + shardSize));
+        }
+    }
+    if (block.have + static_cast<int>(block.parity.size()) >= block.k) {
+        finishBlock(frame, block);
+    }
+    poll(nowUs);
+    return true;
+}
+
+void MulticastReassembler::finishBlock(Frame& frame, Block& block) {
+    if (block.have < block.k) {
+        std::vector<uint8_t*> rows(block.k);
+        for (int i = 0; i < block.k; i++) {
+            rows[i] = frame.data.data() + static_cast<size_t>(block.first + i) * frame.shardSize;
+        }
+        std::vector<std::pair<int, const uint8_t*>> parity;
+        for (const auto& entry : block.parity) {
+            parity.emplace_back(entry.first, entry.second.data());
+        }
+        if (!fec::recover(rows.data(), block.present.data(), block.k, frame.shardSize, parity)) {
+            return;
+        }
+        frame.recovered = true;
+    }
+    block.done = true;
+    block.parity.clear();
+    block.parity.shrink_to_fit();
+    frame.blocksDone++;
+}
+
+int64_t MulticastReassembler::overtakenAtUs(uint32_t seq) const {
+    int64_t at = -1;
+    for (auto it = pending_.upper_bound(seq); it != pending_.end(); ++it) {
+        if (at < 0 || it->second.firstSeenUs < at) {
+            at = it->second.firstSeenUs;
+        }
+    }
+    return at;
+}
+
+bool MulticastReassembler::inWindow(uint32_t seq) const {
+    const uint32_t window = static_cast<uint32_t>(options_.maxPending * 4);
+    return seq >= next_ ? seq - next_ <= window : next_ - seq <= window;
+}
+
+void MulticastReassembler::resync(uint32_t seq) {
+    stats_.lost += pending_.size();
+    pending_.clear();
+    next_ = seq;
+    newest_ = seq;
+    awaitingKey_ = true;
+    keyRequested_ = false;
+    requestKeyframe(seq);
+}
+
+void MulticastReassembler::requestKeyframe(uint32_t throughSeq) {
+    if (keyRequested_ && throughSeq <= keyRequestedThrough_) {
+        return;
+    }
+    keyRequested_ = true;
+    keyRequestedThrough_ = std::max(newest_, throughSeq);  // sent before the server sees the request
+    keyframeRequest_ = true;
+}
+
+void MulticastReassembler::poll(int64_t nowUs) {
+    while (started_ && next_ <= newest_) {
+        auto it = pending_.find(next_);
+        if (it != pending_.end() && it->second.complete()) {
+            Frame frame = std::move(it->second);
+            pending_.erase(it);
+            next_++;
+            if (awaitingKey_ && !(frame.flags & kFlagKeyframe)) {
+                continue;
+            }
+            awaitingKey_ = false;
+            stats_.delivered++;
+            stats_.recovered += frame.recovered ? 1 : 0;
+            stats_.repaired += frame.requests > 0 ? 1 : 0;
+            frame.data.resize(frame.length);
+            ready_.push_back(std::move(frame.data));
+            continue;
+        }
+        if (next_ == newest_) {
+            break;  // still arriving
+        }
+        // Held back behind a newer frame: wait for FEC or a repair, then skip it.
+        // The wait runs from when the newer frame arrived, so a burst of lost
+        // frames all expire together instead of costing holdUs each.
+        const int64_t overtaken = overtakenAtUs(next_);
+        if (overtaken >= 0 && nowUs - overtaken < options_.holdUs && pending_.size() <= options_.maxPending) {
+            break;
+        }
+        // Expired: skip the whole run of missing frames up to the oldest pending one.
+        uint32_t skipTo = next_ + 1;
+        if (it != pending_.end()) {
+            pending_.erase(it);
+        } else {
+            skipTo = pending_.empty() ? newest_ + 1 : pending_.begin()->first;
+        }
+        stats_.lost += skipTo - next_;
+        if (!awaitingKey_) {
+            awaitingKey_ = true;
+            requestKeyframe(skipTo - 1);
+        }
+        next_ = skipTo;
+    }
+}
+
+bool MulticastReassembler::popPacket(std::vector<uint8_t>& out) {
+    if (ready_.empty()) {
+        return false;
+    }
+    out = std::move(ready_.front());
+    ready_.pop_front();
+    return true;
+}
+
+void MulticastReassembler::repairRequests(int64_t nowUs, std::vector<RepairRequest>& out) {
+    for (auto& entry : pending_) {
+        Frame& frame = entry.second;
+        if (frame.complete() || frame.requests >= options_.maxRepairs) {
+            continue;
+        }
+        const bool goneBy = entry.first < newest_ || nowUs - frame.lastSeenUs >= options_.repairAfterUs;
+        if (!goneBy || (frame.requests > 0 && nowUs - frame.requestedAtUs < options_.repairRetryUs)) {
+            continue;
+        }
+        for (size_t b = 0; b < frame.blocks.size(); b++) {
+            const Block& block = frame.blocks[b];
+            if (!block.done) {
+                const int missing = block.k - block.have - static_cast<int>(block.parity.size());
+                out.push_back({entry.first, static_cast<uint16_t>(b), static_cast<uint8_t>(std::min(missing, 255))});
+            }
+        }
+        frame.requestedAtUs = nowUs;
+        frame.requests++;
+        stats_.requests++;
+    }
+    // Frames with no shard at all have no layout to repair; the decoder needs a
+    // new keyframe after them anyway, so ask for it without waiting out holdUs.
+    if (!started_) {
+        return;
+    }
+    const uint32_t from = keyRequested_ && keyRequestedThrough_ >= next_ ? keyRequestedThrough_ + 1 : next_;
+    for (uint32_t seq = from; seq < newest_; seq++) {
+        if (pending_.count(seq)) {
+            continue;
+        }
+        const int64_t overtaken = overtakenAtUs(seq);
+        if (overtaken >= 0 && nowUs - overtaken >= options_.repairAfterUs) {
+            requestKeyframe(seq);
+        }
+        break;
+    }
+}
+
+bool MulticastReassembler::takeKeyframeRequest() {
+    const bool requested = keyframeRequest_;
+    keyframeRequest_ = false;
+    return requested;
+}
+
+}  // namespace vrrenderer
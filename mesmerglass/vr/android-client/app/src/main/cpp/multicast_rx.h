@@ -0,0 +1,147 @@
+/**
+ * Multicast receiver - reassembles the server's FEC-protected multicast stream
+ *
+ * In multicast mode (mesmerglass/mesmervisor/multicast.py) the server sends each
+ * frame once to a UDP group: the ordinary size-prefixed stream packet cut into
+ * equal shards, grouped into blocks of k data shards plus Reed-Solomon parity
+ * (GF(2^8), systematic Cauchy code). Any k shards of a block rebuild it, so
+ * scattered losses cost no round trip. What FEC cannot cover is listed by
+ * repairRequests() and sent as REPAIR on the TCP control connection. A frame
+ * of which no shard arrived cannot be repaired block by block, so a gap in the
+ * sequence asks for a keyframe right away instead. A frame still incomplete
+ * holdUs after a newer one arrived is dropped (all such frames at once), and
+ * delivery resumes at the next keyframe (takeKeyframeRequest() -> NEED_IDR).
+ * Datagrams more than maxPending * 4 frames away from the next expected one
+ * are rejected as strays unless the stream has gone quiet for holdUs, in
+ * which case the receiver resyncs to them (the server moved on during an
+ * outage).
+ *
+ * Packets come out in sequence order. Not thread-safe; multicast_jni.cpp keeps
+ * one instance per receiver behind a mutex.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace vrrenderer {
+
+constexpr size_t kMulticastHeaderSize = 24;
+
+struct RepairRequest {
+    uint32_t seq;
+    uint16_t block;
+    uint8_t count;  // shards still missing
+};
+
+struct MulticastStats {
+    uint64_t datagrams = 0;
+    uint64_t delivered = 0;
+    uint64_t recovered = 0;  // frames rebuilt with parity
+    uint64_t repaired = 0;   // frames completed after a REPAIR
+    uint64_t lost = 0;
+    uint64_t requests = 0;
+};
+
+class MulticastReassembler {
+public:
+    struct Options {
+        int64_t holdUs = 50000;
+        int64_t repairAfterUs = 5000;
+        int64_t repairRetryUs = 30000;
+        int maxRepairs = 3;
+        size_t maxPending = 16;
+    };
+
+    // epoch < 0 accepts datagrams of any server run.
+    explicit MulticastReassembler(int epoch = -1);
+    MulticastReassembler(int epoch, const Options& options);
+
+    // Takes one datagram. Returns false if it is not a shard of this stream
+    // (including strays far outside the reassembly window).
+    bool push(const uint8_t* data, size_t len, int64_t nowUs);
+
+    // Delivers what is ready and gives up on frames held back too long.
+    void poll(int64_t nowUs);
+
+    // Oldest delivered packet (size prefix included), if any.
+    bool popPacket(std::vector<uint8_t>& out);
+    size_t ready() const { return ready_.size(); }
+
+    // Blocks of frames whose datagrams have stopped arriving but are incomplete.
+    // Also raises the keyframe request for frames that were lost entirely.
+    void repairRequests(int64_t nowUs, std::vector<RepairRequest>& out);
+
+    // True once after a frame was dropped.
+    bool takeKeyframeRequest();
+
+    const MulticastStats& stats() const { return stats_; }
+
+private:
+    struct Block {
+        uint32_t first = 0;  // first data shard of the frame in this block
+        int k = 0;
+        int have = 0;        // data shards received
+        bool done = false;
+        std::vector<uint8_t> present;  // per data shard
+        std::vector<std::pair<int, std::vector<uint8_t>>> parity;  // (parity index, shard)
+    };
+
+    struct Frame {
+        uint32_t length = 0;
+        uint16_t shardSize = 0;
+        uint8_t flags = 0;
+        std::vector<Block> blocks;
+        std::vector<uint8_t> data;  // all data shards, back to back
+        size_t blocksDone = 0;
+        bool recovered = false;
+        int64_t firstSeenUs = 0;
+        int64_t lastSeenUs = 0;
+        int64_t requestedAtUs = 0;
+        int requests = 0;
+
+        bool complete() const { return blocksDone == blocks.size(); }
+    };
+
+    void finishBlock(Frame& frame, Block& block);
+    // When a frame after `seq` first arrived (-1 if none has): `seq` is late from then on.
+    int64_t overtakenAtUs(uint32_t seq) const;
+    void requestKeyframe(uint32_t throughSeq);
+    bool inWindow(uint32_t seq) const;
+    void resync(uint32_t seq);
+
+    Options options_;
+    int epoch_;
+    std::map<uint32_t, Frame> pending_;
+    std::deque<std::vector<uint8_t>> ready_;
+    bool started_ = false;
+    uint32_t next_ = 0;
+    uint32_t newest_ = 0;
+    int64_t lastAcceptedUs_ = 0;  // last datagram inside the window
+    bool awaitingKey_ = true;
+    bool keyframeRequest_ = false;
+    bool keyRequested_ = false;
+    uint32_t keyRequestedThrough_ = 0;  // a NEED_IDR already covers losses up to here
+    MulticastStats stats_;
+};
+
+namespace fec {
+
+// Parity shard j of a block: sum over i of coefficient(j, i) * data shard i.
+uint8_t coefficient(int parity, int dataIndex);
+
+// Writes parity shards first..first+count-1 for k data shards of `size` bytes.
+void encode(const uint8_t* const* data, int k, size_t size, int first, int count, uint8_t* const* out);
+
+// Rebuilds the missing data shards (present[i] == 0) from parity shards
+// (index, bytes) in place. Needs at least as many parity shards as holes.
+bool recover(uint8_t* const* data, const uint8_t* present, int k, size_t size,
+             const std::vector<std::pair<int, const uint8_t*>>& parity);
+
+}  // namespace fec
+
+}  // namespace vrrenderer
@@ -0,0 +1,315 @@
+/**
+ * Performance HUD - sample rings, counter text and overlay layout
+ *
+ * See perf_hud.h. Nothing here touches GL, so the layout runs on any host.
+ */
+
+#include "perf_hud.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace vrrenderer {
+
+namespace {
+
+// 5x7 glyphs for ASCII 0x20-0x5F, one byte per row, bit 4 = leftmost column.
+const uint8_t kFont5x7[64][7] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // space
+    {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04},  // !
+    {0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00},  // "
+    {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A},  // #
+    {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04},  // $
+    {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03},  // %
+    {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D},  // &
+    {0x04, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00},  // quote
+    {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02},  // (
+    {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08},  // )
+    {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00},  // *
+    {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00},  // +
+    {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08},  // ,
+    {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00},  // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C},  // .
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00},  // /
+    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},  // 0
+    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},  // 1
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},  // 2
+    {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},  // 3
+    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},  // 4
+    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},  // 5
+    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},  // 6
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},  // 7
+    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},  // 8
+    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},  // 9
+    {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00},  // :
+    {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08},  // ;
+    {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02},  // <
+    {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00},  // =
+    {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08},  // >
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04},  // ?
+    {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E},  // @
+    {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},  // A
+    {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E},  // B
+    {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E},  // C
+    {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C},  // D
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F},  // E
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10},  // F
+    {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F},  // G
+    {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},  // H
+    {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E},  // I
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C},  // J
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11},  // K
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F},  // L
+    {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11},  // M
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11},  // N
+    {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // O
+    {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10},  // P
+    {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D},  // Q
+    {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11},  // R
+    {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E},  // S
+    {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04},  // T
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // U
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04},  // V
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A},  // W
+    {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11},  // X
+    {0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04},  // Y
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F},  // Z
+    {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E},  // [
+    {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00},  // backslash
+    {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E},  // ]
+    {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00},  // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F},  // _
+};
+
+constexpr int kAtlasCell = 8;
+constexpr int kAtlasColumns = kHudAtlasWidth / kAtlasCell;
+constexpr int kSolidCell = 64;
+
+// Panel layout in HUD units (one unit = one font texel on screen).
+constexpr float kPad = 4.0f;
+constexpr float kGlyphAdvance = 6.0f;
+constexpr float kLineHeight = 9.0f;
+constexpr int kTextLines = 3;
+constexpr float kLabelWidth = 8 * kGlyphAdvance;
+constexpr float kGraphWidth = kHudGraphSamples;
+constexpr float kGraphHeight = 14.0f;
+constexpr float kGraphSpacing = 16.0f;
+constexpr float kPanelWidth = kPad + kLabelWidth + kGraphWidth + kPad;
+constexpr float kPanelHeight = kPad + kTextLines * kLineHeight + 2.0f + kHudStageCount * kGraphSpacing + kPad;
+
+// Share of each eye's width the panel takes, and where its top edge sits (eye NDC).
+constexpr float kPanelEyeWidth = 0.9f;
+constexpr float kPanelTopNdc = 0.55f;
+
+constexpr double kTextRefreshMs = 250.0;
+constexpr double kFpsWindowMs = 500.0;
+
+const char* const kStageLabels[kHudStageCount] = {"RX", "DEC", "UPL", "REN", "PRS"};
+const uint8_t kStageColors[kHudStageCount][4] = {
+    {80, 220, 255, 255},   // receive
+    {255, 210, 70, 255},   // decode
+    {120, 230, 120, 255},  // upload
+    {230, 120, 255, 255},  // render
+    {180, 180, 200, 255},  // present
+};
+const uint8_t kTextColor[4] = {235, 235, 235, 255};
+const uint8_t kPanelColor[4] = {0, 0, 0, 150};
+
+void atlasRect(int cell, float& u0, float& v0, float& u1, float& v1) {
+    const int x = (cell % kAtlasColumns) * kAtlasCell;
+    const int y = (cell / kAtlasColumns) * kAtlasCell;
+    u0 = static_cast<float>(x) / kHudAtlasWidth;
+    v0 = static_cast<float>(y) / kHudAtlasHeight;
+    u1 = static_cast<float>(x + 6) / kHudAtlasWidth;
+    v1 = static_cast<float>(y + 8) / kHudAtlasHeight;
+}
+
+}  // namespace
+
+PerfHud::PerfHud() {
+    reset();
+}
+
+void PerfHud::reset() {
+    std::memset(samples_, 0, sizeof(samples_));
+    std::memset(graph_, 0, sizeof(graph_));
+    std::memset(column_, 0, sizeof(column_));
+    std::memset(counters_, 0, sizeof(counters_));
+    head_ = kHudGraphSamples - 1;
+    sampleCount_ = 0;
+    drawCostMs_ = 0.0f;
+    fps_ = 0.0;
+    fpsWindowStartMs_ = -1.0;
+    fpsWindowFrames_ = 0;
+    lastLayoutMs_ = -1.0;
+    vertices_.clear();
+}
+
+void PerfHud::record(const float stageMs[kHudStageCount], double nowMs) {
+    head_ = (head_ + 1) % kHudGraphSamples;
+    for (int s = 0; s < kHudStageCount; ++s) {
+        const float ms = std::max(0.0f, stageMs[s]);
+        samples_[s][head_] = ms;
+        const float scaled = std::min(ms / kHudGraphFullScaleMs, 1.0f) * 255.0f + 0.5f;
+        column_[s] = static_cast<uint8_t>(scaled);
+        graph_[s][head_] = column_[s];
+    }
+    ++sampleCount_;
+
+    if (fpsWindowStartMs_ < 0.0) {
+        fpsWindowStartMs_ = nowMs;
+        fpsWindowFrames_ = 0;
+        return;
+    }
+    ++fpsWindowFrames_;
+    const double elapsedMs = nowMs - fpsWindowStartMs_;
+    if (elapsedMs >= kFpsWindowMs) {
+        fps_ = fpsWindowFrames_ * 1000.0 / elapsedMs;
+        fpsWindowStartMs_ = nowMs;
+        fpsWindowFrames_ = 0;
+    }
+}
+
+void PerfHud::setCounters(const int64_t counters[kHudCounterCount]) {
+    std::memcpy(counters_, counters, sizeof(counters_));
+}
+
+void PerfHud::setDrawCost(float ms) {
+    // Smoothed: a single preempted frame should not read as a HUD regression.
+    drawCostMs_ = drawCostMs_ <= 0.0f ? ms : drawCostMs_ * 0.9f + ms * 0.1f;
+}
+
+float PerfHud::stageAverageMs(int stage) const {
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(sampleCount_, 30));
+    if (n == 0) {
+        return 0.0f;
+    }
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += samples_[stage][(head_ + kHudGraphSamples - static_cast<int>(i)) % kHudGraphSamples];
+    }
+    return sum / static_cast<float>(n);
+}
+
+std::vector<std::string> PerfHud::textLines() const {
+    char buf[64];
+    std::vector<std::string> lines;
+    std::snprintf(buf, sizeof(buf), "FPS %4.1f  %5.1fMBPS  HUD %.2f", fps_,
+                  counters_[kHudBitrateKbps] / 1000.0, drawCostMs_);
+    lines.emplace_back(buf);
+    std::snprintf(buf, sizeof(buf), "JB %lldF %lldMS  DROP %lld", static_cast<long long>(counters_[kHudQueueFrames]),
+                  static_cast<long long>(counters_[kHudPlayoutMs]), static_cast<long long>(counters_[kHudDrops]));
+    lines.emplace_back(buf);
+    std::snprintf(buf, sizeof(buf), "RESYNC %lld  IDR %lld  CRC %lld", static_cast<long long>(counters_[kHudResyncs]),
+                  static_cast<long long>(counters_[kHudNeedIdr]), static_cast<long long>(counters_[kHudCrcFailures]));
+    lines.emplace_back(buf);
+    return lines;
+}
+
+bool PerfHud::update(int surfaceWidth, int surfaceHeight, bool stereo, double nowMs) {
+    if (surfaceWidth <= 0 || surfaceHeight <= 0) {
+        return false;
+    }
+    const bool surfaceChanged = surfaceWidth != surfaceWidth_ || surfaceHeight != surfaceHeight_ || stereo != stereo_;
+    if (!surfaceChanged && lastLayoutMs_ >= 0.0 && nowMs - lastLayoutMs_ < kTextRefreshMs) {
+        return false;
+    }
+    surfaceWidth_ = surfaceWidth;
+    surfaceHeight_ = surfaceHeight;
+    stereo_ = stereo;
+    lastLayoutMs_ = nowMs;
+
+    // Square font texels: one unit spans the same pixels on both axes.
+    const int eyes = stereo ? 2 : 1;
+    const float eyeWidthNdc = 2.0f / eyes;
+    const float unitX = kPanelEyeWidth * eyeWidthNdc / kPanelWidth;
+    const float unitY = unitX * static_cast<float>(surfaceWidth) / static_cast<float>(surfaceHeight);
+
+    vertices_.clear();
+    for (int eye = 0; eye < eyes; ++eye) {
+        const float eyeCenter = -1.0f + eyeWidthNdc * (eye + 0.5f);
+        layoutPanel(eyeCenter - kPanelWidth * unitX * 0.5f, kPanelTopNdc, unitX, unitY);
+    }
+    return true;
+}
+
+void PerfHud::layoutPanel(float left, float top, float unitX, float unitY) {
+    float u0, v0, u1, v1;
+    atlasRect(kSolidCell, u0, v0, u1, v1);
+    // Sample the middle of the solid cell so filtering never reaches a neighbour.
+    const float su = (u0 + u1) * 0.5f;
+    const float sv = (v0 + v1) * 0.5f;
+    pushQuad(left, top, left + kPanelWidth * unitX, top - kPanelHeight * unitY, su, sv, su, sv, kPanelColor, 0.0f);
+
+    float y = kPad;
+    for (const std::string& line : textLines()) {
+        pushText(line, left + kPad * unitX, top - y * unitY, unitX, unitY, kTextColor);
+        y += kLineHeight;
+    }
+    y += 2.0f;
+
+    char label[16];
+    for (int s = 0; s < kHudStageCount; ++s) {
+        const float avg = stageAverageMs(s);
+        std::snprintf(label, sizeof(label), avg < 100.0f ? "%-3s %4.1f" : "%-3s %4.0f", kStageLabels[s], avg);
+        const float rowTop = top - y * unitY;
+        pushText(label, left + kPad * unitX, rowTop - 3.0f * unitY, unitX, unitY, kStageColors[s]);
+        const float gx = left + (kPad + kLabelWidth) * unitX;
+        pushQuad(gx, rowTop, gx + kGraphWidth * unitX, rowTop - kGraphHeight * unitY, 0.0f, 1.0f, 1.0f, 0.0f,
+                 kStageColors[s], 1.0f + s);
+        y += kGraphSpacing;
+    }
+}
+
+void PerfHud::pushText(const std::string& text, float x, float y, float unitX, float unitY, const uint8_t rgba[4]) {
+    for (char c : text) {
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+        if (c != ' ') {
+            const int cell = (c >= 0x20 && c < 0x60) ? c - 0x20 : '?' - 0x20;
+            float u0, v0, u1, v1;
+            atlasRect(cell, u0, v0, u1, v1);
+            pushQuad(x, y, x + kGlyphAdvance * unitX, y - kAtlasCell * unitY, u0, v0, u1, v1, rgba, 0.0f);
+        }
+        x += kGlyphAdvance * unitX;
+    }
+}
+
+void PerfHud::pushQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1,
+                       const uint8_t rgba[4], float mode) {
+    // (x0, y0) is the top-left corner; two triangles, no index buffer.
+    const HudVertex tl = {x0, y0, u0, v0, {rgba[0], rgba[1], rgba[2], rgba[3]}, mode};
+    const HudVertex tr = {x1, y0, u1, v0, {rgba[0], rgba[1], rgba[2], rgba[3]}, mode};
+    const HudVertex bl = {x0, y1, u0, v1, {rgba[0], rgba[1], rgba[2], rgba[3]}, mode};
+    const HudVertex br = {x1, y1, u1, v1, {rgba[0], rgba[1], rgba[2], rgba[3]}, mode};
+    vertices_.push_back(tl);
+    vertices_.push_back(bl);
+    vertices_.push_back(tr);
+    vertices_.push_back(tr);
+    vertices_.push_back(bl);
+    vertices_.push_back(br);
+}
+
+void PerfHud::buildFontAtlas(std::vector<uint8_t>& pixels) {
+    pixels.assign(static_cast<size_t>(kHudAtlasWidth) * kHudAtlasHeight, 0);
+    for (int cell = 0; cell < 64; ++cell) {
+        const int cx = (cell % kAtlasColumns) * kAtlasCell;
+        const int cy = (cell / kAtlasColumns) * kAtlasCell;
+        for (int row = 0; row < 7; ++row) {
+            for (int col = 0; col < 5; ++col) {
+                if (kFont5x7[cell][row] & (0x10 >> col)) {
+                    pixels[static_cast<size_t>(cy + row) * kHudAtlasWidth + cx + col] = 255;
+                }
+            }
+        }
+    }
+    const int sx = (kSolidCell % kAtlasColumns) * kAtlasCell;
+    const int sy = (kSolidCell / kAtlasColumns) * kAtlasCell;
+    for (int row = 0; row < kAtlasCell; ++row) {
+        std::memset(&pixels[static_cast<size_t>(sy + row) * kHudAtlasWidth + sx], 255, kAtlasCell);
+    }
+}
+
+}  // namespace vrrenderer
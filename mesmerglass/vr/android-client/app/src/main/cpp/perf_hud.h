@@ -0,0 +1,119 @@
+/**
+ * Performance HUD - per-stage frame-time graphs and stream counters
+ *
+ * Platform-independent half of the in-headset overlay: keeps the sample
+ * rings, formats the counter text with a built-in 5x7 bitmap font and lays
+ * out one vertex array that covers both eyes. hud_jni.cpp owns the GL side
+ * (one program, two small textures, one glDrawArrays per frame).
+ *
+ * Graphs are not geometry: each stage is one quad whose fragment shader reads
+ * a kHudGraphSamples x kHudStageCount R8 ring texture, so a new frame costs a
+ * 1x5 texel upload. Vertices are only rebuilt when the text changes (a few
+ * times per second) or the surface does.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vrrenderer {
+
+// Stage order is shared with NativeHud.kt.
+enum HudStage {
+    kHudReceive = 0,  // packet inter-arrival
+    kHudDecode,       // JPEG decode / H.264 codec queue+decode
+    kHudUpload,       // texture upload or SurfaceTexture latch
+    kHudRender,       // eye draw calls
+    kHudPresent,      // outside onDrawFrame: swap + vsync wait
+    kHudStageCount
+};
+
+constexpr int kHudGraphSamples = 128;
+constexpr float kHudGraphFullScaleMs = 33.3f;  // top of each graph; the budget line sits at half
+
+// Font atlas: 16x5 cells of 8x8 texels. Cells 0-63 hold ASCII 0x20-0x5F,
+// cell 64 is solid (used for the panel background).
+constexpr int kHudAtlasWidth = 128;
+constexpr int kHudAtlasHeight = 40;
+
+// Counter order is shared with NativeHud.kt.
+enum HudCounter {
+    kHudQueueFrames = 0,  // frames waiting for the decoder
+    kHudPlayoutMs,        // playout (jitter) buffer
+    kHudBitrateKbps,
+    kHudDrops,
+    kHudResyncs,
+    kHudNeedIdr,          // NEED_IDR requests sent
+    kHudCrcFailures,
+    kHudCounterCount
+};
+
+struct HudVertex {
+    float x, y;      // NDC over the whole surface
+    float u, v;      // atlas uv (text/panel) or 0..1 within a graph
+    uint8_t rgba[4]; // premultiplied
+    float mode;      // 0 = atlas, 1 + stage = graph of that stage
+};
+
+class PerfHud {
+public:
+    PerfHud();
+
+    // One sample per rendered frame; nowMs drives the fps readout.
+    void record(const float stageMs[kHudStageCount], double nowMs);
+    void setCounters(const int64_t counters[kHudCounterCount]);
+    // CPU cost of the previous HUD draw, shown so the overlay accounts for itself.
+    void setDrawCost(float ms);
+
+    // Re-lays out text and panels when the surface changed or the text is
+    // older than the refresh interval. Returns true if vertices() changed.
+    bool update(int surfaceWidth, int surfaceHeight, bool stereo, double nowMs);
+
+    const std::vector<HudVertex>& vertices() const { return vertices_; }
+    // Graph ring as R8 texels (kHudGraphSamples wide, one row per stage), the
+    // newest column alone, and that column's x position.
+    const uint8_t* graphPixels() const { return &graph_[0][0]; }
+    const uint8_t* latestColumn() const { return column_; }
+    int head() const { return head_; }
+    // Samples recorded since reset(); lets the renderer tell a one-column
+    // update from a gap that needs the whole ring re-uploaded.
+    uint64_t sampleCount() const { return sampleCount_; }
+    // Fraction of the graph height at which the frame budget line is drawn.
+    static float budgetFraction() { return 0.5f; }
+
+    void reset();
+
+    // R8 pixels of the font atlas, kHudAtlasWidth x kHudAtlasHeight.
+    static void buildFontAtlas(std::vector<uint8_t>& pixels);
+
+private:
+    std::vector<std::string> textLines() const;
+    void layoutPanel(float left, float top, float unitX, float unitY);
+    void pushQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1,
+                  const uint8_t rgba[4], float mode);
+    void pushText(const std::string& text, float x, float y, float unitX, float unitY, const uint8_t rgba[4]);
+    float stageAverageMs(int stage) const;
+
+    float samples_[kHudStageCount][kHudGraphSamples];
+    uint8_t graph_[kHudStageCount][kHudGraphSamples];
+    uint8_t column_[kHudStageCount];
+    int head_ = kHudGraphSamples - 1;
+    uint64_t sampleCount_ = 0;
+
+    int64_t counters_[kHudCounterCount];
+    float drawCostMs_ = 0.0f;
+    double fps_ = 0.0;
+    double fpsWindowStartMs_ = -1.0;
+    int fpsWindowFrames_ = 0;
+
+    int surfaceWidth_ = 0;
+    int surfaceHeight_ = 0;
+    bool stereo_ = false;
+    double lastLayoutMs_ = -1.0;
+    std::vector<HudVertex> vertices_;
+};
+
+}  // namespace vrrenderer
@@ -0,0 +1,105 @@
+/**
+ * JNI bridge for NativeTexture.kt - VRHT ETC2 texture upload
+ *
+ * Runs on the GL thread. Payloads are copied out of the Java array, parsed
+ * (and LZ4-inflated) into reused buffers here and handed to
+ * glCompressedTex(Sub)Image2D, so a VRHT frame never goes through
+ * BitmapFactory or a Java-side copy. The copy keeps GL calls out of a JNI
+ * critical region, where they could stall the GC.
+ */
+
+#if defined(__ANDROID__)
+
+#include "texture_payload.h"
+#include "texture_upload.h"
+
+#include <jni.h>
+#include <android/log.h>
+#include <GLES3/gl3.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define LOG_TAG "VRTexture"
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+
+namespace {
+
+// Only touched from the GL thread.
+std::vector<uint8_t> gInput;
+std::vector<uint8_t> gScratch;
+std::unordered_map<GLuint, std::pair<int, int>> gAllocated;  // texture -> ETC2 storage size
+
+}  // namespace
+
+namespace vrrenderer {
+
+bool uploadEtc2Texture(GLuint texture, int width, int height, const uint8_t* blocks, size_t size) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    auto it = gAllocated.find(texture);
+    const GLsizei imageSize = static_cast<GLsizei>(size);
+    if (it != gAllocated.end() && it->second.first == width && it->second.second == height) {
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_COMPRESSED_RGB8_ETC2, imageSize, blocks);
+    } else {
+        glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RGB8_ETC2, width, height, 0, imageSize, blocks);
+        gAllocated[texture] = std::make_pair(width, height);
+    }
+    const GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        LOGE("ETC2 upload %dx%d failed: 0x%x", width, height, err);
+        gAllocated.erase(texture);
+        return false;
+    }
+    return true;
+}
+
+bool uploadRgbaTexture(GLuint texture, int width, int height, const uint8_t* pixels) {
+    // Always respecify: the storage is no longer ETC2, and JPEG frames uploaded
+    // from Kotlin (GLUtils.texImage2D) may have resized it behind our back.
+    gAllocated.erase(texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    const GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        LOGE("RGBA upload %dx%d failed: 0x%x", width, height, err);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace vrrenderer
+
+extern "C" {
+
+JNIEXPORT jint JNICALL
+Java_com_hypnotic_vrreceiver_NativeTexture_nativeUploadEtc2(JNIEnv* env, jclass, jint textureId, jbyteArray data,
+                                                            jint offset, jint length) {
+    if (data == nullptr || offset < 0 || length <= 0 || length > env->GetArrayLength(data) - offset) {
+        return 0;
+    }
+    gInput.resize(static_cast<size_t>(length));
+    env->GetByteArrayRegion(data, offset, length, reinterpret_cast<jbyte*>(gInput.data()));
+    vrrenderer::TexturePayload payload;
+    if (!vrrenderer::parseTexturePayload(gInput.data(), gInput.size(), gScratch, payload)) {
+        return 0;
+    }
+    const bool ok = vrrenderer::uploadEtc2Texture(static_cast<GLuint>(textureId), payload.width, payload.height,
+                                                  payload.blocks, payload.blocksSize);
+    return ok ? ((payload.width << 16) | payload.height) : 0;
+}
+
+JNIEXPORT void JNICALL
+Java_com_hypnotic_vrreceiver_NativeTexture_nativeReset(JNIEnv*, jclass) {
+    // Texture ids are reused after the GL context is recreated.
+    gAllocated.clear();
+}
+
+}
+
+#endif  // __ANDROID__
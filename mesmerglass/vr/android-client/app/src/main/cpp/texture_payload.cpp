@@ -0,0 +1,119 @@
+/**
+ * VRHT payload parsing and LZ4 block decoding
+ *
+ * The LZ4 decoder is the plain block format (sequences of literals + matches).
+ * It is bounds-checked on every copy since the input comes off the network.
+ */
+
+#include "texture_payload.h"
+
+#include <cstring>
+
+namespace vrrenderer {
+
+size_t etc2ImageSize(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+    return static_cast<size_t>((width + 3) / 4) * static_cast<size_t>((height + 3) / 4) * 8u;
+}
+
+bool lz4DecompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    const uint8_t* ip = src;
+    const uint8_t* const iend = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* const oend = dst + dstSize;
+
+    auto readLength = [&](size_t length, size_t& outLength) -> bool {
+        if (length != 15) {
+            outLength = length;
+            return true;
+        }
+        uint8_t b = 0;
+        do {
+            if (ip >= iend) {
+                return false;
+            }
+            b = *ip++;
+            length += b;
+        } while (b == 255);
+        outLength = length;
+        return true;
+    };
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+        size_t literals = 0;
+        if (!readLength(token >> 4, literals)) {
+            return false;
+        }
+        if (literals > static_cast<size_t>(iend - ip) || literals > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        std::memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == iend) {
+            break;  // the last sequence has literals only
+        }
+
+        if (iend - ip < 2) {
+            return false;
+        }
+        const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t matchLength = 0;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst) || !readLength(token & 0x0F, matchLength)) {
+            return false;
+        }
+        matchLength += 4;
+        if (matchLength > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        const uint8_t* match = op - offset;
+        if (offset >= matchLength) {
+            std::memcpy(op, match, matchLength);
+            op += matchLength;
+        } else {
+            // Overlapping copy (run-length style); must go byte by byte.
+            for (size_t i = 0; i < matchLength; i++) {
+                *op++ = *match++;
+            }
+        }
+    }
+    return op == oend;
+}
+
+bool parseTexturePayload(const uint8_t* data, size_t size, std::vector<uint8_t>& scratch, TexturePayload& out) {
+    if (data == nullptr || size < kTextureHeaderSize) {
+        return false;
+    }
+    out.width = (data[0] << 8) | data[1];
+    out.height = (data[2] << 8) | data[3];
+    out.format = data[4];
+    out.flags = data[5];
+    const size_t bodySize = (static_cast<size_t>(data[8]) << 24) | (static_cast<size_t>(data[9]) << 16) |
+                            (static_cast<size_t>(data[10]) << 8) | static_cast<size_t>(data[11]);
+    if (out.format != kTextureFormatEtc2Rgb8 || bodySize != etc2ImageSize(out.width, out.height)) {
+        return false;
+    }
+
+    const uint8_t* body = data + kTextureHeaderSize;
+    const size_t bodyBytes = size - kTextureHeaderSize;
+    if (out.flags & kTextureFlagLz4) {
+        scratch.resize(bodySize);
+        if (!lz4DecompressBlock(body, bodyBytes, scratch.data(), bodySize)) {
+            return false;
+        }
+        out.blocks = scratch.data();
+    } else {
+        if (bodyBytes != bodySize) {
+            return false;
+        }
+        out.blocks = body;
+    }
+    out.blocksSize = bodySize;
+    return true;
+}
+
+}  // namespace vrrenderer
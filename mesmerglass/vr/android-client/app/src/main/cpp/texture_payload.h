@@ -0,0 +1,43 @@
+/**
+ * VRHT texture payloads - ETC2 blocks for direct glCompressedTexImage2D upload
+ *
+ * Mirrors mesmerglass/mesmervisor/texture_codec.py:
+ *
+ *   width(2) height(2) format(1) flags(1) reserved(2) body_size(4)   big-endian
+ *   body: ETC2 RGB8 blocks, row-major, 8 bytes each; LZ4 block-compressed
+ *         when flags & kTextureFlagLz4 (body_size is the decompressed size)
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vrrenderer {
+
+constexpr uint8_t kTextureFormatEtc2Rgb8 = 1;
+constexpr uint8_t kTextureFlagLz4 = 0x1;
+constexpr size_t kTextureHeaderSize = 12;
+
+struct TexturePayload {
+    int width = 0;
+    int height = 0;
+    uint8_t format = 0;
+    uint8_t flags = 0;
+    const uint8_t* blocks = nullptr;  // points into the payload or the scratch buffer
+    size_t blocksSize = 0;
+};
+
+// Byte size of an ETC2 RGB8 image (4x4 blocks, 8 bytes each).
+size_t etc2ImageSize(int width, int height);
+
+// Decode an LZ4 block (no frame header) into exactly dstSize bytes.
+// Returns false on malformed input or size mismatch.
+bool lz4DecompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+// Parse and, if needed, decompress a payload. `scratch` is reused across calls
+// so steady-state parsing does not allocate.
+bool parseTexturePayload(const uint8_t* data, size_t size, std::vector<uint8_t>& scratch, TexturePayload& out);
+
+}  // namespace vrrenderer
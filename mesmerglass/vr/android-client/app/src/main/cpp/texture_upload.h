@@ -0,0 +1,28 @@
+/**
+ * Texture uploads shared by the JNI bridges (Android only)
+ *
+ * texture_jni.cpp owns the per-texture storage bookkeeping so VRHT frames and
+ * cached assets (asset_jni.cpp) can target the same eye textures without one
+ * reusing storage the other has reallocated. GL thread only.
+ */
+
+#pragma once
+
+#if defined(__ANDROID__)
+
+#include <GLES3/gl3.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vrrenderer {
+
+// ETC2 RGB8 blocks; reuses the texture's storage when the size is unchanged.
+bool uploadEtc2Texture(GLuint texture, int width, int height, const uint8_t* blocks, size_t size);
+
+// Tightly packed RGBA8 rows, top to bottom.
+bool uploadRgbaTexture(GLuint texture, int width, int height, const uint8_t* pixels);
+
+}  // namespace vrrenderer
+
+#endif  // __ANDROID__
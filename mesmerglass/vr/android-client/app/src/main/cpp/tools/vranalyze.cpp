@@ -0,0 +1,868 @@
+/**
+ * vranalyze - per-frame report for recorded VR streams
+ *
+ * Reads any of:
+ *   - a server .h264 / .h265 dump (dumps/vrh2_dump/vrh2_*.h264, Annex-B, no timing)
+ *   - a raw capture of the TCP stream (size-prefixed VRHP/VRH2/VRH3/VRH4/VRHT
+ *     packets, e.g. `nc <server> 5555 > stream.vrh`; VRH4 HEVC flag honoured)
+ *   - a pcap / pcapng capture (Ethernet, raw IP or Linux cooked), from which
+ *     the server->headset TCP flow is reassembled and timestamped
+ *
+ * and reports per frame: size, slice types, QP, IDR spacing, SPS/PPS changes,
+ * frame_id gaps, inter-arrival time and jitter, bitrate, and whether a simple
+ * decoder model predicts input backpressure beyond the client's
+ * inputMaxWaitUs (see VideoDecoder::Options).
+ *
+ *   vranalyze <file> [--fps N] [--port N] [--csv out.csv] [--json out.json]
+ *             [--decode-mbps N] [--decode-ms N] [--max-wait-ms N] [--hevc] [--quiet]
+ *
+ * HEVC frames report slice types from the NAL type only (I for IRAP pictures,
+ * P otherwise) and no QP; SPS/PPS change tracking works for both codecs.
+ *
+ * Files are memory-mapped and scanned once, so multi-hour captures take seconds.
+ */
+
+#include "../annexb.h"
+#include "../bitreader.h"
+#include "../h264_syntax.h"
+#include "../hevc_syntax.h"
+#include "../video_decoder.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using vrrenderer::annexb::Codec;
+using vrrenderer::annexb::NalUnit;
+
+// ---------------------------------------------------------------------------
+// Input
+
+class MappedFile {
+public:
+    explicit MappedFile(const char* path) {
+        fd_ = ::open(path, O_RDONLY);
+        if (fd_ < 0) {
+            return;
+        }
+        struct stat st;
+        if (::fstat(fd_, &st) != 0 || st.st_size <= 0) {
+            return;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) {
+            size_ = 0;
+            return;
+        }
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const uint8_t*>(p);
+    }
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    int fd_ = -1;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+uint16_t be16(const uint8_t* p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+uint32_t be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+uint32_t rd32(const uint8_t* p, bool swap) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return swap ? __builtin_bswap32(v) : v;
+}
+uint16_t rd16(const uint8_t* p, bool swap) {
+    uint16_t v;
+    std::memcpy(&v, p, 2);
+    return swap ? static_cast<uint16_t>(__builtin_bswap16(v)) : v;
+}
+
+bool isVrhMagic(const uint8_t* p) {
+    return p[0] == 'V' && p[1] == 'R' && p[2] == 'H' &&
+           (p[3] == 'P' || p[3] == 'T' || p[3] == '2' || p[3] == '3' || p[3] == '4');
+}
+
+size_t vrhHeaderSize(const uint8_t* magic) {
+    switch (magic[3]) {
+        case '3': return 20;
+        case '4': return 32;
+        default: return 16;
+    }
+}
+
+const uint32_t kVrh4FlagHevc = 0x00000002;  // streaming_server.VRH4_FLAG_HEVC
+
+bool endsWith(const std::string& s, const char* suffix) {
+    const size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Analysis
+
+struct Options {
+    double fps = 30.0;
+    int port = 5555;
+    double decodeMbps = 80.0;  // sustained decoder input rate the model assumes
+    double decodeMs = 6.0;     // fixed per-frame decode cost (both eyes share the codec)
+    double maxWaitMs = vrrenderer::VideoDecoder::Options().inputMaxWaitUs / 1000.0;
+    std::string csvPath;
+    std::string jsonPath;
+    bool hevc = false;  // Annex-B dumps only; VRH4 packets carry their own flag
+    bool quiet = false;
+};
+
+struct FrameRecord {
+    uint64_t index = 0;
+    int64_t frameId = -1;
+    std::string magic;
+    double arrivalMs = 0;
+    double interArrivalMs = -1;  // -1 when unknown (no timing in the source)
+    double jitterMs = 0;
+    uint32_t bytes = 0;
+    uint32_t rightBytes = 0;
+    std::string slices;
+    int qpMin = -1;
+    int qpMax = -1;
+    double qpAvg = -1;
+    bool idr = false;
+    bool spsChange = false;
+    bool ppsChange = false;
+    int64_t sinceIdr = -1;
+    int64_t idGap = 0;
+    double windowKbps = 0;
+    double backlogMs = 0;
+    bool risk = false;
+};
+
+class Analyzer {
+public:
+    explicit Analyzer(const Options& opts) : opts_(opts), periodMs_(1000.0 / opts.fps) {}
+
+    // One server packet (or one access unit for .h264 / .h265 dumps). arrivalMs < 0 = no timing.
+    void addFrame(const char* magic, int64_t frameId, double arrivalMs, const uint8_t* left, size_t leftSize,
+                  size_t rightSize, uint32_t fpsMilli, Codec codec = Codec::kH264) {
+        if (fpsMilli > 0) {
+            periodMs_ = 1e6 / fpsMilli;
+        }
+        FrameRecord r;
+        r.index = frames_.size();
+        r.frameId = frameId;
+        r.magic = magic;
+        r.bytes = static_cast<uint32_t>(leftSize);
+        r.rightBytes = static_cast<uint32_t>(rightSize);
+        const bool timed = arrivalMs >= 0;
+        r.arrivalMs = timed ? arrivalMs : static_cast<double>(r.index) * periodMs_;
+
+        if (r.magic != "VRHP" && r.magic != "VRHT") {
+            if (codec == Codec::kHevc) {
+                analyzeHevcAccessUnit(left, leftSize, &r);
+            } else {
+                analyzeAccessUnit(left, leftSize, &r);
+            }
+        }
+        if (r.idr) {
+            if (lastIdr_ >= 0) {
+                idrSpacing_.push_back(static_cast<double>(r.index - lastIdr_));
+            }
+            lastIdr_ = static_cast<int64_t>(r.index);
+        }
+        r.sinceIdr = lastIdr_ >= 0 ? static_cast<int64_t>(r.index) - lastIdr_ : -1;
+
+        if (frameId >= 0 && lastFrameId_ >= 0) {
+            r.idGap = frameId - lastFrameId_ - 1;
+            if (r.idGap != 0) {
+                gapEvents_++;
+                missingIds_ += r.idGap > 0 ? r.idGap : 0;
+            }
+        }
+        if (frameId >= 0) {
+            lastFrameId_ = frameId;
+        }
+
+        double sinceLast = periodMs_;
+        if (!frames_.empty()) {
+            sinceLast = r.arrivalMs - frames_.back().arrivalMs;
+            if (timed) {
+                r.interArrivalMs = sinceLast;
+                r.jitterMs = sinceLast - periodMs_;
+            }
+        }
+
+        // Rolling one-second bitrate of both eyes.
+        window_.push_back(std::make_pair(r.arrivalMs, static_cast<uint64_t>(r.bytes) + r.rightBytes));
+        windowBytes_ += static_cast<uint64_t>(r.bytes) + r.rightBytes;
+        while (!window_.empty() && window_.front().first <= r.arrivalMs - 1000.0) {
+            windowBytes_ -= window_.front().second;
+            window_.pop_front();
+        }
+        const double spanMs = std::max(periodMs_, r.arrivalMs - window_.front().first + periodMs_);
+        r.windowKbps = windowBytes_ * 8.0 / spanMs;
+
+        // Decoder model: input queue drains in real time and each frame costs a
+        // fixed setup plus its bits at the sustained decode rate.
+        const double costMs = opts_.decodeMs + (static_cast<double>(r.bytes) + r.rightBytes) * 8.0 /
+                                                   (opts_.decodeMbps * 1000.0);
+        backlogMs_ = std::max(0.0, backlogMs_ - std::max(0.0, sinceLast)) + costMs;
+        r.backlogMs = backlogMs_;
+        r.risk = backlogMs_ > opts_.maxWaitMs;
+        if (r.risk) {
+            risky_++;
+        }
+        frames_.push_back(std::move(r));
+    }
+
+    const std::vector<FrameRecord>& frames() const { return frames_; }
+
+    void report(const char* source, FILE* out) const;
+    bool writeCsv(const std::string& path) const;
+    bool writeJson(const std::string& path, const char* source) const;
+
+    uint64_t captureGaps = 0;  // TCP sequence holes in pcap input
+
+private:
+    void analyzeAccessUnit(const uint8_t* data, size_t len, FrameRecord* r) {
+        int qpSum = 0;
+        int qpCount = 0;
+        vrrenderer::annexb::forEachNal(data, len, [&](const NalUnit& nal) {
+            switch (nal.type) {
+                case vrrenderer::annexb::kNalSps: {
+                    vrrenderer::h264::Sps sps;
+                    if (vrrenderer::h264::parseSps(nal.data, nal.size, &sps)) {
+                        std::vector<uint8_t>& prev = spsBytes_[sps.id];
+                        if (!prev.empty() && (prev.size() != nal.size || !std::equal(prev.begin(), prev.end(), nal.data))) {
+                            r->spsChange = true;
+                            spsChanges_++;
+                        }
+                        prev.assign(nal.data, nal.data + nal.size);
+                        sps_[sps.id] = sps;
+                    }
+                    break;
+                }
+                case vrrenderer::annexb::kNalPps: {
+                    vrrenderer::h264::Pps pps;
+                    if (vrrenderer::h264::parsePps(nal.data, nal.size, &pps)) {
+                        std::vector<uint8_t>& prev = ppsBytes_[pps.id];
+                        if (!prev.empty() && (prev.size() != nal.size || !std::equal(prev.begin(), prev.end(), nal.data))) {
+                            r->ppsChange = true;
+                            ppsChanges_++;
+                        }
+                        prev.assign(nal.data, nal.data + nal.size);
+                        pps_[pps.id] = pps;
+                    }
+                    break;
+                }
+                case vrrenderer::annexb::kNalIdr:
+                case vrrenderer::annexb::kNalSlice: {
+                    r->idr = r->idr || nal.type == vrrenderer::annexb::kNalIdr;
+                    vrrenderer::h264::SliceHeader sh;
+                    if (!vrrenderer::h264::parseSliceHeaderPrefix(nal.data, nal.size, &sh)) {
+                        r->slices.push_back('?');
+                        break;
+                    }
+                    auto pps = pps_.find(sh.ppsId);
+                    if (pps != pps_.end()) {
+                        auto sps = sps_.find(pps->second.spsId);
+                        if (sps != sps_.end()) {
+                            vrrenderer::h264::parseSliceHeader(nal.data, nal.size, sps->second, pps->second, &sh);
+                        }
+                    }
+                    r->slices.push_back(vrrenderer::h264::sliceTypeChar(sh.sliceType));
+                    sliceHistogram_[vrrenderer::h264::sliceTypeChar(sh.sliceType)]++;
+                    if (sh.qp >= 0) {
+                        r->qpMin = r->qpMin < 0 ? sh.qp : std::min(r->qpMin, sh.qp);
+                        r->qpMax = std::max(r->qpMax, sh.qp);
+                        qpSum += sh.qp;
+                        qpCount++;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            return true;
+        });
+        if (qpCount > 0) {
+            r->qpAvg = static_cast<double>(qpSum) / qpCount;
+        }
+    }
+
+    // Parameter sets are tracked in their own maps, keyed by NAL type and id so
+    // an HEVC VPS/SPS/PPS never collides with another kind.
+    void noteParameterSet(std::map<int, std::vector<uint8_t>>* seen, int key, const NalUnit& nal, bool* changed,
+                          uint64_t* changes) {
+        std::vector<uint8_t>& prev = (*seen)[key];
+        if (!prev.empty() && (prev.size() != nal.size || !std::equal(prev.begin(), prev.end(), nal.data))) {
+            *changed = true;
+            (*changes)++;
+        }
+        prev.assign(nal.data, nal.data + nal.size);
+    }
+
+    void analyzeHevcAccessUnit(const uint8_t* data, size_t len, FrameRecord* r) {
+        namespace annexb = vrrenderer::annexb;
+        annexb::forEachNal(data, len, [&](const NalUnit& nal) {
+            if (nal.type == annexb::kHevcNalVps || nal.type == annexb::kHevcNalSps) {
+                int id = -1;
+                vrrenderer::hevc::Sps sps;
+                if (nal.type == annexb::kHevcNalSps && vrrenderer::hevc::parseSps(nal.data, nal.size, &sps)) {
+                    id = sps.id;
+                } else if (nal.type == annexb::kHevcNalVps && nal.size >= 3) {
+                    id = nal.data[2] >> 4;  // vps_video_parameter_set_id
+                }
+                if (id >= 0) {
+                    noteParameterSet(&hevcParamBytes_, (nal.type << 8) | id, nal, &r->spsChange, &spsChanges_);
+                }
+            } else if (nal.type == annexb::kHevcNalPps && nal.size >= 3) {
+                vrrenderer::BitReader br(nal.data + 2, nal.size - 2);
+                const int id = static_cast<int>(br.ue());
+                if (br.ok()) {
+                    noteParameterSet(&hevcParamBytes_, (nal.type << 8) | id, nal, &r->ppsChange, &ppsChanges_);
+                }
+            } else if (annexb::isVcl(nal.type, Codec::kHevc)) {
+                r->idr = r->idr || annexb::isIdr(nal.type, Codec::kHevc);
+                // IRAP pictures (BLA/IDR/CRA, types 16-23) are intra; slice_type needs the PPS, skip it.
+                const char type = (nal.type >= 16 && nal.type <= 23) ? 'I' : 'P';
+                r->slices.push_back(type);
+                sliceHistogram_[type]++;
+            }
+            return true;
+        }, Codec::kHevc);
+    }
+
+    Options opts_;
+    double periodMs_;
+    std::vector<FrameRecord> frames_;
+    std::map<int, vrrenderer::h264::Sps> sps_;
+    std::map<int, vrrenderer::h264::Pps> pps_;
+    std::map<int, std::vector<uint8_t>> spsBytes_;
+    std::map<int, std::vector<uint8_t>> ppsBytes_;
+    std::map<int, std::vector<uint8_t>> hevcParamBytes_;
+    std::map<char, uint64_t> sliceHistogram_;
+    std::vector<double> idrSpacing_;
+    std::deque<std::pair<double, uint64_t>> window_;
+    uint64_t windowBytes_ = 0;
+    int64_t lastIdr_ = -1;
+    int64_t lastFrameId_ = -1;
+    uint64_t gapEvents_ = 0;
+    int64_t missingIds_ = 0;
+    uint64_t spsChanges_ = 0;
+    uint64_t ppsChanges_ = 0;
+    uint64_t risky_ = 0;
+    double backlogMs_ = 0;
+};
+
+double mean(const std::vector<double>& v) {
+    double s = 0;
+    for (double x : v) {
+        s += x;
+    }
+    return v.empty() ? 0.0 : s / static_cast<double>(v.size());
+}
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) {
+        return 0;
+    }
+    size_t k = static_cast<size_t>(std::min<double>(v.size() - 1, std::floor(p * (v.size() - 1) + 0.5)));
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+    return v[k];
+}
+
+void Analyzer::report(const char* source, FILE* out) const {
+    std::fprintf(out, "source:        %s\n", source);
+    if (frames_.empty()) {
+        std::fprintf(out, "frames:        0\n");
+        return;
+    }
+    std::vector<double> sizes, arrivals, qps;
+    uint64_t totalBytes = 0;
+    double peakKbps = 0;
+    for (const FrameRecord& f : frames_) {
+        sizes.push_back(f.bytes);
+        totalBytes += static_cast<uint64_t>(f.bytes) + f.rightBytes;
+        peakKbps = std::max(peakKbps, f.windowKbps);
+        if (f.interArrivalMs >= 0) {
+            arrivals.push_back(f.interArrivalMs);
+        }
+        if (f.qpAvg >= 0) {
+            qps.push_back(f.qpAvg);
+        }
+    }
+    const double durationS = std::max(periodMs_, frames_.back().arrivalMs - frames_.front().arrivalMs + periodMs_) / 1000.0;
+    std::fprintf(out, "frames:        %zu over %.1f s (%s timing)\n", frames_.size(), durationS,
+                 arrivals.empty() ? "nominal" : "captured");
+    std::fprintf(out, "bytes:         %llu (avg %.0f kbps, peak 1 s window %.0f kbps)\n",
+                 static_cast<unsigned long long>(totalBytes), totalBytes * 8.0 / durationS / 1000.0, peakKbps);
+    std::fprintf(out, "frame size:    p50 %.0f  p95 %.0f  p99 %.0f  max %.0f bytes (left eye)\n",
+                 percentile(sizes, 0.5), percentile(sizes, 0.95), percentile(sizes, 0.99),
+                 *std::max_element(sizes.begin(), sizes.end()));
+    if (!sliceHistogram_.empty()) {
+        std::fprintf(out, "slices:       ");
+        for (const auto& kv : sliceHistogram_) {
+            std::fprintf(out, " %c:%llu", kv.first, static_cast<unsigned long long>(kv.second));
+        }
+        std::fprintf(out, "\n");
+    }
+    if (!qps.empty()) {
+        std::fprintf(out, "qp:            avg %.1f  min %.1f  max %.1f\n",
+                     mean(qps), *std::min_element(qps.begin(), qps.end()),
+                     *std::max_element(qps.begin(), qps.end()));
+    }
+    if (!idrSpacing_.empty()) {
+        std::fprintf(out, "idr spacing:   avg %.1f  min %.0f  max %.0f frames\n", mean(idrSpacing_),
+                     *std::min_element(idrSpacing_.begin(), idrSpacing_.end()),
+                     *std::max_element(idrSpacing_.begin(), idrSpacing_.end()));
+    }
+    std::fprintf(out, "sps/pps:       %llu / %llu changes\n", static_cast<unsigned long long>(spsChanges_),
+                 static_cast<unsigned long long>(ppsChanges_));
+    std::fprintf(out, "frame_id gaps: %llu (%lld ids missing)\n", static_cast<unsigned long long>(gapEvents_),
+                 static_cast<long long>(missingIds_));
+    if (!arrivals.empty()) {
+        const double avg = mean(arrivals);
+        double var = 0;
+        for (double a : arrivals) {
+            var += (a - avg) * (a - avg);
+        }
+        std::fprintf(out, "inter-arrival: p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms (jitter sd %.2f ms)\n",
+                     percentile(arrivals, 0.5), percentile(arrivals, 0.95), percentile(arrivals, 0.99),
+                     *std::max_element(arrivals.begin(), arrivals.end()), std::sqrt(var / arrivals.size()));
+    }
+    if (captureGaps > 0) {
+        std::fprintf(out, "capture gaps:  %llu TCP holes (frames lost from the capture, not the stream)\n",
+                     static_cast<unsigned long long>(captureGaps));
+    }
+    std::fprintf(out, "backpressure:  %llu frames over %.0f ms modelled decoder backlog", static_cast<unsigned long long>(risky_),
+                 opts_.maxWaitMs);
+    int shown = 0;
+    for (const FrameRecord& f : frames_) {
+        if (f.risk && shown < 8) {
+            std::fprintf(out, "%s#%llu", shown == 0 ? " (first: " : " ", static_cast<unsigned long long>(f.index));
+            shown++;
+        }
+    }
+    std::fprintf(out, "%s\n", shown ? ")" : "");
+}
+
+const char* kCsvHeader =
+    "index,frame_id,magic,arrival_ms,inter_arrival_ms,jitter_ms,bytes,right_bytes,slices,qp_min,qp_avg,qp_max,"
+    "idr,since_idr,sps_change,pps_change,id_gap,window_kbps,backlog_ms,backpressure_risk\n";
+
+bool Analyzer::writeCsv(const std::string& path) const {
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        return false;
+    }
+    std::fputs(kCsvHeader, f);
+    for (const FrameRecord& r : frames_) {
+        std::fprintf(f, "%llu,%lld,%s,%.3f,%.3f,%.3f,%u,%u,%s,%d,%.2f,%d,%d,%lld,%d,%d,%lld,%.1f,%.2f,%d\n",
+                     static_cast<unsigned long long>(r.index), static_cast<long long>(r.frameId), r.magic.c_str(),
+                     r.arrivalMs, r.interArrivalMs, r.jitterMs, r.bytes, r.rightBytes, r.slices.c_str(), r.qpMin,
+                     r.qpAvg, r.qpMax, r.idr ? 1 : 0, static_cast<long long>(r.sinceIdr), r.spsChange ? 1 : 0,
+                     r.ppsChange ? 1 : 0, static_cast<long long>(r.idGap), r.windowKbps, r.backlogMs, r.risk ? 1 : 0);
+    }
+    return std::fclose(f) == 0;
+}
+
+bool Analyzer::writeJson(const std::string& path, const char* source) const {
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        return false;
+    }
+    std::string src;
+    for (const char* p = source; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            src.push_back('\\');
+        }
+        src.push_back(*p);
+    }
+    std::fprintf(f, "{\"source\":\"%s\",\"period_ms\":%.4f,\"max_wait_ms\":%.1f,\"capture_gaps\":%llu,\"frames\":[\n",
+                 src.c_str(), periodMs_, opts_.maxWaitMs, static_cast<unsigned long long>(captureGaps));
+    for (size_t i = 0; i < frames_.size(); i++) {
+        const FrameRecord& r = frames_[i];
+        std::fprintf(f,
+                     "{\"index\":%llu,\"frame_id\":%lld,\"magic\":\"%s\",\"arrival_ms\":%.3f,\"inter_arrival_ms\":%.3f,"
+                     "\"jitter_ms\":%.3f,\"bytes\":%u,\"right_bytes\":%u,\"slices\":\"%s\",\"qp_min\":%d,\"qp_avg\":%.2f,"
+                     "\"qp_max\":%d,\"idr\":%s,\"since_idr\":%lld,\"sps_change\":%s,\"pps_change\":%s,\"id_gap\":%lld,"
+                     "\"window_kbps\":%.1f,\"backlog_ms\":%.2f,\"backpressure_risk\":%s}%s\n",
+                     static_cast<unsigned long long>(r.index), static_cast<long long>(r.frameId), r.magic.c_str(),
+                     r.arrivalMs, r.interArrivalMs, r.jitterMs, r.bytes, r.rightBytes, r.slices.c_str(), r.qpMin,
+                     r.qpAvg, r.qpMax, r.idr ? "true" : "false", static_cast<long long>(r.sinceIdr),
+                     r.spsChange ? "true" : "false", r.ppsChange ? "true" : "false", static_cast<long long>(r.idGap),
+                     r.windowKbps, r.backlogMs, r.risk ? "true" : "false", i + 1 < frames_.size() ? "," : "");
+    }
+    std::fputs("]}\n", f);
+    return std::fclose(f) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// VRH packet stream (raw capture or reassembled TCP payload)
+
+class PacketStream {
+public:
+    explicit PacketStream(Analyzer* analyzer) : analyzer_(analyzer) {}
+
+    // Parse as many whole packets as `data` holds; returns bytes consumed.
+    size_t feed(const uint8_t* data, size_t len, double arrivalMs) {
+        size_t pos = 0;
+        while (len - pos >= 8) {
+            if (!isVrhMagic(data + pos + 4)) {
+                // Lost sync (capture started mid-packet or a TCP hole): find the next magic.
+                size_t next = resync(data, len, pos + 1);
+                if (next == len) {
+                    return len > 8 ? len - 8 : pos;
+                }
+                pos = next;
+                continue;
+            }
+            const uint32_t size = be32(data + pos);
+            const uint8_t* pkt = data + pos + 4;
+            const size_t header = vrhHeaderSize(pkt);
+            if (size < header || size > (256u << 20)) {
+                pos++;
+                continue;
+            }
+            if (len - pos - 4 < size) {
+                break;  // wait for the rest
+            }
+            const uint32_t frameId = be32(pkt + 4);
+            const uint32_t leftSize = be32(pkt + 8);
+            const uint32_t rightSize = be32(pkt + 12);
+            const uint32_t fpsMilli = header >= 20 ? be32(pkt + 16) : 0;
+            const uint32_t flags = header >= 32 ? be32(pkt + 20) : 0;
+            const Codec codec = (flags & kVrh4FlagHevc) ? Codec::kHevc : Codec::kH264;
+            if (header + static_cast<size_t>(leftSize) + rightSize <= size) {
+                char magic[5] = {static_cast<char>(pkt[0]), static_cast<char>(pkt[1]), static_cast<char>(pkt[2]),
+                                 static_cast<char>(pkt[3]), 0};
+                analyzer_->addFrame(magic, frameId, arrivalMs, pkt + header, leftSize, rightSize, fpsMilli, codec);
+            }
+            pos += 4 + size;
+        }
+        return pos;
+    }
+
+private:
+    static size_t resync(const uint8_t* data, size_t len, size_t from) {
+        for (size_t i = from; i + 8 <= len; i++) {
+            const void* v = std::memchr(data + i + 4, 'V', len - i - 4);
+            if (v == nullptr) {
+                break;
+            }
+            i = static_cast<size_t>(static_cast<const uint8_t*>(v) - data) - 4;
+            if (i + 8 <= len && isVrhMagic(data + i + 4)) {
+                return i;
+            }
+        }
+        return len;
+    }
+
+    Analyzer* analyzer_;
+};
+
+// ---------------------------------------------------------------------------
+// pcap / pcapng
+
+class TcpFlow {
+public:
+    TcpFlow(Analyzer* analyzer, int port) : analyzer_(analyzer), stream_(analyzer), port_(port) {}
+
+    void onLinkFrame(int linkType, const uint8_t* p, size_t len, double tsMs) {
+        size_t off = 0;
+        int etherType = 0;
+        if (linkType == 1) {  // Ethernet
+            if (len < 14) return;
+            etherType = be16(p + 12);
+            off = 14;
+            while (etherType == 0x8100 && len >= off + 4) {  // VLAN
+                etherType = be16(p + off + 2);
+                off += 4;
+            }
+        } else if (linkType == 113) {  // Linux cooked v1
+            if (len < 16) return;
+            etherType = be16(p + 14);
+            off = 16;
+        } else if (linkType == 276) {  // Linux cooked v2
+            if (len < 20) return;
+            etherType = be16(p);
+            off = 20;
+        } else if (linkType == 101 || linkType == 12 || linkType == 228 || linkType == 229) {  // raw IP
+            if (len < 1) return;
+            etherType = (p[0] >> 4) == 6 ? 0x86DD : 0x0800;
+        } else {
+            return;
+        }
+        onIp(etherType, p + off, len - off, tsMs);
+    }
+
+private:
+    void onIp(int etherType, const uint8_t* p, size_t len, double tsMs) {
+        size_t ipHeader = 0;
+        size_t ipTotal = len;
+        std::string key;
+        if (etherType == 0x0800) {
+            if (len < 20 || p[9] != 6) return;  // TCP only
+            ipHeader = static_cast<size_t>(p[0] & 0x0F) * 4;
+            ipTotal = std::min<size_t>(len, be16(p + 2));
+            key.assign(reinterpret_cast<const char*>(p + 12), 8);
+        } else if (etherType == 0x86DD) {
+            if (len < 40 || p[6] != 6) return;  // TCP without extension headers
+            ipHeader = 40;
+            ipTotal = std::min<size_t>(len, 40u + be16(p + 4));
+            key.assign(reinterpret_cast<const char*>(p + 8), 32);
+        } else {
+            return;
+        }
+        if (ipTotal < ipHeader + 20) return;
+        const uint8_t* tcp = p + ipHeader;
+        const int srcPort = be16(tcp);
+        if (srcPort != port_) return;
+        key.append(reinterpret_cast<const char*>(tcp), 4);
+        const size_t tcpHeader = static_cast<size_t>(tcp[12] >> 4) * 4;
+        if (ipTotal < ipHeader + tcpHeader) return;
+        const uint32_t seq = be32(tcp + 4);
+        const bool syn = (tcp[13] & 0x02) != 0;
+        const uint8_t* payload = tcp + tcpHeader;
+        const size_t payloadLen = ipTotal - ipHeader - tcpHeader;
+
+        // Follow the first server->headset flow seen.
+        if (flowKey_.empty()) {
+            flowKey_ = key;
+        } else if (key != flowKey_) {
+            return;
+        }
+        if (syn) {
+            nextSeq_ = seq + 1;
+            haveSeq_ = true;
+            return;
+        }
+        if (payloadLen == 0) return;
+        if (!haveSeq_) {
+            nextSeq_ = seq;
+            haveSeq_ = true;
+        }
+        const int32_t delta = static_cast<int32_t>(seq - nextSeq_);
+        size_t skip = 0;
+        if (delta < 0) {
+            // Retransmission, possibly overlapping new data.
+            if (static_cast<size_t>(-static_cast<int64_t>(delta)) >= payloadLen) return;
+            skip = static_cast<size_t>(-static_cast<int64_t>(delta));
+        } else if (delta > 0) {
+            // Hole in the capture: drop partial data and resync on the next packet header.
+            analyzer_->captureGaps++;
+            buffer_.clear();
+        }
+        buffer_.insert(buffer_.end(), payload + skip, payload + payloadLen);
+        nextSeq_ = seq + static_cast<uint32_t>(payloadLen);
+
+        const size_t used = stream_.feed(buffer_.data(), buffer_.size(), tsMs);
+        if (used > 0) {
+            buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(used));
+        }
+    }
+
+    Analyzer* analyzer_;
+    PacketStream stream_;
+    int port_;
+    std::string flowKey_;
+    uint32_t nextSeq_ = 0;
+    bool haveSeq_ = false;
+    std::vector<uint8_t> buffer_;
+};
+
+bool readPcap(const uint8_t* d, size_t n, TcpFlow* flow) {
+    const uint32_t magic = rd32(d, false);
+    bool swap = false;
+    bool nanos = false;
+    if (magic == 0xA1B2C3D4u || magic == 0xA1B23C4Du) {
+        nanos = magic == 0xA1B23C4Du;
+    } else if (magic == 0xD4C3B2A1u || magic == 0x4D3CB2A1u) {
+        swap = true;
+        nanos = magic == 0x4D3CB2A1u;
+    } else {
+        return false;
+    }
+    const int linkType = static_cast<int>(rd32(d + 20, swap) & 0xFFFF);
+    double t0 = -1;
+    for (size_t pos = 24; pos + 16 <= n;) {
+        const double ts = rd32(d + pos, swap) * 1000.0 + rd32(d + pos + 4, swap) / (nanos ? 1e6 : 1e3);
+        const uint32_t capLen = rd32(d + pos + 8, swap);
+        pos += 16;
+        if (capLen > n - pos) break;
+        if (t0 < 0) t0 = ts;
+        flow->onLinkFrame(linkType, d + pos, capLen, ts - t0);
+        pos += capLen;
+    }
+    return true;
+}
+
+bool readPcapng(const uint8_t* d, size_t n, TcpFlow* flow) {
+    bool swap = false;
+    std::vector<std::pair<int, double>> interfaces;  // (link type, seconds per tick)
+    double t0 = -1;
+    for (size_t pos = 0; pos + 12 <= n;) {
+        uint32_t type = rd32(d + pos, swap);
+        if (type == 0x0A0D0D0Au) {
+            const uint32_t bom = rd32(d + pos + 8, false);
+            swap = bom == 0x4D3C2B1Au;
+            interfaces.clear();
+        }
+        const uint32_t blockLen = rd32(d + pos + 4, swap);
+        if (blockLen < 12 || blockLen > n - pos) break;
+        const uint8_t* body = d + pos + 8;
+        const size_t bodyLen = blockLen - 12;
+        if (type == 1 && bodyLen >= 8) {  // Interface Description Block
+            double tick = 1e-6;
+            for (size_t o = 8; o + 4 <= bodyLen;) {
+                const uint16_t code = rd16(body + o, swap);
+                const uint16_t olen = rd16(body + o + 2, swap);
+                if (code == 0) break;
+                if (code == 9 && olen >= 1 && o + 5 <= bodyLen) {  // if_tsresol
+                    const uint8_t r = body[o + 4];
+                    tick = (r & 0x80) ? std::pow(2.0, -static_cast<double>(r & 0x7F)) : std::pow(10.0, -static_cast<double>(r));
+                }
+                o += 4 + ((olen + 3u) & ~3u);
+            }
+            interfaces.emplace_back(rd16(body, swap), tick);
+        } else if (type == 6 && bodyLen >= 20) {  // Enhanced Packet Block
+            const uint32_t iface = rd32(body, swap);
+            const uint64_t ticks = (static_cast<uint64_t>(rd32(body + 4, swap)) << 32) | rd32(body + 8, swap);
+            const uint32_t capLen = rd32(body + 12, swap);
+            if (iface < interfaces.size() && capLen <= bodyLen - 20) {
+                const double ts = static_cast<double>(ticks) * interfaces[iface].second * 1000.0;
+                if (t0 < 0) t0 = ts;
+                flow->onLinkFrame(interfaces[iface].first, body + 20, capLen, ts - t0);
+            }
+        }
+        pos += blockLen;
+    }
+    return true;
+}
+
+int usage(const char* argv0, FILE* out = stderr) {
+    std::fprintf(out,
+                 "usage: %s <dump.h264|dump.h265|stream.vrh|capture.pcap[ng]> [--fps N] [--port N] [--csv out.csv]\n"
+                 "       [--json out.json] [--decode-mbps N] [--decode-ms N] [--max-wait-ms N] [--hevc] [--quiet]\n",
+                 argv0);
+    return out == stderr ? 2 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            return usage(argv[0], stdout);
+        }
+    }
+    if (argc < 2 || argv[1][0] == '-') {
+        return usage(argv[0]);
+    }
+    const char* path = argv[1];
+    Options opts;
+    opts.hevc = endsWith(path, ".h265") || endsWith(path, ".hevc");
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : ""; };
+        if (arg == "--fps") {
+            opts.fps = std::atof(next());
+        } else if (arg == "--port") {
+            opts.port = std::atoi(next());
+        } else if (arg == "--csv") {
+            opts.csvPath = next();
+        } else if (arg == "--json") {
+            opts.jsonPath = next();
+        } else if (arg == "--decode-mbps") {
+            opts.decodeMbps = std::atof(next());
+        } else if (arg == "--decode-ms") {
+            opts.decodeMs = std::atof(next());
+        } else if (arg == "--max-wait-ms") {
+            opts.maxWaitMs = std::atof(next());
+        } else if (arg == "--hevc") {
+            opts.hevc = true;
+        } else if (arg == "--quiet") {
+            opts.quiet = true;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (opts.fps <= 0) {
+        opts.fps = 30.0;
+    }
+    if (opts.decodeMbps <= 0) {
+        opts.decodeMbps = 80.0;
+    }
+
+    MappedFile file(path);
+    if (file.data() == nullptr) {
+        std::fprintf(stderr, "cannot read %s\n", path);
+        return 1;
+    }
+    const uint8_t* d = file.data();
+    const size_t n = file.size();
+
+    Analyzer analyzer(opts);
+    const uint32_t lead = n >= 4 ? rd32(d, false) : 0;
+    if (n >= 24 && (lead == 0xA1B2C3D4u || lead == 0xD4C3B2A1u || lead == 0xA1B23C4Du || lead == 0x4D3CB2A1u)) {
+        TcpFlow flow(&analyzer, opts.port);
+        readPcap(d, n, &flow);
+    } else if (n >= 12 && lead == 0x0A0D0D0Au) {
+        TcpFlow flow(&analyzer, opts.port);
+        readPcapng(d, n, &flow);
+    } else if (n >= 8 && isVrhMagic(d + 4)) {
+        PacketStream stream(&analyzer);
+        stream.feed(d, n, -1.0);
+    } else if (vrrenderer::annexb::hasStartCode(d, n)) {
+        const Codec codec = opts.hevc ? Codec::kHevc : Codec::kH264;
+        vrrenderer::annexb::forEachAccessUnit(d, n, [&](const uint8_t* begin, const uint8_t* end) {
+            analyzer.addFrame(opts.hevc ? "H265" : "H264", -1, -1.0, begin, static_cast<size_t>(end - begin), 0, 0,
+                              codec);
+            return true;
+        }, codec);
+    } else {
+        std::fprintf(stderr, "%s: not an Annex-B dump, VRH stream or pcap capture\n", path);
+        return 1;
+    }
+
+    if (!opts.quiet) {
+        analyzer.report(path, stdout);
+    }
+    if (!opts.csvPath.empty() && !analyzer.writeCsv(opts.csvPath)) {
+        std::fprintf(stderr, "cannot write %s\n", opts.csvPath.c_str());
+        return 1;
+    }
+    if (!opts.jsonPath.empty() && !analyzer.writeJson(opts.jsonPath, path)) {
+        std::fprintf(stderr, "cannot write %s\n", opts.jsonPath.c_str());
+        return 1;
+    }
+    return analyzer.frames().empty() ? 1 : 0;
+}
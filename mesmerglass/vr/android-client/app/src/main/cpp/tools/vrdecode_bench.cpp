@@ -0,0 +1,167 @@
+/**
+ * vrdecode_bench - replay a recorded H.264 / HEVC dump through VideoDecoder on a host
+ *
+ * Feeds the access units of a server dump (vrh2_*.h264, or .h265 for HEVC
+ * clients, under dumps/vrh2_dump) to the same queueing, resync and pacing
+ * pipeline the headset uses, with the FFmpeg backend when built with it and the
+ * null backend otherwise.
+ *
+ *   vrdecode_bench <dump.h264|dump.h265> [--fps N] [--realtime] [--pace] [--hevc]
+ *                  [--backend ffmpeg|null] [--threads N] [--drop-every N]
+ *
+ * HEVC is assumed for .h265 / .hevc files; --hevc forces it for other names.
+ * --drop-every N discards every Nth access unit before submit to exercise the
+ * resync path; the report shows how many frames were lost waiting for IDRs.
+ */
+
+#include "../annexb.h"
+#include "../video_decoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s <dump.h264|dump.h265> [--fps N] [--realtime] [--pace] [--hevc] [--backend ffmpeg|null] "
+                 "[--threads N] [--drop-every N]\n",
+                 argv0);
+    return 2;
+}
+
+bool endsWith(const std::string& s, const char* suffix) {
+    const size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return usage(argv[0]);
+    }
+    std::string path = argv[1];
+    double fps = 30.0;
+    bool realtime = false;
+    bool pace = false;
+    int threads = 2;
+    int dropEvery = 0;
+    bool hevc = endsWith(path, ".h265") || endsWith(path, ".hevc");
+#if defined(VRRENDERER_WITH_FFMPEG)
+    std::string backendName = "ffmpeg";
+#else
+    std::string backendName = "null";
+#endif
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : ""; };
+        if (arg == "--fps") {
+            fps = std::atof(next());
+        } else if (arg == "--realtime") {
+            realtime = true;
+        } else if (arg == "--pace") {
+            pace = true;
+        } else if (arg == "--hevc") {
+            hevc = true;
+        } else if (arg == "--backend") {
+            backendName = next();
+        } else if (arg == "--threads") {
+            threads = std::atoi(next());
+        } else if (arg == "--drop-every") {
+            dropEvery = std::atoi(next());
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (fps <= 0) {
+        fps = 30.0;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return 1;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const int64_t splitStart = nowNs();
+    const vrrenderer::annexb::Codec codec = hevc ? vrrenderer::annexb::Codec::kHevc : vrrenderer::annexb::Codec::kH264;
+    std::vector<std::vector<uint8_t>> units = vrrenderer::annexb::splitAccessUnits(bytes.data(), bytes.size(), codec);
+    const double splitMs = (nowNs() - splitStart) / 1e6;
+    if (units.empty()) {
+        std::fprintf(stderr, "%s: no access units found\n", path.c_str());
+        return 1;
+    }
+
+    std::unique_ptr<vrrenderer::DecoderBackend> backend;
+    if (backendName == "null") {
+        backend = vrrenderer::createNullBackend();
+#if defined(VRRENDERER_WITH_FFMPEG)
+    } else if (backendName == "ffmpeg") {
+        backend = vrrenderer::createFFmpegBackend(threads, false);
+#endif
+    } else {
+        std::fprintf(stderr, "backend '%s' not built in\n", backendName.c_str());
+        return 2;
+    }
+    (void)threads;
+
+    vrrenderer::VideoDecoder::Options opts;
+    opts.pace = pace;
+    opts.codec = codec;
+    // Offline replay submits faster than real time; size the queue so the
+    // bench measures decode throughput, not overflow resyncs.
+    opts.queueMaxFrames = realtime ? opts.queueMaxFrames : units.size() + 1;
+    vrrenderer::VideoDecoder decoder(std::move(backend), opts);
+    decoder.start();
+
+    const int64_t frameNs = static_cast<int64_t>(1e9 / fps);
+    const int64_t start = nowNs();
+    size_t skipped = 0;
+    for (size_t i = 0; i < units.size(); i++) {
+        if (realtime) {
+            const int64_t due = start + static_cast<int64_t>(i) * frameNs;
+            const int64_t wait = due - nowNs();
+            if (wait > 0) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+            }
+        }
+        if (dropEvery > 0 && i > 0 && i % static_cast<size_t>(dropEvery) == 0) {
+            skipped++;
+            decoder.requestResync("bench_drop");
+            continue;
+        }
+        const int64_t ptsUs = static_cast<int64_t>(i) * frameNs / 1000;
+        decoder.submit(units[i].data(), units[i].size(), ptsUs);
+    }
+    decoder.drain(5000);
+    const double wallS = (nowNs() - start) / 1e9;
+    const vrrenderer::DecoderStats s = decoder.stats();
+    decoder.stop();
+
+    const double avgLatencyMs = s.decoded ? (s.sumLatencyUs / 1000.0) / static_cast<double>(s.decoded) : 0.0;
+    std::printf("file:          %s (%zu bytes)\n", path.c_str(), bytes.size());
+    std::printf("backend:       %s %s%s\n", decoder.backendName(), hevc ? "hevc" : "h264", realtime ? " (realtime)" : "");
+    std::printf("access units:  %zu (split %.2f ms)\n", units.size(), splitMs);
+    std::printf("decoded:       %llu in %.3f s (%.1f fps)\n", static_cast<unsigned long long>(s.decoded), wallS,
+                wallS > 0 ? s.decoded / wallS : 0.0);
+    std::printf("latency:       avg %.2f ms, max %.2f ms\n", avgLatencyMs, s.maxLatencyUs / 1000.0);
+    std::printf("dropped:       %llu (+%zu skipped), resyncs %llu, flushes %llu, late %llu\n",
+                static_cast<unsigned long long>(s.dropped), skipped, static_cast<unsigned long long>(s.resyncs),
+                static_cast<unsigned long long>(s.flushes), static_cast<unsigned long long>(s.late));
+    return s.decoded > 0 ? 0 : 1;
+}
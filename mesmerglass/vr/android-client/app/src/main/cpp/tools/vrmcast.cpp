@@ -0,0 +1,304 @@
+/**
+ * vrmcast - a room of multicast headsets on one Linux box
+ *
+ * Opens N control connections to a server running in multicast mode
+ * (`vr-test --multicast`), waits for each one's VRHC JOIN, joins the group with
+ * N sockets and reassembles with the headset's MulticastReassembler. REPAIR and
+ * NEED_IDR go back on each receiver's own TCP connection, as on the headset.
+ * --loss drops that share of datagrams per receiver, independently, to exercise
+ * FEC and repair.
+ *
+ *   vrmcast <server> [--port 5555] [--receivers N] [--seconds S] [--loss PCT]
+ *           [--interface ADDR] [--seed N]
+ *
+ * Prints per receiver: frames, fps, frames rebuilt with parity, frames completed
+ * by a repair, frames lost, repair requests and datagrams received. Every
+ * receiver is sent the same datagrams once, so the server's bitrate does not
+ * grow with N; use --interface 127.0.0.1 when the server sends on loopback.
+ */
+
+#include "../multicast_rx.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint8_t kControlJoin = 0x05;
+constexpr uint8_t kNeedIdr = 0x01;
+constexpr uint8_t kRepair = 0x04;
+
+int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+uint32_t be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+struct Receiver {
+    int control = -1;
+    int group = -1;
+    std::vector<uint8_t> inbox;  // partial control packets
+    vrrenderer::MulticastReassembler* reassembler = nullptr;
+    std::mt19937 rng;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    uint64_t badPackets = 0;
+    uint64_t keyframeRequests = 0;
+    uint64_t datagramsSeen = 0;
+};
+
+int connectControl(const char* host, int port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (fd < 0 || ::inet_pton(AF_INET, host, &addr.sin_addr) != 1 ||
+        ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return -1;
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+int joinGroup(const uint8_t* group, uint16_t port, const char* interface) {
+    const int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    int rcvbuf = 4 * 1024 * 1024;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    ip_mreq mreq{};
+    std::memcpy(&mreq.imr_multiaddr.s_addr, group, 4);
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (interface != nullptr) {
+        ::inet_pton(AF_INET, interface, &mreq.imr_interface);
+    }
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+        std::perror("join");
+        ::close(fd);
+        return -1;
+    }
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+void sendControl(Receiver& rx, const uint8_t* message, size_t len) {
+    if (::send(rx.control, message, len, MSG_NOSIGNAL) != static_cast<ssize_t>(len)) {
+        std::fprintf(stderr, "control send failed\n");
+    }
+}
+
+// Reads control packets; the first JOIN joins the group. Returns false on EOF.
+bool readControl(Receiver& rx, const char* interface) {
+    uint8_t buf[4096];
+    const ssize_t n = ::recv(rx.control, buf, sizeof(buf), 0);
+    if (n <= 0) {
+        return false;
+    }
+    rx.inbox.insert(rx.inbox.end(), buf, buf + n);
+    while (rx.inbox.size() >= 4) {
+        const uint32_t size = be32(rx.inbox.data());
+        if (rx.inbox.size() < 4 + static_cast<size_t>(size)) {
+            break;
+        }
+        const uint8_t* packet = rx.inbox.data() + 4;
+        const bool join = size >= 25 && std::memcmp(packet, "VRHC", 4) == 0 && packet[16] == kControlJoin;
+        if (join && rx.group < 0) {
+            const uint16_t port = static_cast<uint16_t>((packet[21] << 8) | packet[22]);
+            const int epoch = (packet[23] << 8) | packet[24];
+            rx.group = joinGroup(packet + 17, port, interface);
+            rx.reassembler = new vrrenderer::MulticastReassembler(epoch);
+        } else if (!join && std::memcmp(packet, "VRHC", 4) != 0) {
+            std::fprintf(stderr, "frame packet on the control connection; is the server in multicast mode?\n");
+        }
+        rx.inbox.erase(rx.inbox.begin(), rx.inbox.begin() + 4 + size);
+    }
+    return true;
+}
+
+void readGroup(Receiver& rx, double loss) {
+    uint8_t datagram[65536];
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    for (;;) {
+        const ssize_t n = ::recv(rx.group, datagram, sizeof(datagram), 0);
+        if (n <= 0) {
+            return;
+        }
+        rx.datagramsSeen++;
+        if (loss > 0 && coin(rx.rng) < loss) {
+            continue;
+        }
+        rx.reassembler->push(datagram, static_cast<size_t>(n), nowUs());
+    }
+}
+
+void service(Receiver& rx) {
+    const int64_t now = nowUs();
+    rx.reassembler->poll(now);
+    std::vector<vrrenderer::RepairRequest> requests;
+    rx.reassembler->repairRequests(now, requests);
+    for (const auto& request : requests) {
+        const uint8_t message[8] = {
+            kRepair,
+            static_cast<uint8_t>(request.seq >> 24), static_cast<uint8_t>(request.seq >> 16),
+            static_cast<uint8_t>(request.seq >> 8), static_cast<uint8_t>(request.seq),
+            static_cast<uint8_t>(request.block >> 8), static_cast<uint8_t>(request.block),
+            request.count,
+        };
+        sendControl(rx, message, sizeof(message));
+    }
+    if (rx.reassembler->takeKeyframeRequest()) {
+        sendControl(rx, &kNeedIdr, 1);
+        rx.keyframeRequests++;
+    }
+    std::vector<uint8_t> packet;
+    while (rx.reassembler->popPacket(packet)) {
+        // The reassembled bytes are exactly what the TCP path would have carried.
+        if (packet.size() < 20 || be32(packet.data()) + 4 != packet.size() || std::memcmp(packet.data() + 4, "VRH", 3) != 0) {
+            rx.badPackets++;
+            continue;
+        }
+        rx.frames++;
+        rx.bytes += packet.size();
+    }
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s <server> [--port 5555] [--receivers N] [--seconds S] [--loss PCT] "
+                 "[--interface ADDR] [--seed N]\n",
+                 argv0);
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return usage(argv[0]);
+    }
+    const char* host = argv[1];
+    int port = 5555;
+    int count = 4;
+    double seconds = 5.0;
+    double loss = 0.0;
+    const char* interface = nullptr;
+    unsigned seed = 1;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : ""; };
+        if (arg == "--port") {
+            port = std::atoi(next());
+        } else if (arg == "--receivers") {
+            count = std::atoi(next());
+        } else if (arg == "--seconds") {
+            seconds = std::atof(next());
+        } else if (arg == "--loss") {
+            loss = std::atof(next()) / 100.0;
+        } else if (arg == "--interface") {
+            interface = next();
+        } else if (arg == "--seed") {
+            seed = static_cast<unsigned>(std::atoi(next()));
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (count <= 0) {
+        return usage(argv[0]);
+    }
+
+    std::vector<Receiver> receivers(count);
+    for (int r = 0; r < count; r++) {
+        receivers[r].control = connectControl(host, port);
+        receivers[r].rng.seed(seed + r);
+        if (receivers[r].control < 0) {
+            std::fprintf(stderr, "cannot connect to %s:%d\n", host, port);
+            return 1;
+        }
+    }
+
+    const int64_t start = nowUs();
+    const int64_t end = start + static_cast<int64_t>(seconds * 1e6);
+    int exitCode = 0;
+    while (nowUs() < end) {
+        std::vector<pollfd> fds;
+        for (const Receiver& rx : receivers) {
+            fds.push_back({rx.control, POLLIN, 0});
+            if (rx.group >= 0) {
+                fds.push_back({rx.group, POLLIN, 0});
+            }
+        }
+        ::poll(fds.data(), fds.size(), 2);
+        size_t f = 0;
+        for (Receiver& rx : receivers) {
+            if (fds[f++].revents & (POLLIN | POLLHUP)) {
+                if (!readControl(rx, interface)) {
+                    std::fprintf(stderr, "server closed a control connection\n");
+                    exitCode = 1;
+                    goto done;
+                }
+            }
+            if (rx.group >= 0) {
+                if (fds[f++].revents & POLLIN) {
+                    readGroup(rx, loss);
+                }
+                service(rx);
+            }
+        }
+    }
+done:
+    const double elapsed = (nowUs() - start) / 1e6;
+    std::printf("%-4s %8s %7s %9s %8s %6s %8s %10s %8s\n", "rx", "frames", "fps", "recovered", "repaired", "lost",
+                "requests", "datagrams", "Mbps");
+    for (int r = 0; r < count; r++) {
+        Receiver& rx = receivers[r];
+        if (rx.reassembler == nullptr) {
+            std::printf("%-4d never received JOIN\n", r);
+            exitCode = 1;
+            continue;
+        }
+        const vrrenderer::MulticastStats& s = rx.reassembler->stats();
+        std::printf("%-4d %8llu %7.1f %9llu %8llu %6llu %8llu %10llu %8.2f\n", r,
+                    static_cast<unsigned long long>(rx.frames), rx.frames / elapsed,
+                    static_cast<unsigned long long>(s.recovered), static_cast<unsigned long long>(s.repaired),
+                    static_cast<unsigned long long>(s.lost), static_cast<unsigned long long>(s.requests),
+                    static_cast<unsigned long long>(rx.datagramsSeen), rx.bytes * 8 / elapsed / 1e6);
+        if (rx.badPackets != 0) {
+            std::printf("     %llu malformed packets\n", static_cast<unsigned long long>(rx.badPackets));
+            exitCode = 1;
+        }
+        delete rx.reassembler;
+        ::close(rx.group);
+        ::close(rx.control);
+    }
+    return exitCode;
+}
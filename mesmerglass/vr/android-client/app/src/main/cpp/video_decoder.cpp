@@ -0,0 +1,366 @@
+/**
+ * Video Decoder - shared queueing, resync and playout pacing
+ *
+ * Behaviour mirrors the Kotlin MediaCodec path in MainActivity: drop until
+ * the next IDR after any loss, wait out short codec backpressure instead of
+ * skipping P-frames, and schedule output against an adaptive base timestamp
+ * so jitter is absorbed by the playout buffer rather than shown as stutter.
+ */
+
+#include "video_decoder.h"
+
+#include "annexb.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__ANDROID__)
+#include <android/log.h>
+#define LOG_TAG "VideoDecoder"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#else
+#include <cstdio>
+#define LOGI(...) (std::fprintf(stderr, "[VideoDecoder] " __VA_ARGS__), std::fputc('\n', stderr))
+#define LOGW(...) (std::fprintf(stderr, "[VideoDecoder] " __VA_ARGS__), std::fputc('\n', stderr))
+#endif
+
+namespace vrrenderer {
+namespace {
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Emits one picture per access unit without decoding anything. Lets the
+// pipeline (queueing, resync, pacing) be exercised and timed on its own.
+class NullBackend : public DecoderBackend {
+public:
+    const char* name() const override { return "null"; }
+
+    bool configure(const CodecConfig& config) override {
+        width_ = config.width;
+        height_ = config.height;
+        pending_.clear();
+        return true;
+    }
+
+    InputStatus queueInput(const uint8_t*, size_t size, int64_t ptsUs, int64_t) override {
+        if (size == 0) {
+            return InputStatus::kError;
+        }
+        pending_.push_back(ptsUs);
+        return InputStatus::kQueued;
+    }
+
+    bool dequeueOutput(DecodedFrame* frame, int64_t) override {
+        if (pending_.empty()) {
+            return false;
+        }
+        frame->ptsUs = pending_.front();
+        frame->width = width_;
+        frame->height = height_;
+        frame->bufferIndex = 0;
+        pending_.pop_front();
+        return true;
+    }
+
+    void releaseOutput(const DecodedFrame&, int64_t) override {}
+
+    void flush() override { pending_.clear(); }
+
+    void stop() override { pending_.clear(); }
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    std::deque<int64_t> pending_;
+};
+
+}  // namespace
+
+std::unique_ptr<DecoderBackend> createNullBackend() {
+    return std::unique_ptr<DecoderBackend>(new NullBackend());
+}
+
+VideoDecoder::VideoDecoder(std::unique_ptr<DecoderBackend> backend, const Options& options)
+    : backend_(std::move(backend)), opts_(options), clock_(steadyNowNs) {}
+
+VideoDecoder::~VideoDecoder() {
+    stop();
+}
+
+void VideoDecoder::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    worker_ = std::thread(&VideoDecoder::run, this);
+}
+
+void VideoDecoder::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    backend_->stop();
+    configured_ = false;
+}
+
+bool VideoDecoder::submit(const uint8_t* data, size_t size, int64_t ptsUs) {
+    if (data == nullptr || size == 0) {
+        return false;
+    }
+    const bool idr = annexb::containsIdr(data, size, opts_.codec);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stats_.submitted++;
+        if (needIdr_.load() && !idr) {
+            // References are gone; feeding P-frames now only produces mosaic.
+            stats_.dropped++;
+            lock.unlock();
+            maybeRequestIdr("waiting-for-idr");
+            return false;
+        }
+        if (idr && needIdr_.exchange(false)) {
+            stats_.dropped += queue_.size();
+            queue_.clear();
+        }
+
+        queue_.push_back(Unit{std::vector<uint8_t>(data, data + size), ptsUs, now(), idr});
+        if (queue_.size() > opts_.queueMaxFrames) {
+            // Dropping access units is packet loss: restart from this IDR if we
+            // have one, otherwise flush and wait for the next.
+            if (idr) {
+                stats_.dropped += queue_.size() - 1;
+                queue_.erase(queue_.begin(), queue_.end() - 1);
+                flushPending_ = true;
+                stats_.queueDepth = queue_.size();
+            } else {
+                lock.unlock();
+                enterResync("queue_drop");
+                return false;
+            }
+        }
+        stats_.queueDepth = queue_.size();
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void VideoDecoder::requestResync(const char* reason) {
+    enterResync(reason);
+}
+
+void VideoDecoder::enterResync(const char* reason) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.dropped += queue_.size();
+        queue_.clear();
+        stats_.queueDepth = 0;
+        if (!needIdr_.exchange(true)) {
+            stats_.resyncs++;
+            LOGW("resync (%s); waiting for IDR", reason);
+        }
+        flushPending_ = true;
+    }
+    maybeRequestIdr(reason);
+}
+
+void VideoDecoder::maybeRequestIdr(const char* reason) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const int64_t t = now();
+        if (lastIdrRequestNs_ != 0 && t - lastIdrRequestNs_ < opts_.idrRequestMinIntervalMs * 1000000LL) {
+            return;
+        }
+        lastIdrRequestNs_ = t;
+        stats_.idrRequests++;
+    }
+    if (onIdrRequest_) {
+        onIdrRequest_(reason);
+    }
+}
+
+void VideoDecoder::drain(int64_t timeoutMs) {
+    const int64_t deadline = now() + timeoutMs * 1000000LL;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_ && (!queue_.empty() || busy_ || !inflight_.empty())) {
+        if (now() >= deadline) {
+            break;
+        }
+        idleCv_.wait_for(lock, std::chrono::milliseconds(2));
+    }
+}
+
+DecoderStats VideoDecoder::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void VideoDecoder::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        if (queue_.empty()) {
+            // Keep pulling output while idle; pictures can lag their input.
+            const bool waiting = !inflight_.empty();
+            lock.unlock();
+            if (waiting) {
+                drainOutput(0);
+            }
+            lock.lock();
+            idleCv_.notify_all();
+            cv_.wait_for(lock, std::chrono::milliseconds(waiting ? 2 : 20));
+            continue;
+        }
+        Unit unit = std::move(queue_.front());
+        queue_.pop_front();
+        stats_.queueDepth = queue_.size();
+        busy_ = true;
+        lock.unlock();
+
+        if (flushPending_.exchange(false)) {
+            if (configured_) {
+                backend_->flush();
+            }
+            std::lock_guard<std::mutex> guard(mutex_);
+            inflight_.clear();
+            haveBase_ = false;
+            stats_.flushes++;
+        }
+        // Drain first: some codecs only free input buffers once output is taken.
+        drainOutput(0);
+        decodeUnit(unit);
+        drainOutput(0);
+
+        lock.lock();
+        busy_ = false;
+        idleCv_.notify_all();
+    }
+}
+
+bool VideoDecoder::decodeUnit(Unit& unit) {
+    if (unit.idr) {
+        CodecConfig cfg;
+        cfg.codec = opts_.codec;
+        if (annexb::extractParameterSets(unit.data.data(), unit.data.size(), &cfg.sps, &cfg.pps, cfg.codec, &cfg.vps) &&
+            (!configured_ || cfg.sps != config_.sps || cfg.pps != config_.pps || cfg.vps != config_.vps)) {
+            if (!annexb::spsDimensions(cfg.sps.data(), cfg.sps.size(), &cfg.width, &cfg.height, cfg.codec)) {
+                cfg.width = config_.width;
+                cfg.height = config_.height;
+            }
+            if (!backend_->configure(cfg)) {
+                configured_ = false;
+                enterResync("configure_failed");
+                return false;
+            }
+            LOGI("%s configured %dx%d", backend_->name(), cfg.width, cfg.height);
+            config_ = std::move(cfg);
+            configured_ = true;
+            std::lock_guard<std::mutex> guard(mutex_);
+            inflight_.clear();
+            haveBase_ = false;
+            stats_.reconfigures++;
+        }
+    }
+    if (!configured_) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stats_.dropped++;
+        return false;
+    }
+
+    // Smoothness first: wait out short backpressure rather than dropping a
+    // P-frame, but treat a codec that stays full for inputMaxWaitUs as stuck.
+    const int64_t waitStart = now();
+    while (true) {
+        const int64_t waitedUs = (now() - waitStart) / 1000;
+        if (waitedUs >= opts_.inputMaxWaitUs) {
+            LOGW("%s backpressured >%lldms; flushing", backend_->name(),
+                 static_cast<long long>(opts_.inputMaxWaitUs / 1000));
+            enterResync("codec_stuck");
+            return false;
+        }
+        const int64_t timeoutUs = std::min(opts_.inputStepUs, opts_.inputMaxWaitUs - waitedUs);
+        const InputStatus status = backend_->queueInput(unit.data.data(), unit.data.size(), unit.ptsUs, timeoutUs);
+        if (status == InputStatus::kQueued) {
+            std::lock_guard<std::mutex> guard(mutex_);
+            inflight_.emplace_back(unit.ptsUs, unit.submitNs);
+            stats_.queued++;
+            return true;
+        }
+        if (status == InputStatus::kError) {
+            enterResync("codec_error");
+            return false;
+        }
+        drainOutput(0);
+    }
+}
+
+void VideoDecoder::drainOutput(int64_t timeoutUs) {
+    DecodedFrame frame;
+    while (backend_->dequeueOutput(&frame, timeoutUs)) {
+        timeoutUs = 0;
+        const int64_t nowNs = now();
+        const int64_t renderNs = opts_.pace ? schedule(frame.ptsUs, nowNs) : nowNs;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            // No B-frames: output order equals input order, so anything older
+            // than this picture was dropped inside the codec.
+            while (!inflight_.empty() && inflight_.front().first < frame.ptsUs) {
+                inflight_.pop_front();
+            }
+            if (!inflight_.empty() && inflight_.front().first == frame.ptsUs) {
+                const int64_t latencyUs = (nowNs - inflight_.front().second) / 1000;
+                stats_.lastLatencyUs = latencyUs;
+                stats_.maxLatencyUs = std::max(stats_.maxLatencyUs, latencyUs);
+                stats_.sumLatencyUs += latencyUs;
+                inflight_.pop_front();
+            }
+            stats_.decoded++;
+        }
+        if (onFrame_) {
+            onFrame_(frame, renderNs);
+        }
+        backend_->releaseOutput(frame, renderNs);
+    }
+}
+
+int64_t VideoDecoder::schedule(int64_t ptsUs, int64_t nowNs) {
+    const int64_t targetNs = static_cast<int64_t>(opts_.targetBufferMs) * 1000000LL;
+    if (!haveBase_) {
+        haveBase_ = true;
+        basePtsUs_ = ptsUs;
+        baseNs_ = nowNs + targetNs;
+    }
+    const int64_t deltaNs = (ptsUs - basePtsUs_) * 1000;
+    const int64_t desiredNs = baseNs_ + deltaNs;
+    const bool late = desiredNs < nowNs;
+    const int64_t renderNs = late ? nowNs : desiredNs;
+    const int64_t bufferNs = renderNs - nowNs;
+
+    // Steer the base gently so the scheduled buffer tracks the target, and
+    // rebase outright after an underflow so the buffer can rebuild.
+    baseNs_ += std::max<int64_t>(-4000000, std::min<int64_t>(4000000, (targetNs - bufferNs) / 10));
+    if (late) {
+        baseNs_ = nowNs + targetNs - deltaNs;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    stats_.playoutBufferMs = static_cast<int>(bufferNs / 1000000);
+    if (late) {
+        stats_.late++;
+    }
+    return renderNs;
+}
+
+}  // namespace vrrenderer
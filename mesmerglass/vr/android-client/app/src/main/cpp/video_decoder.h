@@ -0,0 +1,203 @@
+/**
+ * Video Decoder - backend-agnostic H.264 / HEVC decode pipeline
+ *
+ * VideoDecoder owns the parts of stream decoding that don't depend on the
+ * codec: a bounded input queue, IDR resync after loss or codec stalls, and
+ * playout pacing of decoded frames against a target buffer. Backends only
+ * move bytes in and pictures out:
+ *
+ *   - MediaCodecBackend (Android): NDK AMediaCodec rendering to a Surface
+ *   - FFmpegBackend (host, VRRENDERER_WITH_FFMPEG): libavcodec software decode
+ *   - NullBackend: emits one picture per access unit, for pipeline tests
+ *
+ * The same pipeline therefore runs on-device and in host benchmarks that
+ * replay recorded .h264 / .h265 dumps (see tools/vrdecode_bench.cpp).
+ */
+
+#pragma once
+
+#include "annexb.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__ANDROID__)
+struct ANativeWindow;
+#endif
+
+namespace vrrenderer {
+
+struct CodecConfig {
+    annexb::Codec codec = annexb::Codec::kH264;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> vps;  // HEVC only
+    std::vector<uint8_t> sps;  // NAL units without start codes
+    std::vector<uint8_t> pps;
+};
+
+enum class InputStatus {
+    kQueued,
+    kTryAgain,  // no input buffer free yet; drain output and retry
+    kError,
+};
+
+struct DecodedFrame {
+    int64_t ptsUs = 0;
+    int width = 0;
+    int height = 0;
+    int32_t bufferIndex = -1;  // backend handle, passed back to releaseOutput()
+    const uint8_t* luma = nullptr;  // software backends only; valid until releaseOutput()
+    int lumaStride = 0;
+};
+
+class DecoderBackend {
+public:
+    virtual ~DecoderBackend() = default;
+
+    virtual const char* name() const = 0;
+
+    // (Re)configure for a new SPS/PPS (and VPS for HEVC). Called before the first
+    // IDR and whenever the parameter sets change.
+    virtual bool configure(const CodecConfig& config) = 0;
+
+    virtual InputStatus queueInput(const uint8_t* data, size_t size, int64_t ptsUs, int64_t timeoutUs) = 0;
+
+    // Returns true and fills `frame` when a decoded picture is ready.
+    virtual bool dequeueOutput(DecodedFrame* frame, int64_t timeoutUs) = 0;
+
+    // Hand a picture back. `renderTimeNs` < 0 drops it without display.
+    virtual void releaseOutput(const DecodedFrame& frame, int64_t renderTimeNs) = 0;
+
+    // Discard all queued input and pending output (used on resync).
+    virtual void flush() = 0;
+
+    virtual void stop() = 0;
+};
+
+std::unique_ptr<DecoderBackend> createNullBackend();
+#if defined(VRRENDERER_WITH_FFMPEG)
+std::unique_ptr<DecoderBackend> createFFmpegBackend(int threads, bool keepLuma);
+#endif
+#if defined(__ANDROID__)
+std::unique_ptr<DecoderBackend> createMediaCodecBackend(ANativeWindow* window);
+#endif
+
+struct DecoderStats {
+    uint64_t submitted = 0;
+    uint64_t queued = 0;          // access units accepted by the backend
+    uint64_t decoded = 0;         // pictures released for display
+    uint64_t dropped = 0;         // access units discarded (queue overflow / resync)
+    uint64_t late = 0;            // pictures that missed their playout slot
+    uint64_t resyncs = 0;
+    uint64_t flushes = 0;
+    uint64_t idrRequests = 0;
+    uint64_t reconfigures = 0;
+    int64_t lastLatencyUs = 0;    // submit -> decoded picture
+    int64_t maxLatencyUs = 0;
+    int64_t sumLatencyUs = 0;
+    int playoutBufferMs = 0;
+    size_t queueDepth = 0;
+};
+
+class VideoDecoder {
+public:
+    struct Options {
+        size_t queueMaxFrames = 8;
+        int targetBufferMs = 60;
+        int64_t inputStepUs = 50000;      // per dequeue attempt while backpressured
+        int64_t inputMaxWaitUs = 500000;  // beyond this the codec is treated as stuck
+        int64_t idrRequestMinIntervalMs = 250;
+        bool pace = true;                 // false: release pictures immediately (benchmarks)
+        annexb::Codec codec = annexb::Codec::kH264;  // fixed per stream (VRH4_FLAG_HEVC)
+    };
+
+    using Clock = std::function<int64_t()>;           // monotonic nanoseconds
+    using IdrRequest = std::function<void(const char* reason)>;
+    using FrameCallback = std::function<void(const DecodedFrame& frame, int64_t renderTimeNs)>;
+
+    VideoDecoder(std::unique_ptr<DecoderBackend> backend, const Options& options);
+    ~VideoDecoder();
+
+    VideoDecoder(const VideoDecoder&) = delete;
+    VideoDecoder& operator=(const VideoDecoder&) = delete;
+
+    // Called when the pipeline needs a keyframe from the sender (rate limited).
+    void setIdrRequestCallback(IdrRequest cb) { onIdrRequest_ = std::move(cb); }
+    // Observes every picture just before it is released to the backend.
+    void setFrameCallback(FrameCallback cb) { onFrame_ = std::move(cb); }
+    void setClock(Clock clock) { clock_ = std::move(clock); }
+
+    void start();
+    void stop();
+
+    // Enqueue one access unit. Never blocks on the codec; returns false when
+    // the unit was dropped (resync pending or queue overflow).
+    bool submit(const uint8_t* data, size_t size, int64_t ptsUs);
+
+    // Signal stream loss from the outside (CRC failure, reconnect).
+    void requestResync(const char* reason);
+
+    // Block until every submitted unit has been handed to the backend and all
+    // available output drained (host benchmarks / end of dump replay).
+    void drain(int64_t timeoutMs);
+
+    DecoderStats stats() const;
+    bool needsIdr() const { return needIdr_.load(); }
+    const char* backendName() const { return backend_->name(); }
+
+private:
+    struct Unit {
+        std::vector<uint8_t> data;
+        int64_t ptsUs;
+        int64_t submitNs;
+        bool idr;
+    };
+
+    void run();
+    bool decodeUnit(Unit& unit);
+    void drainOutput(int64_t timeoutUs);
+    int64_t schedule(int64_t ptsUs, int64_t nowNs);
+    void enterResync(const char* reason);
+    void maybeRequestIdr(const char* reason);
+    int64_t now() const { return clock_(); }
+
+    std::unique_ptr<DecoderBackend> backend_;
+    Options opts_;
+    Clock clock_;
+    IdrRequest onIdrRequest_;
+    FrameCallback onFrame_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idleCv_;
+    std::deque<Unit> queue_;
+    bool running_ = false;
+    bool busy_ = false;
+    std::thread worker_;
+
+    std::atomic<bool> needIdr_{true};
+    std::atomic<bool> flushPending_{false};
+    int64_t lastIdrRequestNs_ = 0;
+
+    // Decode-thread state.
+    bool configured_ = false;
+    CodecConfig config_;
+    std::deque<std::pair<int64_t, int64_t>> inflight_;  // (ptsUs, submitNs)
+    bool haveBase_ = false;
+    int64_t basePtsUs_ = 0;
+    int64_t baseNs_ = 0;
+
+    DecoderStats stats_;
+};
+
+}  // namespace vrrenderer
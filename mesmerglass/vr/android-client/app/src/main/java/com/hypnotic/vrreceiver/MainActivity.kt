@@ -10,6 +10,7 @@ import android.graphics.Color
 import android.graphics.SurfaceTexture
 import android.media.MediaCodec
 import android.media.MediaFormat
+import android.net.wifi.WifiManager
 import android.opengl.GLES11Ext
 import android.opengl.GLSurfaceView
 import android.opengl.GLUtils
@@ -42,16 +43,45 @@ import android.opengl.GLES30
  * 
  * Supports dual-protocol streaming:
  * - VRHP (JPEG): CPU software decoding via BitmapFactory
- * - VRH2 (H.264): GPU hardware decoding via MediaCodec
+ * - VRHT (ETC2): compressed textures uploaded as-is (no decode), same render path as VRHP
+ * - VRH2 (H.264): GPU hardware decoding via MediaCodec (Kotlin loop, or libvrrenderer's
+ *   VideoDecoder when launched with `--ez native_decoder true`)
  */
 class MainActivity : Activity(), GLSurfaceView.Renderer {
     
     private lateinit var glSurfaceView: GLSurfaceView
     private var networkReceiver: NetworkReceiver? = null
     private var discoveryService: DiscoveryService? = null
+    private var multicastLock: WifiManager.MulticastLock? = null
     private var statusColor = Color.BLUE
     private var isStreaming = false
     @Volatile private var isConnecting = false
+
+    // Performance HUD, switched on by the server (VRHC control packet). Stage samples are
+    // collected on the GL thread except receive (network thread) and H.264 decode (decode loop).
+    @Volatile private var hudEnabled = false
+    @Volatile private var hudRxIntervalMs = 0f
+    @Volatile private var hudDecodeMs = 0f
+    @Volatile private var needIdrSentTotal = 0L
+    private var hudLastRxNs = 0L
+    private var hudLastFrameEndNs = 0L
+    private var hudBitrateKbps = 0L
+    private val hudStageMs = FloatArray(NativeHud.STAGE_COUNT)
+    private val hudCounters = LongArray(NativeHud.COUNTER_COUNT)
+
+    // Headset asset cache (VRHP/VRHT): the server shows recurring frames by hash with a VRHC
+    // SHOW instead of resending them. Set by SHOW, cleared by any ordinary frame; guarded by frameLock.
+    private var shownAssetIds: LongArray? = null
+
+    // Opt-in native VRH2 decode (NativeVideoDecoder): the shared VideoDecoder pipeline that
+    // vrdecode_bench replays on hosts. Off by default; enable with
+    // `adb shell am start -n com.hypnotic.vrreceiver/.MainActivity --ez native_decoder true`.
+    // Falls back to the Kotlin MediaCodec loop when the library or codec is unavailable.
+    @Volatile private var useNativeDecoder = false
+    private var nativeLeftDecoder: NativeVideoDecoder? = null
+    private var nativeRightDecoder: NativeVideoDecoder? = null
+    private val nativeDecoderLock = Any()
+    private val nativeTargetBufferMs = 60  // playout buffer of the native pacer
     
     // Clear color (changes based on status)
 
@@ -256,6 +286,8 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
         }
     }
         
+        useNativeDecoder = intent?.getBooleanExtra("native_decoder", false) == true
+
         // Keep screen on
         window.addFlags(WindowManager.LayoutParams.FLAG_KEEP_SCREEN_ON)
 
@@ -360,6 +392,8 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
         GLES30.glGenTextures(2, textures, 0)
         leftEyeTextureId = textures[0]
         rightEyeTextureId = textures[1]
+        if (NativeTexture.available) NativeTexture.reset()
+        NativeHud.reset()
         
         // Setup textures
         for (texId in textures) {
@@ -460,6 +494,10 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
     override fun onDrawFrame(gl: GL10?) {
         // Called every frame - on GL thread
         val renderStart = System.currentTimeMillis()
+        val frameStartNs = System.nanoTime()
+        var frameDecodeMs = 0f
+        var frameUploadNs = 0L
+        var frameRenderNs = 0L
 
         // Always render into the full surface. Some devices/paths can leave a smaller viewport active.
         val sw = surfaceWidth
@@ -483,6 +521,8 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             // Update external textures.
             // Some devices/drivers are flaky about OnFrameAvailable delivery; updating every frame is robust
             // and prevents getting stuck on a stale first frame.
+            frameDecodeMs = hudDecodeMs
+            val latchStartNs = System.nanoTime()
             try {
                 leftSurfaceTexture?.updateTexImage()
                 leftSurfaceTexture?.getTransformMatrix(leftTexMatrix)
@@ -509,39 +549,81 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
                 System.arraycopy(leftTexMatrixFinal, 0, rightTexMatrixFinal, 0, 16)
                 rightH264FrameAvailable = false
             }
+            frameUploadNs = System.nanoTime() - latchStartNs
 
             // Draw latest decoded frames
+            val drawStartNs = System.nanoTime()
             when (layout) {
                 DisplayLayout.VR_STEREO -> renderStereoExternal(lastPacketWasMono)
                 DisplayLayout.FULLSCREEN -> renderFullscreenExternal(leftEyeOesTextureId)
                 DisplayLayout.AUTO -> renderFullscreenExternal(leftEyeOesTextureId)
             }
+            frameRenderNs = System.nanoTime() - drawStartNs
         } else {
-            // VRHP (JPEG) path
+            // VRHP (JPEG) / VRHT (ETC2) path
             val shouldUpload = (hasFrame && receivedFrameVersion != uploadedFrameVersion)
             if (shouldUpload) {
                 synchronized(frameLock) {
-                    if (hasFrame && leftFrameData != null && rightFrameData != null && receivedFrameVersion != uploadedFrameVersion) {
+                    val assetIds = shownAssetIds
+                    if (hasFrame && assetIds != null && receivedFrameVersion != uploadedFrameVersion) {
+                        val uploadStartNs = System.nanoTime()
+
+                        val size = NativeAssetCache.upload(leftEyeTextureId, assetIds[0])
+                        if (size != null) {
+                            videoAspectRatio = size.first.toFloat() / size.second.toFloat()
+                        } else {
+                            requestAsset(assetIds[0])
+                        }
+                        if (layout == DisplayLayout.VR_STEREO && NativeAssetCache.upload(rightEyeTextureId, assetIds[1]) == null) {
+                            requestAsset(assetIds[1])
+                        }
+                        frameUploadNs = System.nanoTime() - uploadStartNs
+
+                        // On a miss the previous frame stays up until the server re-sends the asset.
+                        uploadedFrameVersion = receivedFrameVersion
+                    } else if (hasFrame && leftFrameData != null && rightFrameData != null && receivedFrameVersion != uploadedFrameVersion &&
+                        networkReceiver?.compressedTextures == true) {
+                        val decodeStart = System.currentTimeMillis()
+                        val uploadStartNs = System.nanoTime()
+
+                        val size = NativeTexture.uploadEtc2(leftEyeTextureId, leftFrameData!!)
+                        if (size != null) {
+                            videoAspectRatio = size.first.toFloat() / size.second.toFloat()
+                        }
+                        if (layout == DisplayLayout.VR_STEREO) {
+                            NativeTexture.uploadEtc2(rightEyeTextureId, rightFrameData!!)
+                        }
+                        frameUploadNs = System.nanoTime() - uploadStartNs
+
+                        uploadedFrameVersion = receivedFrameVersion
+                        decodeTimes.add(System.currentTimeMillis() - decodeStart)
+                    } else if (hasFrame && leftFrameData != null && rightFrameData != null && receivedFrameVersion != uploadedFrameVersion) {
                         val decodeStart = System.currentTimeMillis()
+                        val decodeStartNs = System.nanoTime()
 
                         val leftBitmap = BitmapFactory.decodeByteArray(leftFrameData, 0, leftFrameData!!.size)
                         if (leftBitmap != null) {
                             videoAspectRatio = leftBitmap.width.toFloat() / leftBitmap.height.toFloat()
+                            val uploadStartNs = System.nanoTime()
                             GLES30.glBindTexture(GLES30.GL_TEXTURE_2D, leftEyeTextureId)
                             GLUtils.texImage2D(GLES30.GL_TEXTURE_2D, 0, leftBitmap, 0)
+                            frameUploadNs += System.nanoTime() - uploadStartNs
                             leftBitmap.recycle()
                         }
 
                         if (layout == DisplayLayout.VR_STEREO) {
                             val rightBitmap = BitmapFactory.decodeByteArray(rightFrameData, 0, rightFrameData!!.size)
                             if (rightBitmap != null) {
+                                val uploadStartNs = System.nanoTime()
                                 GLES30.glBindTexture(GLES30.GL_TEXTURE_2D, rightEyeTextureId)
                                 GLUtils.texImage2D(GLES30.GL_TEXTURE_2D, 0, rightBitmap, 0)
+                                frameUploadNs += System.nanoTime() - uploadStartNs
                                 rightBitmap.recycle()
                             }
                         }
 
                         uploadedFrameVersion = receivedFrameVersion
+                        frameDecodeMs = (System.nanoTime() - decodeStartNs - frameUploadNs) / 1_000_000f
 
                         val decodeTime = System.currentTimeMillis() - decodeStart
                         decodeTimes.add(decodeTime)
@@ -550,13 +632,19 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             }
 
             if (hasFrame) {
+                val drawStartNs = System.nanoTime()
                 when (layout) {
                     DisplayLayout.VR_STEREO -> renderStereo()
                     DisplayLayout.FULLSCREEN -> renderFullscreen(leftEyeTextureId)
                     DisplayLayout.AUTO -> renderFullscreen(leftEyeTextureId)
                 }
+                frameRenderNs = System.nanoTime() - drawStartNs
             }
         }
+
+        if (hudEnabled) {
+            drawHud(frameStartNs, frameDecodeMs, frameUploadNs, frameRenderNs)
+        }
         
         // Track render time and update performance stats
         val renderTime = System.currentTimeMillis() - renderStart
@@ -580,6 +668,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             
             // Calculate bandwidth
             val bandwidthMbps = if (statsWindow > 0) (bytesReceived * 8) / (statsWindow * 1_000_000) else 0.0
+            hudBitrateKbps = (bandwidthMbps * 1000).toLong()
 
             if (ENABLE_STREAM_STATS_LOG) {
                 val qDepth = synchronized(h264QueueLock) { h264FrameQueue.size }
@@ -653,6 +742,32 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
                 renderTimes.subList(0, renderTimes.size - 120).clear()
             }
         }
+
+        hudLastFrameEndNs = System.nanoTime()
+    }
+
+    private fun drawHud(frameStartNs: Long, decodeMs: Float, uploadNs: Long, renderNs: Long) {
+        hudStageMs[NativeHud.STAGE_RECEIVE] = hudRxIntervalMs
+        hudStageMs[NativeHud.STAGE_DECODE] = decodeMs
+        hudStageMs[NativeHud.STAGE_UPLOAD] = uploadNs / 1_000_000f
+        hudStageMs[NativeHud.STAGE_RENDER] = renderNs / 1_000_000f
+        // Time spent outside onDrawFrame since the last frame: eglSwapBuffers plus the vsync wait.
+        hudStageMs[NativeHud.STAGE_PRESENT] =
+            if (hudLastFrameEndNs != 0L) (frameStartNs - hudLastFrameEndNs) / 1_000_000f else 0f
+        NativeHud.record(hudStageMs)
+
+        hudCounters[NativeHud.COUNTER_QUEUE_FRAMES] = synchronized(h264QueueLock) { h264FrameQueue.size }.toLong()
+        hudCounters[NativeHud.COUNTER_PLAYOUT_MS] = vrh2LastPlayoutBufferMs.toLong()
+        hudCounters[NativeHud.COUNTER_BITRATE_KBPS] = hudBitrateKbps
+        synchronized(statsLock) {
+            hudCounters[NativeHud.COUNTER_DROPS] = h264DroppedTotal
+            hudCounters[NativeHud.COUNTER_RESYNCS] = h264ResyncTotal
+        }
+        hudCounters[NativeHud.COUNTER_NEED_IDR] = needIdrSentTotal
+        hudCounters[NativeHud.COUNTER_CRC_FAILURES] = networkReceiver?.crcFailures ?: 0L
+        NativeHud.setCounters(hudCounters)
+
+        NativeHud.draw(surfaceWidth, surfaceHeight, resolvedDisplayLayout == DisplayLayout.VR_STEREO)
     }
     
     private fun renderStereo() {
@@ -1108,13 +1223,19 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             serverPort = port,
             // Frame received callback
             onFrameReceived = { leftData, rightData, protocol, frameId, isMono ->
+                if (hudEnabled) {
+                    val rxNs = System.nanoTime()
+                    if (hudLastRxNs != 0L) hudRxIntervalMs = (rxNs - hudLastRxNs) / 1_000_000f
+                    hudLastRxNs = rxNs
+                }
+
                 // Detect and initialize decoders on first frame
                 if (streamProtocol == StreamProtocol.UNKNOWN && protocol != StreamProtocol.UNKNOWN) {
                     streamProtocol = protocol
                     runOnUiThread {
                         val protocolName = when(protocol) {
                             StreamProtocol.VRH2 -> "H.264 (GPU)"
-                            StreamProtocol.VRHP -> "JPEG (CPU)"
+                            StreamProtocol.VRHP -> if (networkReceiver?.compressedTextures == true) "ETC2 (texture)" else "JPEG (CPU)"
                             else -> "UNKNOWN"
                         }
                         Toast.makeText(this, "Protocol: $protocolName", Toast.LENGTH_SHORT).show()
@@ -1124,22 +1245,15 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
                 }
                 
                 // Mark as streaming on first frame
-                if (!isStreaming) {
-                    isStreaming = true
-                    isConnecting = false
-                    runOnUiThread {
-                        // Change to black when streaming (for letterbox bars)
-                        clearR = 0.0f
-                        clearG = 0.0f
-                        clearB = 0.0f
-                    }
-                }
+                markStreaming()
                 
                 if (protocol == StreamProtocol.VRH2) {
                     lastPacketWasMono = isMono
                     videoAspectRatio = H264_WIDTH.toFloat() / H264_HEIGHT.toFloat()
                     recordH264Rx(frameId)
-                    enqueueH264Frame(leftData, rightData, frameId, isMono)
+                    if (!(useNativeDecoder && submitNativeH264(leftData, rightData, isMono))) {
+                        enqueueH264Frame(leftData, rightData, frameId, isMono)
+                    }
                     // Track bytes received for bandwidth calculation
                     bytesReceived += leftData.size.toLong() + (if (isMono) 0L else rightData.size.toLong())
                     hasFrame = true
@@ -1148,6 +1262,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
                     synchronized(frameLock) {
                         leftFrameData = leftData
                         rightFrameData = rightData
+                        shownAssetIds = null
                         hasFrame = true
 
                         // Mark new frame available (used by render loop to decide when to decode/upload)
@@ -1167,6 +1282,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
                 isConnecting = false
                 streamProtocol = StreamProtocol.UNKNOWN
                 networkReceiver = null
+                hudEnabled = false
 
                 synchronized(statsLock) {
                     lastRxFrameId = null
@@ -1187,6 +1303,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
                     hasFrame = false
                     leftFrameData = null
                     rightFrameData = null
+                    shownAssetIds = null
                     receivedFrameVersion += 1
                 }
                 
@@ -1218,17 +1335,91 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
                     q >= h264QueueHighWater -> 8L
                     else -> 0L
                 }
-            }
+            },
+            onCorruptPacket = { frameId ->
+                // Checksum proved this packet corrupt: drop it and resync at the next IDR.
+                synchronized(statsLock) {
+                    h264BadAccessUnitsTotal += 1
+                    h264DroppedTotal += 1
+                }
+                Log.w(TAG, "VRH4: CRC32C mismatch on frame $frameId; resyncing")
+                enterH264Resync("crc")
+            },
+            onControl = { command, args, payload ->
+                when (command) {
+                    NetworkReceiver.CONTROL_HUD -> {
+                        hudEnabled = args.isNotEmpty() && args[0].toInt() != 0
+                        hudLastRxNs = 0L
+                        Log.i(TAG, "Performance HUD ${if (hudEnabled) "on" else "off"}")
+                    }
+                    NetworkReceiver.CONTROL_ASSET_OFFER -> {
+                        // Staying silent keeps the server on ordinary frame packets.
+                        if (NativeAssetCache.available) {
+                            val ids = NativeAssetCache.ids()
+                            networkReceiver?.sendAssetHave(ids)
+                            Log.i(TAG, "Asset cache offered; reported ${ids.size} cached assets")
+                        }
+                    }
+                    NetworkReceiver.CONTROL_ASSET_PUT -> {
+                        if (args.size >= 9) {
+                            val buffer = ByteBuffer.wrap(args)
+                            val id = buffer.long
+                            val format = buffer.get().toInt() and 0xFF
+                            if (!NativeAssetCache.put(id, format, payload)) {
+                                Log.w(TAG, "Asset ${java.lang.Long.toHexString(id)} (format $format) rejected")
+                            }
+                            bytesReceived += payload.size.toLong()
+                        }
+                    }
+                    NetworkReceiver.CONTROL_ASSET_SHOW -> {
+                        if (args.size >= 16) {
+                            val buffer = ByteBuffer.wrap(args)
+                            val ids = longArrayOf(buffer.long, buffer.long)
+                            // A cache retained from an earlier connection can make SHOW the first frame.
+                            markStreaming()
+                            synchronized(frameLock) {
+                                shownAssetIds = ids
+                                hasFrame = true
+                                receivedFrameVersion += 1
+                            }
+                        }
+                    }
+                    else -> Log.w(TAG, "Ignoring unknown VRHC command $command")
+                }
+            },
+            onMulticast = { active -> holdMulticastLock(active) }
         )
         
         networkReceiver?.start()
     }
     
+    private fun markStreaming() {
+        if (!isStreaming) {
+            isStreaming = true
+            isConnecting = false
+            runOnUiThread {
+                // Change to black when streaming (for letterbox bars)
+                clearR = 0.0f
+                clearG = 0.0f
+                clearB = 0.0f
+            }
+        }
+    }
+
+    private fun requestAsset(id: Long) {
+        // Send on a background thread; writing can block if the socket is congested.
+        CoroutineScope(Dispatchers.IO).launch {
+            networkReceiver?.sendAssetNeed(id)
+            Log.i(TAG, "Asset ${java.lang.Long.toHexString(id)} evicted; requested again")
+        }
+    }
+
     private fun initializeH264Decoders() {
         // Deprecated placeholder - initialization happens in handleH264Frame once SPS/PPS are available.
     }
 
     private fun resetH264CodecsKeepSurfaces() {
+        releaseNativeDecoders()
         synchronized(decoderLock) {
             try {
                 leftDecoder?.stop()
@@ -1271,6 +1462,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
         val nowMs = SystemClock.elapsedRealtime()
         if (nowMs - lastNeedIdrSentAtMs < needIdrMinIntervalMs) return
         lastNeedIdrSentAtMs = nowMs
+        needIdrSentTotal += 1
 
         // Send on a background thread; writing can block if the socket is congested.
         CoroutineScope(Dispatchers.IO).launch {
@@ -1464,7 +1656,9 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             // Best-effort per-frame codec/decode time sample for H.264.
             // Record only on the left eye to avoid double-counting stereo frames.
             if (!isRight) {
-                val dtMs = (System.nanoTime() - t0) / 1_000_000L
+                val dtNs = System.nanoTime() - t0
+                hudDecodeMs = dtNs / 1_000_000f
+                val dtMs = dtNs / 1_000_000L
                 decodeTimes.add(dtMs)
                 if (decodeTimes.size > 240) {
                     decodeTimes.subList(0, decodeTimes.size - 240).clear()
@@ -1496,8 +1690,10 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
 
     private fun enqueueH264Frame(leftData: ByteArray, rightData: ByteArray, frameId: Int, isMono: Boolean) {
         // If we detect corruption or codec errors, drop frames until the next keyframe (IDR/SPS)
-        // and resync on the next IDR.
-        if (!h264AccessUnitHasStartCode(leftData)) {
+        // and resync on the next IDR. Checksummed (VRH4) payloads were already verified
+        // byte-for-byte, so the structural heuristic is skipped for them.
+        val payloadVerified = networkReceiver?.payloadChecksums == true
+        if (!payloadVerified && !h264AccessUnitHasStartCode(leftData)) {
             synchronized(statsLock) {
                 h264BadAccessUnitsTotal += 1
                 h264DroppedTotal += 1
@@ -1506,7 +1702,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             return
         }
 
-        val isKeyframe = h264AccessUnitLooksLikeKeyframe(leftData)
+        val isKeyframe = h264AccessUnitLooksLikeKeyframe(leftData, networkReceiver?.hevcPayloads == true)
 
         // Resync is handled in handleH264Frame where we can flush immediately before queueing IDR.
 
@@ -1600,6 +1796,54 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
         }
     }
 
+    /**
+     * Hands a VRH2 frame to the native decoders; false means the caller uses the Kotlin path.
+     * Queueing, IDR resync and playout pacing run on the native decode thread.
+     */
+    private fun submitNativeH264(leftData: ByteArray, rightData: ByteArray, isMono: Boolean): Boolean {
+        synchronized(nativeDecoderLock) {
+            val hevc = networkReceiver?.hevcPayloads == true
+            if (nativeLeftDecoder == null) {
+                val left = leftDecoderSurface ?: return false
+                nativeLeftDecoder = NativeVideoDecoder.create(left, nativeTargetBufferMs, h264QueueMaxFrames, hevc)
+                if (nativeLeftDecoder == null) {
+                    Log.w(TAG, "VRH2: native decoder unavailable; using MediaCodec from Kotlin")
+                    useNativeDecoder = false
+                    return false
+                }
+                runOnUiThread {
+                    Toast.makeText(this, "VRH2: native decode active (${if (hevc) "HEVC" else "H.264"})", Toast.LENGTH_SHORT).show()
+                }
+            }
+            if (!isMono && nativeRightDecoder == null) {
+                rightDecoderSurface?.let {
+                    nativeRightDecoder = NativeVideoDecoder.create(it, nativeTargetBufferMs, h264QueueMaxFrames, hevc)
+                }
+            }
+            // Arrival time, as on the Kotlin path; the native pipeline paces against it.
+            val ptsUs = System.nanoTime() / 1000L
+            val accepted = nativeLeftDecoder?.submit(leftData, ptsUs) == true
+            if (!isMono) nativeRightDecoder?.submit(rightData, ptsUs)
+            synchronized(statsLock) {
+                h264EnqueuedTotal += 1
+                if (!accepted) h264DroppedTotal += 1
+            }
+            val leftIdr = nativeLeftDecoder?.takeIdrRequest() == true
+            val rightIdr = nativeRightDecoder?.takeIdrRequest() == true
+            if (leftIdr || rightIdr) maybeSendNeedIdr("native_decoder")
+            return true
+        }
+    }
+
+    private fun releaseNativeDecoders() {
+        synchronized(nativeDecoderLock) {
+            nativeLeftDecoder?.release()
+            nativeLeftDecoder = null
+            nativeRightDecoder?.release()
+            nativeRightDecoder = null
+        }
+    }
+
     private fun stopH264DecodeLoop(clearQueue: Boolean) {
         h264DecodeJob?.cancel()
         h264DecodeJob = null
@@ -1633,9 +1877,18 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
         }
     }
 
-    private fun h264AccessUnitLooksLikeKeyframe(data: ByteArray): Boolean {
+    // NAL unit type from the first header byte: 5 bits for H.264, bits 1-6 for HEVC.
+    private fun nalUnitType(header: Byte, hevc: Boolean): Int {
+        return if (hevc) (header.toInt() shr 1) and 0x3F else header.toInt() and 0x1F
+    }
+
+    private fun nalIsIdr(nalType: Int, hevc: Boolean): Boolean {
+        return if (hevc) nalType == 19 || nalType == 20 else nalType == 5
+    }
+
+    private fun h264AccessUnitLooksLikeKeyframe(data: ByteArray, hevc: Boolean = false): Boolean {
         // Annex-B scan. Treat IDR (type 5) as keyframe. Also accept SPS (7) because it helps resync
-        // after dropping (NVENC repeats headers on keyframes in our config).
+        // after dropping (NVENC repeats headers on keyframes in our config). HEVC: IDR 19/20, VPS 32, SPS 33.
         fun isStartCode3(i: Int): Boolean {
             return i + 2 < data.size && data[i] == 0.toByte() && data[i + 1] == 0.toByte() && data[i + 2] == 1.toByte()
         }
@@ -1657,16 +1910,16 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             val startCodeLen = if (isStartCode4(i)) 4 else 3
             val nalHeaderIndex = start + startCodeLen
             if (nalHeaderIndex >= data.size) break
-            val nalType = (data[nalHeaderIndex].toInt() and 0x1F)
-            if (nalType == 5 || nalType == 7) return true
+            val nalType = nalUnitType(data[nalHeaderIndex], hevc)
+            if (nalIsIdr(nalType, hevc) || nalType == (if (hevc) 33 else 7) || (hevc && nalType == 32)) return true
             i = nalHeaderIndex + 1
         }
 
         return false
     }
 
-    private fun h264AccessUnitContainsIdr(data: ByteArray): Boolean {
-        // Annex-B scan. True IDR slices are NAL type 5.
+    private fun h264AccessUnitContainsIdr(data: ByteArray, hevc: Boolean = false): Boolean {
+        // Annex-B scan. True IDR slices are NAL type 5 (HEVC: IDR_W_RADL 19 / IDR_N_LP 20).
         fun isStartCode3(i: Int): Boolean {
             return i + 2 < data.size && data[i] == 0.toByte() && data[i + 1] == 0.toByte() && data[i + 2] == 1.toByte()
         }
@@ -1688,8 +1941,8 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             val startCodeLen = if (isStartCode4(i)) 4 else 3
             val nalHeaderIndex = start + startCodeLen
             if (nalHeaderIndex >= data.size) break
-            val nalType = (data[nalHeaderIndex].toInt() and 0x1F)
-            if (nalType == 5) return true
+            val nalType = nalUnitType(data[nalHeaderIndex], hevc)
+            if (nalIsIdr(nalType, hevc)) return true
             i = nalHeaderIndex + 1
         }
 
@@ -1698,7 +1951,8 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
 
     private fun handleH264Frame(leftData: ByteArray, rightData: ByteArray, frameId: Int, isMono: Boolean) {
         synchronized(decoderLock) {
-            val (sps, pps) = extractSpsPps(leftData)
+            val hevc = networkReceiver?.hevcPayloads == true
+            val (sps, pps) = extractSpsPps(leftData, hevc)
 
             // If SPS/PPS changes mid-stream (e.g., server reset/recreate encoder), reconfigure.
             // Otherwise, the decoder can output severe mosaic artifacts even though the stream is valid.
@@ -1717,16 +1971,22 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
                 }
 
                 try {
-                    val format = MediaFormat.createVideoFormat(MediaFormat.MIMETYPE_VIDEO_AVC, H264_WIDTH, H264_HEIGHT)
-                    format.setByteBuffer("csd-0", ByteBuffer.wrap(sps))
-                    format.setByteBuffer("csd-1", ByteBuffer.wrap(pps))
+                    val mime = if (hevc) MediaFormat.MIMETYPE_VIDEO_HEVC else MediaFormat.MIMETYPE_VIDEO_AVC
+                    val format = MediaFormat.createVideoFormat(mime, H264_WIDTH, H264_HEIGHT)
+                    if (hevc) {
+                        // HEVC takes VPS+SPS+PPS together in csd-0.
+                        format.setByteBuffer("csd-0", ByteBuffer.wrap(sps + pps))
+                    } else {
+                        format.setByteBuffer("csd-0", ByteBuffer.wrap(sps))
+                        format.setByteBuffer("csd-1", ByteBuffer.wrap(pps))
+                    }
 
-                    leftDecoder = MediaCodec.createDecoderByType(MediaFormat.MIMETYPE_VIDEO_AVC)
+                    leftDecoder = MediaCodec.createDecoderByType(mime)
                     leftDecoder?.configure(format, leftDecoderSurface, null, 0)
                     leftDecoder?.start()
 
                     if (!isMono) {
-                        rightDecoder = MediaCodec.createDecoderByType(MediaFormat.MIMETYPE_VIDEO_AVC)
+                        rightDecoder = MediaCodec.createDecoderByType(mime)
                         rightDecoder?.configure(format, rightDecoderSurface, null, 0)
                         rightDecoder?.start()
                     }
@@ -1740,7 +2000,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
                     enterH264Resync("decoder_init")
 
                     runOnUiThread {
-                        Toast.makeText(this, "VRH2: MediaCodec surface decode active", Toast.LENGTH_SHORT).show()
+                        Toast.makeText(this, "VRH2: MediaCodec surface decode active (${if (hevc) "HEVC" else "H.264"})", Toast.LENGTH_SHORT).show()
                     }
                 } catch (e: Exception) {
                     e.printStackTrace()
@@ -1752,7 +2012,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             }
 
             // If we need to resync, drop until we get a real IDR.
-            val hasIdr = h264AccessUnitContainsIdr(leftData)
+            val hasIdr = h264AccessUnitContainsIdr(leftData, hevc)
             if (h264NeedKeyframeResync) {
                 if (!hasIdr) {
                     synchronized(statsLock) {
@@ -1848,10 +2108,14 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
         }
     }
 
-    private fun extractSpsPps(data: ByteArray): Pair<ByteArray?, ByteArray?> {
+    private fun extractSpsPps(data: ByteArray, hevc: Boolean = false): Pair<ByteArray?, ByteArray?> {
         // Parse Annex-B NAL units and return SPS (type 7) and PPS (type 8), including start codes.
+        // HEVC: the first value is VPS (32) followed by SPS (33), the second PPS (34).
+        var vps: ByteArray? = null
         var sps: ByteArray? = null
         var pps: ByteArray? = null
+        val spsType = if (hevc) 33 else 7
+        val ppsType = if (hevc) 34 else 8
 
         fun isStartCode3(i: Int): Boolean {
             return i + 2 < data.size && data[i] == 0.toByte() && data[i + 1] == 0.toByte() && data[i + 2] == 1.toByte()
@@ -1874,7 +2138,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             val startCodeLen = if (isStartCode4(i)) 4 else 3
             val nalHeaderIndex = start + startCodeLen
             if (nalHeaderIndex >= data.size) break
-            val nalType = (data[nalHeaderIndex].toInt() and 0x1F)
+            val nalType = nalUnitType(data[nalHeaderIndex], hevc)
 
             // Find next start code
             var j = nalHeaderIndex
@@ -1884,13 +2148,18 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
             val end = j
 
             val nalWithStartCode = data.copyOfRange(start, end)
-            if (nalType == 7 && sps == null) sps = nalWithStartCode
-            if (nalType == 8 && pps == null) pps = nalWithStartCode
-            if (sps != null && pps != null) break
+            if (hevc && nalType == 32 && vps == null) vps = nalWithStartCode
+            if (nalType == spsType && sps == null) sps = nalWithStartCode
+            if (nalType == ppsType && pps == null) pps = nalWithStartCode
+            if (sps != null && pps != null && (!hevc || vps != null)) break
 
             i = end
         }
 
+        if (hevc) {
+            val v = vps ?: return Pair(null, pps)
+            return Pair(sps?.let { v + it }, pps)
+        }
         return Pair(sps, pps)
     }
     
@@ -1924,6 +2193,21 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
         }
     }
     
+    // Wi-Fi filters group traffic to save power unless an app holds a MulticastLock.
+    @Synchronized
+    private fun holdMulticastLock(held: Boolean) {
+        if (held) {
+            val wifi = applicationContext.getSystemService(WIFI_SERVICE) as? WifiManager ?: return
+            val lock = multicastLock ?: wifi.createMulticastLock("mesmerglass-stream").also {
+                it.setReferenceCounted(false)
+                multicastLock = it
+            }
+            lock.acquire()
+        } else {
+            multicastLock?.let { if (it.isHeld) it.release() }
+        }
+    }
+
     override fun onPause() {
         super.onPause()
         glSurfaceView.onPause()
@@ -1958,6 +2242,7 @@ class MainActivity : Activity(), GLSurfaceView.Renderer {
     }
     
     private fun releaseDecoders() {
+        releaseNativeDecoders()
         try {
             leftDecoder?.stop()
             leftDecoder?.release()
@@ -2023,6 +2308,16 @@ class DiscoveryService(
         
         println("✅ Discovery service stopped")
     }
+
+    private fun hasHevcDecoder(): Boolean {
+        return try {
+            android.media.MediaCodecList(android.media.MediaCodecList.REGULAR_CODECS).codecInfos.any { info ->
+                !info.isEncoder && info.supportedTypes.any { it.equals(MediaFormat.MIMETYPE_VIDEO_HEVC, ignoreCase = true) }
+            }
+        } catch (e: Exception) {
+            false
+        }
+    }
     
     private suspend fun discoverServer() {
         try {
@@ -2031,13 +2326,15 @@ class DiscoveryService(
             socket?.soTimeout = 1000
             
             val deviceName = android.os.Build.MODEL
+            // Advertise HEVC only when a decoder exists; servers streaming HEVC fall back to H.264 otherwise.
+            val codecs = if (hasHevcDecoder()) "avc,hevc" else "avc"
             
             println("📡 Announcing to MesmerGlass servers on port $discoveryPort...")
             
             while (isRunning) {
                 try {
                     // Send hello message to broadcast address (WORKING PROTOCOL)
-                    val message = "VR_HEADSET_HELLO:$deviceName"
+                    val message = "VR_HEADSET_HELLO:$deviceName;codecs=$codecs"
                     val overrideIp = SERVER_IP_OVERRIDE.trim().ifEmpty { null }
                     val targets = if (overrideIp != null) {
                         listOf(java.net.InetAddress.getByName(overrideIp))
@@ -2104,16 +2401,49 @@ class DiscoveryService(
  * Network Receiver - Handles streaming connection
  * 
  * Supports dual-protocol detection:
- * - VRH2: H.264 hardware decoding
+ * - VRH2/VRH3/VRH4: H.264 hardware decoding
  * - VRHP: JPEG software decoding
+ * - VRHT: ETC2 texture payloads (handled as VRHP, flagged by [compressedTextures])
+ *
+ * VRH4 packets may carry a CRC32C per eye payload. Packets that fail verification
+ * are dropped here (before the decoder sees them) and reported via onCorruptPacket.
+ *
+ * A server in multicast mode answers the connection with CONTROL_MULTICAST_JOIN:
+ * frames then arrive as FEC-protected UDP shards on the group (see NativeMulticast)
+ * and the TCP connection carries control only, including REPAIR for lost shards.
  */
 class NetworkReceiver(
     private val serverIp: String,
     private val serverPort: Int,
     private val onFrameReceived: (ByteArray, ByteArray, MainActivity.StreamProtocol, Int, Boolean) -> Unit,
     private val onDisconnected: (String) -> Unit,  // Callback when connection is lost (includes reason)
-    private val backpressureMs: (MainActivity.StreamProtocol) -> Long = { 0L }
+    private val backpressureMs: (MainActivity.StreamProtocol) -> Long = { 0L },
+    private val onCorruptPacket: (Int) -> Unit = {},  // frameId of a packet that failed CRC32C
+    private val onControl: (Int, ByteArray, ByteArray) -> Unit = { _, _, _ -> },  // VRHC command, arguments, payload
+    private val onMulticast: (Boolean) -> Unit = {}  // true while frames arrive by multicast (hold a MulticastLock)
 ) {
+    companion object {
+        private const val VRH4_FLAG_CRC32C = 0x00000001
+        private const val VRH4_FLAG_HEVC = 0x00000002
+        // Server -> client control commands (VRHC packets).
+        const val CONTROL_HUD = 0x01  // args: [enabled]
+        const val CONTROL_ASSET_OFFER = 0x02  // no args; reply with sendAssetHave()
+        const val CONTROL_ASSET_PUT = 0x03  // args: u64 id, u8 format; asset bytes as payload
+        const val CONTROL_ASSET_SHOW = 0x04  // args: u64 left id, u64 right id
+        const val CONTROL_MULTICAST_JOIN = 0x05  // args: IPv4 group, u16 port, u16 epoch; handled here
+    }
+
+    // True once the server has sent checksummed (VRH4 + CRC32C) payloads on this connection.
+    @Volatile var payloadChecksums = false
+
+    // True while the server flags VRH4 payloads as HEVC (negotiated from the discovery HELLO).
+    @Volatile var hevcPayloads = false
+        private set
+    @Volatile var crcFailures = 0L
+        private set
+    // True once the server has sent VRHT (ETC2 texture) payloads on this connection.
+    @Volatile var compressedTextures = false
+        private set
     
     private var socket: Socket? = null
     private val outputLock = Any()
@@ -2121,18 +2451,52 @@ class NetworkReceiver(
     private var isRunning = false
     private var receiveJob: Job? = null
     private var detectedProtocol = MainActivity.StreamProtocol.UNKNOWN
+    private var multicastJob: Job? = null
+
+    // Idle-timeout bookkeeping; the multicast receive loop updates it too.
+    @Volatile private var hasReceivedAnyPacket = false
+    @Volatile private var lastPacketAtMs = 0L
 
     // Optional control channel: 0x01 => NEED_IDR
     fun sendNeedIdr() {
-        val os: OutputStream? = synchronized(outputLock) { outputStream }
-        if (os == null) return
-        try {
-            os.write(byteArrayOf(0x01))
-            os.flush()
-        } catch (_: Exception) {
-        }
+        writeControl(byteArrayOf(0x01))
     }
     
+    // 0x02 => ASSET_HAVE: u16 count, then count x u64 id (answers CONTROL_ASSET_OFFER)
+    fun sendAssetHave(ids: LongArray) {
+        val count = minOf(ids.size, 0xFFFF)
+        val message = ByteBuffer.allocate(3 + 8 * count)
+        message.put(0x02.toByte())
+        message.putShort(count.toShort())
+        for (i in 0 until count) message.putLong(ids[i])
+        writeControl(message.array())
+    }
+
+    // 0x03 => ASSET_NEED: u64 id of an asset a SHOW named but the cache no longer holds
+    fun sendAssetNeed(id: Long) {
+        writeControl(ByteBuffer.allocate(9).put(0x03.toByte()).putLong(id).array())
+    }
+
+    // 0x04 => REPAIR: u32 seq, u16 block, u8 count of multicast shards still missing
+    fun sendRepair(seq: Long, block: Int, count: Int) {
+        writeControl(
+            ByteBuffer.allocate(8).put(0x04.toByte()).putInt(seq.toInt()).putShort(block.toShort())
+                .put(count.toByte()).array()
+        )
+    }
+
+    private fun writeControl(message: ByteArray) {
+        // Messages are written whole under the lock so concurrent senders cannot interleave.
+        synchronized(outputLock) {
+            val os = outputStream ?: return
+            try {
+                os.write(message)
+                os.flush()
+            } catch (_: Exception) {
+            }
+        }
+    }
+
     fun start() {
         isRunning = true
         receiveJob = CoroutineScope(Dispatchers.IO).launch {
@@ -2144,6 +2508,7 @@ class NetworkReceiver(
         println("🛑 Stopping network receiver...")
         isRunning = false
         receiveJob?.cancel()
+        multicastJob?.cancel()
         
         // Close socket and ensure it's properly released
         try {
@@ -2182,9 +2547,9 @@ class NetworkReceiver(
             
             println("📡 Connected to server $serverIp:$serverPort")
 
-            var hasReceivedAnyPacket = false
+            hasReceivedAnyPacket = false
             val connectedAtMs = android.os.SystemClock.elapsedRealtime()
-            var lastPacketAtMs = connectedAtMs
+            lastPacketAtMs = connectedAtMs
             
             while (isRunning) {
                 // Read packet size
@@ -2232,20 +2597,15 @@ class NetworkReceiver(
                     continue
                 }
                 
-                // Parse packet and detect protocol
-                val parsed = parsePacket(packetData)
-                
-                // Update detected protocol
-                if (detectedProtocol == MainActivity.StreamProtocol.UNKNOWN) {
-                    detectedProtocol = parsed.protocol
-                    println("✅ Detected protocol: ${parsed.protocol.name}")
+                if (isControlPacket(packetData)) {
+                    handleControlPacket(packetData)
+                    continue
                 }
-                
-                // Callback with frames
-                onFrameReceived(parsed.leftFrame, parsed.rightFrame, parsed.protocol, parsed.frameId, parsed.isMono)
+
+                val protocol = deliverPacket(packetData) ?: continue
 
                 // Apply receiver-side backpressure (primarily for VRH2) if requested.
-                val bp = backpressureMs(parsed.protocol)
+                val bp = backpressureMs(protocol)
                 if (bp > 0) {
                     delay(bp)
                 }
@@ -2274,26 +2634,150 @@ class NetworkReceiver(
         }
     }
     
+    // Parses one stream packet (size prefix stripped) and hands its frames on.
+    // Returns the protocol, or null when the packet failed its checksum.
+    private fun deliverPacket(packetData: ByteArray): MainActivity.StreamProtocol? {
+        val parsed = parsePacket(packetData)
+
+        if (parsed.crcFailed) {
+            crcFailures += 1
+            println("⚠️ CRC32C mismatch on frame ${parsed.frameId}; dropping packet")
+            onCorruptPacket(parsed.frameId)
+            return null
+        }
+        
+        // Update detected protocol
+        if (detectedProtocol == MainActivity.StreamProtocol.UNKNOWN) {
+            detectedProtocol = parsed.protocol
+            println("✅ Detected protocol: ${parsed.protocol.name}")
+        }
+        
+        // Callback with frames
+        onFrameReceived(parsed.leftFrame, parsed.rightFrame, parsed.protocol, parsed.frameId, parsed.isMono)
+        return parsed.protocol
+    }
+
+    private fun startMulticast(args: ByteArray) {
+        if (args.size < 8 || multicastJob != null) return
+        val group = java.net.InetAddress.getByAddress(args.copyOfRange(0, 4))
+        val port = ((args[4].toInt() and 0xFF) shl 8) or (args[5].toInt() and 0xFF)
+        val epoch = ((args[6].toInt() and 0xFF) shl 8) or (args[7].toInt() and 0xFF)
+        val reassembler = NativeMulticast.create(epoch)
+        if (reassembler == null) {
+            println("❌ Server streams by multicast but libvrrenderer is unavailable")
+            return
+        }
+        println("📡 Joining multicast ${group.hostAddress}:$port (epoch $epoch)")
+        multicastJob = CoroutineScope(Dispatchers.IO).launch {
+            receiveMulticast(group, port, reassembler)
+        }
+    }
+
+    // Frames arrive in order from the reassembler; there is no backpressure, since
+    // the group is paced by the server for every headset at once.
+    private fun receiveMulticast(group: java.net.InetAddress, port: Int, reassembler: NativeMulticast) {
+        val serviceIntervalUs = 2_000L
+        var s: java.net.MulticastSocket? = null
+        onMulticast(true)
+        try {
+            s = java.net.MulticastSocket(port)
+            s.receiveBufferSize = 4 * 1024 * 1024
+            s.soTimeout = 5
+            s.joinGroup(java.net.InetSocketAddress(group, port), null)
+
+            val buffer = ByteArray(65536)
+            val datagram = java.net.DatagramPacket(buffer, buffer.size)
+            var lastServiceUs = 0L
+            while (isRunning) {
+                var ready = try {
+                    datagram.length = buffer.size
+                    s.receive(datagram)
+                    reassembler.push(buffer, datagram.length, System.nanoTime() / 1000)
+                } catch (e: java.net.SocketTimeoutException) {
+                    false
+                }
+                val nowUs = System.nanoTime() / 1000
+                if (nowUs - lastServiceUs >= serviceIntervalUs) {
+                    lastServiceUs = nowUs
+                    ready = reassembler.poll(nowUs) || ready
+                    for (repair in reassembler.repairRequests(nowUs)) {
+                        sendRepair(repair.seq, repair.block, repair.count)
+                    }
+                    if (reassembler.takeKeyframeRequest()) sendNeedIdr()
+                }
+                if (!ready) continue
+                while (true) {
+                    val packet = reassembler.nextPacket() ?: break
+                    hasReceivedAnyPacket = true
+                    lastPacketAtMs = android.os.SystemClock.elapsedRealtime()
+                    deliverPacket(packet)
+                }
+            }
+        } catch (e: Exception) {
+            if (isRunning) println("❌ Multicast receive error: ${e.message}")
+        } finally {
+            try {
+                s?.leaveGroup(java.net.InetSocketAddress(group, port), null)
+            } catch (_: Exception) {
+            }
+            s?.close()
+            reassembler.stats()?.let {
+                println("📊 Multicast: ${it.delivered} frames, ${it.recovered} rebuilt by FEC, " +
+                    "${it.repaired} repaired, ${it.lost} lost")
+            }
+            reassembler.release()
+            onMulticast(false)
+        }
+    }
+
+    // VRHC: 16-byte VRHP-style header, command byte + arguments in the left-eye slot,
+    // optional payload (asset bytes) in the right-eye slot.
+    private fun isControlPacket(packet: ByteArray): Boolean =
+        packet.size >= 16 && packet[0] == 'V'.code.toByte() && packet[1] == 'R'.code.toByte() &&
+            packet[2] == 'H'.code.toByte() && packet[3] == 'C'.code.toByte()
+
+    private fun handleControlPacket(packet: ByteArray) {
+        val buffer = ByteBuffer.wrap(packet, 8, packet.size - 8)
+        val length = buffer.int
+        val payloadLength = buffer.int
+        if (length <= 0 || payloadLength < 0 || 16L + length + payloadLength > packet.size) {
+            println("⚠️ Malformed VRHC packet (${packet.size} bytes)")
+            return
+        }
+        val command = packet[16].toInt() and 0xFF
+        if (command == CONTROL_MULTICAST_JOIN) {
+            startMulticast(packet.copyOfRange(17, 16 + length))
+            return
+        }
+        onControl(command, packet.copyOfRange(17, 16 + length), packet.copyOfRange(16 + length, 16 + length + payloadLength))
+    }
+
     private data class ParsedPacket(
         val leftFrame: ByteArray,
         val rightFrame: ByteArray,
         val protocol: MainActivity.StreamProtocol,
         val frameId: Int,
-        val isMono: Boolean
+        val isMono: Boolean,
+        val fpsMilli: Int = 0,
+        val crcFailed: Boolean = false
     )
 
     private fun parsePacket(packet: ByteArray): ParsedPacket {
         val buffer = ByteBuffer.wrap(packet)
         
-        // Read header (16 bytes)
+        // Read header (VRHP/VRHT/VRH2 = 16 bytes, VRH3 = 20 bytes, VRH4 = 32 bytes)
         val magic = ByteArray(4)
         buffer.get(magic)
         val magicString = String(magic, Charsets.US_ASCII)
         
         // Detect protocol from magic bytes
         val protocol = when (magicString) {
-            "VRH2" -> MainActivity.StreamProtocol.VRH2  // H.264
+            "VRH2", "VRH3", "VRH4" -> MainActivity.StreamProtocol.VRH2  // H.264
             "VRHP" -> MainActivity.StreamProtocol.VRHP  // JPEG
+            "VRHT" -> {
+                compressedTextures = true
+                MainActivity.StreamProtocol.VRHP  // ETC2 textures, uploaded on the VRHP path
+            }
             else -> {
                 println("⚠️ Unknown protocol magic: $magicString")
                 MainActivity.StreamProtocol.UNKNOWN
@@ -2304,6 +2788,17 @@ class NetworkReceiver(
         val leftSize = buffer.int
         val rightSize = buffer.int
         val isMono = (rightSize == 0)
+        val fpsMilli = if (magicString == "VRH3" || magicString == "VRH4") buffer.int else 0
+
+        var flags = 0
+        var crcLeft = 0
+        var crcRight = 0
+        if (magicString == "VRH4") {
+            flags = buffer.int
+            crcLeft = buffer.int
+            crcRight = buffer.int
+        }
+        hevcPayloads = (flags and VRH4_FLAG_HEVC) != 0
         
         // Read left eye frame
         val leftFrame = ByteArray(leftSize)
@@ -2316,6 +2811,13 @@ class NetworkReceiver(
             leftFrame
         }
 
-        return ParsedPacket(leftFrame, rightFrame, protocol, frameId, isMono)
+        var crcFailed = false
+        if ((flags and VRH4_FLAG_CRC32C) != 0) {
+            payloadChecksums = true
+            crcFailed = NativeCrc.crc32c(leftFrame) != crcLeft ||
+                (rightSize > 0 && NativeCrc.crc32c(rightFrame) != crcRight)
+        }
+
+        return ParsedPacket(leftFrame, rightFrame, protocol, frameId, isMono, fpsMilli, crcFailed)
     }
 }
@@ -0,0 +1,83 @@
+package com.hypnotic.vrreceiver
+
+import android.graphics.Bitmap
+import android.graphics.BitmapFactory
+import android.util.Log
+
+/**
+ * Content-addressed image cache kept by libvrrenderer across frames and connections.
+ *
+ * The server PUTs recurring frames once (JPEG or VRHT payload, keyed by a 64-bit
+ * hash) and afterwards only sends SHOW with the hash. JPEGs are decoded here, once,
+ * on the network thread; [upload] is a plain texture upload on the GL thread.
+ */
+object NativeAssetCache {
+    private const val TAG = "NativeAssetCache"
+
+    // Matches mesmerglass/mesmervisor/asset_cache.py.
+    const val FORMAT_JPEG = 0
+    const val FORMAT_TEXTURE = 1
+
+    val available: Boolean = try {
+        System.loadLibrary("vrrenderer")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "libvrrenderer unavailable; asset cache disabled (${e.message})")
+        false
+    }
+
+    /** Stores one asset from a VRHC PUT; returns false if it could not be decoded or stored. */
+    fun put(id: Long, format: Int, data: ByteArray, offset: Int = 0, length: Int = data.size - offset): Boolean {
+        if (!available || length <= 0) return false
+        return when (format) {
+            FORMAT_TEXTURE -> nativePutTexture(id, data, offset, length)
+            FORMAT_JPEG -> {
+                val options = BitmapFactory.Options().apply { inPreferredConfig = Bitmap.Config.ARGB_8888 }
+                val bitmap = BitmapFactory.decodeByteArray(data, offset, length, options) ?: return false
+                try {
+                    nativePutBitmap(id, bitmap)
+                } finally {
+                    bitmap.recycle()
+                }
+            }
+            else -> false
+        }
+    }
+
+    fun contains(id: Long): Boolean = available && nativeContains(id)
+
+    /** Uploads into [textureId] on the GL thread; returns (width, height) or null on a miss. */
+    fun upload(textureId: Int, id: Long): Pair<Int, Int>? {
+        if (!available) return null
+        val packed = nativeUpload(textureId, id)
+        if (packed == 0) return null
+        return Pair(packed ushr 16, packed and 0xFFFF)
+    }
+
+    /** Cached ids, most recently used first; reported to the server as HAVE. */
+    fun ids(): LongArray = if (available) nativeIds() else LongArray(0)
+
+    /** count, bytes, hits, misses, evictions */
+    fun stats(): LongArray {
+        val out = LongArray(5)
+        if (available) nativeStats(out)
+        return out
+    }
+
+    fun setBudget(bytes: Long) {
+        if (available) nativeSetBudget(bytes)
+    }
+
+    fun clear() {
+        if (available) nativeClear()
+    }
+
+    @JvmStatic private external fun nativePutBitmap(id: Long, bitmap: Bitmap): Boolean
+    @JvmStatic private external fun nativePutTexture(id: Long, data: ByteArray, offset: Int, length: Int): Boolean
+    @JvmStatic private external fun nativeContains(id: Long): Boolean
+    @JvmStatic private external fun nativeUpload(textureId: Int, id: Long): Int
+    @JvmStatic private external fun nativeIds(): LongArray
+    @JvmStatic private external fun nativeStats(out: LongArray)
+    @JvmStatic private external fun nativeSetBudget(bytes: Long)
+    @JvmStatic private external fun nativeClear()
+}
@@ -0,0 +1,49 @@
+package com.hypnotic.vrreceiver
+
+import android.util.Log
+
+/**
+ * CRC32C for VRH4 payload verification.
+ *
+ * Backed by libvrrenderer (ARMv8 CRC instructions when available). If the native
+ * library can't be loaded, a table-driven Kotlin fallback keeps checksums working.
+ */
+object NativeCrc {
+    private const val TAG = "NativeCrc"
+
+    private val nativeLoaded: Boolean = try {
+        System.loadLibrary("vrrenderer")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "libvrrenderer unavailable; using Kotlin CRC32C (${e.message})")
+        false
+    }
+
+    val hardwareAccelerated: Boolean by lazy {
+        nativeLoaded && try { nativeCrc32cHardware() } catch (_: Throwable) { false }
+    }
+
+    private val table: IntArray by lazy {
+        IntArray(256) { i ->
+            var c = i
+            repeat(8) { c = if (c and 1 != 0) (c ushr 1) xor 0x82F63B78.toInt() else c ushr 1 }
+            c
+        }
+    }
+
+    fun crc32c(data: ByteArray, offset: Int = 0, length: Int = data.size - offset): Int {
+        if (length <= 0) return 0
+        if (nativeLoaded) {
+            return nativeCrc32c(data, offset, length)
+        }
+        val t = table
+        var c = -1
+        for (i in offset until offset + length) {
+            c = t[(c xor data[i].toInt()) and 0xFF] xor (c ushr 8)
+        }
+        return c.inv()
+    }
+
+    @JvmStatic private external fun nativeCrc32c(data: ByteArray, offset: Int, length: Int): Int
+    @JvmStatic private external fun nativeCrc32cHardware(): Boolean
+}
@@ -0,0 +1,64 @@
+package com.hypnotic.vrreceiver
+
+import android.util.Log
+
+/**
+ * In-headset performance overlay drawn by libvrrenderer.
+ *
+ * Per-stage frame-time graphs plus stream counters for both eyes in a single
+ * draw call. The server switches it on with a VRHC control packet; all calls
+ * must be made on the GL thread.
+ */
+object NativeHud {
+    private const val TAG = "NativeHud"
+
+    // Stage and counter order match perf_hud.h.
+    const val STAGE_RECEIVE = 0
+    const val STAGE_DECODE = 1
+    const val STAGE_UPLOAD = 2
+    const val STAGE_RENDER = 3
+    const val STAGE_PRESENT = 4
+    const val STAGE_COUNT = 5
+
+    const val COUNTER_QUEUE_FRAMES = 0
+    const val COUNTER_PLAYOUT_MS = 1
+    const val COUNTER_BITRATE_KBPS = 2
+    const val COUNTER_DROPS = 3
+    const val COUNTER_RESYNCS = 4
+    const val COUNTER_NEED_IDR = 5
+    const val COUNTER_CRC_FAILURES = 6
+    const val COUNTER_COUNT = 7
+
+    val available: Boolean = try {
+        System.loadLibrary("vrrenderer")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "libvrrenderer unavailable; performance HUD disabled (${e.message})")
+        false
+    }
+
+    /** One sample per rendered frame, in milliseconds, indexed by STAGE_*. */
+    fun record(stageMs: FloatArray) {
+        if (available) nativeRecord(stageMs)
+    }
+
+    /** Latest counter values, indexed by COUNTER_*. */
+    fun setCounters(counters: LongArray) {
+        if (available) nativeSetCounters(counters)
+    }
+
+    /** Draws over the whole surface; [stereo] places one panel in each eye. */
+    fun draw(surfaceWidth: Int, surfaceHeight: Int, stereo: Boolean) {
+        if (available) nativeDraw(surfaceWidth, surfaceHeight, stereo)
+    }
+
+    /** Drop GL objects and history; call when the GL context is recreated. */
+    fun reset() {
+        if (available) nativeReset()
+    }
+
+    @JvmStatic private external fun nativeRecord(stageMs: FloatArray)
+    @JvmStatic private external fun nativeSetCounters(counters: LongArray)
+    @JvmStatic private external fun nativeDraw(surfaceWidth: Int, surfaceHeight: Int, stereo: Boolean)
+    @JvmStatic private external fun nativeReset()
+}
@@ -0,0 +1,85 @@
+package com.hypnotic.vrreceiver
+
+import android.util.Log
+
+/**
+ * Reassembler for the server's multicast stream (`vr-stream --multicast`),
+ * backed by libvrrenderer's MulticastReassembler.
+ *
+ * Datagrams go in through [push]; complete stream packets come out of
+ * [nextPacket] in order, without their size prefix, ready for the same parser
+ * the TCP path uses. Lost shards that FEC could not cover are listed by
+ * [repairRequests] and sent as REPAIR on the control connection.
+ */
+class NativeMulticast private constructor(private var handle: Long) {
+
+    data class Stats(
+        val datagrams: Long,
+        val delivered: Long,
+        val recovered: Long,
+        val repaired: Long,
+        val lost: Long,
+        val requests: Long,
+    )
+
+    data class Repair(val seq: Long, val block: Int, val count: Int)
+
+    /** Returns true when a packet is ready. */
+    fun push(datagram: ByteArray, length: Int, nowUs: Long): Boolean =
+        handle != 0L && nativePush(handle, datagram, length, nowUs)
+
+    /** Gives up on frames held back too long; returns true when a packet is ready. */
+    fun poll(nowUs: Long): Boolean = handle != 0L && nativePoll(handle, nowUs)
+
+    fun nextPacket(): ByteArray? = if (handle != 0L) nativeNextPacket(handle) else null
+
+    fun repairRequests(nowUs: Long): List<Repair> {
+        if (handle == 0L) return emptyList()
+        val packed = nativeRepairRequests(handle, nowUs) ?: return emptyList()
+        return packed.map { Repair(it ushr 24, ((it ushr 8) and 0xFFFF).toInt(), (it and 0xFF).toInt()) }
+    }
+
+    /** True once after a frame was dropped; the caller sends NEED_IDR. */
+    fun takeKeyframeRequest(): Boolean = handle != 0L && nativeTakeKeyframeRequest(handle)
+
+    fun stats(): Stats? {
+        if (handle == 0L) return null
+        val v = nativeStats(handle) ?: return null
+        return Stats(v[0], v[1], v[2], v[3], v[4], v[5])
+    }
+
+    fun release() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    companion object {
+        private const val TAG = "NativeMulticast"
+
+        private val nativeLoaded: Boolean = try {
+            System.loadLibrary("vrrenderer")
+            true
+        } catch (e: UnsatisfiedLinkError) {
+            Log.w(TAG, "libvrrenderer unavailable (${e.message})")
+            false
+        }
+
+        /** Null when the native library is unavailable; multicast is then declined. */
+        fun create(epoch: Int): NativeMulticast? {
+            if (!nativeLoaded) return null
+            val handle = nativeCreate(epoch)
+            return if (handle != 0L) NativeMulticast(handle) else null
+        }
+
+        @JvmStatic private external fun nativeCreate(epoch: Int): Long
+        @JvmStatic private external fun nativePush(handle: Long, data: ByteArray, length: Int, nowUs: Long): Boolean
+        @JvmStatic private external fun nativePoll(handle: Long, nowUs: Long): Boolean
+        @JvmStatic private external fun nativeNextPacket(handle: Long): ByteArray?
+        @JvmStatic private external fun nativeRepairRequests(handle: Long, nowUs: Long): LongArray?
+        @JvmStatic private external fun nativeTakeKeyframeRequest(handle: Long): Boolean
+        @JvmStatic private external fun nativeStats(handle: Long): LongArray?
+        @JvmStatic private external fun nativeDestroy(handle: Long)
+    }
+}
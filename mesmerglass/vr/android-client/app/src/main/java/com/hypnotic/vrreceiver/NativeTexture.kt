@@ -0,0 +1,37 @@
+package com.hypnotic.vrreceiver
+
+import android.util.Log
+
+/**
+ * Uploads VRHT payloads (ETC2 blocks, optionally LZ4) straight into GL textures.
+ *
+ * The headset does no image decode for VRHT: libvrrenderer parses the payload
+ * and calls glCompressedTexImage2D. Must be called on the GL thread.
+ */
+object NativeTexture {
+    private const val TAG = "NativeTexture"
+
+    val available: Boolean = try {
+        System.loadLibrary("vrrenderer")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "libvrrenderer unavailable; VRHT streams cannot be shown (${e.message})")
+        false
+    }
+
+    /** Uploads into [textureId]; returns (width, height) or null if the payload was rejected. */
+    fun uploadEtc2(textureId: Int, payload: ByteArray, offset: Int = 0, length: Int = payload.size - offset): Pair<Int, Int>? {
+        if (!available || length <= 0) return null
+        val packed = nativeUploadEtc2(textureId, payload, offset, length)
+        if (packed == 0) return null
+        return Pair(packed ushr 16, packed and 0xFFFF)
+    }
+
+    /** Forget texture allocations; call when the GL context (and its texture ids) is recreated. */
+    fun reset() {
+        if (available) nativeReset()
+    }
+
+    @JvmStatic private external fun nativeUploadEtc2(textureId: Int, data: ByteArray, offset: Int, length: Int): Int
+    @JvmStatic private external fun nativeReset()
+}
@@ -0,0 +1,88 @@
+package com.hypnotic.vrreceiver
+
+import android.util.Log
+import android.view.Surface
+
+/**
+ * H.264 / HEVC decoder backed by libvrrenderer's VideoDecoder (NDK AMediaCodec).
+ *
+ * Queueing, IDR resync and playout pacing run on a native decode thread, so
+ * [submit] only copies the access unit and returns. The same pipeline is built
+ * on Linux hosts (FFmpeg backend) to replay recorded dumps; see
+ * app/src/main/cpp/tools/vrdecode_bench.cpp. MainActivity uses it for VRH2 when
+ * launched with the `native_decoder` extra.
+ */
+class NativeVideoDecoder private constructor(private var handle: Long) {
+
+    data class Stats(
+        val submitted: Long,
+        val queued: Long,
+        val decoded: Long,
+        val dropped: Long,
+        val late: Long,
+        val resyncs: Long,
+        val flushes: Long,
+        val lastLatencyUs: Long,
+        val maxLatencyUs: Long,
+        val playoutBufferMs: Long,
+        val queueDepth: Long,
+    )
+
+    /** Returns false when the unit was dropped (waiting for an IDR, or queue overflow). */
+    fun submit(data: ByteArray, ptsUs: Long, offset: Int = 0, length: Int = data.size - offset): Boolean {
+        if (handle == 0L) return false
+        return nativeSubmit(handle, data, offset, length, ptsUs)
+    }
+
+    /** Drop everything until the next IDR (CRC failure, reconnect, ...). */
+    fun requestResync(reason: String) {
+        if (handle != 0L) nativeRequestResync(handle, reason)
+    }
+
+    /** True once per native IDR request; the caller sends NEED_IDR. */
+    fun takeIdrRequest(): Boolean = handle != 0L && nativeTakeIdrRequest(handle)
+
+    fun stats(): Stats? {
+        if (handle == 0L) return null
+        val v = nativeStats(handle) ?: return null
+        return Stats(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10])
+    }
+
+    fun release() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    companion object {
+        private const val TAG = "NativeVideoDecoder"
+
+        private val nativeLoaded: Boolean = try {
+            System.loadLibrary("vrrenderer")
+            true
+        } catch (e: UnsatisfiedLinkError) {
+            Log.w(TAG, "libvrrenderer unavailable (${e.message})")
+            false
+        }
+
+        /** Null when the native library or codec is unavailable; callers keep the Kotlin MediaCodec path. */
+        fun create(surface: Surface, targetBufferMs: Int, queueMaxFrames: Int, hevc: Boolean = false): NativeVideoDecoder? {
+            if (!nativeLoaded) return null
+            val handle = try {
+                nativeCreate(surface, targetBufferMs, queueMaxFrames, hevc)
+            } catch (e: Throwable) {
+                Log.w(TAG, "nativeCreate failed: ${e.message}")
+                0L
+            }
+            return if (handle != 0L) NativeVideoDecoder(handle) else null
+        }
+
+        @JvmStatic private external fun nativeCreate(surface: Surface, targetBufferMs: Int, queueMaxFrames: Int, hevc: Boolean): Long
+        @JvmStatic private external fun nativeSubmit(handle: Long, data: ByteArray, offset: Int, length: Int, ptsUs: Long): Boolean
+        @JvmStatic private external fun nativeRequestResync(handle: Long, reason: String)
+        @JvmStatic private external fun nativeTakeIdrRequest(handle: Long): Boolean
+        @JvmStatic private external fun nativeStats(handle: Long): LongArray?
+        @JvmStatic private external fun nativeDestroy(handle: Long)
+    }
+}
@@ -13,12 +13,25 @@ Usage contract:
 Patterns implemented without shaders (for maximum compatibility):
 - solid: color cycles over time via glClearColor
 - grid: coarse grid drawn using glScissor + glClear to avoid fixed-function draws
+
+The same context + FBO backs the headless streaming compositor
+(mesmerloom.headless_compositor). On Linux the context is an EGL surfaceless
+context (EGL_MESA_platform_surfaceless) created directly on libEGL, so no
+window, display server or Qt GL integration is involved; where that is not
+available it falls back to a QOpenGLContext on a QOffscreenSurface.
+MESMERGLASS_HEADLESS_GL=qt skips the EGL attempt. Call
+ensure_headless_platform() before creating the QGuiApplication on machines
+without a display server.
 """
 
 from __future__ import annotations
 
+import ctypes
+import logging
+import os
+import sys
 from dataclasses import dataclass
-from typing import Tuple
+from typing import Optional, Tuple
 
 from PyQt6.QtGui import QSurfaceFormat
 from PyQt6.QtCore import QSize
@@ -29,6 +42,129 @@ try:
 except Exception as _e:  # pragma: no cover
     GL = None  # type: ignore
 
+logger = logging.getLogger(__name__)
+
+
+def ensure_headless_platform() -> str:
+    """Pick a Qt platform plugin that needs no display server, if none is available.
+
+    Only acts on Linux when neither DISPLAY nor WAYLAND_DISPLAY is set and
+    QT_QPA_PLATFORM was not chosen explicitly. Qt then only provides the event
+    loop: OffscreenGL renders through an EGL surfaceless context and falls back
+    to the Qt context of the plugin chosen here. MESMERGLASS_HEADLESS_QPA selects
+    the plugin (default "offscreen"; "eglfs" or "minimalegl" for the fallback
+    where EGL surfaceless is missing). Returns the platform in effect ("" = Qt default).
+    """
+    current = os.environ.get("QT_QPA_PLATFORM", "")
+    if current or not sys.platform.startswith("linux"):
+        return current
+    if os.environ.get("DISPLAY") or os.environ.get("WAYLAND_DISPLAY"):
+        return current
+    platform = (os.environ.get("MESMERGLASS_HEADLESS_QPA") or "offscreen").strip()
+    os.environ["QT_QPA_PLATFORM"] = platform
+    return platform
+
+
+_EGL_NONE = 0x3038
+_EGL_ALPHA_SIZE = 0x3021
+_EGL_BLUE_SIZE = 0x3022
+_EGL_GREEN_SIZE = 0x3023
+_EGL_RED_SIZE = 0x3024
+_EGL_SURFACE_TYPE = 0x3033
+_EGL_RENDERABLE_TYPE = 0x3040
+_EGL_PBUFFER_BIT = 0x0001
+_EGL_OPENGL_BIT = 0x0008
+_EGL_OPENGL_API = 0x30A2
+_EGL_CONTEXT_MAJOR_VERSION = 0x3098
+_EGL_CONTEXT_MINOR_VERSION = 0x30FB
+_EGL_CONTEXT_OPENGL_PROFILE_MASK = 0x30FD
+_EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT = 0x0001
+_EGL_PLATFORM_SURFACELESS_MESA = 0x31DD
+
+
+def _egl_attribs(*values: int):
+    return (ctypes.c_int32 * (len(values) + 1))(*values, _EGL_NONE)
+
+
+class EglSurfacelessContext:
+    """OpenGL 3.3 core context on Mesa's surfaceless EGL platform.
+
+    Renders only into FBOs, which is all OffscreenGL needs. It mimics the parts
+    of QOpenGLContext the compositors call (makeCurrent/doneCurrent/surface), with
+    itself standing in as the surface. PyOpenGL reaches it through libglvnd's
+    shared dispatch, so no PYOPENGL_PLATFORM change is required.
+    """
+
+    def __init__(self) -> None:
+        egl = ctypes.CDLL("libEGL.so.1")
+        for name, res, args in (
+            ("eglGetProcAddress", ctypes.c_void_p, [ctypes.c_char_p]),
+            ("eglInitialize", ctypes.c_uint, [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]),
+            ("eglBindAPI", ctypes.c_uint, [ctypes.c_uint]),
+            ("eglChooseConfig", ctypes.c_uint, [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int32, ctypes.c_void_p]),
+            ("eglCreateContext", ctypes.c_void_p, [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]),
+            ("eglMakeCurrent", ctypes.c_uint, [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]),
+            ("eglDestroyContext", ctypes.c_uint, [ctypes.c_void_p, ctypes.c_void_p]),
+            ("eglGetError", ctypes.c_int32, []),
+        ):
+            fn = getattr(egl, name)
+            fn.restype, fn.argtypes = res, args
+        self._egl = egl
+        addr = egl.eglGetProcAddress(b"eglGetPlatformDisplayEXT")
+        if not addr:
+            raise RuntimeError("EGL_EXT_platform_base not supported")
+        get_platform_display = ctypes.CFUNCTYPE(ctypes.c_void_p, ctypes.c_uint, ctypes.c_void_p, ctypes.c_void_p)(addr)
+        self._display = get_platform_display(_EGL_PLATFORM_SURFACELESS_MESA, None, None)
+        if not self._display or not egl.eglInitialize(self._display, None, None):
+            raise RuntimeError(f"EGL surfaceless display unavailable (0x{egl.eglGetError():04X})")
+        if not egl.eglBindAPI(_EGL_OPENGL_API):
+            raise RuntimeError("EGL has no desktop OpenGL API")
+        config = ctypes.c_void_p()
+        count = ctypes.c_int32(0)
+        attribs = _egl_attribs(
+            _EGL_SURFACE_TYPE, _EGL_PBUFFER_BIT,
+            _EGL_RENDERABLE_TYPE, _EGL_OPENGL_BIT,
+            _EGL_RED_SIZE, 8, _EGL_GREEN_SIZE, 8, _EGL_BLUE_SIZE, 8, _EGL_ALPHA_SIZE, 8,
+        )
+        if not egl.eglChooseConfig(self._display, attribs, ctypes.byref(config), 1, ctypes.byref(count)) or count.value < 1:
+            raise RuntimeError("No EGL config with desktop OpenGL")
+        ctx_attribs = _egl_attribs(
+            _EGL_CONTEXT_MAJOR_VERSION, 3,
+            _EGL_CONTEXT_MINOR_VERSION, 3,
+            _EGL_CONTEXT_OPENGL_PROFILE_MASK, _EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        )
+        self._context = egl.eglCreateContext(self._display, config, None, ctx_attribs)
+        if not self._context:
+            raise RuntimeError(f"eglCreateContext failed (0x{egl.eglGetError():04X})")
+
+    def surface(self):
+        return self
+
+    def makeCurrent(self, surface=None) -> bool:
+        return bool(self._egl.eglMakeCurrent(self._display, None, None, self._context))
+
+    def doneCurrent(self) -> None:
+        self._egl.eglMakeCurrent(self._display, None, None, None)
+
+    def destroy(self) -> None:
+        if self._context:
+            self.doneCurrent()
+            self._egl.eglDestroyContext(self._display, self._context)
+            self._context = None
+
+
+def _create_egl_context() -> Optional[EglSurfacelessContext]:
+    """EGL surfaceless context, or None where it is disabled or unavailable."""
+    if not sys.platform.startswith("linux"):
+        return None
+    if (os.environ.get("MESMERGLASS_HEADLESS_GL") or "egl").strip().lower() == "qt":
+        return None
+    try:
+        return EglSurfacelessContext()
+    except Exception as e:
+        logger.info("[offscreen] EGL surfaceless context unavailable (%s); using the Qt offscreen context", e)
+        return None
+
 
 @dataclass
 class OffscreenGL:
@@ -38,24 +174,13 @@ class OffscreenGL:
     def __post_init__(self) -> None:
         if GL is None:
             raise RuntimeError("PyOpenGL not available")
-        # Create context and offscreen surface
-        fmt = QSurfaceFormat()
-        fmt.setRenderableType(QSurfaceFormat.RenderableType.OpenGL)
-        fmt.setVersion(3, 3)
-        fmt.setProfile(QSurfaceFormat.OpenGLContextProfile.CoreProfile)
-        # No need for depth/stencil/MSAA for simple test patterns
-        fmt.setDepthBufferSize(0)
-        fmt.setStencilBufferSize(0)
-        self.ctx = QOpenGLContext()
-        self.ctx.setFormat(fmt)
-        ok = self.ctx.create()
-        if not ok:
-            raise RuntimeError("Failed to create QOpenGLContext")
-        self.surf = QOffscreenSurface()
-        self.surf.setFormat(fmt)
-        self.surf.create()
-        if not self.surf.isValid():
-            raise RuntimeError("Failed to create QOffscreenSurface")
+        self.ctx = _create_egl_context()
+        if self.ctx is not None:
+            self.surf = self.ctx
+            self.backend = "egl-surfaceless"
+        else:
+            self._create_qt_context()
+            self.backend = "qt"
         # Make current once to allocate GL objects
         self.make_current()
         try:
@@ -93,6 +218,25 @@ class OffscreenGL:
             GL.glBindFramebuffer(GL.GL_FRAMEBUFFER, 0)
             self.done_current()
 
+    def _create_qt_context(self) -> None:
+        fmt = QSurfaceFormat()
+        fmt.setRenderableType(QSurfaceFormat.RenderableType.OpenGL)
+        fmt.setVersion(3, 3)
+        fmt.setProfile(QSurfaceFormat.OpenGLContextProfile.CoreProfile)
+        # No need for depth/stencil/MSAA for simple test patterns
+        fmt.setDepthBufferSize(0)
+        fmt.setStencilBufferSize(0)
+        self.ctx = QOpenGLContext()
+        self.ctx.setFormat(fmt)
+        ok = self.ctx.create()
+        if not ok:
+            raise RuntimeError("Failed to create QOpenGLContext")
+        self.surf = QOffscreenSurface()
+        self.surf.setFormat(fmt)
+        self.surf.create()
+        if not self.surf.isValid():
+            raise RuntimeError("Failed to create QOffscreenSurface")
+
     def make_current(self) -> None:
         self.ctx.makeCurrent(self.surf)
 
@@ -174,6 +318,22 @@ class OffscreenGL:
                 GL.glClear(GL.GL_COLOR_BUFFER_BIT)
         GL.glDisable(GL.GL_SCISSOR_TEST)
 
+    def read_rgb(self):
+        """Read the FBO back as a top-down (height, width, 3) uint8 numpy array."""
+        import numpy as np
+
+        from mesmerglass.frame_buffers import frame_buffers
+
+        GL.glBindFramebuffer(GL.GL_FRAMEBUFFER, self._fbo)
+        try:
+            GL.glPixelStorei(GL.GL_PACK_ALIGNMENT, 1)
+            data = GL.glReadPixels(0, 0, int(self.width), int(self.height), GL.GL_RGB, GL.GL_UNSIGNED_BYTE)
+        finally:
+            GL.glBindFramebuffer(GL.GL_FRAMEBUFFER, 0)
+        frame = np.frombuffer(data, dtype=np.uint8).reshape(int(self.height), int(self.width), 3)
+        # Flip into a pooled buffer rather than a fresh allocation per frame.
+        return frame_buffers.copy(frame[::-1])
+
     # ----------------- teardown -----------------
     def delete(self) -> None:
         if GL is None:
@@ -191,3 +351,5 @@ class OffscreenGL:
         finally:
             GL.glBindFramebuffer(GL.GL_FRAMEBUFFER, 0)
             self.done_current()
+            if isinstance(self.ctx, EglSurfacelessContext):
+                self.ctx.destroy()